@@ -0,0 +1,418 @@
+#include "bench_common.h"
+
+#include "animation/blend/animation_budget.h"
+#include "animation/blend/animator.h"
+#include "animation/clip/animation_clip.h"
+#include "animation/crowd/crowd_animator.h"
+#include "animation/skinning/skinner.h"
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr uint32_t kBones = 32;
+constexpr float kHeight = 1.8f;
+constexpr float kSegment = kHeight / float(kBones);
+
+// A 8192-vertex tube along +Y skinned to a chain of kBones bones, each
+// vertex weighted over its `influences` nearest bones by distance.
+animation::SkinnedMesh makeTube(uint32_t influences)
+{
+    constexpr uint32_t kRings = 128, kSegments = 64;
+    std::vector<render::Vertex> vertices;
+    std::vector<uint16_t> bones;
+    std::vector<float> weights;
+    for (uint32_t r = 0; r < kRings; ++r) {
+        const float y = kHeight * (float(r) + 0.5f) / float(kRings);
+        const float along = y / kSegment - 0.5f; // in bone units, bone b centred on b
+        for (uint32_t s = 0; s < kSegments; ++s) {
+            const float angle = 6.2831853f * float(s) / float(kSegments);
+            const Vec3 normal{std::cos(angle), 0.0f, std::sin(angle)};
+            vertices.push_back({normal * 0.15f + Vec3{0.0f, y, 0.0f}, normal,
+                                {float(s) / float(kSegments), float(r) / float(kRings)}});
+            const int nearest = int(std::lround(along));
+            for (uint32_t k = 0; k < influences; ++k) {
+                // Bones alternate either side of the nearest one.
+                const int offset = (k % 2 ? -1 : 1) * int((k + 1) / 2);
+                const int bone = std::clamp(nearest + offset, 0, int(kBones) - 1);
+                const float distance = std::abs(along - float(nearest + offset));
+                bones.push_back(uint16_t(bone));
+                weights.push_back(std::max(0.0f, 1.0f - distance / (0.5f * float(influences))));
+            }
+        }
+    }
+    return animation::SkinnedMesh({.vertices = vertices, .bones = bones, .weights = weights, .influences = influences});
+}
+
+// Bends the chain about Z and twists it about Y, differently per instance
+// and frame.
+void pose(animation::BonePalette& palette, uint32_t instance, uint32_t frame)
+{
+    Quat rotation;
+    Vec3 joint;
+    const float phase = 0.37f * float(instance) + 0.05f * float(frame);
+    for (uint32_t b = 0; b < kBones; ++b) {
+        const Quat local = Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 0.06f * std::sin(phase + 0.2f * float(b))) *
+                           Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.08f * std::cos(phase));
+        rotation = math::normalize(rotation * local);
+        // Skin transform: the bone's current transform times the inverse
+        // of its bind transform, a translation to its rest joint.
+        palette.setRigid(b, rotation, joint - math::rotate(rotation, {0.0f, kSegment * float(b), 0.0f}));
+        joint = joint + math::rotate(rotation, {0.0f, kSegment, 0.0f});
+    }
+}
+
+float maxError(const std::vector<render::Vertex>& a, const std::vector<render::Vertex>& b)
+{
+    float error = 0.0f;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        error = std::max(error, math::length(a[i].position - b[i].position));
+    return error;
+}
+
+// A 10 s, 30 fps clip of a 100-bone character walking: a root moving
+// forwards with a bob and a sway; 60 body bones rotating at the 0.9 Hz
+// stride with its second and third harmonics falling off, amplitudes from
+// a few degrees to half a radian, plus capture noise as left by a low-pass
+// filter; 30 finger and face bones held still and 10 moving slowly, two
+// of them breathing in scale. Every bone keeps its bind offset.
+std::vector<animation::Transform> makeClipSamples(uint32_t bones, uint32_t frames, float frameRate, uint32_t seed)
+{
+    constexpr float kStride = 0.9f;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    struct Motion {
+        Vec3 axis;
+        float amplitude[3], phase[3];
+        float noise = 0.0f;
+    };
+    std::vector<Motion> motions(bones);
+    for (Motion& m : motions) {
+        m.axis = math::normalize(Vec3{unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f}, {1.0f, 0.0f, 0.0f});
+        m.amplitude[0] = 0.03f + 0.45f * unit(rng) * unit(rng);
+        m.amplitude[1] = 0.3f * m.amplitude[0] * unit(rng);
+        m.amplitude[2] = 0.1f * m.amplitude[0] * unit(rng);
+        for (float& phase : m.phase)
+            phase = 6.2831853f * unit(rng);
+    }
+    std::normal_distribution<float> noise(0.0f, 0.0001f);
+
+    std::vector<animation::Transform> samples(std::size_t(frames) * bones);
+    for (uint32_t f = 0; f < frames; ++f) {
+        const float t = float(f) / frameRate;
+        for (uint32_t b = 0; b < bones; ++b) {
+            animation::Transform& out = samples[std::size_t(f) * bones + b];
+            Motion& m = motions[b];
+            out.translation = {0.0f, 0.08f + 0.002f * float(b % 7), 0.01f * float(b % 3)};
+            if (b == 0) {
+                out.translation = {0.05f * std::sin(3.1415927f * t), 0.95f + 0.03f * std::sin(6.2831853f * t),
+                                   1.4f * t};
+                out.rotation = Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.1f * std::sin(3.1415927f * t));
+            } else if (b < 61) {
+                float angle = 0.0f;
+                for (int h = 0; h < 3; ++h)
+                    angle += m.amplitude[h] * std::sin(float(h + 1) * kStride * 6.2831853f * t + m.phase[h]);
+                m.noise += 0.3f * (noise(rng) - m.noise);
+                out.rotation = Quat::fromAxisAngle(m.axis, angle + m.noise);
+            } else if (b >= 91) {
+                out.rotation = Quat::fromAxisAngle(m.axis, 0.2f * m.amplitude[0] * std::sin(0.5f * t + m.phase[0]));
+                if (b >= 98)
+                    out.scale = Vec3{1.0f, 1.0f, 1.0f} * (1.0f + 0.02f * std::sin(1.5f * t));
+            }
+        }
+    }
+    return samples;
+}
+
+// A 1 s additive lean: deltas rotating the first twenty bones a little
+// about Z, with no translation or scale.
+std::vector<animation::Transform> makeLeanSamples(uint32_t bones, uint32_t frames)
+{
+    std::vector<animation::Transform> samples(std::size_t(frames) * bones);
+    for (uint32_t f = 0; f < frames; ++f) {
+        const float angle = 0.05f * std::sin(6.2831853f * float(f) / float(frames - 1));
+        for (uint32_t b = 1; b < std::min(bones, 21u); ++b)
+            samples[std::size_t(f) * bones + b].rotation = Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, angle);
+    }
+    return samples;
+}
+
+// Times fn(jobs) on a thread of its own with a one-worker JobSystem: a
+// thread owns at most one system, and main's is already live.
+template <typename Fn>
+double oneWorkerMs(int iterations, Fn&& fn)
+{
+    double ms = 0.0;
+    std::thread([&] {
+        jobs::JobSystem single({.workerCount = 1});
+        ms = bench::medianMs(iterations, [&] { fn(single); });
+    }).join();
+    return ms;
+}
+
+} // namespace
+
+// Cooks a 100-bone clip and measures its compression, its error and the
+// cost of sampling it at random times. Evaluates a locomotion blend tree
+// (three-clip blendspace, masked upper-body layer and additive lean) for
+// 5000 characters, on one core and on every core, crowds of 2000 to
+// 10000 under an LOD budget, and instanced crowds of 10000 and 50000
+// sharing poses by phase. Then skins 250 instances of an 8192-vertex tube
+// (2M vertices) bent and twisted along a 32-bone chain, with 4 and 8
+// influences per vertex, by linear blend and dual quaternion skinning.
+// Each kernel level the CPU supports is measured on one thread, as
+// vertices per second per core, and checked against scalar; the best
+// level then skins all 2M vertices on every core.
+int main()
+{
+    bench::Report report("animation");
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency())});
+
+    {
+        constexpr uint32_t kClipBones = 100, kFrames = 301;
+        constexpr float kFrameRate = 30.0f;
+        const std::vector<animation::Transform> samples = makeClipSamples(kClipBones, kFrames, kFrameRate, 9);
+        bench::Timer cookTimer;
+        const animation::AnimationClip clip(
+            {.bones = kClipBones, .frames = kFrames, .frameRate = kFrameRate, .samples = samples});
+        report.add("clip_100_bones_cook", cookTimer.elapsedMs(), "ms");
+        const animation::AnimationClipStats& stats = clip.stats();
+        report.add("clip_raw_bytes", double(clip.rawSize()), "B");
+        report.add("clip_cooked_bytes", double(clip.memoryUsage()), "B");
+        const double ratio = double(clip.rawSize()) / double(clip.memoryUsage());
+        report.check("clip_compression_ratio", ratio, "x", ">= 10x", ratio >= 10.0);
+        report.add("clip_static_tracks", double(stats.staticTracks), "tracks");
+        report.add("clip_constant_tracks", double(stats.constantTracks), "tracks");
+        report.add("clip_animated_tracks", double(stats.animatedTracks), "tracks");
+        // Keyframe reduction's own share: stripping tracks and quantizing
+        // keys alone come to about 9x on this clip.
+        const double kept = 100.0 * double(stats.keys) / double(stats.sourceKeys);
+        report.check("clip_keys_kept", kept, "%", "<= 75 %", kept <= 75.0);
+
+        // Largest error at every source frame and halfway between frames,
+        // against the source frames nlerped.
+        std::vector<animation::Transform> pose(kClipBones);
+        float rotationError = 0.0f, translationError = 0.0f;
+        for (uint32_t f = 0; f + 1 < kFrames * 2; ++f) {
+            clip.sample(0.5f * float(f) / kFrameRate, pose);
+            const animation::Transform* a = &samples[std::size_t(f / 2) * kClipBones];
+            const animation::Transform* b = &samples[std::size_t((f + 1) / 2) * kClipBones];
+            for (uint32_t bone = 0; bone < kClipBones; ++bone) {
+                Quat expected = math::nlerp(a[bone].rotation, b[bone].rotation, 0.5f);
+                if (math::dot(pose[bone].rotation, expected) < 0.0f)
+                    expected = -expected;
+                // From the chord, 2 sin(angle / 4); acos of the dot is too
+                // coarse this close to zero.
+                const Quat chord = pose[bone].rotation + (-expected);
+                rotationError = std::max(rotationError,
+                                         4.0f * std::asin(std::min(std::sqrt(math::dot(chord, chord)) * 0.5f, 1.0f)));
+                const Vec3 translation = (a[bone].translation + b[bone].translation) * 0.5f;
+                translationError = std::max(translationError, math::length(pose[bone].translation - translation));
+            }
+        }
+        report.add("clip_max_rotation_error", rotationError, "rad");
+        report.add("clip_max_translation_error", 1000.0 * translationError, "mm");
+
+        // Random times, as many characters at different phases would, into
+        // the structure-of-arrays poses blending works on.
+        std::vector<float> times(4096);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> time(0.0f, clip.duration());
+        for (float& t : times)
+            t = time(rng);
+        animation::PoseBuffer buffer(kClipBones);
+        const double ms = bench::medianMs(15, [&] {
+            for (float t : times)
+                clip.sample(t, buffer);
+            bench::doNotOptimize(buffer.data()[0]);
+        });
+        report.add("clip_sample_100_bones", 1000.0 * ms / double(times.size()), "us", "< 1 us");
+    }
+
+    {
+        // Idle, walk and run cycles by speed, a wave over the upper body
+        // and a lean added on top. Parameters: phase, speed, wave weight,
+        // wave phase, lean weight.
+        constexpr uint32_t kClipBones = 100, kCycleFrames = 31, kCharacters = 5000;
+        std::vector<animation::AnimationClip> clips;
+        for (uint32_t seed : {1u, 2u, 3u, 4u}) {
+            const std::vector<animation::Transform> samples = makeClipSamples(kClipBones, kCycleFrames, 30.0f, seed);
+            clips.emplace_back(
+                animation::AnimationClipDesc{.bones = kClipBones, .frames = kCycleFrames, .samples = samples});
+        }
+        const std::vector<animation::Transform> leanSamples = makeLeanSamples(kClipBones, kCycleFrames);
+        const animation::AnimationClip lean({.bones = kClipBones, .frames = kCycleFrames, .samples = leanSamples});
+        std::vector<float> upperBody(kClipBones, 0.0f);
+        std::fill(upperBody.begin() + 20, upperBody.begin() + 61, 1.0f);
+        const animation::AnimationClip* locomotion[] = {&clips[0], &clips[1], &clips[2]};
+        const float speeds[] = {0.0f, 1.5f, 4.0f};
+        using animation::BlendNodeType;
+        const animation::BlendNodeDesc nodes[] = {
+            {.type = BlendNodeType::Additive, .inputs = {1, 4}, .weight = 4},
+            {.type = BlendNodeType::Layer, .inputs = {2, 3}, .weight = 2, .mask = upperBody},
+            {.type = BlendNodeType::Blendspace1D, .phase = 0, .clips = locomotion, .xs = speeds, .x = 1},
+            {.type = BlendNodeType::Clip, .clip = &clips[3], .phase = 3},
+            {.type = BlendNodeType::Clip, .clip = &lean, .phase = 0},
+        };
+        // A ternary tree of bones: level 1 keeps 33, level 2 keeps 11.
+        std::vector<int16_t> parents(kClipBones);
+        for (uint32_t b = 0; b < kClipBones; ++b)
+            parents[b] = int16_t(b == 0 ? -1 : int(b - 1) / 3);
+        const animation::Skeleton skeleton(parents);
+        const animation::BlendTree tree(
+            {.bones = kClipBones, .nodes = nodes, .root = 0, .parameterCount = 5, .skeleton = &skeleton});
+
+        // Speeds anywhere in the blendspace, a quarter of characters
+        // waving, everyone leaning a little.
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<float> parameters(std::size_t(kCharacters) * 5);
+        std::vector<animation::PoseBuffer> poses(kCharacters, animation::PoseBuffer(kClipBones));
+        std::vector<animation::AnimatorInstance> instances;
+        for (uint32_t c = 0; c < kCharacters; ++c) {
+            float* p = &parameters[std::size_t(c) * 5];
+            p[0] = unit(rng);
+            p[1] = 4.0f * unit(rng);
+            p[2] = c % 4 == 0 ? 1.0f : 0.0f;
+            p[3] = unit(rng);
+            p[4] = 0.5f * unit(rng);
+            instances.push_back({&tree, {p, 5}, &poses[c]});
+        }
+        report.add("blend_tree_instructions", double(tree.instructionCount()), "instructions");
+
+        animation::Animator animator;
+        const std::span<const animation::AnimatorInstance> quarter(instances.data(), kCharacters / 4);
+        const double singleMs = oneWorkerMs(9, [&](jobs::JobSystem& single) { animator.update(quarter, single); });
+        report.add("blend_characters_per_core", double(kCharacters / 4) / singleMs, "characters/ms");
+        const double ms = bench::medianMs(9, [&] {
+            animator.update(instances, jobs);
+            bench::doNotOptimize(poses.back().data()[0]);
+        });
+        report.add("blend_5k_characters_all_cores", ms, "ms", "< 16.7 ms");
+
+        // Crowds of every size under a 4 ms budget, importance falling off
+        // with distance. Phases advance a frame at a time; the second half
+        // of 64 frames is measured, once the cost estimate has settled.
+        for (uint32_t crowd : {2000u, 5000u, 10000u}) {
+            std::vector<float> importance(crowd);
+            std::vector<float> crowdParameters(std::size_t(crowd) * 5);
+            std::vector<animation::PoseBuffer> crowdPoses(crowd, animation::PoseBuffer(kClipBones));
+            std::vector<animation::AnimatorHistory> histories(crowd);
+            std::vector<animation::AnimatorInstance> crowdInstances;
+            for (uint32_t c = 0; c < crowd; ++c) {
+                float* p = &crowdParameters[std::size_t(c) * 5];
+                std::copy_n(&parameters[std::size_t(c % kCharacters) * 5], 5, p);
+                importance[c] = 1.0f / (2.0f + 98.0f * unit(rng));
+                crowdInstances.push_back({&tree, {p, 5}, &crowdPoses[c], {}, &histories[c]});
+            }
+            animation::AnimationBudget budget({.milliseconds = 4.0f});
+            animation::Animator lodAnimator;
+            std::vector<double> frames;
+            for (uint32_t frame = 0; frame < 64; ++frame) {
+                budget.assign(crowdInstances, importance);
+                lodAnimator.update(crowdInstances, jobs);
+                budget.calibrate(lodAnimator.stats());
+                if (frame >= 32)
+                    frames.push_back(lodAnimator.stats().milliseconds);
+                for (uint32_t c = 0; c < crowd; ++c) {
+                    crowdParameters[std::size_t(c) * 5] += 1.0f / 30.0f;
+                    crowdParameters[std::size_t(c) * 5 + 3] += 1.0f / 30.0f;
+                }
+            }
+            std::sort(frames.begin(), frames.end());
+            const std::string name = "lod_" + std::to_string(crowd) + "_characters";
+            report.add(name + "_ms", frames[frames.size() / 2], "ms", "4 ms");
+            report.add(name + "_full_rate", 100.0 * budget.stats().characters[0] / double(crowd), "%");
+            report.add(name + "_eighth_rate", 100.0 * budget.stats().characters[3] / double(crowd), "%");
+        }
+
+        // Instanced crowds playing the four cycles at random phases and
+        // speeds. The first update poses every bucket; later ones only
+        // look agents up.
+        const animation::AnimationClip* cycles[] = {&clips[0], &clips[1], &clips[2], &clips[3]};
+        for (uint32_t crowd : {10000u, 50000u}) {
+            animation::CrowdAnimator crowdAnimator({.clips = cycles, .skeleton = &skeleton});
+            std::vector<animation::CrowdAgent> agents(crowd);
+            std::vector<float> rates(crowd);
+            for (uint32_t a = 0; a < crowd; ++a) {
+                agents[a] = {a % 4, unit(rng)};
+                rates[a] = (0.8f + 0.4f * unit(rng)) / (30.0f * clips[a % 4].duration());
+            }
+            std::vector<uint32_t> offsets(crowd);
+            crowdAnimator.update(agents, offsets, jobs);
+            const std::string name = "crowd_" + std::to_string(crowd / 1000) + "k_agents";
+            report.add(name + "_first_update_ms", crowdAnimator.stats().milliseconds, "ms");
+            std::vector<double> frames;
+            for (uint32_t frame = 0; frame < 64; ++frame) {
+                for (uint32_t a = 0; a < crowd; ++a)
+                    agents[a].phase += rates[a];
+                crowdAnimator.update(agents, offsets, jobs);
+                frames.push_back(crowdAnimator.stats().milliseconds);
+            }
+            bench::doNotOptimize(offsets.back());
+            std::sort(frames.begin(), frames.end());
+            report.add(name + "_update_ms", frames[frames.size() / 2], "ms", "< 1 ms");
+            report.add(name + "_buckets", double(crowdAnimator.stats().buckets), "buckets");
+            report.add(name + "_poses_per_bucket", double(crowd) / double(crowdAnimator.stats().buckets), "x");
+        }
+    }
+
+    constexpr uint32_t kInstances = 250;
+    const SimdLevel best = detectSimdLevel();
+    for (uint32_t influences : {4u, 8u}) {
+        const animation::SkinnedMesh mesh = makeTube(influences);
+        report.add("skinned_mesh_" + std::to_string(influences) + "_bytes_per_vertex",
+                   double(mesh.memoryUsage()) / double(mesh.vertexCount()), "B");
+
+        for (animation::SkinningMethod method :
+             {animation::SkinningMethod::Linear, animation::SkinningMethod::DualQuaternion}) {
+            const std::string name =
+                std::string(method == animation::SkinningMethod::Linear ? "lbs" : "dqs") + std::to_string(influences);
+
+            std::vector<animation::BonePalette> palettes(kInstances, animation::BonePalette(method, kBones));
+            std::vector<std::vector<render::Vertex>> streams(kInstances,
+                                                             std::vector<render::Vertex>(mesh.vertexCount()));
+            std::vector<animation::SkinInstance> instances;
+            for (uint32_t i = 0; i < kInstances; ++i) {
+                pose(palettes[i], i, 0);
+                instances.push_back({&mesh, &palettes[i], streams[i]});
+            }
+            const double vertices = double(kInstances) * double(mesh.vertexCount());
+
+            std::vector<render::Vertex> reference;
+            for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2}) {
+                if (level > best)
+                    continue;
+                animation::Skinner skinner(level);
+                const std::string kernel = name + "_" + simdLevelName(level);
+                // One thread, a quarter of the instances.
+                const std::span<const animation::SkinInstance> quarter(instances.data(), kInstances / 4);
+                const double ms = oneWorkerMs(5, [&](jobs::JobSystem& single) { skinner.skin(quarter, single); });
+                report.add("skin_" + kernel + "_per_core", vertices / 4.0 / ms / 1000.0, "Mvertices/s");
+                if (level == SimdLevel::Scalar) {
+                    reference = streams[0];
+                } else {
+                    const double errorMm = 1000.0 * maxError(streams[0], reference);
+                    report.check("skin_" + kernel + "_max_error_vs_scalar", errorMm, "mm", "< 0.01 mm", errorMm < 0.01);
+                }
+            }
+
+            animation::Skinner skinner;
+            const double ms = bench::medianMs(9, [&] {
+                skinner.skin(instances, jobs);
+                bench::doNotOptimize(streams.back().back());
+            });
+            report.add("skin_2m_" + name + "_all_cores", ms, "ms", "< 16.7 ms");
+        }
+    }
+    return report.exitCode();
+}
@@ -0,0 +1,121 @@
+#include "bench_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/broadphase/broadphase.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+// 100k boxes drifting through a 400 x 40 x 400 m volume. Each frame every
+// body reports its new box, then updatePairs() runs; measured for both
+// broadphase types with all bodies moving and with 10% moving. Afterwards
+// the pair cache is checked against a brute-force sweep over the fat boxes.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+struct Body {
+    Vec3 position;
+    Vec3 velocity;
+    Vec3 half;
+    uint32_t proxy;
+};
+
+uint32_t countMismatches(const physics::Broadphase& broadphase, const std::vector<Body>& bodies)
+{
+    std::vector<uint32_t> order(bodies.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+        order[i] = bodies[i].proxy;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return broadphase.fatAabb(a).min.x < broadphase.fatAabb(b).min.x;
+    });
+
+    uint32_t expected = 0, missing = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const physics::Aabb& a = broadphase.fatAabb(order[i]);
+        for (std::size_t j = i + 1; j < order.size(); ++j) {
+            const physics::Aabb& b = broadphase.fatAabb(order[j]);
+            if (b.min.x > a.max.x)
+                break;
+            if (physics::overlaps(a, b)) {
+                ++expected;
+                missing += !broadphase.pairs().contains(physics::pairKey(order[i], order[j]));
+            }
+        }
+    }
+    // Anything beyond the expected set is a stale pair.
+    return missing + (broadphase.pairs().size() - (expected - missing));
+}
+
+} // namespace
+
+int main()
+{
+    bench::Report report("broadphase");
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency())});
+
+    constexpr uint32_t kBodies = 100'000;
+    constexpr float kDt = 1.0f / 60.0f;
+    const Vec3 worldMin{-200.0f, 0.0f, -200.0f}, worldMax{200.0f, 40.0f, 200.0f};
+
+    for (physics::BroadphaseType type : {physics::BroadphaseType::DynamicTree, physics::BroadphaseType::SweepAndPrune}) {
+        const std::string name = type == physics::BroadphaseType::DynamicTree ? "tree" : "sap";
+        for (uint32_t movingPercent : {100u, 10u}) {
+            physics::Broadphase broadphase({.type = type});
+            std::mt19937 rng(5);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            std::vector<Body> bodies(kBodies);
+            for (Body& body : bodies) {
+                body.position = {worldMin.x + unit(rng) * 400.0f, unit(rng) * 40.0f, worldMin.z + unit(rng) * 400.0f};
+                body.half = Vec3{0.2f, 0.2f, 0.2f} + Vec3{unit(rng), unit(rng), unit(rng)} * 0.6f;
+                if (rng() % 100 < movingPercent)
+                    body.velocity = Vec3{unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f} * 8.0f;
+                body.proxy = broadphase.createProxy(physics::Aabb::fromCenterExtents(body.position, body.half),
+                                                     uint32_t(&body - bodies.data()));
+            }
+
+            const double createMs = bench::medianMs(1, [&] { broadphase.updatePairs(jobs); });
+
+            uint64_t moved = 0, added = 0;
+            auto step = [&] {
+                for (Body& body : bodies) {
+                    if (body.velocity.x == 0.0f && body.velocity.y == 0.0f && body.velocity.z == 0.0f)
+                        continue;
+                    const Vec3 d = body.velocity * kDt;
+                    body.position += d;
+                    // Bounce off the world bounds.
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (body.position[axis] < worldMin[axis] || body.position[axis] > worldMax[axis])
+                            body.velocity[axis] = -body.velocity[axis];
+                    }
+                    broadphase.moveProxy(body.proxy, physics::Aabb::fromCenterExtents(body.position, body.half), d);
+                }
+                broadphase.updatePairs(jobs);
+                moved += broadphase.stats().movedProxies;
+                added += broadphase.stats().pairsAdded + broadphase.stats().pairsRemoved;
+            };
+            for (int i = 0; i < 10; ++i)
+                step();
+            moved = added = 0;
+            constexpr int kSteps = 31;
+            const double ms = bench::medianMs(kSteps, step);
+
+            const std::string prefix = name + "_100k_" + std::to_string(movingPercent) + "pct_moving";
+            if (movingPercent == 100)
+                report.add(name + "_100k_initial_build", createMs, "ms");
+            report.add(prefix + "_step", ms, "ms");
+            report.add(prefix + "_fat_box_updates_per_step", double(moved) / kSteps, "proxies");
+            report.add(prefix + "_pair_changes_per_step", double(added) / kSteps, "pairs");
+            report.add(prefix + "_pairs", double(broadphase.stats().pairs), "pairs");
+            const uint32_t mismatches = countMismatches(broadphase, bodies);
+            report.check(prefix + "_pair_mismatches", double(mismatches), "pairs", "0", mismatches == 0);
+            if (type == physics::BroadphaseType::DynamicTree && movingPercent == 100) {
+                report.add("tree_height", double(broadphase.tree().height()), "levels");
+                report.add("tree_area_ratio", double(broadphase.tree().areaRatio()), "");
+            }
+        }
+    }
+    return report.exitCode();
+}
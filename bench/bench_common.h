@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace rebel::bench {
+
+class Timer {
+public:
+    Timer() { reset(); }
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+    double elapsedMs() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// Runs fn `iterations` times and returns the median wall time in ms.
+template <typename Fn>
+double medianMs(int iterations, Fn&& fn)
+{
+    std::vector<double> samples;
+    samples.reserve(std::size_t(iterations));
+    for (int i = 0; i < iterations; ++i) {
+        Timer timer;
+        fn();
+        samples.push_back(timer.elapsedMs());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/// Collects result lines for one benchmark suite, echoes them to stdout and
+/// appends them to bench_output.txt (or $REBEL_BENCH_OUTPUT) on destruction.
+class Report {
+public:
+    explicit Report(std::string suite)
+        : suite_(std::move(suite))
+    {
+    }
+
+    ~Report()
+    {
+        const char* path = std::getenv("REBEL_BENCH_OUTPUT");
+        FILE* file = std::fopen(path ? path : "bench_output.txt", "a");
+        for (const std::string& line : lines_) {
+            std::fputs(line.c_str(), stdout);
+            if (file)
+                std::fputs(line.c_str(), file);
+        }
+        if (file)
+            std::fclose(file);
+    }
+
+    /// Records a metric; pass a non-empty `target` to print the budget it is
+    /// measured against.
+    void add(const std::string& name, double value, const char* unit, const std::string& target = {})
+    {
+        char buffer[512];
+        if (target.empty())
+            std::snprintf(buffer, sizeof(buffer), "[%s] %s: %.4f %s\n", suite_.c_str(), name.c_str(), value, unit);
+        else
+            std::snprintf(buffer, sizeof(buffer), "[%s] %s: %.4f %s (target %s)\n", suite_.c_str(), name.c_str(),
+                          value, unit, target.c_str());
+        lines_.emplace_back(buffer);
+    }
+
+    /// Records a correctness result, one that must meet `target` on any
+    /// machine, unlike the timing budgets passed to add(). A failed check is
+    /// marked on its line and makes exitCode() non-zero.
+    void check(const std::string& name, double value, const char* unit, const std::string& target, bool passed)
+    {
+        add(name, value, unit, target);
+        if (!passed) {
+            lines_.back().insert(lines_.back().size() - 1, " FAILED");
+            ++failures_;
+        }
+    }
+
+    void check(const std::string& name, bool passed) { check(name, passed ? 1.0 : 0.0, "bool", "1", passed); }
+
+    /// For main to return: 1 if any check failed.
+    int exitCode() const { return failures_ > 0 ? 1 : 0; }
+
+private:
+    std::string suite_;
+    std::vector<std::string> lines_;
+    int failures_ = 0;
+};
+
+/// Keeps the optimiser from discarding a computed value.
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace rebel::bench
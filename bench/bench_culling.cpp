@@ -0,0 +1,85 @@
+#include "bench_common.h"
+
+#include "core/jobs/job_system.h"
+#include "render/culling/culler.h"
+#include "render/primitives.h"
+#include "render/software/software_rasterizer.h"
+
+#include <random>
+#include <thread>
+
+// Culls 500k objects scattered over a city-sized area against a ground-level
+// camera, first frustum only and then with a depth pyramid built from a
+// 320x180 depth-only pass over a row of building-sized occluders. Every
+// kernel level the CPU supports is measured and checked against scalar.
+int main()
+{
+    using namespace rebel;
+    using math::Vec3;
+
+    bench::Report report("culling");
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency())});
+
+    constexpr uint32_t kObjects = 500'000;
+    render::BoundsSoA bounds;
+    bounds.resize(kObjects);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> extent(0.25f, 2.0f);
+    for (uint32_t i = 0; i < kObjects; ++i) {
+        const Vec3 e{extent(rng), extent(rng), extent(rng)};
+        bounds.setAabb(i, {coord(rng), e.y, coord(rng)}, e);
+    }
+
+    const Vec3 eye{0.0f, 2.0f, 0.0f};
+    const math::Mat4 view = math::Mat4::lookAt(eye, {0.0f, 2.0f, -1.0f}, {0.0f, 1.0f, 0.0f});
+    const math::Mat4 projection = math::Mat4::perspective(1.2f, 16.0f / 9.0f, 0.5f, 1000.0f);
+    const math::Mat4 viewProjection = projection * view;
+
+    // Occluders: a broken row of buildings 40 m ahead plus a nearby wall.
+    const render::MeshData box = render::makeBox({0.5f, 0.5f, 0.5f});
+    render::SoftwareRasterizer occluderPass({.width = 320, .height = 180, .depthOnly = true, .trianglesPerSetupJob = 256});
+    render::DepthPyramid pyramid;
+    auto renderOccluders = [&] {
+        occluderPass.beginFrame({.viewProjection = viewProjection});
+        for (int b = -6; b <= 6; ++b) {
+            const Vec3 size{14.0f, 30.0f, 10.0f};
+            occluderPass.draw({.mesh = box.view(),
+                               .model = math::Mat4::translation({float(b) * 16.0f, 15.0f, -40.0f}) * math::Mat4::scale(size)});
+        }
+        occluderPass.draw({.mesh = box.view(),
+                           .model = math::Mat4::translation({-12.0f, 3.0f, -12.0f}) * math::Mat4::scale({16.0f, 6.0f, 1.0f})});
+        occluderPass.endFrame(jobs);
+        pyramid.build(occluderPass);
+    };
+    renderOccluders();
+    report.add("occluder_pass_and_pyramid_320x180", bench::medianMs(9, renderOccluders), "ms");
+
+    const SimdLevel best = detectSimdLevel();
+    uint32_t reference[2] = {0, 0};
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (level > best)
+            continue;
+        render::Culler culler(level);
+        const std::string name = simdLevelName(level);
+        for (int occlusion = 0; occlusion < 2; ++occlusion) {
+            const render::CullParams params{viewProjection, occlusion ? &pyramid : nullptr};
+            culler.cull(bounds, params, jobs);
+            const double ms = bench::medianMs(15, [&] { culler.cull(bounds, params, jobs); });
+            const render::CullStats& stats = culler.stats();
+            const std::string test = occlusion ? "frustum_occlusion" : "frustum";
+            report.add(test + "_500k_" + name, ms, "ms", occlusion ? "< 1 ms on all cores" : "");
+
+            if (level == SimdLevel::Scalar) {
+                reference[occlusion] = stats.visible;
+                report.add(test + "_visible", double(stats.visible), "objects");
+                if (occlusion)
+                    report.add(test + "_occlusion_culled", double(stats.occlusionCulled), "objects");
+            } else {
+                const double delta = double(stats.visible) - double(reference[occlusion]);
+                report.check(test + "_visible_delta_vs_scalar_" + name, delta, "objects", "0", delta == 0.0);
+            }
+        }
+    }
+    return report.exitCode();
+}
@@ -0,0 +1,59 @@
+#include "bench_common.h"
+
+#include "core/ecs/world.h"
+#include "core/platform.h"
+
+namespace {
+
+struct Position {
+    float x, y, z;
+};
+
+struct Velocity {
+    float x, y, z;
+};
+
+constexpr std::size_t kEntityCount = 1'000'000;
+
+} // namespace
+
+int main()
+{
+    using namespace rebel;
+    bench::Report report("ecs");
+
+    ecs::World world;
+    bench::Timer createTimer;
+    world.createMany(kEntityCount, Position{0.0f, 0.0f, 0.0f}, Velocity{1.0f, 2.0f, 3.0f});
+    report.add("create_1M_pos_vel", createTimer.elapsedMs(), "ms");
+
+    ecs::Query query = ecs::Query().with<Position, Velocity>();
+    const float dt = 1.0f / 60.0f;
+
+    const double chunkMs = bench::medianMs(51, [&] {
+        world.forEachChunk(query, [dt](const ecs::ChunkView& view) {
+            Position* REBEL_RESTRICT p = view.get<Position>();
+            const Velocity* REBEL_RESTRICT v = view.get<Velocity>();
+            const uint32_t n = view.size();
+            for (uint32_t i = 0; i < n; ++i) {
+                p[i].x += v[i].x * dt;
+                p[i].y += v[i].y * dt;
+                p[i].z += v[i].z * dt;
+            }
+        });
+    });
+    report.add("iterate_1M_pos_vel_chunks", chunkMs, "ms", "< 1 ms single core");
+    report.add("iterate_1M_pos_vel_chunks_per_entity", chunkMs * 1e6 / double(kEntityCount), "ns");
+
+    const double eachMs = bench::medianMs(51, [&] {
+        world.each<Position, Velocity>([dt](Position& p, const Velocity& v) {
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            p.z += v.z * dt;
+        });
+    });
+    report.add("iterate_1M_pos_vel_each", eachMs, "ms");
+
+    bench::doNotOptimize(*world.get<Position>(ecs::Entity{0, 0}));
+    return 0;
+}
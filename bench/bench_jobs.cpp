@@ -0,0 +1,127 @@
+#include "bench_common.h"
+
+#include "core/ecs/world.h"
+#include "core/jobs/job_system.h"
+#include "core/jobs/task_graph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+using namespace rebel;
+
+constexpr uint32_t kEmptyJobs = 100'000;
+
+double emptyJobNs(uint32_t workers)
+{
+    jobs::JobSystem system({.workerCount = workers});
+    const double ms = bench::medianMs(21, [&] {
+        jobs::JobCounter counter;
+        for (uint32_t i = 0; i < kEmptyJobs; ++i)
+            system.run(counter, [] {});
+        system.wait(counter);
+    });
+    return ms * 1e6 / kEmptyJobs;
+}
+
+// Compute-bound parallelFor so scaling is not limited by memory bandwidth.
+double parallelForMs(uint32_t workers, std::vector<float>& data)
+{
+    jobs::JobSystem system({.workerCount = workers});
+    return bench::medianMs(9, [&] {
+        system.parallelFor(uint32_t(data.size()), 4096, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                float x = data[i];
+                for (int k = 0; k < 64; ++k)
+                    x = std::sqrt(x * x + 1.0f);
+                data[i] = x;
+            }
+        });
+    });
+}
+
+struct Position {
+    float x, y, z;
+};
+struct Velocity {
+    float x, y, z;
+};
+struct Pose {
+    float weights[4];
+};
+struct Target {
+    float x, y, z;
+};
+
+} // namespace
+
+int main()
+{
+    bench::Report report("jobs");
+    const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    report.add("empty_job_1_worker", emptyJobNs(1), "ns/job", "< 50 ns");
+    if (hardware > 1)
+        report.add("empty_job_all_workers", emptyJobNs(hardware), "ns/job", "< 50 ns");
+
+    std::vector<float> data(1u << 20, 1.0f);
+    const double baseline = parallelForMs(1, data);
+    report.add("parallel_for_1_worker", baseline, "ms");
+    for (uint32_t workers = 2; workers <= std::min(hardware, 16u); workers *= 2) {
+        const double ms = parallelForMs(workers, data);
+        char name[64];
+        char target[16];
+        std::snprintf(name, sizeof(name), "parallel_for_speedup_%u_workers", workers);
+        std::snprintf(target, sizeof(target), "~%u", workers);
+        report.add(name, baseline / ms, "x", target);
+    }
+
+    // A frame of four systems: AI and animation are independent of each other
+    // and of physics' inputs, so only physics -> render is serialised.
+    jobs::JobSystem system({.workerCount = hardware});
+    ecs::World world;
+    world.createMany(200'000, Position{}, Velocity{1.0f, 0.0f, 0.0f}, Target{}, Pose{});
+
+    ecs::Query movers = ecs::Query().with<Position, Velocity>();
+    ecs::Query thinkers = ecs::Query().with<Target>();
+    ecs::Query animated = ecs::Query().with<Pose>();
+    float checksum = 0.0f;
+
+    jobs::TaskGraph graph;
+    graph.add("physics", jobs::SystemAccess().read<Velocity>().write<Position>(), [&] {
+        world.forEachChunk(movers, [](const ecs::ChunkView& view) {
+            Position* p = view.get<Position>();
+            const Velocity* v = view.get<Velocity>();
+            for (uint32_t i = 0; i < view.size(); ++i)
+                p[i].x += v[i].x * (1.0f / 60.0f);
+        });
+    });
+    graph.add("ai", jobs::SystemAccess().write<Target>(), [&] {
+        world.forEachChunk(thinkers, [](const ecs::ChunkView& view) {
+            Target* t = view.get<Target>();
+            for (uint32_t i = 0; i < view.size(); ++i)
+                t[i].y += 1.0f;
+        });
+    });
+    graph.add("animation", jobs::SystemAccess().write<Pose>(), [&] {
+        world.forEachChunk(animated, [](const ecs::ChunkView& view) {
+            Pose* pose = view.get<Pose>();
+            for (uint32_t i = 0; i < view.size(); ++i)
+                pose[i].weights[0] += 0.5f;
+        });
+    });
+    graph.add("render", jobs::SystemAccess().read<Position, Pose>(), [&] {
+        world.forEachChunk(movers, [&](const ecs::ChunkView& view) { checksum += view.get<Position>()[0].x; });
+    });
+    graph.compile();
+
+    const std::vector<uint32_t>& level = graph.levels();
+    const uint32_t levels = *std::max_element(level.begin(), level.end()) + 1;
+    report.check("task_graph_levels", double(levels), "levels", "2", levels == 2);
+    report.check("task_graph_independent_at_level_0", level[0] == 0 && level[1] == 0 && level[2] == 0);
+    report.add("task_graph_frame_200k", bench::medianMs(21, [&] { graph.run(system); }), "ms");
+    bench::doNotOptimize(checksum);
+    return report.exitCode();
+}
@@ -0,0 +1,70 @@
+#include "bench_common.h"
+
+#include "core/jobs/job_system.h"
+#include "render/lighting/clustered_lights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+// Sweeps clustered light assignment (16x9x24 clusters) from 100 to 10k point
+// lights spread through a street-sized volume, and spot-checks that sampled
+// view-space points find every light whose sphere contains them.
+int main()
+{
+    using namespace rebel;
+    using math::Vec3;
+
+    bench::Report report("lights");
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency())});
+
+    const render::ClusterView view{
+        .view = math::Mat4::lookAt({0.0f, 5.0f, 0.0f}, {0.0f, 5.0f, -1.0f}, {0.0f, 1.0f, 0.0f}),
+        .verticalFov = 1.0f,
+        .aspect = 16.0f / 9.0f,
+        .nearPlane = 0.1f,
+        .farPlane = 400.0f,
+    };
+    render::ClusteredLights clusters;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (uint32_t count : {100u, 1000u, 2500u, 5000u, 10000u}) {
+        std::vector<render::PointLight> lights(count);
+        for (render::PointLight& light : lights) {
+            light.position = {unit(rng) * 300.0f - 150.0f, unit(rng) * 20.0f, -unit(rng) * 350.0f};
+            light.radius = 2.0f + unit(rng) * 6.0f;
+        }
+
+        clusters.build(lights, view, jobs);
+        const double ms = bench::medianMs(15, [&] { clusters.build(lights, view, jobs); });
+
+        uint32_t maxPerCluster = 0;
+        for (const render::ClusterLightRange& range : clusters.clusters())
+            maxPerCluster = std::max(maxPerCluster, range.count);
+
+        // Reconstruct random view-space points and make sure their cluster
+        // lists every light that reaches them.
+        uint32_t missed = 0;
+        const float tanY = std::tan(view.verticalFov * 0.5f), tanX = tanY * view.aspect;
+        for (int sample = 0; sample < 20000; ++sample) {
+            const float u = unit(rng), v = unit(rng);
+            const float depth = view.nearPlane * std::pow(view.farPlane / view.nearPlane, unit(rng));
+            const Vec3 p{(u * 2.0f - 1.0f) * tanX * depth, (1.0f - v * 2.0f) * tanY * depth, -depth};
+            const std::span<const uint32_t> list = clusters.lights(clusters.clusterIndex(u, v, depth));
+            for (uint32_t l = 0; l < count; ++l) {
+                const Vec3 lp = view.view.transformPoint(lights[l].position);
+                if (math::length(lp - p) < lights[l].radius && !std::binary_search(list.begin(), list.end(), l))
+                    ++missed;
+            }
+        }
+
+        const std::string n = std::to_string(count);
+        report.add("assign_" + n + "_lights", ms, "ms");
+        report.add("assign_" + n + "_light_cluster_pairs", double(clusters.lightIndices().size()), "pairs");
+        report.add("assign_" + n + "_max_per_cluster", double(maxPerCluster), "lights");
+        report.check("assign_" + n + "_missed_samples", double(missed), "lights", "0", missed == 0);
+    }
+    return report.exitCode();
+}
@@ -0,0 +1,75 @@
+#include "bench_common.h"
+
+#include "core/jobs/job_system.h"
+#include "core/memory/arena_allocator.h"
+#include "core/memory/frame_allocator.h"
+#include "core/memory/linear_arena.h"
+
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+using namespace rebel;
+
+constexpr uint32_t kAllocations = 1'000'000;
+
+} // namespace
+
+int main()
+{
+    bench::Report report("memory");
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency()),
+                          .scratchBytesPerWorker = std::size_t(8) << 20});
+    std::vector<void*> pointers(kAllocations);
+
+    const double mallocMs = bench::medianMs(9, [&] {
+        for (uint32_t i = 0; i < kAllocations; ++i)
+            pointers[i] = std::malloc(16 + (i & 63));
+        for (uint32_t i = 0; i < kAllocations; ++i)
+            std::free(pointers[i]);
+    });
+    report.add("malloc_free", mallocMs * 1e6 / kAllocations, "ns/alloc");
+
+    memory::FrameAllocator frame(std::size_t(128) << 20);
+    const double frameMs = bench::medianMs(9, [&] {
+        for (uint32_t i = 0; i < kAllocations; ++i)
+            pointers[i] = frame.allocate(16 + (i & 63), 16, memory::MemoryTag::Physics);
+        frame.endFrame();
+    });
+    report.add("frame_allocator", frameMs * 1e6 / kAllocations, "ns/alloc");
+
+    const double scratchMs = bench::medianMs(9, [&] {
+        memory::ScratchScope scope;
+        for (uint32_t i = 0; i < kAllocations / 16; ++i)
+            pointers[i] = scope.allocate(16 + (i & 63), 16);
+    });
+    report.add("thread_scratch", scratchMs * 1e6 / (kAllocations / 16), "ns/alloc");
+
+    const double parallelMs = bench::medianMs(9, [&] {
+        jobs.parallelFor(kAllocations, 16384, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                pointers[i] = frame.allocate(16 + (i & 63), 16, memory::MemoryTag::Render);
+        });
+        frame.endFrame();
+    });
+    report.add("frame_allocator_all_workers", parallelMs * 1e6 / kAllocations, "ns/alloc");
+
+    // A few frames of tagged traffic, so the debug build's report has
+    // something to say about each subsystem.
+    for (int f = 0; f < 4; ++f) {
+        memory::FrameVector<float> positions{memory::ArenaAllocator<float, memory::FrameAllocator>(frame)};
+        positions.resize(10'000 * std::size_t(f + 1));
+        frame.allocateArray<uint64_t>(4096, memory::MemoryTag::Render);
+        frame.allocateArray<float>(20'000, memory::MemoryTag::Animation);
+        frame.allocateArray<uint32_t>(1024, memory::MemoryTag::AI);
+        frame.endFrame();
+    }
+    const memory::FrameAllocatorStats stats = frame.stats();
+    report.add("frame_high_water", double(stats.highWaterBytes) / 1024.0, "KiB");
+    report.add("worker0_scratch_high_water", double(jobs.workerScratch(0).highWater()) / 1024.0, "KiB");
+    std::fputs(memory::formatStats(stats).c_str(), stdout);
+
+    bench::doNotOptimize(pointers[0]);
+    return 0;
+}
@@ -0,0 +1,991 @@
+#include "bench_common.h"
+
+#include "core/jobs/job_system.h"
+#include "core/mapped_file.h"
+#include "physics/character/character_world.h"
+#include "physics/collision/collide.h"
+#include "physics/collision/shape_cast.h"
+#include "physics/convex_hull.h"
+#include "physics/fluid/fluid_world.h"
+#include "physics/heightfield.h"
+#include "physics/query/scene_query.h"
+#include "physics/softbody/soft_body_world.h"
+#include "physics/state_history.h"
+#include "physics/triangle_mesh.h"
+#include "physics/vehicle/vehicle_world.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+// 10k unit boxes dropped as 25 x 25 columns, 16 high, onto a static ground
+// box. After two seconds of settling the pile is stepped with sleeping off,
+// so every body and contact goes through the solver each step, and once in
+// deterministic mode, whose state hash must not depend on the worker count.
+// The pile itself never sleeps: twisted neighbouring columns touch, so it
+// is one island, and 16-high columns on 8 velocity iterations keep moving
+// well above the sleep threshold until some topple.
+//
+// Sleeping is measured on 10k boxes stacked four high on a 50 x 50 grid,
+// a stack to an island: stepped with sleeping off, then with sleeping on
+// once the islands have gone to sleep (or after twenty seconds).
+//
+// Then the narrowphase per pair (closed-form box-box against GJK/EPA on the
+// same cube as a hull), and warm starting: how far the top of a box stack
+// wanders over ten seconds with and without carried-over impulses.
+//
+// Last, 10k small capsules fired at 400 m/s (6.7 m per step) into a wall of
+// 10 cm thick static tiles, standing in for a static mesh: step cost and
+// how many bullets end up behind the wall, with CCD and without.
+//
+// And rollback: 5k boxes in two-high stacks in deterministic mode,
+// snapshotted every step into a 120-frame history capped at 4 MB while they
+// drop into place and again once settled with one stack in fifty knocked
+// over, each time rolled back 60 frames and re-simulated; the replayed
+// state hashes must match the original run. The settled scene must fit all
+// 120 frames in the cap; the dropping one, all of whose bodies move for the
+// first 35 frames, reports how many it keeps.
+//
+// Then batched scene queries over 10k static boxes: 64k rays as 8-ray
+// sight fans, traced with and without packets, 64k random rays, and batches
+// of capsule sweeps and overlaps.
+//
+// Then XPBD cloth: 50 capes of 32 x 32 particles pinned at the shoulders
+// of swaying capsule characters, draped over them and the ground, plus a
+// soft block dropped on the ground for the volume constraints.
+//
+// Finally large static worlds: a 1025 x 1025 heightfield and a 512 x 512
+// cell terrain cooked as a triangle mesh, written out and memory-mapped
+// back. Memory per sample and per triangle, 64k rays checked against brute
+// force, box queries, and 1k mixed bodies dropped onto each.
+//
+// Last, a 200k-particle position-based fluid dam break: step time and
+// particles simulated per second per core, with the neighbour search's
+// cells, merged ranges and candidate pairs, and the remaining compression.
+//
+// And 2k capsule characters wandering over 256 m of the same terrain among
+// 1.5k static kerbs and crates, with the odd jump: the cost of one batch of
+// moves, how many characters stand on the ground, step up kerbs and snap
+// down slopes, and that none ends up under the terrain.
+//
+// Last, 500 AI cars following ring roads over the same terrain at a quarter
+// of its height, one in four finding the ground with sphere sweeps rather
+// than rays: the cost of a vehicle update (batched wheel queries and the
+// sub-stepped drivetrains) and of a whole frame with the world step, and
+// that every car keeps its speed and stays on its wheels.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr float kDt = 1.0f / 60.0f;
+// A few MB hold 120 frames of a mostly resting 5k-body scene. While all
+// 5k bodies settle, most state changes every frame and the lossless floor
+// is about 23 MB, so that scene gets a budget sized for the full window.
+constexpr std::size_t kHistoryBytes = std::size_t(4) << 20;
+constexpr std::size_t kSettlingHistoryBytes = std::size_t(32) << 20;
+
+void buildPile(physics::PhysicsWorld& world, int layers = 16)
+{
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({200.0f, 1.0f, 200.0f}),
+                      .position = {0.0f, -1.0f, 0.0f}});
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+    for (int y = 0; y < layers; ++y) {
+        for (int z = 0; z < 25; ++z) {
+            for (int x = 0; x < 25; ++x) {
+                const Vec3 position{(float(x) - 12.0f) * 1.1f + jitter(rng), 0.5f + float(y) * 1.05f,
+                                    (float(z) - 12.0f) * 1.1f + jitter(rng)};
+                world.createBody({.shape = physics::Shape::box({0.5f, 0.5f, 0.5f}),
+                                  .position = position,
+                                  .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, jitter(rng) * 4.0f)});
+            }
+        }
+    }
+}
+
+// Boxes stacked `layers` high on a 50 x 50 grid: many small islands that go
+// to sleep once settled. Returns the top box of each stack.
+std::vector<physics::BodyId> buildYard(physics::PhysicsWorld& world, int layers = 2)
+{
+    std::vector<physics::BodyId> tops;
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({200.0f, 1.0f, 200.0f}),
+                      .position = {0.0f, -1.0f, 0.0f}});
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+    for (int z = 0; z < 50; ++z) {
+        for (int x = 0; x < 50; ++x) {
+            for (int y = 0; y < layers; ++y) {
+                const physics::BodyId id = world.createBody({.shape = physics::Shape::box({0.5f, 0.5f, 0.5f}),
+                                  .position = {(float(x) - 25.0f) * 3.0f, 0.5f + float(y) * 1.05f,
+                                               (float(z) - 25.0f) * 3.0f + jitter(rng)},
+                                  .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, jitter(rng) * 4.0f)});
+                if (y == layers - 1)
+                    tops.push_back(id);
+            }
+        }
+    }
+    return tops;
+}
+
+// Horizontal drift of the top box of a `height` stack after ten seconds.
+float stackDrift(jobs::JobSystem& jobs, int height, bool warmStarting, uint32_t iterations)
+{
+    physics::PhysicsWorldDesc desc;
+    desc.allowSleeping = false;
+    desc.solver.warmStarting = warmStarting;
+    desc.solver.velocityIterations = iterations;
+    physics::PhysicsWorld world(desc);
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({10.0f, 0.5f, 10.0f}),
+                      .position = {0.0f, -0.5f, 0.0f}});
+    physics::BodyId top;
+    for (int i = 0; i < height; ++i)
+        top = world.createBody(
+            {.shape = physics::Shape::box({0.5f, 0.5f, 0.5f}), .position = {0.0f, 0.5f + float(i), 0.0f}});
+    for (int i = 0; i < 600; ++i)
+        world.step(kDt, jobs);
+    const Vec3 p = world.body(top)->transform.position;
+    return std::sqrt(p.x * p.x + p.z * p.z);
+}
+
+constexpr float kWallX = 20.0f;
+
+// A zig-zag wall of thin tiles, alternately turned +-23 degrees about Y so
+// neighbours meet edge to edge, and 10k capsule rounds 0.5 m apart spinning
+// about their long axis.
+std::vector<physics::BodyId> buildShootingRange(physics::PhysicsWorld& world, bool ccd)
+{
+    for (int y = 0; y < 30; ++y) {
+        for (int z = 0; z < 30; ++z) {
+            const float angle = (y + z) & 1 ? 0.4f : -0.4f;
+            world.createBody({.type = physics::BodyType::Static,
+                              .shape = physics::Shape::box({0.05f, 1.1f, 1.1f}),
+                              .position = {kWallX, float(y) * 2.0f - 4.0f, float(z) * 2.0f - 29.0f},
+                              .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, angle)});
+        }
+    }
+    std::vector<physics::BodyId> bullets;
+    for (int y = 0; y < 100; ++y) {
+        for (int z = 0; z < 100; ++z) {
+            const physics::BodyDesc desc{
+                .shape = physics::Shape::capsule(0.03f, 0.1f),
+                .position = {0.0f, 1.0f + float(y) * 0.5f, float(z) * 0.5f - 25.0f},
+                .rotation = math::Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 0.5f * math::kPi),
+                .linearVelocity = {400.0f, 0.0f, 0.0f},
+                .angularVelocity = {300.0f, 0.0f, 0.0f},
+                .mass = 0.01f,
+                .ccd = ccd};
+            bullets.push_back(world.createBody(desc));
+        }
+    }
+    return bullets;
+}
+
+// State hash after stepping a 2.5k box pile for five seconds on `workers`
+// threads. A thread owns at most one JobSystem, so the run gets a thread
+// of its own rather than nesting a system inside main's.
+uint64_t pileHash(uint32_t workers, bool deterministic)
+{
+    uint64_t hash = 0;
+    std::thread([&] {
+        jobs::JobSystem jobs({.workerCount = workers});
+        physics::PhysicsWorld world({.deterministic = deterministic});
+        buildPile(world, 4);
+        for (int i = 0; i < 300; ++i)
+            world.step(kDt, jobs);
+        hash = world.stateHash();
+    }).join();
+    return hash;
+}
+
+struct RollbackResult {
+    double awakeBodies = 0.0; // mean over the recorded frames
+    double pushMs = 0.0;      // mean snapshot and delta encode per frame
+    double historyMb = 0.0;
+    uint32_t framesHeld = 0;
+    uint32_t budgetEvictions = 0;
+    double rollbackMs = 0.0;
+    bool replayMatches = false;
+};
+
+// Steps 120 frames into a history, then rolls back 60 and replays them.
+RollbackResult recordAndReplay(physics::PhysicsWorld& world, jobs::JobSystem& jobs, std::size_t maxBytes)
+{
+    physics::StateHistory history(120, maxBytes);
+    std::vector<uint64_t> hashes;
+    RollbackResult result;
+    for (uint32_t frame = 0; frame < 120; ++frame) {
+        world.step(kDt, jobs);
+        result.awakeBodies += world.stats().awakeBodies / 120.0;
+        const auto start = std::chrono::steady_clock::now();
+        history.push(frame, world);
+        result.pushMs +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 120.0;
+        hashes.push_back(world.stateHash());
+    }
+    result.historyMb = double(history.memoryUsage()) / (1024.0 * 1024.0);
+    result.framesHeld = history.frameCount();
+    result.budgetEvictions = history.budgetEvictions();
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool held = history.rollback(59, world);
+    result.rollbackMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    result.replayMatches = held && world.stateHash() == hashes[59];
+    for (uint32_t frame = 60; frame < 120; ++frame) {
+        world.step(kDt, jobs);
+        history.push(frame, world);
+        result.replayMatches &= world.stateHash() == hashes[frame];
+    }
+    return result;
+}
+
+// 10k static boxes of assorted sizes over a 400 x 400 m yard.
+void buildCity(physics::PhysicsWorld& world)
+{
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({200.0f, 1.0f, 200.0f}),
+                      .position = {0.0f, -1.0f, 0.0f}});
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> position(-195.0f, 195.0f);
+    std::uniform_real_distribution<float> size(0.3f, 3.0f);
+    std::uniform_real_distribution<float> angle(-math::kPi, math::kPi);
+    for (int i = 0; i < 10000; ++i) {
+        const Vec3 halfExtents{size(rng), size(rng), size(rng)};
+        world.createBody({.type = physics::BodyType::Static,
+                          .shape = physics::Shape::box(halfExtents),
+                          .position = {position(rng), halfExtents.y, position(rng)},
+                          .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, angle(rng))});
+    }
+}
+
+// 8k agents looking around with fans of eight 50 m sight lines spread over
+// 20 degrees, at eye height, rays of one fan adjacent.
+std::vector<physics::Ray> sightFans()
+{
+    std::mt19937 rng(22);
+    std::uniform_real_distribution<float> position(-190.0f, 190.0f);
+    std::uniform_real_distribution<float> angle(-math::kPi, math::kPi);
+    std::vector<physics::Ray> rays;
+    for (int agent = 0; agent < 8192; ++agent) {
+        const Vec3 eye{position(rng), 1.7f, position(rng)};
+        const float heading = angle(rng);
+        for (int i = 0; i < 8; ++i) {
+            const float a = heading + (float(i) - 3.5f) * (math::kPi / 9.0f / 7.0f);
+            rays.push_back({eye, {std::cos(a), -0.02f, std::sin(a)}, 50.0f, {}});
+        }
+    }
+    return rays;
+}
+
+std::vector<physics::Ray> randomRays()
+{
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> position(-190.0f, 190.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<physics::Ray> rays;
+    for (int i = 0; i < 65536; ++i) {
+        const Vec3 direction = math::normalize({unit(rng), unit(rng) * 0.2f, unit(rng)}, {1.0f, 0.0f, 0.0f});
+        rays.push_back({{position(rng), 0.5f + 4.0f * (unit(rng) + 1.0f), position(rng)}, direction, 50.0f, {}});
+    }
+    return rays;
+}
+
+// Capsule characters on a 10 x 5 grid with a cape hanging from the
+// shoulders of each, draped over the back of the capsule.
+constexpr float kCapeSpacing = 0.03f;
+
+Vec3 capeShoulder(int character, float time)
+{
+    const float sway = 0.15f * std::sin(time * 2.0f + float(character));
+    return {float(character % 10) * 3.0f + sway, 1.55f, float(character / 10) * 3.0f - 0.25f};
+}
+
+std::vector<physics::SoftBodyId> buildCapes(physics::PhysicsWorld& rigid, physics::SoftBodyWorld& soft)
+{
+    rigid.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({50.0f, 1.0f, 50.0f}),
+                      .position = {0.0f, -1.0f, 0.0f}});
+    std::vector<physics::SoftBodyId> capes;
+    for (int i = 0; i < 50; ++i) {
+        const Vec3 shoulder = capeShoulder(i, 0.0f);
+        rigid.createBody({.type = physics::BodyType::Kinematic,
+                          .shape = physics::Shape::capsule(0.3f, 0.6f),
+                          .position = {shoulder.x, 0.9f, shoulder.z + 0.25f}});
+        physics::SoftBodyDesc cape =
+            physics::makeCloth(32, 32, kCapeSpacing, {{shoulder.x - 15.5f * kCapeSpacing, shoulder.y, shoulder.z}, {}});
+        cape.inverseMasses.assign(cape.positions.size(), 1.0f);
+        std::fill_n(cape.inverseMasses.begin(), 32, 0.0f);
+        capes.push_back(soft.createBody(cape));
+    }
+    return capes;
+}
+
+// Rolling terrain, +-12 m.
+float terrainHeight(float x, float z)
+{
+    return 8.0f * std::sin(x * 0.05f) * std::cos(z * 0.07f) + 3.0f * std::sin(x * 0.21f + z * 0.13f) +
+           0.5f * std::sin(x * 0.9f) * std::sin(z * 1.1f);
+}
+
+// `cells` x `cells` unit cells of terrain centred on the origin, two
+// triangles per cell.
+void terrainMesh(uint32_t cells, std::vector<Vec3>& vertices, std::vector<uint32_t>& indices)
+{
+    const float half = 0.5f * float(cells);
+    for (uint32_t r = 0; r <= cells; ++r) {
+        for (uint32_t c = 0; c <= cells; ++c) {
+            const float x = float(c) - half, z = float(r) - half;
+            vertices.push_back({x, terrainHeight(x, z), z});
+        }
+    }
+    for (uint32_t r = 0; r < cells; ++r) {
+        for (uint32_t c = 0; c < cells; ++c) {
+            const uint32_t v = r * (cells + 1) + c;
+            indices.insert(indices.end(), {v, v + cells + 1, v + cells + 2, v, v + cells + 2, v + 1});
+        }
+    }
+}
+
+std::vector<physics::Ray> terrainRays(float extent)
+{
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<physics::Ray> rays;
+    for (int i = 0; i < 65536; ++i) {
+        const Vec3 direction =
+            math::normalize({unit(rng), -0.2f - 0.8f * std::fabs(unit(rng)), unit(rng)}, {0.0f, -1.0f, 0.0f});
+        rays.push_back({{position(rng), 20.0f + 10.0f * unit(rng), position(rng)}, direction, 200.0f, {}});
+    }
+    return rays;
+}
+
+// Casts `rays` through `cast`, and the first 256 again by brute force over
+// every triangle `all` yields; returns the ms and whether every distance
+// agrees within a millimetre.
+template <typename Cast, typename All>
+double castTerrainRays(const std::vector<physics::Ray>& rays, Cast&& cast, All&& all, bool& matches, int& hits)
+{
+    std::vector<float> distances(rays.size());
+    const double ms = bench::medianMs(5, [&] {
+        for (std::size_t i = 0; i < rays.size(); ++i) {
+            physics::CastHit hit;
+            distances[i] = cast(rays[i], hit) ? hit.distance : rays[i].maxDistance;
+        }
+    });
+    hits = int(std::count_if(distances.begin(), distances.end(), [](float d) { return d < 200.0f; }));
+    matches = true;
+    for (std::size_t i = 0; i < 256; ++i) {
+        float best = rays[i].maxDistance;
+        all([&](uint32_t, const Vec3* v) {
+            physics::CastHit hit;
+            if (physics::rayTriangle(rays[i].origin, rays[i].direction, v, best, hit))
+                best = hit.distance;
+        });
+        matches = matches && std::fabs(best - distances[i]) < 1e-3f;
+    }
+    return ms;
+}
+
+// 1000 boxes, spheres and capsules on a jittered grid dropped from 25 m onto
+// `ground` and left to settle; returns the step time over the last second
+// and how many ended up below the surface.
+double dropOnTerrain(const physics::Shape& ground, jobs::JobSystem& jobs, int& fellThrough)
+{
+    physics::PhysicsWorld world;
+    world.createBody({.type = physics::BodyType::Static, .shape = ground});
+    std::mt19937 rng(32);
+    std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+    const physics::Shape shapes[3] = {physics::Shape::box({0.5f, 0.5f, 0.5f}), physics::Shape::sphere(0.5f),
+                                      physics::Shape::capsule(0.3f, 0.4f)};
+    std::vector<physics::BodyId> bodies;
+    for (int i = 0; i < 1000; ++i) {
+        const float x = -120.0f + 7.5f * float(i % 32) + jitter(rng);
+        const float z = -120.0f + 7.5f * float(i / 32) + jitter(rng);
+        bodies.push_back(world.createBody({.shape = shapes[i % 3], .position = {x, 25.0f, z}}));
+    }
+    for (int i = 0; i < 180; ++i)
+        world.step(kDt, jobs);
+    const double ms = bench::medianMs(60, [&] { world.step(kDt, jobs); });
+    // Below the surface the ground itself reports, not the analytic one the
+    // sampled terrain only approximates.
+    fellThrough = 0;
+    for (const physics::BodyId id : bodies) {
+        const Vec3 p = world.body(id)->transform.position;
+        physics::CastHit hit;
+        const bool over = physics::rayCast(ground, {}, {p.x, 100.0f, p.z}, {0.0f, -1.0f, 0.0f}, 200.0f, hit);
+        fellThrough += !over || p.y < hit.point.y - 0.25f;
+    }
+    return ms;
+}
+
+// Every character walks at 4 m/s on a heading that turns slowly, one in 97
+// jumping every two seconds.
+void wander(std::span<const physics::CharacterId> characters, int frame, std::vector<physics::CharacterMove>& moves)
+{
+    moves.resize(characters.size());
+    const float time = float(frame) * kDt;
+    for (std::size_t i = 0; i < characters.size(); ++i) {
+        const float heading = 2.4f * float(i) + (i & 1 ? 0.3f : -0.3f) * time;
+        const float jump = i % 97 == 0 && frame % 120 == 0 ? 5.0f : 0.0f;
+        moves[i] = {characters[i], {4.0f * std::cos(heading), jump, 4.0f * std::sin(heading)}};
+    }
+}
+
+// Follows its ring road, centred on the origin, at about 12 m/s.
+physics::VehicleControls drive(const physics::Body& chassis, const physics::VehicleState& state, float ring)
+{
+    const Vec3 p = chassis.transform.position;
+    const float radius = std::sqrt(p.x * p.x + p.z * p.z);
+    const Vec3 along{-p.z / radius, 0.0f, p.x / radius};
+    const Vec3 inward{-p.x / radius, 0.0f, -p.z / radius};
+    const Vec3 target = along + inward * std::clamp(0.2f * (radius - ring), -1.0f, 1.0f);
+    const float heading = std::atan2(math::dot(target, chassis.transform.rotate({1.0f, 0.0f, 0.0f})),
+                                     math::dot(target, chassis.transform.rotate({0.0f, 0.0f, 1.0f})));
+    const float error = 12.0f - state.forwardSpeed;
+    return {.throttle = std::clamp(0.3f * error, 0.0f, 1.0f),
+            .brake = std::clamp(-0.3f * error, 0.0f, 1.0f),
+            .steering = std::clamp(1.5f * heading, -1.0f, 1.0f)};
+}
+
+template <typename Fn>
+double nsPerCall(Fn&& fn)
+{
+    constexpr int kCalls = 20000;
+    return bench::medianMs(9, [&] {
+               for (int i = 0; i < kCalls; ++i)
+                   fn(i);
+           }) *
+           1e6 / kCalls;
+}
+
+} // namespace
+
+int main()
+{
+    bench::Report report("physics");
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency())});
+    report.add("worker_threads", double(jobs.workerCount()), "threads");
+
+    {
+        physics::PhysicsWorld world({.allowSleeping = false});
+        buildPile(world);
+        for (int i = 0; i < 120; ++i)
+            world.step(kDt, jobs);
+
+        report.add("pile_10k_awake_step", bench::medianMs(60, [&] { world.step(kDt, jobs); }), "ms",
+                   "< 4 ms on 8 cores");
+        const physics::PhysicsStats& stats = world.stats();
+        report.add("pile_10k_awake_awake_bodies", double(stats.awakeBodies), "bodies");
+        report.add("pile_10k_awake_contacts", double(stats.contacts), "manifolds");
+        report.add("pile_10k_awake_contact_points", double(stats.contactPoints), "points");
+        report.add("pile_10k_awake_islands", double(stats.islands), "islands");
+        report.add("pile_10k_awake_colors", double(stats.colors), "colors");
+        report.add("pile_10k_awake_overflow_contacts", double(stats.overflowContacts), "contacts");
+        report.add("pile_10k_awake_warm_started_points", double(stats.warmStartedPoints), "points");
+    }
+
+    {
+        double awakeMs = 0.0;
+        for (bool sleeping : {false, true}) {
+            physics::PhysicsWorld world({.allowSleeping = sleeping});
+            buildYard(world, 4);
+            int steps = 0;
+            for (; steps < 1200 && (steps < 120 || (sleeping && world.stats().awakeBodies > 0)); ++steps)
+                world.step(kDt, jobs);
+
+            const double ms = bench::medianMs(60, [&] { world.step(kDt, jobs); });
+            const physics::PhysicsStats& stats = world.stats();
+            const std::string prefix = sleeping ? "yard_10k_asleep" : "yard_10k_awake";
+            report.add(prefix + "_step", ms, "ms");
+            report.add(prefix + "_awake_bodies", double(stats.awakeBodies), "bodies");
+            report.add(prefix + "_islands", double(stats.islands), "islands");
+            if (!sleeping) {
+                awakeMs = ms;
+                continue;
+            }
+            report.add(prefix + "_sleeping_islands", double(stats.sleepingIslands), "islands");
+            report.add(prefix + "_settle_time", double(steps) * kDt, "s");
+            report.add("yard_10k_sleep_speedup", awakeMs / ms, "x");
+        }
+    }
+
+    {
+        physics::PhysicsWorld world({.deterministic = true, .allowSleeping = false});
+        buildPile(world);
+        for (int i = 0; i < 120; ++i)
+            world.step(kDt, jobs);
+        report.add("pile_10k_deterministic_step", bench::medianMs(60, [&] { world.step(kDt, jobs); }), "ms");
+        // Without deterministic mode the hashes can differ, as the pair
+        // cache's slot order depends on how the parallel inserts interleave.
+        for (bool deterministic : {true, false}) {
+            const bool match = pileHash(1, deterministic) == pileHash(4, deterministic);
+            if (deterministic)
+                report.check("deterministic_hash_match_1_vs_4_workers", match);
+            else
+                report.add("default_hash_match_1_vs_4_workers", match ? 1.0 : 0.0, "bool");
+        }
+    }
+
+    {
+        const Vec3 corners[8] = {{-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+                                 {0.5f, 0.5f, -0.5f},   {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f},
+                                 {-0.5f, 0.5f, 0.5f},   {0.5f, 0.5f, 0.5f}};
+        const physics::ConvexHull hull(corners);
+        const physics::Shape box = physics::Shape::box({0.5f, 0.5f, 0.5f});
+        const physics::Shape cube = physics::Shape::convexHull(&hull);
+        const physics::Shape capsule = physics::Shape::capsule(0.3f, 0.5f);
+        const physics::Transform below{};
+        // Resting slightly interpenetrated with a varying twist, as in a stack.
+        auto above = [](int i, float height) {
+            return physics::Transform{{0.05f, height, 0.02f},
+                                      math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, float(i) * 1e-3f)};
+        };
+        physics::ContactManifold manifold;
+        uint32_t points = 0;
+        report.add("narrowphase_box_box", nsPerCall([&](int i) {
+                       points += physics::collide(box, below, box, above(i, 0.995f), 0.02f, manifold);
+                   }),
+                   "ns/pair");
+        report.add("narrowphase_hull_hull_gjk_epa", nsPerCall([&](int i) {
+                       points += physics::collide(cube, below, cube, above(i, 0.995f), 0.02f, manifold);
+                   }),
+                   "ns/pair");
+        report.add("narrowphase_hull_hull_gjk_separated", nsPerCall([&](int i) {
+                       points += physics::collide(cube, below, cube, above(i, 1.01f), 0.02f, manifold);
+                   }),
+                   "ns/pair");
+        report.add("narrowphase_box_capsule", nsPerCall([&](int i) {
+                       points += physics::collide(box, below, capsule, above(i, 1.295f), 0.02f, manifold);
+                   }),
+                   "ns/pair");
+        bench::doNotOptimize(points);
+    }
+
+    report.add("stack5_drift_cold_20_iterations", stackDrift(jobs, 5, false, 20), "m");
+    report.add("stack5_drift_warm_4_iterations", stackDrift(jobs, 5, true, 4), "m");
+    report.add("stack10_drift_cold_20_iterations", stackDrift(jobs, 10, false, 20), "m");
+    report.add("stack10_drift_warm_10_iterations", stackDrift(jobs, 10, true, 10), "m");
+
+    for (bool ccd : {true, false}) {
+        physics::PhysicsWorld world;
+        const std::vector<physics::BodyId> bullets = buildShootingRange(world, ccd);
+        // Impacts start on the third step; with CCD the rounds then tumble
+        // down the wall, without it they are long gone.
+        uint32_t impacts = 0;
+        const double ms = bench::medianMs(10, [&] {
+            world.step(kDt, jobs);
+            impacts += world.stats().impacts;
+        });
+        uint32_t tunneled = 0;
+        for (const physics::BodyId id : bullets)
+            tunneled += world.body(id)->transform.position.x > kWallX + 0.5f;
+        const std::string prefix = ccd ? "bullets_10k_ccd" : "bullets_10k_discrete";
+        report.add(prefix + "_step", ms, "ms");
+        if (ccd)
+            report.check(prefix + "_tunneled", double(tunneled), "bullets", "0", tunneled == 0);
+        else
+            report.add(prefix + "_tunneled", double(tunneled), "bullets");
+        if (ccd)
+            report.add(prefix + "_impacts", double(impacts), "sub-steps");
+    }
+
+    {
+        physics::PhysicsWorld world({.deterministic = true});
+        const std::vector<physics::BodyId> tops = buildYard(world);
+        const RollbackResult falling = recordAndReplay(world, jobs, kSettlingHistoryBytes);
+        report.add("rollback_5k_falling_awake_bodies", falling.awakeBodies, "bodies");
+        report.check("rollback_5k_falling_history", falling.historyMb, "MB", "<= 32 MB", falling.historyMb <= 32.0);
+        report.check("rollback_5k_falling_frames_held", double(falling.framesHeld), "frames", ">= 120",
+                     falling.framesHeld >= 120 && falling.budgetEvictions == 0);
+        report.add("rollback_5k_falling_push", falling.pushMs, "ms");
+        report.check("rollback_5k_falling_replay_matches", falling.replayMatches);
+
+        // Settle, then knock over every fiftieth stack.
+        for (int i = 0; i < 600; ++i)
+            world.step(kDt, jobs);
+        for (std::size_t i = 0; i < tops.size(); i += 50)
+            world.setLinearVelocity(tops[i], {3.0f, 1.0f, 0.0f});
+        const RollbackResult resting = recordAndReplay(world, jobs, kHistoryBytes);
+        report.add("rollback_5k_resting_awake_bodies", resting.awakeBodies, "bodies");
+        report.check("rollback_5k_resting_history", resting.historyMb, "MB", "<= 4 MB", resting.historyMb <= 4.0);
+        report.check("rollback_5k_resting_frames_held", double(resting.framesHeld), "frames", ">= 120",
+                     resting.framesHeld >= 120 && resting.budgetEvictions == 0);
+        report.add("rollback_5k_resting_push", resting.pushMs, "ms");
+        report.add("rollback_5k_resting_rollback_60_frames", resting.rollbackMs, "ms");
+        report.check("rollback_5k_resting_replay_matches", resting.replayMatches);
+
+        std::vector<uint8_t> state;
+        world.saveState(state);
+        report.add("rollback_5k_state_size", double(state.size()) / 1024.0, "KB");
+        report.add("rollback_5k_snapshot", bench::medianMs(50, [&] {
+                       state.clear();
+                       world.saveState(state);
+                   }) * 1e3,
+                   "us");
+        report.add("rollback_5k_restore", bench::medianMs(50, [&] { world.loadState(state); }) * 1e3, "us");
+    }
+
+    {
+        physics::PhysicsWorld world;
+        buildCity(world);
+        world.step(kDt, jobs);
+
+        const std::vector<physics::Ray> fans = sightFans();
+        const std::vector<physics::Ray> scattered = randomRays();
+        const std::size_t count = fans.size();
+        std::vector<physics::BodyId> bodies(count);
+        std::vector<float> distances(count), referenceDistances(count);
+        std::vector<Vec3> points(count), normals(count);
+        const physics::CastResults results{bodies, distances, points, normals};
+
+        physics::SceneQuery packets;
+        physics::SceneQuery singles({.packets = false});
+        report.add("query_packet_width", double(packets.packetWidth()), "rays");
+
+        const double singleMs = bench::medianMs(
+            7, [&] { singles.raycast(world, fans, physics::QueryMode::Closest, results, jobs); });
+        referenceDistances = distances;
+        const double packetMs = bench::medianMs(
+            7, [&] { packets.raycast(world, fans, physics::QueryMode::Closest, results, jobs); });
+        const physics::SceneQueryStats stats = packets.stats();
+        report.add("query_64k_fan_rays_single", singleMs, "ms");
+        report.add("query_64k_fan_rays_packets", packetMs, "ms");
+        report.add("query_fan_rays_in_packets", double(stats.packetRays) / double(stats.queries) * 100.0, "%");
+        report.add("query_fan_packet_speedup", singleMs / packetMs, "x");
+        // Bodies may differ where a ray starts inside two boxes at once.
+        report.check("query_packets_match_single", distances == referenceDistances);
+        report.add("query_64k_fan_rays_any_hit", bench::medianMs(7, [&] {
+                       packets.raycast(world, fans, physics::QueryMode::Any, results, jobs);
+                   }),
+                   "ms");
+        report.add("query_64k_random_rays", bench::medianMs(7, [&] {
+                       packets.raycast(world, scattered, physics::QueryMode::Closest, results, jobs);
+                   }),
+                   "ms");
+        uint32_t hits = 0;
+        for (const physics::BodyId id : bodies)
+            hits += !id.isNull();
+        report.add("query_random_rays_hit", double(hits), "rays");
+
+        std::vector<physics::ShapeSweep> sweeps;
+        std::vector<physics::ShapeOverlap> overlaps;
+        for (uint32_t i = 0; i < 4096; ++i) {
+            const physics::Ray& ray = scattered[i];
+            const physics::Transform start{ray.origin, {}};
+            sweeps.push_back({physics::Shape::capsule(0.4f, 0.5f), start, ray.direction, 10.0f, {}});
+            overlaps.push_back({physics::Shape::capsule(0.4f, 0.5f), start});
+        }
+        report.add("query_4k_capsule_sweeps", bench::medianMs(7, [&] {
+                       packets.sweep(world, sweeps, physics::QueryMode::Closest,
+                                     {{bodies.data(), sweeps.size()}, {distances.data(), sweeps.size()}, {}, {}},
+                                     jobs);
+                   }),
+                   "ms");
+        std::vector<uint32_t> overlapCounts(overlaps.size());
+        report.add("query_4k_capsule_overlaps", bench::medianMs(7, [&] {
+                       packets.overlap(world, overlaps, {16, overlapCounts, bodies}, jobs);
+                   }),
+                   "ms");
+    }
+
+    {
+        physics::PhysicsWorld rigid;
+        physics::SoftBodyWorld soft;
+        const std::vector<physics::SoftBodyId> capes = buildCapes(rigid, soft);
+        float time = 0.0f;
+        auto stepCapes = [&] {
+            time += kDt;
+            for (std::size_t i = 0; i < capes.size(); ++i) {
+                const Vec3 shoulder = capeShoulder(int(i), time);
+                for (uint32_t column = 0; column < 32; ++column)
+                    soft.setPinned(capes[i], column,
+                                   {shoulder.x + (float(column) - 15.5f) * kCapeSpacing, shoulder.y, shoulder.z});
+            }
+            soft.step(kDt, &rigid, jobs);
+        };
+        for (int i = 0; i < 120; ++i)
+            stepCapes();
+        const double ms = bench::medianMs(120, stepCapes);
+        const physics::SoftBodyStats& stats = soft.stats();
+        report.add("cloth_50_capes_step", ms, "ms", "< 2 ms");
+        report.add("cloth_simd_level", double(soft.simdLevel()), "level");
+        report.add("cloth_particles", double(stats.particles), "particles");
+        report.add("cloth_distance_constraints", double(stats.distanceConstraints), "constraints");
+        report.add("cloth_colors", double(stats.colors), "colors");
+        report.add("cloth_overflow_constraints", double(stats.overflow), "constraints");
+        report.add("cloth_collisions_per_step", double(stats.collisions), "pushes");
+
+        // Worst stretch of a structural link, as a ratio of rest length.
+        float stretch = 0.0f;
+        for (const physics::SoftBodyId cape : capes) {
+            const std::span<const physics::SoftParticle> particles = soft.particles(cape);
+            for (uint32_t i = 0; i + 1 < particles.size(); ++i) {
+                if ((i + 1) % 32 != 0)
+                    stretch = std::max(stretch,
+                                       math::length(particles[i + 1].position - particles[i].position) / kCapeSpacing);
+            }
+        }
+        report.add("cloth_max_stretch", stretch, "x rest");
+
+        physics::SoftBodyWorld blocks;
+        const physics::SoftBodyId block =
+            blocks.createBody(physics::makeBlock(6, 6, 6, 0.1f, {{-5.0f, 1.0f, -5.0f}, {}}));
+        for (int i = 0; i < 180; ++i)
+            blocks.step(kDt, &rigid, jobs);
+        float lowest = FLT_MAX;
+        for (const physics::SoftParticle& particle : blocks.particles(block))
+            lowest = std::min(lowest, particle.position.y);
+        report.add("soft_block_volume_constraints", double(blocks.stats().volumeConstraints), "constraints");
+        // Resting on the ground at its particle radius.
+        report.check("soft_block_lowest_particle", lowest, "m", "0.02", std::abs(lowest - 0.02f) < 0.005f);
+    }
+
+    {
+        constexpr uint32_t kSamples = 1025;
+        std::vector<float> heights;
+        for (uint32_t r = 0; r < kSamples; ++r) {
+            for (uint32_t c = 0; c < kSamples; ++c)
+                heights.push_back(terrainHeight(float(c) - 512.0f, float(r) - 512.0f));
+        }
+        const physics::Heightfield field({kSamples, kSamples, 1.0f, heights});
+        report.add("heightfield_1m_bytes_per_sample", double(field.memoryUsage()) / double(heights.size()), "B");
+
+        const std::vector<physics::Ray> rays = terrainRays(500.0f);
+        bool matches = false;
+        int hits = 0;
+        const double ms = castTerrainRays(
+            rays, [&](const physics::Ray& ray, physics::CastHit& hit) {
+                return field.rayCast(ray.origin, ray.direction, ray.maxDistance, hit);
+            },
+            [&](auto&& fn) { field.queryTriangles(field.bounds(), fn); }, matches, hits);
+        report.add("heightfield_64k_rays", ms, "ms");
+        report.add("heightfield_rays_hit", double(hits), "rays");
+        report.check("heightfield_rays_match_brute_force", matches);
+
+        uint32_t triangles = 0;
+        report.add("heightfield_64k_box_queries", bench::medianMs(5, [&] {
+                       triangles = 0;
+                       for (const physics::Ray& ray : rays) {
+                           const Vec3 p{ray.origin.x, terrainHeight(ray.origin.x, ray.origin.z), ray.origin.z};
+                           field.queryTriangles(physics::Aabb::fromCenterExtents(p, Vec3{1.0f}),
+                                                [&](uint32_t, const Vec3*) { ++triangles; });
+                       }
+                   }),
+                   "ms");
+        report.add("heightfield_box_query_triangles", double(triangles) / double(rays.size()), "triangles");
+
+        int fellThrough = 0;
+        report.add("heightfield_1k_bodies_step", dropOnTerrain(physics::Shape::heightfield(&field), jobs, fellThrough),
+                   "ms");
+        report.check("heightfield_bodies_fell_through", double(fellThrough), "bodies", "0", fellThrough == 0);
+    }
+
+    {
+        std::vector<Vec3> vertices;
+        std::vector<uint32_t> indices;
+        terrainMesh(512, vertices, indices);
+        std::vector<uint8_t> cooked;
+        report.add("mesh_512k_cook", bench::medianMs(3, [&] { cooked = physics::TriangleMesh::cook(vertices, indices); }),
+                   "ms");
+        const char* path = "bench_terrain.rbtm";
+        writeFile(path, cooked);
+        MappedFile file;
+        std::optional<physics::TriangleMesh> mesh;
+        report.add("mesh_512k_map_and_load", bench::medianMs(5, [&] {
+                       file.open(path);
+                       mesh.emplace(file.bytes());
+                   }) * 1e3,
+                   "us");
+        report.add("mesh_triangles", double(mesh->triangleCount()), "triangles");
+        const double bytesPerTriangle = double(mesh->memoryUsage()) / double(mesh->triangleCount());
+        report.check("mesh_bytes_per_triangle", bytesPerTriangle, "B", "< 16 B", bytesPerTriangle < 16.0);
+
+        const std::vector<physics::Ray> rays = terrainRays(250.0f);
+        bool matches = false;
+        int hits = 0;
+        const double ms = castTerrainRays(
+            rays, [&](const physics::Ray& ray, physics::CastHit& hit) {
+                return mesh->rayCast(ray.origin, ray.direction, ray.maxDistance, hit);
+            },
+            [&](auto&& fn) { mesh->queryTriangles(mesh->bounds(), fn); }, matches, hits);
+        report.add("mesh_64k_rays", ms, "ms");
+        report.add("mesh_rays_hit", double(hits), "rays");
+        report.check("mesh_rays_match_brute_force", matches);
+
+        int fellThrough = 0;
+        report.add("mesh_1k_bodies_step", dropOnTerrain(physics::Shape::triangleMesh(&*mesh), jobs, fellThrough),
+                   "ms");
+        report.check("mesh_bodies_fell_through", double(fellThrough), "bodies", "0", fellThrough == 0);
+        mesh.reset();
+        file.close();
+        std::remove(path);
+    }
+
+    {
+        // 10 x 4 x 5 m of water at 0.1 m spacing against the left wall of a
+        // 20 m tank.
+        physics::FluidWorld fluid({.bounds = {{-10.0f, 0.0f, -2.5f}, {10.0f, 8.0f, 2.5f}}});
+        std::vector<Vec3> positions;
+        for (int y = 0; y < 40; ++y) {
+            for (int z = 0; z < 50; ++z) {
+                for (int x = 0; x < 100; ++x)
+                    positions.push_back({-9.95f + 0.1f * float(x), 0.05f + 0.1f * float(y), -2.45f + 0.1f * float(z)});
+            }
+        }
+        fluid.addParticles(positions);
+        for (int i = 0; i < 10; ++i)
+            fluid.step(kDt, jobs);
+        const double ms = bench::medianMs(5, [&] { fluid.step(kDt, jobs); });
+        const physics::FluidStats& stats = fluid.stats();
+        report.add("fluid_200k_step", ms, "ms");
+        report.add("fluid_particles_per_second_per_core",
+                   double(stats.particles) / (ms * 1e-3) / double(jobs.workerCount()), "particles/s");
+        report.add("fluid_cells", double(stats.cells), "cells");
+        report.add("fluid_ranges_per_cell", double(stats.ranges) / double(stats.cells), "ranges");
+        report.add("fluid_candidates_per_particle", double(stats.candidates) / double(stats.particles), "pairs");
+        report.add("fluid_density_error", stats.densityError * 100.0, "%");
+        bool inside = true;
+        for (uint32_t i = 0; i < fluid.particleCount(); ++i) {
+            const Vec3 p = fluid.position(i);
+            inside = inside && p.x >= -10.0f && p.x <= 10.0f && p.y >= 0.0f && p.y <= 8.0f && p.z >= -2.5f &&
+                     p.z <= 2.5f;
+        }
+        report.check("fluid_particles_in_tank", inside);
+    }
+
+    {
+        constexpr uint32_t kSamples = 257;
+        std::vector<float> heights;
+        for (uint32_t r = 0; r < kSamples; ++r) {
+            for (uint32_t c = 0; c < kSamples; ++c)
+                heights.push_back(terrainHeight(float(c) - 128.0f, float(r) - 128.0f));
+        }
+        const physics::Heightfield field({kSamples, kSamples, 1.0f, heights});
+        const physics::Shape ground = physics::Shape::heightfield(&field);
+        physics::PhysicsWorld world;
+        world.createBody({.type = physics::BodyType::Static, .shape = ground});
+        // Kerbs low enough to step onto, and crates to walk around, sunk
+        // 10 cm into the slope.
+        std::mt19937 rng(41);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int i = 0; i < 1500; ++i) {
+            const float x = -110.0f + 220.0f * unit(rng), z = -110.0f + 220.0f * unit(rng);
+            const float height = i % 3 == 0 ? 0.2f + 0.2f * unit(rng) : 0.5f + 1.5f * unit(rng);
+            const Vec3 half{0.5f + 1.5f * unit(rng), 0.5f * height, 0.5f + 1.5f * unit(rng)};
+            world.createBody({.type = physics::BodyType::Static,
+                              .shape = physics::Shape::box(half),
+                              .position = {x, terrainHeight(x, z) + half.y - 0.1f, z},
+                              .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 6.28f * unit(rng))});
+        }
+
+        physics::CharacterWorld characters;
+        std::vector<physics::CharacterId> ids;
+        for (int i = 0; i < 2000; ++i) {
+            const float x = -100.0f + 200.0f * unit(rng), z = -100.0f + 200.0f * unit(rng);
+            ids.push_back(characters.createCharacter({.position = {x, terrainHeight(x, z) + 3.0f, z}}));
+        }
+        std::vector<physics::CharacterMove> moves;
+        int frame = 0;
+        for (; frame < 300; ++frame) {
+            wander(ids, frame, moves);
+            characters.move(world, moves, kDt, jobs);
+        }
+        const double ms = bench::medianMs(60, [&] {
+            wander(ids, frame++, moves);
+            characters.move(world, moves, kDt, jobs);
+        });
+        const physics::CharacterStats& stats = characters.stats();
+        report.add("characters_2k_move", ms, "ms", "< 1 ms");
+        report.add("characters_moves_per_second_per_core", double(stats.moves) / (ms * 1e-3) / double(jobs.workerCount()),
+                   "moves/s");
+        report.add("characters_colliders_per_move", double(stats.colliders) / double(stats.moves), "bodies");
+        report.add("characters_planes_per_move", double(stats.planes) / double(stats.moves), "planes");
+        report.add("characters_passes_per_move", double(stats.passes) / double(stats.moves), "passes");
+        report.add("characters_grounded", double(stats.grounded) / double(stats.moves) * 100.0, "%");
+        report.add("characters_step_ups", double(stats.steps), "moves");
+        report.add("characters_snaps", double(stats.snaps), "moves");
+        // Under the surface the heightfield itself reports.
+        int below = 0;
+        for (const physics::CharacterId id : ids) {
+            const Vec3 p = characters.state(id).position;
+            physics::CastHit hit;
+            const bool over = physics::rayCast(ground, {}, {p.x, 100.0f, p.z}, {0.0f, -1.0f, 0.0f}, 200.0f, hit);
+            below += !over || p.y - 0.9f < hit.point.y - 0.05f;
+        }
+        report.check("characters_below_ground", double(below), "characters", "0", below == 0);
+    }
+
+    {
+        constexpr uint32_t kSamples = 257;
+        std::vector<float> heights;
+        for (uint32_t r = 0; r < kSamples; ++r) {
+            for (uint32_t c = 0; c < kSamples; ++c)
+                heights.push_back(0.25f * terrainHeight(float(c) - 128.0f, float(r) - 128.0f));
+        }
+        const physics::Heightfield field({kSamples, kSamples, 1.0f, heights});
+        physics::PhysicsWorld world;
+        world.createBody({.type = physics::BodyType::Static, .shape = physics::Shape::heightfield(&field)});
+        physics::VehicleWorld vehicles;
+        std::vector<physics::VehicleId> cars;
+        std::vector<physics::BodyId> chassis;
+        std::vector<float> rings;
+        for (int i = 0; i < 500; ++i) {
+            const float ring = 30.0f + 5.0f * float(i / 28), angle = 6.2831853f * float(i % 28) / 28.0f;
+            const float x = ring * std::cos(angle), z = ring * std::sin(angle);
+            chassis.push_back(world.createBody({.shape = physics::Shape::box({0.9f, 0.4f, 2.2f}),
+                                                .position = {x, 0.25f * terrainHeight(x, z) + 1.0f, z},
+                                                .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, -angle),
+                                                .mass = 1300.0f}));
+            physics::VehicleDesc car = physics::makeCar(chassis.back(), 0.8f, 1.4f, -0.2f);
+            car.cast = i % 4 == 0 ? physics::WheelCast::Sphere : physics::WheelCast::Ray;
+            cars.push_back(vehicles.createVehicle(car));
+            rings.push_back(ring);
+        }
+        const auto steer = [&] {
+            for (std::size_t i = 0; i < cars.size(); ++i)
+                vehicles.setControls(cars[i], drive(*world.body(chassis[i]), vehicles.state(cars[i]), rings[i]));
+        };
+        for (int i = 0; i < 300; ++i) {
+            steer();
+            vehicles.update(world, kDt, jobs);
+            world.step(kDt, jobs);
+        }
+        std::vector<double> updates;
+        const double frameMs = bench::medianMs(60, [&] {
+            steer();
+            const bench::Timer timer;
+            vehicles.update(world, kDt, jobs);
+            updates.push_back(timer.elapsedMs());
+            world.step(kDt, jobs);
+        });
+        std::sort(updates.begin(), updates.end());
+        const physics::VehicleStats& stats = vehicles.stats();
+        report.add("vehicles_500_update", updates[updates.size() / 2], "ms", "< 2 ms");
+        report.add("vehicles_500_frame", frameMs, "ms", "< 8 ms");
+        report.add("vehicles_wheel_queries", double(stats.rayWheels + stats.sphereWheels), "queries");
+        report.add("vehicles_wheels_on_ground", double(stats.contacts) / double(stats.wheels) * 100.0, "%");
+        double speed = 0.0;
+        int upright = 0;
+        for (std::size_t i = 0; i < cars.size(); ++i) {
+            speed += vehicles.state(cars[i]).forwardSpeed;
+            upright += world.body(chassis[i])->transform.rotate({0.0f, 1.0f, 0.0f}).y > 0.7f;
+        }
+        report.add("vehicles_mean_speed", speed / double(cars.size()), "m/s");
+        report.check("vehicles_upright", double(upright), "vehicles", "500", upright == int(cars.size()));
+    }
+    return report.exitCode();
+}
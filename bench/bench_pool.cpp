@@ -0,0 +1,101 @@
+#include "bench_common.h"
+
+#include "core/jobs/job_system.h"
+#include "core/memory/pool.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace rebel;
+
+// Stand-in for a physics contact point: the pool only cares about size.
+struct ContactLike {
+    float position[3];
+    float normal[3];
+    float depth;
+    float impulses[3];
+    uint64_t pairKey;
+    uint32_t bodies[2];
+    uint32_t pad[2];
+};
+
+constexpr uint32_t kLive = 100'000;
+constexpr uint32_t kChurn = 1'000'000;
+
+} // namespace
+
+int main()
+{
+    bench::Report report("pool");
+
+    memory::Pool<ContactLike> pool(kLive * 2);
+    std::vector<memory::Handle<ContactLike>> handles(kLive);
+    for (uint32_t i = 0; i < kLive; ++i)
+        handles[i] = pool.create();
+
+    // Steady-state churn: destroy one, create one, like contacts appearing and
+    // disappearing every frame.
+    uint32_t rng = 12345;
+    const double poolMs = bench::medianMs(5, [&] {
+        for (uint32_t i = 0; i < kChurn; ++i) {
+            rng = rng * 1664525u + 1013904223u;
+            const uint32_t victim = rng % kLive;
+            pool.destroy(handles[victim]);
+            handles[victim] = pool.create();
+        }
+    });
+    report.add("pool_churn", poolMs * 1e6 / kChurn, "ns/op");
+
+    std::vector<ContactLike*> raw(kLive);
+    for (uint32_t i = 0; i < kLive; ++i)
+        raw[i] = new ContactLike();
+    const double heapMs = bench::medianMs(5, [&] {
+        for (uint32_t i = 0; i < kChurn; ++i) {
+            rng = rng * 1664525u + 1013904223u;
+            const uint32_t victim = rng % kLive;
+            delete raw[victim];
+            raw[victim] = new ContactLike();
+        }
+    });
+    report.add("new_delete_churn", heapMs * 1e6 / kChurn, "ns/op");
+    for (ContactLike* p : raw)
+        delete p;
+
+    // Half of these handles are stale; resolving them is a generation compare.
+    std::vector<memory::Handle<ContactLike>> mixed(handles);
+    for (uint32_t i = 0; i < kLive; i += 2) {
+        pool.destroy(handles[i]);
+        handles[i] = pool.create();
+    }
+    uint32_t resolved = 0;
+    const double getMs = bench::medianMs(11, [&] {
+        resolved = 0;
+        for (const auto& h : mixed)
+            resolved += pool.get(h) != nullptr;
+    });
+    report.add("get_with_stale_check", getMs * 1e6 / kLive, "ns/op");
+    report.add("stale_handles_detected", double(kLive - resolved), "handles", std::to_string(kLive / 2));
+
+    // Every worker replaces handles in one shared array, so slots freed on
+    // one thread are handed out again on another.
+    std::vector<std::atomic<memory::Handle<ContactLike>>> shared(kLive);
+    for (uint32_t i = 0; i < kLive; ++i)
+        shared[i].store(handles[i], std::memory_order_relaxed);
+    jobs::JobSystem jobs({.workerCount = std::max(1u, std::thread::hardware_concurrency())});
+    const double parallelMs = bench::medianMs(5, [&] {
+        jobs.parallelFor(kChurn, 8192, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const uint32_t victim = (i * 2654435761u) % kLive;
+                pool.destroy(shared[victim].exchange(pool.create(), std::memory_order_acq_rel));
+            }
+        });
+    });
+    report.add("pool_churn_all_workers", parallelMs * 1e6 / kChurn, "ns/op");
+    report.check("pool_live_after_churn", double(pool.size()), "objects", std::to_string(kLive),
+                 pool.size() == kLive);
+    return report.exitCode();
+}
@@ -0,0 +1,82 @@
+#include "animation/blend/animation_budget.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace rebel::animation {
+
+AnimationBudget::AnimationBudget(const AnimationBudgetDesc& desc)
+    : milliseconds_(desc.milliseconds)
+    , microsecondsPerWork_(desc.microsecondsPerWork)
+    , smoothing_(desc.smoothing)
+{
+    const std::span<const AnimationLod> levels = desc.levels.empty() ? kDefaultLevels : desc.levels;
+    REBEL_ASSERT(levels.size() <= AnimationBudgetStats::kMaxLevels, "too many animation LOD levels");
+    levels_.assign(levels.begin(), levels.end());
+    stats_.microsecondsPerWork = microsecondsPerWork_;
+}
+
+void AnimationBudget::assign(std::span<AnimatorInstance> instances, std::span<const float> importance)
+{
+    REBEL_ASSERT(importance.size() == instances.size(), "budgets need an importance per instance");
+    const uint32_t count = uint32_t(instances.size());
+    const uint32_t levels = uint32_t(levels_.size());
+    order_.resize(count);
+    std::iota(order_.begin(), order_.end(), 0u);
+    std::sort(order_.begin(), order_.end(), [&](uint32_t a, uint32_t b) { return importance[a] > importance[b]; });
+
+    // Per level, the work of every character up to each rank.
+    prefix_.assign(std::size_t(levels) * (count + 1), 0.0);
+    for (uint32_t level = 0; level < levels; ++level) {
+        double* sum = prefix_.data() + std::size_t(level) * (count + 1);
+        for (uint32_t r = 0; r < count; ++r)
+            sum[r + 1] = sum[r] + Animator::work(*instances[order_[r]].tree, levels_[level]);
+    }
+    // Rank where level `level`'s band ends for a band width of d.
+    auto bandEnd = [&](uint32_t level, uint64_t d) {
+        return level + 1 == levels ? count : uint32_t(std::min<uint64_t>(d * ((2ull << level) - 1), count));
+    };
+    auto predict = [&](uint64_t d) {
+        double work = 0.0;
+        for (uint32_t level = 0, begin = 0; level < levels; ++level) {
+            const uint32_t end = bandEnd(level, d);
+            const double* sum = prefix_.data() + std::size_t(level) * (count + 1);
+            work += sum[end] - sum[begin];
+            begin = end;
+        }
+        return work;
+    };
+
+    // The widest bands whose work fits; the work only grows with d.
+    const double budget = double(milliseconds_) * 1000.0 / double(microsecondsPerWork_);
+    uint64_t low = 0, high = count;
+    while (low < high) {
+        const uint64_t mid = (low + high + 1) / 2;
+        if (predict(mid) <= budget)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+
+    std::fill(std::begin(stats_.characters), std::end(stats_.characters), 0u);
+    for (uint32_t level = 0, r = 0; level < levels; ++level) {
+        for (const uint32_t end = bandEnd(level, low); r < end; ++r)
+            instances[order_[r]].lod = levels_[level];
+        stats_.characters[level] = bandEnd(level, low) - (level ? bandEnd(level - 1, low) : 0);
+    }
+    stats_.predictedWork = predict(low);
+    stats_.predictedMilliseconds = float(stats_.predictedWork * double(microsecondsPerWork_) / 1000.0);
+}
+
+void AnimationBudget::calibrate(const AnimatorStats& stats)
+{
+    if (stats.work == 0)
+        return;
+    const float measured = stats.milliseconds * 1000.0f / float(stats.work);
+    microsecondsPerWork_ += (measured - microsecondsPerWork_) * smoothing_;
+    stats_.microsecondsPerWork = microsecondsPerWork_;
+}
+
+} // namespace rebel::animation
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "animation/blend/animator.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::animation {
+
+struct AnimationBudgetDesc {
+    /// Target time of Animator::update per frame.
+    float milliseconds = 2.0f;
+    /// From best to cheapest; empty for kDefaultLevels.
+    std::span<const AnimationLod> levels = {};
+    /// First guess at the cost of a unit of AnimatorStats::work, refined
+    /// by calibrate().
+    float microsecondsPerWork = 0.01f;
+    /// How far each calibrate() moves the estimate towards its measurement.
+    float smoothing = 0.25f;
+};
+
+struct AnimationBudgetStats {
+    static constexpr uint32_t kMaxLevels = 8;
+
+    double predictedWork = 0.0;
+    float predictedMilliseconds = 0.0f;
+    float microsecondsPerWork = 0.0f;
+    uint32_t characters[kMaxLevels] = {}; // per level
+};
+
+/// Assigns animation LODs so that Animator::update takes a fixed time per
+/// frame whatever the crowd size.
+///
+/// Characters are ranked by importance and given levels in bands that
+/// double in width: the first d characters get the best level, the next
+/// 2d the second, the next 4d the third and so on, everyone past the
+/// bands the cheapest. That matches how many characters a camera sees at
+/// each distance, and detail falls off smoothly rather than in one step.
+/// d is the largest whose predicted cost fits, found by binary search
+/// over per-level prefix sums of the ranked characters' costs.
+///
+/// Costs are predicted as AnimatorStats::work (Animator::work() per
+/// character), converted to time by an estimate that calibrate() keeps
+/// fitted to the measured updates; the estimate absorbs the machine's
+/// speed and core count.
+class AnimationBudget {
+public:
+    static constexpr AnimationLod kDefaultLevels[] = {{1, 0}, {2, 0}, {4, 1}, {8, 2}};
+
+    explicit AnimationBudget(const AnimationBudgetDesc& desc = {});
+
+    void setMilliseconds(float milliseconds) { milliseconds_ = milliseconds; }
+    float milliseconds() const { return milliseconds_; }
+
+    /// Sets every instance's lod from its importance (one per instance, in
+    /// any unit where larger matters more, such as screen size).
+    void assign(std::span<AnimatorInstance> instances, std::span<const float> importance);
+
+    /// Refines the cost estimate from an update's stats.
+    void calibrate(const AnimatorStats& stats);
+
+    const AnimationBudgetStats& stats() const { return stats_; }
+
+private:
+    std::vector<AnimationLod> levels_;
+    float milliseconds_;
+    float microsecondsPerWork_;
+    float smoothing_;
+    std::vector<uint32_t> order_;    // by importance
+    std::vector<double> prefix_;     // per level, work up to each rank
+    AnimationBudgetStats stats_;
+};
+
+} // namespace rebel::animation
@@ -0,0 +1,100 @@
+#include "animation/blend/animator.h"
+
+#include "animation/blend/blend_kernels.h"
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace rebel::animation {
+
+double Animator::work(const BlendTree& tree, AnimationLod lod)
+{
+    const double bones = double(tree.boneCount(lod.skeletonLevel));
+    const double evaluation = bones * double(tree.instructionCount());
+    return lod.interval > 1 ? evaluation / double(lod.interval) + bones : evaluation;
+}
+
+bool Animator::due(const AnimatorInstance& instance) const
+{
+    const AnimatorHistory* history = instance.history;
+    return instance.lod.interval == 1 || !history->valid || history->skeletonLevel != instance.lod.skeletonLevel ||
+           frame_ - history->updated >= instance.lod.interval;
+}
+
+void Animator::animate(const AnimatorInstance& instance, uint32_t index) const
+{
+    const BlendTree& tree = *instance.tree;
+    const uint32_t level = instance.lod.skeletonLevel;
+    const uint32_t interval = instance.lod.interval;
+    if (interval == 1) {
+        tree.evaluate(instance.parameters, *instance.pose, level);
+        if (instance.history)
+            instance.history->valid = false;
+        return;
+    }
+
+    AnimatorHistory& history = *instance.history;
+    // The level's groups, as Float4s.
+    const std::size_t size = std::size_t(PoseBuffer::groupCount(tree.boneCount(level))) * PoseBuffer::kComponents;
+    if (due(instance)) {
+        if (history.current.boneCount() != tree.boneCount()) {
+            history.previous.resize(tree.boneCount());
+            history.current.resize(tree.boneCount());
+        }
+        std::swap(history.previous, history.current);
+        tree.evaluate(instance.parameters, history.current, level);
+        if (history.valid && history.skeletonLevel == level) {
+            history.updated = frame_;
+        } else {
+            // Start from a still pose, as if evaluated up to an interval
+            // ago, staggered by index.
+            std::copy(history.current.data(), history.current.data() + size, history.previous.data());
+            history.updated = frame_ - (index & (interval - 1));
+            history.skeletonLevel = uint8_t(level);
+            history.valid = true;
+        }
+    }
+
+    const math::Float4 t(float(frame_ - history.updated) / float(interval));
+    math::Float4* out = instance.pose->data();
+    std::copy(history.previous.data(), history.previous.data() + size, out);
+    for (std::size_t g = 0; g < size; g += PoseBuffer::kComponents)
+        detail::blendGroup(out + g, history.current.data() + g, t);
+}
+
+void Animator::update(std::span<const AnimatorInstance> instances, jobs::JobSystem& jobs)
+{
+    const auto start = std::chrono::steady_clock::now();
+    stats_ = {};
+    stats_.characters = uint32_t(instances.size());
+    for (const AnimatorInstance& instance : instances) {
+        REBEL_ASSERT(instance.tree && instance.pose, "animator instances need a tree and a pose");
+        REBEL_ASSERT(instance.pose->boneCount() == instance.tree->boneCount(), "pose size mismatch");
+        const uint32_t interval = instance.lod.interval;
+        REBEL_ASSERT(interval >= 1 && interval <= kMaxInterval && (interval & (interval - 1)) == 0,
+                     "update intervals are 1, 2, 4 or 8 frames");
+        REBEL_ASSERT(interval == 1 || instance.history, "update intervals above 1 need a history");
+        const uint32_t bones = instance.tree->boneCount(instance.lod.skeletonLevel);
+        stats_.bones += bones;
+        if (due(instance)) {
+            ++stats_.evaluated;
+            stats_.work += uint64_t(bones) * instance.tree->instructionCount();
+        }
+        if (interval > 1) {
+            ++stats_.interpolated;
+            stats_.work += bones;
+        }
+    }
+
+    jobs.parallelFor(uint32_t(instances.size()), kCharactersPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            animate(instances[i], i);
+    });
+    ++frame_;
+    stats_.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace rebel::animation
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "animation/blend/blend_tree.h"
+#include "animation/pose_buffer.h"
+
+#include <cstdint>
+#include <span>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::animation {
+
+/// How much of a character is animated each frame.
+struct AnimationLod {
+    /// Frames between evaluations: 1, 2, 4 or 8. Between evaluations the
+    /// pose is interpolated from the last two, one interval behind.
+    uint8_t interval = 1;
+    /// Skeleton level (see Skeleton); bones it drops keep their last pose.
+    uint8_t skeletonLevel = 0;
+};
+
+/// What a character updated less than every frame keeps between frames.
+struct AnimatorHistory {
+    PoseBuffer previous;
+    PoseBuffer current;
+    uint32_t updated = 0; // the frame `current` counts from
+    uint8_t skeletonLevel = 0;
+    bool valid = false;
+};
+
+struct AnimatorInstance {
+    const BlendTree* tree = nullptr;
+    /// tree->parameterCount() values.
+    std::span<const float> parameters;
+    /// Overwritten; tree->boneCount() bones.
+    PoseBuffer* pose = nullptr;
+    AnimationLod lod = {};
+    /// Needed for intervals above 1.
+    AnimatorHistory* history = nullptr;
+};
+
+struct AnimatorStats {
+    uint32_t characters = 0;
+    uint32_t evaluated = 0;
+    uint32_t interpolated = 0;
+    uint32_t bones = 0; // over the characters' skeleton levels
+    /// Bones times instructions evaluated, plus bones interpolated: what
+    /// AnimationBudget predicts the update's time from.
+    uint64_t work = 0;
+    float milliseconds = 0.0f;
+};
+
+/// Evaluates many characters' blend trees per frame. Characters are split
+/// into jobs of kCharactersPerJob; each job evaluates its characters one
+/// after another, every tree's registers in the worker's scratch arena.
+///
+/// A character with an interval above 1 is evaluated once per interval
+/// into its history. Characters are staggered from their first update by
+/// their index, so a crowd at one interval spreads its evaluations evenly
+/// over frames. Every other frame the output is nlerped between the
+/// history's two poses. A change of skeleton level restarts the history.
+class Animator {
+public:
+    static constexpr uint32_t kCharactersPerJob = 16;
+    static constexpr uint32_t kMaxInterval = 8;
+
+    void update(std::span<const AnimatorInstance> instances, jobs::JobSystem& jobs);
+
+    /// Updates so far.
+    uint32_t frame() const { return frame_; }
+    const AnimatorStats& stats() const { return stats_; }
+
+    /// The work AnimatorStats counts for one character at `lod`, averaged
+    /// over its interval.
+    static double work(const BlendTree& tree, AnimationLod lod);
+
+private:
+    bool due(const AnimatorInstance& instance) const;
+    void animate(const AnimatorInstance& instance, uint32_t index) const;
+
+    uint32_t frame_ = 0;
+    AnimatorStats stats_;
+};
+
+} // namespace rebel::animation
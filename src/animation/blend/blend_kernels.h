@@ -0,0 +1,55 @@
+#pragma once
+
+#include "animation/pose_buffer.h"
+#include "core/math/simd.h"
+#include "core/platform.h"
+
+// Per-group pose blends shared by BlendTree and Animator. Each takes one
+// group of a PoseBuffer and its weights, a Float4 with one per bone.
+
+namespace rebel::animation::detail {
+
+using math::Float4;
+
+// nlerp of a group's rotations towards b's on the shorter arc, and lerp
+// of its translations and scales.
+REBEL_FORCEINLINE void blendGroup(Float4* a, const Float4* b, Float4 w)
+{
+    const Float4 flip = math::cmpLt(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3], Float4::zero()) &
+                        Float4(-0.0f);
+    Float4 q[4];
+    for (int c = 0; c < 4; ++c)
+        q[c] = math::madd(Float4(_mm_xor_ps(b[c], flip)) - a[c], w, a[c]);
+    const Float4 scale = math::rsqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int c = 0; c < 4; ++c)
+        a[c] = q[c] * scale;
+    for (uint32_t c = 4; c < PoseBuffer::kComponents; ++c)
+        a[c] = math::madd(b[c] - a[c], w, a[c]);
+}
+
+// A group of b's deltas applied to a by w: a's rotations times b's
+// nlerped from identity, translations plus b's, scales times b's lerped
+// from one.
+REBEL_FORCEINLINE void addGroup(Float4* a, const Float4* b, Float4 w)
+{
+    const Float4 one(1.0f);
+    const Float4 flip = math::cmpLt(b[3], Float4::zero()) & Float4(-0.0f);
+    Float4 d[4];
+    for (int c = 0; c < 3; ++c)
+        d[c] = Float4(_mm_xor_ps(b[c], flip)) * w;
+    d[3] = math::madd(Float4(_mm_xor_ps(b[3], flip)) - one, w, one);
+    const Float4 scale = math::rsqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2] + d[3] * d[3]);
+    for (Float4& c : d)
+        c *= scale;
+    const Float4 x = a[0], y = a[1], z = a[2], s = a[3];
+    a[0] = s * d[0] + x * d[3] + y * d[2] - z * d[1];
+    a[1] = s * d[1] - x * d[2] + y * d[3] + z * d[0];
+    a[2] = s * d[2] + x * d[1] - y * d[0] + z * d[3];
+    a[3] = s * d[3] - x * d[0] - y * d[1] - z * d[2];
+    for (uint32_t c = 4; c < 7; ++c)
+        a[c] = math::madd(b[c], w, a[c]);
+    for (uint32_t c = 7; c < PoseBuffer::kComponents; ++c)
+        a[c] = a[c] * math::madd(b[c] - one, w, one);
+}
+
+} // namespace rebel::animation::detail
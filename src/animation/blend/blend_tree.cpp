@@ -0,0 +1,215 @@
+#include "animation/blend/blend_tree.h"
+
+#include "animation/blend/blend_kernels.h"
+#include "core/assert.h"
+#include "core/memory/linear_arena.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace rebel::animation {
+
+namespace {
+
+using detail::addGroup;
+using detail::blendGroup;
+using math::Float4;
+
+constexpr uint32_t kComponents = PoseBuffer::kComponents;
+
+// Combines every group of b into a, by `weight` times the group's mask,
+// if any.
+template <void (*Group)(Float4*, const Float4*, Float4)>
+void combine(Float4* a, const Float4* b, uint32_t groups, const Float4* mask, float weight)
+{
+    const Float4 w(weight);
+    for (uint32_t g = 0; g < groups; ++g)
+        Group(a + std::size_t(g) * kComponents, b + std::size_t(g) * kComponents, mask ? mask[g] * w : w);
+}
+
+float clampWeight(float w)
+{
+    return std::clamp(w, 0.0f, 1.0f);
+}
+
+float wrapPhase(float phase)
+{
+    return phase - std::floor(phase);
+}
+
+// The point of ascending `axis` at or below v, and the weight of the one
+// after it; the weight is zero at and past either end.
+void locate(const float* axis, uint32_t count, float v, uint32_t& index, float& weight)
+{
+    weight = 0.0f;
+    if (v <= axis[0]) {
+        index = 0;
+    } else if (v >= axis[count - 1]) {
+        index = count - 1;
+    } else {
+        index = uint32_t(std::upper_bound(axis, axis + count, v) - axis) - 1;
+        weight = (v - axis[index]) / (axis[index + 1] - axis[index]);
+    }
+}
+
+} // namespace
+
+BlendTree::BlendTree(const BlendTreeDesc& desc)
+    : bones_(desc.bones)
+    , parameterCount_(desc.parameterCount)
+{
+    REBEL_ASSERT(!desc.nodes.empty(), "blend trees need at least one node");
+    REBEL_ASSERT(desc.parameterCount <= UINT16_MAX, "too many blend parameters");
+    levelBones_.push_back(bones_);
+    if (desc.skeleton) {
+        REBEL_ASSERT(desc.skeleton->boneCount() == bones_, "blend tree and skeleton bone counts differ");
+        for (uint32_t level = 1; level < desc.skeleton->levelCount(); ++level)
+            levelBones_.push_back(desc.skeleton->boneCount(level));
+    }
+    compile(desc, desc.root, 0, 0);
+}
+
+uint16_t BlendTree::parameter(uint32_t index) const
+{
+    REBEL_ASSERT(index < parameterCount_, "blend parameter out of range");
+    return uint16_t(index);
+}
+
+uint32_t BlendTree::addClip(const AnimationClip* clip)
+{
+    REBEL_ASSERT(clip && clip->boneCount() == bones_, "blend tree clips need the tree's bone count");
+    clips_.push_back(clip);
+    return uint32_t(clips_.size() - 1);
+}
+
+void BlendTree::compile(const BlendTreeDesc& desc, uint32_t node, uint32_t target, uint32_t depth)
+{
+    REBEL_ASSERT(node < desc.nodes.size(), "blend node out of range");
+    REBEL_ASSERT(depth < desc.nodes.size(), "blend tree has a cycle");
+    REBEL_ASSERT(target + 3 <= UINT8_MAX, "blend tree is too deep");
+    registerCount_ = std::max(registerCount_, target + 1);
+    const BlendNodeDesc& n = desc.nodes[node];
+
+    switch (n.type) {
+    case BlendNodeType::Clip:
+        program_.push_back({Op::Sample, uint8_t(target), 0, parameter(n.phase), addClip(n.clip), kNoMask});
+        break;
+
+    case BlendNodeType::Lerp:
+    case BlendNodeType::Layer:
+    case BlendNodeType::Additive: {
+        REBEL_ASSERT(n.type != BlendNodeType::Layer || !n.mask.empty(), "layers need a mask");
+        uint32_t mask = kNoMask;
+        if (!n.mask.empty()) {
+            REBEL_ASSERT(n.mask.size() == bones_, "masks need a weight per bone");
+            mask = uint32_t(masks_.size());
+            for (uint32_t b = 0; b < bones_; b += PoseBuffer::kLanes) {
+                float w[PoseBuffer::kLanes] = {};
+                for (uint32_t lane = 0; lane < PoseBuffer::kLanes && b + lane < bones_; ++lane)
+                    w[lane] = clampWeight(n.mask[b + lane]);
+                masks_.push_back(Float4::load(w));
+            }
+        }
+        compile(desc, n.inputs[0], target, depth + 1);
+        const std::size_t skip = program_.size();
+        program_.push_back({Op::Skip, 0, 0, parameter(n.weight), 0, kNoMask});
+        compile(desc, n.inputs[1], target + 1, depth + 1);
+        const Op op = n.type == BlendNodeType::Additive ? Op::Add : Op::Blend;
+        program_.push_back({op, uint8_t(target), uint8_t(target + 1), parameter(n.weight), 0, mask});
+        program_[skip].index = uint32_t(program_.size());
+        break;
+    }
+
+    case BlendNodeType::Blendspace1D:
+    case BlendNodeType::Blendspace2D: {
+        const bool grid = n.type == BlendNodeType::Blendspace2D;
+        const std::size_t columns = n.xs.size(), rows = grid ? n.ys.size() : 1;
+        REBEL_ASSERT(columns > 0 && rows > 0 && n.clips.size() == columns * rows,
+                     "blendspaces need a clip per point");
+        REBEL_ASSERT(columns <= UINT16_MAX && rows <= UINT16_MAX, "blendspace is too large");
+        REBEL_ASSERT(std::adjacent_find(n.xs.begin(), n.xs.end(), std::greater_equal<float>()) == n.xs.end() &&
+                         std::adjacent_find(n.ys.begin(), n.ys.end(), std::greater_equal<float>()) == n.ys.end(),
+                     "blendspace positions must ascend");
+        const Blendspace space{uint32_t(clips_.size()), uint32_t(axes_.size()), uint16_t(columns), uint16_t(rows),
+                               parameter(n.phase),      parameter(n.x),         grid ? parameter(n.y) : uint16_t(0)};
+        for (const AnimationClip* clip : n.clips)
+            addClip(clip);
+        axes_.insert(axes_.end(), n.xs.begin(), n.xs.end());
+        if (grid)
+            axes_.insert(axes_.end(), n.ys.begin(), n.ys.end());
+        program_.push_back({Op::Blendspace, uint8_t(target), 0, 0, uint32_t(blendspaces_.size()), kNoMask});
+        blendspaces_.push_back(space);
+        registerCount_ = std::max(registerCount_, target + (grid ? 3 : 2));
+        break;
+    }
+    }
+}
+
+void BlendTree::evaluate(std::span<const float> parameters, PoseBuffer& pose, uint32_t level) const
+{
+    REBEL_ASSERT(parameters.size() >= parameterCount_, "too few blend parameters");
+    REBEL_ASSERT(pose.boneCount() == bones_, "pose size mismatch");
+
+    const uint32_t bones = boneCount(level);
+    const uint32_t groups = PoseBuffer::groupCount(bones);
+    const std::size_t stride = std::size_t(groups) * kComponents;
+    memory::ScratchScope scratch;
+    Float4* spare = scratch.allocateArray<Float4>(stride * (registerCount_ - 1));
+    auto reg = [&](uint32_t r) { return r == 0 ? pose.data() : spare + stride * (r - 1); };
+    auto sample = [&](uint32_t clip, float phase, Float4* out) {
+        const AnimationClip& c = *clips_[clip];
+        c.sample(phase * c.duration(), out, bones);
+    };
+
+    for (std::size_t pc = 0; pc < program_.size();) {
+        const Instruction& in = program_[pc++];
+        switch (in.op) {
+        case Op::Sample:
+            sample(in.index, wrapPhase(parameters[in.parameter]), reg(in.target));
+            break;
+        case Op::Blend:
+        case Op::Add: {
+            const Float4* mask = in.mask == kNoMask ? nullptr : masks_.data() + in.mask;
+            const float weight = clampWeight(parameters[in.parameter]);
+            if (in.op == Op::Blend)
+                combine<blendGroup>(reg(in.target), reg(in.source), groups, mask, weight);
+            else
+                combine<addGroup>(reg(in.target), reg(in.source), groups, mask, weight);
+            break;
+        }
+        case Op::Skip:
+            if (clampWeight(parameters[in.parameter]) == 0.0f)
+                pc = in.index;
+            break;
+        case Op::Blendspace: {
+            // Each row blends its two columns into its register; a second
+            // row, in the register above, then blends into the first.
+            const Blendspace& space = blendspaces_[in.index];
+            const float* xs = axes_.data() + space.firstAxis;
+            uint32_t column = 0, row = 0;
+            float tx = 0.0f, ty = 0.0f;
+            locate(xs, space.columns, parameters[space.x], column, tx);
+            if (space.rows > 1)
+                locate(xs + space.columns, space.rows, parameters[space.y], row, ty);
+            const float phase = wrapPhase(parameters[space.phase]);
+            auto sampleRow = [&](uint32_t r, Float4* out, Float4* next) {
+                const uint32_t first = space.firstClip + r * space.columns + column;
+                sample(first, phase, out);
+                if (tx > 0.0f) {
+                    sample(first + 1, phase, next);
+                    combine<blendGroup>(out, next, groups, nullptr, tx);
+                }
+            };
+            sampleRow(row, reg(in.target), reg(in.target + 1));
+            if (ty > 0.0f) {
+                sampleRow(row + 1, reg(in.target + 1), reg(in.target + 2));
+                combine<blendGroup>(reg(in.target), reg(in.target + 1), groups, nullptr, ty);
+            }
+            break;
+        }
+        }
+    }
+}
+
+} // namespace rebel::animation
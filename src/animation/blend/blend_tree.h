@@ -0,0 +1,137 @@
+#pragma once
+
+#include "animation/pose_buffer.h"
+#include "animation/skeleton.h"
+#include "animation/clip/animation_clip.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::animation {
+
+enum class BlendNodeType : uint8_t {
+    /// `clip` at parameter `phase`.
+    Clip,
+    /// inputs[0] to inputs[1] by parameter `weight`.
+    Lerp,
+    /// Lerp, per bone scaled by `mask`.
+    Layer,
+    /// inputs[1], a delta pose, applied on top of inputs[0] by parameter
+    /// `weight` (and `mask`, if any): rotations multiply on the right,
+    /// translations add and scales multiply.
+    Additive,
+    /// `clips` at ascending positions `xs`, blended between the two either
+    /// side of parameter `x`.
+    Blendspace1D,
+    /// `clips` on a grid, rows at `ys` and columns at `xs` (row-major),
+    /// blended bilinearly between the four around parameters `x`, `y`.
+    Blendspace2D,
+};
+
+/// One node of a blend tree, referring to its inputs and parameters by
+/// index. Clip phases run from 0 to 1 over the clip and wrap; weights are
+/// clamped to [0, 1]. Every clip in a blendspace plays at the same phase,
+/// so a blendspace of cycles stays in step.
+struct BlendNodeDesc {
+    BlendNodeType type = BlendNodeType::Clip;
+    const AnimationClip* clip = nullptr;
+    uint32_t phase = 0;
+    uint32_t inputs[2] = {};
+    uint32_t weight = 0;
+    /// One weight per bone.
+    std::span<const float> mask = {};
+    std::span<const AnimationClip* const> clips = {};
+    std::span<const float> xs = {};
+    std::span<const float> ys = {};
+    uint32_t x = 0;
+    uint32_t y = 0;
+};
+
+struct BlendTreeDesc {
+    /// Every clip's bone count.
+    uint32_t bones = 0;
+    std::span<const BlendNodeDesc> nodes;
+    uint32_t root = 0;
+    uint32_t parameterCount = 0;
+    /// For skeleton LODs; without one every level keeps every bone.
+    const Skeleton* skeleton = nullptr;
+};
+
+/// A blend tree compiled into a flat program over pose registers.
+///
+/// Nodes are compiled depth first: each writes its result to the register
+/// its parent gives it and its second input, if any, to the one above, so
+/// a tree needs one register per level of second inputs (blendspaces use
+/// one or two above theirs). Register 0 is the output pose. Evaluating
+/// runs the program in order, one switch per instruction:
+///
+/// - Sample decodes a clip into a register;
+/// - Blend and Add combine two registers four bones per SIMD operation;
+/// - Skip jumps over a blend's second input while its weight is zero;
+/// - Blendspace samples the clips either side of its parameters, skipping
+///   any whose weight is zero, and blends them.
+///
+/// A node used twice is compiled, and evaluated, twice. The tree is
+/// immutable once built and shared by every character using it.
+class BlendTree {
+public:
+    explicit BlendTree(const BlendTreeDesc& desc);
+
+    uint32_t boneCount() const { return bones_; }
+    /// Bones kept at skeleton LOD `level`, clamped to the last level.
+    uint32_t boneCount(uint32_t level) const
+    {
+        return levelBones_[std::min<std::size_t>(level, levelBones_.size() - 1)];
+    }
+    uint32_t levelCount() const { return uint32_t(levelBones_.size()); }
+    uint32_t parameterCount() const { return parameterCount_; }
+    uint32_t registerCount() const { return registerCount_; }
+    uint32_t instructionCount() const { return uint32_t(program_.size()); }
+
+    /// Writes the tree's pose for `parameters` (parameterCount() values)
+    /// into `pose`, using the calling thread's scratch arena for registers.
+    /// Only the groups holding boneCount(level) bones are evaluated; the
+    /// rest of `pose` is left as it was.
+    void evaluate(std::span<const float> parameters, PoseBuffer& pose, uint32_t level = 0) const;
+
+private:
+    enum class Op : uint8_t { Sample, Blend, Add, Skip, Blendspace };
+
+    struct Instruction {
+        Op op;
+        uint8_t target;
+        uint8_t source;
+        uint16_t parameter;
+        uint32_t index; // clip, blendspace or jump target
+        uint32_t mask;  // first group in masks_, or kNoMask
+    };
+    static constexpr uint32_t kNoMask = ~0u;
+
+    struct Blendspace {
+        uint32_t firstClip; // in clips_, row-major
+        uint32_t firstAxis; // in axes_, xs then ys
+        uint16_t columns;
+        uint16_t rows;
+        uint16_t phase;
+        uint16_t x;
+        uint16_t y;
+    };
+
+    void compile(const BlendTreeDesc& desc, uint32_t node, uint32_t target, uint32_t depth);
+    uint32_t addClip(const AnimationClip* clip);
+    uint16_t parameter(uint32_t index) const;
+
+    uint32_t bones_ = 0;
+    uint32_t parameterCount_ = 0;
+    uint32_t registerCount_ = 1;
+    std::vector<uint32_t> levelBones_;
+    std::vector<Instruction> program_;
+    std::vector<const AnimationClip*> clips_;
+    std::vector<Blendspace> blendspaces_;
+    std::vector<float> axes_;
+    std::vector<math::Float4> masks_; // a Float4 per bone group
+};
+
+} // namespace rebel::animation
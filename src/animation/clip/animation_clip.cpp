@@ -0,0 +1,473 @@
+#include "animation/clip/animation_clip.h"
+
+#include "core/assert.h"
+#include "core/math/simd.h"
+#include "core/memory/linear_arena.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace rebel::animation {
+
+namespace {
+
+using math::Float4;
+using math::Quat;
+using math::Vec3;
+
+constexpr float kSqrtHalf = 0.70710678f;
+
+// Smallest three: the largest component is dropped (made positive, since
+// q and -q are the same rotation) and rebuilt from the unit length; the
+// others lie in [-sqrt(1/2), sqrt(1/2)] and take 15 bits each. The
+// dropped index takes the top bits of the first two words.
+void encodeRotation(Quat q, uint16_t* out)
+{
+    const float c[4] = {q.x, q.y, q.z, q.w};
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i) {
+        if (std::abs(c[i]) > std::abs(c[largest]))
+            largest = i;
+    }
+    const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+    for (uint32_t i = 0, k = 0; i < 4; ++i) {
+        if (i == largest)
+            continue;
+        const float unit = std::clamp(c[i] * sign / kSqrtHalf * 0.5f + 0.5f, 0.0f, 1.0f);
+        out[k++] = uint16_t(std::lround(unit * 32767.0f));
+    }
+    out[0] = uint16_t(out[0] | (largest & 1u) << 15);
+    out[1] = uint16_t(out[1] | (largest >> 1) << 15);
+}
+
+Quat decodeRotation(const uint16_t* in)
+{
+    const uint32_t largest = (in[0] >> 15) | (in[1] >> 15) << 1;
+    float c[4];
+    float sum = 0.0f;
+    for (uint32_t i = 0, k = 0; i < 4; ++i) {
+        if (i == largest)
+            continue;
+        c[i] = (float(in[k++] & 0x7FFF) * (2.0f / 32767.0f) - 1.0f) * kSqrtHalf;
+        sum += c[i] * c[i];
+    }
+    c[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+    return {c[0], c[1], c[2], c[3]};
+}
+
+// decodeRotation() for four keys, one per lane, with the dropped
+// component put back by selects. Reads a word past each key.
+REBEL_FORCEINLINE void decodeRotations(const uint16_t* const (&keys)[4], Float4 (&q)[4])
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i t0 = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys[0])),
+                                          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys[1])));
+    const __m128i t1 = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys[2])),
+                                          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys[3])));
+    const __m128i low = _mm_unpacklo_epi32(t0, t1), high = _mm_unpackhi_epi32(t0, t1);
+    const __m128i words[3] = {_mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+                              _mm_unpacklo_epi16(high, zero)};
+    Float4 c[3];
+    for (int i = 0; i < 3; ++i) {
+        const Float4 unit = Float4(_mm_cvtepi32_ps(_mm_and_si128(words[i], _mm_set1_epi32(0x7FFF))));
+        c[i] = math::madd(unit, Float4(2.0f / 32767.0f), Float4(-1.0f)) * Float4(kSqrtHalf);
+    }
+    const __m128i dropped = _mm_or_si128(_mm_srli_epi32(words[0], 15), _mm_slli_epi32(_mm_srli_epi32(words[1], 15), 1));
+    const Float4 sum = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+    const Float4 largest = math::sqrt(math::max(Float4(1.0f) - sum, Float4::zero()));
+    Float4 is[4];
+    for (int i = 0; i < 4; ++i)
+        is[i] = _mm_castsi128_ps(_mm_cmpeq_epi32(dropped, _mm_set1_epi32(i)));
+    // Dropped x: (L, c0, c1, c2); y: (c0, L, c1, c2); z: (c0, c1, L, c2);
+    // w: (c0, c1, c2, L).
+    q[0] = math::select(is[0], largest, c[0]);
+    q[1] = math::select(is[0], c[0], math::select(is[1], largest, c[1]));
+    q[2] = math::select(is[3], c[2], math::select(is[2], largest, c[1]));
+    q[3] = math::select(is[3], largest, c[2]);
+}
+
+// Set bits of a segment mask. std::popcount() is a library call on the
+// x86-64 baseline, which has no POPCNT.
+REBEL_FORCEINLINE uint32_t countBits(uint32_t v)
+{
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return (((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+}
+
+// The same for each lane.
+REBEL_FORCEINLINE __m128i countBits(__m128i v)
+{
+    v = _mm_sub_epi32(v, _mm_and_si128(_mm_srli_epi32(v, 1), _mm_set1_epi32(0x55555555)));
+    v = _mm_add_epi32(_mm_and_si128(v, _mm_set1_epi32(0x33333333)),
+                      _mm_and_si128(_mm_srli_epi32(v, 2), _mm_set1_epi32(0x33333333)));
+    v = _mm_and_si128(_mm_add_epi32(v, _mm_srli_epi32(v, 4)), _mm_set1_epi32(0x0F0F0F0F));
+    v = _mm_add_epi32(v, _mm_srli_epi32(v, 8));
+    return _mm_and_si128(_mm_add_epi32(v, _mm_srli_epi32(v, 16)), _mm_set1_epi32(0x3F));
+}
+
+// Index of each lane's highest set bit, from the exponent of its float
+// conversion; exact below 2^24.
+REBEL_FORCEINLINE Float4 highestBit(__m128i v)
+{
+    const __m128i exponent = _mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(v)), 23);
+    return _mm_cvtepi32_ps(_mm_sub_epi32(exponent, _mm_set1_epi32(127)));
+}
+
+uint16_t quantize(float v, float min, float extent)
+{
+    return extent > 0.0f ? uint16_t(std::lround(std::clamp((v - min) / extent, 0.0f, 1.0f) * 65535.0f)) : 0;
+}
+
+// Angle between two unit rotations, from the chord between them (|a - b|
+// is 2 sin(angle / 4)) rather than acos of their dot, which loses small
+// angles to float rounding.
+float angleBetween(Quat a, Quat b)
+{
+    if (math::dot(a, b) < 0.0f)
+        b = -b;
+    const Quat d = a + (-b);
+    return 4.0f * std::asin(std::min(std::sqrt(math::dot(d, d)) * 0.5f, 1.0f));
+}
+
+} // namespace
+
+AnimationClip::AnimationClip(const AnimationClipDesc& desc)
+    : bones_(desc.bones)
+    , frames_(desc.frames)
+    , frameRate_(desc.frameRate)
+{
+    REBEL_ASSERT(desc.frames > 0 && desc.frameRate > 0.0f, "clips need at least one frame");
+    REBEL_ASSERT(desc.samples.size() == std::size_t(desc.frames) * desc.bones, "clips need frames x bones samples");
+    REBEL_ASSERT(desc.bones <= UINT16_MAX, "too many bones");
+
+    const uint32_t bones = desc.bones;
+    auto raw = [&](uint32_t frame, uint32_t bone) -> const Transform& {
+        return desc.samples[std::size_t(frame) * bones + bone];
+    };
+    const float tolerance[3] = {desc.rotationTolerance, desc.translationTolerance, desc.scaleTolerance};
+    // Error between two values of a channel.
+    auto error = [](Channel channel, const Transform& a, const Transform& b) {
+        switch (channel) {
+        case Channel::Rotation:
+            return angleBetween(a.rotation, b.rotation);
+        case Channel::Translation:
+            return math::length(a.translation - b.translation);
+        case Channel::Scale:
+            return math::length(a.scale - b.scale);
+        }
+        return 0.0f;
+    };
+
+    // Classify every track; constant ones go into the base pose.
+    std::vector<Transform> basePose(bones);
+    for (uint32_t b = 0; b < bones; ++b) {
+        for (Channel channel : {Channel::Rotation, Channel::Translation, Channel::Scale}) {
+            const float limit = tolerance[uint32_t(channel)];
+            bool constant = true;
+            for (uint32_t f = 1; f < frames_ && constant; ++f)
+                constant = error(channel, raw(f, b), raw(0, b)) <= limit;
+            if (constant) {
+                const Transform& value = raw(0, b);
+                if (error(channel, value, Transform{}) <= limit) {
+                    ++stats_.staticTracks;
+                } else {
+                    ++stats_.constantTracks;
+                    if (channel == Channel::Rotation)
+                        basePose[b].rotation = math::normalize(value.rotation);
+                    else if (channel == Channel::Translation)
+                        basePose[b].translation = value.translation;
+                    else
+                        basePose[b].scale = value.scale;
+                }
+                continue;
+            }
+
+            Track track{uint16_t(b), channel, {}, {}};
+            if (channel != Channel::Rotation) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    float low = INFINITY, high = -INFINITY;
+                    for (uint32_t f = 0; f < frames_; ++f) {
+                        const Vec3& v = channel == Channel::Translation ? raw(f, b).translation : raw(f, b).scale;
+                        low = std::min(low, v[axis]);
+                        high = std::max(high, v[axis]);
+                    }
+                    track.min[axis] = low;
+                    track.extent[axis] = high - low;
+                }
+            }
+            tracks_.push_back(track);
+            ++stats_.animatedTracks;
+        }
+    }
+
+    basePose_.resize(std::size_t(PoseBuffer::groupCount(bones)) * PoseBuffer::kComponents);
+    PoseBuffer::pack(basePose, basePose_.data());
+
+    // Rotations first, so sampling decodes them four at a time.
+    std::stable_sort(tracks_.begin(), tracks_.end(),
+                     [](const Track& a, const Track& b) { return a.channel < b.channel; });
+    rotationTracks_ = uint32_t(std::count_if(tracks_.begin(), tracks_.end(),
+                                             [](const Track& t) { return t.channel == Channel::Rotation; }));
+
+    // Quantized key of a track's value, and its decoded value.
+    auto encode = [](const Track& track, const Transform& value, uint16_t* out) {
+        if (track.channel == Channel::Rotation) {
+            encodeRotation(math::normalize(value.rotation), out);
+            return;
+        }
+        const Vec3& v = track.channel == Channel::Translation ? value.translation : value.scale;
+        for (int axis = 0; axis < 3; ++axis)
+            out[axis] = quantize(v[axis], track.min[axis], track.extent[axis]);
+    };
+    auto decode = [](const Track& track, const uint16_t* key) {
+        Transform value;
+        if (track.channel == Channel::Rotation) {
+            value.rotation = decodeRotation(key);
+            return value;
+        }
+        Vec3 v;
+        for (int axis = 0; axis < 3; ++axis)
+            v[axis] = track.min[axis] + track.extent[axis] * (float(key[axis]) * (1.0f / 65535.0f));
+        (track.channel == Channel::Translation ? value.translation : value.scale) = v;
+        return value;
+    };
+    auto interpolate = [](Channel channel, const Transform& a, const Transform& b, float t) {
+        Transform value;
+        if (channel == Channel::Rotation)
+            value.rotation = math::nlerp(a.rotation, b.rotation, t);
+        else if (channel == Channel::Translation)
+            value.translation = math::lerp(a.translation, b.translation, t);
+        else
+            value.scale = math::lerp(a.scale, b.scale, t);
+        return value;
+    };
+
+    // The end key of a span from `start` over source frames (from, to]
+    // fitted by least squares, rather than the source value at `to`, so
+    // capture noise at one frame does not end the span. Rotations are
+    // fitted in quaternion space on the start's hemisphere.
+    auto fit = [&](const Track& track, const Transform& start, uint32_t from, uint32_t to) {
+        float weights = 0.0f;
+        Quat rotation{0.0f, 0.0f, 0.0f, 0.0f};
+        Vec3 offset;
+        for (uint32_t f = from + 1; f <= to; ++f) {
+            const float t = float(f - from) / float(to - from);
+            weights += t * t;
+            const Transform& value = raw(f, track.bone);
+            if (track.channel == Channel::Rotation) {
+                const Quat q = math::normalize(value.rotation);
+                rotation = rotation + (math::dot(q, start.rotation) < 0.0f ? -q : q) * t + start.rotation * -t;
+            } else if (track.channel == Channel::Translation) {
+                offset = offset + (value.translation - start.translation) * t;
+            } else {
+                offset = offset + (value.scale - start.scale) * t;
+            }
+        }
+        Transform end;
+        if (track.channel == Channel::Rotation)
+            end.rotation = math::normalize(start.rotation + rotation * (1.0f / weights));
+        else if (track.channel == Channel::Translation)
+            end.translation = start.translation + offset * (1.0f / weights);
+        else
+            end.scale = start.scale + offset * (1.0f / weights);
+        return end;
+    };
+
+    // Segments: masks, then keys. Within a segment each track keeps the
+    // farthest next key, fitted to the source frames since the last one,
+    // whose interpolation reproduces every source frame up to it, greedily
+    // from the first frame. A span of one frame keeps the source key.
+    const uint32_t segments = std::max((frames_ - 1 + kSegmentFrames - 1) / kSegmentFrames, 1u);
+    std::vector<uint16_t> encoded;
+    std::vector<Transform> decoded;
+    std::vector<uint16_t> keys;
+    for (uint32_t s = 0; s < segments; ++s) {
+        const uint32_t first = s * kSegmentFrames;
+        const uint32_t length = std::min(first + kSegmentFrames, frames_ - 1) - first;
+        segmentStart_.push_back(uint32_t(data_.size()));
+        const std::size_t masks = data_.size();
+        data_.resize(masks + tracks_.size(), 0);
+        keys.clear();
+        for (std::size_t t = 0; t < tracks_.size(); ++t) {
+            const Track& track = tracks_[t];
+            encoded.resize(std::size_t(length + 1) * 3);
+            decoded.resize(length + 1);
+            for (uint32_t i = 0; i <= length; ++i) {
+                encode(track, raw(first + i, track.bone), &encoded[i * 3]);
+                decoded[i] = decode(track, &encoded[i * 3]);
+            }
+            const float limit = tolerance[uint32_t(track.channel)];
+            uint16_t mask = 0;
+            keys.insert(keys.end(), &encoded[0], &encoded[3]);
+            Transform start = decoded[0];
+            for (uint32_t current = 0; current < length;) {
+                uint32_t next = current + 1;
+                uint16_t key[3] = {encoded[next * 3], encoded[next * 3 + 1], encoded[next * 3 + 2]};
+                Transform end = decoded[next];
+                for (uint32_t candidate = current + 2; candidate <= length; ++candidate) {
+                    uint16_t fitted[3];
+                    encode(track, fit(track, start, first + current, first + candidate), fitted);
+                    const Transform value = decode(track, fitted);
+                    bool fits = true;
+                    for (uint32_t i = current + 1; i <= candidate && fits; ++i) {
+                        const float t01 = float(i - current) / float(candidate - current);
+                        fits = error(track.channel, interpolate(track.channel, start, value, t01),
+                                     raw(first + i, track.bone)) <= limit;
+                    }
+                    if (!fits)
+                        break;
+                    next = candidate;
+                    std::copy(fitted, fitted + 3, key);
+                    end = value;
+                }
+                if (next < length)
+                    mask = uint16_t(mask | 1u << (next - 1));
+                keys.insert(keys.end(), key, key + 3);
+                start = end;
+                current = next;
+            }
+            data_[masks + t] = mask;
+            stats_.keys += uint32_t(std::popcount(mask)) + (length > 0 ? 2u : 1u);
+            stats_.sourceKeys += length + 1;
+        }
+        data_.insert(data_.end(), keys.begin(), keys.end());
+    }
+    segmentStart_.push_back(uint32_t(data_.size()));
+    // Sampling reads keys and masks four words at a time.
+    data_.push_back(0);
+}
+
+void AnimationClip::sample(float time, PoseBuffer& pose) const
+{
+    REBEL_ASSERT(pose.boneCount() == bones_, "pose size mismatch");
+    sample(time, pose.data());
+}
+
+void AnimationClip::sample(float time, std::span<Transform> pose) const
+{
+    REBEL_ASSERT(pose.size() >= bones_, "pose is smaller than the clip's skeleton");
+    memory::ScratchScope scratch;
+    Float4* groups = scratch.allocateArray<Float4>(basePose_.size());
+    sample(time, groups);
+    PoseBuffer::unpack(groups, pose.first(bones_));
+}
+
+void AnimationClip::sample(float time, Float4* groups, uint32_t bones) const
+{
+    bones = std::min(bones, bones_);
+    std::memcpy(static_cast<void*>(groups), basePose_.data(),
+                std::size_t(PoseBuffer::groupCount(bones)) * PoseBuffer::kComponents * sizeof(Float4));
+    if (tracks_.empty())
+        return;
+    // Component c of a bone, at lane bone % 4 of its group's Float4 c.
+    float* out = reinterpret_cast<float*>(groups);
+    auto at = [&](uint32_t bone, uint32_t c) {
+        return out + (std::size_t(bone / PoseBuffer::kLanes) * PoseBuffer::kComponents + c) * PoseBuffer::kLanes +
+               bone % PoseBuffer::kLanes;
+    };
+
+    const float frame = std::clamp(time * frameRate_, 0.0f, float(frames_ - 1));
+    const uint32_t segment = std::min(uint32_t(frame) / kSegmentFrames, uint32_t(segmentStart_.size()) - 2);
+    const uint32_t first = segment * kSegmentFrames;
+    const uint32_t length = std::min(first + kSegmentFrames, frames_ - 1) - first;
+    const float local = frame - float(first);
+    // Frames up to and including the one at or before `local`.
+    const uint32_t upTo = (2u << std::min(uint32_t(local), length)) - 1;
+
+    // Each channel's tracks are in bone order, so a LOD's are a prefix.
+    auto below = [](const Track& track, uint32_t bone) { return track.bone < bone; };
+    const uint32_t rotations = uint32_t(
+        std::lower_bound(tracks_.begin(), tracks_.begin() + rotationTracks_, bones, below) - tracks_.begin());
+
+    const uint16_t* masks = data_.data() + segmentStart_[segment];
+    const uint16_t* keys = masks + tracks_.size();
+    // Rotations four tracks at a time. Each track's keys are found from
+    // its mask: the frames at or before `local` and after it, their
+    // highest and lowest bits, and the key count before them.
+    const __m128i segmentFrames = _mm_set1_epi32(int(1u | 1u << length));
+    const __m128i sampled = _mm_set1_epi32(int(upTo));
+    for (uint32_t t = 0; t < rotations; t += 4) {
+        const __m128i mask =
+            _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(masks + t)), _mm_setzero_si128());
+        const __m128i frames = _mm_or_si128(_mm_slli_epi32(mask, 1), segmentFrames);
+        const __m128i before = _mm_and_si128(frames, sampled);
+        const __m128i after = _mm_andnot_si128(sampled, frames);
+        const __m128i count = countBits(frames);
+        __m128i end = _mm_add_epi32(count, _mm_slli_si128(count, 4));
+        end = _mm_add_epi32(end, _mm_slli_si128(end, 8)); // keys up to each track's last, inclusive
+        __m128i first = _mm_add_epi32(_mm_sub_epi32(end, count), _mm_sub_epi32(countBits(before), _mm_set1_epi32(1)));
+        first = _mm_add_epi32(first, _mm_add_epi32(first, first)); // in words
+        const __m128i last = _mm_cmpeq_epi32(after, _mm_setzero_si128());
+        const __m128i second = _mm_add_epi32(first, _mm_andnot_si128(last, _mm_set1_epi32(3)));
+
+        const Float4 previous = highestBit(before);
+        const Float4 next = math::select(_mm_castsi128_ps(last), previous + Float4(1.0f),
+                                         highestBit(_mm_and_si128(after, _mm_sub_epi32(_mm_setzero_si128(), after))));
+        const Float4 weight = (Float4(local) - previous) / (next - previous);
+
+        // A short last group decodes its last track's keys in the spare
+        // lanes, and stores only its own.
+        const uint32_t lanes = std::min(rotations - t, 4u);
+        alignas(16) int32_t offsets[2][4], ends[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(offsets[0]), first);
+        _mm_store_si128(reinterpret_cast<__m128i*>(offsets[1]), second);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ends), end);
+        const uint16_t* k0[4];
+        const uint16_t* k1[4];
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            const uint32_t from = std::min(lane, lanes - 1);
+            k0[lane] = keys + offsets[0][from];
+            k1[lane] = keys + offsets[1][from];
+        }
+        keys += 3 * ends[lanes - 1];
+
+        Float4 a[4], b[4];
+        decodeRotations(k0, a);
+        decodeRotations(k1, b);
+        // nlerp on the shorter arc.
+        const Float4 flip = math::cmpLt(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3], Float4::zero()) &
+                            Float4(-0.0f);
+        Float4 q[4];
+        for (int c = 0; c < 4; ++c)
+            q[c] = math::madd(Float4(_mm_xor_ps(b[c], flip)) - a[c], weight, a[c]);
+        const Float4 scale = math::rsqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        alignas(16) float components[4][4];
+        for (int c = 0; c < 4; ++c)
+            (q[c] * scale).storeAligned(components[c]);
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            float* rotation = at(tracks_[t + lane].bone, 0);
+            for (uint32_t c = 0; c < 4; ++c)
+                rotation[c * PoseBuffer::kLanes] = components[c][lane];
+        }
+    }
+
+    // Dropped bones' keys are only counted.
+    for (uint32_t t = rotations; t < rotationTracks_; ++t)
+        keys += 3 * countBits(uint32_t(masks[t]) << 1 | 1u | 1u << length);
+
+    for (std::size_t t = rotationTracks_; t < tracks_.size(); ++t) {
+        const Track& track = tracks_[t];
+        const uint32_t frames = uint32_t(masks[t]) << 1 | 1u | 1u << length;
+        if (track.bone >= bones) {
+            keys += 3 * countBits(frames);
+            continue;
+        }
+        const uint32_t before = frames & upTo, after = frames & ~upTo;
+        const uint32_t previous = 31 - uint32_t(std::countl_zero(before));
+        const uint32_t next = after ? uint32_t(std::countr_zero(after)) : previous + 1;
+        const uint16_t* k0 = keys + 3 * (countBits(before) - 1);
+        const uint16_t* k1 = after ? k0 + 3 : k0;
+        const float alpha = (local - float(previous)) / float(next - previous);
+        keys += 3 * countBits(frames);
+        float* v = at(track.bone, track.channel == Channel::Translation ? 4 : 7);
+        for (int axis = 0; axis < 3; ++axis) {
+            const float q = float(k0[axis]) + (float(k1[axis]) - float(k0[axis])) * alpha;
+            v[axis * PoseBuffer::kLanes] = track.min[axis] + track.extent[axis] * (q * (1.0f / 65535.0f));
+        }
+    }
+}
+
+} // namespace rebel::animation
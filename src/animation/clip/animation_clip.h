@@ -0,0 +1,111 @@
+#pragma once
+
+#include "animation/pose_buffer.h"
+#include "animation/transform.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::animation {
+
+struct AnimationClipDesc {
+    uint32_t bones = 0;
+    /// At least one.
+    uint32_t frames = 0;
+    float frameRate = 30.0f;
+    /// frames x bones local transforms, frame-major.
+    std::span<const Transform> samples;
+    /// Largest error keyframe reduction may leave at any source frame,
+    /// measured from the quantized keys; a track whose quantization alone
+    /// exceeds it keeps every key. Tracks within these of their first
+    /// frame throughout are constant.
+    float rotationTolerance = 0.0005f;    // radians
+    float translationTolerance = 0.0002f; // metres
+    float scaleTolerance = 0.0002f;
+};
+
+struct AnimationClipStats {
+    uint32_t staticTracks = 0;   // identity throughout, no data
+    uint32_t constantTracks = 0; // one value, kept in the base pose
+    uint32_t animatedTracks = 0;
+    uint32_t keys = 0; // over every animated track and segment
+    uint32_t sourceKeys = 0;
+};
+
+/// A cooked, compressed animation clip. Each bone has a rotation, a
+/// translation and a scale track:
+///
+/// - static tracks (identity throughout) and constant tracks cost nothing
+///   per frame; their values live in a base pose, in PoseBuffer's layout,
+///   copied out first;
+/// - animated tracks keep 48-bit keys: rotations as the smallest three
+///   components in 15 bits each plus the dropped component's index,
+///   translations and scales as 16 bits per component over the track's
+///   range;
+/// - keys are dropped wherever interpolating their neighbours stays within
+///   the desc's tolerances. A key that ends a longer span is fitted to the
+///   source frames in it by least squares rather than copied from its own
+///   frame, so noise below the tolerances does not pin every key.
+///
+/// The keys are cut into segments of kSegmentFrames frames, each one
+/// contiguous: a 16-bit mask per animated track marking which of the
+/// segment's interior frames are keys (its first and last frames always
+/// are), then every track's keys in order. Sampling at a time reads one
+/// segment front to back, finding each track's two keys from its mask
+/// with bit operations rather than a search.
+class AnimationClip {
+public:
+    static constexpr uint32_t kSegmentFrames = 16;
+
+    explicit AnimationClip(const AnimationClipDesc& desc);
+
+    uint32_t boneCount() const { return bones_; }
+    uint32_t frameCount() const { return frames_; }
+    float frameRate() const { return frameRate_; }
+    float duration() const { return float(frames_ - 1) / frameRate_; }
+    const AnimationClipStats& stats() const { return stats_; }
+
+    /// Cooked bytes, against rawSize() for the float tracks it came from.
+    std::size_t memoryUsage() const
+    {
+        return basePose_.size() * sizeof(math::Float4) + tracks_.size() * sizeof(Track) +
+               segmentStart_.size() * sizeof(uint32_t) + data_.size() * sizeof(uint16_t);
+    }
+    std::size_t rawSize() const { return std::size_t(frames_) * bones_ * sizeof(Transform); }
+
+    /// Local transforms of every bone at `time` seconds, clamped to the
+    /// clip, written in PoseBuffer's layout: `groups` holds
+    /// PoseBuffer::groupCount(boneCount()) groups. With `bones`, only the
+    /// groups holding the first `bones` bones (a skeleton LOD) are written,
+    /// and only those bones' tracks decoded.
+    void sample(float time, math::Float4* groups, uint32_t bones = UINT32_MAX) const;
+    void sample(float time, PoseBuffer& pose) const;
+    /// The same as transforms, through a PoseBuffer's worth of scratch;
+    /// `pose` holds boneCount() transforms.
+    void sample(float time, std::span<Transform> pose) const;
+
+private:
+    enum class Channel : uint8_t { Rotation, Translation, Scale };
+
+    struct Track {
+        uint16_t bone;
+        Channel channel;
+        // Translation and scale dequantization: min + extent * q / 65535.
+        float min[3];
+        float extent[3];
+    };
+
+    uint32_t bones_ = 0;
+    std::vector<math::Float4> basePose_;
+    std::vector<Track> tracks_; // animated only, by channel then bone
+    uint32_t rotationTracks_ = 0;
+    /// Per segment, its offset into data_, plus the end.
+    std::vector<uint32_t> segmentStart_;
+    std::vector<uint16_t> data_;
+    uint32_t frames_ = 0;
+    float frameRate_ = 30.0f;
+    AnimationClipStats stats_;
+};
+
+} // namespace rebel::animation
@@ -0,0 +1,95 @@
+#include "animation/crowd/crowd_animator.h"
+
+#include "animation/transform.h"
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/memory/linear_arena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace rebel::animation {
+
+CrowdAnimator::CrowdAnimator(const CrowdAnimatorDesc& desc)
+    : clips_(desc.clips.begin(), desc.clips.end())
+    , skeleton_(desc.skeleton)
+    , bones_(desc.skeleton ? desc.skeleton->boneCount() : 0)
+    , steps_(desc.phaseSteps)
+{
+    REBEL_ASSERT(skeleton_ && !clips_.empty(), "crowds need a skeleton and at least one clip");
+    REBEL_ASSERT(steps_ > 0, "crowds need at least one phase step");
+    REBEL_ASSERT(std::all_of(clips_.begin(), clips_.end(),
+                             [&](const AnimationClip* clip) { return clip && clip->boneCount() == bones_; }),
+                 "crowd clips need the skeleton's bone count");
+    if (desc.inverseBind.empty()) {
+        inverseBind_.assign(bones_, math::Mat4::identity());
+    } else {
+        REBEL_ASSERT(desc.inverseBind.size() == bones_, "crowds need an inverse bind matrix per bone");
+        inverseBind_.assign(desc.inverseBind.begin(), desc.inverseBind.end());
+    }
+    palette_.assign(std::size_t(bucketCount()) * bones_ * kMatrixFloats, 0.0f);
+    seen_.assign(bucketCount(), 0);
+}
+
+uint32_t CrowdAnimator::bucket(const CrowdAgent& agent) const
+{
+    REBEL_ASSERT(agent.clip < clips_.size(), "crowd agent clip out of range");
+    const float phase = agent.phase - std::floor(agent.phase);
+    const uint32_t step = uint32_t(phase * float(steps_) + 0.5f) % steps_;
+    return agent.clip * steps_ + step;
+}
+
+void CrowdAnimator::pose(uint32_t bucket)
+{
+    const AnimationClip& clip = *clips_[bucket / steps_];
+    memory::ScratchScope scratch;
+    Transform* local = scratch.allocateArray<Transform>(bones_);
+    math::Mat4* model = scratch.allocateArray<math::Mat4>(bones_);
+    clip.sample(float(bucket % steps_) / float(steps_) * clip.duration(), std::span(local, bones_));
+
+    float* out = palette_.data() + std::size_t(bucket) * bones_ * kMatrixFloats;
+    for (uint32_t b = 0; b < bones_; ++b) {
+        const math::Mat4 m = math::Mat4::trs(local[b].translation, local[b].rotation, local[b].scale);
+        const int16_t parent = skeleton_->parent(b);
+        model[b] = parent < 0 ? m : model[parent] * m;
+        const math::Mat4 skin = model[b] * inverseBind_[b];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c)
+                *out++ = skin.cols[c][r];
+        }
+    }
+}
+
+void CrowdAnimator::update(std::span<const CrowdAgent> agents, std::span<uint32_t> paletteOffsets,
+                           jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(paletteOffsets.size() >= agents.size(), "crowds need a palette offset per agent");
+    const auto start = std::chrono::steady_clock::now();
+    const uint32_t cached = stats_.cached;
+    stats_ = {};
+    stats_.agents = uint32_t(agents.size());
+    written_.clear();
+    ++updates_;
+
+    for (std::size_t i = 0; i < agents.size(); ++i) {
+        const uint32_t b = bucket(agents[i]);
+        if (seen_[b] != updates_) {
+            if (seen_[b] == 0)
+                written_.push_back(b);
+            seen_[b] = updates_;
+            ++stats_.buckets;
+        }
+        paletteOffsets[i] = b * bones_;
+    }
+
+    jobs.parallelFor(uint32_t(written_.size()), kBucketsPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            pose(written_[i]);
+    });
+    stats_.evaluated = uint32_t(written_.size());
+    stats_.cached = cached + stats_.evaluated;
+    stats_.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace rebel::animation
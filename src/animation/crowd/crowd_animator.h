@@ -0,0 +1,95 @@
+#pragma once
+
+#include "animation/clip/animation_clip.h"
+#include "animation/skeleton.h"
+#include "core/math/mat.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::animation {
+
+struct CrowdAnimatorDesc {
+    /// Every clip needs skeleton->boneCount() bones and is played looped.
+    std::span<const AnimationClip* const> clips;
+    const Skeleton* skeleton = nullptr;
+    /// Model space to bind pose space, per bone; empty for identity.
+    std::span<const math::Mat4> inverseBind = {};
+    /// Poses per clip cycle; an agent's phase snaps to the nearest.
+    uint32_t phaseSteps = 32;
+};
+
+/// One crowd member: which clip it plays and how far through its cycle,
+/// in [0, 1) (other values wrap).
+struct CrowdAgent {
+    uint32_t clip = 0;
+    float phase = 0.0f;
+};
+
+struct CrowdStats {
+    uint32_t agents = 0;
+    uint32_t buckets = 0;   // distinct (clip, step) pairs the agents are in
+    uint32_t evaluated = 0; // buckets posed for the first time this update
+    uint32_t cached = 0;    // buckets posed so far
+    float milliseconds = 0.0f;
+};
+
+/// Animation for crowds too large to pose one by one. Agents playing the
+/// same clip at nearly the same phase share a pose: phases are quantized
+/// to phaseSteps per cycle, and each (clip, step) bucket is sampled and
+/// turned into skinning matrices once, the first time an agent lands in
+/// it. Bucket poses never change, so they stay cached, and an update's
+/// cost grows with the buckets first reached that frame rather than with
+/// the crowd; a settled crowd only pays for looking up its agents'
+/// buckets.
+///
+/// Every bucket has a fixed place in palette(), a bone's 3x4 row-major
+/// skinning matrix (pose times inverse bind) every 12 floats, so the
+/// palette is clips x phaseSteps x bones matrices and an offset handed
+/// to the renderer stays valid across frames. Draws pass an agent's
+/// offset as render::DrawCommand::paletteOffset and the palette as
+/// render::RenderFrameParams::bonePalette; buckets() lists the ones
+/// written since the last update, for uploading just those.
+class CrowdAnimator {
+public:
+    static constexpr uint32_t kMatrixFloats = 12;
+    static constexpr uint32_t kBucketsPerJob = 4;
+
+    explicit CrowdAnimator(const CrowdAnimatorDesc& desc);
+
+    uint32_t boneCount() const { return bones_; }
+    uint32_t phaseSteps() const { return steps_; }
+    uint32_t bucketCount() const { return uint32_t(clips_.size()) * steps_; }
+
+    /// Poses every bucket an agent is in that isn't cached yet, and writes
+    /// each agent's palette offset, in bones, to `paletteOffsets`.
+    void update(std::span<const CrowdAgent> agents, std::span<uint32_t> paletteOffsets, jobs::JobSystem& jobs);
+
+    uint32_t bucket(const CrowdAgent& agent) const;
+
+    std::span<const float> palette() const { return palette_; }
+    /// Buckets written by the last update.
+    std::span<const uint32_t> buckets() const { return written_; }
+    const CrowdStats& stats() const { return stats_; }
+
+private:
+    void pose(uint32_t bucket);
+
+    std::vector<const AnimationClip*> clips_;
+    const Skeleton* skeleton_;
+    std::vector<math::Mat4> inverseBind_;
+    uint32_t bones_;
+    uint32_t steps_;
+    std::vector<float> palette_;
+    std::vector<uint32_t> seen_; // per bucket, the last update an agent was in it; 0 if never posed
+    uint32_t updates_ = 0;
+    std::vector<uint32_t> written_;
+    CrowdStats stats_;
+};
+
+} // namespace rebel::animation
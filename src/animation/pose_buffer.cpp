@@ -0,0 +1,111 @@
+#include "animation/pose_buffer.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+
+namespace rebel::animation {
+
+namespace {
+
+using math::Float4;
+
+static_assert(sizeof(Transform) == 40, "pack() reads transforms as rotation, translation, scale floats");
+
+constexpr uint32_t kLanes = PoseBuffer::kLanes;
+
+// Four transforms to one group. Scales are loaded from translation.z on,
+// so every load stays inside its transform.
+void packGroup(const Transform* t, Float4* out)
+{
+    Float4 r[4], p[4], s[4];
+    for (uint32_t i = 0; i < kLanes; ++i) {
+        r[i] = Float4::load(&t[i].rotation.x);
+        p[i] = Float4::load(&t[i].translation.x);
+        s[i] = Float4::load(&t[i].translation.z);
+    }
+    math::transpose4(r[0], r[1], r[2], r[3]);
+    math::transpose4(p[0], p[1], p[2], p[3]);
+    math::transpose4(s[0], s[1], s[2], s[3]);
+    const Float4 rows[PoseBuffer::kComponents] = {r[0], r[1], r[2], r[3], p[0], p[1], p[2], s[1], s[2], s[3]};
+    std::copy(rows, rows + PoseBuffer::kComponents, out);
+}
+
+// The reverse; translations are stored before the scales that overlap
+// them.
+void unpackGroup(const Float4* in, Transform* t)
+{
+    Float4 r[4] = {in[0], in[1], in[2], in[3]};
+    Float4 p[4] = {in[4], in[5], in[6], in[7]};
+    Float4 s[4] = {in[6], in[7], in[8], in[9]};
+    math::transpose4(r[0], r[1], r[2], r[3]);
+    math::transpose4(p[0], p[1], p[2], p[3]);
+    math::transpose4(s[0], s[1], s[2], s[3]);
+    for (uint32_t i = 0; i < kLanes; ++i) {
+        r[i].store(&t[i].rotation.x);
+        p[i].store(&t[i].translation.x);
+        s[i].store(&t[i].translation.z);
+    }
+}
+
+} // namespace
+
+void PoseBuffer::resize(uint32_t bones)
+{
+    bones_ = bones;
+    data_.resize(std::size_t(groupCount()) * kComponents);
+    const std::vector<Transform> identity(bones);
+    pack(identity, data_.data());
+}
+
+void PoseBuffer::set(std::span<const Transform> transforms)
+{
+    REBEL_ASSERT(transforms.size() == bones_, "pose size mismatch");
+    pack(transforms, data_.data());
+}
+
+void PoseBuffer::get(std::span<Transform> transforms) const
+{
+    REBEL_ASSERT(transforms.size() >= bones_, "pose size mismatch");
+    unpack(data_.data(), transforms.first(bones_));
+}
+
+Transform PoseBuffer::bone(uint32_t bone) const
+{
+    REBEL_ASSERT(bone < bones_, "bone out of range");
+    const Float4* c = data_.data() + std::size_t(bone / kLanes) * kComponents;
+    const int lane = int(bone % kLanes);
+    Transform t;
+    t.rotation = {c[0].lane(lane), c[1].lane(lane), c[2].lane(lane), c[3].lane(lane)};
+    t.translation = {c[4].lane(lane), c[5].lane(lane), c[6].lane(lane)};
+    t.scale = {c[7].lane(lane), c[8].lane(lane), c[9].lane(lane)};
+    return t;
+}
+
+void PoseBuffer::pack(std::span<const Transform> transforms, Float4* out)
+{
+    const uint32_t bones = uint32_t(transforms.size());
+    const uint32_t whole = bones / kLanes;
+    for (uint32_t g = 0; g < whole; ++g)
+        packGroup(&transforms[g * kLanes], out + std::size_t(g) * kComponents);
+    if (bones % kLanes) {
+        Transform last[kLanes];
+        std::copy(transforms.begin() + whole * kLanes, transforms.end(), last);
+        packGroup(last, out + std::size_t(whole) * kComponents);
+    }
+}
+
+void PoseBuffer::unpack(const Float4* in, std::span<Transform> transforms)
+{
+    const uint32_t bones = uint32_t(transforms.size());
+    const uint32_t whole = bones / kLanes;
+    for (uint32_t g = 0; g < whole; ++g)
+        unpackGroup(in + std::size_t(g) * kComponents, &transforms[g * kLanes]);
+    if (bones % kLanes) {
+        Transform last[kLanes];
+        unpackGroup(in + std::size_t(whole) * kComponents, last);
+        std::copy(last, last + bones % kLanes, transforms.begin() + whole * kLanes);
+    }
+}
+
+} // namespace rebel::animation
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "animation/transform.h"
+#include "core/math/simd.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::animation {
+
+/// A pose stored four bones to a group, structure-of-arrays within each
+/// group: rotation x, y, z, w, translation x, y, z and scale x, y, z, one
+/// Float4 apiece with a bone per lane. Blending walks the groups front to
+/// back and touches four bones with each instruction. Lanes past the last
+/// bone hold identity.
+class PoseBuffer {
+public:
+    static constexpr uint32_t kLanes = 4;
+    static constexpr uint32_t kComponents = 10;
+
+    explicit PoseBuffer(uint32_t bones = 0) { resize(bones); }
+
+    /// Every bone back to identity.
+    void resize(uint32_t bones);
+
+    uint32_t boneCount() const { return bones_; }
+    uint32_t groupCount() const { return groupCount(bones_); }
+    static uint32_t groupCount(uint32_t bones) { return (bones + kLanes - 1) / kLanes; }
+
+    /// kComponents Float4s per group, groups in order.
+    math::Float4* data() { return data_.data(); }
+    const math::Float4* data() const { return data_.data(); }
+
+    /// set() takes boneCount() transforms, get() room for at least as many.
+    void set(std::span<const Transform> transforms);
+    void get(std::span<Transform> transforms) const;
+    Transform bone(uint32_t bone) const;
+
+    /// Transposes transforms into groups at `out`, padding the last group
+    /// with identity, and back again.
+    static void pack(std::span<const Transform> transforms, math::Float4* out);
+    static void unpack(const math::Float4* in, std::span<Transform> transforms);
+
+private:
+    uint32_t bones_ = 0;
+    std::vector<math::Float4> data_;
+};
+
+} // namespace rebel::animation
@@ -0,0 +1,54 @@
+#include "animation/skeleton.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace rebel::animation {
+
+namespace {
+
+std::vector<uint32_t> heights(std::span<const int16_t> parents)
+{
+    std::vector<uint32_t> height(parents.size(), 0);
+    for (std::size_t b = parents.size(); b-- > 0;) {
+        REBEL_ASSERT(parents[b] < int(b), "parents must come before their children");
+        if (parents[b] >= 0)
+            height[std::size_t(parents[b])] = std::max(height[std::size_t(parents[b])], height[b] + 1);
+    }
+    return height;
+}
+
+} // namespace
+
+Skeleton::Skeleton(std::span<const int16_t> parents)
+    : parents_(parents.begin(), parents.end())
+{
+    REBEL_ASSERT(!parents.empty(), "skeletons need at least one bone");
+    const std::vector<uint32_t> height = heights(parents);
+    REBEL_ASSERT(std::is_sorted(height.rbegin(), height.rend()), "bones must be in LOD order");
+    levelBones_.resize(height[0] + 1);
+    for (uint32_t level = 0; level < levelBones_.size(); ++level)
+        levelBones_[level] = uint32_t(std::partition_point(height.begin(), height.end(),
+                                                           [&](uint32_t h) { return h >= level; }) -
+                                      height.begin());
+}
+
+uint32_t Skeleton::boneCount(uint32_t level) const
+{
+    return levelBones_[std::min(level, levelCount() - 1)];
+}
+
+std::vector<uint32_t> Skeleton::lodOrder(std::span<const int16_t> parents)
+{
+    // A parent is taller than any of its children, so sorting by height
+    // keeps parents first.
+    const std::vector<uint32_t> height = heights(parents);
+    std::vector<uint32_t> order(parents.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return height[a] > height[b]; });
+    return order;
+}
+
+} // namespace rebel::animation
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::animation {
+
+/// A bone hierarchy and its LOD levels. A bone's height is the number of
+/// generations below it (leaves are 0); level L keeps the bones of height
+/// L or more, so each level drops the previous level's leaves. Bones are
+/// stored in LOD order, so every level's bones are a prefix of the
+/// skeleton and evaluating a level touches only its first groups of a
+/// PoseBuffer.
+class Skeleton {
+public:
+    /// `parents[b]` is bone b's parent, which must come before it, or -1
+    /// for a root. Bones must already be in LOD order (see lodOrder()).
+    explicit Skeleton(std::span<const int16_t> parents);
+
+    uint32_t boneCount() const { return uint32_t(parents_.size()); }
+    int16_t parent(uint32_t bone) const { return parents_[bone]; }
+
+    /// Level 0 keeps every bone; the last keeps only the tallest roots.
+    uint32_t levelCount() const { return uint32_t(levelBones_.size()); }
+    /// Bones kept at `level`, clamped to the last.
+    uint32_t boneCount(uint32_t level) const;
+
+    /// A parents-first order of `parents`' bones that puts every level's
+    /// bones before the ones it drops: new bone i is old bone order[i].
+    /// Clips, meshes and masks are cooked in this order.
+    static std::vector<uint32_t> lodOrder(std::span<const int16_t> parents);
+
+private:
+    std::vector<int16_t> parents_;
+    std::vector<uint32_t> levelBones_;
+};
+
+} // namespace rebel::animation
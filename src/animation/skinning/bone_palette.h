@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/math/mat.h"
+#include "core/math/quat.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::animation {
+
+enum class SkinningMethod : uint8_t {
+    /// Linear blend skinning: the weighted sum of each vertex's bone
+    /// matrices. Handles any affine transform, scale included, but joints
+    /// that twist or bend far collapse towards the bone ("candy wrapper").
+    Linear,
+    /// Dual quaternion skinning: the weighted sum of rigid transforms as
+    /// unit dual quaternions. Keeps volume through twists, but rigid only.
+    DualQuaternion,
+};
+
+/// One instance's skinning transforms (current pose times inverse bind
+/// pose), stored structure-of-arrays: component c of every bone is
+/// contiguous, so a kernel gathers it for eight vertices' bones with one
+/// instruction.
+///
+/// Linear palettes hold a 3x4 row-major matrix per bone (12 components),
+/// dual quaternion palettes a real and a dual quaternion, x, y, z, w each
+/// (8 components). New bones start at identity.
+class BonePalette {
+public:
+    static constexpr uint32_t kLinearComponents = 12;
+    static constexpr uint32_t kDualQuaternionComponents = 8;
+
+    explicit BonePalette(SkinningMethod method = SkinningMethod::Linear, uint32_t bones = 0)
+        : method_(method)
+    {
+        resize(bones);
+    }
+
+    SkinningMethod method() const { return method_; }
+    uint32_t size() const { return bones_; }
+    uint32_t componentCount() const
+    {
+        return method_ == SkinningMethod::Linear ? kLinearComponents : kDualQuaternionComponents;
+    }
+
+    void resize(uint32_t bones)
+    {
+        std::vector<float> old = std::move(components_);
+        components_.assign(std::size_t(bones) * componentCount(), 0.0f);
+        for (uint32_t c = 0; c < componentCount(); ++c) {
+            const bool one = method_ == SkinningMethod::Linear ? c % 5 == 0 : c == 3;
+            for (uint32_t b = 0; b < bones; ++b)
+                components_[std::size_t(c) * bones + b] = b < bones_ ? old[std::size_t(c) * bones_ + b] : float(one);
+        }
+        bones_ = bones;
+    }
+
+    /// Linear palettes only: any affine transform.
+    void setMatrix(uint32_t bone, const math::Mat4& skin)
+    {
+        REBEL_ASSERT(method_ == SkinningMethod::Linear, "dual quaternion palettes take rigid transforms only");
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c)
+                at(uint32_t(r * 4 + c), bone) = skin.cols[c][r];
+        }
+    }
+
+    /// Rotation then translation, for either method.
+    void setRigid(uint32_t bone, math::Quat rotation, math::Vec3 translation)
+    {
+        if (method_ == SkinningMethod::Linear) {
+            setMatrix(bone, math::Mat4::trs(translation, rotation, {1.0f, 1.0f, 1.0f}));
+            return;
+        }
+        // Dual part: half the translation, as a pure quaternion, times the
+        // rotation.
+        const math::Quat dual = math::Quat{translation.x, translation.y, translation.z, 0.0f} * rotation * 0.5f;
+        const float values[kDualQuaternionComponents] = {rotation.x, rotation.y, rotation.z, rotation.w,
+                                                         dual.x,     dual.y,     dual.z,     dual.w};
+        for (uint32_t c = 0; c < kDualQuaternionComponents; ++c)
+            at(c, bone) = values[c];
+    }
+
+    /// Component `c` of every bone.
+    const float* component(uint32_t c) const { return components_.data() + std::size_t(c) * bones_; }
+
+private:
+    float& at(uint32_t c, uint32_t bone)
+    {
+        REBEL_ASSERT(bone < bones_, "bone out of range");
+        return components_[std::size_t(c) * bones_ + bone];
+    }
+
+    SkinningMethod method_;
+    uint32_t bones_ = 0;
+    std::vector<float> components_;
+};
+
+} // namespace rebel::animation
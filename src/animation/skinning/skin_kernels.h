@@ -0,0 +1,30 @@
+#pragma once
+
+#include "animation/skinning/skinned_mesh.h"
+#include "render/vertex.h"
+
+#include <cstdint>
+
+// Internal interface between Skinner and its per-ISA kernels.
+
+namespace rebel::animation::detail {
+
+struct SkinKernelInput {
+    const SkinnedMesh* mesh;
+    /// The palette's components, 12 for linear and 8 for dual quaternion
+    /// skinning (see BonePalette).
+    const float* palette[12];
+    /// Vertex 0 of the instance's output stream.
+    render::Vertex* out;
+};
+
+/// Skins blocks [begin, end) and writes their vertices below the mesh's
+/// vertex count to `out`. Normals come out unit length.
+using SkinKernel = void (*)(const SkinKernelInput& in, uint32_t begin, uint32_t end);
+
+void skinLinearScalar(const SkinKernelInput& in, uint32_t begin, uint32_t end);
+void skinLinearAvx2(const SkinKernelInput& in, uint32_t begin, uint32_t end);
+void skinDualQuaternionScalar(const SkinKernelInput& in, uint32_t begin, uint32_t end);
+void skinDualQuaternionAvx2(const SkinKernelInput& in, uint32_t begin, uint32_t end);
+
+} // namespace rebel::animation::detail
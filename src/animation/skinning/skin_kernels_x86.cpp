@@ -0,0 +1,233 @@
+#include "animation/skinning/skin_kernels.h"
+
+#include "core/platform.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// AVX2 variants of skinLinearScalar() and skinDualQuaternionScalar() (see
+// skinner.cpp for the reference), one block of eight vertices per
+// iteration. Built for the baseline ISA with per-function target
+// attributes; Skinner only calls them after checking detectSimdLevel().
+
+namespace rebel::animation::detail {
+
+namespace {
+
+constexpr uint32_t kLanes = SkinnedMesh::kBlockVertices;
+
+// Eight registers of one attribute for eight vertices become eight
+// vertices of eight attributes: render::Vertex rows.
+REBEL_TARGET_AVX2_FMA REBEL_FORCEINLINE void transpose8(__m256 (&r)[8])
+{
+    const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// Normalises the normal, keeps the block's uvs and writes its vertices;
+// a partial last block goes through the stack.
+REBEL_TARGET_AVX2_FMA REBEL_FORCEINLINE void writeBlock(const SkinKernelInput& in, uint32_t block, __m256 (&r)[8])
+{
+    const float* rows = in.mesh->attributes(block);
+    const __m256 length2 =
+        _mm256_fmadd_ps(r[3], r[3], _mm256_fmadd_ps(r[4], r[4], _mm256_mul_ps(r[5], r[5])));
+    // 1/sqrt with one Newton-Raphson step; zero normals stay zero.
+    const __m256 estimate = _mm256_rsqrt_ps(length2);
+    const __m256 refined = _mm256_mul_ps(
+        _mm256_mul_ps(_mm256_set1_ps(0.5f), estimate),
+        _mm256_fnmadd_ps(_mm256_mul_ps(length2, estimate), estimate, _mm256_set1_ps(3.0f)));
+    const __m256 scale = _mm256_and_ps(refined, _mm256_cmp_ps(length2, _mm256_setzero_ps(), _CMP_GT_OQ));
+    r[3] = _mm256_mul_ps(r[3], scale);
+    r[4] = _mm256_mul_ps(r[4], scale);
+    r[5] = _mm256_mul_ps(r[5], scale);
+    r[6] = _mm256_loadu_ps(rows + 6 * kLanes);
+    r[7] = _mm256_loadu_ps(rows + 7 * kLanes);
+    transpose8(r);
+
+    float* out = &in.out[block * kLanes].position.x;
+    const uint32_t lanes = in.mesh->vertexCount() - block * kLanes;
+    if (lanes >= kLanes) {
+        for (uint32_t v = 0; v < kLanes; ++v)
+            _mm256_storeu_ps(out + v * 8, r[v]);
+        return;
+    }
+    alignas(32) float tail[kLanes * 8];
+    for (uint32_t v = 0; v < kLanes; ++v)
+        _mm256_store_ps(tail + v * 8, r[v]);
+    std::memcpy(out, tail, lanes * sizeof(render::Vertex));
+}
+
+REBEL_TARGET_AVX2_FMA REBEL_FORCEINLINE __m256i loadBones(const uint16_t* bones)
+{
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bones)));
+}
+
+// v + w t + r x t with t = 2 r x v, as math::rotate(), by the real part
+// of q.
+REBEL_TARGET_AVX2_FMA REBEL_FORCEINLINE void rotate(const __m256 (&q)[8], __m256 vx, __m256 vy, __m256 vz, __m256& ox,
+                                                    __m256& oy, __m256& oz)
+{
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 rx = q[0], ry = q[1], rz = q[2], rw = q[3];
+    const __m256 cx = _mm256_mul_ps(two, _mm256_fmsub_ps(ry, vz, _mm256_mul_ps(rz, vy)));
+    const __m256 cy = _mm256_mul_ps(two, _mm256_fmsub_ps(rz, vx, _mm256_mul_ps(rx, vz)));
+    const __m256 cz = _mm256_mul_ps(two, _mm256_fmsub_ps(rx, vy, _mm256_mul_ps(ry, vx)));
+    ox = _mm256_add_ps(_mm256_fmadd_ps(rw, cx, vx), _mm256_fmsub_ps(ry, cz, _mm256_mul_ps(rz, cy)));
+    oy = _mm256_add_ps(_mm256_fmadd_ps(rw, cy, vy), _mm256_fmsub_ps(rz, cx, _mm256_mul_ps(rx, cz)));
+    oz = _mm256_add_ps(_mm256_fmadd_ps(rw, cz, vz), _mm256_fmsub_ps(rx, cy, _mm256_mul_ps(ry, cx)));
+}
+
+} // namespace
+
+REBEL_TARGET_AVX2_FMA void skinLinearAvx2(const SkinKernelInput& in, uint32_t begin, uint32_t end)
+{
+    const SkinnedMesh& mesh = *in.mesh;
+    const uint32_t influences = mesh.influences();
+    for (uint32_t b = begin; b < end; ++b) {
+        const uint16_t* bones = mesh.bones(b);
+        const float* weights = mesh.weights(b);
+
+        // Blend the 3x4 matrices. Influences are sorted by weight, so the
+        // first all-zero slot ends the block.
+        __m256 m[12];
+        {
+            const __m256i index = loadBones(bones);
+            const __m256 w = _mm256_loadu_ps(weights);
+            for (int c = 0; c < 12; ++c)
+                m[c] = _mm256_mul_ps(_mm256_i32gather_ps(in.palette[c], index, 4), w);
+        }
+        for (uint32_t k = 1; k < influences; ++k) {
+            const __m256 w = _mm256_loadu_ps(weights + k * kLanes);
+            if (!_mm256_movemask_ps(_mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_NEQ_OQ)))
+                break;
+            const __m256i index = loadBones(bones + k * kLanes);
+            for (int c = 0; c < 12; ++c)
+                m[c] = _mm256_fmadd_ps(_mm256_i32gather_ps(in.palette[c], index, 4), w, m[c]);
+        }
+
+        const float* rows = mesh.attributes(b);
+        const __m256 x = _mm256_loadu_ps(rows), y = _mm256_loadu_ps(rows + kLanes);
+        const __m256 z = _mm256_loadu_ps(rows + 2 * kLanes);
+        const __m256 nx = _mm256_loadu_ps(rows + 3 * kLanes), ny = _mm256_loadu_ps(rows + 4 * kLanes);
+        const __m256 nz = _mm256_loadu_ps(rows + 5 * kLanes);
+        __m256 r[8];
+        for (int row = 0; row < 3; ++row) {
+            const __m256* mr = m + row * 4;
+            r[row] = _mm256_fmadd_ps(mr[0], x, _mm256_fmadd_ps(mr[1], y, _mm256_fmadd_ps(mr[2], z, mr[3])));
+            r[3 + row] = _mm256_fmadd_ps(mr[0], nx, _mm256_fmadd_ps(mr[1], ny, _mm256_mul_ps(mr[2], nz)));
+        }
+        writeBlock(in, b, r);
+    }
+}
+
+REBEL_TARGET_AVX2_FMA void skinDualQuaternionAvx2(const SkinKernelInput& in, uint32_t begin, uint32_t end)
+{
+    const SkinnedMesh& mesh = *in.mesh;
+    const uint32_t influences = mesh.influences();
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    for (uint32_t b = begin; b < end; ++b) {
+        const uint16_t* bones = mesh.bones(b);
+        const float* weights = mesh.weights(b);
+
+        __m256 q[8];
+        {
+            const __m256i index = loadBones(bones);
+            const __m256 w = _mm256_loadu_ps(weights);
+            for (int c = 0; c < 8; ++c)
+                q[c] = _mm256_mul_ps(_mm256_i32gather_ps(in.palette[c], index, 4), w);
+        }
+        // The first influence's real part, for the sign test: q and -q are
+        // the same transform, so later influences blend on its side.
+        const __m256 px = q[0], py = q[1], pz = q[2], pw = q[3];
+        for (uint32_t k = 1; k < influences; ++k) {
+            __m256 w = _mm256_loadu_ps(weights + k * kLanes);
+            if (!_mm256_movemask_ps(_mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_NEQ_OQ)))
+                break;
+            const __m256i index = loadBones(bones + k * kLanes);
+            __m256 g[8];
+            for (int c = 0; c < 8; ++c)
+                g[c] = _mm256_i32gather_ps(in.palette[c], index, 4);
+            const __m256 side = _mm256_fmadd_ps(
+                px, g[0], _mm256_fmadd_ps(py, g[1], _mm256_fmadd_ps(pz, g[2], _mm256_mul_ps(pw, g[3]))));
+            w = _mm256_xor_ps(w, _mm256_and_ps(side, signBit));
+            for (int c = 0; c < 8; ++c)
+                q[c] = _mm256_fmadd_ps(g[c], w, q[c]);
+        }
+
+        // Normalise by the real part's length (exactly: the rotation must
+        // stay unit so normals need no second normalisation).
+        const __m256 length2 = _mm256_fmadd_ps(
+            q[0], q[0], _mm256_fmadd_ps(q[1], q[1], _mm256_fmadd_ps(q[2], q[2], _mm256_mul_ps(q[3], q[3]))));
+        const __m256 scale = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(length2)),
+                                           _mm256_cmp_ps(length2, _mm256_setzero_ps(), _CMP_GT_OQ));
+        for (__m256& c : q)
+            c = _mm256_mul_ps(c, scale);
+        const __m256 rx = q[0], ry = q[1], rz = q[2], rw = q[3];
+        const __m256 dx = q[4], dy = q[5], dz = q[6], dw = q[7];
+
+        // Translation 2 (w_r d - w_d r + r x d).
+        const __m256 tx = _mm256_mul_ps(
+            two, _mm256_fmsub_ps(rw, dx, _mm256_fmsub_ps(dw, rx, _mm256_fmsub_ps(ry, dz, _mm256_mul_ps(rz, dy)))));
+        const __m256 ty = _mm256_mul_ps(
+            two, _mm256_fmsub_ps(rw, dy, _mm256_fmsub_ps(dw, ry, _mm256_fmsub_ps(rz, dx, _mm256_mul_ps(rx, dz)))));
+        const __m256 tz = _mm256_mul_ps(
+            two, _mm256_fmsub_ps(rw, dz, _mm256_fmsub_ps(dw, rz, _mm256_fmsub_ps(rx, dy, _mm256_mul_ps(ry, dx)))));
+
+        const float* rows = mesh.attributes(b);
+        __m256 r[8];
+        rotate(q, _mm256_loadu_ps(rows), _mm256_loadu_ps(rows + kLanes), _mm256_loadu_ps(rows + 2 * kLanes), r[0],
+               r[1], r[2]);
+        r[0] = _mm256_add_ps(r[0], tx);
+        r[1] = _mm256_add_ps(r[1], ty);
+        r[2] = _mm256_add_ps(r[2], tz);
+        rotate(q, _mm256_loadu_ps(rows + 3 * kLanes), _mm256_loadu_ps(rows + 4 * kLanes),
+               _mm256_loadu_ps(rows + 5 * kLanes), r[3], r[4], r[5]);
+        writeBlock(in, b, r);
+    }
+}
+
+} // namespace rebel::animation::detail
+
+#else
+
+namespace rebel::animation::detail {
+
+void skinLinearAvx2(const SkinKernelInput& in, uint32_t begin, uint32_t end)
+{
+    skinLinearScalar(in, begin, end);
+}
+
+void skinDualQuaternionAvx2(const SkinKernelInput& in, uint32_t begin, uint32_t end)
+{
+    skinDualQuaternionScalar(in, begin, end);
+}
+
+} // namespace rebel::animation::detail
+
+#endif
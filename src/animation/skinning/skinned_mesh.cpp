@@ -0,0 +1,60 @@
+#include "animation/skinning/skinned_mesh.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rebel::animation {
+
+SkinnedMesh::SkinnedMesh(const SkinnedMeshDesc& desc)
+    : vertexCount_(uint32_t(desc.vertices.size()))
+    , influences_(desc.influences)
+{
+    REBEL_ASSERT(influences_ == 4 || influences_ == 8, "skinned meshes take 4 or 8 influences per vertex");
+    REBEL_ASSERT(desc.bones.size() == std::size_t(vertexCount_) * influences_ &&
+                     desc.weights.size() == desc.bones.size(),
+                 "bones and weights need `influences` entries per vertex");
+
+    const std::size_t blocks = blockCount();
+    attributes_.assign(blocks * kAttributes * kBlockVertices, 0.0f);
+    bones_.assign(blocks * influences_ * kBlockVertices, 0);
+    weights_.assign(bones_.size(), 0.0f);
+
+    std::pair<float, uint16_t> sorted[8];
+    for (uint32_t v = 0; v < vertexCount_; ++v) {
+        const uint32_t block = v / kBlockVertices, lane = v % kBlockVertices;
+        const render::Vertex& vertex = desc.vertices[v];
+        const float values[kAttributes] = {vertex.position.x, vertex.position.y, vertex.position.z, vertex.normal.x,
+                                           vertex.normal.y,   vertex.normal.z,   vertex.uv.x,       vertex.uv.y};
+        float* rows = attributes_.data() + std::size_t(block) * kAttributes * kBlockVertices;
+        for (uint32_t a = 0; a < kAttributes; ++a)
+            rows[a * kBlockVertices + lane] = values[a];
+
+        float total = 0.0f;
+        for (uint32_t k = 0; k < influences_; ++k) {
+            const std::size_t i = std::size_t(v) * influences_ + k;
+            const float weight = std::max(desc.weights[i], 0.0f);
+            sorted[k] = {weight, weight > 0.0f ? desc.bones[i] : uint16_t(0)};
+            total += weight;
+        }
+        // Insertion sort, heaviest first; there are at most eight.
+        for (uint32_t k = 1; k < influences_; ++k) {
+            for (uint32_t j = k; j > 0 && sorted[j].first > sorted[j - 1].first; --j)
+                std::swap(sorted[j], sorted[j - 1]);
+        }
+        if (total <= 0.0f) {
+            sorted[0] = {1.0f, 0};
+            total = 1.0f;
+        }
+
+        const std::size_t slots = std::size_t(block) * influences_ * kBlockVertices;
+        for (uint32_t k = 0; k < influences_; ++k) {
+            bones_[slots + k * kBlockVertices + lane] = sorted[k].second;
+            weights_[slots + k * kBlockVertices + lane] = sorted[k].first / total;
+            boneCount_ = std::max(boneCount_, uint32_t(sorted[k].second) + 1);
+        }
+    }
+}
+
+} // namespace rebel::animation
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "render/vertex.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::animation {
+
+struct SkinnedMeshDesc {
+    /// Bind pose, in the space the palette's transforms map from.
+    std::span<const render::Vertex> vertices;
+    /// `influences` bone indices and weights per vertex, vertex-major.
+    /// Weights need not sum to one; zero weights are ignored.
+    std::span<const uint16_t> bones;
+    std::span<const float> weights;
+    uint32_t influences = 4; // 4 or 8
+};
+
+/// Bind pose and bone influences cooked for the skinning kernels: blocks
+/// of kBlockVertices vertices, each holding every attribute for its eight
+/// vertices as eight-wide rows, then per influence slot eight bone indices
+/// and eight weights.
+///
+/// A vertex's influences are sorted by decreasing weight and normalised,
+/// so the later slots of a block are often all zero and the kernels stop
+/// at the first such slot. A vertex with no weight follows bone 0. The
+/// last block is padded with zero-weight vertices, never written out.
+class SkinnedMesh {
+public:
+    static constexpr uint32_t kBlockVertices = 8;
+    /// Position xyz, normal xyz and uv, the layout of render::Vertex.
+    static constexpr uint32_t kAttributes = 8;
+
+    explicit SkinnedMesh(const SkinnedMeshDesc& desc);
+
+    uint32_t vertexCount() const { return vertexCount_; }
+    uint32_t blockCount() const { return (vertexCount_ + kBlockVertices - 1) / kBlockVertices; }
+    uint32_t influences() const { return influences_; }
+    /// One past the highest bone index referenced; palettes need at least
+    /// this many bones.
+    uint32_t boneCount() const { return boneCount_; }
+    std::size_t memoryUsage() const
+    {
+        return attributes_.size() * sizeof(float) + bones_.size() * sizeof(uint16_t) + weights_.size() * sizeof(float);
+    }
+
+    /// Block b's attribute rows, kAttributes x kBlockVertices floats.
+    const float* attributes(uint32_t block) const
+    {
+        return attributes_.data() + std::size_t(block) * kAttributes * kBlockVertices;
+    }
+    /// Block b's influence slots, influences() x kBlockVertices each.
+    const uint16_t* bones(uint32_t block) const
+    {
+        return bones_.data() + std::size_t(block) * influences_ * kBlockVertices;
+    }
+    const float* weights(uint32_t block) const
+    {
+        return weights_.data() + std::size_t(block) * influences_ * kBlockVertices;
+    }
+
+private:
+    std::vector<float> attributes_;
+    std::vector<uint16_t> bones_;
+    std::vector<float> weights_;
+    uint32_t vertexCount_ = 0;
+    uint32_t influences_ = 4;
+    uint32_t boneCount_ = 0;
+};
+
+} // namespace rebel::animation
@@ -0,0 +1,164 @@
+#include "animation/skinning/skinner.h"
+
+#include "animation/skinning/skin_kernels.h"
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rebel::animation {
+
+namespace detail {
+
+namespace {
+
+constexpr uint32_t kLanes = SkinnedMesh::kBlockVertices;
+
+// Writes one vertex from its eight attributes, normalising the normal.
+void writeVertex(render::Vertex& out, const float (&p)[3], const float (&n)[3], const float* rows, uint32_t lane)
+{
+    const float length2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+    const float scale = length2 > 0.0f ? 1.0f / std::sqrt(length2) : 0.0f;
+    out.position = {p[0], p[1], p[2]};
+    out.normal = {n[0] * scale, n[1] * scale, n[2] * scale};
+    out.uv = {rows[6 * kLanes + lane], rows[7 * kLanes + lane]};
+}
+
+} // namespace
+
+void skinLinearScalar(const SkinKernelInput& in, uint32_t begin, uint32_t end)
+{
+    const SkinnedMesh& mesh = *in.mesh;
+    const uint32_t influences = mesh.influences();
+    for (uint32_t b = begin; b < end; ++b) {
+        const float* rows = mesh.attributes(b);
+        const uint16_t* bones = mesh.bones(b);
+        const float* weights = mesh.weights(b);
+        const uint32_t lanes = std::min(kLanes, mesh.vertexCount() - b * kLanes);
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            float m[12] = {};
+            for (uint32_t k = 0; k < influences; ++k) {
+                const float w = weights[k * kLanes + lane];
+                if (w == 0.0f)
+                    break;
+                const uint16_t bone = bones[k * kLanes + lane];
+                for (int c = 0; c < 12; ++c)
+                    m[c] += in.palette[c][bone] * w;
+            }
+            const float x = rows[lane], y = rows[kLanes + lane], z = rows[2 * kLanes + lane];
+            const float nx = rows[3 * kLanes + lane], ny = rows[4 * kLanes + lane], nz = rows[5 * kLanes + lane];
+            float p[3], n[3];
+            for (int r = 0; r < 3; ++r) {
+                p[r] = m[r * 4] * x + m[r * 4 + 1] * y + m[r * 4 + 2] * z + m[r * 4 + 3];
+                n[r] = m[r * 4] * nx + m[r * 4 + 1] * ny + m[r * 4 + 2] * nz;
+            }
+            writeVertex(in.out[b * kLanes + lane], p, n, rows, lane);
+        }
+    }
+}
+
+void skinDualQuaternionScalar(const SkinKernelInput& in, uint32_t begin, uint32_t end)
+{
+    const SkinnedMesh& mesh = *in.mesh;
+    const uint32_t influences = mesh.influences();
+    for (uint32_t b = begin; b < end; ++b) {
+        const float* rows = mesh.attributes(b);
+        const uint16_t* bones = mesh.bones(b);
+        const float* weights = mesh.weights(b);
+        const uint32_t lanes = std::min(kLanes, mesh.vertexCount() - b * kLanes);
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            float q[8] = {};
+            float pivot[4] = {};
+            for (uint32_t k = 0; k < influences; ++k) {
+                float w = weights[k * kLanes + lane];
+                if (w == 0.0f)
+                    break;
+                const uint16_t bone = bones[k * kLanes + lane];
+                // q and -q are the same transform; blend every influence
+                // on the same side as the first.
+                if (k == 0) {
+                    for (int c = 0; c < 4; ++c)
+                        pivot[c] = in.palette[c][bone];
+                } else if (pivot[0] * in.palette[0][bone] + pivot[1] * in.palette[1][bone] +
+                               pivot[2] * in.palette[2][bone] + pivot[3] * in.palette[3][bone] <
+                           0.0f) {
+                    w = -w;
+                }
+                for (int c = 0; c < 8; ++c)
+                    q[c] += in.palette[c][bone] * w;
+            }
+            const float length2 = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+            const float scale = length2 > 0.0f ? 1.0f / std::sqrt(length2) : 0.0f;
+            for (float& c : q)
+                c *= scale;
+
+            // Rotate by the real part, then translate by
+            // 2 (w_r d - w_d r + r x d), the vector parts of r and d.
+            const math::Vec3 r{q[0], q[1], q[2]}, d{q[4], q[5], q[6]};
+            const math::Quat rotation{q[0], q[1], q[2], q[3]};
+            const math::Vec3 t = (d * q[3] - r * q[7] + math::cross(r, d)) * 2.0f;
+            const math::Vec3 position =
+                math::rotate(rotation, {rows[lane], rows[kLanes + lane], rows[2 * kLanes + lane]}) + t;
+            const math::Vec3 normal =
+                math::rotate(rotation, {rows[3 * kLanes + lane], rows[4 * kLanes + lane], rows[5 * kLanes + lane]});
+            const float p[3] = {position.x, position.y, position.z};
+            const float n[3] = {normal.x, normal.y, normal.z};
+            writeVertex(in.out[b * kLanes + lane], p, n, rows, lane);
+        }
+    }
+}
+
+} // namespace detail
+
+Skinner::Skinner(SimdLevel level)
+    : level_(level)
+{
+}
+
+void Skinner::skin(std::span<const SkinInstance> instances, jobs::JobSystem& jobs)
+{
+    stats_ = {};
+    stats_.instances = uint32_t(instances.size());
+    firstBlock_.resize(instances.size() + 1);
+    firstBlock_[0] = 0;
+    for (std::size_t i = 0; i < instances.size(); ++i) {
+        const SkinInstance& instance = instances[i];
+        REBEL_ASSERT(instance.mesh && instance.palette, "skin instances need a mesh and a palette");
+        REBEL_ASSERT(instance.palette->size() >= instance.mesh->boneCount(), "palette is smaller than the skeleton");
+        REBEL_ASSERT(instance.output.size() >= instance.mesh->vertexCount(), "output stream is too short");
+        firstBlock_[i + 1] = firstBlock_[i] + instance.mesh->blockCount();
+        const uint32_t vertices = instance.mesh->vertexCount();
+        stats_.vertices += vertices;
+        if (instance.palette->method() == SkinningMethod::Linear)
+            stats_.linearVertices += vertices;
+        else
+            stats_.dualQuaternionVertices += vertices;
+    }
+
+    const bool wide = level_ >= SimdLevel::Avx2;
+    const detail::SkinKernel linear = wide ? detail::skinLinearAvx2 : detail::skinLinearScalar;
+    const detail::SkinKernel dualQuaternion = wide ? detail::skinDualQuaternionAvx2 : detail::skinDualQuaternionScalar;
+
+    // Each job finds the instance holding its first block, then walks on
+    // through as many instances as its range covers.
+    jobs.parallelFor(firstBlock_.back(), kBlocksPerJob, [&](uint32_t begin, uint32_t end) {
+        const auto first = std::upper_bound(firstBlock_.begin(), firstBlock_.end(), begin) - 1;
+        for (std::size_t i = std::size_t(first - firstBlock_.begin()); begin < end; ++i) {
+            const SkinInstance& instance = instances[i];
+            const uint32_t stop = std::min(end, firstBlock_[i + 1]);
+            if (begin == stop)
+                continue;
+            detail::SkinKernelInput in{};
+            in.mesh = instance.mesh;
+            for (uint32_t c = 0; c < instance.palette->componentCount(); ++c)
+                in.palette[c] = instance.palette->component(c);
+            in.out = instance.output.data();
+            const bool isLinear = instance.palette->method() == SkinningMethod::Linear;
+            (isLinear ? linear : dualQuaternion)(in, begin - firstBlock_[i], stop - firstBlock_[i]);
+            begin = stop;
+        }
+    });
+}
+
+} // namespace rebel::animation
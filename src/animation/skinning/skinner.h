@@ -0,0 +1,65 @@
+#pragma once
+
+#include "animation/skinning/bone_palette.h"
+#include "animation/skinning/skinned_mesh.h"
+#include "core/cpu_features.h"
+#include "render/vertex.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::animation {
+
+struct SkinInstance {
+    const SkinnedMesh* mesh = nullptr;
+    /// Its method picks the kernel; needs mesh->boneCount() bones.
+    const BonePalette* palette = nullptr;
+    /// The renderer's vertex stream for this instance, at least
+    /// mesh->vertexCount() long. Positions, normals and uvs are all
+    /// overwritten.
+    std::span<render::Vertex> output;
+};
+
+struct SkinStats {
+    uint32_t instances = 0;
+    uint32_t vertices = 0;
+    uint32_t linearVertices = 0;
+    uint32_t dualQuaternionVertices = 0;
+};
+
+/// CPU skinning for machines without a GPU, such as servers and tooling.
+///
+/// All instances' vertex blocks are laid end to end and split into jobs of
+/// kBlocksPerJob blocks, so a frame of many small meshes spreads across
+/// workers as evenly as one large mesh. Each kernel call blends the
+/// palette entries of eight vertices at a time, gathering every component
+/// for the eight vertices' bones at once, transforms positions and
+/// normals, and transposes the results straight into the output stream
+/// as whole render::Vertex rows.
+///
+/// Kernels exist for AVX2 (8 lanes) and scalar code; the widest one the
+/// CPU supports is used unless a lower level is requested.
+class Skinner {
+public:
+    static constexpr uint32_t kBlocksPerJob = 256;
+
+    explicit Skinner(SimdLevel level = detectSimdLevel());
+
+    SimdLevel simdLevel() const { return level_; }
+
+    void skin(std::span<const SkinInstance> instances, jobs::JobSystem& jobs);
+
+    const SkinStats& stats() const { return stats_; }
+
+private:
+    SimdLevel level_;
+    std::vector<uint32_t> firstBlock_; // per instance, plus the total
+    SkinStats stats_;
+};
+
+} // namespace rebel::animation
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "core/math/quat.h"
+#include "core/math/vec.h"
+
+namespace rebel::animation {
+
+/// A bone's transform relative to its parent: scale, then rotation, then
+/// translation.
+struct Transform {
+    math::Quat rotation;
+    math::Vec3 translation;
+    math::Vec3 scale{1.0f, 1.0f, 1.0f};
+};
+
+} // namespace rebel::animation
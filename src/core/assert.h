@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace rebel::detail {
+
+[[noreturn]] inline void assertFailed(const char* expr, const char* msg, const char* file, int line)
+{
+    std::fprintf(stderr, "%s:%d: assertion '%s' failed: %s\n", file, line, expr, msg);
+    std::abort();
+}
+
+} // namespace rebel::detail
+
+/// Debug-only invariant check. Engine code reports programmer errors through
+/// this macro rather than exceptions; release builds compile it out unless
+/// REBEL_ENABLE_ASSERTS is defined.
+#if !defined(NDEBUG) || defined(REBEL_ENABLE_ASSERTS)
+#define REBEL_ASSERT(cond, msg)                                                  \
+    do {                                                                         \
+        if (!(cond))                                                             \
+            ::rebel::detail::assertFailed(#cond, msg, __FILE__, __LINE__);       \
+    } while (0)
+#else
+#define REBEL_ASSERT(cond, msg) ((void)0)
+#endif
@@ -0,0 +1,40 @@
+#include "core/cpu_features.h"
+
+namespace rebel {
+
+namespace {
+
+SimdLevel queryCpu()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::Avx2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel()
+{
+    static const SimdLevel level = queryCpu();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace rebel
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rebel {
+
+/// Widest x86 vector ISA a kernel may use. Hot loops provide one
+/// target-attributed variant per level and dispatch on detectSimdLevel().
+enum class SimdLevel : uint8_t {
+    Scalar,
+    Avx2,   // AVX2 + FMA, 8 float lanes
+    Avx512, // AVX-512F, 16 float lanes
+};
+
+/// Best level supported by the running CPU (and OS). Detected once.
+SimdLevel detectSimdLevel();
+
+const char* simdLevelName(SimdLevel level);
+
+} // namespace rebel
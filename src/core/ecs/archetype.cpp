@@ -0,0 +1,132 @@
+#include "core/ecs/archetype.h"
+
+#include "core/assert.h"
+#include "core/platform.h"
+
+#include <cstring>
+#include <new>
+
+namespace rebel::ecs {
+
+namespace {
+
+std::byte* allocateChunkMemory()
+{
+    return static_cast<std::byte*>(::operator new(kChunkSize, std::align_val_t(kCacheLineSize)));
+}
+
+void freeChunkMemory(std::byte* data)
+{
+    ::operator delete(data, std::align_val_t(kCacheLineSize));
+}
+
+// Byte size of a chunk laid out for `capacity` rows, with every column
+// starting on its own alignment boundary.
+std::size_t layoutSize(uint32_t capacity, std::span<const uint32_t> sizes, std::span<const uint32_t> aligns,
+                       std::vector<uint32_t>* offsets)
+{
+    std::size_t offset = sizeof(Entity) * capacity;
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        offset = alignUp(offset, aligns[i]);
+        if (offsets)
+            (*offsets)[i] = uint32_t(offset);
+        offset += std::size_t(sizes[i]) * capacity;
+    }
+    return offset;
+}
+
+} // namespace
+
+Archetype::Archetype(uint32_t id, std::span<const ComponentId> sortedComponents)
+    : id_(id)
+    , components_(sortedComponents.begin(), sortedComponents.end())
+{
+    columnLookup_.fill(-1);
+
+    std::vector<uint32_t> aligns;
+    columnSizes_.reserve(components_.size());
+    aligns.reserve(components_.size());
+    std::size_t rowBytes = sizeof(Entity);
+    for (std::size_t i = 0; i < components_.size(); ++i) {
+        const ComponentInfo& info = ComponentRegistry::info(components_[i]);
+        mask_.set(info.id);
+        columnLookup_[info.id] = int16_t(i);
+        columnSizes_.push_back(info.size);
+        aligns.push_back(info.alignment);
+        rowBytes += info.size;
+    }
+
+    // Start from the unpadded estimate and back off until alignment padding fits.
+    capacity_ = uint32_t(kChunkSize / rowBytes);
+    while (capacity_ > 1 && layoutSize(capacity_, columnSizes_, aligns, nullptr) > kChunkSize)
+        --capacity_;
+    REBEL_ASSERT(capacity_ >= 1 && layoutSize(capacity_, columnSizes_, aligns, nullptr) <= kChunkSize,
+                 "component signature does not fit in a chunk");
+
+    columnOffsets_.resize(components_.size());
+    layoutSize(capacity_, columnSizes_, aligns, &columnOffsets_);
+}
+
+Archetype::~Archetype()
+{
+    for (Chunk& chunk : chunks_)
+        freeChunkMemory(chunk.data);
+    if (spare_.data)
+        freeChunkMemory(spare_.data);
+}
+
+Archetype::Row Archetype::pushRow(Entity entity)
+{
+    if (chunks_.empty() || chunks_.back().count == capacity_) {
+        Chunk chunk;
+        if (spare_.data) {
+            chunk.data = spare_.data;
+            spare_.data = nullptr;
+        } else {
+            chunk.data = allocateChunkMemory();
+        }
+        chunks_.push_back(chunk);
+    }
+
+    Chunk& chunk = chunks_.back();
+    const uint32_t row = chunk.count++;
+    entities(chunk)[row] = entity;
+    ++entityCount_;
+    return {uint32_t(chunks_.size() - 1), row};
+}
+
+Entity Archetype::swapRemoveRow(Row row)
+{
+    REBEL_ASSERT(row.chunk < chunks_.size() && row.row < chunks_[row.chunk].count, "row out of range");
+
+    Chunk& last = chunks_.back();
+    const uint32_t lastRow = last.count - 1;
+    const bool removingLast = row.chunk == chunks_.size() - 1 && row.row == lastRow;
+
+    Entity moved = kNullEntity;
+    if (!removingLast) {
+        Chunk& dst = chunks_[row.chunk];
+        moved = entities(last)[lastRow];
+        entities(dst)[row.row] = moved;
+        for (std::size_t c = 0; c < components_.size(); ++c) {
+            const uint32_t size = columnSizes_[c];
+            if (size == 0)
+                continue;
+            std::memcpy(columnData(dst, int(c)) + std::size_t(row.row) * size,
+                        columnData(last, int(c)) + std::size_t(lastRow) * size, size);
+        }
+    }
+
+    --last.count;
+    --entityCount_;
+    if (last.count == 0) {
+        if (spare_.data)
+            freeChunkMemory(last.data);
+        else
+            spare_.data = last.data;
+        chunks_.pop_back();
+    }
+    return moved;
+}
+
+} // namespace rebel::ecs
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/ecs/component.h"
+#include "core/ecs/entity.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace rebel::ecs {
+
+/// Every chunk is exactly this many bytes. A chunk holds the entity ids of
+/// its rows followed by one tightly packed array per component (SoA), so a
+/// system touching two components streams through two contiguous arrays.
+inline constexpr std::size_t kChunkSize = 16 * 1024;
+
+struct Chunk {
+    std::byte* data = nullptr;
+    uint32_t count = 0;
+};
+
+/// Set of entities sharing the exact same component signature.
+class Archetype {
+public:
+    Archetype(uint32_t id, std::span<const ComponentId> sortedComponents);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    uint32_t id() const { return id_; }
+    const ComponentMask& mask() const { return mask_; }
+    std::span<const ComponentId> components() const { return components_; }
+
+    /// Column index of a component in this archetype, or -1 when absent.
+    int column(ComponentId component) const { return columnLookup_[component]; }
+
+    uint32_t chunkCapacity() const { return capacity_; }
+    std::size_t chunkCount() const { return chunks_.size(); }
+    const Chunk& chunk(std::size_t index) const { return chunks_[index]; }
+    std::size_t entityCount() const { return entityCount_; }
+
+    Entity* entities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+
+    std::byte* columnData(const Chunk& chunk, int column) const
+    {
+        return chunk.data + columnOffsets_[std::size_t(column)];
+    }
+
+    void* componentPtr(uint32_t chunkIndex, uint32_t row, int column) const
+    {
+        return columnData(chunks_[chunkIndex], column) + std::size_t(row) * columnSizes_[std::size_t(column)];
+    }
+
+    uint32_t columnSize(int column) const { return columnSizes_[std::size_t(column)]; }
+
+    struct Row {
+        uint32_t chunk;
+        uint32_t row;
+    };
+
+    /// Appends a row for `entity`; component memory is left uninitialised.
+    Row pushRow(Entity entity);
+
+    /// Removes a row by moving the archetype's last row into its place, which
+    /// keeps every chunk but the last one full. Returns the entity that was
+    /// moved (kNullEntity if the removed row was the last one).
+    Entity swapRemoveRow(Row row);
+
+    /// Cached archetype transitions for add/remove of a single component.
+    std::unordered_map<ComponentId, Archetype*> addEdges;
+    std::unordered_map<ComponentId, Archetype*> removeEdges;
+
+private:
+    uint32_t id_;
+    ComponentMask mask_;
+    std::vector<ComponentId> components_;
+    std::vector<uint32_t> columnSizes_;
+    std::vector<uint32_t> columnOffsets_;
+    std::array<int16_t, kMaxComponentTypes> columnLookup_;
+    uint32_t capacity_ = 0;
+    std::size_t entityCount_ = 0;
+    std::vector<Chunk> chunks_;
+    Chunk spare_; // one empty chunk kept around to avoid allocation churn at the boundary
+};
+
+} // namespace rebel::ecs
@@ -0,0 +1,54 @@
+#include "core/ecs/component.h"
+
+#include "core/assert.h"
+
+#include <mutex>
+#include <deque>
+
+namespace rebel::ecs {
+
+namespace {
+
+struct RegistryState {
+    std::mutex mutex;
+    std::deque<ComponentInfo> infos; // deque keeps info() references stable
+};
+
+RegistryState& state()
+{
+    static RegistryState s;
+    return s;
+}
+
+} // namespace
+
+ComponentId ComponentRegistry::registerType(uint32_t size, uint32_t alignment, const char* name)
+{
+    RegistryState& s = state();
+    std::lock_guard lock(s.mutex);
+    REBEL_ASSERT(s.infos.size() < kMaxComponentTypes, "too many component types");
+    ComponentInfo info;
+    info.id = ComponentId(s.infos.size());
+    info.size = size;
+    info.alignment = alignment;
+    info.name = name;
+    s.infos.push_back(info);
+    return info.id;
+}
+
+const ComponentInfo& ComponentRegistry::info(ComponentId id)
+{
+    RegistryState& s = state();
+    std::lock_guard lock(s.mutex);
+    REBEL_ASSERT(id < s.infos.size(), "unknown component id");
+    return s.infos[id];
+}
+
+std::size_t ComponentRegistry::count()
+{
+    RegistryState& s = state();
+    std::lock_guard lock(s.mutex);
+    return s.infos.size();
+}
+
+} // namespace rebel::ecs
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+
+namespace rebel::ecs {
+
+using ComponentId = uint16_t;
+
+inline constexpr std::size_t kMaxComponentTypes = 256;
+using ComponentMask = std::bitset<kMaxComponentTypes>;
+
+/// Layout information for a registered component type. Components are plain
+/// data: they are relocated between chunks with memcpy and never destructed.
+/// Empty types are tags and occupy no storage.
+struct ComponentInfo {
+    ComponentId id = 0;
+    uint32_t size = 0;
+    uint32_t alignment = 1;
+    const char* name = "";
+};
+
+class ComponentRegistry {
+public:
+    static ComponentId registerType(uint32_t size, uint32_t alignment, const char* name);
+    static const ComponentInfo& info(ComponentId id);
+    static std::size_t count();
+};
+
+template <typename T>
+concept Component = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+
+/// Stable runtime id for a component type, assigned on first use. A
+/// cv-qualified T shares the id of the unqualified type.
+template <Component T>
+ComponentId componentId()
+{
+    if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>) {
+        return componentId<std::remove_cv_t<T>>();
+    } else {
+        static const ComponentId id = ComponentRegistry::registerType(
+            std::is_empty_v<T> ? 0u : uint32_t(sizeof(T)), uint32_t(alignof(T)), typeid(T).name());
+        return id;
+    }
+}
+
+template <Component... Ts>
+ComponentMask componentMask()
+{
+    ComponentMask mask;
+    (mask.set(componentId<Ts>()), ...);
+    return mask;
+}
+
+} // namespace rebel::ecs
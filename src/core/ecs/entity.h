@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace rebel::ecs {
+
+/// Lightweight entity identifier. The index addresses the world's entity
+/// table; the generation is bumped whenever an index is recycled so stale
+/// handles can be detected.
+struct Entity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    constexpr bool isNull() const { return index == UINT32_MAX; }
+    constexpr uint64_t bits() const { return (uint64_t(generation) << 32) | index; }
+
+    friend constexpr bool operator==(Entity a, Entity b) = default;
+};
+
+inline constexpr Entity kNullEntity{};
+
+} // namespace rebel::ecs
+
+template <>
+struct std::hash<rebel::ecs::Entity> {
+    size_t operator()(rebel::ecs::Entity e) const noexcept { return std::hash<uint64_t>{}(e.bits()); }
+};
@@ -0,0 +1,159 @@
+#include "core/ecs/world.h"
+
+#include <cstring>
+
+namespace rebel::ecs {
+
+namespace {
+
+std::atomic<uint64_t> nextWorldId{1};
+
+} // namespace
+
+World::World()
+    : id_(nextWorldId.fetch_add(1, std::memory_order_relaxed))
+{
+    emptyArchetype_ = archetypeFor(ComponentMask{});
+}
+
+World::~World() = default;
+
+Entity World::create()
+{
+    return allocateEntity(emptyArchetype_);
+}
+
+void World::destroy(Entity entity)
+{
+    REBEL_ASSERT(iterationDepth_ == 0, "structural change during iteration");
+    if (!alive(entity))
+        return;
+
+    Record& record = records_[entity.index];
+    removeRow(record);
+    record.archetype = nullptr;
+    ++record.generation;
+    freeIndices_.push_back(entity.index);
+    --liveCount_;
+}
+
+bool World::alive(Entity entity) const
+{
+    return entity.index < records_.size() && records_[entity.index].archetype != nullptr &&
+           records_[entity.index].generation == entity.generation;
+}
+
+void World::gatherChunks(Query& query, std::vector<ChunkView>& out)
+{
+    for (Archetype* archetype : matching(query)) {
+        for (std::size_t c = 0; c < archetype->chunkCount(); ++c)
+            out.emplace_back(archetype, &archetype->chunk(c));
+    }
+}
+
+std::span<Archetype* const> World::matching(Query& query)
+{
+    if (query.world_ != id_) {
+        query.invalidate();
+        query.world_ = id_;
+    }
+    for (; query.scanned_ < archetypes_.size(); ++query.scanned_) {
+        Archetype* archetype = archetypes_[query.scanned_].get();
+        if (query.matches(*archetype))
+            query.matched_.push_back(archetype);
+    }
+    return query.matched_;
+}
+
+Archetype* World::archetypeFor(const ComponentMask& mask)
+{
+    if (auto it = archetypeByMask_.find(mask); it != archetypeByMask_.end())
+        return it->second;
+
+    std::vector<ComponentId> ids;
+    for (std::size_t i = 0; i < kMaxComponentTypes; ++i) {
+        if (mask.test(i))
+            ids.push_back(ComponentId(i));
+    }
+    archetypes_.push_back(std::make_unique<Archetype>(uint32_t(archetypes_.size()), ids));
+    Archetype* archetype = archetypes_.back().get();
+    archetypeByMask_.emplace(mask, archetype);
+    return archetype;
+}
+
+Entity World::allocateEntity(Archetype* archetype)
+{
+    REBEL_ASSERT(iterationDepth_ == 0, "structural change during iteration");
+
+    uint32_t index;
+    if (!freeIndices_.empty()) {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    } else {
+        index = uint32_t(records_.size());
+        records_.emplace_back();
+    }
+
+    Record& record = records_[index];
+    const Entity entity{index, record.generation};
+    const Archetype::Row row = archetype->pushRow(entity);
+    record.archetype = archetype;
+    record.chunk = row.chunk;
+    record.row = row.row;
+    ++liveCount_;
+    return entity;
+}
+
+void World::reserveEntities(std::size_t count)
+{
+    const std::size_t fresh = count > freeIndices_.size() ? count - freeIndices_.size() : 0;
+    records_.reserve(records_.size() + fresh);
+}
+
+void World::removeRow(const Record& record)
+{
+    const Entity moved = record.archetype->swapRemoveRow({record.chunk, record.row});
+    if (!moved.isNull()) {
+        Record& movedRecord = records_[moved.index];
+        movedRecord.chunk = record.chunk;
+        movedRecord.row = record.row;
+    }
+}
+
+void World::moveEntity(Entity entity, ComponentId component, bool adding)
+{
+    REBEL_ASSERT(iterationDepth_ == 0, "structural change during iteration");
+
+    Record& record = records_[entity.index];
+    Archetype* source = record.archetype;
+
+    auto& edges = adding ? source->addEdges : source->removeEdges;
+    Archetype* target;
+    if (auto it = edges.find(component); it != edges.end()) {
+        target = it->second;
+    } else {
+        ComponentMask mask = source->mask();
+        mask.set(component, adding);
+        target = archetypeFor(mask);
+        edges.emplace(component, target);
+    }
+
+    const Archetype::Row row = target->pushRow(entity);
+    for (const ComponentId id : target->components()) {
+        const int srcColumn = source->column(id);
+        const int dstColumn = target->column(id);
+        const uint32_t size = target->columnSize(dstColumn);
+        if (srcColumn < 0 || size == 0)
+            continue;
+        std::memcpy(target->componentPtr(row.chunk, row.row, dstColumn),
+                    source->componentPtr(record.chunk, record.row, srcColumn), size);
+    }
+
+    const Record old = record;
+    removeRow(old);
+    record.archetype = target;
+    record.chunk = row.chunk;
+    record.row = row.row;
+}
+
+} // namespace rebel::ecs
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/ecs/archetype.h"
+#include "core/ecs/component.h"
+#include "core/ecs/entity.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rebel::ecs {
+
+/// Filter over archetypes. Matching archetypes are cached and refreshed
+/// incrementally, so keeping a Query alive across frames makes matching free
+/// once the set of archetypes stabilises.
+class Query {
+public:
+    template <Component... Ts>
+    Query& with()
+    {
+        (include_.set(componentId<Ts>()), ...);
+        invalidate();
+        return *this;
+    }
+
+    template <Component... Ts>
+    Query& without()
+    {
+        (exclude_.set(componentId<Ts>()), ...);
+        invalidate();
+        return *this;
+    }
+
+    const ComponentMask& included() const { return include_; }
+    const ComponentMask& excluded() const { return exclude_; }
+
+    bool matches(const Archetype& archetype) const
+    {
+        const ComponentMask& mask = archetype.mask();
+        return (mask & include_) == include_ && (mask & exclude_).none();
+    }
+
+private:
+    friend class World;
+
+    void invalidate()
+    {
+        matched_.clear();
+        scanned_ = 0;
+    }
+
+    ComponentMask include_;
+    ComponentMask exclude_;
+    std::vector<Archetype*> matched_;
+    std::size_t scanned_ = 0;
+    // World::id() of the world matched_ came from; a world created at a
+    // destroyed one's address gets a new id, so stale archetypes are never
+    // reused.
+    uint64_t world_ = 0;
+};
+
+/// One chunk's worth of rows seen through a query. Component arrays are
+/// contiguous, so systems can loop over raw pointers and let the compiler
+/// vectorise.
+class ChunkView {
+public:
+    ChunkView() = default;
+    ChunkView(const Archetype* archetype, const Chunk* chunk)
+        : archetype_(archetype)
+        , chunk_(chunk)
+    {
+    }
+
+    uint32_t size() const { return chunk_->count; }
+    const Archetype& archetype() const { return *archetype_; }
+
+    std::span<const Entity> entities() const { return {archetype_->entities(*chunk_), chunk_->count}; }
+
+    /// Column for T, or nullptr when the archetype lacks T (or T is a tag).
+    template <Component T>
+    T* get() const
+    {
+        const int column = archetype_->column(componentId<T>());
+        if (column < 0 || archetype_->columnSize(column) == 0)
+            return nullptr;
+        return std::launder(reinterpret_cast<T*>(archetype_->columnData(*chunk_, column)));
+    }
+
+    template <Component T>
+    bool has() const
+    {
+        return archetype_->column(componentId<T>()) >= 0;
+    }
+
+private:
+    const Archetype* archetype_ = nullptr;
+    const Chunk* chunk_ = nullptr;
+};
+
+/// Owns entities and their components, stored per archetype in 16 KiB SoA
+/// chunks. Structural changes (create/destroy/add/remove) must not happen
+/// while iterating. Several threads may iterate one World at once, each
+/// with its own Query.
+class World {
+public:
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    /// Unique for the life of the process.
+    uint64_t id() const { return id_; }
+
+    Entity create();
+
+    template <Component... Ts>
+    Entity create(const Ts&... components)
+    {
+        static_assert(sizeof...(Ts) > 0);
+        Archetype* archetype = archetypeFor(componentMask<Ts...>());
+        const Entity entity = allocateEntity(archetype);
+        (writeComponent(entity, components), ...);
+        return entity;
+    }
+
+    /// Creates `count` entities with the given components, value-initialised
+    /// from the prototypes. Much cheaper than calling create() in a loop since
+    /// it resolves the archetype once.
+    template <Component... Ts>
+    void createMany(std::size_t count, const Ts&... prototypes)
+    {
+        Archetype* archetype = archetypeFor(componentMask<Ts...>());
+        reserveEntities(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const Entity entity = allocateEntity(archetype);
+            (writeComponent(entity, prototypes), ...);
+        }
+    }
+
+    void destroy(Entity entity);
+    bool alive(Entity entity) const;
+    std::size_t entityCount() const { return liveCount_; }
+
+    template <Component T>
+    T* get(Entity entity) const
+    {
+        if (!alive(entity))
+            return nullptr;
+        const Record& record = records_[entity.index];
+        const int column = record.archetype->column(componentId<T>());
+        if (column < 0 || record.archetype->columnSize(column) == 0)
+            return nullptr;
+        return static_cast<T*>(record.archetype->componentPtr(record.chunk, record.row, column));
+    }
+
+    template <Component T>
+    bool has(Entity entity) const
+    {
+        return alive(entity) && records_[entity.index].archetype->column(componentId<T>()) >= 0;
+    }
+
+    /// Adds T (or overwrites it when already present).
+    template <Component T>
+    void add(Entity entity, const T& value = T{})
+    {
+        REBEL_ASSERT(alive(entity), "add() on dead entity");
+        const ComponentId id = componentId<T>();
+        if (records_[entity.index].archetype->column(id) < 0)
+            moveEntity(entity, id, true);
+        writeComponent(entity, value);
+    }
+
+    template <Component T>
+    void remove(Entity entity)
+    {
+        REBEL_ASSERT(alive(entity), "remove() on dead entity");
+        const ComponentId id = componentId<T>();
+        if (records_[entity.index].archetype->column(id) >= 0)
+            moveEntity(entity, id, false);
+    }
+
+    /// Calls fn(ChunkView) for every non-empty chunk matched by the query.
+    template <typename Fn>
+    void forEachChunk(Query& query, Fn&& fn)
+    {
+        ++iterationDepth_;
+        for (Archetype* archetype : matching(query)) {
+            for (std::size_t c = 0; c < archetype->chunkCount(); ++c)
+                fn(ChunkView(archetype, &archetype->chunk(c)));
+        }
+        --iterationDepth_;
+    }
+
+    /// Appends every chunk matched by the query to `out`. Used to fan chunk
+    /// ranges out to worker threads.
+    void gatherChunks(Query& query, std::vector<ChunkView>& out);
+
+    /// Per-entity convenience iteration: fn(T&...) for every entity that has
+    /// all of Ts. Tags have no storage; fn gets a stand-in object for them.
+    /// Prefer forEachChunk in hot systems.
+    template <Component... Ts, typename Fn>
+    void each(Fn&& fn)
+    {
+        static thread_local Query query = Query().with<Ts...>();
+        forEachChunk(query, [&](const ChunkView& view) {
+            std::tuple<Ts*...> columns(view.get<Ts>()...);
+            const uint32_t n = view.size();
+            for (uint32_t i = 0; i < n; ++i)
+                fn(element<Ts>(std::get<Ts*>(columns), i)...);
+        });
+    }
+
+    /// Matching archetypes for a query, refreshing its cache if needed.
+    std::span<Archetype* const> matching(Query& query);
+
+    std::size_t archetypeCount() const { return archetypes_.size(); }
+
+private:
+    struct Record {
+        Archetype* archetype = nullptr;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    Archetype* archetypeFor(const ComponentMask& mask);
+    Entity allocateEntity(Archetype* archetype);
+    void reserveEntities(std::size_t count);
+    void moveEntity(Entity entity, ComponentId component, bool adding);
+    void removeRow(const Record& record);
+
+    template <Component T>
+    static T& element(T* column, uint32_t i)
+    {
+        if constexpr (std::is_empty_v<T>) {
+            static T tag{};
+            return tag;
+        } else {
+            return column[i];
+        }
+    }
+
+    template <Component T>
+    void writeComponent(Entity entity, const T& value)
+    {
+        if constexpr (!std::is_empty_v<T>) {
+            const Record& record = records_[entity.index];
+            const int column = record.archetype->column(componentId<T>());
+            std::memcpy(record.archetype->componentPtr(record.chunk, record.row, column), &value, sizeof(T));
+        }
+    }
+
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::unordered_map<ComponentMask, Archetype*> archetypeByMask_;
+    Archetype* emptyArchetype_ = nullptr;
+    std::vector<Record> records_;
+    std::vector<uint32_t> freeIndices_;
+    std::size_t liveCount_ = 0;
+    uint64_t id_;
+    std::atomic<int> iterationDepth_ = 0; // iterations in flight, over all threads
+};
+
+} // namespace rebel::ecs
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/platform.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace rebel::jobs {
+
+/// Fixed-capacity Chase-Lev work-stealing deque (Le et al., "Correct and
+/// Efficient Work-Stealing for Weak Memory Models", PPoPP 2013).
+///
+/// The owning thread pushes and pops at the bottom; any other thread may
+/// steal from the top. Capacity is fixed so there is no buffer reclamation
+/// problem: push() fails when full and the caller runs the work inline.
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "deque stores values with relaxed atomics");
+
+public:
+    explicit ChaseLevDeque(std::size_t capacity)
+        : mask_(int64_t(capacity) - 1)
+        , buffer_(std::make_unique<std::atomic<T>[]>(capacity))
+    {
+        REBEL_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    }
+
+    /// Owner only.
+    bool push(T item)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t > mask_)
+            return false;
+        buffer_[b & mask_].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Owner only. LIFO end, so recently pushed (cache-hot) work runs first.
+    bool pop(T& out)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = buffer_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last element: race against thieves for it.
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /// Any thread. FIFO end.
+    bool steal(T& out)
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+
+        T item = buffer_[t & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+        out = item;
+        return true;
+    }
+
+    /// Approximate; only meaningful as a hint.
+    std::size_t sizeHint() const
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? std::size_t(b - t) : 0;
+    }
+
+private:
+    alignas(kCacheLineSize) std::atomic<int64_t> top_{0};
+    alignas(kCacheLineSize) std::atomic<int64_t> bottom_{0};
+    int64_t mask_;
+    std::unique_ptr<std::atomic<T>[]> buffer_;
+};
+
+} // namespace rebel::jobs
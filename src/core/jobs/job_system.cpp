@@ -0,0 +1,215 @@
+#include "core/jobs/job_system.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define REBEL_CPU_RELAX() _mm_pause()
+#else
+#define REBEL_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace rebel::jobs {
+
+namespace {
+
+thread_local const JobSystem* tlsSystem = nullptr;
+thread_local int tlsWorkerIndex = -1;
+
+// Spins before a worker with nothing to do goes to sleep.
+constexpr int kIdleSpins = 256;
+
+} // namespace
+
+struct JobSystem::Worker {
+    Worker(uint32_t capacity, std::size_t scratchBytes)
+        : deque(capacity)
+        , ring(std::make_unique<Job[]>(capacity))
+        , ringMask(capacity - 1)
+        , scratch(scratchBytes, "worker scratch")
+    {
+    }
+
+    ChaseLevDeque<Job*> deque;
+    std::unique_ptr<Job[]> ring;
+    uint32_t ringMask;
+    uint32_t ringCursor = 0;
+    memory::LinearArena scratch;
+    uint32_t rng = 0;
+    uint32_t index = 0;
+};
+
+JobSystem::JobSystem(const JobSystemDesc& desc)
+{
+    REBEL_ASSERT(tlsSystem == nullptr, "thread already owns a JobSystem");
+
+    uint32_t count = desc.workerCount ? desc.workerCount : std::thread::hardware_concurrency();
+    count = std::max(count, 1u);
+
+    workers_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>(desc.queueCapacity, desc.scratchBytesPerWorker));
+        workers_.back()->index = i;
+        workers_.back()->rng = 0x9E3779B9u * (i + 1);
+    }
+
+    tlsSystem = this;
+    tlsWorkerIndex = 0;
+    memory::bindThreadScratch(&workers_[0]->scratch);
+
+    threads_.reserve(count - 1);
+    for (uint32_t i = 1; i < count; ++i)
+        threads_.emplace_back([this, i] { workerMain(i); });
+}
+
+JobSystem::~JobSystem()
+{
+    running_.store(false, std::memory_order_seq_cst);
+    wakeEpoch_.fetch_add(1, std::memory_order_seq_cst);
+    wakeEpoch_.notify_all();
+    for (std::thread& thread : threads_)
+        thread.join();
+
+    tlsSystem = nullptr;
+    tlsWorkerIndex = -1;
+    memory::bindThreadScratch(nullptr);
+}
+
+int JobSystem::workerIndex()
+{
+    return tlsWorkerIndex;
+}
+
+const memory::LinearArena& JobSystem::workerScratch(uint32_t worker) const
+{
+    return workers_[worker]->scratch;
+}
+
+JobSystem::Worker& JobSystem::currentWorker()
+{
+    REBEL_ASSERT(tlsSystem == this, "jobs must be submitted from a worker thread");
+    return *workers_[std::size_t(tlsWorkerIndex)];
+}
+
+Job* JobSystem::allocateJob()
+{
+    Worker& self = currentWorker();
+    Job* job = &self.ring[self.ringCursor & self.ringMask];
+    // The ring is large enough that the slot is almost always free; if the
+    // job that last used it is still in flight, make progress until it is.
+    while (job->busy.load(std::memory_order_acquire) != 0) {
+        if (!tryRunOne(self))
+            REBEL_CPU_RELAX();
+    }
+    ++self.ringCursor;
+    job->busy.store(1, std::memory_order_relaxed);
+    return job;
+}
+
+void JobSystem::submit(Job* job)
+{
+    Worker& self = currentWorker();
+    if (!self.deque.push(job)) {
+        execute(job);
+        return;
+    }
+
+    if (threads_.empty())
+        return;
+
+    // Pairs with the sleepers_ increment in workerMain(): either the sleeper
+    // sees the pushed job on its recheck, or we see it registered and wake it.
+    // A locked RMW is a full barrier and cheaper than mfence on x86.
+    if (sleepers_.fetch_add(0, std::memory_order_seq_cst) != 0) {
+        wakeEpoch_.fetch_add(1, std::memory_order_seq_cst);
+        wakeEpoch_.notify_one();
+    }
+}
+
+void JobSystem::execute(Job* job)
+{
+    job->invoke(*job);
+    JobCounter* counter = job->counter;
+    job->busy.store(0, std::memory_order_release);
+    counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+Job* JobSystem::findJob(Worker& self)
+{
+    Job* job = nullptr;
+    if (self.deque.pop(job))
+        return job;
+
+    const uint32_t count = uint32_t(workers_.size());
+    if (count == 1)
+        return nullptr;
+
+    // xorshift32 victim selection, then sweep the remaining workers.
+    self.rng ^= self.rng << 13;
+    self.rng ^= self.rng >> 17;
+    self.rng ^= self.rng << 5;
+    const uint32_t start = self.rng % count;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t victim = (start + i) % count;
+        if (victim != self.index && workers_[victim]->deque.steal(job))
+            return job;
+    }
+    return nullptr;
+}
+
+bool JobSystem::tryRunOne(Worker& self)
+{
+    Job* job = findJob(self);
+    if (!job)
+        return false;
+    execute(job);
+    return true;
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    Worker& self = currentWorker();
+    int idle = 0;
+    while (!counter.done()) {
+        if (tryRunOne(self)) {
+            idle = 0;
+        } else if (++idle < kIdleSpins) {
+            REBEL_CPU_RELAX();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerMain(uint32_t index)
+{
+    tlsSystem = this;
+    tlsWorkerIndex = int(index);
+    Worker& self = *workers_[index];
+    memory::bindThreadScratch(&self.scratch);
+
+    int idle = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (tryRunOne(self)) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < kIdleSpins) {
+            REBEL_CPU_RELAX();
+            continue;
+        }
+
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t epoch = wakeEpoch_.load(std::memory_order_seq_cst);
+        if (Job* job = findJob(self)) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            execute(job);
+            idle = 0;
+            continue;
+        }
+        if (running_.load(std::memory_order_seq_cst))
+            wakeEpoch_.wait(epoch, std::memory_order_seq_cst);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+} // namespace rebel::jobs
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/jobs/chase_lev_deque.h"
+#include "core/memory/linear_arena.h"
+#include "core/platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace rebel::jobs {
+
+/// Number of outstanding jobs in a group. wait() returns once it hits zero.
+class JobCounter {
+public:
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int32_t> pending_{0};
+};
+
+/// A unit of work. The callable is stored inline so submitting a job never
+/// touches the heap; jobs themselves come from a per-worker ring.
+struct alignas(kCacheLineSize) Job {
+    static constexpr std::size_t kPayloadSize = 40;
+
+    void (*invoke)(Job&) = nullptr;
+    JobCounter* counter = nullptr;
+    std::atomic<uint32_t> busy{0};
+    alignas(8) unsigned char payload[kPayloadSize];
+};
+static_assert(sizeof(Job) == kCacheLineSize);
+
+struct JobSystemDesc {
+    /// Total workers including the thread that creates the JobSystem, which
+    /// becomes worker 0. Zero selects std::thread::hardware_concurrency().
+    uint32_t workerCount = 0;
+    /// Per-worker deque and job ring capacity (power of two).
+    uint32_t queueCapacity = 1u << 16;
+    /// Size of each worker's thread-local scratch arena (memory::threadScratch()).
+    std::size_t scratchBytesPerWorker = std::size_t(1) << 20;
+};
+
+/// Work-stealing scheduler with one Chase-Lev deque per worker. Workers pop
+/// their own deque LIFO and steal FIFO from a random victim when empty.
+///
+/// Jobs may only be submitted from worker threads (including the owning
+/// thread, worker 0). Waiting is cooperative: wait() executes other jobs
+/// until the counter drains, so jobs may freely wait on nested work.
+class JobSystem {
+public:
+    explicit JobSystem(const JobSystemDesc& desc = {});
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    uint32_t workerCount() const { return uint32_t(workers_.size()); }
+
+    /// Scratch arena owned by a worker, for high-water reporting.
+    const memory::LinearArena& workerScratch(uint32_t worker) const;
+
+    /// Index of the calling worker in [0, workerCount), or -1 for threads
+    /// that do not belong to any JobSystem.
+    static int workerIndex();
+
+    /// Schedules fn() and increments `counter` until it completes. `fn` must
+    /// be trivially copyable and fit in Job::kPayloadSize bytes; capture by
+    /// reference or pointer for larger state.
+    template <typename Fn>
+    void run(JobCounter& counter, Fn&& fn)
+    {
+        using F = std::decay_t<Fn>;
+        static_assert(sizeof(F) <= Job::kPayloadSize, "job callable too large; capture by reference");
+        static_assert(alignof(F) <= 8, "job callable over-aligned");
+        static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>,
+                      "job callables must be trivially copyable");
+
+        Job* job = allocateJob();
+        ::new (static_cast<void*>(job->payload)) F(std::forward<Fn>(fn));
+        job->invoke = [](Job& self) { (*std::launder(reinterpret_cast<F*>(self.payload)))(); };
+        job->counter = &counter;
+        counter.pending_.fetch_add(1, std::memory_order_relaxed);
+        submit(job);
+    }
+
+    /// Splits [0, count) into ranges of at most `grain` items and calls
+    /// fn(begin, end) for each range in parallel. Blocks until done.
+    template <typename Fn>
+    void parallelFor(uint32_t count, uint32_t grain, const Fn& fn)
+    {
+        if (count == 0)
+            return;
+        grain = std::max(grain, 1u);
+        if (count <= grain || workers_.size() == 1) {
+            fn(0u, count);
+            return;
+        }
+
+        JobCounter counter;
+        const Fn* body = &fn;
+        for (uint32_t begin = grain; begin < count; begin += grain) {
+            const uint32_t end = std::min(begin + grain, count);
+            run(counter, [body, begin, end] { (*body)(begin, end); });
+        }
+        fn(0u, grain);
+        wait(counter);
+    }
+
+    /// Runs queued jobs on the calling thread until `counter` reaches zero.
+    void wait(const JobCounter& counter);
+
+private:
+    struct Worker;
+
+    Job* allocateJob();
+    void submit(Job* job);
+    bool tryRunOne(Worker& self);
+    Job* findJob(Worker& self);
+    void execute(Job* job);
+    void workerMain(uint32_t index);
+    Worker& currentWorker();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_{true};
+    alignas(kCacheLineSize) std::atomic<uint32_t> wakeEpoch_{0};
+    alignas(kCacheLineSize) std::atomic<uint32_t> sleepers_{0};
+};
+
+} // namespace rebel::jobs
@@ -0,0 +1,106 @@
+#include "core/jobs/task_graph.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+
+namespace rebel::jobs {
+
+uint32_t TaskGraph::add(std::string name, const SystemAccess& access, SystemFn fn)
+{
+    Node node;
+    node.name = std::move(name);
+    node.access = access;
+    node.fn = std::move(fn);
+    nodes_.push_back(std::move(node));
+    compiled_ = false;
+    return uint32_t(nodes_.size() - 1);
+}
+
+void TaskGraph::addDependency(uint32_t before, uint32_t after)
+{
+    REBEL_ASSERT(before < after && after < nodes_.size(), "dependencies must follow insertion order");
+    nodes_[after].explicitAfter.push_back(before);
+    compiled_ = false;
+}
+
+void TaskGraph::compile()
+{
+    const std::size_t n = nodes_.size();
+    for (Node& node : nodes_) {
+        node.successors.clear();
+        node.indegree = 0;
+    }
+
+    // ancestors[j][i] is true when system i must finish before system j.
+    // Candidates are visited from the nearest predecessor backwards, so any
+    // candidate already implied by an accepted edge is dropped (transitive
+    // reduction) and each system only waits on its direct predecessors.
+    std::vector<std::vector<bool>> ancestors(n, std::vector<bool>(n, false));
+    levels_.assign(n, 0);
+    for (std::size_t j = 0; j < n; ++j) {
+        Node& node = nodes_[j];
+        for (std::size_t k = j; k-- > 0;) {
+            const bool explicitEdge = std::find(node.explicitAfter.begin(), node.explicitAfter.end(), uint32_t(k)) !=
+                                      node.explicitAfter.end();
+            if (!explicitEdge && !nodes_[k].access.conflictsWith(node.access))
+                continue;
+            if (ancestors[j][k])
+                continue;
+
+            nodes_[k].successors.push_back(uint32_t(j));
+            ++node.indegree;
+            levels_[j] = std::max(levels_[j], levels_[k] + 1);
+            ancestors[j][k] = true;
+            for (std::size_t a = 0; a < k; ++a) {
+                if (ancestors[k][a])
+                    ancestors[j][a] = true;
+            }
+        }
+    }
+
+    roots_.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (nodes_[i].indegree == 0)
+            roots_.push_back(uint32_t(i));
+    }
+    remaining_ = std::make_unique<std::atomic<uint32_t>[]>(n);
+    compiled_ = true;
+}
+
+std::vector<uint32_t> TaskGraph::predecessors(uint32_t system) const
+{
+    std::vector<uint32_t> result;
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+        const auto& successors = nodes_[i].successors;
+        if (std::find(successors.begin(), successors.end(), system) != successors.end())
+            result.push_back(i);
+    }
+    return result;
+}
+
+void TaskGraph::run(JobSystem& jobs)
+{
+    REBEL_ASSERT(compiled_, "TaskGraph::run() before compile()");
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+        remaining_[i].store(nodes_[i].indegree, std::memory_order_relaxed);
+
+    JobCounter counter;
+    for (const uint32_t root : roots_)
+        jobs.run(counter, [this, &jobs, &counter, root] { runNode(jobs, counter, root); });
+    jobs.wait(counter);
+}
+
+void TaskGraph::runNode(JobSystem& jobs, JobCounter& counter, uint32_t index)
+{
+    Node& node = nodes_[index];
+    if (node.fn)
+        node.fn();
+    for (const uint32_t next : node.successors) {
+        if (remaining_[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            jobs.run(counter, [this, &jobs, &counter, next] { runNode(jobs, counter, next); });
+    }
+}
+
+} // namespace rebel::jobs
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/ecs/component.h"
+#include "core/jobs/job_system.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rebel::jobs {
+
+/// Declares which components a system reads and writes. The task graph uses
+/// this to decide which systems may run concurrently.
+struct SystemAccess {
+    ecs::ComponentMask reads;
+    ecs::ComponentMask writes;
+
+    template <ecs::Component... Ts>
+    SystemAccess& read()
+    {
+        (reads.set(ecs::componentId<Ts>()), ...);
+        return *this;
+    }
+
+    template <ecs::Component... Ts>
+    SystemAccess& write()
+    {
+        (writes.set(ecs::componentId<Ts>()), ...);
+        return *this;
+    }
+
+    /// Two systems conflict when either writes something the other touches.
+    bool conflictsWith(const SystemAccess& other) const
+    {
+        return (writes & (other.reads | other.writes)).any() || (reads & other.writes).any();
+    }
+};
+
+/// Per-frame graph of systems. Systems are added in their logical order;
+/// compile() orders each pair of conflicting systems the way they were added
+/// and leaves independent systems unordered so they run in parallel.
+///
+/// Build the graph once, compile() it, then run() it every frame.
+class TaskGraph {
+public:
+    using SystemFn = std::function<void()>;
+
+    uint32_t add(std::string name, const SystemAccess& access, SystemFn fn);
+
+    /// Adds an ordering edge that component access alone does not express.
+    void addDependency(uint32_t before, uint32_t after);
+
+    void compile();
+    void run(JobSystem& jobs);
+
+    std::size_t systemCount() const { return nodes_.size(); }
+    const std::string& name(uint32_t system) const { return nodes_[system].name; }
+
+    /// Length of the longest dependency chain ending at each system; systems
+    /// sharing a level have no ordering between them.
+    const std::vector<uint32_t>& levels() const { return levels_; }
+
+    /// Direct predecessors after transitive reduction.
+    std::vector<uint32_t> predecessors(uint32_t system) const;
+
+private:
+    struct Node {
+        std::string name;
+        SystemAccess access;
+        SystemFn fn;
+        std::vector<uint32_t> successors;
+        std::vector<uint32_t> explicitAfter;
+        uint32_t indegree = 0;
+    };
+
+    void runNode(JobSystem& jobs, JobCounter& counter, uint32_t index);
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> roots_;
+    std::vector<uint32_t> levels_;
+    std::unique_ptr<std::atomic<uint32_t>[]> remaining_;
+    bool compiled_ = false;
+};
+
+} // namespace rebel::jobs
@@ -0,0 +1,103 @@
+#include "core/mapped_file.h"
+
+#include <cstdio>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define REBEL_HAS_MMAP 1
+#else
+#define REBEL_HAS_MMAP 0
+#endif
+
+namespace rebel {
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, false))
+    , buffer_(std::move(other.buffer_))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const char* path)
+{
+    close();
+#if REBEL_HAS_MMAP
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* data = ::mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = std::size_t(info.st_size);
+    mapped_ = true;
+    return true;
+#else
+    FILE* file = std::fopen(path, "rb");
+    if (!file)
+        return false;
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size > 0) {
+        buffer_.resize(std::size_t(size));
+        if (std::fread(buffer_.data(), 1, buffer_.size(), file) != buffer_.size())
+            buffer_.clear();
+    }
+    std::fclose(file);
+    if (buffer_.empty())
+        return false;
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+#endif
+}
+
+void MappedFile::close()
+{
+#if REBEL_HAS_MMAP
+    if (mapped_)
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_ = {};
+}
+
+bool writeFile(const char* path, std::span<const uint8_t> bytes)
+{
+    FILE* file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+} // namespace rebel
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel {
+
+/// Read-only view of a whole file. On POSIX systems the file is
+/// memory-mapped, so pages load on first touch and stay shared with every
+/// other process mapping it; elsewhere it is read into memory. Either way
+/// the bytes are at least 16-byte aligned, which cooked formats rely on.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Replaces any open file. Returns false (leaving the view empty) when
+    /// the file cannot be opened or is empty.
+    bool open(const char* path);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    std::span<const uint8_t> bytes() const { return {data_, size_}; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> buffer_; // fallback copy where mapping is unavailable
+};
+
+/// Writes `bytes` to `path`, replacing the file. Returns false on failure.
+bool writeFile(const char* path, std::span<const uint8_t> bytes);
+
+} // namespace rebel
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/math/quat.h"
+#include "core/math/vec.h"
+
+#include <cmath>
+
+namespace rebel::math {
+
+/// Column-major 3x3 matrix.
+struct Mat3 {
+    Vec3 cols[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+
+    static constexpr Mat3 identity() { return {}; }
+
+    static constexpr Mat3 fromColumns(Vec3 c0, Vec3 c1, Vec3 c2)
+    {
+        Mat3 m;
+        m.cols[0] = c0;
+        m.cols[1] = c1;
+        m.cols[2] = c2;
+        return m;
+    }
+
+    static constexpr Mat3 diagonal(Vec3 d)
+    {
+        return fromColumns({d.x, 0.0f, 0.0f}, {0.0f, d.y, 0.0f}, {0.0f, 0.0f, d.z});
+    }
+
+    static constexpr Mat3 fromQuat(Quat q)
+    {
+        const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        return fromColumns({1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy)},
+                           {2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx)},
+                           {2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy)});
+    }
+
+    constexpr Vec3 row(int r) const { return {cols[0][r], cols[1][r], cols[2][r]}; }
+
+    constexpr Vec3 operator*(Vec3 v) const { return cols[0] * v.x + cols[1] * v.y + cols[2] * v.z; }
+
+    constexpr Mat3 operator*(const Mat3& o) const { return fromColumns(*this * o.cols[0], *this * o.cols[1], *this * o.cols[2]); }
+
+    constexpr Mat3 operator+(const Mat3& o) const
+    {
+        return fromColumns(cols[0] + o.cols[0], cols[1] + o.cols[1], cols[2] + o.cols[2]);
+    }
+};
+
+constexpr Mat3 transpose(const Mat3& m) { return Mat3::fromColumns(m.row(0), m.row(1), m.row(2)); }
+
+inline Mat3 inverse(const Mat3& m)
+{
+    const Vec3 r0 = cross(m.cols[1], m.cols[2]);
+    const Vec3 r1 = cross(m.cols[2], m.cols[0]);
+    const Vec3 r2 = cross(m.cols[0], m.cols[1]);
+    const float det = dot(m.cols[0], r0);
+    const float invDet = det != 0.0f ? 1.0f / det : 0.0f;
+    return transpose(Mat3::fromColumns(r0 * invDet, r1 * invDet, r2 * invDet));
+}
+
+/// Column-major 4x4 matrix; vectors are columns (p' = M * p).
+struct Mat4 {
+    Vec4 cols[4] = {{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}};
+
+    static constexpr Mat4 identity() { return {}; }
+
+    static constexpr Mat4 translation(Vec3 t)
+    {
+        Mat4 m;
+        m.cols[3] = {t, 1.0f};
+        return m;
+    }
+
+    static constexpr Mat4 scale(Vec3 s)
+    {
+        Mat4 m;
+        m.cols[0].x = s.x;
+        m.cols[1].y = s.y;
+        m.cols[2].z = s.z;
+        return m;
+    }
+
+    /// Translation * rotation * scale.
+    static constexpr Mat4 trs(Vec3 t, Quat r, Vec3 s)
+    {
+        const Mat3 rot = Mat3::fromQuat(r);
+        Mat4 m;
+        m.cols[0] = {rot.cols[0] * s.x, 0.0f};
+        m.cols[1] = {rot.cols[1] * s.y, 0.0f};
+        m.cols[2] = {rot.cols[2] * s.z, 0.0f};
+        m.cols[3] = {t, 1.0f};
+        return m;
+    }
+
+    /// Right-handed view looking down -Z.
+    static Mat4 lookAt(Vec3 eye, Vec3 target, Vec3 up)
+    {
+        const Vec3 f = normalize(target - eye, {0.0f, 0.0f, -1.0f});
+        const Vec3 s = normalize(cross(f, up), {1.0f, 0.0f, 0.0f});
+        const Vec3 u = cross(s, f);
+        Mat4 m;
+        m.cols[0] = {s.x, u.x, -f.x, 0.0f};
+        m.cols[1] = {s.y, u.y, -f.y, 0.0f};
+        m.cols[2] = {s.z, u.z, -f.z, 0.0f};
+        m.cols[3] = {-dot(s, eye), -dot(u, eye), dot(f, eye), 1.0f};
+        return m;
+    }
+
+    /// Right-handed perspective projection mapping view-space depth
+    /// [-zNear, -zFar] to clip z/w in [0, 1].
+    static Mat4 perspective(float fovYRadians, float aspect, float zNear, float zFar)
+    {
+        const float f = 1.0f / std::tan(fovYRadians * 0.5f);
+        Mat4 m;
+        m.cols[0] = {f / aspect, 0.0f, 0.0f, 0.0f};
+        m.cols[1] = {0.0f, f, 0.0f, 0.0f};
+        m.cols[2] = {0.0f, 0.0f, zFar / (zNear - zFar), -1.0f};
+        m.cols[3] = {0.0f, 0.0f, zNear * zFar / (zNear - zFar), 0.0f};
+        return m;
+    }
+
+    constexpr Vec4 row(int r) const { return {cols[0][r], cols[1][r], cols[2][r], cols[3][r]}; }
+
+    constexpr Vec4 operator*(Vec4 v) const { return cols[0] * v.x + cols[1] * v.y + cols[2] * v.z + cols[3] * v.w; }
+
+    constexpr Mat4 operator*(const Mat4& o) const
+    {
+        Mat4 m;
+        for (int i = 0; i < 4; ++i)
+            m.cols[i] = *this * o.cols[i];
+        return m;
+    }
+
+    constexpr Vec3 transformPoint(Vec3 p) const { return (cols[0] * p.x + cols[1] * p.y + cols[2] * p.z + cols[3]).xyz(); }
+    constexpr Vec3 transformVector(Vec3 v) const { return (cols[0] * v.x + cols[1] * v.y + cols[2] * v.z).xyz(); }
+
+    constexpr Mat3 upper3x3() const { return Mat3::fromColumns(cols[0].xyz(), cols[1].xyz(), cols[2].xyz()); }
+};
+
+/// Inverse of a rigid (rotation + translation) transform.
+inline Mat4 inverseRigid(const Mat4& m)
+{
+    const Mat3 rt = transpose(m.upper3x3());
+    const Vec3 t = -(rt * m.cols[3].xyz());
+    Mat4 r;
+    r.cols[0] = {rt.cols[0], 0.0f};
+    r.cols[1] = {rt.cols[1], 0.0f};
+    r.cols[2] = {rt.cols[2], 0.0f};
+    r.cols[3] = {t, 1.0f};
+    return r;
+}
+
+} // namespace rebel::math
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "core/math/vec.h"
+
+#include <cmath>
+
+namespace rebel::math {
+
+/// Unit quaternion (x, y, z vector part; w scalar part).
+struct Quat {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f;
+
+    constexpr Quat() = default;
+    constexpr Quat(float x_, float y_, float z_, float w_)
+        : x(x_)
+        , y(y_)
+        , z(z_)
+        , w(w_)
+    {
+    }
+
+    static Quat fromAxisAngle(Vec3 axis, float radians)
+    {
+        const Vec3 n = normalize(axis, {0.0f, 1.0f, 0.0f});
+        const float s = std::sin(radians * 0.5f);
+        return {n.x * s, n.y * s, n.z * s, std::cos(radians * 0.5f)};
+    }
+
+    static constexpr Quat identity() { return {}; }
+
+    constexpr Vec3 vec() const { return {x, y, z}; }
+
+    constexpr Quat operator*(Quat o) const
+    {
+        return {w * o.x + x * o.w + y * o.z - z * o.y, w * o.y - x * o.z + y * o.w + z * o.x,
+                w * o.z + x * o.y - y * o.x + z * o.w, w * o.w - x * o.x - y * o.y - z * o.z};
+    }
+    constexpr Quat operator*(float s) const { return {x * s, y * s, z * s, w * s}; }
+    constexpr Quat operator+(Quat o) const { return {x + o.x, y + o.y, z + o.z, w + o.w}; }
+    constexpr Quat operator-() const { return {-x, -y, -z, -w}; }
+};
+
+constexpr float dot(Quat a, Quat b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+constexpr Quat conjugate(Quat q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+inline Quat normalize(Quat q)
+{
+    const float len2 = dot(q, q);
+    return len2 > 1e-30f ? q * (1.0f / std::sqrt(len2)) : Quat{};
+}
+
+/// Rotates v by unit quaternion q.
+constexpr Vec3 rotate(Quat q, Vec3 v)
+{
+    const Vec3 u = q.vec();
+    const Vec3 t = cross(u, v) * 2.0f;
+    return v + t * q.w + cross(u, t);
+}
+
+/// Normalised lerp along the shortest arc.
+inline Quat nlerp(Quat a, Quat b, float t)
+{
+    if (dot(a, b) < 0.0f)
+        b = -b;
+    return normalize(a * (1.0f - t) + b * t);
+}
+
+inline Quat slerp(Quat a, Quat b, float t)
+{
+    float cosTheta = dot(a, b);
+    if (cosTheta < 0.0f) {
+        b = -b;
+        cosTheta = -cosTheta;
+    }
+    if (cosTheta > 0.9995f)
+        return nlerp(a, b, t);
+    const float theta = std::acos(cosTheta);
+    const float sinTheta = std::sin(theta);
+    return a * (std::sin((1.0f - t) * theta) / sinTheta) + b * (std::sin(t * theta) / sinTheta);
+}
+
+/// Integrates angular velocity over dt (first order) and renormalises.
+inline Quat integrate(Quat q, Vec3 angularVelocity, float dt)
+{
+    const Quat spin{angularVelocity.x, angularVelocity.y, angularVelocity.z, 0.0f};
+    return normalize(q + (spin * q) * (0.5f * dt));
+}
+
+} // namespace rebel::math
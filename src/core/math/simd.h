@@ -0,0 +1,127 @@
+#pragma once
+
+#include "core/platform.h"
+
+#include <cstdint>
+#include <emmintrin.h>
+
+namespace rebel::math {
+
+/// Thin SSE2 wrapper for four-lane float math. Engine code builds for the
+/// x86-64 baseline; wider kernels (AVX2/AVX-512) live in target-attributed
+/// functions selected at runtime.
+struct Float4 {
+    __m128 v;
+
+    Float4() = default;
+    REBEL_FORCEINLINE Float4(__m128 m)
+        : v(m)
+    {
+    }
+    REBEL_FORCEINLINE explicit Float4(float s)
+        : v(_mm_set1_ps(s))
+    {
+    }
+    REBEL_FORCEINLINE Float4(float a, float b, float c, float d)
+        : v(_mm_setr_ps(a, b, c, d))
+    {
+    }
+
+    static REBEL_FORCEINLINE Float4 zero() { return _mm_setzero_ps(); }
+    static REBEL_FORCEINLINE Float4 load(const float* p) { return _mm_loadu_ps(p); }
+    static REBEL_FORCEINLINE Float4 loadAligned(const float* p) { return _mm_load_ps(p); }
+    REBEL_FORCEINLINE void store(float* p) const { _mm_storeu_ps(p, v); }
+    REBEL_FORCEINLINE void storeAligned(float* p) const { _mm_store_ps(p, v); }
+
+    REBEL_FORCEINLINE float lane(int i) const
+    {
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, v);
+        return tmp[i];
+    }
+
+    REBEL_FORCEINLINE operator __m128() const { return v; }
+};
+
+REBEL_FORCEINLINE Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+REBEL_FORCEINLINE Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+REBEL_FORCEINLINE Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+REBEL_FORCEINLINE Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+REBEL_FORCEINLINE Float4 operator-(Float4 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+REBEL_FORCEINLINE Float4& operator+=(Float4& a, Float4 b) { return a = a + b; }
+REBEL_FORCEINLINE Float4& operator-=(Float4& a, Float4 b) { return a = a - b; }
+REBEL_FORCEINLINE Float4& operator*=(Float4& a, Float4 b) { return a = a * b; }
+
+REBEL_FORCEINLINE Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+REBEL_FORCEINLINE Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+REBEL_FORCEINLINE Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+REBEL_FORCEINLINE Float4 abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+REBEL_FORCEINLINE Float4 clamp(Float4 v, Float4 lo, Float4 hi) { return min(max(v, lo), hi); }
+
+/// a * b + c. Deliberately not fused so results match the scalar path.
+REBEL_FORCEINLINE Float4 madd(Float4 a, Float4 b, Float4 c) { return a * b + c; }
+
+/// Lane masks: all-ones where the comparison holds.
+REBEL_FORCEINLINE Float4 cmpLt(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+REBEL_FORCEINLINE Float4 cmpLe(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+REBEL_FORCEINLINE Float4 cmpGt(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+REBEL_FORCEINLINE Float4 cmpGe(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+REBEL_FORCEINLINE Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+REBEL_FORCEINLINE Float4 operator|(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+
+/// mask ? a : b, per lane.
+REBEL_FORCEINLINE Float4 select(Float4 mask, Float4 a, Float4 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// Bit i set when lane i's sign bit (i.e. mask lane) is set.
+REBEL_FORCEINLINE int moveMask(Float4 mask) { return _mm_movemask_ps(mask); }
+
+/// Reciprocal with one Newton-Raphson step (~22 bits).
+REBEL_FORCEINLINE Float4 reciprocal(Float4 a)
+{
+    const Float4 r = _mm_rcp_ps(a);
+    return r * (Float4(2.0f) - a * r);
+}
+
+/// 1/sqrt with one Newton-Raphson step.
+REBEL_FORCEINLINE Float4 rsqrt(Float4 a)
+{
+    const Float4 r = _mm_rsqrt_ps(a);
+    return Float4(0.5f) * r * (Float4(3.0f) - a * r * r);
+}
+
+REBEL_FORCEINLINE float horizontalMax(Float4 a)
+{
+    __m128 m = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(m);
+}
+
+REBEL_FORCEINLINE float horizontalMin(Float4 a)
+{
+    __m128 m = _mm_min_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(m);
+}
+
+REBEL_FORCEINLINE float horizontalSum(Float4 a)
+{
+    __m128 s = _mm_add_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+    s = _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(s);
+}
+
+/// In-place 4x4 transpose of four row registers.
+REBEL_FORCEINLINE void transpose4(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+{
+    __m128 a = r0, b = r1, c = r2, d = r3;
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    r0 = a;
+    r1 = b;
+    r2 = c;
+    r3 = d;
+}
+
+} // namespace rebel::math
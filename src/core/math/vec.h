@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace rebel::math {
+
+struct Vec2 {
+    float x = 0.0f, y = 0.0f;
+
+    constexpr Vec2() = default;
+    constexpr Vec2(float x_, float y_)
+        : x(x_)
+        , y(y_)
+    {
+    }
+
+    constexpr Vec2 operator+(Vec2 o) const { return {x + o.x, y + o.y}; }
+    constexpr Vec2 operator-(Vec2 o) const { return {x - o.x, y - o.y}; }
+    constexpr Vec2 operator*(float s) const { return {x * s, y * s}; }
+    constexpr Vec2& operator+=(Vec2 o) { return *this = *this + o; }
+    constexpr Vec2& operator-=(Vec2 o) { return *this = *this - o; }
+};
+
+struct Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+
+    constexpr Vec3() = default;
+    constexpr Vec3(float x_, float y_, float z_)
+        : x(x_)
+        , y(y_)
+        , z(z_)
+    {
+    }
+    explicit constexpr Vec3(float s)
+        : x(s)
+        , y(s)
+        , z(s)
+    {
+    }
+
+    constexpr float operator[](int i) const { return i == 0 ? x : (i == 1 ? y : z); }
+    constexpr float& operator[](int i) { return i == 0 ? x : (i == 1 ? y : z); }
+
+    constexpr Vec3 operator-() const { return {-x, -y, -z}; }
+    constexpr Vec3 operator+(Vec3 o) const { return {x + o.x, y + o.y, z + o.z}; }
+    constexpr Vec3 operator-(Vec3 o) const { return {x - o.x, y - o.y, z - o.z}; }
+    constexpr Vec3 operator*(Vec3 o) const { return {x * o.x, y * o.y, z * o.z}; }
+    constexpr Vec3 operator*(float s) const { return {x * s, y * s, z * s}; }
+    constexpr Vec3 operator/(float s) const { return {x / s, y / s, z / s}; }
+    constexpr Vec3& operator+=(Vec3 o) { return *this = *this + o; }
+    constexpr Vec3& operator-=(Vec3 o) { return *this = *this - o; }
+    constexpr Vec3& operator*=(float s) { return *this = *this * s; }
+
+    friend constexpr Vec3 operator*(float s, Vec3 v) { return v * s; }
+    friend constexpr bool operator==(Vec3 a, Vec3 b) = default;
+};
+
+struct Vec4 {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+
+    constexpr Vec4() = default;
+    constexpr Vec4(float x_, float y_, float z_, float w_)
+        : x(x_)
+        , y(y_)
+        , z(z_)
+        , w(w_)
+    {
+    }
+    constexpr Vec4(Vec3 v, float w_)
+        : x(v.x)
+        , y(v.y)
+        , z(v.z)
+        , w(w_)
+    {
+    }
+
+    constexpr Vec3 xyz() const { return {x, y, z}; }
+    constexpr float operator[](int i) const { return i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w)); }
+
+    constexpr Vec4 operator+(Vec4 o) const { return {x + o.x, y + o.y, z + o.z, w + o.w}; }
+    constexpr Vec4 operator-(Vec4 o) const { return {x - o.x, y - o.y, z - o.z, w - o.w}; }
+    constexpr Vec4 operator*(float s) const { return {x * s, y * s, z * s, w * s}; }
+};
+
+constexpr float dot(Vec2 a, Vec2 b) { return a.x * b.x + a.y * b.y; }
+constexpr float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+constexpr float dot(Vec4 a, Vec4 b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+constexpr Vec3 cross(Vec3 a, Vec3 b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline float length(Vec3 v) { return std::sqrt(dot(v, v)); }
+constexpr float lengthSquared(Vec3 v) { return dot(v, v); }
+
+/// Returns `fallback` for (near) zero-length input instead of NaNs.
+inline Vec3 normalize(Vec3 v, Vec3 fallback = {0.0f, 0.0f, 0.0f})
+{
+    const float len2 = dot(v, v);
+    return len2 > 1e-30f ? v * (1.0f / std::sqrt(len2)) : fallback;
+}
+
+inline Vec3 min(Vec3 a, Vec3 b) { return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)}; }
+inline Vec3 max(Vec3 a, Vec3 b) { return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)}; }
+inline Vec3 abs(Vec3 v) { return {std::fabs(v.x), std::fabs(v.y), std::fabs(v.z)}; }
+constexpr Vec3 lerp(Vec3 a, Vec3 b, float t) { return a + (b - a) * t; }
+
+template <typename T>
+constexpr T clamp(T v, T lo, T hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+inline constexpr float kPi = 3.14159265358979323846f;
+
+} // namespace rebel::math
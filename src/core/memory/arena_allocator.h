@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/memory/frame_allocator.h"
+#include "core/memory/linear_arena.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace rebel::memory {
+
+/// STL allocator adapter over any arena exposing allocate(size, alignment).
+/// deallocate() is a no-op: memory comes back when the arena is rewound or
+/// reset, so containers using it must not outlive that point.
+template <typename T, typename Arena = LinearArena>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Arena>& other) noexcept
+        : arena_(other.arena())
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        void* memory = arena_->allocate(sizeof(T) * count, alignof(T));
+        if (!memory)
+            throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    Arena* arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U, Arena>& other) const
+    {
+        return arena_ == other.arena();
+    }
+
+private:
+    Arena* arena_;
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T, LinearArena>>;
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T, FrameAllocator>>;
+
+} // namespace rebel::memory
@@ -0,0 +1,106 @@
+#include "core/memory/frame_allocator.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace rebel::memory {
+
+FrameAllocator::FrameAllocator(std::size_t bytesPerFrame)
+    : capacity_(bytesPerFrame)
+{
+    for (unsigned char*& buffer : buffers_) {
+        buffer = static_cast<unsigned char*>(::operator new(capacity_, std::align_val_t(kCacheLineSize)));
+#if defined(REBEL_MEMORY_DEBUG)
+        std::memset(buffer, kPoisonByte, capacity_);
+#endif
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (unsigned char* buffer : buffers_)
+        ::operator delete(buffer, std::align_val_t(kCacheLineSize));
+}
+
+void* FrameAllocator::allocate(std::size_t size, std::size_t alignment, MemoryTag tag)
+{
+    unsigned char* base = buffers_[current_];
+    const uintptr_t baseAddress = reinterpret_cast<uintptr_t>(base);
+
+    std::size_t offset = offset_.load(std::memory_order_relaxed);
+    std::size_t start;
+    do {
+        start = alignUp(baseAddress + offset, alignment) - baseAddress;
+        if (start + size > capacity_) {
+            REBEL_ASSERT(false, "frame allocator exhausted");
+            return nullptr;
+        }
+    } while (!offset_.compare_exchange_weak(offset, start + size, std::memory_order_relaxed));
+
+#if defined(REBEL_MEMORY_DEBUG)
+    tagBytes_[std::size_t(tag)].fetch_add(size, std::memory_order_relaxed);
+#else
+    (void)tag;
+#endif
+    return base + start;
+}
+
+void FrameAllocator::endFrame()
+{
+    lastFrameBytes_ = offset_.load(std::memory_order_relaxed);
+    highWater_ = std::max(highWater_, lastFrameBytes_);
+
+#if defined(REBEL_MEMORY_DEBUG)
+    for (std::size_t i = 0; i < kMemoryTagCount; ++i) {
+        lastFrameByTag_[i] = tagBytes_[i].exchange(0, std::memory_order_relaxed);
+        highWaterByTag_[i] = std::max(highWaterByTag_[i], lastFrameByTag_[i]);
+    }
+#endif
+
+    // The buffer becoming current was last used two frames ago; everything
+    // in it is now dead.
+    current_ ^= 1u;
+    ++frame_;
+#if defined(REBEL_MEMORY_DEBUG)
+    std::memset(buffers_[current_], kPoisonByte, capacity_);
+#endif
+    offset_.store(0, std::memory_order_relaxed);
+}
+
+FrameAllocatorStats FrameAllocator::stats() const
+{
+    FrameAllocatorStats stats;
+    stats.frame = frame_;
+    stats.capacityPerFrame = capacity_;
+    stats.lastFrameBytes = lastFrameBytes_;
+    stats.highWaterBytes = highWater_;
+#if defined(REBEL_MEMORY_DEBUG)
+    stats.lastFrameByTag = lastFrameByTag_;
+    stats.highWaterByTag = highWaterByTag_;
+#endif
+    return stats;
+}
+
+std::string formatStats(const FrameAllocatorStats& stats)
+{
+    std::string out;
+    char line[160];
+    std::snprintf(line, sizeof(line), "frame %" PRIu64 ": last %zu B, high-water %zu B of %zu B\n", stats.frame,
+                  stats.lastFrameBytes, stats.highWaterBytes, stats.capacityPerFrame);
+    out += line;
+    for (std::size_t i = 0; i < kMemoryTagCount; ++i) {
+        if (stats.highWaterByTag[i] == 0)
+            continue;
+        std::snprintf(line, sizeof(line), "  %-10s last %zu B, high-water %zu B\n", memoryTagName(MemoryTag(i)),
+                      stats.lastFrameByTag[i], stats.highWaterByTag[i]);
+        out += line;
+    }
+    return out;
+}
+
+} // namespace rebel::memory
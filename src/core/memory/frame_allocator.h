@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/memory/linear_arena.h"
+#include "core/memory/memory_tag.h"
+#include "core/platform.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace rebel::memory {
+
+struct FrameAllocatorStats {
+    uint64_t frame = 0;
+    std::size_t capacityPerFrame = 0;
+    std::size_t lastFrameBytes = 0;
+    std::size_t highWaterBytes = 0;
+    /// Per-subsystem totals; only populated when REBEL_MEMORY_DEBUG is set.
+    std::array<std::size_t, kMemoryTagCount> lastFrameByTag{};
+    std::array<std::size_t, kMemoryTagCount> highWaterByTag{};
+};
+
+/// Double-buffered, thread-safe bump allocator for memory that lives for one
+/// frame. Allocation is a single atomic add. endFrame() flips buffers and
+/// resets the new current one, so memory from frame N stays valid through
+/// frame N+1 (e.g. for a render thread consuming the previous frame).
+///
+/// With REBEL_MEMORY_DEBUG the released buffer is poisoned and usage is
+/// attributed per MemoryTag so subsystem budgets can be sized from the
+/// reported high-water marks.
+class FrameAllocator {
+public:
+    explicit FrameAllocator(std::size_t bytesPerFrame);
+    ~FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t),
+                   MemoryTag tag = MemoryTag::General);
+
+    template <typename T>
+    T* allocateArray(std::size_t count, MemoryTag tag = MemoryTag::General)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "frame memory is never destructed");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T), tag));
+    }
+
+    /// Must be called from one thread with no concurrent allocate() calls.
+    void endFrame();
+
+    std::size_t used() const { return offset_.load(std::memory_order_relaxed); }
+    std::size_t capacity() const { return capacity_; }
+    FrameAllocatorStats stats() const;
+
+private:
+    unsigned char* buffers_[2] = {nullptr, nullptr};
+    std::size_t capacity_ = 0;
+    uint32_t current_ = 0;
+    uint64_t frame_ = 0;
+    alignas(kCacheLineSize) std::atomic<std::size_t> offset_{0};
+    std::size_t lastFrameBytes_ = 0;
+    std::size_t highWater_ = 0;
+#if defined(REBEL_MEMORY_DEBUG)
+    std::array<std::atomic<std::size_t>, kMemoryTagCount> tagBytes_{};
+    std::array<std::size_t, kMemoryTagCount> lastFrameByTag_{};
+    std::array<std::size_t, kMemoryTagCount> highWaterByTag_{};
+#endif
+};
+
+/// Human-readable multi-line report of a frame allocator's usage.
+std::string formatStats(const FrameAllocatorStats& stats);
+
+} // namespace rebel::memory
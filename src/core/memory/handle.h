@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace rebel::memory {
+
+/// Generational reference to an object in a Pool<T> or SlotTable<T>. The
+/// index addresses a slot; the generation must match the slot's current
+/// generation, so a handle to a freed (and possibly reused) slot is detected
+/// in O(1).
+template <typename T>
+struct Handle {
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    constexpr bool isNull() const { return index == kInvalidIndex; }
+    constexpr uint64_t bits() const { return (uint64_t(generation) << 32) | index; }
+
+    friend constexpr bool operator==(Handle a, Handle b) = default;
+};
+
+} // namespace rebel::memory
+
+template <typename T>
+struct std::hash<rebel::memory::Handle<T>> {
+    size_t operator()(rebel::memory::Handle<T> h) const noexcept { return std::hash<uint64_t>{}(h.bits()); }
+};
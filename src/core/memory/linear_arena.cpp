@@ -0,0 +1,114 @@
+#include "core/memory/linear_arena.h"
+
+#include "core/assert.h"
+#include "core/platform.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace rebel::memory {
+
+namespace {
+
+constexpr std::size_t kFallbackScratchBytes = 1u << 20;
+
+thread_local LinearArena* tlsScratch = nullptr;
+
+} // namespace
+
+LinearArena::LinearArena(std::size_t capacity, const char* name)
+    : base_(static_cast<unsigned char*>(::operator new(capacity, std::align_val_t(kCacheLineSize))))
+    , capacity_(capacity)
+    , name_(name)
+    , owned_(true)
+{
+#if defined(REBEL_MEMORY_DEBUG)
+    std::memset(base_, kPoisonByte, capacity_);
+#endif
+}
+
+LinearArena::LinearArena(void* buffer, std::size_t capacity, const char* name)
+    : base_(static_cast<unsigned char*>(buffer))
+    , capacity_(capacity)
+    , name_(name)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    release();
+}
+
+LinearArena::LinearArena(LinearArena&& other) noexcept
+    : base_(std::exchange(other.base_, nullptr))
+    , capacity_(std::exchange(other.capacity_, 0))
+    , offset_(std::exchange(other.offset_, 0))
+    , highWater_(std::exchange(other.highWater_, 0))
+    , name_(other.name_)
+    , owned_(std::exchange(other.owned_, false))
+{
+}
+
+LinearArena& LinearArena::operator=(LinearArena&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        base_ = std::exchange(other.base_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        offset_ = std::exchange(other.offset_, 0);
+        highWater_ = std::exchange(other.highWater_, 0);
+        name_ = other.name_;
+        owned_ = std::exchange(other.owned_, false);
+    }
+    return *this;
+}
+
+void LinearArena::release()
+{
+    if (owned_ && base_)
+        ::operator delete(base_, std::align_val_t(kCacheLineSize));
+    base_ = nullptr;
+    owned_ = false;
+}
+
+void* LinearArena::allocate(std::size_t size, std::size_t alignment)
+{
+    const uintptr_t base = reinterpret_cast<uintptr_t>(base_);
+    const std::size_t start = alignUp(base + offset_, alignment) - base;
+    if (start + size > capacity_) {
+        REBEL_ASSERT(false, "linear arena exhausted");
+        return nullptr;
+    }
+    offset_ = start + size;
+    highWater_ = std::max(highWater_, offset_);
+    return base_ + start;
+}
+
+void LinearArena::rewind(std::size_t marker)
+{
+    REBEL_ASSERT(marker <= offset_, "rewinding past the current offset");
+#if defined(REBEL_MEMORY_DEBUG)
+    std::memset(base_ + marker, kPoisonByte, offset_ - marker);
+#endif
+    offset_ = marker;
+}
+
+LinearArena& threadScratch()
+{
+    if (!tlsScratch) {
+        thread_local std::unique_ptr<LinearArena> fallback;
+        if (!fallback)
+            fallback = std::make_unique<LinearArena>(kFallbackScratchBytes, "thread scratch");
+        tlsScratch = fallback.get();
+    }
+    return *tlsScratch;
+}
+
+void bindThreadScratch(LinearArena* arena)
+{
+    tlsScratch = arena;
+}
+
+} // namespace rebel::memory
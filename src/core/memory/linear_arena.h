@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/memory/memory_tag.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace rebel::memory {
+
+/// Single-threaded bump allocator over a fixed buffer. Individual frees do
+/// not exist: callers take a marker and rewind to it, or reset everything.
+/// Out of memory is a sizing bug, reported by assertion; allocate() then
+/// returns nullptr.
+class LinearArena {
+public:
+    LinearArena() = default;
+    /// Owns `capacity` bytes of cache-line aligned memory.
+    explicit LinearArena(std::size_t capacity, const char* name = "arena");
+    /// Wraps caller-owned memory.
+    LinearArena(void* buffer, std::size_t capacity, const char* name = "arena");
+    ~LinearArena();
+
+    LinearArena(LinearArena&& other) noexcept;
+    LinearArena& operator=(LinearArena&& other) noexcept;
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /// Uninitialised storage for `count` objects of an implicit-lifetime type.
+    template <typename T>
+    T* allocateArray(std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is never destructed");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    std::size_t marker() const { return offset_; }
+    void rewind(std::size_t marker);
+    void reset() { rewind(0); }
+
+    std::size_t used() const { return offset_; }
+    std::size_t capacity() const { return capacity_; }
+    std::size_t highWater() const { return highWater_; }
+    const char* name() const { return name_; }
+
+private:
+    void release();
+
+    unsigned char* base_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t offset_ = 0;
+    std::size_t highWater_ = 0;
+    const char* name_ = "arena";
+    bool owned_ = false;
+};
+
+/// The calling thread's scratch arena. Job-system workers get one sized by
+/// JobSystemDesc::scratchBytesPerWorker; other threads lazily get a default
+/// one on first use.
+LinearArena& threadScratch();
+
+/// Installs `arena` as the calling thread's scratch (nullptr restores the
+/// lazily created fallback).
+void bindThreadScratch(LinearArena* arena);
+
+/// RAII scope over the thread's scratch arena. Everything allocated through
+/// it is released when the scope ends, so scratch use nests naturally, even
+/// across jobs executed while waiting inside another job.
+class ScratchScope {
+public:
+    ScratchScope()
+        : arena_(threadScratch())
+        , marker_(arena_.marker())
+    {
+    }
+    ~ScratchScope() { arena_.rewind(marker_); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    LinearArena& arena() { return arena_; }
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        return arena_.allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* allocateArray(std::size_t count)
+    {
+        return arena_.allocateArray<T>(count);
+    }
+
+private:
+    LinearArena& arena_;
+    std::size_t marker_;
+};
+
+} // namespace rebel::memory
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rebel::memory {
+
+/// Subsystem that owns an allocation. Used to attribute arena usage so each
+/// subsystem's per-frame budget can be sized from measured high-water marks.
+enum class MemoryTag : uint8_t {
+    General,
+    Render,
+    Physics,
+    Animation,
+    AI,
+    Count
+};
+
+inline constexpr std::size_t kMemoryTagCount = std::size_t(MemoryTag::Count);
+
+constexpr const char* memoryTagName(MemoryTag tag)
+{
+    switch (tag) {
+    case MemoryTag::General: return "general";
+    case MemoryTag::Render: return "render";
+    case MemoryTag::Physics: return "physics";
+    case MemoryTag::Animation: return "animation";
+    case MemoryTag::AI: return "ai";
+    case MemoryTag::Count: break;
+    }
+    return "unknown";
+}
+
+/// Byte written over arena memory when it is released in debug builds, so
+/// use-after-reset reads show up as 0xDDDDDDDD instead of stale data.
+inline constexpr unsigned char kPoisonByte = 0xDD;
+
+} // namespace rebel::memory
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/memory/handle.h"
+#include "core/platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace rebel::memory {
+
+/// Fixed-capacity typed pool addressed through generational handles.
+///
+/// Slots live in lazily allocated blocks of kBlockSize that are never moved
+/// or returned, so pointers stay stable and a long-running process never
+/// fragments the heap. create() and destroy() are lock-free and may be
+/// called from any job thread: freed slots go on a Treiber stack whose head
+/// carries an ABA tag, and never-used slots are handed out by an atomic bump
+/// index.
+///
+/// A slot's generation is odd while it is alive and even while it is free.
+/// get() only checks generations, so it must not race with destroy() of the
+/// same object; callers own that synchronisation.
+///
+/// Which slot a create() gets depends on how concurrent calls interleave,
+/// so a Pool suits long-lived objects created and destroyed from any thread
+/// whose ids need not be reproducible. Simulation state that must replay
+/// and snapshot bit for bit does not live in one: the physics worlds keep
+/// bodies in SlotTable-indexed arrays, and rebuild contact manifolds each
+/// step into arrays that keep their capacity, which is neither per-object
+/// heap traffic nor fragmentation. Animation instances are the caller's
+/// (see AnimatorInstance), so the caller picks their storage.
+template <typename T>
+class Pool {
+public:
+    static constexpr uint32_t kBlockShift = 10;
+    static constexpr uint32_t kBlockSize = 1u << kBlockShift;
+
+    explicit Pool(uint32_t capacity)
+        : capacity_(capacity)
+        , blockCount_((capacity + kBlockSize - 1) / kBlockSize)
+        , blocks_(std::make_unique<std::atomic<Slot*>[]>(blockCount_))
+    {
+        for (uint32_t b = 0; b < blockCount_; ++b)
+            blocks_[b].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~Pool()
+    {
+        forEach([](Handle<T>, T& object) { object.~T(); });
+        for (uint32_t b = 0; b < blockCount_; ++b)
+            delete[] blocks_[b].load(std::memory_order_relaxed);
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    /// Constructs a T in a free slot. Returns a null handle when the pool is
+    /// exhausted, which is treated as a sizing error.
+    template <typename... Args>
+    Handle<T> create(Args&&... args)
+    {
+        uint32_t index = popFree();
+        if (index == kNone) {
+            index = fresh_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= capacity_) {
+                REBEL_ASSERT(false, "pool exhausted");
+                return {};
+            }
+        }
+
+        Slot& slot = slotAt(index, true);
+        ::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        live_.fetch_add(1, std::memory_order_relaxed);
+        return {index, generation};
+    }
+
+    /// Destroys the object. Returns false (and does nothing) for null, stale
+    /// or already-destroyed handles.
+    bool destroy(Handle<T> handle)
+    {
+        Slot* slot = slotFor(handle);
+        if (!slot)
+            return false;
+        uint32_t expected = handle.generation;
+        if (!slot->generation.compare_exchange_strong(expected, expected + 1, std::memory_order_acq_rel))
+            return false;
+        std::launder(reinterpret_cast<T*>(slot->storage))->~T();
+        pushFree(handle.index, *slot);
+        live_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Object for a handle, or nullptr if the handle is null or stale.
+    T* get(Handle<T> handle) const
+    {
+        Slot* slot = slotFor(handle);
+        if (!slot || slot->generation.load(std::memory_order_acquire) != handle.generation)
+            return nullptr;
+        return std::launder(reinterpret_cast<T*>(slot->storage));
+    }
+
+    bool valid(Handle<T> handle) const { return get(handle) != nullptr; }
+
+    uint32_t size() const { return live_.load(std::memory_order_relaxed); }
+    uint32_t capacity() const { return capacity_; }
+
+    /// Slots ever handed out; an upper bound for iteration.
+    uint32_t slotHighWater() const { return std::min(fresh_.load(std::memory_order_relaxed), capacity_); }
+
+    /// Calls fn(handle, object) for every live object in slot order. Must not
+    /// run concurrently with create() or destroy().
+    template <typename Fn>
+    void forEach(Fn&& fn)
+    {
+        const uint32_t end = slotHighWater();
+        for (uint32_t index = 0; index < end; ++index) {
+            Slot* block = blocks_[index >> kBlockShift].load(std::memory_order_acquire);
+            if (!block)
+                continue;
+            Slot& slot = block[index & (kBlockSize - 1)];
+            const uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+            if (generation & 1u)
+                fn(Handle<T>{index, generation}, *std::launder(reinterpret_cast<T*>(slot.storage)));
+        }
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint32_t> generation{0};
+        std::atomic<uint32_t> nextFree{kNone};
+    };
+
+    Slot& slotAt(uint32_t index, bool allocateBlock)
+    {
+        std::atomic<Slot*>& blockPtr = blocks_[index >> kBlockShift];
+        Slot* block = blockPtr.load(std::memory_order_acquire);
+        if (!block && allocateBlock) {
+            // Racing creators may both allocate; the loser frees its copy.
+            Slot* fresh = new Slot[kBlockSize];
+            if (blockPtr.compare_exchange_strong(block, fresh, std::memory_order_acq_rel))
+                block = fresh;
+            else
+                delete[] fresh;
+        }
+        return block[index & (kBlockSize - 1)];
+    }
+
+    Slot* slotFor(Handle<T> handle) const
+    {
+        if (handle.index >= capacity_ || !(handle.generation & 1u))
+            return nullptr;
+        Slot* block = blocks_[handle.index >> kBlockShift].load(std::memory_order_acquire);
+        return block ? &block[handle.index & (kBlockSize - 1)] : nullptr;
+    }
+
+    // Free list head packs {tag:32, index:32}; the tag changes on every
+    // update so a concurrent pop/push/pop sequence cannot ABA the CAS.
+    static constexpr uint64_t pack(uint32_t tag, uint32_t index) { return (uint64_t(tag) << 32) | index; }
+
+    uint32_t popFree()
+    {
+        uint64_t head = freeHead_.load(std::memory_order_acquire);
+        for (;;) {
+            const uint32_t index = uint32_t(head);
+            if (index == kNone)
+                return kNone;
+            const uint32_t next = slotAt(index, false).nextFree.load(std::memory_order_relaxed);
+            if (freeHead_.compare_exchange_weak(head, pack(uint32_t(head >> 32) + 1, next),
+                                                std::memory_order_acquire, std::memory_order_acquire))
+                return index;
+        }
+    }
+
+    void pushFree(uint32_t index, Slot& slot)
+    {
+        uint64_t head = freeHead_.load(std::memory_order_relaxed);
+        do {
+            slot.nextFree.store(uint32_t(head), std::memory_order_relaxed);
+        } while (!freeHead_.compare_exchange_weak(head, pack(uint32_t(head >> 32) + 1, index),
+                                                  std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    uint32_t capacity_;
+    uint32_t blockCount_;
+    std::unique_ptr<std::atomic<Slot*>[]> blocks_;
+    alignas(kCacheLineSize) std::atomic<uint64_t> freeHead_{pack(0, kNone)};
+    alignas(kCacheLineSize) std::atomic<uint32_t> fresh_{0};
+    alignas(kCacheLineSize) std::atomic<uint32_t> live_{0};
+};
+
+} // namespace rebel::memory
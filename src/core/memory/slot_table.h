@@ -0,0 +1,88 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/memory/handle.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::memory {
+
+/// Generational slots for objects their owner keeps in its own flat,
+/// slot-indexed arrays. Single-threaded; generations are odd while alive,
+/// as in Pool<T>, so ids are the same Handle<T>.
+///
+/// Simulation worlds use this rather than Pool<T>: their step jobs walk
+/// per-slot arrays (bodies, bounds, solver indices) densely, the arrays grow
+/// without a fixed capacity, and a world snapshot must capture the
+/// allocator itself, generations and free order, so that a world restored
+/// from it hands out the same ids as the original. Pool keeps objects in
+/// blocks beside their atomics, with its free list in a lock-free stack.
+///
+/// Freed slots are reused last-freed first, so ids are deterministic.
+template <typename T>
+class SlotTable {
+public:
+    /// A free slot, or a new one at the end: when the returned index equals
+    /// the slotCount() before the call, the owner grows its arrays.
+    Handle<T> create()
+    {
+        uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        } else {
+            index = uint32_t(generations_.size());
+            generations_.push_back(0);
+        }
+        ++live_;
+        return {index, ++generations_[index]};
+    }
+
+    void destroy(Handle<T> handle)
+    {
+        REBEL_ASSERT(valid(handle), "destroying a stale handle");
+        ++generations_[handle.index];
+        free_.push_back(handle.index);
+        --live_;
+    }
+
+    bool valid(Handle<T> handle) const
+    {
+        return handle.index < generations_.size() && generations_[handle.index] == handle.generation &&
+               (handle.generation & 1u);
+    }
+
+    bool alive(uint32_t index) const { return generations_[index] & 1u; }
+    /// The handle of the object in slot `index`.
+    Handle<T> handle(uint32_t index) const { return {index, generations_[index]}; }
+
+    /// Slots ever created, live or free: the length of the owner's arrays.
+    uint32_t slotCount() const { return uint32_t(generations_.size()); }
+    uint32_t size() const { return live_; }
+
+    /// For snapshots: Writer and Reader take array(std::vector&) and
+    /// value(uint32_t&), as physics::StateWriter and StateReader do.
+    template <typename Writer>
+    void saveState(Writer& writer) const
+    {
+        writer.array(generations_);
+        writer.array(free_);
+        writer.value(live_);
+    }
+
+    template <typename Reader>
+    void loadState(Reader& reader)
+    {
+        reader.array(generations_);
+        reader.array(free_);
+        reader.value(live_);
+    }
+
+private:
+    std::vector<uint32_t> generations_;
+    std::vector<uint32_t> free_;
+    uint32_t live_ = 0;
+};
+
+} // namespace rebel::memory
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#define REBEL_FORCEINLINE __forceinline
+#define REBEL_NOINLINE __declspec(noinline)
+#define REBEL_RESTRICT __restrict
+#define REBEL_TARGET_AVX2
+#define REBEL_TARGET_AVX2_FMA
+#define REBEL_TARGET_AVX512
+#else
+#define REBEL_FORCEINLINE inline __attribute__((always_inline))
+#define REBEL_NOINLINE __attribute__((noinline))
+#define REBEL_RESTRICT __restrict__
+// Per-function ISA targets for kernels built alongside baseline code; only
+// call them after checking detectSimdLevel(). Kernels that must match their
+// SSE twin bit for bit use REBEL_TARGET_AVX2, which leaves FMA off.
+#define REBEL_TARGET_AVX2 __attribute__((target("avx2")))
+#define REBEL_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#define REBEL_TARGET_AVX512 __attribute__((target("avx2,fma,avx512f")))
+#endif
+
+namespace rebel {
+
+/// Size of a cache line on every platform we ship on.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace rebel
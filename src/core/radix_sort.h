@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/assert.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace rebel {
+
+/// Stable LSD radix sort on the 64-bit key `keyOf(entry)`, 8 bits per pass.
+/// All eight histograms are built in one read of the input, and passes where
+/// every key shares the same byte are skipped, so keys using few distinct
+/// bits (render sort keys, broadphase pair keys) cost proportionally fewer
+/// passes. `scratch` must be at least as large as `entries`; the result
+/// always ends up in `entries`.
+template <typename T, typename KeyFn>
+void radixSort(std::span<T> entries, std::span<T> scratch, KeyFn keyOf)
+{
+    REBEL_ASSERT(scratch.size() >= entries.size(), "radix sort scratch too small");
+    const std::size_t n = entries.size();
+    if (n < 2)
+        return;
+
+    uint32_t histograms[8][256] = {};
+    for (const T& e : entries) {
+        const uint64_t key = keyOf(e);
+        for (int b = 0; b < 8; ++b)
+            ++histograms[b][(key >> (b * 8)) & 0xFF];
+    }
+
+    T* src = entries.data();
+    T* dst = scratch.data();
+    for (int b = 0; b < 8; ++b) {
+        uint32_t* histogram = histograms[b];
+        const int shift = b * 8;
+        if (histogram[(keyOf(src[0]) >> shift) & 0xFF] == n)
+            continue; // every key has the same byte here
+
+        uint32_t offset = 0;
+        for (int d = 0; d < 256; ++d) {
+            const uint32_t count = histogram[d];
+            histogram[d] = offset;
+            offset += count;
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            dst[histogram[(keyOf(src[i]) >> shift) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+
+    if (src != entries.data())
+        std::copy(src, src + n, entries.data());
+}
+
+/// Sorts bare keys.
+inline void radixSort(std::span<uint64_t> keys, std::span<uint64_t> scratch)
+{
+    radixSort(keys, scratch, [](uint64_t key) { return key; });
+}
+
+} // namespace rebel
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/math/vec.h"
+
+#include <cfloat>
+
+namespace rebel::physics {
+
+/// Axis-aligned bounding box. Overlap tests are inclusive, so touching
+/// boxes overlap.
+struct Aabb {
+    math::Vec3 min{FLT_MAX, FLT_MAX, FLT_MAX};
+    math::Vec3 max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    static constexpr Aabb fromCenterExtents(math::Vec3 center, math::Vec3 extents)
+    {
+        return {center - extents, center + extents};
+    }
+
+    constexpr math::Vec3 center() const { return (min + max) * 0.5f; }
+    constexpr math::Vec3 extents() const { return (max - min) * 0.5f; }
+
+    /// Surface area, the SAH cost metric.
+    constexpr float area() const
+    {
+        const math::Vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    constexpr bool contains(const Aabb& other) const
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && other.max.x <= max.x &&
+               other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    constexpr bool contains(math::Vec3 p) const
+    {
+        return min.x <= p.x && p.x <= max.x && min.y <= p.y && p.y <= max.y && min.z <= p.z && p.z <= max.z;
+    }
+
+    constexpr Aabb expanded(float margin) const
+    {
+        return {min - math::Vec3{margin, margin, margin}, max + math::Vec3{margin, margin, margin}};
+    }
+};
+
+constexpr bool overlaps(const Aabb& a, const Aabb& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+inline Aabb merge(const Aabb& a, const Aabb& b)
+{
+    return {math::min(a.min, b.min), math::max(a.max, b.max)};
+}
+
+} // namespace rebel::physics
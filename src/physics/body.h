@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/math/quat.h"
+#include "core/math/vec.h"
+#include "core/memory/handle.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+
+#include <cstdint>
+
+namespace rebel::physics {
+
+enum class BodyType : uint8_t {
+    /// Never moves; infinite mass.
+    Static,
+    /// Moved by its velocity only; pushes dynamic bodies but is never pushed.
+    Kinematic,
+    Dynamic,
+};
+
+struct BodyDesc {
+    BodyType type = BodyType::Dynamic;
+    Shape shape;
+    math::Vec3 position{};
+    math::Quat rotation{};
+    math::Vec3 linearVelocity{};
+    math::Vec3 angularVelocity{};
+    /// Dynamic bodies only.
+    float mass = 1.0f;
+    float friction = 0.6f;
+    float restitution = 0.0f;
+    float linearDamping = 0.0f;
+    float angularDamping = 0.05f;
+    bool allowSleep = true;
+    /// Continuous collision for small, fast dynamic bodies such as
+    /// projectiles: speculative contacts reach as far as the body can move
+    /// in a step, and time-of-impact sub-steps stop it at static geometry.
+    bool ccd = false;
+    uint32_t userData = 0;
+};
+
+struct Body {
+    Transform transform;
+    math::Vec3 linearVelocity{};
+    math::Vec3 angularVelocity{};
+    /// Body-space principal inverse inertia; zero unless dynamic.
+    math::Vec3 inverseInertia;
+    float inverseMass = 0.0f;
+    float friction = 0.6f;
+    float restitution = 0.0f;
+    float linearDamping = 0.0f;
+    float angularDamping = 0.0f;
+    /// Seconds spent below the sleep velocity thresholds.
+    float sleepTime = 0.0f;
+    Shape shape;
+    uint32_t proxy = 0;
+    uint32_t userData = 0;
+    /// Sleeping island the body belongs to, when asleep.
+    uint32_t island = UINT32_MAX;
+    BodyType type = BodyType::Dynamic;
+    bool allowSleep = true;
+    bool ccd = false;
+    bool sleeping = false;
+};
+
+using BodyId = memory::Handle<Body>;
+
+} // namespace rebel::physics
@@ -0,0 +1,269 @@
+#include "physics/broadphase/broadphase.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "physics/state_buffer.h"
+
+#include <algorithm>
+
+namespace rebel::physics {
+
+namespace {
+
+constexpr uint32_t kQueryGrain = 256;
+constexpr uint32_t kScanGrain = 16 * 1024;
+
+} // namespace
+
+Broadphase::Broadphase(const BroadphaseDesc& desc)
+    : type_(desc.type)
+    , margin_(desc.margin)
+    , displacementMultiplier_(desc.displacementMultiplier)
+    , pairs_(desc.initialPairCapacity)
+{
+}
+
+uint32_t Broadphase::createProxy(const Aabb& aabb, uint32_t userData)
+{
+    uint32_t id;
+    if (!freeProxies_.empty()) {
+        id = freeProxies_.back();
+        freeProxies_.pop_back();
+    } else {
+        id = uint32_t(proxies_.size());
+        proxies_.emplace_back();
+    }
+
+    Proxy& proxy = proxies_[id];
+    proxy = Proxy{};
+    proxy.fat = aabb.expanded(margin_);
+    proxy.userData = userData;
+    proxy.state = ProxyState::Alive;
+    ++aliveCount_;
+
+    if (type_ == BroadphaseType::DynamicTree) {
+        proxy.leaf = tree_.createProxy(proxy.fat, id);
+        markMoved(id);
+    } else {
+        proxy.pending = true;
+        pendingCreate_.push_back(id);
+    }
+    return id;
+}
+
+void Broadphase::destroyProxy(uint32_t proxy)
+{
+    Proxy& p = proxies_[proxy];
+    REBEL_ASSERT(p.state == ProxyState::Alive, "destroying a dead proxy");
+    if (type_ == BroadphaseType::DynamicTree) {
+        tree_.destroyProxy(p.leaf);
+        p.leaf = kNullNode;
+    } else if (p.pending) {
+        pendingCreate_.erase(std::find(pendingCreate_.begin(), pendingCreate_.end(), proxy));
+    } else {
+        sweep_.removeProxy(proxy);
+    }
+    p.state = ProxyState::Destroyed;
+    destroyed_.push_back(proxy);
+    --aliveCount_;
+}
+
+void Broadphase::moveProxy(uint32_t proxy, const Aabb& aabb, math::Vec3 displacement)
+{
+    Proxy& p = proxies_[proxy];
+    REBEL_ASSERT(p.state == ProxyState::Alive, "moving a dead proxy");
+    if (p.fat.contains(aabb))
+        return;
+
+    // Predict along the motion so steady movers keep their fat box.
+    Aabb fat = aabb.expanded(margin_);
+    const math::Vec3 d = displacement * displacementMultiplier_;
+    (d.x < 0.0f ? fat.min.x : fat.max.x) += d.x;
+    (d.y < 0.0f ? fat.min.y : fat.max.y) += d.y;
+    (d.z < 0.0f ? fat.min.z : fat.max.z) += d.z;
+    p.fat = fat;
+
+    if (type_ == BroadphaseType::DynamicTree)
+        tree_.moveProxy(p.leaf, fat);
+    if (!p.pending)
+        markMoved(proxy);
+}
+
+void Broadphase::markMoved(uint32_t proxy)
+{
+    if (!proxies_[proxy].moved) {
+        proxies_[proxy].moved = true;
+        moved_.push_back(proxy);
+    }
+}
+
+void Broadphase::saveState(StateWriter& out) const
+{
+    out.array(proxies_);
+    out.array(freeProxies_);
+    out.array(moved_);
+    out.array(destroyed_);
+    out.array(pendingCreate_);
+    out.value(aliveCount_);
+    if (type_ == BroadphaseType::DynamicTree)
+        tree_.saveState(out);
+    else
+        sweep_.saveState(out);
+    pairs_.saveState(out);
+}
+
+void Broadphase::loadState(StateReader& in)
+{
+    in.array(proxies_);
+    in.array(freeProxies_);
+    in.array(moved_);
+    in.array(destroyed_);
+    in.array(pendingCreate_);
+    in.value(aliveCount_);
+    if (type_ == BroadphaseType::DynamicTree)
+        tree_.loadState(in);
+    else
+        sweep_.loadState(in);
+    pairs_.loadState(in);
+}
+
+void Broadphase::updatePairs(jobs::JobSystem& jobs)
+{
+    stats_ = {};
+    stats_.movedProxies = uint32_t(moved_.size() + pendingCreate_.size());
+
+    if (type_ == BroadphaseType::DynamicTree) {
+        if (!moved_.empty() || !destroyed_.empty())
+            purgePairs(jobs, true);
+        findTreePairs(jobs);
+    } else {
+        updateSweep();
+        if (!destroyed_.empty())
+            purgePairs(jobs, false);
+    }
+
+    for (const uint32_t proxy : moved_)
+        proxies_[proxy].moved = false;
+    moved_.clear();
+    for (const uint32_t proxy : destroyed_) {
+        proxies_[proxy].state = ProxyState::Free;
+        freeProxies_.push_back(proxy);
+    }
+    destroyed_.clear();
+    pairs_.compact();
+
+    stats_.proxies = aliveCount_;
+    stats_.pairs = pairs_.size();
+}
+
+void Broadphase::purgePairs(jobs::JobSystem& jobs, bool movedOnly)
+{
+    // One linear pass over the table; only pairs touching a destroyed proxy,
+    // or (tree mode) a moved one, get an overlap test.
+    const uint32_t capacity = pairs_.capacity();
+    const uint32_t jobCount = (capacity + kScanGrain - 1) / kScanGrain;
+    jobRemoved_.assign(jobCount, 0);
+    jobs.parallelFor(capacity, kScanGrain, [&](uint32_t begin, uint32_t end) {
+        uint32_t removed = 0;
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint64_t key = pairs_.slot(i);
+            if (!PairCache::live(key))
+                continue;
+            const Proxy& a = proxies_[pairFirst(key)];
+            const Proxy& b = proxies_[pairSecond(key)];
+            bool stale = a.state != ProxyState::Alive || b.state != ProxyState::Alive;
+            if (!stale && movedOnly && (a.moved || b.moved))
+                stale = !overlaps(a.fat, b.fat);
+            if (stale && pairs_.remove(key))
+                ++removed;
+        }
+        jobRemoved_[begin / kScanGrain] = removed;
+    });
+    for (const uint32_t removed : jobRemoved_)
+        stats_.pairsRemoved += removed;
+}
+
+void Broadphase::findTreePairs(jobs::JobSystem& jobs)
+{
+    const uint32_t movedCount = uint32_t(moved_.size());
+    if (movedCount == 0)
+        return;
+
+    pairs_.reserve(pairs_.size() + movedCount);
+    const uint32_t jobCount = (movedCount + kQueryGrain - 1) / kQueryGrain;
+    if (overflow_.size() < jobCount)
+        overflow_.resize(jobCount);
+    jobAdded_.assign(jobCount, 0);
+
+    jobs.parallelFor(movedCount, kQueryGrain, [&](uint32_t begin, uint32_t end) {
+        const uint32_t job = begin / kQueryGrain;
+        std::vector<uint64_t>& overflow = overflow_[job];
+        overflow.clear();
+        uint32_t added = 0;
+        for (uint32_t m = begin; m < end; ++m) {
+            const uint32_t self = moved_[m];
+            if (proxies_[self].state != ProxyState::Alive)
+                continue;
+            tree_.query(proxies_[self].fat, [&](uint32_t other) {
+                // When both moved, only the higher id reports the pair.
+                if (other == self || (proxies_[other].moved && other < self))
+                    return true;
+                const uint64_t key = pairKey(self, other);
+                const PairCache::AddResult result = pairs_.add(key);
+                if (result == PairCache::AddResult::Added)
+                    ++added;
+                else if (result == PairCache::AddResult::Full)
+                    overflow.push_back(key);
+                return true;
+            });
+        }
+        jobAdded_[job] = added;
+    });
+
+    std::size_t overflowCount = 0;
+    for (uint32_t j = 0; j < jobCount; ++j) {
+        stats_.pairsAdded += jobAdded_[j];
+        overflowCount += overflow_[j].size();
+    }
+    if (overflowCount > 0) {
+        pairs_.reserve(uint32_t(pairs_.size() + overflowCount));
+        for (uint32_t j = 0; j < jobCount; ++j) {
+            for (const uint64_t key : overflow_[j])
+                stats_.pairsAdded += pairs_.add(key) == PairCache::AddResult::Added;
+        }
+    }
+}
+
+void Broadphase::updateSweep()
+{
+    uint32_t added = 0, removed = 0;
+
+    // Big batches (level load) re-sort from scratch instead of inserting
+    // one by one at O(n) each.
+    if (!pendingCreate_.empty()) {
+        if (pendingCreate_.size() > std::max<std::size_t>(64, aliveCount_ / 8)) {
+            std::vector<Aabb> boxes;
+            boxes.reserve(pendingCreate_.size());
+            for (const uint32_t proxy : pendingCreate_)
+                boxes.push_back(proxies_[proxy].fat);
+            pairs_.reserve(pairs_.size() + uint32_t(pendingCreate_.size()) * 4);
+            sweep_.rebuild(pendingCreate_, boxes, pairs_, added);
+        } else {
+            for (const uint32_t proxy : pendingCreate_)
+                sweep_.addProxy(proxy, proxies_[proxy].fat, pairs_, added);
+        }
+        for (const uint32_t proxy : pendingCreate_)
+            proxies_[proxy].pending = false;
+        pendingCreate_.clear();
+    }
+
+    for (const uint32_t proxy : moved_) {
+        if (proxies_[proxy].state == ProxyState::Alive)
+            sweep_.moveProxy(proxy, proxies_[proxy].fat, pairs_, added, removed);
+    }
+
+    stats_.pairsAdded += added;
+    stats_.pairsRemoved += removed;
+}
+
+} // namespace rebel::physics
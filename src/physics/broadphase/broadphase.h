@@ -0,0 +1,126 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/aabb.h"
+#include "physics/broadphase/dynamic_tree.h"
+#include "physics/broadphase/pair_cache.h"
+#include "physics/broadphase/sweep_and_prune.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+class StateReader;
+class StateWriter;
+
+enum class BroadphaseType : uint8_t {
+    /// Dynamic AABB tree; parallel pair finding. Best for scenes with many
+    /// fast or unevenly distributed bodies.
+    DynamicTree,
+    /// Incremental three-axis sweep and prune; cheapest for large numbers of
+    /// slow, coherently moving bodies.
+    SweepAndPrune,
+};
+
+struct BroadphaseDesc {
+    BroadphaseType type = BroadphaseType::DynamicTree;
+    /// Fat AABB margin added on every side.
+    float margin = 0.1f;
+    /// Fat AABBs are also stretched along the step's displacement times this
+    /// factor, so steadily moving bodies rarely leave them.
+    float displacementMultiplier = 2.0f;
+    uint32_t initialPairCapacity = 4096;
+};
+
+struct BroadphaseStats {
+    uint32_t proxies = 0;
+    uint32_t movedProxies = 0; // fat boxes that changed in the last update
+    uint32_t pairs = 0;
+    uint32_t pairsAdded = 0;
+    uint32_t pairsRemoved = 0;
+};
+
+/// Broadphase front end: owns proxies and their fat AABBs, drives the chosen
+/// acceleration structure, and keeps the lock-free PairCache of overlapping
+/// fat boxes up to date.
+///
+/// moveProxy() is free while a body stays inside its fat box. Only proxies
+/// whose fat box changed are re-tested in updatePairs(), so pair work per
+/// step follows movement rather than body count.
+class Broadphase {
+public:
+    explicit Broadphase(const BroadphaseDesc& desc = {});
+
+    BroadphaseType type() const { return type_; }
+
+    uint32_t createProxy(const Aabb& aabb, uint32_t userData);
+    /// The proxy id stays reserved until the next updatePairs() purges its
+    /// pairs.
+    void destroyProxy(uint32_t proxy);
+    /// Reports a proxy's new tight box and its displacement over the step.
+    void moveProxy(uint32_t proxy, const Aabb& aabb, math::Vec3 displacement);
+
+    /// Brings the pair cache up to date with every create/move/destroy since
+    /// the previous call.
+    void updatePairs(jobs::JobSystem& jobs);
+
+    const PairCache& pairs() const { return pairs_; }
+    const Aabb& fatAabb(uint32_t proxy) const { return proxies_[proxy].fat; }
+    uint32_t userData(uint32_t proxy) const { return proxies_[proxy].userData; }
+    /// The tree in DynamicTree mode (empty otherwise); leaves carry proxy ids.
+    const DynamicAabbTree& tree() const { return tree_; }
+    const BroadphaseStats& stats() const { return stats_; }
+
+    /// Snapshot support: proxies, the active structure and the pair cache,
+    /// restored exactly so the pair set and its slot order come back too.
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
+private:
+    enum class ProxyState : uint8_t {
+        Free,
+        Alive,
+        Destroyed, // awaiting pair purge
+    };
+
+    struct Proxy {
+        Aabb fat;
+        uint32_t userData = 0;
+        uint32_t leaf = kNullNode;
+        ProxyState state = ProxyState::Free;
+        bool moved = false;
+        bool pending = false; // created since the last update (SweepAndPrune)
+    };
+
+    void markMoved(uint32_t proxy);
+    void purgePairs(jobs::JobSystem& jobs, bool movedOnly);
+    void findTreePairs(jobs::JobSystem& jobs);
+    void updateSweep();
+
+    BroadphaseType type_;
+    float margin_;
+    float displacementMultiplier_;
+
+    std::vector<Proxy> proxies_;
+    std::vector<uint32_t> freeProxies_;
+    std::vector<uint32_t> moved_;
+    std::vector<uint32_t> destroyed_;
+    std::vector<uint32_t> pendingCreate_;
+    uint32_t aliveCount_ = 0;
+
+    DynamicAabbTree tree_;
+    SweepAndPrune sweep_;
+    PairCache pairs_;
+
+    std::vector<std::vector<uint64_t>> overflow_;
+    std::vector<uint32_t> jobAdded_;
+    std::vector<uint32_t> jobRemoved_;
+    BroadphaseStats stats_;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,254 @@
+#include "physics/broadphase/dynamic_tree.h"
+
+#include "physics/state_buffer.h"
+
+#include <algorithm>
+
+namespace rebel::physics {
+
+uint32_t DynamicAabbTree::allocateNode()
+{
+    if (freeList_ == kNullNode) {
+        nodes_.emplace_back();
+        return uint32_t(nodes_.size() - 1);
+    }
+    const uint32_t node = freeList_;
+    freeList_ = nodes_[node].parent;
+    nodes_[node] = Node{};
+    return node;
+}
+
+void DynamicAabbTree::freeNode(uint32_t node)
+{
+    nodes_[node].height = -1;
+    nodes_[node].parent = freeList_;
+    freeList_ = node;
+}
+
+uint32_t DynamicAabbTree::createProxy(const Aabb& aabb, uint32_t userData)
+{
+    const uint32_t leaf = allocateNode();
+    nodes_[leaf].aabb = aabb;
+    nodes_[leaf].userData = userData;
+    nodes_[leaf].height = 0;
+    insertLeaf(leaf);
+    ++leafCount_;
+    return leaf;
+}
+
+void DynamicAabbTree::destroyProxy(uint32_t leaf)
+{
+    REBEL_ASSERT(leaf < nodes_.size() && nodes_[leaf].leaf() && nodes_[leaf].height == 0, "not a tree leaf");
+    removeLeaf(leaf);
+    freeNode(leaf);
+    --leafCount_;
+}
+
+void DynamicAabbTree::moveProxy(uint32_t leaf, const Aabb& aabb)
+{
+    REBEL_ASSERT(leaf < nodes_.size() && nodes_[leaf].height == 0, "not a tree leaf");
+    if (leaf != root_ && overlaps(nodes_[leaf].aabb, aabb)) {
+        // Small move: keep the leaf where it is and refit its ancestors.
+        nodes_[leaf].aabb = aabb;
+        refitUpwards(nodes_[leaf].parent);
+        return;
+    }
+    removeLeaf(leaf);
+    nodes_[leaf].aabb = aabb;
+    insertLeaf(leaf);
+}
+
+void DynamicAabbTree::insertLeaf(uint32_t leaf)
+{
+    if (root_ == kNullNode) {
+        root_ = leaf;
+        nodes_[leaf].parent = kNullNode;
+        return;
+    }
+
+    // Descend towards the sibling with the lowest surface-area cost. Every
+    // ancestor of the new leaf grows by the "inherited" cost.
+    const Aabb box = nodes_[leaf].aabb;
+    uint32_t index = root_;
+    while (!nodes_[index].leaf()) {
+        const Node& node = nodes_[index];
+        const float area = node.aabb.area();
+        const float combined = merge(node.aabb, box).area();
+        const float cost = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+
+        auto childCost = [&](uint32_t child) {
+            const Node& c = nodes_[child];
+            const float merged = merge(c.aabb, box).area();
+            return (c.leaf() ? merged : merged - c.aabb.area()) + inherited;
+        };
+        const float cost1 = childCost(node.child1);
+        const float cost2 = childCost(node.child2);
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const uint32_t sibling = index;
+    const uint32_t oldParent = nodes_[sibling].parent;
+    const uint32_t newParent = allocateNode();
+    Node& parent = nodes_[newParent];
+    parent.parent = oldParent;
+    parent.aabb = merge(box, nodes_[sibling].aabb);
+    parent.height = nodes_[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+
+    if (oldParent == kNullNode) {
+        root_ = newParent;
+    } else if (nodes_[oldParent].child1 == sibling) {
+        nodes_[oldParent].child1 = newParent;
+    } else {
+        nodes_[oldParent].child2 = newParent;
+    }
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    refitUpwards(newParent);
+}
+
+void DynamicAabbTree::removeLeaf(uint32_t leaf)
+{
+    if (leaf == root_) {
+        root_ = kNullNode;
+        return;
+    }
+
+    const uint32_t parent = nodes_[leaf].parent;
+    const uint32_t grandParent = nodes_[parent].parent;
+    const uint32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent == kNullNode) {
+        root_ = sibling;
+        nodes_[sibling].parent = kNullNode;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes_[grandParent].child1 == parent)
+        nodes_[grandParent].child1 = sibling;
+    else
+        nodes_[grandParent].child2 = sibling;
+    nodes_[sibling].parent = grandParent;
+    freeNode(parent);
+    refitUpwards(grandParent);
+}
+
+void DynamicAabbTree::refitUpwards(uint32_t index)
+{
+    while (index != kNullNode) {
+        Node& node = nodes_[index];
+        const Node& c1 = nodes_[node.child1];
+        const Node& c2 = nodes_[node.child2];
+        node.aabb = merge(c1.aabb, c2.aabb);
+        node.height = 1 + std::max(c1.height, c2.height);
+        rotate(index);
+        index = nodes_[index].parent;
+    }
+}
+
+void DynamicAabbTree::rotate(uint32_t a)
+{
+    Node& A = nodes_[a];
+    if (A.height < 2)
+        return;
+
+    const uint32_t b = A.child1, c = A.child2;
+    const Node& B = nodes_[b];
+    const Node& C = nodes_[c];
+
+    // Candidate swaps of one child of A with a grandchild under the other
+    // child. Only the subtree receiving the child changes area; keep the
+    // swap that shrinks it the most.
+    enum class Swap { None, BF, BG, CD, CE };
+    Swap best = Swap::None;
+    float bestGain = 0.0f;
+    auto consider = [&](Swap swap, float gain) {
+        if (gain > bestGain) {
+            bestGain = gain;
+            best = swap;
+        }
+    };
+    if (!C.leaf()) {
+        const float areaC = C.aabb.area();
+        consider(Swap::BF, areaC - merge(B.aabb, nodes_[C.child2].aabb).area());
+        consider(Swap::BG, areaC - merge(B.aabb, nodes_[C.child1].aabb).area());
+    }
+    if (!B.leaf()) {
+        const float areaB = B.aabb.area();
+        consider(Swap::CD, areaB - merge(C.aabb, nodes_[B.child2].aabb).area());
+        consider(Swap::CE, areaB - merge(C.aabb, nodes_[B.child1].aabb).area());
+    }
+    if (best == Swap::None)
+        return;
+
+    // Swaps child `x` of A with grandchild `y`, a child of `s` (the other
+    // child of A), then refits `s`.
+    auto swapWithGrandchild = [&](uint32_t x, uint32_t s, uint32_t y) {
+        Node& S = nodes_[s];
+        if (A.child1 == x)
+            A.child1 = y;
+        else
+            A.child2 = y;
+        if (S.child1 == y)
+            S.child1 = x;
+        else
+            S.child2 = x;
+        nodes_[y].parent = a;
+        nodes_[x].parent = s;
+        S.aabb = merge(nodes_[S.child1].aabb, nodes_[S.child2].aabb);
+        S.height = 1 + std::max(nodes_[S.child1].height, nodes_[S.child2].height);
+    };
+    switch (best) {
+    case Swap::BF:
+        swapWithGrandchild(b, c, C.child1);
+        break;
+    case Swap::BG:
+        swapWithGrandchild(b, c, C.child2);
+        break;
+    case Swap::CD:
+        swapWithGrandchild(c, b, B.child1);
+        break;
+    case Swap::CE:
+        swapWithGrandchild(c, b, B.child2);
+        break;
+    case Swap::None:
+        break;
+    }
+    A.height = 1 + std::max(nodes_[A.child1].height, nodes_[A.child2].height);
+}
+
+void DynamicAabbTree::saveState(StateWriter& out) const
+{
+    out.array(nodes_);
+    out.value(root_);
+    out.value(freeList_);
+    out.value(leafCount_);
+}
+
+void DynamicAabbTree::loadState(StateReader& in)
+{
+    in.array(nodes_);
+    in.value(root_);
+    in.value(freeList_);
+    in.value(leafCount_);
+}
+
+float DynamicAabbTree::areaRatio() const
+{
+    if (root_ == kNullNode)
+        return 0.0f;
+    float total = 0.0f;
+    for (const Node& node : nodes_) {
+        if (node.height > 0)
+            total += node.aabb.area();
+    }
+    return total / nodes_[root_].aabb.area();
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "core/assert.h"
+#include "physics/aabb.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::physics {
+
+class StateReader;
+class StateWriter;
+
+inline constexpr uint32_t kNullNode = ~0u;
+
+/// Dynamic AABB tree (bounding volume hierarchy) over fat leaf boxes.
+///
+/// Leaves are inserted at the sibling chosen by a surface-area cost descent.
+/// Moving a leaf whose new box still overlaps the old one refits its
+/// ancestors in place; a leaf that jumped away is reinserted. Every node
+/// touched on the way up is offered a tree rotation (swap of a child with a
+/// grandchild) when that lowers the surface area, which keeps the tree
+/// balanced without global rebuilds.
+///
+/// Not thread-safe for modification; queries may run concurrently with each
+/// other.
+class DynamicAabbTree {
+public:
+    /// Returns the leaf node id.
+    uint32_t createProxy(const Aabb& aabb, uint32_t userData);
+    void destroyProxy(uint32_t leaf);
+    /// Replaces the leaf's box.
+    void moveProxy(uint32_t leaf, const Aabb& aabb);
+
+    const Aabb& aabb(uint32_t node) const { return nodes_[node].aabb; }
+    uint32_t userData(uint32_t leaf) const { return nodes_[leaf].userData; }
+    uint32_t root() const { return root_; }
+    uint32_t leafCount() const { return leafCount_; }
+    int32_t height() const { return root_ == kNullNode ? 0 : nodes_[root_].height; }
+    /// Sum of internal node areas over the root area; lower is better.
+    float areaRatio() const;
+
+    /// Snapshot support: the node pool as it is, so restoring gives back the
+    /// exact same tree.
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
+    /// Calls fn(userData) for every leaf overlapping `box`; fn returns false
+    /// to stop early.
+    template <typename Fn>
+    void query(const Aabb& box, Fn&& fn) const
+    {
+        if (root_ == kNullNode)
+            return;
+        Stack stack;
+        stack.push(root_);
+        while (!stack.empty()) {
+            const Node& node = nodes_[stack.pop()];
+            if (!overlaps(node.aabb, box))
+                continue;
+            if (node.leaf()) {
+                if (!fn(node.userData))
+                    return;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    struct Node {
+        Aabb aabb;
+        uint32_t parent = kNullNode; // next free node while on the free list
+        uint32_t child1 = kNullNode;
+        uint32_t child2 = kNullNode;
+        uint32_t userData = 0;
+        int32_t height = -1; // 0 for leaves, -1 while free
+
+        bool leaf() const { return child1 == kNullNode; }
+    };
+
+    const Node& node(uint32_t id) const { return nodes_[id]; }
+
+    /// Fixed-size traversal stack that spills to the heap for deep trees.
+    class Stack {
+    public:
+        bool empty() const { return count_ == 0; }
+        void push(uint32_t node)
+        {
+            if (count_ < kInline)
+                inline_[count_] = node;
+            else
+                spill_.push_back(node);
+            ++count_;
+        }
+        uint32_t pop()
+        {
+            --count_;
+            if (count_ < kInline)
+                return inline_[count_];
+            const uint32_t node = spill_.back();
+            spill_.pop_back();
+            return node;
+        }
+
+    private:
+        static constexpr uint32_t kInline = 128;
+        uint32_t inline_[kInline];
+        uint32_t count_ = 0;
+        std::vector<uint32_t> spill_;
+    };
+
+private:
+    uint32_t allocateNode();
+    void freeNode(uint32_t node);
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    /// Refits and rotates from `node` up to the root.
+    void refitUpwards(uint32_t node);
+    void rotate(uint32_t node);
+
+    std::vector<Node> nodes_;
+    uint32_t root_ = kNullNode;
+    uint32_t freeList_ = kNullNode;
+    uint32_t leafCount_ = 0;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,136 @@
+#include "physics/broadphase/pair_cache.h"
+
+#include "core/assert.h"
+#include "physics/state_buffer.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace rebel::physics {
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "pair slots are saved as raw keys");
+
+PairCache::PairCache(uint32_t capacity)
+{
+    minCapacity_ = std::bit_ceil(std::max(capacity, 16u));
+    rehash(minCapacity_);
+}
+
+PairCache::AddResult PairCache::add(uint64_t key)
+{
+    REBEL_ASSERT(live(key), "pair key collides with a sentinel");
+    uint32_t i = home(key);
+    for (uint32_t probe = 0; probe < kMaxProbes && probe <= mask_; ++probe, i = (i + 1) & mask_) {
+        uint64_t current = slots_[i].load(std::memory_order_acquire);
+        if (current == key)
+            return AddResult::Exists;
+        if (current != kEmpty)
+            continue; // live key or tombstone: tombstones are only reused by rehash
+        if (slots_[i].compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+            size_.fetch_add(1, std::memory_order_relaxed);
+            return AddResult::Added;
+        }
+        if (current == key)
+            return AddResult::Exists; // another job inserted the same pair
+    }
+    return AddResult::Full;
+}
+
+bool PairCache::remove(uint64_t key)
+{
+    uint32_t i = home(key);
+    for (uint32_t probe = 0; probe < kMaxProbes && probe <= mask_; ++probe, i = (i + 1) & mask_) {
+        uint64_t current = slots_[i].load(std::memory_order_acquire);
+        if (current == kEmpty)
+            return false;
+        if (current == key) {
+            if (!slots_[i].compare_exchange_strong(current, kTombstone, std::memory_order_acq_rel))
+                return false;
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            tombstones_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PairCache::contains(uint64_t key) const
+{
+    uint32_t i = home(key);
+    for (uint32_t probe = 0; probe < kMaxProbes && probe <= mask_; ++probe, i = (i + 1) & mask_) {
+        const uint64_t current = slots_[i].load(std::memory_order_acquire);
+        if (current == key)
+            return true;
+        if (current == kEmpty)
+            return false;
+    }
+    return false;
+}
+
+void PairCache::reserve(uint32_t count)
+{
+    const uint32_t needed = std::bit_ceil(std::max(count, 8u) * 2);
+    if (needed > capacity())
+        rehash(needed);
+}
+
+void PairCache::compact()
+{
+    // Shrink after bursts (level loads) so scans stay proportional to the
+    // live pair count; otherwise rehash in place once tombstones pile up.
+    const uint32_t live = size();
+    if (capacity() > minCapacity_ && live * 8 < capacity())
+        rehash(std::max(minCapacity_, std::bit_ceil(std::max(live, 8u) * 2)));
+    else if (tombstones_.load(std::memory_order_relaxed) > capacity() / 8)
+        rehash(capacity());
+}
+
+void PairCache::clear()
+{
+    for (uint32_t i = 0; i <= mask_; ++i)
+        slots_[i].store(kEmpty, std::memory_order_relaxed);
+    size_.store(0, std::memory_order_relaxed);
+    tombstones_.store(0, std::memory_order_relaxed);
+}
+
+void PairCache::saveState(StateWriter& out) const
+{
+    out.value(mask_);
+    out.value(size());
+    out.value(tombstones_.load(std::memory_order_relaxed));
+    out.bytes(slots_.get(), capacity() * sizeof(uint64_t));
+}
+
+void PairCache::loadState(StateReader& in)
+{
+    uint32_t mask = 0, size = 0, tombstones = 0;
+    in.value(mask);
+    in.value(size);
+    in.value(tombstones);
+    if (mask != mask_) {
+        slots_ = std::make_unique<std::atomic<uint64_t>[]>(mask + 1);
+        mask_ = mask;
+    }
+    in.bytes(slots_.get(), capacity() * sizeof(uint64_t));
+    size_.store(size, std::memory_order_relaxed);
+    tombstones_.store(tombstones, std::memory_order_relaxed);
+}
+
+void PairCache::rehash(uint32_t capacity)
+{
+    std::vector<uint64_t> keys;
+    keys.reserve(size());
+    if (slots_)
+        forEach([&](uint64_t key) { keys.push_back(key); });
+
+    slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity);
+    mask_ = capacity - 1;
+    clear();
+    for (const uint64_t key : keys) {
+        [[maybe_unused]] const AddResult result = add(key);
+        REBEL_ASSERT(result == AddResult::Added, "pair cache rehash overflow");
+    }
+}
+
+} // namespace rebel::physics
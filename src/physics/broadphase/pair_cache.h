@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace rebel::physics {
+
+class StateReader;
+class StateWriter;
+
+/// Canonical key of an unordered proxy pair: smaller id in the high half.
+inline uint64_t pairKey(uint32_t a, uint32_t b)
+{
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+inline uint32_t pairFirst(uint64_t key) { return uint32_t(key >> 32); }
+inline uint32_t pairSecond(uint64_t key) { return uint32_t(key); }
+
+/// Lock-free set of overlapping proxy pairs.
+///
+/// Open addressing with linear probing over 64-bit keys. add(), remove()
+/// and contains() may run concurrently from any number of jobs; inserts
+/// claim empty slots by CAS and removals leave tombstones, so a probe
+/// sequence is never broken while others walk it. Growing and purging
+/// tombstones (reserve(), compact()) happen between parallel phases.
+class PairCache {
+public:
+    enum class AddResult : uint8_t {
+        Added,
+        Exists,
+        Full, // no free slot within the probe limit; retry after reserve()
+    };
+
+    explicit PairCache(uint32_t capacity = 1024);
+
+    PairCache(const PairCache&) = delete;
+    PairCache& operator=(const PairCache&) = delete;
+
+    AddResult add(uint64_t key);
+    bool remove(uint64_t key);
+    bool contains(uint64_t key) const;
+
+    uint32_t size() const { return size_.load(std::memory_order_relaxed); }
+    uint32_t capacity() const { return mask_ + 1; }
+
+    /// Makes room for `count` live pairs at no more than half load. Not
+    /// thread-safe.
+    void reserve(uint32_t count);
+    /// Rehashes when tombstones make up a large share of the table, or
+    /// shrinks it when mostly empty. Not thread-safe.
+    void compact();
+    void clear();
+
+    /// Snapshot support (see PhysicsWorld::saveState). Not thread-safe.
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
+    /// Raw slot access for parallel scans: slot(i) is a key when live(i).
+    uint64_t slot(uint32_t i) const { return slots_[i].load(std::memory_order_relaxed); }
+    static bool live(uint64_t slotValue) { return slotValue < kTombstone; }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const
+    {
+        for (uint32_t i = 0; i <= mask_; ++i) {
+            const uint64_t key = slots_[i].load(std::memory_order_relaxed);
+            if (live(key))
+                fn(key);
+        }
+    }
+
+private:
+    static constexpr uint64_t kEmpty = ~uint64_t(0);
+    static constexpr uint64_t kTombstone = ~uint64_t(0) - 1;
+    static constexpr uint32_t kMaxProbes = 128;
+
+    uint32_t home(uint64_t key) const
+    {
+        // Fibonacci hashing of the mixed key.
+        return uint32_t(((key ^ (key >> 29)) * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+    }
+    void rehash(uint32_t capacity);
+
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    uint32_t mask_ = 0;
+    uint32_t minCapacity_ = 16;
+    std::atomic<uint32_t> size_{0};
+    std::atomic<uint32_t> tombstones_{0};
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,205 @@
+#include "physics/broadphase/sweep_and_prune.h"
+
+#include "core/assert.h"
+#include "physics/state_buffer.h"
+
+#include <algorithm>
+
+namespace rebel::physics {
+
+namespace {
+
+inline float axisValue(const math::Vec3& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+} // namespace
+
+void SweepAndPrune::overlapBegins(uint32_t a, uint32_t b, PairCache& pairs, uint32_t& added)
+{
+    if (!overlaps(handles_[a].box, handles_[b].box))
+        return;
+    const PairCache::AddResult result = pairs.add(pairKey(a, b));
+    if (result == PairCache::AddResult::Full) {
+        pairs.reserve(pairs.size() + 1);
+        pairs.add(pairKey(a, b));
+        ++added;
+    } else if (result == PairCache::AddResult::Added) {
+        ++added;
+    }
+}
+
+void SweepAndPrune::overlapEnds(uint32_t a, uint32_t b, PairCache& pairs, uint32_t& removed)
+{
+    if (pairs.remove(pairKey(a, b)))
+        ++removed;
+}
+
+void SweepAndPrune::sortDown(int axis, uint32_t index, PairCache& pairs, uint32_t& added, uint32_t& removed)
+{
+    std::vector<Edge>& edges = edges_[axis];
+    const Edge edge = edges[index];
+    while (index > 0 && edges[index - 1].value > edge.value) {
+        const Edge prev = edges[index - 1];
+        if (!edge.isMax && prev.isMax)
+            overlapBegins(edge.proxy, prev.proxy, pairs, added); // our min passed their max
+        else if (edge.isMax && !prev.isMax)
+            overlapEnds(edge.proxy, prev.proxy, pairs, removed); // our max passed their min
+        edges[index] = prev;
+        handles_[prev.proxy].edge[axis][prev.isMax] = index;
+        --index;
+    }
+    edges[index] = edge;
+    handles_[edge.proxy].edge[axis][edge.isMax] = index;
+}
+
+void SweepAndPrune::sortUp(int axis, uint32_t index, PairCache& pairs, uint32_t& added, uint32_t& removed)
+{
+    std::vector<Edge>& edges = edges_[axis];
+    const Edge edge = edges[index];
+    const uint32_t last = uint32_t(edges.size()) - 1;
+    while (index < last && edges[index + 1].value < edge.value) {
+        const Edge next = edges[index + 1];
+        if (!edge.isMax && next.isMax)
+            overlapEnds(edge.proxy, next.proxy, pairs, removed); // our min passed their max
+        else if (edge.isMax && !next.isMax)
+            overlapBegins(edge.proxy, next.proxy, pairs, added); // our max passed their min
+        edges[index] = next;
+        handles_[next.proxy].edge[axis][next.isMax] = index;
+        ++index;
+    }
+    edges[index] = edge;
+    handles_[edge.proxy].edge[axis][edge.isMax] = index;
+}
+
+void SweepAndPrune::addProxy(uint32_t proxy, const Aabb& aabb, PairCache& pairs, uint32_t& added)
+{
+    if (handles_.size() <= proxy)
+        handles_.resize(proxy + 1);
+    Handle& handle = handles_[proxy];
+    REBEL_ASSERT(!handle.active, "proxy already in the sweep");
+    handle.box = aabb;
+    handle.active = true;
+
+    uint32_t removed = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Edge>& edges = edges_[axis];
+        const uint32_t minIndex = uint32_t(edges.size());
+        edges.push_back({axisValue(aabb.min, axis), proxy, 0});
+        edges.push_back({axisValue(aabb.max, axis), proxy, 1});
+        handle.edge[axis][0] = minIndex;
+        handle.edge[axis][1] = minIndex + 1;
+        // The min sinks past every max above it (overlap candidates); the
+        // max then only passes mins, which cannot hold pairs yet.
+        sortDown(axis, minIndex, pairs, added, removed);
+        sortDown(axis, minIndex + 1, pairs, added, removed);
+    }
+}
+
+void SweepAndPrune::removeProxy(uint32_t proxy)
+{
+    Handle& handle = handles_[proxy];
+    REBEL_ASSERT(handle.active, "proxy not in the sweep");
+    handle.active = false;
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Edge>& edges = edges_[axis];
+        const uint32_t first = handle.edge[axis][0];
+        const uint32_t second = handle.edge[axis][1];
+        // Compact the axis, skipping both endpoints, and fix moved indices.
+        uint32_t write = first;
+        for (uint32_t read = first + 1; read < edges.size(); ++read) {
+            if (read == second)
+                continue;
+            edges[write] = edges[read];
+            handles_[edges[write].proxy].edge[axis][edges[write].isMax] = write;
+            ++write;
+        }
+        edges.resize(edges.size() - 2);
+    }
+}
+
+void SweepAndPrune::moveProxy(uint32_t proxy, const Aabb& aabb, PairCache& pairs, uint32_t& added,
+                              uint32_t& removed)
+{
+    Handle& handle = handles_[proxy];
+    const Aabb old = handle.box;
+    handle.box = aabb;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float oldMin = axisValue(old.min, axis), newMin = axisValue(aabb.min, axis);
+        const float oldMax = axisValue(old.max, axis), newMax = axisValue(aabb.max, axis);
+        edges_[axis][handles_[proxy].edge[axis][0]].value = newMin;
+        edges_[axis][handles_[proxy].edge[axis][1]].value = newMax;
+        // Grow first, then shrink, so min and max never cross.
+        if (newMin < oldMin)
+            sortDown(axis, handles_[proxy].edge[axis][0], pairs, added, removed);
+        if (newMax > oldMax)
+            sortUp(axis, handles_[proxy].edge[axis][1], pairs, added, removed);
+        if (newMin > oldMin)
+            sortUp(axis, handles_[proxy].edge[axis][0], pairs, added, removed);
+        if (newMax < oldMax)
+            sortDown(axis, handles_[proxy].edge[axis][1], pairs, added, removed);
+    }
+}
+
+void SweepAndPrune::rebuild(std::span<const uint32_t> newProxies, std::span<const Aabb> newBoxes, PairCache& pairs,
+                            uint32_t& added)
+{
+    for (std::size_t i = 0; i < newProxies.size(); ++i) {
+        const uint32_t proxy = newProxies[i];
+        if (handles_.size() <= proxy)
+            handles_.resize(proxy + 1);
+        REBEL_ASSERT(!handles_[proxy].active, "proxy already in the sweep");
+        handles_[proxy].box = newBoxes[i];
+        handles_[proxy].active = true;
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Edge>& edges = edges_[axis];
+        edges.clear();
+        for (uint32_t p = 0; p < handles_.size(); ++p) {
+            if (!handles_[p].active)
+                continue;
+            edges.push_back({axisValue(handles_[p].box.min, axis), p, 0});
+            edges.push_back({axisValue(handles_[p].box.max, axis), p, 1});
+        }
+        // Min before max on ties, matching the inclusive overlap test.
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+            return a.value < b.value || (a.value == b.value && a.isMax < b.isMax);
+        });
+        for (uint32_t i = 0; i < edges.size(); ++i)
+            handles_[edges[i].proxy].edge[axis][edges[i].isMax] = i;
+    }
+
+    // Sweep x with an active list; y/z are checked per candidate.
+    active_.clear();
+    for (const Edge& edge : edges_[0]) {
+        if (edge.isMax) {
+            const auto it = std::find(active_.begin(), active_.end(), uint32_t(edge.proxy));
+            *it = active_.back();
+            active_.pop_back();
+            continue;
+        }
+        for (const uint32_t other : active_)
+            overlapBegins(edge.proxy, other, pairs, added);
+        active_.push_back(edge.proxy);
+    }
+}
+
+void SweepAndPrune::saveState(StateWriter& out) const
+{
+    out.array(handles_);
+    for (const std::vector<Edge>& edges : edges_)
+        out.array(edges);
+    out.array(active_);
+}
+
+void SweepAndPrune::loadState(StateReader& in)
+{
+    in.array(handles_);
+    for (std::vector<Edge>& edges : edges_)
+        in.array(edges);
+    in.array(active_);
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "physics/aabb.h"
+#include "physics/broadphase/pair_cache.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::physics {
+
+class StateReader;
+class StateWriter;
+
+/// Incremental multi-axis sweep and prune.
+///
+/// Box endpoints are kept sorted on all three axes. A moved box re-sorts its
+/// endpoints by insertion sort, and every swap of a min with a max endpoint
+/// is a potential overlap change: the pair is tested in 3D and added to or
+/// removed from the pair cache. Thanks to temporal coherence the cost is
+/// proportional to the number of swaps, i.e. to how far things moved, not to
+/// the number of boxes. Large batches of insertions use rebuild() instead.
+///
+/// Proxy ids are assigned by the caller (Broadphase) and index a dense
+/// array. Single-threaded.
+class SweepAndPrune {
+public:
+    /// Inserts one box, adding its overlaps to `pairs`. O(n) per call.
+    void addProxy(uint32_t proxy, const Aabb& aabb, PairCache& pairs, uint32_t& added);
+    /// Removes a box's endpoints. Its pairs are left for the caller to purge.
+    void removeProxy(uint32_t proxy);
+    void moveProxy(uint32_t proxy, const Aabb& aabb, PairCache& pairs, uint32_t& added, uint32_t& removed);
+
+    /// Re-sorts every axis from scratch (after large batches of insertions)
+    /// and re-adds all overlapping pairs by a sweep along x.
+    void rebuild(std::span<const uint32_t> newProxies, std::span<const Aabb> newBoxes, PairCache& pairs,
+                 uint32_t& added);
+
+    uint32_t proxyCount() const { return uint32_t(edges_[0].size() / 2); }
+
+    /// Snapshot support: handles and sorted endpoint arrays as they are.
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
+private:
+    struct Edge {
+        float value;
+        uint32_t proxy : 31;
+        uint32_t isMax : 1;
+    };
+    struct Handle {
+        Aabb box;
+        uint32_t edge[3][2]; // [axis][0 = min, 1 = max] index into edges_
+        bool active = false;
+    };
+
+    void sortDown(int axis, uint32_t index, PairCache& pairs, uint32_t& added, uint32_t& removed);
+    void sortUp(int axis, uint32_t index, PairCache& pairs, uint32_t& added, uint32_t& removed);
+    void overlapBegins(uint32_t a, uint32_t b, PairCache& pairs, uint32_t& added);
+    void overlapEnds(uint32_t a, uint32_t b, PairCache& pairs, uint32_t& removed);
+
+    std::vector<Handle> handles_;
+    std::vector<Edge> edges_[3];
+    std::vector<uint32_t> active_;
+};
+
+} // namespace rebel::physics
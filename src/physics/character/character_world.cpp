@@ -0,0 +1,474 @@
+#include "physics/character/character_world.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "physics/collision/gjk.h"
+#include "physics/collision/segments.h"
+#include "physics/collision/triangles.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kCharactersPerJob = 64;
+// Rounds of projections per solve; two or three planes settle in a few.
+constexpr uint32_t kSolverRounds = 4;
+// Moves and leftovers shorter than this are done with.
+constexpr float kMinMove = 1e-4f;
+// How far past the skin width a walkable plane still holds the character.
+constexpr float kGroundTolerance = 0.01f;
+constexpr float kSlack = 1e-6f;
+constexpr Vec3 kUp{0.0f, 1.0f, 0.0f};
+
+struct Collider {
+    const Body* body;
+    uint32_t slot;
+    Aabb bounds;
+};
+
+struct Colliders {
+    Collider collider[CharacterWorld::kMaxColliders];
+    uint32_t count = 0;
+    uint32_t dropped = 0;
+};
+
+// Keeps a move x, taken from where the plane was gathered, to
+// dot(x, normal) >= offset: the skin width less the gap there.
+struct Plane {
+    Vec3 normal;
+    float offset;
+    float distance; // gap where gathered
+    uint32_t body;  // slot
+    bool walkable;
+};
+
+struct Planes {
+    Plane plane[CharacterWorld::kMaxPlanes];
+    uint32_t count = 0;
+    uint32_t dropped = 0;
+};
+
+// What one gather needs to know about the character.
+struct Probe {
+    const Shape& shape;
+    float walkable;
+    float skinWidth;
+};
+
+float horizontalLength(Vec3 v) { return std::sqrt(v.x * v.x + v.z * v.z); }
+
+void push(Planes& planes, const Plane& plane)
+{
+    if (planes.count < CharacterWorld::kMaxPlanes) {
+        planes.plane[planes.count++] = plane;
+        return;
+    }
+    // Full: the nearest planes matter most.
+    ++planes.dropped;
+    Plane* farthest = std::max_element(planes.plane, planes.plane + planes.count,
+                                       [](const Plane& a, const Plane& b) { return a.distance < b.distance; });
+    if (plane.distance < farthest->distance)
+        *farthest = plane;
+}
+
+void addPlane(Planes& planes, const Probe& probe, Vec3 normal, float distance, uint32_t body)
+{
+    const float offset = probe.skinWidth - distance;
+    push(planes, {normal, offset, distance, body, normal.y >= probe.walkable});
+    // Too steep to stand on but facing up: also a wall, so walking into it
+    // does not climb it. A horizontal move meets it where the plane would;
+    // pushing out of the skin is left to the plane itself.
+    const float horizontal = horizontalLength(normal);
+    if (normal.y > 0.0f && normal.y < probe.walkable && horizontal > 1e-3f) {
+        const float wall = std::min(offset, 0.0f) / horizontal;
+        push(planes, {Vec3{normal.x, 0.0f, normal.z} * (1.0f / horizontal), wall, distance, body, false});
+    }
+}
+
+// Inside the prism over the triangle, for a point on its plane.
+bool overTriangle(const Vec3* v, Vec3 face, Vec3 p)
+{
+    return math::dot(math::cross(v[1] - v[0], p - v[0]), face) >= 0.0f &&
+           math::dot(math::cross(v[2] - v[1], p - v[1]), face) >= 0.0f &&
+           math::dot(math::cross(v[0] - v[2], p - v[2]), face) >= 0.0f;
+}
+
+// Squared horizontal distance from `p` to the triangle's footprint on the
+// ground, which no point straight above or below `p` gets closer than.
+float footprintDistanceSquared(const Vec3* v, Vec3 p)
+{
+    const float winding = (v[1].x - v[0].x) * (v[2].z - v[0].z) - (v[1].z - v[0].z) * (v[2].x - v[0].x);
+    float nearest = 0.0f;
+    for (uint32_t e = 0; e < 3; ++e) {
+        const Vec3 a = v[e], b = v[e == 2 ? 0 : e + 1];
+        const float ex = b.x - a.x, ez = b.z - a.z, rx = p.x - a.x, rz = p.z - a.z;
+        if ((ex * rz - ez * rx) * winding >= 0.0f)
+            continue;
+        const float length2 = ex * ex + ez * ez;
+        const float t = length2 > 1e-12f ? std::clamp((rx * ex + rz * ez) / length2, 0.0f, 1.0f) : 0.0f;
+        const float dx = rx - ex * t, dz = rz - ez * t;
+        const float d2 = dx * dx + dz * dz;
+        nearest = nearest == 0.0f ? d2 : std::min(nearest, d2);
+    }
+    return nearest;
+}
+
+// Whether a plane this far away, facing this way, can stop a move of up to
+// `reach`, or a drop of `down` more.
+bool withinReach(Vec3 normal, float distance, float reach, float down)
+{
+    return distance <= reach + down * std::max(normal.y, 0.0f);
+}
+
+// Gap from a triangle to the upright capsule's segment, the normal facing
+// the capsule. When the segment end nearest the plane lies over the
+// triangle, or the segment pierces it, the face is the answer; otherwise
+// the nearer of the ends against the triangle and the segment against the
+// edges.
+bool triangleGap(const Vec3* v, const Segment& segment, float radius, float reach, float down, Vec3& normal,
+                 float& distance)
+{
+    const float horizontal = radius + reach;
+    if (footprintDistanceSquared(v, segment.a) > horizontal * horizontal)
+        return false;
+    const Vec3 face = math::cross(v[1] - v[0], v[2] - v[0]);
+    const float area = math::length(face);
+    if (area < 1e-12f)
+        return false;
+    Vec3 n = face * (1.0f / area);
+    if (math::dot((segment.a + segment.b) * 0.5f - v[0], n) < 0.0f)
+        n = -n;
+    const float heightA = math::dot(segment.a - v[0], n);
+    const float heightB = math::dot(segment.b - v[0], n);
+    const float nearest = std::min(heightA, heightB);
+    if (nearest - radius > reach + down)
+        return false;
+    const bool pierced = heightA * heightB < 0.0f &&
+                         overTriangle(v, face, math::lerp(segment.a, segment.b, heightA / (heightA - heightB)));
+    if (pierced || overTriangle(v, face, (heightA < heightB ? segment.a : segment.b) - n * nearest)) {
+        normal = n;
+        distance = nearest - radius;
+        return withinReach(normal, distance, reach, down);
+    }
+
+    // The end nearer the plane against the triangle, and the other end only
+    // if its plane distance leaves it a chance.
+    const bool bottomNearer = heightA <= heightB;
+    Vec3 p = bottomNearer ? segment.a : segment.b;
+    Vec3 q = closestOnTriangle(v, p);
+    float best = math::lengthSquared(p - q);
+    const float farther = std::max(heightA, heightB);
+    if (farther * farther < best) {
+        const Vec3 end = bottomNearer ? segment.b : segment.a;
+        const Vec3 onTriangle = closestOnTriangle(v, end);
+        if (math::lengthSquared(end - onTriangle) < best) {
+            p = end;
+            q = onTriangle;
+            best = math::lengthSquared(p - q);
+        }
+    }
+    // Between the ends the nearest points are level: where an edge passes
+    // closest to the axis, if that is within the segment's height.
+    const Vec3 axis = segment.a;
+    for (uint32_t e = 0; e < 3; ++e) {
+        const Vec3 a = v[e], d = v[e == 2 ? 0 : e + 1] - a;
+        const float length2 = d.x * d.x + d.z * d.z;
+        if (length2 < 1e-12f)
+            continue;
+        const float t = std::clamp(((axis.x - a.x) * d.x + (axis.z - a.z) * d.z) / length2, 0.0f, 1.0f);
+        const Vec3 onEdge = a + d * t;
+        if (onEdge.y <= segment.a.y || onEdge.y >= segment.b.y)
+            continue;
+        const float dx = axis.x - onEdge.x, dz = axis.z - onEdge.z;
+        if (dx * dx + dz * dz < best) {
+            p = {axis.x, onEdge.y, axis.z};
+            q = onEdge;
+            best = dx * dx + dz * dz;
+        }
+    }
+    const float gap = std::sqrt(best);
+    normal = gap > 1e-6f ? (p - q) * (1.0f / gap) : n;
+    distance = gap - radius;
+    return withinReach(normal, distance, reach, down);
+}
+
+// Planes of every collider within `reach` of the capsule at `position`,
+// plus `down` more below it for snapping.
+void gather(const Colliders& colliders, const Probe& probe, Vec3 position, float reach, float down, Planes& planes)
+{
+    planes.count = 0;
+    const Transform transform{position, {}};
+    const ConvexCore core(probe.shape, transform);
+    const Segment segment{position - kUp * probe.shape.halfHeight, position + kUp * probe.shape.halfHeight};
+    Aabb box = computeAabb(probe.shape, transform).expanded(reach);
+    box.min.y -= down;
+    for (uint32_t i = 0; i < colliders.count; ++i) {
+        const Collider& collider = colliders.collider[i];
+        if (!overlaps(box, collider.bounds))
+            continue;
+        const Body& body = *collider.body;
+        if (isTriangleShape(body.shape.type)) {
+            forEachTriangle(body.shape, body.transform, box, [&](uint32_t, const Vec3* v) {
+                Vec3 normal;
+                float distance;
+                if (triangleGap(v, segment, core.radius, reach, down, normal, distance))
+                    addPlane(planes, probe, normal, distance, collider.slot);
+            });
+            continue;
+        }
+        const ConvexCore obstacle(body.shape, body.transform);
+        const float rounding = obstacle.radius + core.radius;
+        ClosestPoints closest;
+        if (!closestPoints(obstacle, core, reach + down + rounding, closest) ||
+            !withinReach(closest.normal, closest.distance - rounding, reach, down))
+            continue;
+        addPlane(planes, probe, closest.normal, closest.distance - rounding, collider.slot);
+    }
+}
+
+// Keeps `x` to the plane, as solve() does: walkable ground lifts it
+// straight up, so walking up a slope keeps its horizontal speed, and every
+// other plane pushes it out along the normal.
+void project(const Plane& plane, float gap, Vec3& x)
+{
+    if (plane.walkable)
+        x.y -= gap / plane.normal.y;
+    else
+        x -= plane.normal * gap;
+}
+
+// The move nearest `desired` that keeps to every plane, for planes
+// gathered `from` back along the way.
+Vec3 solve(const Planes& planes, Vec3 desired, Vec3 from)
+{
+    Vec3 x = desired;
+    for (uint32_t round = 0; round < kSolverRounds; ++round) {
+        bool clean = true;
+        for (uint32_t i = 0; i < planes.count; ++i) {
+            const Plane& plane = planes.plane[i];
+            const float gap = math::dot(from + x, plane.normal) - plane.offset;
+            if (gap >= -kSlack)
+                continue;
+            project(plane, gap, x);
+            clean = false;
+        }
+        if (clean)
+            return x;
+    }
+    // Boxed in by planes that undo each other: as much of the last move as
+    // every plane allows. Planes already penetrated still push out.
+    float t = 1.0f;
+    for (uint32_t i = 0; i < planes.count; ++i) {
+        const Plane& plane = planes.plane[i];
+        const float room = plane.offset - math::dot(from, plane.normal);
+        const float along = math::dot(x, plane.normal);
+        if (room <= 0.0f && along < room)
+            t = std::min(t, room / along);
+    }
+    return x * t;
+}
+
+// The walkable plane nearest the character after moving `x`, if it is
+// within the ground tolerance.
+const Plane* groundPlane(const Planes& planes, Vec3 x, float skinWidth)
+{
+    const Plane* ground = nullptr;
+    float nearest = skinWidth + kGroundTolerance;
+    for (uint32_t i = 0; i < planes.count; ++i) {
+        const Plane& plane = planes.plane[i];
+        const float gap = plane.distance + math::dot(x, plane.normal);
+        if (plane.walkable && gap <= nearest) {
+            nearest = gap;
+            ground = &plane;
+        }
+    }
+    return ground;
+}
+
+} // namespace
+
+CharacterWorld::CharacterWorld(const CharacterWorldDesc& desc)
+    : gravity_(desc.gravity)
+    , maxIterations_(std::max(desc.maxIterations, 1u))
+{
+}
+
+CharacterId CharacterWorld::createCharacter(const CharacterDesc& desc)
+{
+    REBEL_ASSERT(desc.radius > 0.0f && desc.halfHeight >= 0.0f, "bad character capsule");
+    REBEL_ASSERT(desc.maxSlope >= 0.0f && desc.maxSlope < 0.5f * math::kPi, "max slope must be below 90 degrees");
+    const CharacterId id = ids_.create();
+    if (id.index == slots_.size())
+        slots_.emplace_back();
+    Slot& slot = slots_[id.index];
+    slot = Slot{};
+    slot.state.position = desc.position;
+    slot.shape = Shape::capsule(desc.radius, desc.halfHeight);
+    slot.walkable = std::cos(desc.maxSlope);
+    slot.stepHeight = desc.stepHeight;
+    slot.snapDistance = desc.snapDistance;
+    slot.skinWidth = desc.skinWidth;
+    return id;
+}
+
+void CharacterWorld::destroyCharacter(CharacterId id)
+{
+    ids_.destroy(id);
+}
+
+const CharacterState& CharacterWorld::state(CharacterId id) const
+{
+    REBEL_ASSERT(valid(id), "stale character");
+    return slots_[id.index].state;
+}
+
+void CharacterWorld::setPosition(CharacterId id, Vec3 position)
+{
+    REBEL_ASSERT(valid(id), "stale character");
+    Slot& slot = slots_[id.index];
+    slot.state = {};
+    slot.state.position = position;
+    slot.verticalSpeed = 0.0f;
+}
+
+void CharacterWorld::move(const PhysicsWorld& world, std::span<const CharacterMove> moves, float dt,
+                          jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(world.broadphase().type() == BroadphaseType::DynamicTree, "characters need a DynamicTree broadphase");
+    jobs.parallelFor(uint32_t(moves.size()), kCharactersPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            REBEL_ASSERT(valid(moves[i].character), "moving a stale character");
+            moveCharacter(slots_[moves[i].character.index], world, moves[i].velocity, dt);
+        }
+    });
+
+    stats_ = {};
+    for (const CharacterMove& m : moves) {
+        const Slot& slot = slots_[m.character.index];
+        ++stats_.moves;
+        stats_.colliders += slot.last.colliders;
+        stats_.planes += slot.last.planes;
+        stats_.passes += slot.last.passes;
+        stats_.grounded += slot.state.grounded;
+        stats_.steps += slot.last.stepped;
+        stats_.snaps += slot.last.snapped;
+        stats_.dropped += slot.last.dropped;
+    }
+}
+
+void CharacterWorld::moveCharacter(Slot& slot, const PhysicsWorld& world, Vec3 velocity, float dt) const
+{
+    CharacterState& state = slot.state;
+    const Vec3 start = state.position;
+    const bool wasGrounded = state.grounded;
+    const float vertical = wasGrounded ? std::max(velocity.y, 0.0f) : slot.verticalSpeed - gravity_ * dt;
+    const Vec3 desired{velocity.x * dt, vertical * dt, velocity.z * dt};
+    const Vec3 walk{desired.x, 0.0f, desired.z};
+    const Probe probe{slot.shape, slot.walkable, slot.skinWidth};
+    // Walkable ground lifts a move by up to tan(maxSlope) of its length.
+    const float stretch = 1.0f / slot.walkable;
+    const float snap = wasGrounded ? slot.snapDistance : 0.0f;
+    slot.last = {};
+
+    // Every body the move, a step up and a snap down could reach, from one
+    // walk of the tree.
+    Colliders colliders;
+    Aabb bounds = computeAabb(slot.shape, {start, {}})
+                      .expanded(math::length(desired) * stretch + slot.skinWidth + kGroundTolerance);
+    bounds.max.y += slot.stepHeight;
+    bounds.min.y -= slot.snapDistance;
+    world.broadphase().tree().query(bounds, [&](uint32_t proxy) {
+        const uint32_t index = world.broadphase().userData(proxy);
+        const Body& body = *world.body(world.bodyId(index));
+        if (colliders.count == kMaxColliders) {
+            ++colliders.dropped;
+            return true;
+        }
+        colliders.collider[colliders.count++] = {&body, index, computeAabb(body.shape, body.transform)};
+        return true;
+    });
+
+    // Collide and slide. Whatever the planes in the way do not account for
+    // is left for another pass from where the move stopped.
+    Planes first, later;
+    Planes* planes = &first;
+    Vec3 position = start, remaining = desired, moved{};
+    for (uint32_t pass = 0; pass < maxIterations_; ++pass) {
+        planes = pass == 0 ? &first : &later;
+        const float reach = math::length(remaining) * stretch + slot.skinWidth + kGroundTolerance;
+        gather(colliders, probe, position, reach, snap, *planes);
+        ++slot.last.passes;
+        slot.last.planes += planes->count;
+        slot.last.dropped += planes->dropped;
+        moved = solve(*planes, remaining, {});
+        position += moved;
+        remaining -= moved;
+        for (uint32_t i = 0; i < planes->count; ++i) {
+            const Plane& plane = planes->plane[i];
+            const float into = math::dot(remaining, plane.normal);
+            if (into < 0.0f && math::dot(moved, plane.normal) - plane.offset <= kMinMove)
+                project(plane, into, remaining);
+        }
+        if (math::lengthSquared(remaining) < kMinMove * kMinMove)
+            break;
+    }
+    const Plane* ground = groundPlane(*planes, moved, slot.skinWidth);
+
+    // Held back by a ledge: try the move again a step higher and drop back
+    // down onto it.
+    Planes raisedPlanes;
+    const float wanted = horizontalLength(walk);
+    const Vec3 heading = wanted > 0.0f ? walk * (1.0f / wanted) : Vec3{};
+    const float walked = math::dot(position - start, heading);
+    if (wasGrounded && slot.stepHeight > 0.0f && wanted - walked > kMinMove) {
+        const Vec3 up = solve(first, {0.0f, slot.stepHeight, 0.0f}, {});
+        if (up.y > kMinMove) {
+            const float reach = wanted * stretch + slot.skinWidth + kGroundTolerance;
+            gather(colliders, probe, start + up, reach, up.y + slot.snapDistance, raisedPlanes);
+            ++slot.last.passes;
+            slot.last.planes += raisedPlanes.count;
+            slot.last.dropped += raisedPlanes.dropped;
+            const Vec3 across = solve(raisedPlanes, walk, {});
+            const Vec3 down = solve(raisedPlanes, {0.0f, -(up.y + slot.snapDistance), 0.0f}, across);
+            const Plane* landing = groundPlane(raisedPlanes, across + down, slot.skinWidth);
+            // Only onto ground, and only if it gets further than walking did.
+            if (landing && math::dot(up + across + down, heading) > walked + kMinMove) {
+                position = start + up + across + down;
+                ground = landing;
+                slot.last.stepped = true;
+            }
+        }
+    }
+
+    // Walked off the ground going down a slope or a kerb: back down onto it.
+    if (!ground && wasGrounded && vertical <= 0.0f) {
+        const Vec3 down = solve(*planes, {0.0f, -slot.snapDistance, 0.0f}, moved);
+        if (const Plane* below = groundPlane(*planes, moved + down, slot.skinWidth)) {
+            position += down;
+            ground = below;
+            slot.last.snapped = true;
+        }
+    }
+
+    const float climbed = (position.y - start.y) / dt;
+    state.position = position;
+    state.velocity = (position - start) * (1.0f / dt);
+    state.grounded = ground != nullptr;
+    state.groundNormal = ground ? ground->normal : kUp;
+    state.ground = ground ? world.bodyId(ground->body) : BodyId{};
+    // Airborne characters keep what is left of their vertical speed after
+    // ceilings and slopes.
+    slot.verticalSpeed = ground ? 0.0f
+                         : vertical > 0.0f ? std::min(vertical, std::max(climbed, 0.0f))
+                                           : std::max(vertical, std::min(climbed, 0.0f));
+    slot.last.colliders = colliders.count;
+    slot.last.dropped += colliders.dropped;
+}
+
+} // namespace rebel::physics
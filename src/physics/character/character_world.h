@@ -0,0 +1,154 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "core/memory/slot_table.h"
+#include "physics/body.h"
+#include "physics/shape.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+class PhysicsWorld;
+
+struct CharacterWorldDesc {
+    /// Downward acceleration while airborne. Up is +Y.
+    float gravity = 9.81f;
+    /// Collide-and-slide passes per move. Further passes only run while a
+    /// move is held back by more than its contact planes explain, as in
+    /// tight corners.
+    uint32_t maxIterations = 3;
+};
+
+struct CharacterDesc {
+    /// Centre of the upright capsule.
+    math::Vec3 position;
+    float radius = 0.4f;
+    float halfHeight = 0.5f; // of the capsule's segment
+    /// Steepest ground the character stands on and walks up, in radians.
+    float maxSlope = 0.785398f; // 45 degrees
+    /// Tallest ledge walked onto without jumping.
+    float stepHeight = 0.35f;
+    /// Walking down slopes and off kerbs up to this far keeps the character
+    /// on the ground instead of launching it.
+    float snapDistance = 0.3f;
+    /// Gap kept between the capsule and everything it touches.
+    float skinWidth = 0.02f;
+};
+
+struct Character;
+using CharacterId = memory::Handle<Character>;
+
+/// One character's move for a batch: the velocity it wants this step. The
+/// horizontal part is walked; while grounded, a positive vertical part
+/// jumps. Airborne characters keep falling whatever they ask for.
+struct CharacterMove {
+    CharacterId character;
+    math::Vec3 velocity;
+};
+
+struct CharacterState {
+    math::Vec3 position;
+    /// Of the last move, as it came out.
+    math::Vec3 velocity;
+    /// Up while airborne.
+    math::Vec3 groundNormal{0.0f, 1.0f, 0.0f};
+    BodyId ground;
+    bool grounded = false;
+};
+
+struct CharacterStats {
+    uint32_t moves = 0;
+    uint32_t colliders = 0;  // bodies near the characters, summed over moves
+    uint32_t planes = 0;     // contact planes gathered, over all passes
+    uint32_t passes = 0;     // narrowphase passes, step-ups included
+    uint32_t grounded = 0;   // characters on the ground after the batch
+    uint32_t steps = 0;      // moves that stepped up a ledge
+    uint32_t snaps = 0;      // moves snapped down to the ground
+    uint32_t dropped = 0;    // colliders or planes over the per-move limits
+};
+
+/// Kinematic capsule characters moved by collide-and-slide against a
+/// PhysicsWorld's bodies.
+///
+/// A batch of moves runs in parallel, one job per batch of characters, and
+/// each move walks the rigid world's broadphase tree once for the bodies
+/// under its swept bounds. Against those it gathers one contact plane per
+/// convex body or triangle within reach: the separating plane at the
+/// closest points (GJK on the capsule's segment, or the triangle's face
+/// when the capsule is over it), which the whole obstacle lies behind.
+/// The move is then solved against the planes alone, a few projections
+/// that need no further queries: walkable ground lifts the move up the
+/// slope so horizontal speed is kept, steeper ground also blocks it
+/// horizontally, and everything else slides it along the plane. Planes are
+/// conservative, so nothing is tunnelled through however fast the move.
+///
+/// Grounded characters blocked by a ledge retry the move raised by
+/// stepHeight and lowered back onto the ledge, and keep the result if it
+/// lands on walkable ground further along. Grounded characters that walk
+/// off the ground are snapped back down by up to snapDistance.
+///
+/// Characters push nothing and do not collide with each other. The rigid
+/// world needs the DynamicTree broadphase and must not be stepped during a
+/// batch.
+class CharacterWorld {
+public:
+    /// Per move.
+    static constexpr uint32_t kMaxColliders = 32;
+    static constexpr uint32_t kMaxPlanes = 32;
+
+    explicit CharacterWorld(const CharacterWorldDesc& desc = {});
+
+    CharacterId createCharacter(const CharacterDesc& desc);
+    void destroyCharacter(CharacterId id);
+    bool valid(CharacterId id) const { return ids_.valid(id); }
+
+    const CharacterState& state(CharacterId id) const;
+    /// Teleports the character. It starts out airborne.
+    void setPosition(CharacterId id, math::Vec3 position);
+
+    /// Moves every character in `moves` by its velocity over `dt`. At most
+    /// one move per character per batch.
+    void move(const PhysicsWorld& world, std::span<const CharacterMove> moves, float dt, jobs::JobSystem& jobs);
+
+    /// Of the last batch.
+    const CharacterStats& stats() const { return stats_; }
+
+private:
+    // What one move did, summed into the stats after the batch.
+    struct MoveStats {
+        uint32_t colliders = 0;
+        uint32_t planes = 0;
+        uint32_t passes = 0;
+        uint32_t dropped = 0;
+        bool stepped = false;
+        bool snapped = false;
+    };
+
+    struct Slot {
+        CharacterState state;
+        MoveStats last;
+        Shape shape;
+        float verticalSpeed = 0.0f;
+        float walkable = 0.0f; // cosine of maxSlope
+        float stepHeight = 0.0f;
+        float snapDistance = 0.0f;
+        float skinWidth = 0.0f;
+    };
+
+    void moveCharacter(Slot& slot, const PhysicsWorld& world, math::Vec3 velocity, float dt) const;
+
+    float gravity_;
+    uint32_t maxIterations_;
+    memory::SlotTable<Character> ids_;
+    std::vector<Slot> slots_;
+    CharacterStats stats_;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,700 @@
+#include "physics/collision/collide.h"
+
+#include "core/math/mat.h"
+#include "physics/collision/gjk.h"
+#include "physics/collision/segments.h"
+#include "physics/collision/triangles.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+// Face axes win over the other box's faces and over edges unless those
+// separate clearly more; keeps the reference face stable frame to frame.
+constexpr float kRelativeTolerance = 0.95f;
+constexpr float kAbsoluteTolerance = 0.005f;
+
+struct OrientedBox {
+    Vec3 center;
+    Vec3 axis[3];
+    Vec3 half;
+};
+
+OrientedBox orientedBox(Vec3 half, const Transform& t)
+{
+    const math::Mat3 r = math::Mat3::fromQuat(t.rotation);
+    return {t.position, {r.cols[0], r.cols[1], r.cols[2]}, half};
+}
+
+// Incident face vertex in the reference face frame: x, y across the face,
+// z the height above it.
+struct ClipVertex {
+    float x, y, z;
+    uint32_t id;
+};
+
+// Sutherland-Hodgman against one side of the reference face; keeps
+// sign * coordinate <= limit, where the coordinate is x or y.
+uint32_t clipPolygon(const ClipVertex* in, uint32_t count, int coordinate, float sign, float limit, uint32_t plane,
+                     ClipVertex* out)
+{
+    uint32_t outCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const ClipVertex& a = in[i];
+        const ClipVertex& b = in[i + 1 == count ? 0 : i + 1];
+        const float da = sign * (coordinate == 0 ? a.x : a.y) - limit;
+        const float db = sign * (coordinate == 0 ? b.x : b.y) - limit;
+        if (da <= 0.0f)
+            out[outCount++] = a;
+        if ((da <= 0.0f) != (db <= 0.0f)) {
+            const float t = da / (da - db);
+            out[outCount++] = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t,
+                               0x100u | (plane << 4) | (a.id & 0xFu)};
+        }
+    }
+    return outCount;
+}
+
+// reduceManifold() in the reference face plane, where areas are 2D cross
+// products. Returns the chosen indices.
+uint32_t reduceFacePoints(const ClipVertex* points, uint32_t count, uint32_t (&chosen)[kMaxManifoldPoints])
+{
+    uint32_t i0 = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        if (points[i].z < points[i0].z)
+            i0 = i;
+    }
+    uint32_t i1 = i0;
+    float best = -1.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float dx = points[i].x - points[i0].x, dy = points[i].y - points[i0].y;
+        if (dx * dx + dy * dy > best) {
+            best = dx * dx + dy * dy;
+            i1 = i;
+        }
+    }
+    const float ex = points[i1].x - points[i0].x, ey = points[i1].y - points[i0].y;
+    uint32_t i2 = i0, i3 = i0;
+    float maxArea = 0.0f, minArea = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float area = ex * (points[i].y - points[i0].y) - ey * (points[i].x - points[i0].x);
+        if (area > maxArea) {
+            maxArea = area;
+            i2 = i;
+        } else if (area < minArea) {
+            minArea = area;
+            i3 = i;
+        }
+    }
+
+    uint32_t out = 0;
+    chosen[out++] = i0;
+    if (i1 != i0)
+        chosen[out++] = i1;
+    if (i2 != i0)
+        chosen[out++] = i2;
+    if (i3 != i0)
+        chosen[out++] = i3;
+    return out;
+}
+
+void flip(ContactManifold& manifold) { manifold.normal = -manifold.normal; }
+
+// Capsules within this sine of parallel rest on two points.
+constexpr float kParallelSine = 0.1f;
+constexpr uint32_t kMaxFaceVertices = 16;
+constexpr uint32_t kMaxClipVertices = 2 * kMaxFaceVertices + 8;
+// A supporting face within this cosine of the GJK normal supplies the
+// contact normal itself.
+constexpr float kFaceNormalSnap = 0.999f;
+// Candidate points gathered over a triangle shape's triangles before the
+// manifold is reduced.
+constexpr uint32_t kMaxTrianglePoints = 32;
+
+Segment capsuleSegment(float halfHeight, const Transform& t)
+{
+    return {t.apply({0.0f, -halfHeight, 0.0f}), t.apply({0.0f, halfHeight, 0.0f})};
+}
+
+struct FacePoint {
+    Vec3 p;
+    uint32_t id;
+};
+
+// Keeps the part of a point, segment or convex polygon with
+// dot(normal, p) <= offset. Points created on the plane get fresh ids.
+uint32_t clipToPlane(const FacePoint* in, uint32_t count, Vec3 normal, float offset, uint32_t plane, FacePoint* out)
+{
+    uint32_t outCount = 0;
+    const uint32_t edges = count == 1 ? 1 : count == 2 ? 1 : count;
+    for (uint32_t i = 0; i < edges; ++i) {
+        const FacePoint& a = in[i];
+        const float da = math::dot(normal, a.p) - offset;
+        if (da <= 0.0f)
+            out[outCount++] = a;
+        if (count == 1)
+            break;
+        const FacePoint& b = in[i + 1 == count ? 0 : i + 1];
+        const float db = math::dot(normal, b.p) - offset;
+        if ((da <= 0.0f) != (db <= 0.0f))
+            out[outCount++] = {a.p + (b.p - a.p) * (da / (da - db)), 0x100u | (plane << 4) | (a.id & 0xFu)};
+        if (count == 2 && db <= 0.0f)
+            out[outCount++] = b;
+    }
+    return outCount;
+}
+
+// Contact points between the supporting features of two shapes: the
+// incident feature is clipped against the side planes of the reference
+// face (or the end planes of a reference segment), and its points are
+// measured against the reference plane. Returns 0 when a feature is a
+// single point, leaving the caller with the GJK witness.
+uint32_t clipFeatures(const FacePoint* faceA, uint32_t countA, const FacePoint* faceB, uint32_t countB, Vec3 n,
+                      float margin, ContactPoint* out)
+{
+    const bool refIsA = countA >= 3 || (countA == 2 && countB < 3);
+    const FacePoint* ref = refIsA ? faceA : faceB;
+    const FacePoint* inc = refIsA ? faceB : faceA;
+    const uint32_t refCount = refIsA ? countA : countB;
+    const uint32_t incCount = refIsA ? countB : countA;
+    if (refCount < 2 || (refCount == 2 && incCount < 2))
+        return 0;
+    const Vec3 refNormal = refIsA ? n : -n;
+
+    FacePoint polygon[kMaxClipVertices], scratch[kMaxClipVertices];
+    uint32_t count = incCount;
+    for (uint32_t i = 0; i < count; ++i)
+        polygon[i] = inc[i];
+    if (refCount == 2) {
+        const Vec3 axis = ref[1].p - ref[0].p;
+        count = clipToPlane(polygon, count, -axis, -math::dot(axis, ref[0].p), 0, scratch);
+        count = clipToPlane(scratch, count, axis, math::dot(axis, ref[1].p), 1, polygon);
+    } else {
+        // The reference face is counter-clockwise about its normal, so
+        // edge x normal points out of the face.
+        for (uint32_t i = 0; i < refCount && count > 0; ++i) {
+            const Vec3 edge = ref[i + 1 == refCount ? 0 : i + 1].p - ref[i].p;
+            const Vec3 side = math::cross(edge, refNormal);
+            count = clipToPlane(polygon, count, side, math::dot(side, ref[i].p), i, scratch);
+            std::copy(scratch, scratch + count, polygon);
+        }
+    }
+
+    const uint32_t refBits = refIsA ? 0x40000000u : 0xC0000000u;
+    const float refOffset = math::dot(ref[0].p, refNormal);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float separation = math::dot(polygon[i].p, refNormal) - refOffset;
+        if (separation <= margin)
+            out[kept++] = {polygon[i].p - refNormal * (0.5f * separation), separation, refBits | polygon[i].id};
+    }
+    return kept;
+}
+
+} // namespace
+
+void reduceManifold(const ContactPoint* points, uint32_t count, ContactManifold& manifold)
+{
+    if (count <= kMaxManifoldPoints) {
+        for (uint32_t i = 0; i < count; ++i)
+            manifold.points[i] = points[i];
+        manifold.pointCount = count;
+        return;
+    }
+
+    const Vec3 n = manifold.normal;
+    uint32_t i0 = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        if (points[i].separation < points[i0].separation)
+            i0 = i;
+    }
+    const Vec3 p0 = points[i0].position;
+
+    uint32_t i1 = i0;
+    float best = -1.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float d = math::lengthSquared(points[i].position - p0);
+        if (d > best) {
+            best = d;
+            i1 = i;
+        }
+    }
+    const Vec3 edge = points[i1].position - p0;
+
+    // Third point: largest triangle; fourth: largest on the opposite side.
+    uint32_t i2 = i0;
+    float area2 = 0.0f;
+    best = -1.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float area = math::dot(math::cross(edge, points[i].position - p0), n);
+        if (std::fabs(area) > best) {
+            best = std::fabs(area);
+            area2 = area;
+            i2 = i;
+        }
+    }
+    uint32_t i3 = i0;
+    best = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float area = -math::dot(math::cross(edge, points[i].position - p0), n) * (area2 < 0.0f ? -1.0f : 1.0f);
+        if (area > best) {
+            best = area;
+            i3 = i;
+        }
+    }
+
+    uint32_t out = 0;
+    for (const uint32_t index : {i0, i1, i2, i3}) {
+        bool duplicate = false;
+        for (uint32_t k = 0; k < out; ++k)
+            duplicate |= manifold.points[k].featureId == points[index].featureId &&
+                         manifold.points[k].position == points[index].position;
+        if (!duplicate)
+            manifold.points[out++] = points[index];
+    }
+    manifold.pointCount = out;
+}
+
+bool collideSpheres(float radiusA, Vec3 centerA, float radiusB, Vec3 centerB, float margin, ContactManifold& manifold)
+{
+    const Vec3 d = centerB - centerA;
+    const float distSq = math::lengthSquared(d);
+    const float reach = radiusA + radiusB + margin;
+    if (distSq > reach * reach)
+        return false;
+
+    const float dist = std::sqrt(distSq);
+    const Vec3 n = dist > 1e-6f ? d / dist : Vec3{0.0f, 1.0f, 0.0f};
+    const float separation = dist - radiusA - radiusB;
+    manifold.normal = n;
+    manifold.pointCount = 1;
+    manifold.points[0] = {centerA + n * (radiusA + 0.5f * separation), separation, 0};
+    return true;
+}
+
+bool collideBoxSphere(Vec3 halfExtents, const Transform& box, float radius, Vec3 center, float margin,
+                      ContactManifold& manifold)
+{
+    const Vec3 local = box.applyInverse(center);
+    const Vec3 closest = math::min(math::max(local, -halfExtents), halfExtents);
+    const Vec3 d = local - closest;
+    const float distSq = math::lengthSquared(d);
+    const float reach = radius + margin;
+    if (distSq > reach * reach)
+        return false;
+
+    Vec3 localNormal;
+    Vec3 surface = closest;
+    float separation;
+    uint32_t feature;
+    if (distSq > 1e-12f) {
+        const float dist = std::sqrt(distSq);
+        localNormal = d / dist;
+        separation = dist - radius;
+        feature = 0;
+    } else {
+        // Centre inside the box: push out through the nearest face.
+        int axis = 0;
+        float penetration = FLT_MAX;
+        for (int k = 0; k < 3; ++k) {
+            const float p = halfExtents[k] - std::fabs(local[k]);
+            if (p < penetration) {
+                penetration = p;
+                axis = k;
+            }
+        }
+        const float sign = local[axis] < 0.0f ? -1.0f : 1.0f;
+        localNormal = {};
+        localNormal[axis] = sign;
+        surface[axis] = sign * halfExtents[axis];
+        separation = -penetration - radius;
+        feature = 1 + uint32_t(axis);
+    }
+
+    const Vec3 n = box.rotate(localNormal);
+    manifold.normal = n;
+    manifold.pointCount = 1;
+    manifold.points[0] = {box.apply(surface) + n * (0.5f * separation), separation, feature};
+    return true;
+}
+
+bool collideBoxes(Vec3 halfA, const Transform& ta, Vec3 halfB, const Transform& tb, float margin,
+                  ContactManifold& manifold)
+{
+    const OrientedBox a = orientedBox(halfA, ta);
+    const OrientedBox b = orientedBox(halfB, tb);
+    const Vec3 d = b.center - a.center;
+
+    // Work in A's frame: c[i][j] = a_i . b_j, t = d in A's axes.
+    float c[3][3], absC[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            c[i][j] = math::dot(a.axis[i], b.axis[j]);
+            absC[i][j] = std::fabs(c[i][j]) + 1e-6f;
+        }
+    }
+    const float t[3] = {math::dot(d, a.axis[0]), math::dot(d, a.axis[1]), math::dot(d, a.axis[2])};
+
+    float faceSepA = -FLT_MAX, faceSepB = -FLT_MAX, edgeSep = -FLT_MAX;
+    int faceA = 0, faceB = 0, edgeA = 0, edgeB = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        const float s = std::fabs(t[i]) - a.half[i] -
+                        (b.half.x * absC[i][0] + b.half.y * absC[i][1] + b.half.z * absC[i][2]);
+        if (s > margin)
+            return false;
+        if (s > faceSepA) {
+            faceSepA = s;
+            faceA = i;
+        }
+    }
+    for (int j = 0; j < 3; ++j) {
+        const float s = std::fabs(t[0] * c[0][j] + t[1] * c[1][j] + t[2] * c[2][j]) - b.half[j] -
+                        (a.half.x * absC[0][j] + a.half.y * absC[1][j] + a.half.z * absC[2][j]);
+        if (s > margin)
+            return false;
+        if (s > faceSepB) {
+            faceSepB = s;
+            faceB = j;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            // |a_i x b_j| = sin of the angle between the edges.
+            const float lenSq = 1.0f - c[i][j] * c[i][j];
+            if (lenSq < 1e-6f)
+                continue; // parallel edges; covered by the face axes
+            const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            const float distance = std::fabs(t[i2] * c[i1][j] - t[i1] * c[i2][j]);
+            const float radius = a.half[i1] * absC[i2][j] + a.half[i2] * absC[i1][j] + b.half[j1] * absC[i][j2] +
+                                 b.half[j2] * absC[i][j1];
+            const float s = (distance - radius) / std::sqrt(lenSq);
+            if (s > margin)
+                return false;
+            if (s > edgeSep) {
+                edgeSep = s;
+                edgeA = i;
+                edgeB = j;
+            }
+        }
+    }
+
+    const bool refIsA = faceSepB <= kRelativeTolerance * faceSepA + kAbsoluteTolerance;
+    const float faceSep = refIsA ? faceSepA : faceSepB;
+
+    if (edgeSep > kRelativeTolerance * faceSep + kAbsoluteTolerance) {
+        Vec3 n = math::normalize(math::cross(a.axis[edgeA], b.axis[edgeB]));
+        if (math::dot(n, d) < 0.0f)
+            n = -n;
+        // Support edges: the edge of A furthest along n, of B furthest against n.
+        Vec3 pA = a.center, pB = b.center;
+        for (int k = 0; k < 3; ++k) {
+            if (k != edgeA)
+                pA += a.axis[k] * (math::dot(a.axis[k], n) > 0.0f ? a.half[k] : -a.half[k]);
+            if (k != edgeB)
+                pB += b.axis[k] * (math::dot(b.axis[k], n) > 0.0f ? -b.half[k] : b.half[k]);
+        }
+        const Vec3 dA = a.axis[edgeA], dB = b.axis[edgeB];
+        const Vec3 r = pA - pB;
+        const float k = math::dot(dA, dB);
+        const float c = math::dot(dA, r);
+        const float f = math::dot(dB, r);
+        const float denom = 1.0f - k * k;
+        float s = denom > 1e-6f ? math::clamp((k * f - c) / denom, -a.half[edgeA], a.half[edgeA]) : 0.0f;
+        const float t = math::clamp(k * s + f, -b.half[edgeB], b.half[edgeB]);
+        s = math::clamp(k * t - c, -a.half[edgeA], a.half[edgeA]);
+
+        manifold.normal = n;
+        manifold.pointCount = 1;
+        manifold.points[0] = {(pA + dA * s + pB + dB * t) * 0.5f, edgeSep, 0x80000000u | uint32_t(edgeA * 3 + edgeB)};
+        return true;
+    }
+
+    const OrientedBox& ref = refIsA ? a : b;
+    const OrientedBox& inc = refIsA ? b : a;
+    const int axis = refIsA ? faceA : faceB;
+    Vec3 n = ref.axis[axis];
+    if (math::dot(n, inc.center - ref.center) < 0.0f)
+        n = -n;
+
+    // Incident face: the one most anti-parallel to the reference normal.
+    int incAxis = 0;
+    float best = -1.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float alignment = std::fabs(math::dot(inc.axis[k], n));
+        if (alignment > best) {
+            best = alignment;
+            incAxis = k;
+        }
+    }
+    const float incSign = math::dot(inc.axis[incAxis], n) > 0.0f ? -1.0f : 1.0f;
+    const Vec3 incCenter = inc.center + inc.axis[incAxis] * (incSign * inc.half[incAxis]);
+    const int u = (incAxis + 1) % 3, v = (incAxis + 2) % 3;
+    const Vec3 du = inc.axis[u] * inc.half[u], dv = inc.axis[v] * inc.half[v];
+
+    // Express the incident face in the reference face's frame and clip it
+    // to the face rectangle.
+    const int side1 = (axis + 1) % 3, side2 = (axis + 2) % 3;
+    const Vec3 refCenter = ref.center + n * ref.half[axis];
+    const Vec3 s1 = ref.axis[side1], s2 = ref.axis[side2];
+    const Vec3 corners[4] = {incCenter + du + dv, incCenter - du + dv, incCenter - du - dv, incCenter + du - dv};
+    ClipVertex polygon[8], scratch[8];
+    for (uint32_t k = 0; k < 4; ++k) {
+        const Vec3 r = corners[k] - refCenter;
+        polygon[k] = {math::dot(r, s1), math::dot(r, s2), math::dot(r, n), k};
+    }
+    uint32_t count = 4;
+    count = clipPolygon(polygon, count, 0, 1.0f, ref.half[side1], 0, scratch);
+    count = clipPolygon(scratch, count, 0, -1.0f, ref.half[side1], 1, polygon);
+    count = clipPolygon(polygon, count, 1, 1.0f, ref.half[side2], 2, scratch);
+    count = clipPolygon(scratch, count, 1, -1.0f, ref.half[side2], 3, polygon);
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (polygon[i].z <= margin)
+            polygon[kept++] = polygon[i];
+    }
+    if (kept == 0)
+        return false;
+
+    uint32_t chosen[kMaxManifoldPoints] = {0, 1, 2, 3};
+    const uint32_t pointCount = kept > kMaxManifoldPoints ? reduceFacePoints(polygon, kept, chosen) : kept;
+
+    const uint32_t faceBits = (refIsA ? 0u : 0x800000u) |
+                              (uint32_t(axis * 2 + (math::dot(n, ref.axis[axis]) < 0.0f)) << 24) |
+                              (uint32_t(incAxis * 2 + (incSign < 0.0f)) << 16);
+    manifold.normal = refIsA ? n : -n;
+    manifold.pointCount = pointCount;
+    for (uint32_t i = 0; i < pointCount; ++i) {
+        const ClipVertex& p = polygon[chosen[i]];
+        manifold.points[i] = {refCenter + s1 * p.x + s2 * p.y + n * (0.5f * p.z), p.z, faceBits | p.id};
+    }
+    return true;
+}
+
+bool collideCapsuleSphere(float capsuleRadius, float halfHeight, const Transform& capsule, float radius, Vec3 center,
+                          float margin, ContactManifold& manifold)
+{
+    const Vec3 closest = closestOnSegment(capsuleSegment(halfHeight, capsule), center);
+    return collideSpheres(capsuleRadius, closest, radius, center, margin, manifold);
+}
+
+bool collideCapsules(float radiusA, float halfHeightA, const Transform& ta, float radiusB, float halfHeightB,
+                     const Transform& tb, float margin, ContactManifold& manifold)
+{
+    const Segment sa = capsuleSegment(halfHeightA, ta), sb = capsuleSegment(halfHeightB, tb);
+    Vec3 ca, cb;
+    closestBetweenSegments(sa, sb, ca, cb);
+    const float reach = radiusA + radiusB + margin;
+    const Vec3 d = cb - ca;
+    const float distSq = math::lengthSquared(d);
+    if (distSq > reach * reach)
+        return false;
+
+    const Vec3 axisA = sa.b - sa.a, axisB = sb.b - sb.a;
+    const float dist = std::sqrt(distSq);
+    Vec3 n;
+    if (dist > 1e-6f) {
+        n = d / dist;
+    } else {
+        // Crossing axes: separate along their common perpendicular.
+        n = math::normalize(math::cross(axisA, axisB), {});
+        if (math::lengthSquared(n) == 0.0f)
+            n = math::normalize(math::cross(axisA, Vec3{1.0f, 0.0f, 0.0f}), {0.0f, 0.0f, 1.0f});
+        if (math::dot(n, tb.position - ta.position) < 0.0f)
+            n = -n;
+    }
+    manifold.normal = n;
+    manifold.pointCount = 0;
+
+    // Nearly parallel axes: keep both ends of the overlap so the capsules
+    // rest on a line instead of a single rocking point.
+    const float crossSq = math::lengthSquared(math::cross(axisA, axisB));
+    if (crossSq <= kParallelSine * kParallelSine * math::lengthSquared(axisA) * math::lengthSquared(axisB)) {
+        const FacePoint faceA[2] = {{sa.a + n * radiusA, 0}, {sa.b + n * radiusA, 1}};
+        const FacePoint faceB[2] = {{sb.a - n * radiusB, 0}, {sb.b - n * radiusB, 1}};
+        ContactPoint points[kMaxClipVertices];
+        const uint32_t count = clipFeatures(faceA, 2, faceB, 2, n, margin, points);
+        if (count == 2) {
+            reduceManifold(points, count, manifold);
+            return true;
+        }
+    }
+
+    const float separation = dist - radiusA - radiusB;
+    manifold.pointCount = 1;
+    manifold.points[0] = {ca + n * (radiusA + 0.5f * separation), separation, 0};
+    return true;
+}
+
+namespace {
+
+// Unit normal of a counter-clockwise polygon (Newell's method).
+Vec3 polygonNormal(const Vec3* points, uint32_t count)
+{
+    Vec3 sum{};
+    for (uint32_t i = 0; i < count; ++i) {
+        const Vec3& a = points[i];
+        const Vec3& b = points[i + 1 == count ? 0 : i + 1];
+        sum += Vec3{(a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x), (a.x - b.x) * (a.y + b.y)};
+    }
+    return math::normalize(sum, Vec3{});
+}
+
+// Contact of two cores along the unit normal `n` (A to B), given their
+// separation along it and a closest pair for the fallback point.
+bool collideAlong(const ConvexCore& coreA, const ConvexCore& coreB, Vec3 n, float separation,
+                  const ClosestPoints& closest, float margin, ContactManifold& manifold)
+{
+    manifold.normal = n;
+    Vec3 pointsA[kMaxFaceVertices], pointsB[kMaxFaceVertices];
+    uint32_t idsA[kMaxFaceVertices], idsB[kMaxFaceVertices];
+    const uint32_t countA = coreA.supportingFace(n, pointsA, idsA, kMaxFaceVertices);
+    const uint32_t countB = coreB.supportingFace(-n, pointsB, idsB, kMaxFaceVertices);
+    FacePoint faceA[kMaxFaceVertices], faceB[kMaxFaceVertices];
+    for (uint32_t i = 0; i < countA; ++i)
+        faceA[i] = {pointsA[i], idsA[i]};
+    for (uint32_t i = 0; i < countB; ++i)
+        faceB[i] = {pointsB[i], idsB[i]};
+
+    // GJK's normal between two nearly parallel faces is only good to about
+    // 1e-4 rad, which tilts the reference plane enough to move separations
+    // by a millimetre across a large face. Use the face's own normal.
+    if (countA >= 3 || countB >= 3) {
+        const Vec3 faceNormal = countA >= 3 ? polygonNormal(pointsA, countA) : -polygonNormal(pointsB, countB);
+        if (math::dot(faceNormal, n) > kFaceNormalSnap) {
+            n = faceNormal;
+            manifold.normal = n;
+        }
+    }
+
+    ContactPoint points[kMaxClipVertices];
+    const uint32_t count = clipFeatures(faceA, countA, faceB, countB, n, margin, points);
+    if (count == 0) {
+        const Vec3 surfaceA = closest.pointA + n * coreA.radius;
+        const Vec3 surfaceB = closest.pointB - n * coreB.radius;
+        manifold.pointCount = 1;
+        manifold.points[0] = {(surfaceA + surfaceB) * 0.5f, separation, 0};
+        return true;
+    }
+    reduceManifold(points, count, manifold);
+    return true;
+}
+
+bool collideCores(const ConvexCore& coreA, const ConvexCore& coreB, float margin, ContactManifold& manifold)
+{
+    const float rounding = coreA.radius + coreB.radius;
+    ClosestPoints closest;
+    if (!closestPoints(coreA, coreB, rounding + margin, closest))
+        return false;
+    const float separation = closest.distance - rounding;
+    if (separation > margin)
+        return false;
+    return collideAlong(coreA, coreB, closest.normal, separation, closest, margin, manifold);
+}
+
+} // namespace
+
+bool collideConvex(const Shape& a, const Transform& ta, const Shape& b, const Transform& tb, float margin,
+                   ContactManifold& manifold)
+{
+    return collideCores(ConvexCore(a, ta), ConvexCore(b, tb), margin, manifold);
+}
+
+bool collideTriangles(const Shape& triangles, const Transform& tt, const Shape& convex, const Transform& tc,
+                      float margin, ContactManifold& manifold)
+{
+    const ConvexCore core(convex, tc);
+    ContactPoint points[kMaxTrianglePoints];
+    uint32_t count = 0;
+    float deepest = FLT_MAX;
+    forEachTriangle(triangles, tt, computeAabb(convex, tc).expanded(margin), [&](uint32_t id, const Vec3* v) {
+        const ConvexCore triangle(v);
+        ClosestPoints closest;
+        if (!closestPoints(triangle, core, core.radius + margin, closest))
+            return;
+        // A triangle has no inside, so once the core itself is into one the
+        // shortest way out can lie across it or over an edge shared with
+        // its neighbour. Push out of the face on the side the core's centre
+        // is on instead, so thin surfaces hold and seams don't snag.
+        Vec3 normal = closest.normal;
+        float separation = closest.distance - core.radius;
+        if (closest.distance <= 0.0f) {
+            normal = math::normalize(math::cross(v[1] - v[0], v[2] - v[0]), normal);
+            if (math::dot(tc.position - v[0], normal) < 0.0f)
+                normal = -normal;
+            separation = math::dot(core.support(-normal) - v[0], normal) - core.radius;
+        }
+        ContactManifold candidate;
+        if (separation > margin || !collideAlong(triangle, core, normal, separation, closest, margin, candidate))
+            return;
+        for (uint32_t i = 0; i < candidate.pointCount; ++i) {
+            if (count == kMaxTrianglePoints) {
+                // Full: keep the best four so far and carry on.
+                ContactManifold reduced;
+                reduceManifold(points, count, reduced);
+                std::copy_n(reduced.points, reduced.pointCount, points);
+                count = reduced.pointCount;
+            }
+            ContactPoint& point = points[count++];
+            point = candidate.points[i];
+            point.featureId ^= id * 0x9E3779B9u;
+            // The deepest triangle's normal speaks for the manifold.
+            if (point.separation < deepest) {
+                deepest = point.separation;
+                manifold.normal = candidate.normal;
+            }
+        }
+    });
+    if (count == 0)
+        return false;
+    reduceManifold(points, count, manifold);
+    return true;
+}
+
+bool collide(const Shape& a, const Transform& ta, const Shape& b, const Transform& tb, float margin,
+             ContactManifold& manifold)
+{
+    manifold.pointCount = 0;
+    const ShapeType typeA = a.type, typeB = b.type;
+    if (typeA == ShapeType::Sphere && typeB == ShapeType::Sphere)
+        return collideSpheres(a.radius, ta.position, b.radius, tb.position, margin, manifold);
+    if (typeA == ShapeType::Box && typeB == ShapeType::Box)
+        return collideBoxes(a.halfExtents, ta, b.halfExtents, tb, margin, manifold);
+    if (typeA == ShapeType::Capsule && typeB == ShapeType::Capsule)
+        return collideCapsules(a.radius, a.halfHeight, ta, b.radius, b.halfHeight, tb, margin, manifold);
+    if (typeA == ShapeType::Box && typeB == ShapeType::Sphere)
+        return collideBoxSphere(a.halfExtents, ta, b.radius, tb.position, margin, manifold);
+    if (typeA == ShapeType::Capsule && typeB == ShapeType::Sphere)
+        return collideCapsuleSphere(a.radius, a.halfHeight, ta, b.radius, tb.position, margin, manifold);
+
+    // Closed forms are written one way round; flip the normal for the other.
+    if (typeA == ShapeType::Sphere && (typeB == ShapeType::Box || typeB == ShapeType::Capsule)) {
+        const bool hit = typeB == ShapeType::Box
+                             ? collideBoxSphere(b.halfExtents, tb, a.radius, ta.position, margin, manifold)
+                             : collideCapsuleSphere(b.radius, b.halfHeight, tb, a.radius, ta.position, margin,
+                                                    manifold);
+        if (hit)
+            flip(manifold);
+        return hit;
+    }
+    if (isTriangleShape(typeA))
+        return collideTriangles(a, ta, b, tb, margin, manifold);
+    if (isTriangleShape(typeB)) {
+        const bool hit = collideTriangles(b, tb, a, ta, margin, manifold);
+        if (hit)
+            flip(manifold);
+        return hit;
+    }
+    return collideConvex(a, ta, b, tb, margin, manifold);
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "physics/collision/contact.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+
+namespace rebel::physics {
+
+/// Narrowphase entry point. Fills `manifold` (normal from A to B) with every
+/// point whose separation is below `margin`, and returns whether any was
+/// found. Pass a positive margin to get speculative points for shapes that
+/// are close but not yet touching.
+///
+/// Sphere, capsule and box pairs have closed forms, heightfields and
+/// meshes go through collideTriangles(), and every other pair goes through
+/// collideConvex().
+bool collide(const Shape& a, const Transform& ta, const Shape& b, const Transform& tb, float margin,
+             ContactManifold& manifold);
+
+bool collideSpheres(float radiusA, math::Vec3 centerA, float radiusB, math::Vec3 centerB, float margin,
+                    ContactManifold& manifold);
+/// Box A against sphere B.
+bool collideBoxSphere(math::Vec3 halfExtents, const Transform& box, float radius, math::Vec3 center, float margin,
+                      ContactManifold& manifold);
+/// Separating-axis test over the 15 box axes, then either reference-face
+/// clipping (up to four points) or a single edge-edge point.
+bool collideBoxes(math::Vec3 halfA, const Transform& ta, math::Vec3 halfB, const Transform& tb, float margin,
+                  ContactManifold& manifold);
+
+/// Capsule (segment along its local Y) against sphere B.
+bool collideCapsuleSphere(float capsuleRadius, float halfHeight, const Transform& capsule, float radius,
+                          math::Vec3 center, float margin, ContactManifold& manifold);
+/// Closest points between the axes; nearly parallel capsules get two points.
+bool collideCapsules(float radiusA, float halfHeightA, const Transform& ta, float radiusB, float halfHeightB,
+                     const Transform& tb, float margin, ContactManifold& manifold);
+/// Any two convex shapes: GJK (EPA once the cores overlap) finds the normal,
+/// then the supporting features are clipped against each other for up to
+/// four points.
+bool collideConvex(const Shape& a, const Transform& ta, const Shape& b, const Transform& tb, float margin,
+                   ContactManifold& manifold);
+
+/// Heightfield or mesh against a convex shape, normal from the triangles to
+/// the convex shape. Each triangle near the convex shape goes through the
+/// convex path, except that a shape penetrating a triangle is pushed out of
+/// its face rather than over an edge; the points are pooled, the deepest
+/// triangle's normal is kept, and the pool is reduced to one manifold.
+bool collideTriangles(const Shape& triangles, const Transform& tt, const Shape& convex, const Transform& tc,
+                      float margin, ContactManifold& manifold);
+
+/// Reduces `count` candidate points to at most four that keep the deepest
+/// point and maximise the contact area. Writes the result to `manifold`.
+void reduceManifold(const ContactPoint* points, uint32_t count, ContactManifold& manifold);
+
+} // namespace rebel::physics
@@ -0,0 +1,47 @@
+#include "physics/collision/contact.h"
+
+namespace rebel::physics {
+
+void matchManifold(const ContactManifold* previous, ContactManifold& current, const Transform& ta, float tolerance)
+{
+    for (uint32_t i = 0; i < current.pointCount; ++i) {
+        ContactPoint& point = current.points[i];
+        point.localA = ta.applyInverse(point.position);
+        point.normalImpulse = 0.0f;
+        point.tangentImpulse[0] = point.tangentImpulse[1] = 0.0f;
+    }
+    // Impulses only carry over while the normal holds; a flipped or swung
+    // normal means a different contact configuration.
+    if (!previous || previous->pointCount == 0 || math::dot(previous->normal, current.normal) < 0.95f)
+        return;
+
+    uint32_t taken = 0; // previous points already claimed
+    for (uint32_t i = 0; i < current.pointCount; ++i) {
+        ContactPoint& point = current.points[i];
+        uint32_t match = UINT32_MAX;
+        float best = tolerance * tolerance;
+        for (uint32_t j = 0; j < previous->pointCount; ++j) {
+            if (taken & (1u << j))
+                continue;
+            const ContactPoint& old = previous->points[j];
+            if (old.featureId == point.featureId && point.featureId != 0) {
+                match = j;
+                break;
+            }
+            const float distSq = math::lengthSquared(old.localA - point.localA);
+            if (distSq <= best) {
+                best = distSq;
+                match = j;
+            }
+        }
+        if (match == UINT32_MAX)
+            continue;
+        taken |= 1u << match;
+        const ContactPoint& old = previous->points[match];
+        point.normalImpulse = old.normalImpulse;
+        point.tangentImpulse[0] = old.tangentImpulse[0];
+        point.tangentImpulse[1] = old.tangentImpulse[1];
+    }
+}
+
+} // namespace rebel::physics
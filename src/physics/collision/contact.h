@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/transform.h"
+
+#include <cstdint>
+
+namespace rebel::physics {
+
+inline constexpr uint32_t kMaxManifoldPoints = 4;
+
+struct ContactPoint {
+    /// World space, midway between the two surfaces.
+    math::Vec3 position;
+    /// Signed distance along the normal; negative while penetrating.
+    float separation = 0.0f;
+    /// Identifies the pair of features that produced the point.
+    uint32_t featureId = 0;
+    /// Position in body A's frame, for matching points across steps.
+    math::Vec3 localA{};
+    /// Accumulated solver impulses along the normal and the two tangents,
+    /// carried between steps to warm start the solver.
+    float normalImpulse = 0.0f;
+    float tangentImpulse[2] = {};
+};
+
+/// Up to four points sharing one normal, which points from shape A to B.
+struct ContactManifold {
+    math::Vec3 normal;
+    uint32_t pointCount = 0;
+    ContactPoint points[kMaxManifoldPoints];
+};
+
+/// A touching pair after the narrowphase. Bodies are slot indices
+/// (BodyId::index); A is the body of the pair's lower proxy.
+struct Contact {
+    uint64_t key = 0; // broadphase pair key, stable while the pair overlaps
+    uint32_t bodyA = 0;
+    uint32_t bodyB = 0;
+    ContactManifold manifold;
+};
+
+/// Makes `current` persistent: records each point's position in A's frame
+/// and takes over the impulses of the `previous` point it matches. Points
+/// match on feature id, or failing that when they lie within `tolerance`
+/// of each other in A's frame. Pass null for a new pair.
+void matchManifold(const ContactManifold* previous, ContactManifold& current, const Transform& ta, float tolerance);
+
+} // namespace rebel::physics
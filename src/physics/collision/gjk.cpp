@@ -0,0 +1,565 @@
+#include "physics/collision/gjk.h"
+
+#include "physics/convex_hull.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kMaxGjkIterations = 32;
+constexpr uint32_t kMaxEpaIterations = 48;
+constexpr uint32_t kMaxEpaVertices = kMaxEpaIterations + 4;
+constexpr uint32_t kMaxEpaFaces = 2 * kMaxEpaVertices;
+constexpr uint32_t kMaxHorizon = 3 * kMaxEpaVertices;
+constexpr float kGjkRelativeTolerance = 1e-6f;
+constexpr float kEpaTolerance = 1e-4f;
+// Capsules lying within about six degrees of a support plane present their
+// whole segment, so they rest on two points instead of rocking on one.
+constexpr float kCapsuleFlatSine = 0.1f;
+// Hull vertices this close to the support plane, relative to the hull size,
+// count as one face.
+constexpr float kHullFaceTolerance = 0.02f;
+// What triangle cores refer to as their shape; never inspected.
+constexpr Shape kTriangleShape = Shape::sphere(0.0f);
+
+struct SimplexVertex {
+    Vec3 a, b, w; // w = a - b
+};
+
+struct Simplex {
+    SimplexVertex v[4];
+    float lambda[4];
+    uint32_t count = 0;
+};
+
+SimplexVertex supportVertex(const ConvexCore& a, const ConvexCore& b, Vec3 direction)
+{
+    SimplexVertex s;
+    s.a = a.support(direction);
+    s.b = b.support(-direction);
+    s.w = s.a - s.b;
+    return s;
+}
+
+// Closest point to the origin on the segment; reduces the simplex to the
+// supporting vertices and returns the point.
+Vec3 closestOnSegment(Simplex& s)
+{
+    const Vec3 a = s.v[0].w, b = s.v[1].w;
+    const Vec3 ab = b - a;
+    const float t = -math::dot(a, ab);
+    if (t <= 0.0f) {
+        s.count = 1;
+        s.lambda[0] = 1.0f;
+        return a;
+    }
+    const float len = math::dot(ab, ab);
+    if (t >= len) {
+        s.v[0] = s.v[1];
+        s.count = 1;
+        s.lambda[0] = 1.0f;
+        return b;
+    }
+    s.lambda[1] = t / len;
+    s.lambda[0] = 1.0f - s.lambda[1];
+    return a + ab * s.lambda[1];
+}
+
+// Ericson's closest point on a triangle, by Voronoi regions.
+Vec3 closestOnTriangle(Simplex& s)
+{
+    const SimplexVertex va = s.v[0], vb = s.v[1], vc = s.v[2];
+    const Vec3 a = va.w, b = vb.w, c = vc.w;
+    const Vec3 ab = b - a, ac = c - a;
+    const float d1 = -math::dot(ab, a), d2 = -math::dot(ac, a);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        s.count = 1;
+        s.lambda[0] = 1.0f;
+        return a;
+    }
+    const float d3 = -math::dot(ab, b), d4 = -math::dot(ac, b);
+    if (d3 >= 0.0f && d4 <= d3) {
+        s.v[0] = vb;
+        s.count = 1;
+        s.lambda[0] = 1.0f;
+        return b;
+    }
+    const float vc3 = d1 * d4 - d3 * d2;
+    if (vc3 <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        const float t = d1 / (d1 - d3);
+        s.count = 2;
+        s.lambda[0] = 1.0f - t;
+        s.lambda[1] = t;
+        return a + ab * t;
+    }
+    const float d5 = -math::dot(ab, c), d6 = -math::dot(ac, c);
+    if (d6 >= 0.0f && d5 <= d6) {
+        s.v[0] = vc;
+        s.count = 1;
+        s.lambda[0] = 1.0f;
+        return c;
+    }
+    const float vb3 = d5 * d2 - d1 * d6;
+    if (vb3 <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        const float t = d2 / (d2 - d6);
+        s.v[1] = vc;
+        s.count = 2;
+        s.lambda[0] = 1.0f - t;
+        s.lambda[1] = t;
+        return a + ac * t;
+    }
+    const float va3 = d3 * d6 - d5 * d4;
+    if (va3 <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+        const float t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        s.v[0] = vb;
+        s.v[1] = vc;
+        s.count = 2;
+        s.lambda[0] = 1.0f - t;
+        s.lambda[1] = t;
+        return b + (c - b) * t;
+    }
+    const float denom = 1.0f / (va3 + vb3 + vc3);
+    const float v = vb3 * denom, w = vc3 * denom;
+    s.lambda[0] = 1.0f - v - w;
+    s.lambda[1] = v;
+    s.lambda[2] = w;
+    return a + ab * v + ac * w;
+}
+
+// Closest point on a tetrahedron: the best of the faces the origin lies
+// outside of. Leaves all four vertices when the origin is inside.
+Vec3 closestOnTetrahedron(Simplex& s, bool& inside)
+{
+    static constexpr uint32_t kFaces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+    inside = true;
+    float best = FLT_MAX;
+    Simplex result;
+    Vec3 closest{};
+    for (const auto& f : kFaces) {
+        const Vec3 a = s.v[f[0]].w;
+        const Vec3 n = math::cross(s.v[f[1]].w - a, s.v[f[2]].w - a);
+        const float origin = -math::dot(n, a);
+        const float opposite = math::dot(n, s.v[f[3]].w - a);
+        if (origin * opposite >= 0.0f && opposite * opposite > 1e-12f)
+            continue;
+        inside = false;
+        Simplex face;
+        face.v[0] = s.v[f[0]];
+        face.v[1] = s.v[f[1]];
+        face.v[2] = s.v[f[2]];
+        face.count = 3;
+        const Vec3 p = closestOnTriangle(face);
+        const float d = math::dot(p, p);
+        if (d < best) {
+            best = d;
+            result = face;
+            closest = p;
+        }
+    }
+    if (!inside)
+        s = result;
+    return closest;
+}
+
+void witnessPoints(const Simplex& s, Vec3& a, Vec3& b)
+{
+    a = {};
+    b = {};
+    for (uint32_t i = 0; i < s.count; ++i) {
+        a += s.v[i].a * s.lambda[i];
+        b += s.v[i].b * s.lambda[i];
+    }
+}
+
+struct EpaFace {
+    uint32_t v[3];
+    Vec3 normal;
+    float distance;
+    bool removed;
+};
+
+bool makeFace(const SimplexVertex* vertices, uint32_t a, uint32_t b, uint32_t c, EpaFace& face)
+{
+    const Vec3 n = math::cross(vertices[b].w - vertices[a].w, vertices[c].w - vertices[a].w);
+    const float len = math::length(n);
+    if (!(len > 1e-12f))
+        return false;
+    face = {{a, b, c}, n / len, math::dot(n, vertices[a].w) / len, false};
+    return true;
+}
+
+// Grows a degenerate GJK simplex into a tetrahedron around the origin by
+// searching along directions orthogonal to what is already spanned.
+bool completeTetrahedron(const ConvexCore& a, const ConvexCore& b, Simplex& s)
+{
+    static constexpr Vec3 kAxes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    if (s.count == 1) {
+        for (const Vec3& axis : kAxes) {
+            for (const float sign : {1.0f, -1.0f}) {
+                const SimplexVertex v = supportVertex(a, b, axis * sign);
+                if (math::lengthSquared(v.w - s.v[0].w) > 1e-10f) {
+                    s.v[s.count++] = v;
+                    break;
+                }
+            }
+            if (s.count == 2)
+                break;
+        }
+        if (s.count < 2)
+            return false;
+    }
+    if (s.count == 2) {
+        const Vec3 d = s.v[1].w - s.v[0].w;
+        const Vec3 axis = std::fabs(d.x) < std::fabs(d.y) ? (std::fabs(d.x) < std::fabs(d.z) ? kAxes[0] : kAxes[2])
+                                                          : (std::fabs(d.y) < std::fabs(d.z) ? kAxes[1] : kAxes[2]);
+        Vec3 dir = math::cross(d, axis);
+        for (int attempt = 0; attempt < 6 && s.count == 2; ++attempt) {
+            const SimplexVertex v = supportVertex(a, b, dir);
+            if (math::lengthSquared(math::cross(v.w - s.v[0].w, d)) > 1e-10f * math::lengthSquared(d))
+                s.v[s.count++] = v;
+            // Rotate the search direction 60 degrees about the segment.
+            dir = dir * 0.5f + math::cross(math::normalize(d), dir) * 0.8660254f;
+        }
+        if (s.count < 3)
+            return false;
+    }
+    if (s.count == 3) {
+        const Vec3 n = math::cross(s.v[1].w - s.v[0].w, s.v[2].w - s.v[0].w);
+        SimplexVertex v = supportVertex(a, b, n);
+        if (std::fabs(math::dot(v.w - s.v[0].w, n)) <= 1e-6f * math::length(n))
+            v = supportVertex(a, b, -n);
+        if (std::fabs(math::dot(v.w - s.v[0].w, n)) <= 1e-6f * math::length(n))
+            return false;
+        s.v[s.count++] = v;
+    }
+    return true;
+}
+
+// Expanding polytope: walks the Minkowski difference boundary towards the
+// face closest to the origin.
+bool epa(const ConvexCore& a, const ConvexCore& b, Simplex& s, ClosestPoints& result)
+{
+    if (s.count < 4 && !completeTetrahedron(a, b, s))
+        return false;
+
+    SimplexVertex vertices[kMaxEpaVertices];
+    EpaFace faces[kMaxEpaFaces];
+    uint32_t vertexCount = 4, faceCount = 0;
+    for (uint32_t i = 0; i < 4; ++i)
+        vertices[i] = s.v[i];
+    // Wind the tetrahedron outwards.
+    if (math::dot(math::cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w),
+                  vertices[3].w - vertices[0].w) > 0.0f)
+        std::swap(vertices[1], vertices[2]);
+    static constexpr uint32_t kTetra[4][3] = {{0, 1, 2}, {0, 3, 1}, {0, 2, 3}, {1, 3, 2}};
+    for (const auto& f : kTetra) {
+        if (!makeFace(vertices, f[0], f[1], f[2], faces[faceCount++]))
+            return false;
+    }
+
+    // A copy, since expanding the polytope rewrites face slots. When the
+    // expansion runs into a degenerate face (a new vertex coplanar with a
+    // horizon edge, common on boxes) this is the best answer available.
+    EpaFace closest;
+    for (uint32_t iteration = 0; iteration < kMaxEpaIterations; ++iteration) {
+        const EpaFace* best = nullptr;
+        for (uint32_t f = 0; f < faceCount; ++f) {
+            if (!faces[f].removed && (!best || faces[f].distance < best->distance))
+                best = &faces[f];
+        }
+        if (!best)
+            return false;
+        closest = *best;
+
+        const SimplexVertex v = supportVertex(a, b, closest.normal);
+        if (math::dot(v.w, closest.normal) - closest.distance < kEpaTolerance || vertexCount == kMaxEpaVertices)
+            break;
+
+        // Remove every face the new vertex sees; their unshared edges form
+        // the horizon, which is fanned to the new vertex.
+        uint32_t horizon[kMaxHorizon][2];
+        uint32_t horizonCount = 0;
+        const uint32_t vi = vertexCount;
+        vertices[vertexCount++] = v;
+        for (uint32_t f = 0; f < faceCount; ++f) {
+            EpaFace& face = faces[f];
+            if (face.removed || math::dot(face.normal, v.w - vertices[face.v[0]].w) <= 0.0f)
+                continue;
+            face.removed = true;
+            for (uint32_t e = 0; e < 3; ++e) {
+                const uint32_t from = face.v[e], to = face.v[(e + 1) % 3];
+                uint32_t k = 0;
+                while (k < horizonCount && !(horizon[k][0] == to && horizon[k][1] == from))
+                    ++k;
+                if (k < horizonCount) {
+                    horizon[k][0] = horizon[horizonCount - 1][0];
+                    horizon[k][1] = horizon[horizonCount - 1][1];
+                    --horizonCount;
+                } else if (horizonCount < kMaxHorizon) {
+                    horizon[horizonCount][0] = from;
+                    horizon[horizonCount][1] = to;
+                    ++horizonCount;
+                }
+            }
+        }
+
+        // Reuse removed slots so the face array does not run out.
+        uint32_t slot = 0;
+        bool degenerate = false;
+        for (uint32_t e = 0; e < horizonCount && !degenerate; ++e) {
+            while (slot < faceCount && !faces[slot].removed)
+                ++slot;
+            if (slot == faceCount) {
+                if (faceCount == kMaxEpaFaces)
+                    return false;
+                ++faceCount;
+            }
+            degenerate = !makeFace(vertices, horizon[e][0], horizon[e][1], vi, faces[slot]);
+        }
+        if (degenerate)
+            break;
+    }
+
+    // Barycentrics of the origin's projection on the closest face.
+    const SimplexVertex& va = vertices[closest.v[0]];
+    const SimplexVertex& vb = vertices[closest.v[1]];
+    const SimplexVertex& vc = vertices[closest.v[2]];
+    const Vec3 p = closest.normal * closest.distance;
+    const Vec3 v0 = vb.w - va.w, v1 = vc.w - va.w, v2 = p - va.w;
+    const float d00 = math::dot(v0, v0), d01 = math::dot(v0, v1), d11 = math::dot(v1, v1);
+    const float d20 = math::dot(v2, v0), d21 = math::dot(v2, v1);
+    const float denom = d00 * d11 - d01 * d01;
+    float u = 1.0f / 3.0f, w = 1.0f / 3.0f;
+    if (denom > 1e-20f) {
+        u = (d11 * d20 - d01 * d21) / denom;
+        w = (d00 * d21 - d01 * d20) / denom;
+    }
+    const float t = 1.0f - u - w;
+    result.pointA = va.a * t + vb.a * u + vc.a * w;
+    result.pointB = va.b * t + vb.b * u + vc.b * w;
+    result.normal = closest.normal;
+    result.distance = -closest.distance;
+    return true;
+}
+
+} // namespace
+
+ConvexCore::ConvexCore(const Shape& s, const Transform& t)
+    : shape(s)
+    , transform(t)
+    , rotation(math::Mat3::fromQuat(t.rotation))
+    , radius(s.type == ShapeType::Sphere || s.type == ShapeType::Capsule ? s.radius : 0.0f)
+{
+}
+
+ConvexCore::ConvexCore(const Vec3* vertices)
+    : shape(kTriangleShape)
+    , transform{(vertices[0] + vertices[1] + vertices[2]) * (1.0f / 3.0f), {}}
+    , rotation(math::Mat3::fromQuat({}))
+    , radius(0.0f)
+    , triangle(vertices)
+{
+}
+
+Vec3 ConvexCore::toWorld(Vec3 local) const
+{
+    return rotation.cols[0] * local.x + rotation.cols[1] * local.y + rotation.cols[2] * local.z + transform.position;
+}
+
+Vec3 ConvexCore::toLocal(Vec3 direction) const
+{
+    return {math::dot(rotation.cols[0], direction), math::dot(rotation.cols[1], direction),
+            math::dot(rotation.cols[2], direction)};
+}
+
+Vec3 ConvexCore::support(Vec3 direction) const
+{
+    if (triangle) {
+        const float d0 = math::dot(triangle[0], direction);
+        const float d1 = math::dot(triangle[1], direction);
+        const float d2 = math::dot(triangle[2], direction);
+        return d0 >= d1 && d0 >= d2 ? triangle[0] : (d1 >= d2 ? triangle[1] : triangle[2]);
+    }
+    switch (shape.type) {
+    case ShapeType::Sphere:
+        return transform.position;
+    case ShapeType::Box: {
+        // Corner = centre + sum of +-half extent along each axis.
+        Vec3 p = transform.position;
+        for (int k = 0; k < 3; ++k) {
+            const float e = shape.halfExtents[k];
+            p += rotation.cols[k] * (math::dot(rotation.cols[k], direction) < 0.0f ? -e : e);
+        }
+        return p;
+    }
+    case ShapeType::Capsule: {
+        const float h = math::dot(rotation.cols[1], direction) < 0.0f ? -shape.halfHeight : shape.halfHeight;
+        return transform.position + rotation.cols[1] * h;
+    }
+    case ShapeType::ConvexHull:
+        return toWorld(shape.hull->point(shape.hull->support(toLocal(direction))));
+    case ShapeType::Heightfield:
+    case ShapeType::TriangleMesh:
+        // Not convex; the narrowphase makes a core per triangle instead.
+        break;
+    }
+    return transform.position;
+}
+
+uint32_t ConvexCore::supportingFace(Vec3 direction, Vec3* points, uint32_t* ids, uint32_t capacity) const
+{
+    if (triangle) {
+        // The whole face when the direction is close to its normal,
+        // otherwise the edge or vertex within tolerance of the support plane.
+        float dots[3], best = -FLT_MAX;
+        for (uint32_t i = 0; i < 3; ++i) {
+            dots[i] = math::dot(triangle[i], direction);
+            best = std::max(best, dots[i]);
+        }
+        const Vec3 size = math::max(math::max(triangle[0], triangle[1]), triangle[2]) -
+                          math::min(math::min(triangle[0], triangle[1]), triangle[2]);
+        const float tolerance = kHullFaceTolerance * std::max(size.x, std::max(size.y, size.z));
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < 3 && count < capacity; ++i) {
+            if (dots[i] >= best - tolerance) {
+                points[count] = triangle[i];
+                ids[count++] = i;
+            }
+        }
+        if (count == 3 && math::dot(math::cross(points[1] - points[0], points[2] - points[0]), direction) < 0.0f) {
+            std::swap(points[1], points[2]);
+            std::swap(ids[1], ids[2]);
+        }
+        return count;
+    }
+    const Vec3 offset = direction * radius;
+    const Vec3 d = toLocal(direction);
+    switch (shape.type) {
+    case ShapeType::Sphere:
+        points[0] = transform.position + offset;
+        ids[0] = 0;
+        return 1;
+    case ShapeType::Box: {
+        // Face most aligned with the direction, corners counter-clockwise.
+        int axis = 0;
+        for (int k = 1; k < 3; ++k) {
+            if (std::fabs(d[k]) > std::fabs(d[axis]))
+                axis = k;
+        }
+        const float sign = d[axis] < 0.0f ? -1.0f : 1.0f;
+        const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+        static constexpr float kCorners[4][2] = {{1.0f, 1.0f}, {-1.0f, 1.0f}, {-1.0f, -1.0f}, {1.0f, -1.0f}};
+        for (uint32_t i = 0; i < 4; ++i) {
+            const float* c = kCorners[sign > 0.0f ? i : 3 - i];
+            Vec3 local;
+            local[axis] = sign * shape.halfExtents[axis];
+            local[u] = c[0] * shape.halfExtents[u];
+            local[v] = c[1] * shape.halfExtents[v];
+            points[i] = toWorld(local);
+            ids[i] = (local.x > 0.0f ? 1u : 0u) | (local.y > 0.0f ? 2u : 0u) | (local.z > 0.0f ? 4u : 0u);
+        }
+        return 4;
+    }
+    case ShapeType::Capsule: {
+        const Vec3 top = transform.position + rotation.cols[1] * shape.halfHeight;
+        const Vec3 bottom = transform.position - rotation.cols[1] * shape.halfHeight;
+        if (std::fabs(d.y) <= kCapsuleFlatSine && capacity >= 2) {
+            points[0] = bottom + offset;
+            points[1] = top + offset;
+            ids[0] = 0;
+            ids[1] = 1;
+            return 2;
+        }
+        points[0] = (d.y < 0.0f ? bottom : top) + offset;
+        ids[0] = d.y < 0.0f ? 0u : 1u;
+        return 1;
+    }
+    case ShapeType::ConvexHull: {
+        const Vec3 size = shape.hull->bounds().extents();
+        const float tolerance = kHullFaceTolerance * std::max(size.x, std::max(size.y, size.z));
+        const uint32_t count = shape.hull->supportingFace(d, tolerance, ids, capacity);
+        for (uint32_t i = 0; i < count; ++i)
+            points[i] = toWorld(shape.hull->point(ids[i]));
+        return count;
+    }
+    case ShapeType::Heightfield:
+    case ShapeType::TriangleMesh:
+        break;
+    }
+    return 0;
+}
+
+bool closestPoints(const ConvexCore& a, const ConvexCore& b, float maxDistance, ClosestPoints& result)
+{
+    Vec3 v = a.transform.position - b.transform.position;
+    if (math::lengthSquared(v) < 1e-12f)
+        v = {1.0f, 0.0f, 0.0f};
+
+    Simplex s;
+    s.v[0] = supportVertex(a, b, -v);
+    s.lambda[0] = 1.0f;
+    s.count = 1;
+    v = s.v[0].w;
+
+    bool overlap = false;
+    for (uint32_t iteration = 0; iteration < kMaxGjkIterations; ++iteration) {
+        const float vv = math::dot(v, v);
+        if (vv <= 1e-12f) {
+            overlap = true;
+            break;
+        }
+        const SimplexVertex w = supportVertex(a, b, -v);
+        const float vw = math::dot(v, w.w);
+        // dot(v, w) / |v| bounds the distance from below.
+        if (vw > 0.0f && vw * vw > vv * maxDistance * maxDistance)
+            return false;
+        if (vv - vw <= kGjkRelativeTolerance * vv)
+            break;
+
+        const Simplex previous = s;
+        s.v[s.count++] = w;
+        bool inside = false;
+        const Vec3 next = s.count == 2 ? closestOnSegment(s)
+                          : s.count == 3 ? closestOnTriangle(s)
+                                         : closestOnTetrahedron(s, inside);
+        if (inside) {
+            overlap = true;
+            break;
+        }
+        // No progress: numerical floor reached, keep the previous answer.
+        if (math::dot(next, next) >= vv) {
+            s = previous;
+            break;
+        }
+        v = next;
+    }
+
+    if (!overlap) {
+        witnessPoints(s, result.pointA, result.pointB);
+        const float distance = math::length(v);
+        result.normal = -v / distance;
+        result.distance = distance;
+        if (distance > maxDistance)
+            return false;
+        // Below this the direction is noise; fall through to EPA.
+        if (distance > 1e-4f)
+            return true;
+    }
+
+    if (epa(a, b, s, result))
+        return true;
+    // Touching or degenerate: report contact along the centre line.
+    witnessPoints(s, result.pointA, result.pointB);
+    result.normal = math::normalize(b.transform.position - a.transform.position, {0.0f, 1.0f, 0.0f});
+    result.distance = 0.0f;
+    return true;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/math/mat.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+
+#include <cstdint>
+
+namespace rebel::physics {
+
+/// A shape as GJK sees it: a convex core (point, segment, box or hull)
+/// grown by `radius`. Spheres and capsules keep their rounding out of the
+/// core, so GJK stays on the fast, well-conditioned separated path for
+/// them until the cores themselves touch.
+struct ConvexCore {
+    ConvexCore(const Shape& s, const Transform& t);
+    /// One heightfield or mesh triangle, three world-space vertices that
+    /// must outlive the core: a flat hull with no rounding.
+    explicit ConvexCore(const math::Vec3* triangle);
+
+    /// Farthest core point along a world-space direction.
+    math::Vec3 support(math::Vec3 direction) const;
+    /// Surface feature (vertex, edge or face polygon) farthest along the unit
+    /// world-space `direction`, rounding included. Polygons are
+    /// counter-clockwise about `direction`. Returns the vertex count; `ids`
+    /// receives a stable id per vertex.
+    uint32_t supportingFace(math::Vec3 direction, math::Vec3* points, uint32_t* ids, uint32_t capacity) const;
+
+    math::Vec3 toWorld(math::Vec3 local) const;
+    math::Vec3 toLocal(math::Vec3 direction) const;
+
+    const Shape& shape;
+    Transform transform;
+    math::Mat3 rotation; // of `transform`, cached for the support queries
+    float radius;
+    const math::Vec3* triangle = nullptr;
+};
+
+struct ClosestPoints {
+    math::Vec3 pointA; // on A's core
+    math::Vec3 pointB; // on B's core
+    math::Vec3 normal; // unit, from A to B
+    /// Core distance; negative when the cores overlap (EPA depth).
+    float distance = 0.0f;
+};
+
+/// GJK distance between the cores, with EPA for overlapping cores. Returns
+/// false as soon as the cores are proven farther apart than `maxDistance`.
+bool closestPoints(const ConvexCore& a, const ConvexCore& b, float maxDistance, ClosestPoints& result);
+
+} // namespace rebel::physics
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/math/vec.h"
+
+#include <algorithm>
+
+// Closed-form closest points for segments and triangles, for the pairs the
+// narrowphase and the character controller solve without GJK.
+
+namespace rebel::physics {
+
+struct Segment {
+    math::Vec3 a, b;
+};
+
+inline math::Vec3 closestOnSegment(const Segment& s, math::Vec3 p)
+{
+    const math::Vec3 d = s.b - s.a;
+    const float len = math::dot(d, d);
+    const float t = len > 1e-12f ? std::clamp(math::dot(p - s.a, d) / len, 0.0f, 1.0f) : 0.0f;
+    return s.a + d * t;
+}
+
+/// Closest points between two segments (Ericson 5.1.9).
+inline void closestBetweenSegments(const Segment& s1, const Segment& s2, math::Vec3& c1, math::Vec3& c2)
+{
+    const math::Vec3 d1 = s1.b - s1.a, d2 = s2.b - s2.a, r = s1.a - s2.a;
+    const float a = math::dot(d1, d1), e = math::dot(d2, d2), f = math::dot(d2, r);
+    float s = 0.0f, t = 0.0f;
+    if (a <= 1e-12f && e <= 1e-12f) {
+        c1 = s1.a;
+        c2 = s2.a;
+        return;
+    }
+    if (a <= 1e-12f) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        const float c = math::dot(d1, r);
+        if (e <= 1e-12f) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            const float b = math::dot(d1, d2);
+            const float denom = a * e - b * b;
+            s = denom > 1e-12f ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    c1 = s1.a + d1 * s;
+    c2 = s2.a + d2 * t;
+}
+
+/// Closest point of a triangle to `p`, by Voronoi regions (Ericson 5.1.5).
+inline math::Vec3 closestOnTriangle(const math::Vec3* v, math::Vec3 p)
+{
+    const math::Vec3 ab = v[1] - v[0], ac = v[2] - v[0], ap = p - v[0];
+    const float d1 = math::dot(ab, ap), d2 = math::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return v[0];
+    const math::Vec3 bp = p - v[1];
+    const float d3 = math::dot(ab, bp), d4 = math::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return v[1];
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return v[0] + ab * (d1 / (d1 - d3));
+    const math::Vec3 cp = p - v[2];
+    const float d5 = math::dot(ab, cp), d6 = math::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return v[2];
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return v[0] + ac * (d2 / (d2 - d6));
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        return v[1] + (v[2] - v[1]) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    const float denom = 1.0f / (va + vb + vc);
+    return v[0] + ab * (vb * denom) + ac * (vc * denom);
+}
+
+} // namespace rebel::physics
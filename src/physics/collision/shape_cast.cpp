@@ -0,0 +1,233 @@
+#include "physics/collision/shape_cast.h"
+
+#include "physics/collision/gjk.h"
+#include "physics/collision/triangles.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kMaxCastIterations = 24;
+// Casts stop once the surfaces are this close.
+constexpr float kCastTolerance = 1e-4f;
+
+bool raySphere(Vec3 center, float radius, Vec3 origin, Vec3 direction, float maxDistance, CastHit& hit)
+{
+    const Vec3 m = origin - center;
+    const float b = math::dot(m, direction);
+    const float c = math::dot(m, m) - radius * radius;
+    if (c <= 0.0f) {
+        hit = {0.0f, origin, -direction};
+        return true;
+    }
+    const float discriminant = b * b - c;
+    if (b > 0.0f || discriminant < 0.0f)
+        return false;
+    const float t = -b - std::sqrt(discriminant);
+    if (t > maxDistance)
+        return false;
+    hit.distance = t;
+    hit.point = origin + direction * t;
+    hit.normal = (hit.point - center) * (1.0f / radius);
+    return true;
+}
+
+bool rayBox(const Transform& transform, Vec3 halfExtents, Vec3 origin, Vec3 direction, float maxDistance,
+            CastHit& hit)
+{
+    const Vec3 o = transform.applyInverse(origin);
+    const Vec3 d = transform.rotateInverse(direction);
+    float enter = 0.0f;
+    float exit = maxDistance;
+    int axis = -1;
+    float sign = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        if (std::fabs(d[i]) < 1e-12f) {
+            if (std::fabs(o[i]) > halfExtents[i])
+                return false;
+            continue;
+        }
+        const float inverse = 1.0f / d[i];
+        float t1 = (-halfExtents[i] - o[i]) * inverse;
+        float t2 = (halfExtents[i] - o[i]) * inverse;
+        float faceSign = -1.0f;
+        if (t1 > t2) {
+            std::swap(t1, t2);
+            faceSign = 1.0f;
+        }
+        if (t1 > enter) {
+            enter = t1;
+            axis = i;
+            sign = faceSign;
+        }
+        exit = std::min(exit, t2);
+        if (enter > exit)
+            return false;
+    }
+    if (axis < 0) {
+        hit = {0.0f, origin, -direction};
+        return true;
+    }
+    Vec3 normal{};
+    normal[axis] = sign;
+    hit.distance = enter;
+    hit.point = origin + direction * enter;
+    hit.normal = transform.rotate(normal);
+    return true;
+}
+
+// shapeCast() against one convex core.
+bool castAgainst(const Shape& a, const Transform& start, Vec3 direction, float maxDistance, const ConvexCore& cb,
+                 CastHit& hit)
+{
+    float t = 0.0f;
+    for (uint32_t i = 0; i < kMaxCastIterations; ++i) {
+        const ConvexCore ca(a, {start.position + direction * t, start.rotation});
+        ClosestPoints points;
+        closestPoints(ca, cb, FLT_MAX, points);
+        const float distance = points.distance - ca.radius - cb.radius;
+        if (distance < 0.0f && i == 0) {
+            hit = {0.0f, start.position, -direction};
+            return true;
+        }
+        if (distance <= kCastTolerance) {
+            hit.distance = t;
+            hit.point = points.pointB - points.normal * cb.radius;
+            hit.normal = -points.normal;
+            return true;
+        }
+        const float closing = math::dot(direction, points.normal);
+        if (closing <= 0.0f)
+            return false;
+        t += distance / closing;
+        if (t > maxDistance)
+            return false;
+    }
+    // Out of iterations while still converging; report where it got to.
+    const ConvexCore ca(a, {start.position + direction * t, start.rotation});
+    ClosestPoints points;
+    closestPoints(ca, cb, FLT_MAX, points);
+    hit.distance = t;
+    hit.point = points.pointB - points.normal * cb.radius;
+    hit.normal = -points.normal;
+    return true;
+}
+
+} // namespace
+
+bool rayTriangle(Vec3 origin, Vec3 direction, const Vec3* v, float maxDistance, CastHit& hit)
+{
+    const Vec3 e1 = v[1] - v[0];
+    const Vec3 e2 = v[2] - v[0];
+    const Vec3 p = math::cross(direction, e2);
+    const float det = math::dot(e1, p);
+    if (std::fabs(det) < 1e-12f)
+        return false;
+    const float inverse = 1.0f / det;
+    const Vec3 s = origin - v[0];
+    const float u = math::dot(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+    const Vec3 q = math::cross(s, e1);
+    const float w = math::dot(direction, q) * inverse;
+    if (w < 0.0f || u + w > 1.0f)
+        return false;
+    const float t = math::dot(e2, q) * inverse;
+    if (t < 0.0f || t > maxDistance)
+        return false;
+    const Vec3 normal = math::normalize(math::cross(e1, e2), {0.0f, 1.0f, 0.0f});
+    hit.distance = t;
+    hit.point = origin + direction * t;
+    hit.normal = math::dot(normal, direction) > 0.0f ? -normal : normal;
+    return true;
+}
+
+bool rayCast(const Shape& shape, const Transform& transform, Vec3 origin, Vec3 direction, float maxDistance,
+             CastHit& hit)
+{
+    switch (shape.type) {
+    case ShapeType::Sphere:
+        return raySphere(transform.position, shape.radius, origin, direction, maxDistance, hit);
+    case ShapeType::Box:
+        return rayBox(transform, shape.halfExtents, origin, direction, maxDistance, hit);
+    case ShapeType::Capsule:
+    case ShapeType::ConvexHull:
+        break;
+    case ShapeType::Heightfield:
+    case ShapeType::TriangleMesh: {
+        const Vec3 localOrigin = transform.applyInverse(origin);
+        const Vec3 localDirection = transform.rotateInverse(direction);
+        const bool found = shape.type == ShapeType::Heightfield
+                               ? shape.field->rayCast(localOrigin, localDirection, maxDistance, hit)
+                               : shape.mesh->rayCast(localOrigin, localDirection, maxDistance, hit);
+        if (found) {
+            hit.point = transform.apply(hit.point);
+            hit.normal = transform.rotate(hit.normal);
+        }
+        return found;
+    }
+    }
+    static constexpr Shape kPoint = Shape::sphere(0.0f);
+    return shapeCast(kPoint, {origin, {}}, direction, maxDistance, shape, transform, hit);
+}
+
+bool shapeCast(const Shape& a, const Transform& start, Vec3 direction, float maxDistance, const Shape& b,
+               const Transform& transformB, CastHit& hit)
+{
+    if (!isTriangleShape(b.type))
+        return castAgainst(a, start, direction, maxDistance, ConvexCore(b, transformB), hit);
+
+    // Every triangle under the swept bounds; each hit shortens the rest.
+    Aabb swept = computeAabb(a, start);
+    const Aabb end = computeAabb(a, {start.position + direction * maxDistance, start.rotation});
+    swept.min = math::min(swept.min, end.min);
+    swept.max = math::max(swept.max, end.max);
+    float best = maxDistance;
+    bool found = false;
+    forEachTriangle(b, transformB, swept, [&](uint32_t, const Vec3* v) {
+        CastHit candidate;
+        if (castAgainst(a, start, direction, best, ConvexCore(v), candidate) && candidate.distance <= best) {
+            hit = candidate;
+            best = candidate.distance;
+            found = true;
+        }
+    });
+    return found;
+}
+
+bool shapesOverlap(const Shape& a, const Transform& transformA, const Shape& b, const Transform& transformB)
+{
+    if (isTriangleShape(a.type) || isTriangleShape(b.type)) {
+        const bool aIsTriangles = isTriangleShape(a.type);
+        const Shape& convex = aIsTriangles ? b : a;
+        const Transform& transform = aIsTriangles ? transformB : transformA;
+        const ConvexCore core(convex, transform);
+        bool overlap = false;
+        forEachTriangle(aIsTriangles ? a : b, aIsTriangles ? transformA : transformB, computeAabb(convex, transform),
+                        [&](uint32_t, const Vec3* v) {
+                            ClosestPoints points;
+                            if (!overlap && closestPoints(ConvexCore(v), core, core.radius, points))
+                                overlap = points.distance <= core.radius;
+                        });
+        return overlap;
+    }
+    if (a.type == ShapeType::Sphere && b.type == ShapeType::Sphere) {
+        const float reach = a.radius + b.radius;
+        return math::lengthSquared(transformB.position - transformA.position) <= reach * reach;
+    }
+    const ConvexCore ca(a, transformA);
+    const ConvexCore cb(b, transformB);
+    ClosestPoints points;
+    if (!closestPoints(ca, cb, ca.radius + cb.radius, points))
+        return false;
+    return points.distance <= ca.radius + cb.radius;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+
+#include <cmath>
+
+namespace rebel::physics {
+
+struct CastHit {
+    /// Along the cast direction, from its start.
+    float distance = 0.0f;
+    /// On the surface of the shape that was hit.
+    math::Vec3 point;
+    /// Unit surface normal there, facing back towards the cast.
+    math::Vec3 normal;
+};
+
+/// Ray against one shape; `direction` must be unit length. Spheres and boxes
+/// are solved in closed form, heightfields and meshes through their own
+/// hierarchies, capsules and hulls as a point cast (see shapeCast). A ray
+/// starting inside a convex shape hits at distance zero with the normal
+/// opposing `direction`.
+bool rayCast(const Shape& shape, const Transform& transform, math::Vec3 origin, math::Vec3 direction,
+             float maxDistance, CastHit& hit);
+
+/// Ray against a two-sided triangle (Moller-Trumbore), the normal facing
+/// back along the ray.
+bool rayTriangle(math::Vec3 origin, math::Vec3 direction, const math::Vec3* vertices, float maxDistance,
+                 CastHit& hit);
+
+/// 1 / d for slab tests, large but finite for d at or near zero so that
+/// axis-parallel rays never see 0 * inf.
+inline float safeInverse(float d)
+{
+    return 1.0f / (std::fabs(d) > 1e-20f ? d : std::copysign(1e-20f, d));
+}
+
+/// Shape `a` translated from `start` along the unit `direction` against
+/// shape `b` at rest. Each iteration measures the GJK distance and moves to
+/// the separating plane at the closest points, which the convex Minkowski
+/// difference lies entirely behind, so the cast never steps past the first
+/// contact. Shapes that already touch hit at distance zero. A heightfield
+/// or mesh `b` is cast against triangle by triangle under the swept bounds.
+bool shapeCast(const Shape& a, const Transform& start, math::Vec3 direction, float maxDistance, const Shape& b,
+               const Transform& transformB, CastHit& hit);
+
+/// True when the shapes touch or interpenetrate.
+bool shapesOverlap(const Shape& a, const Transform& transformA, const Shape& b, const Transform& transformB);
+
+} // namespace rebel::physics
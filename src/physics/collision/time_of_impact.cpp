@@ -0,0 +1,92 @@
+#include "physics/collision/time_of_impact.h"
+
+#include "physics/collision/triangles.h"
+
+#include <cfloat>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kMaxAdvancements = 20;
+
+// timeOfImpact() against whatever `coreB(time)` places at each time.
+template <typename CoreB>
+bool advance(const Shape& a, const Sweep& sa, CoreB&& coreB, math::Vec3 relative, float angularBound, float duration,
+             float target, TimeOfImpact& result)
+{
+    // Stop within a quarter of the target so the last steps stay short.
+    const float tolerance = 0.25f * target;
+
+    float time = 0.0f;
+    for (uint32_t i = 0; i < kMaxAdvancements; ++i) {
+        const ConvexCore ca(a, sa.at(time));
+        const ConvexCore cb = coreB(time);
+        ClosestPoints points;
+        closestPoints(ca, cb, FLT_MAX, points);
+        const float distance = points.distance - ca.radius - cb.radius;
+        if (distance < target + tolerance) {
+            // Already touching at the start: an impact only if still closing
+            // fast enough to sink past the target within the sweep.
+            if (i == 0 && math::dot(relative, points.normal) * duration <= target)
+                return false;
+            result.time = time;
+            result.normal = points.normal;
+            result.point = points.pointA + points.normal * (ca.radius + 0.5f * distance);
+            return true;
+        }
+
+        const float closingSpeed = math::dot(relative, points.normal) + angularBound;
+        if (closingSpeed <= 0.0f)
+            return false;
+        time += (distance - target) / closingSpeed;
+        if (time >= duration)
+            return false;
+    }
+    // Out of iterations while still closing in; the last pose is safe.
+    const ConvexCore ca(a, sa.at(time));
+    const ConvexCore cb = coreB(time);
+    ClosestPoints points;
+    closestPoints(ca, cb, FLT_MAX, points);
+    result.time = time;
+    result.normal = points.normal;
+    result.point = points.pointA + points.normal * (ca.radius + 0.5f * (points.distance - ca.radius - cb.radius));
+    return true;
+}
+
+} // namespace
+
+bool timeOfImpact(const Shape& a, const Sweep& sa, const Shape& b, const Sweep& sb, float duration, float target,
+                  TimeOfImpact& result)
+{
+    const Vec3 relative = sa.linearVelocity - sb.linearVelocity;
+    if (!isTriangleShape(b.type)) {
+        const float angularBound = math::length(sa.angularVelocity) * boundingRadius(a) +
+                                   math::length(sb.angularVelocity) * boundingRadius(b);
+        return advance(a, sa, [&](float time) { return ConvexCore(b, sb.at(time)); }, relative, angularBound,
+                       duration, target, result);
+    }
+
+    // Static triangles: each impact found shortens the search of the rest.
+    const float angularBound = math::length(sa.angularVelocity) * boundingRadius(a);
+    Aabb swept = computeAabb(a, sa.at(0.0f));
+    const Aabb end = computeAabb(a, sa.at(duration));
+    swept.min = math::min(swept.min, end.min);
+    swept.max = math::max(swept.max, end.max);
+    swept = swept.expanded(angularBound * duration + target);
+    float earliest = duration;
+    bool found = false;
+    forEachTriangle(b, sb.start, swept, [&](uint32_t, const Vec3* v) {
+        TimeOfImpact impact;
+        if (advance(a, sa, [v](float) { return ConvexCore(v); }, relative, angularBound, earliest, target, impact)) {
+            result = impact;
+            earliest = impact.time;
+            found = true;
+        }
+    });
+    return found;
+}
+
+} // namespace rebel::physics
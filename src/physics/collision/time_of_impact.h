@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/math/quat.h"
+#include "core/math/vec.h"
+#include "physics/collision/gjk.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+
+namespace rebel::physics {
+
+/// A body's motion over one step at constant velocity, integrated the same
+/// way PhysicsWorld integrates positions, so at(dt) is the end-of-step pose.
+struct Sweep {
+    Transform start;
+    math::Vec3 linearVelocity{};
+    math::Vec3 angularVelocity{};
+
+    Transform at(float time) const
+    {
+        return {start.position + linearVelocity * time, math::integrate(start.rotation, angularVelocity, time)};
+    }
+};
+
+struct TimeOfImpact {
+    /// Seconds into the sweep at which the surfaces come within the target
+    /// distance.
+    float time = 0.0f;
+    /// Contact at `time`: midway between the surfaces, normal from A to B.
+    math::Vec3 point;
+    math::Vec3 normal;
+};
+
+/// Conservative advancement: repeatedly measures the GJK distance and moves
+/// both sweeps forward by that distance over an upper bound on the closing
+/// speed (the relative velocity along the normal plus each body's angular
+/// speed times its bounding radius), so the shapes can never pass through
+/// each other between samples.
+///
+/// Returns false when the surfaces stay farther than `target` apart for the
+/// whole `duration`. Shapes already that close at the start report an
+/// impact at time zero only while their linear velocities would carry them
+/// more than `target` deeper; resting contact is the regular contacts' job.
+///
+/// A heightfield or mesh `b` must be static: the earliest impact over the
+/// triangles under A's swept bounds is reported.
+bool timeOfImpact(const Shape& a, const Sweep& sa, const Shape& b, const Sweep& sb, float duration, float target,
+                  TimeOfImpact& result);
+
+} // namespace rebel::physics
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "core/math/quat.h"
+#include "physics/heightfield.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+#include "physics/triangle_mesh.h"
+
+namespace rebel::physics {
+
+/// Calls fn(id, vertices) with the three world-space vertices of every
+/// triangle of a heightfield or mesh shape placed at `transform` that may
+/// touch the world-space `box`. Triangle ids are stable per shape, so they
+/// can tell contact features apart across steps.
+template <typename Fn>
+void forEachTriangle(const Shape& shape, const Transform& transform, const Aabb& box, Fn&& fn)
+{
+    // The box's bounds in the shape's frame.
+    const Aabb local = computeAabb(Shape::box(box.extents()),
+                                   {transform.applyInverse(box.center()), math::conjugate(transform.rotation)});
+    // Terrain is rarely rotated, and unrotated shapes only need moving.
+    const math::Quat& q = transform.rotation;
+    const bool rotated = q.x != 0.0f || q.y != 0.0f || q.z != 0.0f;
+    auto toWorld = [&](uint32_t id, const math::Vec3* v) {
+        const math::Vec3 world[3] = {
+            rotated ? transform.apply(v[0]) : v[0] + transform.position,
+            rotated ? transform.apply(v[1]) : v[1] + transform.position,
+            rotated ? transform.apply(v[2]) : v[2] + transform.position,
+        };
+        fn(id, static_cast<const math::Vec3*>(world));
+    };
+    if (shape.type == ShapeType::Heightfield)
+        shape.field->queryTriangles(local, toWorld);
+    else
+        shape.mesh->queryTriangles(local, toWorld);
+}
+
+} // namespace rebel::physics
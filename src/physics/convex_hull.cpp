@@ -0,0 +1,138 @@
+#include "physics/convex_hull.h"
+
+#include "core/assert.h"
+#include "core/math/simd.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace rebel::physics {
+
+using math::Float4;
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kMaxFaceCandidates = 64;
+
+// Basis (u, v) of the plane perpendicular to the unit vector n.
+void planeBasis(Vec3 n, Vec3& u, Vec3& v)
+{
+    u = std::fabs(n.x) >= 0.57735f ? math::normalize(Vec3{n.y, -n.x, 0.0f}) : math::normalize(Vec3{0.0f, n.z, -n.y});
+    v = math::cross(n, u);
+}
+
+} // namespace
+
+ConvexHull::ConvexHull(std::span<const Vec3> points)
+    : count_(uint32_t(points.size()))
+{
+    REBEL_ASSERT(!points.empty(), "convex hull needs at least one point");
+    blocks_.resize((count_ + 3) / 4);
+    for (uint32_t i = 0; i < uint32_t(blocks_.size()) * 4; ++i) {
+        const Vec3 p = i < count_ ? points[i] : points[0];
+        Block& b = blocks_[i >> 2];
+        b.x[i & 3] = p.x;
+        b.y[i & 3] = p.y;
+        b.z[i & 3] = p.z;
+    }
+    for (const Vec3& p : points)
+        bounds_ = merge(bounds_, Aabb{p, p});
+}
+
+uint32_t ConvexHull::support(Vec3 direction) const
+{
+    const Float4 dx(direction.x), dy(direction.y), dz(direction.z);
+    Float4 best(-FLT_MAX);
+    Float4 bestBlock = Float4::zero();
+    Float4 block = Float4::zero();
+    for (const Block& b : blocks_) {
+        const Float4 d = Float4::loadAligned(b.x) * dx + Float4::loadAligned(b.y) * dy + Float4::loadAligned(b.z) * dz;
+        const Float4 better = math::cmpGt(d, best);
+        best = math::select(better, d, best);
+        bestBlock = math::select(better, block, bestBlock);
+        block += Float4(1.0f);
+    }
+
+    // Lowest index among equally good lanes keeps the choice stable.
+    alignas(16) float value[4], blockOf[4];
+    best.storeAligned(value);
+    bestBlock.storeAligned(blockOf);
+    uint32_t index = 0;
+    float top = -FLT_MAX;
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        const uint32_t i = uint32_t(blockOf[lane]) * 4 + lane;
+        if (value[lane] > top || (value[lane] == top && i < index)) {
+            top = value[lane];
+            index = i;
+        }
+    }
+    return std::min(index, count_ - 1);
+}
+
+uint32_t ConvexHull::supportingFace(Vec3 direction, float tolerance, uint32_t* indices, uint32_t capacity) const
+{
+    const Vec3 n = math::normalize(direction, {0.0f, 1.0f, 0.0f});
+    const float top = math::dot(point(support(n)), n);
+
+    uint32_t candidates[kMaxFaceCandidates];
+    uint32_t count = 0;
+    const Float4 threshold(top - tolerance);
+    const Float4 nx(n.x), ny(n.y), nz(n.z);
+    for (uint32_t b = 0; b < uint32_t(blocks_.size()) && count < kMaxFaceCandidates; ++b) {
+        const Block& block = blocks_[b];
+        const Float4 d =
+            Float4::loadAligned(block.x) * nx + Float4::loadAligned(block.y) * ny + Float4::loadAligned(block.z) * nz;
+        int mask = math::moveMask(math::cmpGe(d, threshold));
+        while (mask && count < kMaxFaceCandidates) {
+            const uint32_t i = b * 4 + uint32_t(__builtin_ctz(unsigned(mask)));
+            mask &= mask - 1;
+            if (i < count_)
+                candidates[count++] = i;
+        }
+    }
+    if (count < 3) {
+        count = std::min(count, capacity);
+        std::copy(candidates, candidates + count, indices);
+        return count;
+    }
+
+    // Monotone chain in the plane: drops interior and collinear points and
+    // leaves the rest counter-clockwise about n.
+    Vec3 u, v;
+    planeBasis(n, u, v);
+    struct Planar {
+        float x, y;
+        uint32_t index;
+    };
+    Planar planar[kMaxFaceCandidates];
+    for (uint32_t i = 0; i < count; ++i) {
+        const Vec3 p = point(candidates[i]);
+        planar[i] = {math::dot(p, u), math::dot(p, v), candidates[i]};
+    }
+    std::sort(planar, planar + count, [](const Planar& a, const Planar& b) {
+        return a.x < b.x || (a.x == b.x && (a.y < b.y || (a.y == b.y && a.index < b.index)));
+    });
+    auto turn = [](const Planar& o, const Planar& a, const Planar& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+    Planar hull[2 * kMaxFaceCandidates];
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        while (k >= 2 && turn(hull[k - 2], hull[k - 1], planar[i]) <= 0.0f)
+            --k;
+        hull[k++] = planar[i];
+    }
+    for (uint32_t i = count - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && turn(hull[k - 2], hull[k - 1], planar[i]) <= 0.0f)
+            --k;
+        hull[k++] = planar[i];
+    }
+    const uint32_t hullCount = std::min(k - 1, capacity);
+    for (uint32_t i = 0; i < hullCount; ++i)
+        indices[i] = hull[i].index;
+    return hullCount;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/aabb.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::physics {
+
+/// Convex point cloud for the GJK/EPA narrowphase, in body space.
+///
+/// Vertices are stored structure-of-arrays in blocks of four, so a support
+/// query tests four vertices per SSE step. Interior points are harmless
+/// but cost time; pass the hull's vertices where they are known. Shapes
+/// reference hulls by pointer, so a hull must outlive every body using it.
+class ConvexHull {
+public:
+    explicit ConvexHull(std::span<const math::Vec3> points);
+
+    uint32_t size() const { return count_; }
+    math::Vec3 point(uint32_t i) const
+    {
+        const Block& b = blocks_[i >> 2];
+        return {b.x[i & 3], b.y[i & 3], b.z[i & 3]};
+    }
+    /// Body-space bounds.
+    const Aabb& bounds() const { return bounds_; }
+
+    /// Index of the vertex farthest along `direction`.
+    uint32_t support(math::Vec3 direction) const;
+    /// Collects every vertex within `tolerance` of the support plane along
+    /// `direction`, ordered counter-clockwise around it when there are three
+    /// or more. Returns the count, at most `capacity`.
+    uint32_t supportingFace(math::Vec3 direction, float tolerance, uint32_t* indices, uint32_t capacity) const;
+
+private:
+    struct alignas(16) Block {
+        float x[4], y[4], z[4];
+    };
+
+    std::vector<Block> blocks_; // padded by repeating the first vertex
+    uint32_t count_ = 0;
+    Aabb bounds_;
+};
+
+} // namespace rebel::physics
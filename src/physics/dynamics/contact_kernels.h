@@ -0,0 +1,50 @@
+#pragma once
+
+#include "physics/collision/contact.h"
+#include "physics/dynamics/contact_solver.h"
+
+#include <cstdint>
+
+// Internal interface between ContactSolver and its per-ISA kernels.
+
+namespace rebel::physics::detail {
+
+/// Contacts per bundle. The SSE kernel solves a bundle as two halves of
+/// four; the AVX2 kernel takes all eight at once.
+inline constexpr uint32_t kBundleLanes = 8;
+
+struct alignas(32) ContactBundlePoint {
+    float rA[3][kBundleLanes];
+    float rB[3][kBundleLanes];
+    float normalMass[kBundleLanes];
+    float tangentMass1[kBundleLanes];
+    float tangentMass2[kBundleLanes];
+    float bias[kBundleLanes];
+    float normalImpulse[kBundleLanes];
+    float tangentImpulse1[kBundleLanes];
+    float tangentImpulse2[kBundleLanes];
+};
+
+/// Up to eight contacts of one colour, structure-of-arrays with one lane
+/// per contact. Padding lanes point both bodies at the static slot and have
+/// zero masses, so they compute zero impulses.
+struct alignas(64) ContactBundle {
+    uint32_t bodyA[kBundleLanes];
+    uint32_t bodyB[kBundleLanes];
+    uint32_t contact[kBundleLanes]; // UINT32_MAX for padding lanes
+    float normal[3][kBundleLanes];
+    float tangent1[3][kBundleLanes];
+    float tangent2[3][kBundleLanes];
+    float friction[kBundleLanes];
+    uint32_t pointCount;
+    uint32_t writeMask; // bit l: lane l's body A is dynamic; bit 8 + l: body B
+    ContactBundlePoint points[kMaxManifoldPoints];
+};
+
+/// Runs one velocity iteration over bundles [0, count) in order.
+using ContactKernel = void (*)(ContactBundle* bundles, uint32_t count, SolverBody* bodies);
+
+void solveBundlesSse(ContactBundle* bundles, uint32_t count, SolverBody* bodies);
+void solveBundlesAvx2(ContactBundle* bundles, uint32_t count, SolverBody* bodies);
+
+} // namespace rebel::physics::detail
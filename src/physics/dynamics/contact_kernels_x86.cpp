@@ -0,0 +1,219 @@
+#include "physics/dynamics/contact_kernels.h"
+
+#include "core/platform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// AVX2 variant of solveBundlesSse() (see contact_solver.cpp for the
+// reference). Every operation mirrors the SSE kernel in the same order and
+// nothing is fused, so both produce bit-identical velocities. ContactSolver
+// only selects it after checking detectSimdLevel().
+
+namespace rebel::physics::detail {
+
+namespace {
+
+struct Vec3x8 {
+    __m256 x, y, z;
+};
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE __m256 load(const float* p) { return _mm256_load_ps(p); }
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Vec3x8 load3(const float (&v)[3][kBundleLanes])
+{
+    return {load(v[0]), load(v[1]), load(v[2])};
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Vec3x8 add(const Vec3x8& a, const Vec3x8& b)
+{
+    return {_mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z)};
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Vec3x8 sub(const Vec3x8& a, const Vec3x8& b)
+{
+    return {_mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z)};
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Vec3x8 scale(const Vec3x8& a, __m256 s)
+{
+    return {_mm256_mul_ps(a.x, s), _mm256_mul_ps(a.y, s), _mm256_mul_ps(a.z, s)};
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE __m256 dot(const Vec3x8& a, const Vec3x8& b)
+{
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y)), _mm256_mul_ps(a.z, b.z));
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Vec3x8 cross(const Vec3x8& a, const Vec3x8& b)
+{
+    return {_mm256_sub_ps(_mm256_mul_ps(a.y, b.z), _mm256_mul_ps(a.z, b.y)),
+            _mm256_sub_ps(_mm256_mul_ps(a.z, b.x), _mm256_mul_ps(a.x, b.z)),
+            _mm256_sub_ps(_mm256_mul_ps(a.x, b.y), _mm256_mul_ps(a.y, b.x))};
+}
+
+// Eight bodies transposed into lanes.
+struct BodyLanes8 {
+    Vec3x8 v;
+    __m256 inverseMass;
+    Vec3x8 w;
+    __m256 ixx, iyy, izz, ixy, ixz, iyz;
+};
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Vec3x8 applyInertia(const BodyLanes8& b, const Vec3x8& t)
+{
+    return {_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b.ixx, t.x), _mm256_mul_ps(b.ixy, t.y)), _mm256_mul_ps(b.ixz, t.z)),
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b.ixy, t.x), _mm256_mul_ps(b.iyy, t.y)), _mm256_mul_ps(b.iyz, t.z)),
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b.ixz, t.x), _mm256_mul_ps(b.iyz, t.y)), _mm256_mul_ps(b.izz, t.z))};
+}
+
+// 4x4 transpose within each 128-bit half: rows [body k | body k + 4] in,
+// columns out (and back).
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void transpose(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void loadRows(const SolverBody* bodies, const uint32_t* index, uint32_t offset,
+                                                  __m256 (&rows)[4])
+{
+    for (int k = 0; k < 4; ++k) {
+        const float* lo = reinterpret_cast<const float*>(&bodies[index[k]]) + offset;
+        const float* hi = reinterpret_cast<const float*>(&bodies[index[k + 4]]) + offset;
+        rows[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(lo)), _mm_load_ps(hi), 1);
+    }
+    transpose(rows[0], rows[1], rows[2], rows[3]);
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void gather(const SolverBody* bodies, const uint32_t* index, BodyLanes8& out)
+{
+    __m256 rows[4];
+    loadRows(bodies, index, 0, rows);
+    out.v = {rows[0], rows[1], rows[2]};
+    out.inverseMass = rows[3];
+    loadRows(bodies, index, 4, rows);
+    out.w = {rows[0], rows[1], rows[2]};
+    loadRows(bodies, index, 8, rows);
+    out.ixx = rows[0];
+    out.iyy = rows[1];
+    out.izz = rows[2];
+    out.ixy = rows[3];
+    loadRows(bodies, index, 12, rows);
+    out.ixz = rows[0];
+    out.iyz = rows[1];
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void storeRows(SolverBody* bodies, const uint32_t* index, uint32_t offset,
+                                                   uint32_t mask, __m256 r0, __m256 r1, __m256 r2, __m256 r3)
+{
+    transpose(r0, r1, r2, r3);
+    const __m256 rows[4] = {r0, r1, r2, r3};
+    for (uint32_t k = 0; k < 4; ++k) {
+        if (mask & (1u << k))
+            _mm_store_ps(reinterpret_cast<float*>(&bodies[index[k]]) + offset, _mm256_castps256_ps128(rows[k]));
+        if (mask & (16u << k))
+            _mm_store_ps(reinterpret_cast<float*>(&bodies[index[k + 4]]) + offset, _mm256_extractf128_ps(rows[k], 1));
+    }
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void scatter(SolverBody* bodies, const uint32_t* index, uint32_t mask,
+                                                 const BodyLanes8& b)
+{
+    storeRows(bodies, index, 0, mask, b.v.x, b.v.y, b.v.z, b.inverseMass);
+    storeRows(bodies, index, 4, mask, b.w.x, b.w.y, b.w.z, _mm256_setzero_ps());
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE __m256 clamp(__m256 v, __m256 lo, __m256 hi)
+{
+    return _mm256_min_ps(_mm256_max_ps(v, lo), hi);
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE __m256 negate(__m256 v) { return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f)); }
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void applyImpulse(BodyLanes8& a, BodyLanes8& b, const Vec3x8& rA, const Vec3x8& rB,
+                                                      const Vec3x8& impulse)
+{
+    a.v = sub(a.v, scale(impulse, a.inverseMass));
+    a.w = sub(a.w, applyInertia(a, cross(rA, impulse)));
+    b.v = add(b.v, scale(impulse, b.inverseMass));
+    b.w = add(b.w, applyInertia(b, cross(rB, impulse)));
+}
+
+REBEL_TARGET_AVX2 void solveBundle(ContactBundle& bundle, SolverBody* bodies)
+{
+    BodyLanes8 a, b;
+    gather(bodies, bundle.bodyA, a);
+    gather(bodies, bundle.bodyB, b);
+
+    const Vec3x8 n = load3(bundle.normal);
+    const Vec3x8 t1 = load3(bundle.tangent1);
+    const Vec3x8 t2 = load3(bundle.tangent2);
+    const __m256 friction = load(bundle.friction);
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (uint32_t p = 0; p < bundle.pointCount; ++p) {
+        ContactBundlePoint& point = bundle.points[p];
+        const Vec3x8 rA = load3(point.rA);
+        const Vec3x8 rB = load3(point.rB);
+
+        {
+            const Vec3x8 dv = sub(sub(add(b.v, cross(b.w, rB)), a.v), cross(a.w, rA));
+            const __m256 limit = _mm256_mul_ps(friction, load(point.normalImpulse));
+
+            const __m256 old1 = load(point.tangentImpulse1);
+            const __m256 new1 =
+                clamp(_mm256_sub_ps(old1, _mm256_mul_ps(load(point.tangentMass1), dot(dv, t1))), negate(limit), limit);
+            _mm256_store_ps(point.tangentImpulse1, new1);
+            const __m256 old2 = load(point.tangentImpulse2);
+            const __m256 new2 =
+                clamp(_mm256_sub_ps(old2, _mm256_mul_ps(load(point.tangentMass2), dot(dv, t2))), negate(limit), limit);
+            _mm256_store_ps(point.tangentImpulse2, new2);
+
+            applyImpulse(a, b, rA, rB, add(scale(t1, _mm256_sub_ps(new1, old1)), scale(t2, _mm256_sub_ps(new2, old2))));
+        }
+
+        {
+            const Vec3x8 dv = sub(sub(add(b.v, cross(b.w, rB)), a.v), cross(a.w, rA));
+            const __m256 old = load(point.normalImpulse);
+            const __m256 lambda = _mm256_mul_ps(load(point.normalMass), _mm256_sub_ps(load(point.bias), dot(dv, n)));
+            const __m256 updated = _mm256_max_ps(_mm256_add_ps(old, lambda), zero);
+            _mm256_store_ps(point.normalImpulse, updated);
+
+            applyImpulse(a, b, rA, rB, scale(n, _mm256_sub_ps(updated, old)));
+        }
+    }
+
+    scatter(bodies, bundle.bodyA, bundle.writeMask & 0xFFu, a);
+    scatter(bodies, bundle.bodyB, bundle.writeMask >> 8, b);
+}
+
+} // namespace
+
+REBEL_TARGET_AVX2 void solveBundlesAvx2(ContactBundle* bundles, uint32_t count, SolverBody* bodies)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        solveBundle(bundles[i], bodies);
+}
+
+} // namespace rebel::physics::detail
+
+#else
+
+namespace rebel::physics::detail {
+
+void solveBundlesAvx2(ContactBundle* bundles, uint32_t count, SolverBody* bodies)
+{
+    solveBundlesSse(bundles, count, bodies);
+}
+
+} // namespace rebel::physics::detail
+
+#endif
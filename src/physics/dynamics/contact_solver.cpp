@@ -0,0 +1,458 @@
+#include "physics/dynamics/contact_solver.h"
+
+#include "physics/dynamics/contact_kernels.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/math/simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace rebel::physics {
+
+using detail::ContactBundle;
+using detail::kBundleLanes;
+using math::Float4;
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kBundlesPerJob = 16;
+constexpr uint8_t kOverflowColor = ContactSolver::kMaxColors;
+
+struct Vec3x4 {
+    Float4 x, y, z;
+};
+
+REBEL_FORCEINLINE Vec3x4 operator+(const Vec3x4& a, const Vec3x4& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+REBEL_FORCEINLINE Vec3x4 operator-(const Vec3x4& a, const Vec3x4& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+REBEL_FORCEINLINE Vec3x4 operator*(const Vec3x4& a, Float4 s) { return {a.x * s, a.y * s, a.z * s}; }
+REBEL_FORCEINLINE Float4 dot(const Vec3x4& a, const Vec3x4& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+REBEL_FORCEINLINE Vec3x4 cross(const Vec3x4& a, const Vec3x4& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+REBEL_FORCEINLINE Vec3x4 load3(const float (&v)[3][kBundleLanes], uint32_t lane)
+{
+    return {Float4::loadAligned(v[0] + lane), Float4::loadAligned(v[1] + lane), Float4::loadAligned(v[2] + lane)};
+}
+
+// Four bodies transposed into lanes.
+struct BodyLanes {
+    Vec3x4 v;
+    Float4 inverseMass;
+    Vec3x4 w;
+    Float4 ixx, iyy, izz, ixy, ixz, iyz;
+
+    REBEL_FORCEINLINE Vec3x4 applyInertia(const Vec3x4& t) const
+    {
+        return {ixx * t.x + ixy * t.y + ixz * t.z, ixy * t.x + iyy * t.y + iyz * t.z, ixz * t.x + iyz * t.y + izz * t.z};
+    }
+};
+
+REBEL_FORCEINLINE void gather(const SolverBody* bodies, const uint32_t* index, BodyLanes& out)
+{
+    const SolverBody& b0 = bodies[index[0]];
+    const SolverBody& b1 = bodies[index[1]];
+    const SolverBody& b2 = bodies[index[2]];
+    const SolverBody& b3 = bodies[index[3]];
+
+    Float4 r0 = Float4::loadAligned(b0.linear), r1 = Float4::loadAligned(b1.linear);
+    Float4 r2 = Float4::loadAligned(b2.linear), r3 = Float4::loadAligned(b3.linear);
+    math::transpose4(r0, r1, r2, r3);
+    out.v = {r0, r1, r2};
+    out.inverseMass = r3;
+
+    r0 = Float4::loadAligned(b0.angular), r1 = Float4::loadAligned(b1.angular);
+    r2 = Float4::loadAligned(b2.angular), r3 = Float4::loadAligned(b3.angular);
+    math::transpose4(r0, r1, r2, r3);
+    out.w = {r0, r1, r2};
+
+    r0 = Float4::loadAligned(b0.inverseInertia), r1 = Float4::loadAligned(b1.inverseInertia);
+    r2 = Float4::loadAligned(b2.inverseInertia), r3 = Float4::loadAligned(b3.inverseInertia);
+    math::transpose4(r0, r1, r2, r3);
+    out.ixx = r0;
+    out.iyy = r1;
+    out.izz = r2;
+    out.ixy = r3;
+
+    r0 = Float4::loadAligned(b0.inverseInertia + 4), r1 = Float4::loadAligned(b1.inverseInertia + 4);
+    r2 = Float4::loadAligned(b2.inverseInertia + 4), r3 = Float4::loadAligned(b3.inverseInertia + 4);
+    math::transpose4(r0, r1, r2, r3);
+    out.ixz = r0;
+    out.iyz = r1;
+}
+
+// Writes velocities back for the lanes set in `mask`; other lanes belong to
+// static/kinematic bodies or padding and must not be touched.
+REBEL_FORCEINLINE void scatter(SolverBody* bodies, const uint32_t* index, uint32_t mask, const BodyLanes& lanes)
+{
+    Float4 l0 = lanes.v.x, l1 = lanes.v.y, l2 = lanes.v.z, l3 = lanes.inverseMass;
+    math::transpose4(l0, l1, l2, l3);
+    Float4 a0 = lanes.w.x, a1 = lanes.w.y, a2 = lanes.w.z, a3 = Float4::zero();
+    math::transpose4(a0, a1, a2, a3);
+    const Float4 linear[4] = {l0, l1, l2, l3};
+    const Float4 angular[4] = {a0, a1, a2, a3};
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        if (mask & (1u << lane)) {
+            linear[lane].storeAligned(bodies[index[lane]].linear);
+            angular[lane].storeAligned(bodies[index[lane]].angular);
+        }
+    }
+}
+
+// Any unit vector perpendicular to n.
+Vec3 perpendicular(Vec3 n)
+{
+    return std::fabs(n.x) >= 0.57735f ? math::normalize(Vec3{n.y, -n.x, 0.0f}) : math::normalize(Vec3{0.0f, n.z, -n.y});
+}
+
+} // namespace
+
+void ContactSolver::prepare(std::span<const SolverContact> contacts, std::span<const SolverBody> bodies,
+                            std::span<const math::Vec3> centers, float dt, const ContactSolverSettings& settings,
+                            jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(bodies.size() == centers.size(), "one centre per solver body");
+    const uint32_t contactCount = uint32_t(contacts.size());
+    settings_ = settings;
+    contacts_ = contacts;
+    invDt_ = dt > 0.0f ? 1.0f / dt : 0.0f;
+    stats_ = {};
+    stats_.contacts = contactCount;
+
+    // Greedy colouring in contact order. Only dynamic bodies constrain the
+    // colour; static and kinematic bodies are read-only in the solver.
+    bodyColors_.assign(bodies.size(), 0);
+    contactColor_.resize(contactCount);
+    uint32_t colorCounts[kMaxColors + 1] = {};
+    for (uint32_t c = 0; c < contactCount; ++c) {
+        const uint32_t a = contacts[c].bodyA, b = contacts[c].bodyB;
+        const bool dynamicA = bodies[a].linear[3] > 0.0f;
+        const bool dynamicB = bodies[b].linear[3] > 0.0f;
+        const uint32_t used = (dynamicA ? bodyColors_[a] : 0u) | (dynamicB ? bodyColors_[b] : 0u);
+        uint8_t color = kOverflowColor;
+        if (used != ~0u) {
+            color = uint8_t(std::countr_zero(~used));
+            if (dynamicA)
+                bodyColors_[a] |= 1u << color;
+            if (dynamicB)
+                bodyColors_[b] |= 1u << color;
+        }
+        contactColor_[c] = color;
+        ++colorCounts[color];
+    }
+
+    // Colours take ceil(count / 8) bundles; overflow contacts get one
+    // bundle each since they may conflict with one another.
+    colorStart_.assign(kMaxColors + 2, 0);
+    for (uint32_t k = 0; k < kMaxColors; ++k) {
+        colorStart_[k + 1] = colorStart_[k] + (colorCounts[k] + kBundleLanes - 1) / kBundleLanes;
+        stats_.colors += colorCounts[k] > 0;
+    }
+    colorStart_[kMaxColors + 1] = colorStart_[kMaxColors] + colorCounts[kOverflowColor];
+    stats_.overflow = colorCounts[kOverflowColor];
+    const uint32_t bundleCount = colorStart_[kMaxColors + 1];
+    stats_.bundles = bundleCount;
+
+    bundles_.resize(bundleCount);
+    for (ContactBundle& bundle : bundles_)
+        std::fill_n(bundle.contact, kBundleLanes, UINT32_MAX);
+    uint32_t cursor[kMaxColors + 1] = {};
+    for (uint32_t c = 0; c < contactCount; ++c) {
+        const uint8_t color = contactColor_[c];
+        const uint32_t slot = cursor[color]++;
+        if (color == kOverflowColor)
+            bundles_[colorStart_[kMaxColors] + slot].contact[0] = c;
+        else
+            bundles_[colorStart_[color] + slot / kBundleLanes].contact[slot % kBundleLanes] = c;
+    }
+
+    jobs.parallelFor(bundleCount, kBundlesPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            prepareBundle(bundles_[i], contacts.data(), bodies.data(), centers.data());
+    });
+}
+
+void ContactSolver::prepareBundle(ContactBundle& bundle, const SolverContact* contacts, const SolverBody* bodies,
+                                  const math::Vec3* centers) const
+{
+    bundle.pointCount = 0;
+    bundle.writeMask = 0;
+
+    // Per-lane inputs are staged scalar; the mass and bias maths then runs
+    // four lanes at a time.
+    alignas(16) float position[kMaxManifoldPoints][3][kBundleLanes];
+    alignas(16) float separation[kMaxManifoldPoints][kBundleLanes];
+    alignas(16) float centerA[3][kBundleLanes], centerB[3][kBundleLanes];
+    alignas(16) float restitution[kBundleLanes];
+    alignas(16) float pointMask[kMaxManifoldPoints][kBundleLanes];
+    alignas(16) float impulse[kMaxManifoldPoints][3][kBundleLanes];
+
+    for (uint32_t lane = 0; lane < kBundleLanes; ++lane) {
+        const uint32_t c = bundle.contact[lane];
+        const SolverContact* contact = c != UINT32_MAX ? &contacts[c] : nullptr;
+        // Padding lanes use the static slot for both bodies and get zero
+        // masses, so they compute zero impulses.
+        const uint32_t a = contact ? contact->bodyA : 0;
+        const uint32_t b = contact ? contact->bodyB : 0;
+        bundle.bodyA[lane] = a;
+        bundle.bodyB[lane] = b;
+        bundle.writeMask |= (bodies[a].linear[3] > 0.0f ? 1u << lane : 0u) | (bodies[b].linear[3] > 0.0f ? 256u << lane : 0u);
+
+        const ContactManifold* manifold = contact ? contact->manifold : nullptr;
+        const Vec3 n = manifold ? manifold->normal : Vec3{0.0f, 1.0f, 0.0f};
+        const Vec3 t1 = perpendicular(n);
+        const Vec3 t2 = math::cross(n, t1);
+        const uint32_t pointCount = manifold ? manifold->pointCount : 0;
+        for (int k = 0; k < 3; ++k) {
+            bundle.normal[k][lane] = n[k];
+            bundle.tangent1[k][lane] = t1[k];
+            bundle.tangent2[k][lane] = t2[k];
+            centerA[k][lane] = centers[a][k];
+            centerB[k][lane] = centers[b][k];
+        }
+        bundle.friction[lane] = contact ? contact->friction : 0.0f;
+        restitution[lane] = contact ? contact->restitution : 0.0f;
+        bundle.pointCount = std::max(bundle.pointCount, pointCount);
+
+        for (uint32_t p = 0; p < kMaxManifoldPoints; ++p) {
+            const bool valid = p < pointCount;
+            const Vec3 pos = valid ? manifold->points[p].position : centers[a];
+            for (int k = 0; k < 3; ++k)
+                position[p][k][lane] = pos[k];
+            separation[p][lane] = valid ? manifold->points[p].separation : 0.0f;
+            pointMask[p][lane] = valid ? 1.0f : 0.0f;
+            const bool warm = valid && settings_.warmStarting;
+            impulse[p][0][lane] = warm ? manifold->points[p].normalImpulse : 0.0f;
+            impulse[p][1][lane] = warm ? manifold->points[p].tangentImpulse[0] : 0.0f;
+            impulse[p][2][lane] = warm ? manifold->points[p].tangentImpulse[1] : 0.0f;
+        }
+    }
+
+    const Float4 zero = Float4::zero();
+    const Float4 invDt(invDt_);
+    const Float4 baumgarte(settings_.baumgarte * invDt_);
+    const Float4 slop(settings_.linearSlop);
+    const Float4 maxBias(settings_.maxBiasVelocity);
+    const Float4 restitutionThreshold(-settings_.restitutionThreshold);
+
+    for (uint32_t lane = 0; lane < kBundleLanes; lane += 4) {
+        BodyLanes a, b;
+        gather(bodies, bundle.bodyA + lane, a);
+        gather(bodies, bundle.bodyB + lane, b);
+        const Vec3x4 cA = load3(centerA, lane), cB = load3(centerB, lane);
+        const Vec3x4 n = load3(bundle.normal, lane);
+        const Vec3x4 t1 = load3(bundle.tangent1, lane);
+        const Vec3x4 t2 = load3(bundle.tangent2, lane);
+        const Float4 e = Float4::loadAligned(restitution + lane);
+        const Float4 baseMass = a.inverseMass + b.inverseMass;
+
+        // 1 / (mA + mB + (rA x d) . IA (rA x d) + (rB x d) . IB (rB x d)),
+        // zero for missing points.
+        auto effectiveMass = [&](const Vec3x4& rA, const Vec3x4& rB, const Vec3x4& d, Float4 valid) {
+            const Vec3x4 raxd = cross(rA, d), rbxd = cross(rB, d);
+            const Float4 k = baseMass + dot(raxd, a.applyInertia(raxd)) + dot(rbxd, b.applyInertia(rbxd));
+            const Float4 usable = math::cmpGt(k, zero) & math::cmpGt(valid, zero);
+            return math::select(usable, Float4(1.0f) / math::select(usable, k, Float4(1.0f)), zero);
+        };
+
+        for (uint32_t p = 0; p < kMaxManifoldPoints; ++p) {
+            detail::ContactBundlePoint& point = bundle.points[p];
+            const Float4 valid = Float4::loadAligned(pointMask[p] + lane);
+            const Vec3x4 pos = load3(position[p], lane);
+            const Vec3x4 rA = pos - cA, rB = pos - cB;
+            rA.x.storeAligned(point.rA[0] + lane);
+            rA.y.storeAligned(point.rA[1] + lane);
+            rA.z.storeAligned(point.rA[2] + lane);
+            rB.x.storeAligned(point.rB[0] + lane);
+            rB.y.storeAligned(point.rB[1] + lane);
+            rB.z.storeAligned(point.rB[2] + lane);
+            effectiveMass(rA, rB, n, valid).storeAligned(point.normalMass + lane);
+            effectiveMass(rA, rB, t1, valid).storeAligned(point.tangentMass1 + lane);
+            effectiveMass(rA, rB, t2, valid).storeAligned(point.tangentMass2 + lane);
+
+            // Separated (speculative) points may close the gap this step but
+            // no further; penetrating ones are pushed out gradually.
+            const Float4 sep = Float4::loadAligned(separation[p] + lane);
+            const Float4 push = math::min(baumgarte * math::max(-sep - slop, zero), maxBias);
+            Float4 bias = math::select(math::cmpGt(sep, zero), -sep * invDt, push);
+            // Bounce only once the gap actually closes this step, so a
+            // speculative point ahead of a fast body does not push it away
+            // early.
+            const Float4 approach = dot(b.v + cross(b.w, rB) - a.v - cross(a.w, rA), n);
+            const Float4 bounces =
+                math::cmpLt(approach, restitutionThreshold) & math::cmpLt(approach + math::max(sep, zero) * invDt, zero);
+            bias = math::select(bounces, math::max(bias, -e * approach), bias);
+            (bias * valid).storeAligned(point.bias + lane);
+
+            Float4::loadAligned(impulse[p][0] + lane).storeAligned(point.normalImpulse + lane);
+            Float4::loadAligned(impulse[p][1] + lane).storeAligned(point.tangentImpulse1 + lane);
+            Float4::loadAligned(impulse[p][2] + lane).storeAligned(point.tangentImpulse2 + lane);
+        }
+    }
+}
+
+namespace {
+
+// Solves lanes [lane, lane + 4) of a bundle.
+void solveHalf(ContactBundle& bundle, uint32_t lane, SolverBody* bodies)
+{
+    BodyLanes a, b;
+    gather(bodies, bundle.bodyA + lane, a);
+    gather(bodies, bundle.bodyB + lane, b);
+
+    const Vec3x4 n = load3(bundle.normal, lane);
+    const Vec3x4 t1 = load3(bundle.tangent1, lane);
+    const Vec3x4 t2 = load3(bundle.tangent2, lane);
+    const Float4 friction = Float4::loadAligned(bundle.friction + lane);
+    const Float4 zero = Float4::zero();
+
+    for (uint32_t p = 0; p < bundle.pointCount; ++p) {
+        detail::ContactBundlePoint& point = bundle.points[p];
+        const Vec3x4 rA = load3(point.rA, lane);
+        const Vec3x4 rB = load3(point.rB, lane);
+
+        // Friction first, bounded by the current normal impulse.
+        {
+            const Vec3x4 dv = b.v + cross(b.w, rB) - a.v - cross(a.w, rA);
+            const Float4 limit = friction * Float4::loadAligned(point.normalImpulse + lane);
+
+            const Float4 old1 = Float4::loadAligned(point.tangentImpulse1 + lane);
+            const Float4 new1 =
+                math::clamp(old1 - Float4::loadAligned(point.tangentMass1 + lane) * dot(dv, t1), -limit, limit);
+            new1.storeAligned(point.tangentImpulse1 + lane);
+            const Float4 old2 = Float4::loadAligned(point.tangentImpulse2 + lane);
+            const Float4 new2 =
+                math::clamp(old2 - Float4::loadAligned(point.tangentMass2 + lane) * dot(dv, t2), -limit, limit);
+            new2.storeAligned(point.tangentImpulse2 + lane);
+
+            const Vec3x4 impulse = t1 * (new1 - old1) + t2 * (new2 - old2);
+            a.v = a.v - impulse * a.inverseMass;
+            a.w = a.w - a.applyInertia(cross(rA, impulse));
+            b.v = b.v + impulse * b.inverseMass;
+            b.w = b.w + b.applyInertia(cross(rB, impulse));
+        }
+
+        {
+            const Vec3x4 dv = b.v + cross(b.w, rB) - a.v - cross(a.w, rA);
+            const Float4 old = Float4::loadAligned(point.normalImpulse + lane);
+            const Float4 lambda =
+                Float4::loadAligned(point.normalMass + lane) * (Float4::loadAligned(point.bias + lane) - dot(dv, n));
+            const Float4 updated = math::max(old + lambda, zero);
+            updated.storeAligned(point.normalImpulse + lane);
+
+            const Vec3x4 impulse = n * (updated - old);
+            a.v = a.v - impulse * a.inverseMass;
+            a.w = a.w - a.applyInertia(cross(rA, impulse));
+            b.v = b.v + impulse * b.inverseMass;
+            b.w = b.w + b.applyInertia(cross(rB, impulse));
+        }
+    }
+
+    scatter(bodies, bundle.bodyA + lane, (bundle.writeMask >> lane) & 0xFu, a);
+    scatter(bodies, bundle.bodyB + lane, (bundle.writeMask >> (8 + lane)) & 0xFu, b);
+}
+
+// Applies the impulses carried over from the previous step.
+void warmStartHalf(ContactBundle& bundle, uint32_t lane, SolverBody* bodies)
+{
+    BodyLanes a, b;
+    gather(bodies, bundle.bodyA + lane, a);
+    gather(bodies, bundle.bodyB + lane, b);
+
+    const Vec3x4 n = load3(bundle.normal, lane);
+    const Vec3x4 t1 = load3(bundle.tangent1, lane);
+    const Vec3x4 t2 = load3(bundle.tangent2, lane);
+    for (uint32_t p = 0; p < bundle.pointCount; ++p) {
+        const detail::ContactBundlePoint& point = bundle.points[p];
+        const Vec3x4 rA = load3(point.rA, lane);
+        const Vec3x4 rB = load3(point.rB, lane);
+        const Vec3x4 impulse = n * Float4::loadAligned(point.normalImpulse + lane) +
+                               t1 * Float4::loadAligned(point.tangentImpulse1 + lane) +
+                               t2 * Float4::loadAligned(point.tangentImpulse2 + lane);
+        a.v = a.v - impulse * a.inverseMass;
+        a.w = a.w - a.applyInertia(cross(rA, impulse));
+        b.v = b.v + impulse * b.inverseMass;
+        b.w = b.w + b.applyInertia(cross(rB, impulse));
+    }
+
+    scatter(bodies, bundle.bodyA + lane, (bundle.writeMask >> lane) & 0xFu, a);
+    scatter(bodies, bundle.bodyB + lane, (bundle.writeMask >> (8 + lane)) & 0xFu, b);
+}
+
+} // namespace
+
+namespace detail {
+
+void solveBundlesSse(ContactBundle* bundles, uint32_t count, SolverBody* bodies)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        solveHalf(bundles[i], 0, bodies);
+        // Lanes are filled in order, so an empty upper half is all padding.
+        if (bundles[i].contact[4] != UINT32_MAX)
+            solveHalf(bundles[i], 4, bodies);
+    }
+}
+
+} // namespace detail
+
+ContactSolver::ContactSolver(SimdLevel level)
+    : level_(std::min(level, detectSimdLevel()))
+    , kernel_(level_ >= SimdLevel::Avx2 ? detail::solveBundlesAvx2 : detail::solveBundlesSse)
+{
+}
+
+ContactSolver::~ContactSolver() = default;
+
+template <typename Fn>
+void ContactSolver::forEachColor(jobs::JobSystem& jobs, Fn&& fn)
+{
+    for (uint32_t color = 0; color < kMaxColors; ++color) {
+        const uint32_t begin = colorStart_[color];
+        const uint32_t count = colorStart_[color + 1] - begin;
+        jobs.parallelFor(count, kBundlesPerJob, [&](uint32_t first, uint32_t last) {
+            fn(bundles_.data() + begin + first, last - first);
+        });
+    }
+    fn(bundles_.data() + colorStart_[kMaxColors], colorStart_[kMaxColors + 1] - colorStart_[kMaxColors]);
+}
+
+void ContactSolver::solve(std::span<SolverBody> bodies, jobs::JobSystem& jobs)
+{
+    SolverBody* const bodyData = bodies.data();
+    if (settings_.warmStarting) {
+        // Shared by both kernels so SSE and AVX2 runs stay identical.
+        forEachColor(jobs, [&](ContactBundle* bundles, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i) {
+                warmStartHalf(bundles[i], 0, bodyData);
+                if (bundles[i].contact[4] != UINT32_MAX)
+                    warmStartHalf(bundles[i], 4, bodyData);
+            }
+        });
+    }
+    for (uint32_t iteration = 0; iteration < settings_.velocityIterations; ++iteration)
+        forEachColor(jobs, [&](ContactBundle* bundles, uint32_t count) { kernel_(bundles, count, bodyData); });
+
+    // Each contact sits in exactly one bundle, so the write-back is parallel.
+    jobs.parallelFor(uint32_t(bundles_.size()), kBundlesPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const ContactBundle& bundle = bundles_[i];
+            for (uint32_t lane = 0; lane < kBundleLanes; ++lane) {
+                if (bundle.contact[lane] == UINT32_MAX)
+                    continue;
+                ContactManifold& manifold = *contacts_[bundle.contact[lane]].manifold;
+                for (uint32_t p = 0; p < manifold.pointCount; ++p) {
+                    const detail::ContactBundlePoint& point = bundle.points[p];
+                    manifold.points[p].normalImpulse = point.normalImpulse[lane];
+                    manifold.points[p].tangentImpulse[0] = point.tangentImpulse1[lane];
+                    manifold.points[p].tangentImpulse[1] = point.tangentImpulse2[lane];
+                }
+            }
+        }
+    });
+}
+
+} // namespace rebel::physics
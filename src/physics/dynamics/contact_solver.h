@@ -0,0 +1,125 @@
+#pragma once
+
+#include "core/cpu_features.h"
+#include "core/math/vec.h"
+#include "physics/collision/contact.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+namespace detail {
+struct ContactBundle;
+}
+
+/// Velocity state the solver reads and writes, one per awake body. Laid out
+/// so four bodies transpose straight into SIMD lanes. Index 0 is reserved
+/// for static geometry (zero velocity, zero inverse mass) and is never
+/// written.
+struct alignas(64) SolverBody {
+    float linear[4];          // velocity xyz, inverse mass
+    float angular[4];         // angular velocity xyz, unused
+    float inverseInertia[8];  // world space, symmetric: xx yy zz xy | xz yz - -
+};
+
+struct SolverContact {
+    uint32_t bodyA = 0; // SolverBody indices
+    uint32_t bodyB = 0;
+    float friction = 0.6f;
+    float restitution = 0.0f;
+    /// Point impulses are read to warm start and written back after solving.
+    ContactManifold* manifold = nullptr;
+};
+
+struct ContactSolverSettings {
+    uint32_t velocityIterations = 8;
+    /// Fraction of the penetration (beyond the slop) removed per step.
+    float baumgarte = 0.2f;
+    float linearSlop = 0.005f;
+    /// Cap on the velocity the position bias may inject.
+    float maxBiasVelocity = 4.0f;
+    /// Approach speeds below this do not bounce.
+    float restitutionThreshold = 1.0f;
+    /// Start from the impulses stored in the manifolds. Stacks that need
+    /// about 20 cold iterations settle in 4 warm ones.
+    bool warmStarting = true;
+};
+
+struct ContactSolverStats {
+    uint32_t contacts = 0;
+    uint32_t colors = 0;
+    uint32_t bundles = 0;
+    uint32_t overflow = 0; // contacts that did not fit a colour, solved serially
+};
+
+/// Projected Gauss-Seidel contact solver with friction, vectorised across
+/// constraints.
+///
+/// prepare() greedily graph-colours the contacts so no two contacts of a
+/// colour share a dynamic body, then packs each colour into bundles of
+/// eight contacts stored structure-of-arrays, one SIMD lane per contact.
+/// Within a colour bundles are independent, so every iteration runs each
+/// colour as a parallelFor; bodies are gathered into lanes with 4x4
+/// transposes. Static and kinematic bodies take no part in colouring since
+/// they are never written. Contacts beyond kMaxColors go to a serial
+/// overflow pass.
+///
+/// With warm starting, solve() first applies each point's impulse from the
+/// previous step (kept in the persistent manifold), then iterates, then
+/// writes the accumulated impulses back to the manifolds.
+///
+/// The SSE and AVX2 kernels perform the same operations in the same order
+/// without fused multiply-adds, so they produce identical results.
+class ContactSolver {
+public:
+    static constexpr uint32_t kMaxColors = 32;
+
+    /// `level` is clamped to what the CPU supports. AVX-512 uses the AVX2
+    /// kernel.
+    explicit ContactSolver(SimdLevel level = detectSimdLevel());
+    ~ContactSolver();
+
+    ContactSolver(const ContactSolver&) = delete;
+    ContactSolver& operator=(const ContactSolver&) = delete;
+
+    SimdLevel simdLevel() const { return level_; }
+
+    /// `centers` holds each SolverBody's centre of mass. Both spans and the
+    /// manifolds must stay valid until solve() returns.
+    void prepare(std::span<const SolverContact> contacts, std::span<const SolverBody> bodies,
+                 std::span<const math::Vec3> centers, float dt, const ContactSolverSettings& settings,
+                 jobs::JobSystem& jobs);
+
+    /// Runs the velocity iterations, updating `bodies` in place, and stores
+    /// the impulses in the manifolds.
+    void solve(std::span<SolverBody> bodies, jobs::JobSystem& jobs);
+
+    const ContactSolverStats& stats() const { return stats_; }
+
+private:
+    void prepareBundle(detail::ContactBundle& bundle, const SolverContact* contacts, const SolverBody* bodies,
+                       const math::Vec3* centers) const;
+    /// Runs `fn(bundles, count)` over every colour in turn, each colour in
+    /// parallel, then the overflow serially.
+    template <typename Fn>
+    void forEachColor(jobs::JobSystem& jobs, Fn&& fn);
+
+    SimdLevel level_;
+    void (*kernel_)(detail::ContactBundle*, uint32_t, SolverBody*);
+    std::vector<detail::ContactBundle> bundles_;
+    std::span<const SolverContact> contacts_;
+    std::vector<uint32_t> colorStart_; // kMaxColors + 2 entries; the last range is the overflow
+    std::vector<uint32_t> bodyColors_;
+    std::vector<uint8_t> contactColor_;
+    float invDt_ = 0.0f;
+    ContactSolverSettings settings_;
+    ContactSolverStats stats_;
+};
+
+} // namespace rebel::physics
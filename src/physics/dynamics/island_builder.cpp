@@ -0,0 +1,62 @@
+#include "physics/dynamics/island_builder.h"
+
+#include <utility>
+
+namespace rebel::physics {
+
+void IslandBuilder::reset(uint32_t bodyCount)
+{
+    parent_.resize(bodyCount);
+    for (uint32_t i = 0; i < bodyCount; ++i)
+        parent_[i] = i;
+}
+
+uint32_t IslandBuilder::find(uint32_t body)
+{
+    // Path halving.
+    while (parent_[body] != body) {
+        parent_[body] = parent_[parent_[body]];
+        body = parent_[body];
+    }
+    return body;
+}
+
+void IslandBuilder::link(uint32_t a, uint32_t b)
+{
+    a = find(a);
+    b = find(b);
+    if (a == b)
+        return;
+    if (b < a)
+        std::swap(a, b);
+    parent_[b] = a;
+}
+
+void IslandBuilder::build()
+{
+    const uint32_t bodyCount = uint32_t(parent_.size());
+    islandOf_.resize(bodyCount);
+    islandStart_.assign(1, 0);
+
+    // Roots are the smallest index of their island, so one ascending pass
+    // meets every root before its members and numbers islands in order.
+    for (uint32_t i = 0; i < bodyCount; ++i) {
+        const uint32_t root = find(i);
+        if (root == i) {
+            islandOf_[i] = uint32_t(islandStart_.size()) - 1;
+            islandStart_.push_back(0);
+        } else {
+            islandOf_[i] = islandOf_[root];
+        }
+        ++islandStart_[islandOf_[i] + 1];
+    }
+    for (std::size_t k = 1; k < islandStart_.size(); ++k)
+        islandStart_[k] += islandStart_[k - 1];
+
+    bodies_.resize(bodyCount);
+    std::vector<uint32_t> cursor(islandStart_.begin(), islandStart_.end() - 1);
+    for (uint32_t i = 0; i < bodyCount; ++i)
+        bodies_[cursor[islandOf_[i]]++] = i;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::physics {
+
+/// Union-find over the bodies of one step. link() merges the islands of two
+/// bodies connected by a contact; build() then groups bodies by island.
+///
+/// The smaller index always becomes the root and islands are numbered by
+/// their smallest body, so the grouping depends only on the set of links,
+/// not on the order they were made in.
+class IslandBuilder {
+public:
+    void reset(uint32_t bodyCount);
+    void link(uint32_t a, uint32_t b);
+    void build();
+
+    uint32_t islandCount() const { return uint32_t(islandStart_.size()) - 1; }
+    std::span<const uint32_t> island(uint32_t index) const
+    {
+        return {bodies_.data() + islandStart_[index], islandStart_[index + 1] - islandStart_[index]};
+    }
+    uint32_t islandOf(uint32_t body) const { return islandOf_[body]; }
+
+private:
+    uint32_t find(uint32_t body);
+
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> islandOf_;
+    std::vector<uint32_t> islandStart_;
+    std::vector<uint32_t> bodies_;
+};
+
+} // namespace rebel::physics
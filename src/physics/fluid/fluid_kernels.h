@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+// Internal interface between FluidWorld and its per-ISA neighbour kernels.
+
+namespace rebel::physics::detail {
+
+/// Particles a kernel reads past the end of a range; FluidWorld pads every
+/// array by this much so the widest load stays in bounds.
+inline constexpr uint32_t kFluidPadding = 8;
+
+/// A run of consecutive particles, in sorted order, that may be neighbours.
+struct NeighborRange {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+};
+
+/// Smoothing-kernel constants for one step. Particle volume (mass over rest
+/// density) is folded into the scales, so densities come out as a fraction
+/// of the rest density.
+struct FluidConstants {
+    float h = 0.0f;             // smoothing radius
+    float h2 = 0.0f;
+    float densityScale = 0.0f;  // volume * poly6 normalisation
+    float gradientScale = 0.0f; // volume * spiky gradient normalisation
+    float relaxation = 0.0f;    // constraint-force mixing, in 1 / m^2
+};
+
+/// Structure-of-arrays particle state, in cell-sorted order.
+struct FluidArrays {
+    const float* x;
+    const float* y;
+    const float* z;
+    float* lambda;
+    float* density;
+    float* dx;
+    float* dy;
+    float* dz;
+};
+
+/// Density constraint pass over particles [begin, end) of one cell, which
+/// share `ranges`: writes each particle's density and PBF multiplier.
+using LambdaKernel = void (*)(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin,
+                              uint32_t end, const NeighborRange* ranges, uint32_t rangeCount);
+/// Position correction pass: writes each particle's dx, dy, dz from the
+/// multipliers of the previous pass.
+using DeltaKernel = LambdaKernel;
+
+void solveLambdasSse(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                     const NeighborRange* ranges, uint32_t rangeCount);
+void solveLambdasAvx2(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                      const NeighborRange* ranges, uint32_t rangeCount);
+void solveDeltasSse(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                    const NeighborRange* ranges, uint32_t rangeCount);
+void solveDeltasAvx2(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                     const NeighborRange* ranges, uint32_t rangeCount);
+
+} // namespace rebel::physics::detail
@@ -0,0 +1,138 @@
+#include "physics/fluid/fluid_kernels.h"
+
+#include "core/platform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+// AVX2 variants of the fluid neighbour passes (see fluid_world.cpp): the
+// same sums over eight neighbours at a time. FluidWorld only selects them
+// after checking detectSimdLevel().
+
+namespace rebel::physics::detail {
+
+namespace {
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE float horizontalSum(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+// Lanes of j, j + 1, ... that are still before `last`.
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE __m256 liveLanes(uint32_t j, __m256 last)
+{
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    return _mm256_cmp_ps(_mm256_add_ps(lanes, _mm256_set1_ps(float(j))), last, _CMP_LT_OQ);
+}
+
+} // namespace
+
+REBEL_TARGET_AVX2 void solveLambdasAvx2(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin,
+                                        uint32_t end, const NeighborRange* ranges, uint32_t rangeCount)
+{
+    const __m256 h = _mm256_set1_ps(constants.h);
+    const __m256 h2 = _mm256_set1_ps(constants.h2);
+    const __m256 tiny = _mm256_set1_ps(1e-12f);
+    for (uint32_t i = begin; i < end; ++i) {
+        const __m256 xi = _mm256_set1_ps(arrays.x[i]);
+        const __m256 yi = _mm256_set1_ps(arrays.y[i]);
+        const __m256 zi = _mm256_set1_ps(arrays.z[i]);
+        __m256 density = _mm256_setzero_ps(), sumSquares = _mm256_setzero_ps();
+        __m256 gx = _mm256_setzero_ps(), gy = _mm256_setzero_ps(), gz = _mm256_setzero_ps();
+        for (uint32_t r = 0; r < rangeCount; ++r) {
+            const __m256 last = _mm256_set1_ps(float(ranges[r].end));
+            for (uint32_t j = ranges[r].begin; j < ranges[r].end; j += 8) {
+                const __m256 dx = _mm256_sub_ps(xi, _mm256_loadu_ps(arrays.x + j));
+                const __m256 dy = _mm256_sub_ps(yi, _mm256_loadu_ps(arrays.y + j));
+                const __m256 dz = _mm256_sub_ps(zi, _mm256_loadu_ps(arrays.z + j));
+                const __m256 r2 =
+                    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+                const __m256 near = _mm256_and_ps(_mm256_cmp_ps(r2, h2, _CMP_LT_OQ), liveLanes(j, last));
+                const __m256 q = _mm256_sub_ps(h2, r2);
+                density = _mm256_add_ps(density, _mm256_and_ps(_mm256_mul_ps(_mm256_mul_ps(q, q), q), near));
+                const __m256 distance = _mm256_sqrt_ps(r2);
+                const __m256 falloff = _mm256_sub_ps(h, distance);
+                const __m256 s =
+                    _mm256_and_ps(_mm256_div_ps(_mm256_mul_ps(falloff, falloff), distance),
+                                  _mm256_and_ps(near, _mm256_cmp_ps(r2, tiny, _CMP_GT_OQ)));
+                gx = _mm256_add_ps(gx, _mm256_mul_ps(dx, s));
+                gy = _mm256_add_ps(gy, _mm256_mul_ps(dy, s));
+                gz = _mm256_add_ps(gz, _mm256_mul_ps(dz, s));
+                sumSquares = _mm256_add_ps(sumSquares, _mm256_mul_ps(_mm256_mul_ps(s, s), r2));
+            }
+        }
+        const float rho = constants.densityScale * horizontalSum(density);
+        const float g = constants.gradientScale;
+        const float sx = g * horizontalSum(gx), sy = g * horizontalSum(gy), sz = g * horizontalSum(gz);
+        const float norm = g * g * horizontalSum(sumSquares) + sx * sx + sy * sy + sz * sz + constants.relaxation;
+        arrays.density[i] = rho;
+        arrays.lambda[i] = -std::max(rho - 1.0f, 0.0f) / norm;
+    }
+}
+
+REBEL_TARGET_AVX2 void solveDeltasAvx2(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin,
+                                       uint32_t end, const NeighborRange* ranges, uint32_t rangeCount)
+{
+    const __m256 h = _mm256_set1_ps(constants.h);
+    const __m256 h2 = _mm256_set1_ps(constants.h2);
+    const __m256 tiny = _mm256_set1_ps(1e-12f);
+    for (uint32_t i = begin; i < end; ++i) {
+        const __m256 xi = _mm256_set1_ps(arrays.x[i]);
+        const __m256 yi = _mm256_set1_ps(arrays.y[i]);
+        const __m256 zi = _mm256_set1_ps(arrays.z[i]);
+        const __m256 li = _mm256_set1_ps(arrays.lambda[i]);
+        __m256 ax = _mm256_setzero_ps(), ay = _mm256_setzero_ps(), az = _mm256_setzero_ps();
+        for (uint32_t r = 0; r < rangeCount; ++r) {
+            const __m256 last = _mm256_set1_ps(float(ranges[r].end));
+            for (uint32_t j = ranges[r].begin; j < ranges[r].end; j += 8) {
+                const __m256 dx = _mm256_sub_ps(xi, _mm256_loadu_ps(arrays.x + j));
+                const __m256 dy = _mm256_sub_ps(yi, _mm256_loadu_ps(arrays.y + j));
+                const __m256 dz = _mm256_sub_ps(zi, _mm256_loadu_ps(arrays.z + j));
+                const __m256 r2 =
+                    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+                const __m256 near = _mm256_and_ps(
+                    _mm256_and_ps(_mm256_cmp_ps(r2, h2, _CMP_LT_OQ), _mm256_cmp_ps(r2, tiny, _CMP_GT_OQ)),
+                    liveLanes(j, last));
+                const __m256 distance = _mm256_sqrt_ps(r2);
+                const __m256 falloff = _mm256_sub_ps(h, distance);
+                const __m256 lambda = _mm256_add_ps(li, _mm256_loadu_ps(arrays.lambda + j));
+                const __m256 w = _mm256_and_ps(
+                    _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(lambda, falloff), falloff), distance), near);
+                ax = _mm256_add_ps(ax, _mm256_mul_ps(dx, w));
+                ay = _mm256_add_ps(ay, _mm256_mul_ps(dy, w));
+                az = _mm256_add_ps(az, _mm256_mul_ps(dz, w));
+            }
+        }
+        arrays.dx[i] = constants.gradientScale * horizontalSum(ax);
+        arrays.dy[i] = constants.gradientScale * horizontalSum(ay);
+        arrays.dz[i] = constants.gradientScale * horizontalSum(az);
+    }
+}
+
+} // namespace rebel::physics::detail
+
+#else
+
+namespace rebel::physics::detail {
+
+void solveLambdasAvx2(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                      const NeighborRange* ranges, uint32_t rangeCount)
+{
+    solveLambdasSse(constants, arrays, begin, end, ranges, rangeCount);
+}
+
+void solveDeltasAvx2(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                     const NeighborRange* ranges, uint32_t rangeCount)
+{
+    solveDeltasSse(constants, arrays, begin, end, ranges, rangeCount);
+}
+
+} // namespace rebel::physics::detail
+
+#endif
@@ -0,0 +1,447 @@
+#include "physics/fluid/fluid_world.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/math/simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+namespace rebel::physics {
+
+using math::Float4;
+using math::Vec3;
+
+namespace detail {
+
+void solveLambdasSse(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                     const NeighborRange* ranges, uint32_t rangeCount)
+{
+    const Float4 h(constants.h), h2(constants.h2), tiny(1e-12f);
+    const Float4 lanes(0.0f, 1.0f, 2.0f, 3.0f);
+    for (uint32_t i = begin; i < end; ++i) {
+        const Float4 xi(arrays.x[i]), yi(arrays.y[i]), zi(arrays.z[i]);
+        Float4 density = Float4::zero(), sumSquares = Float4::zero();
+        Float4 gx = Float4::zero(), gy = Float4::zero(), gz = Float4::zero();
+        for (uint32_t r = 0; r < rangeCount; ++r) {
+            const Float4 last(float(ranges[r].end));
+            for (uint32_t j = ranges[r].begin; j < ranges[r].end; j += 4) {
+                const Float4 dx = xi - Float4::load(arrays.x + j);
+                const Float4 dy = yi - Float4::load(arrays.y + j);
+                const Float4 dz = zi - Float4::load(arrays.z + j);
+                const Float4 r2 = dx * dx + dy * dy + dz * dz;
+                const Float4 near = cmpLt(r2, h2) & cmpLt(lanes + Float4(float(j)), last);
+                const Float4 q = h2 - r2;
+                density += (q * q * q) & near;
+                // Spiky gradient over distance; the particle itself has none.
+                const Float4 distance = sqrt(r2);
+                const Float4 falloff = h - distance;
+                const Float4 s = (falloff * falloff / distance) & (near & cmpGt(r2, tiny));
+                gx += dx * s;
+                gy += dy * s;
+                gz += dz * s;
+                sumSquares += s * s * r2;
+            }
+        }
+        const float rho = constants.densityScale * horizontalSum(density);
+        const float g = constants.gradientScale;
+        const float sx = g * horizontalSum(gx), sy = g * horizontalSum(gy), sz = g * horizontalSum(gz);
+        const float norm = g * g * horizontalSum(sumSquares) + sx * sx + sy * sy + sz * sz + constants.relaxation;
+        arrays.density[i] = rho;
+        arrays.lambda[i] = -std::max(rho - 1.0f, 0.0f) / norm;
+    }
+}
+
+void solveDeltasSse(const FluidConstants& constants, const FluidArrays& arrays, uint32_t begin, uint32_t end,
+                    const NeighborRange* ranges, uint32_t rangeCount)
+{
+    const Float4 h(constants.h), h2(constants.h2), tiny(1e-12f);
+    const Float4 lanes(0.0f, 1.0f, 2.0f, 3.0f);
+    for (uint32_t i = begin; i < end; ++i) {
+        const Float4 xi(arrays.x[i]), yi(arrays.y[i]), zi(arrays.z[i]);
+        const Float4 li(arrays.lambda[i]);
+        Float4 ax = Float4::zero(), ay = Float4::zero(), az = Float4::zero();
+        for (uint32_t r = 0; r < rangeCount; ++r) {
+            const Float4 last(float(ranges[r].end));
+            for (uint32_t j = ranges[r].begin; j < ranges[r].end; j += 4) {
+                const Float4 dx = xi - Float4::load(arrays.x + j);
+                const Float4 dy = yi - Float4::load(arrays.y + j);
+                const Float4 dz = zi - Float4::load(arrays.z + j);
+                const Float4 r2 = dx * dx + dy * dy + dz * dz;
+                const Float4 near = cmpLt(r2, h2) & cmpGt(r2, tiny) & cmpLt(lanes + Float4(float(j)), last);
+                const Float4 distance = sqrt(r2);
+                const Float4 falloff = h - distance;
+                const Float4 w = ((li + Float4::load(arrays.lambda + j)) * falloff * falloff / distance) & near;
+                ax += dx * w;
+                ay += dy * w;
+                az += dz * w;
+            }
+        }
+        arrays.dx[i] = constants.gradientScale * horizontalSum(ax);
+        arrays.dy[i] = constants.gradientScale * horizontalSum(ay);
+        arrays.dz[i] = constants.gradientScale * horizontalSum(az);
+    }
+}
+
+} // namespace detail
+
+namespace {
+
+constexpr uint32_t kParticleGrain = 4096;
+constexpr uint32_t kCellGrain = 64;
+constexpr uint32_t kNeighborCells = 27;
+// Padding particles sit here, out of every neighbourhood.
+constexpr float kFar = 1e18f;
+// Farthest a wall puts a particle back inside, in smoothing radii.
+constexpr float kWallReach = 0.25f;
+
+// 10-bit coordinate to every third bit.
+uint32_t spreadBits(uint32_t v)
+{
+    v &= 0x3FF;
+    v = (v | (v << 16)) & 0x030000FF;
+    v = (v | (v << 8)) & 0x0300F00F;
+    v = (v | (v << 4)) & 0x030C30C3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+uint32_t compactBits(uint32_t v)
+{
+    v &= 0x09249249;
+    v = (v ^ (v >> 2)) & 0x030C30C3;
+    v = (v ^ (v >> 4)) & 0x0300F00F;
+    v = (v ^ (v >> 8)) & 0x030000FF;
+    v = (v ^ (v >> 16)) & 0x000003FF;
+    return v;
+}
+
+uint32_t morton(uint32_t x, uint32_t y, uint32_t z) { return spreadBits(x) | spreadBits(y) << 1 | spreadBits(z) << 2; }
+
+// Puts a coordinate that left [low, high] back inside, half its overshoot
+// (up to `reach`) from the wall. Clamping flat to the wall would stack
+// particles pressed into an edge or corner on the same point, where no
+// kernel gradient can separate them again.
+float wall(float p, float low, float high, float reach)
+{
+    if (p < low)
+        return low + std::min(low - p, reach) * 0.5f;
+    if (p > high)
+        return high - std::min(p - high, reach) * 0.5f;
+    return p;
+}
+
+uint32_t tableSlot(uint32_t key, uint32_t mask)
+{
+    uint32_t h = key * 0x9E3779B1u;
+    return (h ^ (h >> 15)) & mask;
+}
+
+// LSD radix sort on the 30-bit cell keys in the high words, 10 bits per
+// pass, skipping passes where every key shares the digit.
+void sortKeys(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch)
+{
+    const std::size_t n = keys.size();
+    if (n < 2)
+        return;
+    scratch.resize(n);
+    uint32_t histograms[3][1024] = {};
+    for (const uint64_t key : keys) {
+        for (int b = 0; b < 3; ++b)
+            ++histograms[b][(key >> (32 + b * 10)) & 0x3FF];
+    }
+    for (int b = 0; b < 3; ++b) {
+        const int shift = 32 + b * 10;
+        uint32_t* histogram = histograms[b];
+        if (histogram[(keys[0] >> shift) & 0x3FF] == n)
+            continue;
+        uint32_t offset = 0;
+        for (int d = 0; d < 1024; ++d) {
+            const uint32_t count = histogram[d];
+            histogram[d] = offset;
+            offset += count;
+        }
+        for (const uint64_t key : keys)
+            scratch[histogram[(key >> shift) & 0x3FF]++] = key;
+        keys.swap(scratch);
+    }
+}
+
+} // namespace
+
+FluidWorld::FluidWorld(const FluidWorldDesc& desc)
+    : bounds_(desc.bounds)
+    , inner_(desc.bounds.expanded(-desc.particleRadius))
+    , gravity_(desc.gravity)
+    , iterations_(std::max(desc.iterations, 1u))
+    , viscosity_(desc.viscosity)
+    , level_(std::min(desc.simdLevel, detectSimdLevel()))
+    , lambdaKernel_(level_ >= SimdLevel::Avx2 ? detail::solveLambdasAvx2 : detail::solveLambdasSse)
+    , deltaKernel_(level_ >= SimdLevel::Avx2 ? detail::solveDeltasAvx2 : detail::solveDeltasSse)
+{
+    const float h = 4.0f * desc.particleRadius;
+    const float spacing = 2.0f * desc.particleRadius;
+    const float volume = spacing * spacing * spacing;
+    const float pi = std::numbers::pi_v<float>;
+    constants_.h = h;
+    constants_.h2 = h * h;
+    constants_.densityScale = volume * 315.0f / (64.0f * pi * std::pow(h, 9.0f));
+    constants_.gradientScale = volume * -45.0f / (pi * std::pow(h, 6.0f));
+    constants_.relaxation = desc.relaxation / (h * h);
+
+    [[maybe_unused]] const Vec3 cells = (bounds_.max - bounds_.min) * (1.0f / h);
+    REBEL_ASSERT(desc.particleRadius > 0.0f && cells.x > 0.0f && cells.y > 0.0f && cells.z > 0.0f,
+                 "fluid needs a particle radius and a container");
+    REBEL_ASSERT(std::max({cells.x, cells.y, cells.z}) <= float(1u << kGridBits), "fluid container too large");
+    resize(0);
+}
+
+void FluidWorld::resize(uint32_t count)
+{
+    const uint32_t padded = count + detail::kFluidPadding;
+    for (std::vector<float>* array : {&x_, &y_, &z_, &startX_, &startY_, &startZ_, &vx_, &vy_, &vz_, &lambda_,
+                                      &density_, &dx_, &dy_, &dz_, &scratch_}) {
+        array->resize(padded);
+        std::fill(array->begin() + count, array->end(), kFar);
+    }
+    keys_.resize(count);
+    count_ = count;
+}
+
+void FluidWorld::addParticles(std::span<const Vec3> positions, Vec3 velocity)
+{
+    const uint32_t first = count_;
+    resize(count_ + uint32_t(positions.size()));
+    for (uint32_t i = 0; i < positions.size(); ++i) {
+        const Vec3 p = math::min(math::max(positions[i], inner_.min), inner_.max);
+        x_[first + i] = p.x;
+        y_[first + i] = p.y;
+        z_[first + i] = p.z;
+        vx_[first + i] = velocity.x;
+        vy_[first + i] = velocity.y;
+        vz_[first + i] = velocity.z;
+        lambda_[first + i] = 0.0f;
+        density_[first + i] = 0.0f;
+    }
+}
+
+void FluidWorld::step(float dt, jobs::JobSystem& jobs)
+{
+    stats_ = {};
+    stats_.particles = count_;
+    if (count_ == 0)
+        return;
+
+    // Predict, keeping predictions inside the container so they key into
+    // the grid.
+    const Vec3 gravityStep = gravity_ * dt;
+    const float reach = kWallReach * constants_.h;
+    jobs.parallelFor(count_, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            startX_[i] = x_[i];
+            startY_[i] = y_[i];
+            startZ_[i] = z_[i];
+            vx_[i] += gravityStep.x;
+            vy_[i] += gravityStep.y;
+            vz_[i] += gravityStep.z;
+            x_[i] = wall(x_[i] + vx_[i] * dt, inner_.min.x, inner_.max.x, reach);
+            y_[i] = wall(y_[i] + vy_[i] * dt, inner_.min.y, inner_.max.y, reach);
+            z_[i] = wall(z_[i] + vz_[i] * dt, inner_.min.z, inner_.max.z, reach);
+        }
+    });
+
+    sortParticles(jobs);
+    buildCells(jobs);
+
+    const detail::FluidArrays arrays{x_.data(),       y_.data(),  z_.data(),  lambda_.data(),
+                                     density_.data(), dx_.data(), dy_.data(), dz_.data()};
+    const uint32_t cellCount = uint32_t(cells_.size() - 1);
+    for (uint32_t iteration = 0; iteration < iterations_; ++iteration) {
+        jobs.parallelFor(cellCount, kCellGrain, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t c = begin; c < end; ++c)
+                lambdaKernel_(constants_, arrays, cells_[c].begin, cells_[c + 1].begin,
+                              &ranges_[std::size_t(c) * kNeighborCells], rangeCounts_[c]);
+        });
+        jobs.parallelFor(cellCount, kCellGrain, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t c = begin; c < end; ++c)
+                deltaKernel_(constants_, arrays, cells_[c].begin, cells_[c + 1].begin,
+                             &ranges_[std::size_t(c) * kNeighborCells], rangeCounts_[c]);
+        });
+        applyDeltas(jobs);
+    }
+
+    const float inverseDt = 1.0f / dt;
+    jobs.parallelFor(count_, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            vx_[i] = (x_[i] - startX_[i]) * inverseDt;
+            vy_[i] = (y_[i] - startY_[i]) * inverseDt;
+            vz_[i] = (z_[i] - startZ_[i]) * inverseDt;
+        }
+    });
+    if (viscosity_ > 0.0f)
+        applyViscosity(jobs);
+
+    double compression = 0.0;
+    for (uint32_t i = 0; i < count_; ++i)
+        compression += std::max(density_[i] - 1.0f, 0.0f);
+    stats_.densityError = float(compression / double(count_));
+}
+
+void FluidWorld::sortParticles(jobs::JobSystem& jobs)
+{
+    const float inverseH = 1.0f / constants_.h;
+    const uint32_t last = (1u << kGridBits) - 1;
+    const auto cell = [&](float p, float min) {
+        return std::min(uint32_t(std::max((p - min) * inverseH, 0.0f)), last);
+    };
+    jobs.parallelFor(count_, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t key =
+                morton(cell(x_[i], bounds_.min.x), cell(y_[i], bounds_.min.y), cell(z_[i], bounds_.min.z));
+            keys_[i] = uint64_t(key) << 32 | i;
+        }
+    });
+    sortKeys(keys_, sortScratch_);
+
+    // Reorder everything that lives across the sort. Padding is the same
+    // in every array, so swapping with the scratch keeps it.
+    for (std::vector<float>* array : {&x_, &y_, &z_, &startX_, &startY_, &startZ_, &vx_, &vy_, &vz_}) {
+        const float* source = array->data();
+        jobs.parallelFor(count_, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                scratch_[i] = source[uint32_t(keys_[i])];
+        });
+        array->swap(scratch_);
+    }
+}
+
+uint32_t FluidWorld::findCell(uint32_t key) const
+{
+    const uint32_t mask = uint32_t(cellTable_.size() - 1);
+    for (uint32_t slot = tableSlot(key, mask);; slot = (slot + 1) & mask) {
+        const uint32_t entry = cellTable_[slot];
+        if (entry == 0 || cells_[entry - 1].key == key)
+            return entry;
+    }
+}
+
+void FluidWorld::buildCells(jobs::JobSystem& jobs)
+{
+    cells_.clear();
+    for (uint32_t i = 0; i < count_; ++i) {
+        const uint32_t key = uint32_t(keys_[i] >> 32);
+        if (cells_.empty() || cells_.back().key != key)
+            cells_.push_back({key, i});
+    }
+    const uint32_t cellCount = uint32_t(cells_.size());
+    cells_.push_back({UINT32_MAX, count_});
+
+    cellTable_.assign(std::bit_ceil(2 * cellCount), 0);
+    const uint32_t mask = uint32_t(cellTable_.size() - 1);
+    for (uint32_t c = 0; c < cellCount; ++c) {
+        uint32_t slot = tableSlot(cells_[c].key, mask);
+        while (cellTable_[slot] != 0)
+            slot = (slot + 1) & mask;
+        cellTable_[slot] = c + 1;
+    }
+
+    // Each cell's neighbourhood as runs of particles, in memory order, with
+    // runs that meet merged.
+    ranges_.resize(std::size_t(cellCount) * kNeighborCells);
+    rangeCounts_.resize(cellCount);
+    const uint32_t last = (1u << kGridBits) - 1;
+    jobs.parallelFor(cellCount, kCellGrain * 4, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c) {
+            const uint32_t key = cells_[c].key;
+            const uint32_t cx = compactBits(key), cy = compactBits(key >> 1), cz = compactBits(key >> 2);
+            detail::NeighborRange* ranges = &ranges_[std::size_t(c) * kNeighborCells];
+            uint32_t count = 0;
+            for (uint32_t z = cz - (cz > 0); z <= std::min(cz + 1, last); ++z) {
+                for (uint32_t y = cy - (cy > 0); y <= std::min(cy + 1, last); ++y) {
+                    for (uint32_t x = cx - (cx > 0); x <= std::min(cx + 1, last); ++x) {
+                        const uint32_t entry = findCell(morton(x, y, z));
+                        if (entry != 0)
+                            ranges[count++] = {cells_[entry - 1].begin, cells_[entry].begin};
+                    }
+                }
+            }
+            for (uint32_t i = 1; i < count; ++i) {
+                for (uint32_t j = i; j > 0 && ranges[j].begin < ranges[j - 1].begin; --j)
+                    std::swap(ranges[j], ranges[j - 1]);
+            }
+            uint32_t merged = 0;
+            for (uint32_t i = 1; i < count; ++i) {
+                if (ranges[i].begin == ranges[merged].end)
+                    ranges[merged].end = ranges[i].end;
+                else
+                    ranges[++merged] = ranges[i];
+            }
+            rangeCounts_[c] = uint8_t(merged + 1);
+        }
+    });
+
+    stats_.cells = cellCount;
+    for (uint32_t c = 0; c < cellCount; ++c) {
+        const detail::NeighborRange* ranges = &ranges_[std::size_t(c) * kNeighborCells];
+        uint64_t span = 0;
+        for (uint32_t r = 0; r < rangeCounts_[c]; ++r)
+            span += ranges[r].end - ranges[r].begin;
+        stats_.ranges += rangeCounts_[c];
+        stats_.candidates += span * (cells_[c + 1].begin - cells_[c].begin);
+    }
+}
+
+void FluidWorld::applyDeltas(jobs::JobSystem& jobs)
+{
+    const float reach = kWallReach * constants_.h;
+    jobs.parallelFor(count_, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            x_[i] = wall(x_[i] + dx_[i], inner_.min.x, inner_.max.x, reach);
+            y_[i] = wall(y_[i] + dy_[i], inner_.min.y, inner_.max.y, reach);
+            z_[i] = wall(z_[i] + dz_[i], inner_.min.z, inner_.max.z, reach);
+        }
+    });
+}
+
+void FluidWorld::applyViscosity(jobs::JobSystem& jobs)
+{
+    // XSPH: blend towards the density-weighted mean of the neighbours'
+    // velocities. New velocities go to dx_..dz_, then swap in.
+    const Float4 h2(constants_.h2);
+    const Float4 lanes(0.0f, 1.0f, 2.0f, 3.0f);
+    const float blend = viscosity_ * constants_.densityScale;
+    jobs.parallelFor(uint32_t(cells_.size() - 1), kCellGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c) {
+            const detail::NeighborRange* ranges = &ranges_[std::size_t(c) * kNeighborCells];
+            for (uint32_t i = cells_[c].begin; i < cells_[c + 1].begin; ++i) {
+                const Float4 xi(x_[i]), yi(y_[i]), zi(z_[i]);
+                const Float4 ui(vx_[i]), vi(vy_[i]), wi(vz_[i]);
+                Float4 au = Float4::zero(), av = Float4::zero(), aw = Float4::zero();
+                for (uint32_t r = 0; r < rangeCounts_[c]; ++r) {
+                    const Float4 last(float(ranges[r].end));
+                    for (uint32_t j = ranges[r].begin; j < ranges[r].end; j += 4) {
+                        const Float4 dx = xi - Float4::load(&x_[j]);
+                        const Float4 dy = yi - Float4::load(&y_[j]);
+                        const Float4 dz = zi - Float4::load(&z_[j]);
+                        const Float4 r2 = dx * dx + dy * dy + dz * dz;
+                        const Float4 q = h2 - r2;
+                        const Float4 w = (q * q * q) & cmpLt(r2, h2) & cmpLt(lanes + Float4(float(j)), last);
+                        au += (Float4::load(&vx_[j]) - ui) * w;
+                        av += (Float4::load(&vy_[j]) - vi) * w;
+                        aw += (Float4::load(&vz_[j]) - wi) * w;
+                    }
+                }
+                dx_[i] = vx_[i] + blend * horizontalSum(au);
+                dy_[i] = vy_[i] + blend * horizontalSum(av);
+                dz_[i] = vz_[i] + blend * horizontalSum(aw);
+            }
+        }
+    });
+    vx_.swap(dx_);
+    vy_.swap(dy_);
+    vz_.swap(dz_);
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,223 @@
+#include "physics/heightfield.h"
+
+#include "core/assert.h"
+#include "physics/collision/shape_cast.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kMaxLevels = 32;
+
+// Ray against a box, clipped to [0, maxDistance]; `enter` is where it
+// enters.
+bool rayBounds(Vec3 origin, Vec3 inverse, Vec3 min, Vec3 max, float maxDistance, float& enter)
+{
+    const Vec3 t1 = (min - origin) * inverse;
+    const Vec3 t2 = (max - origin) * inverse;
+    const Vec3 near = math::min(t1, t2);
+    const Vec3 far = math::max(t1, t2);
+    enter = std::max({near.x, near.y, near.z, 0.0f});
+    return enter <= std::min({far.x, far.y, far.z, maxDistance});
+}
+
+} // namespace
+
+Heightfield::Heightfield(const HeightfieldDesc& desc)
+    : columns_(desc.columns)
+    , rows_(desc.rows)
+    , spacing_(desc.spacing)
+{
+    REBEL_ASSERT(columns_ >= 2 && rows_ >= 2, "heightfield needs at least one cell");
+    REBEL_ASSERT(desc.heights.size() == std::size_t(columns_) * rows_, "one height per sample");
+    originX_ = -0.5f * spacing_ * float(columns_ - 1);
+    originZ_ = -0.5f * spacing_ * float(rows_ - 1);
+
+    float low = FLT_MAX, high = -FLT_MAX;
+    for (const float h : desc.heights) {
+        low = std::min(low, h);
+        high = std::max(high, h);
+    }
+    offset_ = low;
+    scale_ = high > low ? (high - low) / 65535.0f : 1.0f;
+    samples_.resize(desc.heights.size());
+    for (std::size_t i = 0; i < samples_.size(); ++i)
+        samples_[i] = uint16_t(std::lround((desc.heights[i] - low) / scale_));
+    bounds_ = {{originX_, low, originZ_}, {-originX_, high, -originZ_}};
+
+    // Level 0 from the samples, then each level from the one below.
+    const uint32_t cellColumns = columns_ - 1, cellRows = rows_ - 1;
+    blockColumns_ = (cellColumns + kBlockCells - 1) / kBlockCells;
+    uint32_t levelColumns = blockColumns_, levelRows = (cellRows + kBlockCells - 1) / kBlockCells;
+    levelStart_.push_back(0);
+    levelColumns_.push_back(levelColumns);
+    levelRows_.push_back(levelRows);
+    ranges_.resize(std::size_t(levelColumns) * levelRows);
+    for (uint32_t br = 0; br < levelRows; ++br) {
+        for (uint32_t bc = 0; bc < levelColumns; ++bc) {
+            Range range{UINT16_MAX, 0};
+            const uint32_t rEnd = std::min(rows_ - 1, (br + 1) * kBlockCells);
+            const uint32_t cEnd = std::min(columns_ - 1, (bc + 1) * kBlockCells);
+            for (uint32_t r = br * kBlockCells; r <= rEnd; ++r) {
+                for (uint32_t c = bc * kBlockCells; c <= cEnd; ++c) {
+                    range.min = std::min(range.min, sample(c, r));
+                    range.max = std::max(range.max, sample(c, r));
+                }
+            }
+            ranges_[br * levelColumns + bc] = range;
+        }
+    }
+    while (levelColumns > 1 || levelRows > 1) {
+        const uint32_t below = levelStart_.back();
+        const uint32_t belowColumns = levelColumns, belowRows = levelRows;
+        levelColumns = (levelColumns + 1) / 2;
+        levelRows = (levelRows + 1) / 2;
+        levelStart_.push_back(uint32_t(ranges_.size()));
+        levelColumns_.push_back(levelColumns);
+        levelRows_.push_back(levelRows);
+        ranges_.resize(ranges_.size() + std::size_t(levelColumns) * levelRows);
+        Range* level = ranges_.data() + levelStart_.back();
+        for (uint32_t r = 0; r < levelRows; ++r) {
+            for (uint32_t c = 0; c < levelColumns; ++c) {
+                Range range{UINT16_MAX, 0};
+                for (uint32_t rr = 2 * r; rr < std::min(2 * r + 2, belowRows); ++rr) {
+                    for (uint32_t cc = 2 * c; cc < std::min(2 * c + 2, belowColumns); ++cc) {
+                        const Range& child = ranges_[below + rr * belowColumns + cc];
+                        range.min = std::min(range.min, child.min);
+                        range.max = std::max(range.max, child.max);
+                    }
+                }
+                level[r * levelColumns + c] = range;
+            }
+        }
+    }
+    REBEL_ASSERT(levelStart_.size() <= kMaxLevels, "heightfield too large");
+}
+
+bool Heightfield::cellRange(const Aabb& box, uint32_t& c0, uint32_t& r0, uint32_t& c1, uint32_t& r1) const
+{
+    if (box.max.x < bounds_.min.x || box.min.x > bounds_.max.x || box.max.z < bounds_.min.z ||
+        box.min.z > bounds_.max.z)
+        return false;
+    const float inverse = 1.0f / spacing_;
+    const auto clampCell = [](float f, uint32_t cells) {
+        return uint32_t(std::clamp(f, 0.0f, float(cells - 1)));
+    };
+    c0 = clampCell((box.min.x - originX_) * inverse, columns_ - 1);
+    c1 = clampCell((box.max.x - originX_) * inverse, columns_ - 1);
+    r0 = clampCell((box.min.z - originZ_) * inverse, rows_ - 1);
+    r1 = clampCell((box.max.z - originZ_) * inverse, rows_ - 1);
+    return true;
+}
+
+bool Heightfield::rayCast(Vec3 origin, Vec3 direction, float maxDistance, CastHit& hit) const
+{
+    const Vec3 inverse{safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z)};
+
+    // Front to back over the pyramid: children are pushed far first, and
+    // nodes entered beyond the best hit so far are dropped.
+    struct Entry {
+        uint32_t level, column, row;
+        float enter;
+    };
+    Entry stack[4 * kMaxLevels];
+    uint32_t size = 0;
+    float best = maxDistance;
+    bool found = false;
+
+    auto nodeBounds = [&](uint32_t level, uint32_t column, uint32_t row, Vec3& min, Vec3& max) {
+        const uint32_t cells = kBlockCells << level;
+        const Range& range = ranges_[levelStart_[level] + row * levelColumns_[level] + column];
+        min = {x(column * cells), height(range.min), z(row * cells)};
+        max = {x(std::min(columns_ - 1, (column + 1) * cells)), height(range.max),
+               z(std::min(rows_ - 1, (row + 1) * cells))};
+    };
+
+    auto cell = [&](uint32_t c, uint32_t r) {
+        Vec3 v[4];
+        cellCorners(c, r, v);
+        const Vec3 cellMin = math::min(math::min(v[0], v[1]), math::min(v[2], v[3]));
+        const Vec3 cellMax = math::max(math::max(v[0], v[1]), math::max(v[2], v[3]));
+        float cellEnter;
+        if (!rayBounds(origin, inverse, cellMin, cellMax, best, cellEnter))
+            return;
+        const Vec3 first[3] = {v[0], v[2], v[3]};
+        const Vec3 second[3] = {v[0], v[3], v[1]};
+        CastHit candidate;
+        if (rayTriangle(origin, direction, first, best, candidate)) {
+            hit = candidate;
+            best = candidate.distance;
+            found = true;
+        }
+        if (rayTriangle(origin, direction, second, best, candidate)) {
+            hit = candidate;
+            best = candidate.distance;
+            found = true;
+        }
+    };
+
+    // Short, steep rays such as wheel and foot probes cross no more than a
+    // block's worth of cells, so they test those directly rather than
+    // descending the pyramid to reach them.
+    if ((std::fabs(direction.x) + std::fabs(direction.z)) * maxDistance <= float(kBlockCells) * spacing_) {
+        const Vec3 end = origin + direction * maxDistance;
+        uint32_t c0, r0, c1, r1;
+        if (!cellRange({math::min(origin, end), math::max(origin, end)}, c0, r0, c1, r1))
+            return false;
+        for (uint32_t r = r0; r <= r1; ++r) {
+            for (uint32_t c = c0; c <= c1; ++c)
+                cell(c, r);
+        }
+        return found;
+    }
+
+    const uint32_t top = uint32_t(levelStart_.size() - 1);
+    Vec3 min, max;
+    float enter;
+    nodeBounds(top, 0, 0, min, max);
+    if (!rayBounds(origin, inverse, min, max, best, enter))
+        return false;
+    stack[size++] = {top, 0, 0, enter};
+
+    while (size > 0) {
+        const Entry node = stack[--size];
+        if (node.enter > best)
+            continue;
+        if (node.level == 0) {
+            const uint32_t rEnd = std::min(rows_ - 1, (node.row + 1) * kBlockCells);
+            const uint32_t cEnd = std::min(columns_ - 1, (node.column + 1) * kBlockCells);
+            for (uint32_t r = node.row * kBlockCells; r < rEnd; ++r) {
+                for (uint32_t c = node.column * kBlockCells; c < cEnd; ++c) {
+                    cell(c, r);
+                }
+            }
+            continue;
+        }
+
+        const uint32_t level = node.level - 1;
+        Entry children[4];
+        uint32_t count = 0;
+        for (uint32_t r = 2 * node.row; r < std::min(2 * node.row + 2, levelRows_[level]); ++r) {
+            for (uint32_t c = 2 * node.column; c < std::min(2 * node.column + 2, levelColumns_[level]); ++c) {
+                nodeBounds(level, c, r, min, max);
+                if (rayBounds(origin, inverse, min, max, best, enter))
+                    children[count++] = {level, c, r, enter};
+            }
+        }
+        // Insertion sort, farthest first, so the nearest is popped next.
+        for (uint32_t i = 1; i < count; ++i) {
+            for (uint32_t j = i; j > 0 && children[j].enter > children[j - 1].enter; --j)
+                std::swap(children[j], children[j - 1]);
+        }
+        for (uint32_t i = 0; i < count; ++i)
+            stack[size++] = children[i];
+    }
+    return found;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/aabb.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::physics {
+
+struct CastHit;
+
+struct HeightfieldDesc {
+    uint32_t columns = 0; // samples along X
+    uint32_t rows = 0;    // samples along Z
+    /// Distance between neighbouring samples along X and Z.
+    float spacing = 1.0f;
+    /// rows x columns heights, row-major along X.
+    std::span<const float> heights;
+};
+
+/// Terrain collision: a regular grid of heights in body space, centred on
+/// the body origin in X and Z, with heights taken as body-space Y.
+///
+/// Heights are quantized to 16 bits between the lowest and highest sample,
+/// about 1.5 cm of error over a 1 km height range, and each cell is split
+/// into two triangles along its (x, z) to (x + 1, z + 1) diagonal.
+/// Blocks of kBlockCells x kBlockCells cells keep their quantized height
+/// range in a min/max pyramid, up to one root block, so rays skip empty
+/// space block by block and box queries reject blocks above or below the
+/// box before touching samples. The pyramid adds about a quarter byte per
+/// sample to the two of the heights. Shapes reference heightfields by
+/// pointer, so a heightfield must outlive every body using it.
+class Heightfield {
+public:
+    static constexpr uint32_t kBlockCells = 4;
+
+    explicit Heightfield(const HeightfieldDesc& desc);
+
+    uint32_t columns() const { return columns_; }
+    uint32_t rows() const { return rows_; }
+    float spacing() const { return spacing_; }
+    /// Body-space bounds.
+    const Aabb& bounds() const { return bounds_; }
+    /// Bytes of heights and pyramid.
+    std::size_t memoryUsage() const
+    {
+        return samples_.size() * sizeof(uint16_t) + ranges_.size() * sizeof(Range);
+    }
+
+    /// Dequantized height of a sample.
+    float height(uint32_t column, uint32_t row) const { return offset_ + scale_ * float(sample(column, row)); }
+
+    /// Body-space ray against the surface from either side; `direction`
+    /// must be unit length. The normal faces back along the ray.
+    bool rayCast(math::Vec3 origin, math::Vec3 direction, float maxDistance, CastHit& hit) const;
+
+    /// Calls fn(id, vertices) for every triangle whose cell overlaps the
+    /// body-space `box`, with the three body-space vertices. Ids are stable:
+    /// two per cell, in row-major cell order.
+    template <typename Fn>
+    void queryTriangles(const Aabb& box, Fn&& fn) const
+    {
+        uint32_t c0, r0, c1, r1;
+        if (!cellRange(box, c0, r0, c1, r1))
+            return;
+        const float low = box.min.y, high = box.max.y;
+        for (uint32_t br = r0 / kBlockCells; br <= r1 / kBlockCells; ++br) {
+            for (uint32_t bc = c0 / kBlockCells; bc <= c1 / kBlockCells; ++bc) {
+                const Range& block = ranges_[br * blockColumns_ + bc];
+                if (height(block.min) > high || height(block.max) < low)
+                    continue;
+                const uint32_t rEnd = std::min(r1, br * kBlockCells + kBlockCells - 1);
+                const uint32_t cEnd = std::min(c1, bc * kBlockCells + kBlockCells - 1);
+                for (uint32_t r = std::max(r0, br * kBlockCells); r <= rEnd; ++r) {
+                    for (uint32_t c = std::max(c0, bc * kBlockCells); c <= cEnd; ++c) {
+                        math::Vec3 v[4];
+                        cellCorners(c, r, v);
+                        const float cellLow = std::min(std::min(v[0].y, v[1].y), std::min(v[2].y, v[3].y));
+                        const float cellHigh = std::max(std::max(v[0].y, v[1].y), std::max(v[2].y, v[3].y));
+                        if (cellLow > high || cellHigh < low)
+                            continue;
+                        const uint32_t id = (r * (columns_ - 1) + c) * 2;
+                        const math::Vec3 first[3] = {v[0], v[2], v[3]};
+                        const math::Vec3 second[3] = {v[0], v[3], v[1]};
+                        fn(id, first);
+                        fn(id + 1, second);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    struct Range {
+        uint16_t min, max;
+    };
+
+    uint16_t sample(uint32_t column, uint32_t row) const { return samples_[row * columns_ + column]; }
+    float height(uint16_t quantized) const { return offset_ + scale_ * float(quantized); }
+    float x(uint32_t column) const { return originX_ + spacing_ * float(column); }
+    float z(uint32_t row) const { return originZ_ + spacing_ * float(row); }
+
+    /// Corners (c, r), (c + 1, r), (c, r + 1), (c + 1, r + 1).
+    void cellCorners(uint32_t column, uint32_t row, math::Vec3 (&v)[4]) const
+    {
+        v[0] = {x(column), height(column, row), z(row)};
+        v[1] = {x(column + 1), height(column + 1, row), z(row)};
+        v[2] = {x(column), height(column, row + 1), z(row + 1)};
+        v[3] = {x(column + 1), height(column + 1, row + 1), z(row + 1)};
+    }
+
+    /// Inclusive cell range under the box's X/Z extent; false when the box
+    /// misses the grid.
+    bool cellRange(const Aabb& box, uint32_t& c0, uint32_t& r0, uint32_t& c1, uint32_t& r1) const;
+
+    std::vector<uint16_t> samples_;
+    /// Pyramid levels from the kBlockCells blocks up to the root, each
+    /// row-major; level i starts at levelStart_[i].
+    std::vector<Range> ranges_;
+    std::vector<uint32_t> levelStart_;
+    std::vector<uint32_t> levelColumns_;
+    std::vector<uint32_t> levelRows_;
+    uint32_t columns_ = 0;
+    uint32_t rows_ = 0;
+    uint32_t blockColumns_ = 0;
+    float spacing_ = 1.0f;
+    float originX_ = 0.0f;
+    float originZ_ = 0.0f;
+    float offset_ = 0.0f;
+    float scale_ = 1.0f;
+    Aabb bounds_;
+};
+
+} // namespace rebel::physics
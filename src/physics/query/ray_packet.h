@@ -0,0 +1,44 @@
+#pragma once
+
+#include "physics/broadphase/dynamic_tree.h"
+
+#include <cstdint>
+
+// Internal interface between SceneQuery and its per-ISA packet traversals.
+
+namespace rebel::physics::detail {
+
+/// Rays per packet: the AVX2 traversal takes all eight lanes, the SSE one
+/// the first four.
+inline constexpr uint32_t kPacketLanes = 8;
+
+/// Coherent rays transposed into lanes. `direction` is a representative
+/// used to visit the nearer child first.
+struct alignas(32) RayPacket {
+    float originX[kPacketLanes];
+    float originY[kPacketLanes];
+    float originZ[kPacketLanes];
+    float inverseX[kPacketLanes]; // 1 / direction, finite
+    float inverseY[kPacketLanes];
+    float inverseZ[kPacketLanes];
+    /// Per-lane search distance; the leaf callback shortens it as hits are
+    /// found.
+    float maxDistance[kPacketLanes];
+    float direction[3];
+    /// Bit per lane still searching; the leaf callback clears lanes that are
+    /// done.
+    uint32_t active;
+};
+
+/// Called for a tree leaf whose fat box the rays of `lanes` enter within
+/// their current maxDistance.
+using PacketLeafFn = void (*)(void* context, uint32_t proxy, uint32_t lanes, RayPacket& packet);
+
+/// Depth-first traversal of `tree`, near child first, testing every node
+/// box against all active lanes at once.
+using PacketTraversal = void (*)(const DynamicAabbTree& tree, RayPacket& packet, PacketLeafFn leaf, void* context);
+
+void traversePacketSse(const DynamicAabbTree& tree, RayPacket& packet, PacketLeafFn leaf, void* context);
+void traversePacketAvx2(const DynamicAabbTree& tree, RayPacket& packet, PacketLeafFn leaf, void* context);
+
+} // namespace rebel::physics::detail
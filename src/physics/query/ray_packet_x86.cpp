@@ -0,0 +1,72 @@
+#include "physics/query/ray_packet.h"
+
+#include "core/platform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// AVX2 variant of traversePacketSse() (see scene_query.cpp): the same walk
+// with all eight lanes per node test. SceneQuery only selects it after
+// checking detectSimdLevel().
+
+namespace rebel::physics::detail {
+
+REBEL_TARGET_AVX2 void traversePacketAvx2(const DynamicAabbTree& tree, RayPacket& packet, PacketLeafFn leaf,
+                                          void* context)
+{
+    if (tree.root() == kNullNode)
+        return;
+    const __m256 originX = _mm256_load_ps(packet.originX);
+    const __m256 originY = _mm256_load_ps(packet.originY);
+    const __m256 originZ = _mm256_load_ps(packet.originZ);
+    const __m256 inverseX = _mm256_load_ps(packet.inverseX);
+    const __m256 inverseY = _mm256_load_ps(packet.inverseY);
+    const __m256 inverseZ = _mm256_load_ps(packet.inverseZ);
+    const math::Vec3 direction{packet.direction[0], packet.direction[1], packet.direction[2]};
+
+    DynamicAabbTree::Stack stack;
+    stack.push(tree.root());
+    while (!stack.empty() && packet.active) {
+        const DynamicAabbTree::Node& node = tree.node(stack.pop());
+        const Aabb& box = node.aabb;
+        const __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.x), originX), inverseX);
+        const __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.x), originX), inverseX);
+        const __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.y), originY), inverseY);
+        const __m256 y2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.y), originY), inverseY);
+        const __m256 z1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.z), originZ), inverseZ);
+        const __m256 z2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.z), originZ), inverseZ);
+        __m256 enter = _mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2));
+        enter = _mm256_max_ps(_mm256_max_ps(enter, _mm256_min_ps(z1, z2)), _mm256_setzero_ps());
+        __m256 exit = _mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2));
+        exit = _mm256_min_ps(_mm256_min_ps(exit, _mm256_max_ps(z1, z2)), _mm256_load_ps(packet.maxDistance));
+        const uint32_t lanes = uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(enter, exit, _CMP_LE_OQ))) & packet.active;
+        if (lanes == 0)
+            continue;
+
+        if (node.leaf()) {
+            leaf(context, node.userData, lanes, packet);
+            continue;
+        }
+        const DynamicAabbTree::Node& child1 = tree.node(node.child1);
+        const DynamicAabbTree::Node& child2 = tree.node(node.child2);
+        const bool firstIsNearer = math::dot(child2.aabb.center() - child1.aabb.center(), direction) > 0.0f;
+        stack.push(firstIsNearer ? node.child2 : node.child1);
+        stack.push(firstIsNearer ? node.child1 : node.child2);
+    }
+}
+
+} // namespace rebel::physics::detail
+
+#else
+
+namespace rebel::physics::detail {
+
+void traversePacketAvx2(const DynamicAabbTree& tree, RayPacket& packet, PacketLeafFn leaf, void* context)
+{
+    traversePacketSse(tree, packet, leaf, context);
+}
+
+} // namespace rebel::physics::detail
+
+#endif
@@ -0,0 +1,320 @@
+#include "physics/query/scene_query.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/math/simd.h"
+#include "physics/collision/shape_cast.h"
+#include "physics/query/ray_packet.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+
+namespace rebel::physics {
+
+using math::Float4;
+using math::Vec3;
+
+namespace detail {
+
+void traversePacketSse(const DynamicAabbTree& tree, RayPacket& packet, PacketLeafFn leaf, void* context)
+{
+    if (tree.root() == kNullNode)
+        return;
+    const Float4 originX = Float4::loadAligned(packet.originX);
+    const Float4 originY = Float4::loadAligned(packet.originY);
+    const Float4 originZ = Float4::loadAligned(packet.originZ);
+    const Float4 inverseX = Float4::loadAligned(packet.inverseX);
+    const Float4 inverseY = Float4::loadAligned(packet.inverseY);
+    const Float4 inverseZ = Float4::loadAligned(packet.inverseZ);
+    const Vec3 direction{packet.direction[0], packet.direction[1], packet.direction[2]};
+
+    DynamicAabbTree::Stack stack;
+    stack.push(tree.root());
+    while (!stack.empty() && packet.active) {
+        const DynamicAabbTree::Node& node = tree.node(stack.pop());
+        const Aabb& box = node.aabb;
+        const Float4 x1 = (Float4(box.min.x) - originX) * inverseX;
+        const Float4 x2 = (Float4(box.max.x) - originX) * inverseX;
+        const Float4 y1 = (Float4(box.min.y) - originY) * inverseY;
+        const Float4 y2 = (Float4(box.max.y) - originY) * inverseY;
+        const Float4 z1 = (Float4(box.min.z) - originZ) * inverseZ;
+        const Float4 z2 = (Float4(box.max.z) - originZ) * inverseZ;
+        const Float4 enter = max(max(max(min(x1, x2), min(y1, y2)), min(z1, z2)), Float4::zero());
+        const Float4 exit =
+            min(min(min(max(x1, x2), max(y1, y2)), max(z1, z2)), Float4::loadAligned(packet.maxDistance));
+        const uint32_t lanes = uint32_t(moveMask(cmpLe(enter, exit))) & packet.active;
+        if (lanes == 0)
+            continue;
+
+        if (node.leaf()) {
+            leaf(context, node.userData, lanes, packet);
+            continue;
+        }
+        const DynamicAabbTree::Node& child1 = tree.node(node.child1);
+        const DynamicAabbTree::Node& child2 = tree.node(node.child2);
+        const bool firstIsNearer = math::dot(child2.aabb.center() - child1.aabb.center(), direction) > 0.0f;
+        stack.push(firstIsNearer ? node.child2 : node.child1);
+        stack.push(firstIsNearer ? node.child1 : node.child2);
+    }
+}
+
+} // namespace detail
+
+namespace {
+
+// Multiples of the widest packet, so jobs never split one.
+constexpr uint32_t kRaysPerJob = 256;
+constexpr uint32_t kSweepsPerJob = 16;
+constexpr uint32_t kOverlapsPerJob = 64;
+
+struct Hit {
+    uint32_t slot = UINT32_MAX;
+    CastHit cast;
+};
+
+// Single-ray walk, near child first. Node boxes are grown by
+// [lower, upper], the swept shape's bounds about its origin (zero for rays).
+// fn(proxy) tests a leaf, shortening maxDistance on a hit; false stops.
+template <typename Fn>
+void traverseRay(const DynamicAabbTree& tree, Vec3 origin, Vec3 direction, const float& maxDistance, Vec3 lower,
+                 Vec3 upper, Fn&& fn)
+{
+    if (tree.root() == kNullNode)
+        return;
+    const Vec3 inverse{safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z)};
+    DynamicAabbTree::Stack stack;
+    stack.push(tree.root());
+    while (!stack.empty()) {
+        const DynamicAabbTree::Node& node = tree.node(stack.pop());
+        const Vec3 t1 = (node.aabb.min - upper - origin) * inverse;
+        const Vec3 t2 = (node.aabb.max - lower - origin) * inverse;
+        const Vec3 near = math::min(t1, t2);
+        const Vec3 far = math::max(t1, t2);
+        const float enter = std::max({near.x, near.y, near.z, 0.0f});
+        const float exit = std::min({far.x, far.y, far.z, maxDistance});
+        if (enter > exit)
+            continue;
+
+        if (node.leaf()) {
+            if (!fn(node.userData))
+                return;
+            continue;
+        }
+        const DynamicAabbTree::Node& child1 = tree.node(node.child1);
+        const DynamicAabbTree::Node& child2 = tree.node(node.child2);
+        const bool firstIsNearer = math::dot(child2.aabb.center() - child1.aabb.center(), direction) > 0.0f;
+        stack.push(firstIsNearer ? node.child2 : node.child1);
+        stack.push(firstIsNearer ? node.child1 : node.child2);
+    }
+}
+
+const Body& bodyOfProxy(const PhysicsWorld& world, uint32_t proxy, uint32_t& slot)
+{
+    slot = world.broadphase().userData(proxy);
+    return *world.body(world.bodyId(slot));
+}
+
+void writeResult(const PhysicsWorld& world, const CastResults& results, uint32_t index, const Hit& hit,
+                 float maxDistance)
+{
+    const bool found = hit.slot != UINT32_MAX;
+    results.body[index] = found ? world.bodyId(hit.slot) : BodyId{};
+    results.distance[index] = found ? hit.cast.distance : maxDistance;
+    if (!results.point.empty())
+        results.point[index] = found ? hit.cast.point : Vec3{};
+    if (!results.normal.empty())
+        results.normal[index] = found ? hit.cast.normal : Vec3{};
+}
+
+void checkResults([[maybe_unused]] const CastResults& results, [[maybe_unused]] std::size_t count)
+{
+    REBEL_ASSERT(results.body.size() >= count && results.distance.size() >= count, "cast results too small");
+    REBEL_ASSERT(results.point.empty() || results.point.size() >= count, "cast results too small");
+    REBEL_ASSERT(results.normal.empty() || results.normal.size() >= count, "cast results too small");
+}
+
+// Rays share a packet walk when they start close together and point
+// roughly the same way, so their paths cross mostly the same nodes. Any
+// mix would give correct results; these only decide when it pays.
+constexpr float kPacketOriginSpread = 1.0f;
+constexpr float kPacketMinCosine = 0.9f; // about 25 degrees
+
+bool coherent(std::span<const Ray> rays)
+{
+    const Ray& first = rays[0];
+    return std::all_of(rays.begin() + 1, rays.end(), [&](const Ray& r) {
+        return math::dot(r.direction, first.direction) >= kPacketMinCosine &&
+               math::lengthSquared(r.origin - first.origin) <= kPacketOriginSpread * kPacketOriginSpread;
+    });
+}
+
+struct PacketContext {
+    const PhysicsWorld* world;
+    const Ray* rays; // lane 0's ray
+    QueryMode mode;
+    Hit hits[detail::kPacketLanes];
+};
+
+void packetLeaf(void* context, uint32_t proxy, uint32_t lanes, detail::RayPacket& packet)
+{
+    PacketContext& c = *static_cast<PacketContext*>(context);
+    uint32_t slot;
+    const Body& body = bodyOfProxy(*c.world, proxy, slot);
+    for (; lanes != 0; lanes &= lanes - 1) {
+        const uint32_t lane = uint32_t(std::countr_zero(lanes));
+        const Ray& ray = c.rays[lane];
+        CastHit hit;
+        if (slot == ray.ignore.index ||
+            !rayCast(body.shape, body.transform, ray.origin, ray.direction, packet.maxDistance[lane], hit))
+            continue;
+        packet.maxDistance[lane] = hit.distance;
+        c.hits[lane] = {slot, hit};
+        if (c.mode == QueryMode::Any)
+            packet.active &= ~(1u << lane);
+    }
+}
+
+} // namespace
+
+SceneQuery::SceneQuery(const SceneQueryDesc& desc)
+    : level_(std::min(desc.simdLevel, detectSimdLevel()))
+    , packetWidth_(level_ >= SimdLevel::Avx2 ? 8 : 4)
+    , packets_(desc.packets)
+{
+}
+
+void SceneQuery::raycast(const PhysicsWorld& world, std::span<const Ray> rays, QueryMode mode,
+                         const CastResults& results, jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(world.broadphase().type() == BroadphaseType::DynamicTree, "scene queries need a DynamicTree");
+    checkResults(results, rays.size());
+    const DynamicAabbTree& tree = world.broadphase().tree();
+    const detail::PacketTraversal traverse =
+        level_ >= SimdLevel::Avx2 ? detail::traversePacketAvx2 : detail::traversePacketSse;
+    const uint32_t count = uint32_t(rays.size());
+    const uint32_t width = packetWidth_;
+    const uint32_t groups = (count + width - 1) / width;
+
+    std::atomic<uint32_t> packets{0}, packetRays{0}, singleRays{0};
+    jobs.parallelFor(groups, kRaysPerJob / width, [&](uint32_t begin, uint32_t end) {
+        uint32_t jobPackets = 0, jobPacketRays = 0, jobSingleRays = 0;
+        for (uint32_t group = begin; group < end; ++group) {
+            const uint32_t first = group * width;
+            const std::span<const Ray> batch = rays.subspan(first, std::min(width, count - first));
+            if (packets_ && batch.size() > 1 && coherent(batch)) {
+                alignas(32) detail::RayPacket packet{};
+                for (uint32_t lane = 0; lane < batch.size(); ++lane) {
+                    const Ray& ray = batch[lane];
+                    packet.originX[lane] = ray.origin.x;
+                    packet.originY[lane] = ray.origin.y;
+                    packet.originZ[lane] = ray.origin.z;
+                    packet.inverseX[lane] = safeInverse(ray.direction.x);
+                    packet.inverseY[lane] = safeInverse(ray.direction.y);
+                    packet.inverseZ[lane] = safeInverse(ray.direction.z);
+                    packet.maxDistance[lane] = ray.maxDistance;
+                }
+                packet.direction[0] = batch[0].direction.x;
+                packet.direction[1] = batch[0].direction.y;
+                packet.direction[2] = batch[0].direction.z;
+                packet.active = (1u << batch.size()) - 1;
+
+                PacketContext context{&world, batch.data(), mode, {}};
+                traverse(tree, packet, packetLeaf, &context);
+                for (uint32_t lane = 0; lane < batch.size(); ++lane)
+                    writeResult(world, results, first + lane, context.hits[lane], batch[lane].maxDistance);
+                ++jobPackets;
+                jobPacketRays += uint32_t(batch.size());
+                continue;
+            }
+
+            for (uint32_t i = 0; i < batch.size(); ++i) {
+                const Ray& ray = batch[i];
+                Hit best;
+                float maxDistance = ray.maxDistance;
+                traverseRay(tree, ray.origin, ray.direction, maxDistance, {}, {}, [&](uint32_t proxy) {
+                    uint32_t slot;
+                    const Body& body = bodyOfProxy(world, proxy, slot);
+                    CastHit hit;
+                    if (slot == ray.ignore.index ||
+                        !rayCast(body.shape, body.transform, ray.origin, ray.direction, maxDistance, hit))
+                        return true;
+                    maxDistance = hit.distance;
+                    best = {slot, hit};
+                    return mode == QueryMode::Closest;
+                });
+                writeResult(world, results, first + i, best, ray.maxDistance);
+            }
+            jobSingleRays += uint32_t(batch.size());
+        }
+        packets.fetch_add(jobPackets, std::memory_order_relaxed);
+        packetRays.fetch_add(jobPacketRays, std::memory_order_relaxed);
+        singleRays.fetch_add(jobSingleRays, std::memory_order_relaxed);
+    });
+    stats_ = {count, packets.load(), packetRays.load(), singleRays.load()};
+}
+
+void SceneQuery::sweep(const PhysicsWorld& world, std::span<const ShapeSweep> sweeps, QueryMode mode,
+                       const CastResults& results, jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(world.broadphase().type() == BroadphaseType::DynamicTree, "scene queries need a DynamicTree");
+    checkResults(results, sweeps.size());
+    const DynamicAabbTree& tree = world.broadphase().tree();
+
+    jobs.parallelFor(uint32_t(sweeps.size()), kSweepsPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const ShapeSweep& sweep = sweeps[i];
+            const Aabb bounds = computeAabb(sweep.shape, sweep.start);
+            Hit best;
+            float maxDistance = sweep.maxDistance;
+            traverseRay(tree, sweep.start.position, sweep.direction, maxDistance,
+                        bounds.min - sweep.start.position, bounds.max - sweep.start.position, [&](uint32_t proxy) {
+                            uint32_t slot;
+                            const Body& body = bodyOfProxy(world, proxy, slot);
+                            CastHit hit;
+                            if (slot == sweep.ignore.index ||
+                                !shapeCast(sweep.shape, sweep.start, sweep.direction, maxDistance, body.shape,
+                                           body.transform, hit))
+                                return true;
+                            maxDistance = hit.distance;
+                            best = {slot, hit};
+                            return mode == QueryMode::Closest;
+                        });
+            writeResult(world, results, i, best, sweep.maxDistance);
+        }
+    });
+    stats_ = {uint32_t(sweeps.size()), 0, 0, 0};
+}
+
+void SceneQuery::overlap(const PhysicsWorld& world, std::span<const ShapeOverlap> overlaps,
+                         const OverlapResults& results, jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(world.broadphase().type() == BroadphaseType::DynamicTree, "scene queries need a DynamicTree");
+    REBEL_ASSERT(results.count.size() >= overlaps.size() &&
+                     results.bodies.size() >= overlaps.size() * std::size_t(results.maxPerQuery),
+                 "overlap results too small");
+    const DynamicAabbTree& tree = world.broadphase().tree();
+
+    jobs.parallelFor(uint32_t(overlaps.size()), kOverlapsPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const ShapeOverlap& overlap = overlaps[i];
+            BodyId* out = results.bodies.data() + std::size_t(i) * results.maxPerQuery;
+            uint32_t found = 0;
+            if (results.maxPerQuery > 0) {
+                tree.query(computeAabb(overlap.shape, overlap.transform), [&](uint32_t proxy) {
+                    uint32_t slot;
+                    const Body& body = bodyOfProxy(world, proxy, slot);
+                    if (shapesOverlap(overlap.shape, overlap.transform, body.shape, body.transform))
+                        out[found++] = world.bodyId(slot);
+                    return found < results.maxPerQuery;
+                });
+            }
+            results.count[i] = found;
+        }
+    });
+    stats_ = {uint32_t(overlaps.size()), 0, 0, 0};
+}
+
+} // namespace rebel::physics
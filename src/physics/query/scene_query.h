@@ -0,0 +1,120 @@
+#pragma once
+
+#include "core/cpu_features.h"
+#include "core/math/vec.h"
+#include "physics/body.h"
+#include "physics/shape.h"
+#include "physics/transform.h"
+
+#include <cfloat>
+#include <cstdint>
+#include <span>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+class PhysicsWorld;
+
+struct Ray {
+    math::Vec3 origin;
+    math::Vec3 direction; // unit length
+    float maxDistance = FLT_MAX;
+    /// Never hit, e.g. the live body the ray is cast from.
+    BodyId ignore;
+};
+
+struct ShapeSweep {
+    Shape shape;
+    Transform start;
+    math::Vec3 direction; // unit length
+    float maxDistance = 0.0f;
+    BodyId ignore; // as for Ray
+};
+
+struct ShapeOverlap {
+    Shape shape;
+    Transform transform;
+};
+
+enum class QueryMode : uint8_t {
+    /// The nearest hit along each ray or sweep.
+    Closest,
+    /// Any hit, e.g. for line-of-sight tests. Stops at the first one found.
+    Any,
+};
+
+/// Caller-owned result arrays for ray and sweep batches, one element per
+/// query in query order. `body` and `distance` are required; `point` and
+/// `normal` may be left empty when not needed. Misses get a null body, the
+/// query's maxDistance and zero vectors.
+struct CastResults {
+    std::span<BodyId> body;
+    std::span<float> distance;
+    std::span<math::Vec3> point;
+    std::span<math::Vec3> normal;
+};
+
+/// Caller-owned result arrays for overlap batches. Query i writes its bodies
+/// to bodies[i * maxPerQuery ...] and their number, at most maxPerQuery, to
+/// count[i].
+struct OverlapResults {
+    uint32_t maxPerQuery = 0;
+    std::span<uint32_t> count;
+    std::span<BodyId> bodies;
+};
+
+struct SceneQueryDesc {
+    SimdLevel simdLevel = detectSimdLevel();
+    /// Trace runs of coherent rays as packets. Off traces every ray alone.
+    bool packets = true;
+};
+
+struct SceneQueryStats {
+    uint32_t queries = 0;
+    uint32_t packets = 0;    // ray packets traced
+    uint32_t packetRays = 0; // rays traced inside them
+    uint32_t singleRays = 0; // rays traced alone
+};
+
+/// Batched raycasts, shape sweeps and overlap tests against a PhysicsWorld's
+/// bodies, split into jobs over the broadphase tree. Nothing is allocated:
+/// results go straight to the caller's arrays.
+///
+/// Rays are taken in groups of the packet width (eight with AVX2, four
+/// otherwise). A group whose rays start within a metre of each other and
+/// point within about 25 degrees of each other is traced as one packet:
+/// each tree node is tested against every ray of the group in one SIMD slab
+/// test, and the walk is shared for as long as any of them still needs it.
+/// Other groups fall back to one walk per ray. Callers get the most out of
+/// packets by keeping such rays next to each other, as fans of sight lines
+/// naturally are.
+///
+/// Needs the DynamicTree broadphase. Must not overlap with step().
+class SceneQuery {
+public:
+    explicit SceneQuery(const SceneQueryDesc& desc = {});
+
+    SimdLevel simdLevel() const { return level_; }
+    uint32_t packetWidth() const { return packetWidth_; }
+
+    void raycast(const PhysicsWorld& world, std::span<const Ray> rays, QueryMode mode, const CastResults& results,
+                 jobs::JobSystem& jobs);
+    void sweep(const PhysicsWorld& world, std::span<const ShapeSweep> sweeps, QueryMode mode,
+               const CastResults& results, jobs::JobSystem& jobs);
+    void overlap(const PhysicsWorld& world, std::span<const ShapeOverlap> overlaps, const OverlapResults& results,
+                 jobs::JobSystem& jobs);
+
+    /// Of the last batch.
+    const SceneQueryStats& stats() const { return stats_; }
+
+private:
+    SimdLevel level_;
+    uint32_t packetWidth_;
+    bool packets_;
+    SceneQueryStats stats_;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,104 @@
+#include "physics/shape.h"
+
+#include "core/math/mat.h"
+#include "core/assert.h"
+#include "physics/convex_hull.h"
+#include "physics/heightfield.h"
+#include "physics/triangle_mesh.h"
+
+#include <cmath>
+
+namespace rebel::physics {
+
+namespace {
+
+// Bounds of a body-space box (centre, half extents) placed at `transform`:
+// the extent along each world axis is |R| * e.
+Aabb transformedBox(math::Vec3 center, math::Vec3 e, const Transform& transform)
+{
+    const math::Mat3 r = math::Mat3::fromQuat(transform.rotation);
+    const math::Vec3 extents{
+        std::fabs(r.cols[0].x) * e.x + std::fabs(r.cols[1].x) * e.y + std::fabs(r.cols[2].x) * e.z,
+        std::fabs(r.cols[0].y) * e.x + std::fabs(r.cols[1].y) * e.y + std::fabs(r.cols[2].y) * e.z,
+        std::fabs(r.cols[0].z) * e.x + std::fabs(r.cols[1].z) * e.y + std::fabs(r.cols[2].z) * e.z};
+    return Aabb::fromCenterExtents(transform.apply(center), extents);
+}
+
+} // namespace
+
+Aabb computeAabb(const Shape& shape, const Transform& transform)
+{
+    switch (shape.type) {
+    case ShapeType::Sphere:
+        return Aabb::fromCenterExtents(transform.position, math::Vec3{shape.radius});
+    case ShapeType::Box:
+        return transformedBox({}, shape.halfExtents, transform);
+    case ShapeType::Capsule: {
+        const math::Vec3 axis = transform.rotate({0.0f, shape.halfHeight, 0.0f});
+        return Aabb::fromCenterExtents(transform.position, math::abs(axis) + math::Vec3{shape.radius});
+    }
+    case ShapeType::ConvexHull:
+        return transformedBox(shape.hull->bounds().center(), shape.hull->bounds().extents(), transform);
+    case ShapeType::Heightfield:
+        return transformedBox(shape.field->bounds().center(), shape.field->bounds().extents(), transform);
+    case ShapeType::TriangleMesh:
+        return transformedBox(shape.mesh->bounds().center(), shape.mesh->bounds().extents(), transform);
+    }
+    return {};
+}
+
+float boundingRadius(const Shape& shape)
+{
+    switch (shape.type) {
+    case ShapeType::Sphere:
+        return shape.radius;
+    case ShapeType::Box:
+        return math::length(shape.halfExtents);
+    case ShapeType::Capsule:
+        return shape.halfHeight + shape.radius;
+    case ShapeType::ConvexHull:
+    case ShapeType::Heightfield:
+    case ShapeType::TriangleMesh: {
+        const Aabb& bounds = shape.type == ShapeType::ConvexHull    ? shape.hull->bounds()
+                             : shape.type == ShapeType::Heightfield ? shape.field->bounds()
+                                                                    : shape.mesh->bounds();
+        return math::length(math::max(math::abs(bounds.min), math::abs(bounds.max)));
+    }
+    }
+    return 0.0f;
+}
+
+math::Vec3 computeInertia(const Shape& shape, float mass)
+{
+    switch (shape.type) {
+    case ShapeType::Sphere:
+        return math::Vec3{0.4f * mass * shape.radius * shape.radius};
+    case ShapeType::Box: {
+        const math::Vec3 d = shape.halfExtents * 2.0f;
+        const float k = mass / 12.0f;
+        return {k * (d.y * d.y + d.z * d.z), k * (d.x * d.x + d.z * d.z), k * (d.x * d.x + d.y * d.y)};
+    }
+    case ShapeType::Capsule: {
+        // Cylinder plus two hemispheres, split by volume; the hemisphere
+        // terms use the parallel axis theorem about the capsule centre.
+        const float r = shape.radius, h = 2.0f * shape.halfHeight;
+        const float cylinder = math::kPi * r * r * h;
+        const float spheres = 4.0f / 3.0f * math::kPi * r * r * r;
+        const float mc = mass * cylinder / (cylinder + spheres);
+        const float ms = mass - mc;
+        const float axial = 0.5f * mc * r * r + 0.4f * ms * r * r;
+        const float transverse =
+            mc * (3.0f * r * r + h * h) / 12.0f + ms * (0.4f * r * r + 0.25f * h * h + 0.375f * h * r);
+        return {transverse, axial, transverse};
+    }
+    case ShapeType::ConvexHull:
+        return computeInertia(Shape::box(shape.hull->bounds().extents()), mass);
+    case ShapeType::Heightfield:
+    case ShapeType::TriangleMesh:
+        REBEL_ASSERT(false, "triangle shapes are static only");
+        break;
+    }
+    return math::Vec3{1.0f};
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/aabb.h"
+#include "physics/transform.h"
+
+#include <cstdint>
+
+namespace rebel::physics {
+
+class ConvexHull;
+class Heightfield;
+class TriangleMesh;
+
+enum class ShapeType : uint8_t {
+    Sphere,
+    Box,
+    Capsule,
+    ConvexHull,
+    /// Static bodies only, as are triangle meshes.
+    Heightfield,
+    TriangleMesh,
+};
+
+/// True for the shapes made of triangles, which only static bodies use.
+constexpr bool isTriangleShape(ShapeType type)
+{
+    return type == ShapeType::Heightfield || type == ShapeType::TriangleMesh;
+}
+
+/// Collision shape, stored by value in each body. Shapes are centred on the
+/// body origin.
+struct Shape {
+    ShapeType type = ShapeType::Sphere;
+    float radius = 0.5f;                      // Sphere, Capsule
+    float halfHeight = 0.5f;                  // Capsule: segment along local Y
+    math::Vec3 halfExtents{0.5f, 0.5f, 0.5f}; // Box
+    const ConvexHull* hull = nullptr;         // ConvexHull; must outlive the body
+    const Heightfield* field = nullptr;       // Heightfield; must outlive the body
+    const TriangleMesh* mesh = nullptr;       // TriangleMesh; must outlive the body
+
+    static constexpr Shape sphere(float radius)
+    {
+        Shape s;
+        s.type = ShapeType::Sphere;
+        s.radius = radius;
+        return s;
+    }
+
+    static constexpr Shape box(math::Vec3 halfExtents)
+    {
+        Shape s;
+        s.type = ShapeType::Box;
+        s.halfExtents = halfExtents;
+        return s;
+    }
+
+    static constexpr Shape capsule(float radius, float halfHeight)
+    {
+        Shape s;
+        s.type = ShapeType::Capsule;
+        s.radius = radius;
+        s.halfHeight = halfHeight;
+        return s;
+    }
+
+    static constexpr Shape convexHull(const ConvexHull* hull)
+    {
+        Shape s;
+        s.type = ShapeType::ConvexHull;
+        s.hull = hull;
+        return s;
+    }
+
+    static constexpr Shape heightfield(const Heightfield* heightfield)
+    {
+        Shape s;
+        s.type = ShapeType::Heightfield;
+        s.field = heightfield;
+        return s;
+    }
+
+    static constexpr Shape triangleMesh(const TriangleMesh* mesh)
+    {
+        Shape s;
+        s.type = ShapeType::TriangleMesh;
+        s.mesh = mesh;
+        return s;
+    }
+};
+
+/// World-space bounds of a shape placed at `transform`.
+Aabb computeAabb(const Shape& shape, const Transform& transform);
+
+/// Radius of the smallest origin-centred sphere enclosing the shape; bounds
+/// how far a surface point moves as the body turns.
+float boundingRadius(const Shape& shape);
+
+/// Principal moments of inertia (body space) for a solid shape of `mass`.
+/// Convex hulls use their bounding box. Not defined for triangle shapes,
+/// which are never dynamic.
+math::Vec3 computeInertia(const Shape& shape, float mass);
+
+} // namespace rebel::physics
@@ -0,0 +1,105 @@
+#include "physics/softbody/soft_body.h"
+
+#include "core/assert.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+SoftBodyDesc makeCloth(uint32_t columns, uint32_t rows, float spacing, const Transform& placement,
+                       const SoftBodyMaterial& material)
+{
+    REBEL_ASSERT(columns >= 2 && rows >= 2, "cloth needs at least 2 x 2 particles");
+    SoftBodyDesc desc;
+    auto index = [columns](uint32_t x, uint32_t y) { return y * columns + x; };
+    for (uint32_t y = 0; y < rows; ++y) {
+        for (uint32_t x = 0; x < columns; ++x)
+            desc.positions.push_back(placement.apply({float(x) * spacing, -float(y) * spacing, 0.0f}));
+    }
+    for (uint32_t y = 0; y < rows; ++y) {
+        for (uint32_t x = 0; x < columns; ++x) {
+            if (x + 1 < columns)
+                desc.distances.push_back({index(x, y), index(x + 1, y), material.stretchCompliance});
+            if (y + 1 < rows)
+                desc.distances.push_back({index(x, y), index(x, y + 1), material.stretchCompliance});
+            if (x + 1 < columns && y + 1 < rows) {
+                desc.distances.push_back({index(x, y), index(x + 1, y + 1), material.shearCompliance});
+                desc.distances.push_back({index(x + 1, y), index(x, y + 1), material.shearCompliance});
+            }
+            if (x + 2 < columns)
+                desc.distances.push_back({index(x, y), index(x + 2, y), material.bendCompliance});
+            if (y + 2 < rows)
+                desc.distances.push_back({index(x, y), index(x, y + 2), material.bendCompliance});
+        }
+    }
+    return desc;
+}
+
+SoftBodyDesc makeRope(uint32_t segments, float length, const Transform& placement, const SoftBodyMaterial& material)
+{
+    REBEL_ASSERT(segments >= 1, "rope needs a segment");
+    SoftBodyDesc desc;
+    const float step = length / float(segments);
+    for (uint32_t i = 0; i <= segments; ++i)
+        desc.positions.push_back(placement.apply({0.0f, -float(i) * step, 0.0f}));
+    for (uint32_t i = 0; i < segments; ++i) {
+        desc.distances.push_back({i, i + 1, material.stretchCompliance});
+        if (i + 2 <= segments)
+            desc.distances.push_back({i, i + 2, material.bendCompliance});
+    }
+    return desc;
+}
+
+SoftBodyDesc makeBlock(uint32_t cellsX, uint32_t cellsY, uint32_t cellsZ, float spacing, const Transform& placement,
+                       const SoftBodyMaterial& material)
+{
+    REBEL_ASSERT(cellsX >= 1 && cellsY >= 1 && cellsZ >= 1, "block needs a cell");
+    SoftBodyDesc desc;
+    const uint32_t nx = cellsX + 1, ny = cellsY + 1;
+    auto index = [&](uint32_t x, uint32_t y, uint32_t z) { return (z * ny + y) * nx + x; };
+    for (uint32_t z = 0; z <= cellsZ; ++z) {
+        for (uint32_t y = 0; y <= cellsY; ++y) {
+            for (uint32_t x = 0; x <= cellsX; ++x)
+                desc.positions.push_back(placement.apply(Vec3{float(x), float(y), float(z)} * spacing));
+        }
+    }
+
+    // Corner c of a cell is offset (c & 1, c >> 1 & 1, c >> 2). Cells
+    // alternate between the two mirror-image five-tetrahedron splits so
+    // shared faces are cut the same way on both sides.
+    static constexpr uint32_t kSplits[2][5][4] = {
+        {{0, 1, 2, 4}, {3, 2, 1, 7}, {5, 1, 4, 7}, {6, 4, 2, 7}, {1, 2, 4, 7}},
+        {{1, 0, 3, 5}, {2, 0, 6, 3}, {4, 0, 5, 6}, {7, 3, 6, 5}, {0, 3, 5, 6}},
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t z = 0; z < cellsZ; ++z) {
+        for (uint32_t y = 0; y < cellsY; ++y) {
+            for (uint32_t x = 0; x < cellsX; ++x) {
+                uint32_t corner[8];
+                for (uint32_t c = 0; c < 8; ++c)
+                    corner[c] = index(x + (c & 1), y + (c >> 1 & 1), z + (c >> 2));
+                for (const auto& tet : kSplits[(x + y + z) & 1]) {
+                    VolumeConstraint volume{{corner[tet[0]], corner[tet[1]], corner[tet[2]], corner[tet[3]]},
+                                            material.volumeCompliance};
+                    desc.volumes.push_back(volume);
+                    for (uint32_t i = 0; i < 4; ++i) {
+                        for (uint32_t j = i + 1; j < 4; ++j) {
+                            const uint32_t a = volume.particles[i], b = volume.particles[j];
+                            edges.emplace_back(std::min(a, b), std::max(a, b));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    for (const auto& [a, b] : edges)
+        desc.distances.push_back({a, b, material.stretchCompliance});
+    return desc;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/transform.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::physics {
+
+/// Position and inverse mass, 16 bytes so one particle loads as one SIMD
+/// register and four or eight transpose straight into lanes.
+struct alignas(16) SoftParticle {
+    math::Vec3 position;
+    float inverseMass = 0.0f;
+};
+
+/// Keeps two particles at their rest distance.
+struct DistanceConstraint {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    /// Inverse stiffness in m/N; zero is rigid.
+    float compliance = 0.0f;
+};
+
+/// Keeps the signed volume of a tetrahedron at its rest value.
+struct VolumeConstraint {
+    uint32_t particles[4] = {};
+    float compliance = 0.0f;
+};
+
+/// Particles and constraints of one cloth, rope or soft body. Rest lengths
+/// and volumes are taken from `positions`.
+struct SoftBodyDesc {
+    std::vector<math::Vec3> positions;
+    /// Per particle; empty gives every particle 1. Zero pins a particle to
+    /// wherever SoftBodyWorld::setPinned() puts it.
+    std::vector<float> inverseMasses;
+    /// Stretch, shear and bending. Bending is resisted by distance
+    /// constraints between the far vertices of neighbouring triangles (or
+    /// segments), the cheap form that needs no dihedral angles, so all three
+    /// share one batched kernel.
+    std::vector<DistanceConstraint> distances;
+    std::vector<VolumeConstraint> volumes;
+    /// Collision thickness against rigid bodies.
+    float particleRadius = 0.02f;
+    /// Share of the tangential slip cancelled while touching a rigid body.
+    float friction = 0.3f;
+    /// Fraction of the velocity removed per second.
+    float damping = 0.1f;
+};
+
+struct SoftBodyMaterial {
+    float stretchCompliance = 0.0f;
+    float shearCompliance = 1e-5f;
+    float bendCompliance = 1e-3f;
+    float volumeCompliance = 0.0f;
+};
+
+/// A `columns` x `rows` grid hanging down from its top row along -Y in the
+/// local XY plane, placed by `placement`. Structural, diagonal shear and
+/// skip-one bending constraints. Particles are row-major from the top left,
+/// so the top row is [0, columns).
+SoftBodyDesc makeCloth(uint32_t columns, uint32_t rows, float spacing, const Transform& placement,
+                       const SoftBodyMaterial& material = {});
+
+/// `segments` links hanging along -Y from `placement`, with skip-one
+/// bending constraints. Particle 0 is the top end.
+SoftBodyDesc makeRope(uint32_t segments, float length, const Transform& placement,
+                      const SoftBodyMaterial& material = {});
+
+/// A lattice of cellsX x cellsY x cellsZ cubes split into five tetrahedra
+/// each, with volume constraints per tetrahedron and distance constraints
+/// along their edges. The lattice's minimum corner sits at `placement`.
+SoftBodyDesc makeBlock(uint32_t cellsX, uint32_t cellsY, uint32_t cellsZ, float spacing, const Transform& placement,
+                       const SoftBodyMaterial& material = {});
+
+} // namespace rebel::physics
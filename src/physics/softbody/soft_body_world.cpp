@@ -0,0 +1,565 @@
+#include "physics/softbody/soft_body_world.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/math/simd.h"
+#include "physics/collision/gjk.h"
+#include "physics/collision/triangles.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace rebel::physics {
+
+using math::Float4;
+using math::Vec3;
+
+namespace detail {
+
+namespace {
+
+// Four particles transposed into lanes.
+struct Lanes4 {
+    Float4 x, y, z, w;
+};
+
+REBEL_FORCEINLINE Lanes4 gather(const SoftParticle* particles, const uint32_t* index)
+{
+    Lanes4 l{Float4::loadAligned(&particles[index[0]].position.x), Float4::loadAligned(&particles[index[1]].position.x),
+             Float4::loadAligned(&particles[index[2]].position.x), Float4::loadAligned(&particles[index[3]].position.x)};
+    math::transpose4(l.x, l.y, l.z, l.w);
+    return l;
+}
+
+REBEL_FORCEINLINE void scatter(SoftParticle* particles, const uint32_t* index, Lanes4 l)
+{
+    math::transpose4(l.x, l.y, l.z, l.w);
+    l.x.storeAligned(&particles[index[0]].position.x);
+    l.y.storeAligned(&particles[index[1]].position.x);
+    l.z.storeAligned(&particles[index[2]].position.x);
+    l.w.storeAligned(&particles[index[3]].position.x);
+}
+
+void solveDistanceHalf(const DistanceBatch& batch, uint32_t lane, SoftParticle* particles, Float4 alphaScale)
+{
+    const Float4 epsilon(1e-9f);
+    Lanes4 a = gather(particles, batch.a + lane);
+    Lanes4 b = gather(particles, batch.b + lane);
+
+    const Float4 dx = a.x - b.x;
+    const Float4 dy = a.y - b.y;
+    const Float4 dz = a.z - b.z;
+    const Float4 length = sqrt(dx * dx + dy * dy + dz * dz);
+    const Float4 error = length - Float4::loadAligned(batch.restLength + lane);
+    const Float4 alpha = Float4::loadAligned(batch.compliance + lane) * alphaScale;
+    const Float4 weight = a.w + b.w + alpha + epsilon;
+    // lambda / length, zero for coincident particles.
+    const Float4 scale = (error / (weight * length)) & cmpGt(length, epsilon);
+
+    const Float4 sa = scale * a.w;
+    const Float4 sb = scale * b.w;
+    a.x -= dx * sa;
+    a.y -= dy * sa;
+    a.z -= dz * sa;
+    b.x += dx * sb;
+    b.y += dy * sb;
+    b.z += dz * sb;
+    scatter(particles, batch.a + lane, a);
+    scatter(particles, batch.b + lane, b);
+}
+
+struct Vec3x4 {
+    Float4 x, y, z;
+};
+
+REBEL_FORCEINLINE Vec3x4 operator-(const Vec3x4& a, const Vec3x4& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+
+REBEL_FORCEINLINE Vec3x4 cross(const Vec3x4& a, const Vec3x4& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+REBEL_FORCEINLINE Float4 dot(const Vec3x4& a, const Vec3x4& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+void solveVolumeHalf(const VolumeBatch& batch, uint32_t lane, SoftParticle* particles, Float4 alphaScale)
+{
+    Lanes4 p[4];
+    for (uint32_t k = 0; k < 4; ++k)
+        p[k] = gather(particles, batch.particles[k] + lane);
+    const Vec3x4 p0{p[0].x, p[0].y, p[0].z};
+    const Vec3x4 e1 = Vec3x4{p[1].x, p[1].y, p[1].z} - p0;
+    const Vec3x4 e2 = Vec3x4{p[2].x, p[2].y, p[2].z} - p0;
+    const Vec3x4 e3 = Vec3x4{p[3].x, p[3].y, p[3].z} - p0;
+
+    // Gradients of six times the signed volume e1 . (e2 x e3).
+    Vec3x4 g[4];
+    g[1] = cross(e2, e3);
+    g[2] = cross(e3, e1);
+    g[3] = cross(e1, e2);
+    g[0] = {-(g[1].x + g[2].x + g[3].x), -(g[1].y + g[2].y + g[3].y), -(g[1].z + g[2].z + g[3].z)};
+
+    const Float4 error = dot(e1, g[1]) - Float4::loadAligned(batch.restVolume + lane);
+    Float4 weight = Float4::loadAligned(batch.compliance + lane) * alphaScale + Float4(1e-9f);
+    for (uint32_t k = 0; k < 4; ++k)
+        weight += p[k].w * dot(g[k], g[k]);
+    const Float4 lambda = -error / weight;
+
+    for (uint32_t k = 0; k < 4; ++k) {
+        const Float4 s = lambda * p[k].w;
+        p[k].x += g[k].x * s;
+        p[k].y += g[k].y * s;
+        p[k].z += g[k].z * s;
+        scatter(particles, batch.particles[k] + lane, p[k]);
+    }
+}
+
+} // namespace
+
+void solveDistancesSse(const DistanceBatch* batches, uint32_t count, SoftParticle* particles, float inverseDtSquared)
+{
+    const Float4 alphaScale(inverseDtSquared);
+    for (uint32_t i = 0; i < count; ++i) {
+        solveDistanceHalf(batches[i], 0, particles, alphaScale);
+        // Lanes fill in order, and only padding lanes have a == b.
+        if (batches[i].a[4] != batches[i].b[4])
+            solveDistanceHalf(batches[i], 4, particles, alphaScale);
+    }
+}
+
+void solveVolumesSse(const VolumeBatch* batches, uint32_t count, SoftParticle* particles, float inverseDtSquared)
+{
+    const Float4 alphaScale(inverseDtSquared);
+    for (uint32_t i = 0; i < count; ++i) {
+        solveVolumeHalf(batches[i], 0, particles, alphaScale);
+        if (batches[i].particles[0][4] != batches[i].particles[1][4])
+            solveVolumeHalf(batches[i], 4, particles, alphaScale);
+    }
+}
+
+} // namespace detail
+
+namespace {
+
+using detail::DistanceBatch;
+using detail::kXpbdLanes;
+using detail::VolumeBatch;
+
+float signedVolume6(Vec3 p0, Vec3 p1, Vec3 p2, Vec3 p3)
+{
+    return math::dot(p1 - p0, math::cross(p2 - p0, p3 - p0));
+}
+
+// Greedy colouring in constraint order: each constraint takes the lowest
+// colour none of its particles has yet. Returns kMaxColors for overflow.
+template <uint32_t N>
+uint32_t pickColor(std::vector<uint64_t>& used, const uint32_t (&particles)[N])
+{
+    uint64_t taken = 0;
+    for (const uint32_t p : particles)
+        taken |= used[p];
+    if (taken == ~uint64_t(0))
+        return SoftBodyWorld::kMaxColors;
+    const uint32_t color = uint32_t(std::countr_zero(~taken));
+    for (const uint32_t p : particles)
+        used[p] |= uint64_t(1) << color;
+    return color;
+}
+
+// Batch ranges per colour from per-colour constraint counts.
+uint32_t layoutColors(const uint32_t (&counts)[SoftBodyWorld::kMaxColors], std::vector<uint32_t>& start)
+{
+    start.assign(SoftBodyWorld::kMaxColors + 1, 0);
+    uint32_t colors = 0;
+    for (uint32_t c = 0; c < SoftBodyWorld::kMaxColors; ++c) {
+        start[c + 1] = start[c] + (counts[c] + kXpbdLanes - 1) / kXpbdLanes;
+        colors += counts[c] > 0;
+    }
+    return colors;
+}
+
+// Pushes `p` out of the rigid shape by `radius`: the outward normal and
+// depth, or false when it is clear. `axis` is the capsule's world axis.
+bool penetration(const Shape& shape, const Transform& transform, Vec3 axis, Vec3 p, float radius, Vec3& normal,
+                 float& depth)
+{
+    switch (shape.type) {
+    case ShapeType::Sphere:
+    case ShapeType::Capsule: {
+        Vec3 center = transform.position;
+        if (shape.type == ShapeType::Capsule)
+            center += axis * math::clamp(math::dot(p - center, axis), -shape.halfHeight, shape.halfHeight);
+        const Vec3 d = p - center;
+        const float reach = shape.radius + radius;
+        const float distance2 = math::lengthSquared(d);
+        if (distance2 >= reach * reach)
+            return false;
+        const float distance = std::sqrt(distance2);
+        normal = distance > 1e-9f ? d * (1.0f / distance) : Vec3{0.0f, 1.0f, 0.0f};
+        depth = reach - distance;
+        return true;
+    }
+    case ShapeType::Box: {
+        const Vec3 q = transform.applyInverse(p);
+        const Vec3 he = shape.halfExtents;
+        const Vec3 clamped{math::clamp(q.x, -he.x, he.x), math::clamp(q.y, -he.y, he.y),
+                           math::clamp(q.z, -he.z, he.z)};
+        const Vec3 d = q - clamped;
+        const float distance2 = math::lengthSquared(d);
+        Vec3 local{};
+        if (distance2 > 0.0f) {
+            if (distance2 >= radius * radius)
+                return false;
+            const float distance = std::sqrt(distance2);
+            local = d * (1.0f / distance);
+            depth = radius - distance;
+        } else {
+            // Inside: out through the nearest face.
+            int axis = 0;
+            float nearest = he.x - std::fabs(q.x);
+            for (int i = 1; i < 3; ++i) {
+                const float gap = he[i] - std::fabs(q[i]);
+                if (gap < nearest) {
+                    nearest = gap;
+                    axis = i;
+                }
+            }
+            local[axis] = q[axis] < 0.0f ? -1.0f : 1.0f;
+            depth = nearest + radius;
+        }
+        normal = transform.rotate(local);
+        return true;
+    }
+    case ShapeType::ConvexHull: {
+        static constexpr Shape kPoint = Shape::sphere(0.0f);
+        const ConvexCore point(kPoint, {p, {}});
+        const ConvexCore hull(shape, transform);
+        ClosestPoints closest;
+        if (!closestPoints(point, hull, radius, closest) || closest.distance >= radius)
+            return false;
+        normal = -closest.normal;
+        depth = radius - closest.distance;
+        return true;
+    }
+    case ShapeType::Heightfield:
+    case ShapeType::TriangleMesh: {
+        // Out along the nearest triangle within reach.
+        static constexpr Shape kPoint = Shape::sphere(0.0f);
+        const ConvexCore point(kPoint, {p, {}});
+        float nearest = radius;
+        forEachTriangle(shape, transform, Aabb::fromCenterExtents(p, Vec3{radius}), [&](uint32_t, const Vec3* v) {
+            ClosestPoints closest;
+            if (closestPoints(point, ConvexCore(v), nearest, closest) && closest.distance < nearest) {
+                nearest = closest.distance;
+                normal = -closest.normal;
+            }
+        });
+        depth = radius - nearest;
+        return nearest < radius;
+    }
+    }
+    return false;
+}
+
+} // namespace
+
+SoftBodyWorld::SoftBodyWorld(const SoftBodyWorldDesc& desc)
+    : gravity_(desc.gravity)
+    , substeps_(std::max(desc.substeps, 1u))
+    , level_(std::min(desc.simdLevel, detectSimdLevel()))
+    , distanceKernel_(level_ >= SimdLevel::Avx2 ? detail::solveDistancesAvx2 : detail::solveDistancesSse)
+{
+}
+
+SoftBodyId SoftBodyWorld::createBody(const SoftBodyDesc& desc)
+{
+    const uint32_t count = uint32_t(desc.positions.size());
+    REBEL_ASSERT(count > 0, "soft body without particles");
+    REBEL_ASSERT(desc.inverseMasses.empty() || desc.inverseMasses.size() == count, "one inverse mass per particle");
+
+    const SoftBodyId id = ids_.create();
+    if (id.index == bodies_.size())
+        bodies_.emplace_back();
+    Body& body = bodies_[id.index];
+    body = Body{};
+    body.particleCount = count;
+    body.particleRadius = desc.particleRadius;
+    body.friction = desc.friction;
+    body.damping = desc.damping;
+
+    body.particles.resize(count + 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        const float inverseMass = desc.inverseMasses.empty() ? 1.0f : desc.inverseMasses[i];
+        body.particles[i] = {desc.positions[i], inverseMass};
+        if (inverseMass == 0.0f)
+            body.pinned.push_back(i);
+    }
+    body.previous = body.particles;
+    body.velocities.resize(count + 1);
+    body.pinTargets = desc.positions;
+
+    std::vector<uint64_t> used(count, 0);
+    std::vector<uint32_t> colorOf(desc.distances.size());
+    uint32_t counts[kMaxColors] = {};
+    for (std::size_t i = 0; i < desc.distances.size(); ++i) {
+        const DistanceConstraint& c = desc.distances[i];
+        REBEL_ASSERT(c.a < count && c.b < count && c.a != c.b, "bad distance constraint");
+        colorOf[i] = pickColor(used, {c.a, c.b});
+        if (colorOf[i] == kMaxColors) {
+            body.distanceOverflow.push_back(c);
+            body.distanceOverflowRest.push_back(math::length(desc.positions[c.a] - desc.positions[c.b]));
+        } else {
+            ++counts[colorOf[i]];
+        }
+    }
+    const uint32_t distanceColors = layoutColors(counts, body.distanceColorStart);
+    DistanceBatch padding{};
+    std::fill(std::begin(padding.a), std::end(padding.a), count);
+    std::fill(std::begin(padding.b), std::end(padding.b), count);
+    body.distanceBatches.assign(body.distanceColorStart.back(), padding);
+    uint32_t cursor[kMaxColors] = {};
+    for (std::size_t i = 0; i < desc.distances.size(); ++i) {
+        if (colorOf[i] == kMaxColors)
+            continue;
+        const DistanceConstraint& c = desc.distances[i];
+        const uint32_t index = cursor[colorOf[i]]++;
+        DistanceBatch& batch = body.distanceBatches[body.distanceColorStart[colorOf[i]] + index / kXpbdLanes];
+        const uint32_t lane = index % kXpbdLanes;
+        batch.a[lane] = c.a;
+        batch.b[lane] = c.b;
+        batch.restLength[lane] = math::length(desc.positions[c.a] - desc.positions[c.b]);
+        batch.compliance[lane] = c.compliance;
+    }
+
+    std::fill(std::begin(used), std::end(used), 0);
+    std::fill(std::begin(counts), std::end(counts), 0);
+    colorOf.resize(desc.volumes.size());
+    for (std::size_t i = 0; i < desc.volumes.size(); ++i) {
+        const VolumeConstraint& c = desc.volumes[i];
+        REBEL_ASSERT(std::all_of(std::begin(c.particles), std::end(c.particles), [&](uint32_t p) { return p < count; }),
+                     "bad volume constraint");
+        colorOf[i] = pickColor(used, c.particles);
+        const float rest = signedVolume6(desc.positions[c.particles[0]], desc.positions[c.particles[1]],
+                                         desc.positions[c.particles[2]], desc.positions[c.particles[3]]);
+        if (colorOf[i] == kMaxColors) {
+            body.volumeOverflow.push_back(c);
+            body.volumeOverflowRest.push_back(rest);
+        } else {
+            ++counts[colorOf[i]];
+        }
+    }
+    const uint32_t volumeColors = layoutColors(counts, body.volumeColorStart);
+    VolumeBatch volumePadding{};
+    for (auto& lanes : volumePadding.particles)
+        std::fill(std::begin(lanes), std::end(lanes), count);
+    body.volumeBatches.assign(body.volumeColorStart.back(), volumePadding);
+    std::fill(std::begin(cursor), std::end(cursor), 0);
+    for (std::size_t i = 0; i < desc.volumes.size(); ++i) {
+        if (colorOf[i] == kMaxColors)
+            continue;
+        const VolumeConstraint& c = desc.volumes[i];
+        const uint32_t index = cursor[colorOf[i]]++;
+        VolumeBatch& batch = body.volumeBatches[body.volumeColorStart[colorOf[i]] + index / kXpbdLanes];
+        const uint32_t lane = index % kXpbdLanes;
+        for (uint32_t k = 0; k < 4; ++k)
+            batch.particles[k][lane] = c.particles[k];
+        batch.restVolume[lane] = signedVolume6(desc.positions[c.particles[0]], desc.positions[c.particles[1]],
+                                               desc.positions[c.particles[2]], desc.positions[c.particles[3]]);
+        batch.compliance[lane] = c.compliance;
+    }
+
+    body.distanceCount = uint32_t(desc.distances.size());
+    body.volumeCount = uint32_t(desc.volumes.size());
+    body.colors = distanceColors + volumeColors;
+    return id;
+}
+
+void SoftBodyWorld::destroyBody(SoftBodyId id)
+{
+    REBEL_ASSERT(valid(id), "destroying a stale soft body");
+    bodies_[id.index] = Body{};
+    ids_.destroy(id);
+}
+
+std::span<const SoftParticle> SoftBodyWorld::particles(SoftBodyId id) const
+{
+    REBEL_ASSERT(valid(id), "stale soft body");
+    const Body& body = bodies_[id.index];
+    return {body.particles.data(), body.particleCount};
+}
+
+void SoftBodyWorld::setPinned(SoftBodyId id, uint32_t particle, Vec3 position)
+{
+    REBEL_ASSERT(valid(id), "stale soft body");
+    Body& body = bodies_[id.index];
+    REBEL_ASSERT(particle < body.particleCount && body.particles[particle].inverseMass == 0.0f,
+                 "only pinned particles can be placed");
+    body.pinTargets[particle] = position;
+}
+
+void SoftBodyWorld::step(float dt, const PhysicsWorld* rigid, jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(!rigid || rigid->broadphase().type() == BroadphaseType::DynamicTree,
+                 "soft body collision needs a DynamicTree broadphase");
+    jobs.parallelFor(uint32_t(bodies_.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            if (ids_.alive(i))
+                simulate(bodies_[i], dt, rigid);
+        }
+    });
+
+    stats_ = {};
+    for (uint32_t i = 0; i < bodies_.size(); ++i) {
+        if (!ids_.alive(i))
+            continue;
+        const Body& body = bodies_[i];
+        ++stats_.bodies;
+        stats_.particles += body.particleCount;
+        stats_.distanceConstraints += body.distanceCount;
+        stats_.volumeConstraints += body.volumeCount;
+        stats_.colors = std::max(stats_.colors, body.colors);
+        stats_.overflow += uint32_t(body.distanceOverflow.size() + body.volumeOverflow.size());
+        stats_.colliders += uint32_t(body.colliders.size());
+        stats_.collisions += body.collisions;
+    }
+}
+
+void SoftBodyWorld::gatherColliders(Body& body, float dt, const PhysicsWorld& rigid) const
+{
+    // Everything a particle could reach this step, given its velocity.
+    Aabb bounds;
+    for (uint32_t i = 0; i < body.particleCount; ++i) {
+        const Vec3 p = body.particles[i].position;
+        const Vec3 q = p + body.velocities[i].linear * dt;
+        bounds.min = math::min(bounds.min, math::min(p, q));
+        bounds.max = math::max(bounds.max, math::max(p, q));
+    }
+    bounds = bounds.expanded(body.particleRadius + math::length(gravity_) * dt * dt);
+
+    rigid.broadphase().tree().query(bounds, [&](uint32_t proxy) {
+        const physics::Body& rigidBody = *rigid.body(rigid.bodyId(rigid.broadphase().userData(proxy)));
+        body.colliders.push_back({rigidBody.shape, rigidBody.transform, rigidBody.transform.rotate({0.0f, 1.0f, 0.0f}),
+                                  computeAabb(rigidBody.shape, rigidBody.transform).expanded(body.particleRadius)});
+        return true;
+    });
+}
+
+uint32_t SoftBodyWorld::collide(Body& body) const
+{
+    uint32_t collisions = 0;
+    for (const Collider& collider : body.colliders) {
+        for (uint32_t i = 0; i < body.particleCount; ++i) {
+            SoftParticle& particle = body.particles[i];
+            if (particle.inverseMass == 0.0f || !collider.bounds.contains(particle.position))
+                continue;
+            Vec3 normal;
+            float depth;
+            if (!penetration(collider.shape, collider.transform, collider.axis, particle.position, body.particleRadius,
+                             normal, depth))
+                continue;
+            particle.position += normal * depth;
+            // Position-based friction: cancel part of the slip along the
+            // surface since the start of the substep.
+            Vec3 slip = particle.position - body.previous[i].position;
+            slip -= normal * math::dot(slip, normal);
+            particle.position -= slip * body.friction;
+            ++collisions;
+        }
+    }
+    return collisions;
+}
+
+void SoftBodyWorld::simulate(Body& body, float dt, const PhysicsWorld* rigid) const
+{
+    const uint32_t count = body.particleCount;
+    const float h = dt / float(substeps_);
+    const float inverseH = 1.0f / h;
+    const float inverseH2 = inverseH * inverseH;
+    body.colliders.clear();
+    if (rigid)
+        gatherColliders(body, dt, *rigid);
+
+    SoftParticle* particles = body.particles.data();
+    const Float4 gravityStep(gravity_.x * h, gravity_.y * h, gravity_.z * h, 0.0f);
+    const Float4 hStep(h, h, h, 0.0f);
+    body.collisions = 0;
+    for (uint32_t substep = 0; substep < substeps_; ++substep) {
+        // Predict. Velocities keep a zero fourth lane, so inverse masses
+        // pass through untouched.
+        for (uint32_t i = 0; i < count; ++i) {
+            const Float4 p = Float4::loadAligned(&particles[i].position.x);
+            p.storeAligned(&body.previous[i].position.x);
+            const Float4 movable = cmpGt(Float4(_mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3))), Float4::zero());
+            const Float4 v =
+                select(movable, Float4::loadAligned(&body.velocities[i].linear.x) + gravityStep, Float4::zero());
+            v.storeAligned(&body.velocities[i].linear.x);
+            (p + v * hStep).storeAligned(&particles[i].position.x);
+        }
+        // Pinned particles cover an equal share of the remaining way.
+        const float share = 1.0f / float(substeps_ - substep);
+        for (const uint32_t i : body.pinned)
+            particles[i].position += (body.pinTargets[i] - particles[i].position) * share;
+
+        for (uint32_t c = 0; c < kMaxColors; ++c) {
+            const uint32_t begin = body.distanceColorStart[c];
+            distanceKernel_(body.distanceBatches.data() + begin, body.distanceColorStart[c + 1] - begin, particles,
+                            inverseH2);
+        }
+        for (std::size_t i = 0; i < body.distanceOverflow.size(); ++i) {
+            const DistanceConstraint& c = body.distanceOverflow[i];
+            SoftParticle& a = particles[c.a];
+            SoftParticle& b = particles[c.b];
+            const Vec3 d = a.position - b.position;
+            const float length = math::length(d);
+            const float weight = a.inverseMass + b.inverseMass + c.compliance * inverseH2;
+            if (length <= 1e-9f || weight <= 0.0f)
+                continue;
+            const Vec3 step = d * ((length - body.distanceOverflowRest[i]) / (weight * length));
+            a.position -= step * a.inverseMass;
+            b.position += step * b.inverseMass;
+        }
+        for (uint32_t c = 0; c < kMaxColors; ++c) {
+            const uint32_t begin = body.volumeColorStart[c];
+            detail::solveVolumesSse(body.volumeBatches.data() + begin, body.volumeColorStart[c + 1] - begin,
+                                    particles, inverseH2);
+        }
+        for (std::size_t i = 0; i < body.volumeOverflow.size(); ++i) {
+            const VolumeConstraint& c = body.volumeOverflow[i];
+            SoftParticle* p[4] = {&particles[c.particles[0]], &particles[c.particles[1]], &particles[c.particles[2]],
+                                  &particles[c.particles[3]]};
+            const Vec3 e1 = p[1]->position - p[0]->position;
+            const Vec3 e2 = p[2]->position - p[0]->position;
+            const Vec3 e3 = p[3]->position - p[0]->position;
+            Vec3 g[4];
+            g[1] = math::cross(e2, e3);
+            g[2] = math::cross(e3, e1);
+            g[3] = math::cross(e1, e2);
+            g[0] = -(g[1] + g[2] + g[3]);
+            float weight = c.compliance * inverseH2;
+            for (uint32_t k = 0; k < 4; ++k)
+                weight += p[k]->inverseMass * math::lengthSquared(g[k]);
+            if (weight <= 0.0f)
+                continue;
+            const float lambda = -(math::dot(e1, g[1]) - body.volumeOverflowRest[i]) / weight;
+            for (uint32_t k = 0; k < 4; ++k)
+                p[k]->position += g[k] * (lambda * p[k]->inverseMass);
+        }
+
+        if (!body.colliders.empty())
+            body.collisions += collide(body);
+
+        const Float4 inverseStep(inverseH);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Float4 p = Float4::loadAligned(&particles[i].position.x);
+            const Float4 previous = Float4::loadAligned(&body.previous[i].position.x);
+            ((p - previous) * inverseStep).storeAligned(&body.velocities[i].linear.x);
+        }
+    }
+
+    const float keep = std::max(0.0f, 1.0f - body.damping * dt);
+    for (uint32_t i = 0; i < count; ++i)
+        body.velocities[i].linear *= keep;
+}
+
+} // namespace rebel::physics
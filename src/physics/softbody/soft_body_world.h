@@ -0,0 +1,141 @@
+#pragma once
+
+#include "core/cpu_features.h"
+#include "core/math/vec.h"
+#include "core/memory/slot_table.h"
+#include "physics/aabb.h"
+#include "physics/shape.h"
+#include "physics/softbody/soft_body.h"
+#include "physics/softbody/xpbd_kernels.h"
+#include "physics/transform.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+class PhysicsWorld;
+
+struct SoftBodyWorldDesc {
+    math::Vec3 gravity{0.0f, -9.81f, 0.0f};
+    /// XPBD substeps per step, one constraint iteration each. More substeps
+    /// stiffen constraints faster than more iterations would.
+    uint32_t substeps = 4;
+    SimdLevel simdLevel = detectSimdLevel();
+};
+
+struct SoftBodyStats {
+    uint32_t bodies = 0;
+    uint32_t particles = 0;
+    uint32_t distanceConstraints = 0;
+    uint32_t volumeConstraints = 0;
+    uint32_t colors = 0;        // most colours of any body
+    uint32_t overflow = 0;      // constraints that did not fit a colour, solved serially
+    uint32_t colliders = 0;     // rigid bodies near soft bodies, summed over bodies
+    uint32_t collisions = 0;    // particle pushes out of rigid bodies over all substeps
+};
+
+struct SoftBody;
+using SoftBodyId = memory::Handle<SoftBody>;
+
+/// Extended position-based dynamics (XPBD) for cloth, ropes and soft
+/// bodies, with small steps: each step runs `substeps` rounds of predict,
+/// one projection of every constraint, collide and derive velocities.
+///
+/// At creation each body's constraints are greedily graph-coloured so no
+/// two constraints of a colour share a particle, and each colour is packed
+/// into batches of eight stored structure-of-arrays. A batch is solved in
+/// SIMD lanes: particles are stored as one 16-byte position/inverse-mass
+/// register each and transposed into lanes, as the rigid contact solver
+/// does with bodies. Distance constraints run 8-wide with AVX2 or 4-wide
+/// with SSE; volume constraints run 4-wide. Bodies are independent, so a
+/// step runs one job per body, which keeps a cape's particles in L1.
+///
+/// Rigid bodies collide one way: particles are pushed out of every rigid
+/// body the soft body's swept bounds touch (found through the rigid
+/// world's broadphase tree) every substep, with position-based friction,
+/// but never push back.
+class SoftBodyWorld {
+public:
+    static constexpr uint32_t kMaxColors = 64;
+
+    explicit SoftBodyWorld(const SoftBodyWorldDesc& desc = {});
+
+    SimdLevel simdLevel() const { return level_; }
+
+    SoftBodyId createBody(const SoftBodyDesc& desc);
+    void destroyBody(SoftBodyId id);
+    bool valid(SoftBodyId id) const { return ids_.valid(id); }
+
+    /// Current particles, in the order of the desc.
+    std::span<const SoftParticle> particles(SoftBodyId id) const;
+    /// Moves a pinned (zero inverse mass) particle. It travels there in a
+    /// straight line over the next step, so attachments to animated
+    /// characters drag the body smoothly.
+    void setPinned(SoftBodyId id, uint32_t particle, math::Vec3 position);
+
+    /// Advances every body by `dt`, colliding with `rigid` when given. The
+    /// rigid world needs the DynamicTree broadphase and must not be stepped
+    /// at the same time.
+    void step(float dt, const PhysicsWorld* rigid, jobs::JobSystem& jobs);
+
+    const SoftBodyStats& stats() const { return stats_; }
+
+private:
+    struct Collider {
+        Shape shape;
+        Transform transform;
+        math::Vec3 axis; // world capsule axis, rotated once per step
+        Aabb bounds;     // grown by the particle radius
+    };
+
+    struct alignas(16) Velocity {
+        math::Vec3 linear;
+        float unused = 0.0f; // keeps the particle's inverse mass lane unchanged
+    };
+
+    struct Body {
+        // One spare particle past the end takes the padding lanes.
+        std::vector<SoftParticle> particles;
+        std::vector<SoftParticle> previous;
+        std::vector<Velocity> velocities;
+        std::vector<math::Vec3> pinTargets;
+        std::vector<uint32_t> pinned;
+        std::vector<detail::DistanceBatch> distanceBatches;
+        std::vector<detail::VolumeBatch> volumeBatches;
+        std::vector<uint32_t> distanceColorStart; // batch ranges per colour
+        std::vector<uint32_t> volumeColorStart;
+        std::vector<DistanceConstraint> distanceOverflow;
+        std::vector<float> distanceOverflowRest;
+        std::vector<VolumeConstraint> volumeOverflow;
+        std::vector<float> volumeOverflowRest;
+        std::vector<Collider> colliders;
+        uint32_t particleCount = 0;
+        uint32_t distanceCount = 0;
+        uint32_t volumeCount = 0;
+        uint32_t colors = 0;
+        uint32_t collisions = 0;
+        float particleRadius = 0.0f;
+        float friction = 0.0f;
+        float damping = 0.0f;
+    };
+
+    void simulate(Body& body, float dt, const PhysicsWorld* rigid) const;
+    void gatherColliders(Body& body, float dt, const PhysicsWorld& rigid) const;
+    uint32_t collide(Body& body) const;
+
+    math::Vec3 gravity_;
+    uint32_t substeps_;
+    SimdLevel level_;
+    detail::DistanceKernel distanceKernel_;
+    std::vector<Body> bodies_;
+    memory::SlotTable<SoftBody> ids_;
+    SoftBodyStats stats_;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "physics/softbody/soft_body.h"
+
+#include <cstdint>
+
+// Internal interface between SoftBodyWorld and its per-ISA constraint
+// kernels.
+
+namespace rebel::physics::detail {
+
+/// Constraints per batch. The SSE kernels solve a batch as two halves of
+/// four; the AVX2 distance kernel takes all eight at once.
+inline constexpr uint32_t kXpbdLanes = 8;
+
+/// Up to eight distance constraints of one colour, one lane each. Padding
+/// lanes point both ends at the body's spare particle, which has zero
+/// inverse mass, so they move nothing.
+struct alignas(32) DistanceBatch {
+    uint32_t a[kXpbdLanes];
+    uint32_t b[kXpbdLanes];
+    float restLength[kXpbdLanes];
+    float compliance[kXpbdLanes];
+};
+
+struct alignas(32) VolumeBatch {
+    uint32_t particles[4][kXpbdLanes];
+    float restVolume[kXpbdLanes]; // six times the signed volume
+    float compliance[kXpbdLanes];
+};
+
+/// One XPBD projection of batches [0, count) in order. With a single
+/// iteration per substep the Lagrange multipliers start from zero, so
+/// `inverseDtSquared` (1 / substep^2) is all that turns compliance into
+/// the time-step-scaled alpha.
+using DistanceKernel = void (*)(const DistanceBatch* batches, uint32_t count, SoftParticle* particles,
+                                float inverseDtSquared);
+
+void solveDistancesSse(const DistanceBatch* batches, uint32_t count, SoftParticle* particles,
+                       float inverseDtSquared);
+void solveDistancesAvx2(const DistanceBatch* batches, uint32_t count, SoftParticle* particles,
+                        float inverseDtSquared);
+void solveVolumesSse(const VolumeBatch* batches, uint32_t count, SoftParticle* particles, float inverseDtSquared);
+
+} // namespace rebel::physics::detail
@@ -0,0 +1,118 @@
+#include "physics/softbody/xpbd_kernels.h"
+
+#include "core/platform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// AVX2 variant of solveDistancesSse() (see soft_body_world.cpp): the same
+// projection for all eight lanes at once. SoftBodyWorld only selects it
+// after checking detectSimdLevel().
+
+namespace rebel::physics::detail {
+
+namespace {
+
+// Particles index[k] and index[k + 4] share row k; the in-lane 4x4
+// transpose turns rows into x, y, z and inverse mass with lane j holding
+// particle index[j]. The transpose is its own inverse, which scatter uses.
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void transpose(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE __m256 loadRow(const SoftParticle* particles, const uint32_t* index, int k)
+{
+    const __m128 low = _mm_load_ps(&particles[index[k]].position.x);
+    const __m128 high = _mm_load_ps(&particles[index[k + 4]].position.x);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void storeRow(SoftParticle* particles, const uint32_t* index, int k, __m256 row)
+{
+    _mm_store_ps(&particles[index[k]].position.x, _mm256_castps256_ps128(row));
+    _mm_store_ps(&particles[index[k + 4]].position.x, _mm256_extractf128_ps(row, 1));
+}
+
+struct Lanes {
+    __m256 x, y, z, w;
+};
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE Lanes gather(const SoftParticle* particles, const uint32_t* index)
+{
+    Lanes l{loadRow(particles, index, 0), loadRow(particles, index, 1), loadRow(particles, index, 2),
+            loadRow(particles, index, 3)};
+    transpose(l.x, l.y, l.z, l.w);
+    return l;
+}
+
+REBEL_TARGET_AVX2 REBEL_FORCEINLINE void scatter(SoftParticle* particles, const uint32_t* index, Lanes l)
+{
+    transpose(l.x, l.y, l.z, l.w);
+    storeRow(particles, index, 0, l.x);
+    storeRow(particles, index, 1, l.y);
+    storeRow(particles, index, 2, l.z);
+    storeRow(particles, index, 3, l.w);
+}
+
+} // namespace
+
+REBEL_TARGET_AVX2 void solveDistancesAvx2(const DistanceBatch* batches, uint32_t count, SoftParticle* particles,
+                                          float inverseDtSquared)
+{
+    const __m256 alphaScale = _mm256_set1_ps(inverseDtSquared);
+    const __m256 epsilon = _mm256_set1_ps(1e-9f);
+    for (uint32_t i = 0; i < count; ++i) {
+        const DistanceBatch& batch = batches[i];
+        Lanes a = gather(particles, batch.a);
+        Lanes b = gather(particles, batch.b);
+
+        const __m256 dx = _mm256_sub_ps(a.x, b.x);
+        const __m256 dy = _mm256_sub_ps(a.y, b.y);
+        const __m256 dz = _mm256_sub_ps(a.z, b.z);
+        const __m256 length =
+            _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                         _mm256_mul_ps(dz, dz)));
+        const __m256 error = _mm256_sub_ps(length, _mm256_load_ps(batch.restLength));
+        const __m256 alpha = _mm256_mul_ps(_mm256_load_ps(batch.compliance), alphaScale);
+        const __m256 weight = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(a.w, b.w), alpha), epsilon);
+        // lambda / length, zero for coincident particles.
+        const __m256 scale = _mm256_and_ps(_mm256_div_ps(error, _mm256_mul_ps(weight, length)),
+                                           _mm256_cmp_ps(length, epsilon, _CMP_GT_OQ));
+
+        const __m256 sa = _mm256_mul_ps(scale, a.w);
+        const __m256 sb = _mm256_mul_ps(scale, b.w);
+        a.x = _mm256_sub_ps(a.x, _mm256_mul_ps(dx, sa));
+        a.y = _mm256_sub_ps(a.y, _mm256_mul_ps(dy, sa));
+        a.z = _mm256_sub_ps(a.z, _mm256_mul_ps(dz, sa));
+        b.x = _mm256_add_ps(b.x, _mm256_mul_ps(dx, sb));
+        b.y = _mm256_add_ps(b.y, _mm256_mul_ps(dy, sb));
+        b.z = _mm256_add_ps(b.z, _mm256_mul_ps(dz, sb));
+        scatter(particles, batch.a, a);
+        scatter(particles, batch.b, b);
+    }
+}
+
+} // namespace rebel::physics::detail
+
+#else
+
+namespace rebel::physics::detail {
+
+void solveDistancesAvx2(const DistanceBatch* batches, uint32_t count, SoftParticle* particles,
+                        float inverseDtSquared)
+{
+    solveDistancesSse(batches, count, particles, inverseDtSquared);
+}
+
+} // namespace rebel::physics::detail
+
+#endif
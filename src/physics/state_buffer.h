@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/assert.h"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rebel::physics {
+
+/// Appends raw simulation state to a flat byte buffer for world snapshots.
+/// Arrays are stored as a 32-bit count followed by their bytes, so saving is
+/// a handful of memcpys. Only meaningful to the same build in the same
+/// process: pointers (such as Shape::hull) are stored as they are.
+class StateWriter {
+public:
+    explicit StateWriter(std::vector<uint8_t>& out)
+        : out_(out)
+    {
+    }
+
+    template <typename T>
+    void value(const T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void array(std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        value(uint32_t(values.size()));
+        append(values.data(), values.size_bytes());
+    }
+
+    template <typename T>
+    void array(const std::vector<T>& values)
+    {
+        array(std::span<const T>(values));
+    }
+
+    /// Raw bytes, for storage the type system does not see as copyable
+    /// (atomics, while nothing else touches them).
+    void bytes(const void* data, std::size_t size) { append(data, size); }
+
+private:
+    void append(const void* data, std::size_t size)
+    {
+        const std::size_t offset = out_.size();
+        out_.resize(offset + size);
+        if (size > 0)
+            std::memcpy(out_.data() + offset, data, size);
+    }
+
+    std::vector<uint8_t>& out_;
+};
+
+/// Reads back what a StateWriter wrote, in the same order.
+class StateReader {
+public:
+    explicit StateReader(std::span<const uint8_t> in)
+        : in_(in)
+    {
+    }
+
+    template <typename T>
+    void value(T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        take(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void array(std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint32_t count = 0;
+        value(count);
+        values.resize(count);
+        take(values.data(), count * sizeof(T));
+    }
+
+    void bytes(void* data, std::size_t size) { take(data, size); }
+
+    bool finished() const { return offset_ == in_.size(); }
+
+private:
+    void take(void* data, std::size_t size)
+    {
+        REBEL_ASSERT(offset_ + size <= in_.size(), "physics state buffer truncated");
+        if (size > 0)
+            std::memcpy(data, in_.data() + offset_, size);
+        offset_ += size;
+    }
+
+    std::span<const uint8_t> in_;
+    std::size_t offset_ = 0;
+};
+
+} // namespace rebel::physics
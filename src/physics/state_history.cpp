@@ -0,0 +1,355 @@
+#include "physics/state_history.h"
+
+#include "core/assert.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace rebel::physics {
+
+namespace {
+
+// Delta layout: the target size in bytes, then tokens to the end of
+//   varint  words equal to the base words `shift` further on,
+//   varint  literal count << 1 | whether `shift` changes after them,
+//   residuals, per four literals a byte of their sizes less one (two bits
+//           each) and then each residual's low bytes,
+//   varint  the change of `shift`, zigzagged, when flagged.
+// A literal's residual is its XOR with the base word `shift` further on.
+// `shift` starts at zero and never goes negative, so applying a delta in
+// place reads every base word before the target overwrites it. Base words
+// past the end read as zero.
+
+// A moved record is found by hashing kWindowWords of its words. The base is
+// hashed every kWindowWords words, so each lookup tries that many literals
+// in a row, one of which lines up; lookups start every kLookupStride
+// literals. Records that moved towards the front of the buffer are stored
+// as literals.
+constexpr std::size_t kWindowWords = 4;
+constexpr std::size_t kLookupStride = 16;
+
+uint32_t wordAt(std::span<const uint8_t> bytes, std::size_t index)
+{
+    const std::size_t offset = index * 4;
+    uint32_t word = 0;
+    if (offset + 4 <= bytes.size())
+        std::memcpy(&word, bytes.data() + offset, 4);
+    else if (offset < bytes.size())
+        std::memcpy(&word, bytes.data() + offset, bytes.size() - offset);
+    return word;
+}
+
+void putVarint(std::vector<uint8_t>& out, std::size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+std::size_t getVarint(std::span<const uint8_t> in, std::size_t& offset)
+{
+    std::size_t value = 0;
+    for (uint32_t shift = 0;; shift += 7) {
+        REBEL_ASSERT(offset < in.size(), "physics state delta truncated");
+        const uint8_t byte = in[offset++];
+        value |= std::size_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+struct Window {
+    uint32_t words[kWindowWords];
+
+    // One repeated word, such as zero padding, matches anywhere and says
+    // nothing about where a record went.
+    bool uniform() const
+    {
+        return std::all_of(words + 1, words + kWindowWords, [&](uint32_t word) { return word == words[0]; });
+    }
+
+    uint32_t hash(uint32_t bits) const
+    {
+        uint32_t h = 0;
+        for (const uint32_t word : words)
+            h = (h ^ word) * 0x9e3779b1u;
+        return h >> (32 - bits);
+    }
+
+    friend bool operator==(const Window&, const Window&) = default;
+};
+
+Window windowAt(std::span<const uint8_t> bytes, std::size_t index)
+{
+    Window window;
+    if ((index + kWindowWords) * 4 <= bytes.size()) {
+        std::memcpy(window.words, bytes.data() + index * 4, sizeof(window.words));
+    } else {
+        for (std::size_t w = 0; w < kWindowWords; ++w)
+            window.words[w] = wordAt(bytes, index + w);
+    }
+    return window;
+}
+
+class DeltaEncoder {
+public:
+    DeltaEncoder(std::span<const uint8_t> base, std::span<const uint8_t> target, std::vector<uint32_t>& windows)
+        : base_(base)
+        , target_(target)
+        , windows_(windows)
+        , baseWords_((base.size() + 3) / 4)
+        , words_((target.size() + 3) / 4)
+    {
+    }
+
+    void encode(std::vector<uint8_t>& out)
+    {
+        const uint32_t size = uint32_t(target_.size());
+        out.resize(sizeof(size));
+        std::memcpy(out.data(), &size, sizeof(size));
+
+        std::size_t i = 0;
+        while (i < words_) {
+            const std::size_t runStart = i;
+            i = runEnd(i);
+            putVarint(out, i - runStart);
+
+            const std::size_t literalStart = i;
+            std::size_t moved = 0;
+            bool found = false;
+            while (i < words_ && target(i) != predicted(i)) {
+                found = (i - literalStart) % kLookupStride < kWindowWords && find(i, moved);
+                if (found)
+                    break;
+                ++i;
+            }
+            putVarint(out, (i - literalStart) << 1 | std::size_t(found));
+            putResiduals(literalStart, i, out);
+            if (found) {
+                const int64_t delta = int64_t(moved) - int64_t(i) - shift_;
+                putVarint(out, std::size_t(delta < 0 ? ((-delta) << 1) - 1 : delta << 1));
+                shift_ += delta;
+            }
+        }
+    }
+
+private:
+    uint32_t target(std::size_t i) const { return wordAt(target_, i); }
+    std::size_t shifted(std::size_t i) const { return std::size_t(int64_t(i) + shift_); }
+    uint32_t predicted(std::size_t i) const { return wordAt(base_, shifted(i)); }
+
+    std::size_t runEnd(std::size_t i) const
+    {
+        // Eight bytes at a time while both sides have them.
+        std::size_t b = shifted(i);
+        while ((i + 2) * 4 <= target_.size() && (b + 2) * 4 <= base_.size() &&
+               std::memcmp(target_.data() + i * 4, base_.data() + b * 4, 8) == 0) {
+            i += 2;
+            b += 2;
+        }
+        while (i < words_ && target(i) == predicted(i))
+            ++i;
+        return i;
+    }
+
+    // Looks for target word i, and the kWindowWords after it, at or after
+    // base word i; `moved` becomes the base word it was found at.
+    bool find(std::size_t i, std::size_t& moved)
+    {
+        if (i + kWindowWords > words_ || baseWords_ < kWindowWords)
+            return false;
+        const Window window = windowAt(target_, i);
+        if (window.uniform())
+            return false;
+        // Back in line with the base, once a moved stretch ends.
+        if (shift_ != 0 && windowAt(base_, i) == window) {
+            moved = i;
+            return true;
+        }
+        if (windows_.empty())
+            index();
+        const uint32_t candidate = windows_[window.hash(bits_)];
+        if (candidate <= i || windowAt(base_, candidate - 1) != window)
+            return false;
+        moved = candidate - 1;
+        return true;
+    }
+
+    // Built on the first lookup, so deltas without literals skip it.
+    void index()
+    {
+        bits_ = std::max<uint32_t>(std::bit_width(baseWords_ / kWindowWords), 8);
+        windows_.assign(std::size_t(1) << bits_, 0);
+        for (std::size_t b = 0; b + kWindowWords <= baseWords_; b += kWindowWords) {
+            const Window window = windowAt(base_, b);
+            if (!window.uniform())
+                windows_[window.hash(bits_)] = uint32_t(b + 1);
+        }
+    }
+
+    void putResiduals(std::size_t begin, std::size_t end, std::vector<uint8_t>& out) const
+    {
+        // Whole words are written and the end trimmed back to the residuals.
+        std::size_t at = out.size();
+        out.resize(at + (end - begin) * 4 + (end - begin + 3) / 4 + 4);
+        for (std::size_t group = begin; group < end; group += 4) {
+            uint8_t& tag = out[at++];
+            tag = 0;
+            for (std::size_t w = group; w < std::min(group + 4, end); ++w) {
+                const uint32_t residual = target(w) ^ predicted(w);
+                const uint32_t bytes = residual >> 24 ? 4 : residual >> 16 ? 3 : residual >> 8 ? 2 : 1;
+                tag |= uint8_t((bytes - 1) << (2 * (w - group)));
+                std::memcpy(out.data() + at, &residual, 4);
+                at += bytes;
+            }
+        }
+        out.resize(at);
+    }
+
+    std::span<const uint8_t> base_;
+    std::span<const uint8_t> target_;
+    std::vector<uint32_t>& windows_; // base word + 1 by window hash, 0 when empty
+    std::size_t baseWords_;
+    std::size_t words_;
+    uint32_t bits_ = 0;
+    int64_t shift_ = 0;
+};
+
+// Turns `state` from the delta's base into its target in place: runs at
+// their old offset are already right, moved runs are copied down from
+// further on, and literals are patched.
+void applyDelta(std::span<const uint8_t> delta, std::vector<uint8_t>& state)
+{
+    uint32_t size = 0;
+    REBEL_ASSERT(delta.size() >= sizeof(size), "physics state delta truncated");
+    std::memcpy(&size, delta.data(), sizeof(size));
+    // Work in whole words; base words past the end read as zero, which
+    // growing the vector provides. The padding is cut off at the end.
+    const std::size_t words = (std::size_t(size) + 3) / 4;
+    const std::size_t baseWords = (state.size() + 3) / 4;
+    state.resize(std::max(words, baseWords) * 4);
+    uint8_t* const data = state.data();
+    auto source = [&](std::size_t b) {
+        uint32_t word = 0;
+        if (b < baseWords)
+            std::memcpy(&word, data + b * 4, 4);
+        return word;
+    };
+
+    std::size_t offset = sizeof(size);
+    std::size_t i = 0;
+    int64_t shift = 0;
+    while (i < words) {
+        const std::size_t run = getVarint(delta, offset);
+        REBEL_ASSERT(i + run <= words, "physics state delta overruns its target");
+        const std::size_t b = i + std::size_t(shift);
+        if (shift != 0) {
+            const std::size_t copied = b < baseWords ? std::min(run, baseWords - b) : 0;
+            std::memmove(data + i * 4, data + b * 4, copied * 4);
+            std::memset(data + (i + copied) * 4, 0, (run - copied) * 4);
+        }
+        i += run;
+
+        const std::size_t token = getVarint(delta, offset);
+        const std::size_t literals = token >> 1;
+        REBEL_ASSERT(i + literals <= words, "physics state delta overruns its target");
+        for (std::size_t group = 0; group < literals; group += 4) {
+            REBEL_ASSERT(offset < delta.size(), "physics state delta truncated");
+            const uint8_t tag = delta[offset++];
+            for (std::size_t k = 0; k < std::min<std::size_t>(4, literals - group); ++k) {
+                const uint32_t bytes = ((tag >> (2 * k)) & 3u) + 1;
+                REBEL_ASSERT(offset + bytes <= delta.size(), "physics state delta truncated");
+                uint32_t residual = 0;
+                if (offset + 4 <= delta.size()) {
+                    std::memcpy(&residual, delta.data() + offset, 4);
+                    residual &= 0xffffffffu >> (32 - 8 * bytes);
+                } else {
+                    for (uint32_t n = 0; n < bytes; ++n)
+                        residual |= uint32_t(delta[offset + n]) << (8 * n);
+                }
+                offset += bytes;
+                const uint32_t word = source(i + std::size_t(shift)) ^ residual;
+                std::memcpy(data + i * 4, &word, 4);
+                ++i;
+            }
+        }
+        if (token & 1) {
+            const std::size_t zigzag = getVarint(delta, offset);
+            shift += zigzag & 1 ? -int64_t((zigzag + 1) >> 1) : int64_t(zigzag >> 1);
+        }
+    }
+    REBEL_ASSERT(offset == delta.size(), "physics state delta has trailing bytes");
+    state.resize(size);
+}
+
+} // namespace
+
+StateHistory::StateHistory(uint32_t capacity, std::size_t maxBytes)
+    : capacity_(capacity)
+    , maxBytes_(maxBytes)
+    , deltas_(capacity)
+{
+    REBEL_ASSERT(capacity > 0, "state history needs room for one frame");
+}
+
+bool StateHistory::push(uint32_t frame, const PhysicsWorld& world)
+{
+    scratch_.clear();
+    world.saveState(scratch_);
+    if (count_ > 0 && frame == newest_ + 1 && capacity_ > 1) {
+        // The outgoing newest frame becomes a delta against the new one.
+        if (count_ == capacity_)
+            evictOldest();
+        std::vector<uint8_t>& delta = deltas_[slot(newest_)];
+        DeltaEncoder(scratch_, current_, windows_).encode(delta);
+        windows_.clear();
+        deltaBytes_ += delta.size();
+        ++count_;
+    } else {
+        clear();
+        count_ = 1;
+    }
+    current_.swap(scratch_);
+    newest_ = frame;
+    bool withinBudget = true;
+    while (count_ > 1 && memoryUsage() > maxBytes_) {
+        evictOldest();
+        ++budgetEvictions_;
+        withinBudget = false;
+    }
+    return withinBudget;
+}
+
+bool StateHistory::rollback(uint32_t frame, PhysicsWorld& world)
+{
+    if (!contains(frame))
+        return false;
+    for (uint32_t f = newest_; f != frame; --f) {
+        const std::vector<uint8_t>& delta = deltas_[slot(f - 1)];
+        applyDelta(delta, current_);
+        deltaBytes_ -= delta.size();
+    }
+    count_ -= newest_ - frame;
+    newest_ = frame;
+    world.loadState(current_);
+    return true;
+}
+
+void StateHistory::clear()
+{
+    count_ = 0;
+    budgetEvictions_ = 0;
+    deltaBytes_ = 0;
+}
+
+void StateHistory::evictOldest()
+{
+    deltaBytes_ -= deltas_[slot(oldestFrame())].size();
+    --count_;
+}
+
+} // namespace rebel::physics
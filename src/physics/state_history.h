@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::physics {
+
+class PhysicsWorld;
+
+/// Ring of the last N world snapshots for rollback and re-simulation.
+///
+/// Only the newest frame is kept whole. Every older frame is stored as a
+/// delta against the frame after it. Words equal to the newer frame's
+/// collapse into a varint count; a changed word is predicted by the newer
+/// frame's and only the residual (their XOR) is kept, without its leading
+/// zero bytes, so a float that moved a little costs a byte or two. Records
+/// that shifted within the buffer, such as contacts behind a newly inserted
+/// one, are matched at their old offset rather than stored again. Sleeping
+/// and static bodies, the broadphase of a quiet scene and unchanged
+/// contacts all cost a few bytes per frame. Pushing a frame encodes one
+/// delta; rolling back k frames patches k of them into the newest frame.
+///
+/// A scene where everything is moving changes most of its state every
+/// frame, which no lossless delta hides (5k settling bodies take about
+/// 230 KB a frame). maxBytes bounds the memory held: once the whole frame
+/// and deltas exceed it, the oldest frames are dropped until they fit, so
+/// such a scene keeps a shorter history rather than a larger one. That is
+/// never silent: push() returns false when the budget, rather than the
+/// ring, dropped a frame, and budgetEvictions() counts them, so a caller
+/// that needs the full window can size the budget or fall back.
+///
+/// Frames are numbered by the caller and pushed consecutively. Pushing any
+/// other number starts the history over.
+class StateHistory {
+public:
+    explicit StateHistory(uint32_t capacity = 120, std::size_t maxBytes = SIZE_MAX);
+
+    /// Snapshots `world` as `frame`, evicting the oldest frames when the
+    /// ring is full or over maxBytes. False if maxBytes dropped a frame the
+    /// ring had room for, leaving fewer than `capacity` frames held.
+    bool push(uint32_t frame, const PhysicsWorld& world);
+    /// Loads `frame` into `world` and forgets every newer frame, so the
+    /// re-simulated ones can be pushed again. False if `frame` is not held.
+    bool rollback(uint32_t frame, PhysicsWorld& world);
+    void clear();
+
+    bool contains(uint32_t frame) const { return count_ > 0 && frame <= newest_ && newest_ - frame < count_; }
+    uint32_t frameCount() const { return count_; }
+    uint32_t newestFrame() const { return newest_; }
+    uint32_t oldestFrame() const { return newest_ - (count_ - 1); }
+    /// Bytes of state held: the newest frame in full plus every delta.
+    std::size_t memoryUsage() const { return count_ > 0 ? current_.size() + deltaBytes_ : 0; }
+    /// Frames dropped to stay under maxBytes since the history last started
+    /// over. While non-zero, rollback() to a frame up to `capacity` back may
+    /// fail.
+    uint32_t budgetEvictions() const { return budgetEvictions_; }
+
+private:
+    uint32_t slot(uint32_t frame) const { return frame % capacity_; }
+    void evictOldest();
+
+    uint32_t capacity_;
+    std::size_t maxBytes_;
+    uint32_t count_ = 0;
+    uint32_t newest_ = 0;
+    uint32_t budgetEvictions_ = 0;
+    std::size_t deltaBytes_ = 0; // held deltas, for memoryUsage()
+    std::vector<uint8_t> current_;
+    std::vector<uint8_t> scratch_;
+    std::vector<std::vector<uint8_t>> deltas_; // by slot(frame), all but the newest
+    std::vector<uint32_t> windows_;             // encoder scratch: base offsets by hash of their words
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "core/math/quat.h"
+#include "core/math/vec.h"
+
+namespace rebel::physics {
+
+/// Rigid transform: rotation followed by translation.
+struct Transform {
+    math::Vec3 position;
+    math::Quat rotation;
+
+    constexpr math::Vec3 apply(math::Vec3 p) const { return math::rotate(rotation, p) + position; }
+    constexpr math::Vec3 applyInverse(math::Vec3 p) const
+    {
+        return math::rotate(math::conjugate(rotation), p - position);
+    }
+    constexpr math::Vec3 rotate(math::Vec3 v) const { return math::rotate(rotation, v); }
+    constexpr math::Vec3 rotateInverse(math::Vec3 v) const { return math::rotate(math::conjugate(rotation), v); }
+};
+
+} // namespace rebel::physics
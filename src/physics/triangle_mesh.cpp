@@ -0,0 +1,293 @@
+#include "physics/triangle_mesh.h"
+
+#include "core/assert.h"
+#include "core/platform.h"
+#include "physics/collision/shape_cast.h"
+
+#include <cfloat>
+#include <cstring>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+// Leaves only ever reference vertices this far behind the newest one;
+// older vertices are duplicated instead, which keeps every leaf's indices
+// within 16 bits of its base.
+constexpr uint32_t kVertexWindow = 60000;
+
+struct Triangle {
+    uint32_t v[3];
+    Vec3 centroid;
+};
+
+// Orders a leaf's triangles into strips: each strip continues through a
+// remaining triangle sharing its last edge, and restarts (marked by
+// `restart`) when none does.
+void buildStrips(std::span<const Triangle> triangles, uint32_t restart, std::vector<uint32_t>& out)
+{
+    uint32_t used = 0;
+    const uint32_t count = uint32_t(triangles.size());
+    auto findNext = [&](uint32_t a, uint32_t b, uint32_t& third) {
+        for (uint32_t t = 0; t < count; ++t) {
+            if (used & (1u << t))
+                continue;
+            const uint32_t* v = triangles[t].v;
+            for (int k = 0; k < 3; ++k) {
+                if ((v[k] == a && v[(k + 1) % 3] == b) || (v[k] == b && v[(k + 1) % 3] == a)) {
+                    third = v[(k + 2) % 3];
+                    return t;
+                }
+            }
+        }
+        return count;
+    };
+
+    for (uint32_t start = 0; start < count; ++start) {
+        if (used & (1u << start))
+            continue;
+        used |= 1u << start;
+        const uint32_t* v = triangles[start].v;
+        // Start on the rotation whose last edge continues the strip.
+        uint32_t rotation = 0;
+        for (uint32_t k = 0; k < 3; ++k) {
+            uint32_t third;
+            if (findNext(v[(k + 1) % 3], v[(k + 2) % 3], third) != count) {
+                rotation = k;
+                break;
+            }
+        }
+        if (!out.empty())
+            out.push_back(restart);
+        uint32_t a = v[(rotation + 1) % 3], b = v[(rotation + 2) % 3];
+        out.insert(out.end(), {v[rotation], a, b});
+        for (;;) {
+            uint32_t third;
+            const uint32_t next = findNext(a, b, third);
+            if (next == count)
+                break;
+            used |= 1u << next;
+            out.push_back(third);
+            a = b;
+            b = third;
+        }
+    }
+}
+
+} // namespace
+
+std::vector<uint8_t> TriangleMesh::cook(std::span<const Vec3> vertices, std::span<const uint32_t> indices)
+{
+    REBEL_ASSERT(indices.size() % 3 == 0, "three indices per triangle");
+    std::vector<Triangle> triangles;
+    triangles.reserve(indices.size() / 3);
+    Aabb bounds;
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        REBEL_ASSERT(a < vertices.size() && b < vertices.size() && c < vertices.size(), "index out of range");
+        if (a == b || b == c || a == c)
+            continue;
+        triangles.push_back({{a, b, c}, (vertices[a] + vertices[b] + vertices[c]) * (1.0f / 3.0f)});
+        for (const uint32_t v : {a, b, c}) {
+            bounds.min = math::min(bounds.min, vertices[v]);
+            bounds.max = math::max(bounds.max, vertices[v]);
+        }
+    }
+    REBEL_ASSERT(!triangles.empty(), "mesh without triangles");
+
+    Vec3 step;
+    for (int i = 0; i < 3; ++i)
+        step[i] = std::max(bounds.max[i] - bounds.min[i], 1e-6f) / 65535.0f;
+
+    // Depth-first build. Leaves renumber their vertices as they are
+    // emitted, so neighbouring leaves share nearby vertex ranges.
+    std::vector<Node> nodes;
+    std::vector<uint32_t> leafWords;
+    std::vector<Vec3> outVertices;
+    std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+    std::vector<uint32_t> strip;
+
+    auto quantizeBounds = [&](const Aabb& box, Node& node) {
+        for (int i = 0; i < 3; ++i) {
+            const float low = std::floor((box.min[i] - bounds.min[i]) / step[i]);
+            const float high = std::ceil((box.max[i] - bounds.min[i]) / step[i]);
+            node.min[i] = uint16_t(std::clamp(low, 0.0f, 65535.0f));
+            node.max[i] = uint16_t(std::clamp(high, 0.0f, 65535.0f));
+        }
+    };
+
+    auto emitLeaf = [&](std::span<const Triangle> leaf, Node& node) {
+        strip.clear();
+        buildStrips(leaf, UINT32_MAX, strip);
+        uint32_t base = UINT32_MAX;
+        for (uint32_t& v : strip) {
+            if (v == UINT32_MAX)
+                continue;
+            const uint32_t newest = uint32_t(outVertices.size());
+            if (remap[v] == UINT32_MAX || newest - remap[v] > kVertexWindow) {
+                remap[v] = newest;
+                outVertices.push_back(vertices[v]);
+            }
+            v = remap[v];
+            base = std::min(base, v);
+        }
+        node.data = kLeafFlag | uint32_t(leafWords.size());
+        leafWords.push_back(base);
+        leafWords.push_back(uint32_t(leaf.size()) | uint32_t(strip.size()) << 16);
+        const std::size_t first = leafWords.size();
+        leafWords.resize(first + (strip.size() + 1) / 2, 0);
+        uint16_t* packed = reinterpret_cast<uint16_t*>(leafWords.data() + first);
+        for (std::size_t i = 0; i < strip.size(); ++i)
+            packed[i] = strip[i] == UINT32_MAX ? kStripRestart : uint16_t(strip[i] - base);
+    };
+
+    auto build = [&](auto& self, std::span<Triangle> range, uint32_t depth) -> void {
+        REBEL_ASSERT(depth < kMaxDepth, "mesh hierarchy too deep");
+        const uint32_t index = uint32_t(nodes.size());
+        nodes.emplace_back();
+        Aabb box, centroids;
+        for (const Triangle& t : range) {
+            for (const uint32_t v : t.v) {
+                box.min = math::min(box.min, vertices[v]);
+                box.max = math::max(box.max, vertices[v]);
+            }
+            centroids.min = math::min(centroids.min, t.centroid);
+            centroids.max = math::max(centroids.max, t.centroid);
+        }
+        quantizeBounds(box, nodes[index]);
+        if (range.size() <= kMaxLeafTriangles) {
+            emitLeaf(range, nodes[index]);
+            return;
+        }
+        const Vec3 extent = centroids.max - centroids.min;
+        const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const std::size_t half = range.size() / 2;
+        std::nth_element(range.begin(), range.begin() + half, range.end(),
+                         [axis](const Triangle& a, const Triangle& b) { return a.centroid[axis] < b.centroid[axis]; });
+        self(self, range.first(half), depth + 1);
+        nodes[index].data = uint32_t(nodes.size());
+        self(self, range.subspan(half), depth + 1);
+    };
+    build(build, triangles, 0);
+
+    Header header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.vertexCount = uint32_t(outVertices.size());
+    header.triangleCount = uint32_t(triangles.size());
+    header.nodeCount = uint32_t(nodes.size());
+    header.leafWords = uint32_t(leafWords.size());
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = bounds.min[i];
+        header.boundsMax[i] = bounds.max[i];
+    }
+
+    const std::size_t vertexBytes = alignUp(outVertices.size() * 3 * sizeof(float), 16);
+    std::vector<uint8_t> cooked(sizeof(Header) + vertexBytes + nodes.size() * sizeof(Node) +
+                                leafWords.size() * sizeof(uint32_t));
+    uint8_t* out = cooked.data();
+    std::memcpy(out, &header, sizeof(Header));
+    out += sizeof(Header);
+    for (const Vec3& v : outVertices) {
+        const float xyz[3] = {v.x, v.y, v.z};
+        std::memcpy(out, xyz, sizeof(xyz));
+        out += sizeof(xyz);
+    }
+    out = cooked.data() + sizeof(Header) + vertexBytes;
+    std::memcpy(out, nodes.data(), nodes.size() * sizeof(Node));
+    out += nodes.size() * sizeof(Node);
+    std::memcpy(out, leafWords.data(), leafWords.size() * sizeof(uint32_t));
+    return cooked;
+}
+
+TriangleMesh::TriangleMesh(std::span<const uint8_t> cooked)
+    : size_(cooked.size())
+{
+    REBEL_ASSERT(reinterpret_cast<uintptr_t>(cooked.data()) % 16 == 0, "cooked mesh must be 16-byte aligned");
+    REBEL_ASSERT(cooked.size() >= sizeof(Header), "cooked mesh truncated");
+    header_ = reinterpret_cast<const Header*>(cooked.data());
+    REBEL_ASSERT(header_->magic == kMagic && header_->version == kVersion, "not a cooked mesh of this version");
+
+    const std::size_t vertexBytes = alignUp(std::size_t(header_->vertexCount) * 3 * sizeof(float), 16);
+    REBEL_ASSERT(cooked.size() == sizeof(Header) + vertexBytes + header_->nodeCount * sizeof(Node) +
+                                      header_->leafWords * sizeof(uint32_t),
+                 "cooked mesh truncated");
+    vertices_ = reinterpret_cast<const float*>(cooked.data() + sizeof(Header));
+    nodes_ = reinterpret_cast<const Node*>(cooked.data() + sizeof(Header) + vertexBytes);
+    leaves_ = reinterpret_cast<const uint32_t*>(nodes_ + header_->nodeCount);
+
+    bounds_ = {{header_->boundsMin[0], header_->boundsMin[1], header_->boundsMin[2]},
+               {header_->boundsMax[0], header_->boundsMax[1], header_->boundsMax[2]}};
+    for (int i = 0; i < 3; ++i) {
+        step_[i] = std::max(bounds_.max[i] - bounds_.min[i], 1e-6f) / 65535.0f;
+        inverseStep_[i] = 1.0f / step_[i];
+    }
+}
+
+bool TriangleMesh::rayCast(Vec3 origin, Vec3 direction, float maxDistance, CastHit& hit) const
+{
+    const Vec3 inverse{safeInverse(direction.x), safeInverse(direction.y), safeInverse(direction.z)};
+    // Ray in quantized node space, so node bounds are tested without
+    // dequantizing them.
+    const Vec3 start = (origin - bounds_.min) * inverseStep_;
+    const Vec3 scaledInverse = inverse * step_;
+
+    struct Entry {
+        uint32_t node;
+        float enter;
+    };
+    Entry stack[kMaxDepth];
+    uint32_t size = 0;
+    float best = maxDistance;
+    bool found = false;
+
+    auto enterNode = [&](uint32_t index, float& enter) {
+        const Node& node = nodes_[index];
+        const Vec3 t1 = (Vec3{float(node.min[0]), float(node.min[1]), float(node.min[2])} - start) * scaledInverse;
+        const Vec3 t2 = (Vec3{float(node.max[0]), float(node.max[1]), float(node.max[2])} - start) * scaledInverse;
+        const Vec3 near = math::min(t1, t2);
+        const Vec3 far = math::max(t1, t2);
+        enter = std::max({near.x, near.y, near.z, 0.0f});
+        return enter <= std::min({far.x, far.y, far.z, best});
+    };
+
+    float enter;
+    if (!enterNode(0, enter))
+        return false;
+    stack[size++] = {0, enter};
+    while (size > 0) {
+        const Entry entry = stack[--size];
+        if (entry.enter > best)
+            continue;
+        const Node& node = nodes_[entry.node];
+        if (node.data & kLeafFlag) {
+            forEachTriangle(entry.node, [&](uint32_t, const Vec3* v) {
+                CastHit candidate;
+                if (rayTriangle(origin, direction, v, best, candidate)) {
+                    hit = candidate;
+                    best = candidate.distance;
+                    found = true;
+                }
+            });
+            continue;
+        }
+        float enterFirst, enterSecond;
+        const bool first = enterNode(entry.node + 1, enterFirst);
+        const bool second = enterNode(node.data, enterSecond);
+        // Nearer child on top.
+        if (first && second && enterFirst < enterSecond) {
+            stack[size++] = {node.data, enterSecond};
+            stack[size++] = {entry.node + 1, enterFirst};
+        } else {
+            if (first)
+                stack[size++] = {entry.node + 1, enterFirst};
+            if (second)
+                stack[size++] = {node.data, enterSecond};
+        }
+    }
+    return found;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/aabb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::physics {
+
+struct CastHit;
+
+/// Static level geometry: a triangle soup under a bounding volume
+/// hierarchy, stored in one flat cooked buffer that the mesh views in
+/// place. Nothing in the buffer is a pointer or needs fixing up, so a
+/// cooked file can be memory-mapped (see core/mapped_file.h) and used
+/// directly, paging in only the parts that queries touch.
+///
+/// Cooking builds the hierarchy by median splits down to leaves of at most
+/// kMaxLeafTriangles triangles. Node bounds are 16-bit, quantized
+/// conservatively against the mesh bounds, so a node takes 16 bytes.
+/// Leaves store their triangles as strips of 16-bit indices relative to a
+/// per-leaf base vertex, with vertices renumbered in leaf order to keep
+/// those offsets small. A well-connected mesh comes to under 16 bytes per
+/// triangle, vertices included. Triangles are two-sided.
+///
+/// The layout is native-endian; cook on a machine with the same byte order
+/// as the one that loads. Shapes reference meshes by pointer, so a mesh
+/// (and its buffer) must outlive every body using it.
+class TriangleMesh {
+public:
+    static constexpr uint32_t kMaxLeafTriangles = 8;
+
+    /// Cooks an indexed triangle list (three indices per triangle).
+    /// Degenerate triangles are dropped.
+    static std::vector<uint8_t> cook(std::span<const math::Vec3> vertices, std::span<const uint32_t> indices);
+
+    /// Views `cooked`, which must be 16-byte aligned and stay valid for the
+    /// mesh's lifetime.
+    explicit TriangleMesh(std::span<const uint8_t> cooked);
+
+    uint32_t triangleCount() const { return header_->triangleCount; }
+    uint32_t vertexCount() const { return header_->vertexCount; }
+    uint32_t nodeCount() const { return header_->nodeCount; }
+    /// Size of the cooked buffer.
+    std::size_t memoryUsage() const { return size_; }
+    /// Body-space bounds.
+    const Aabb& bounds() const { return bounds_; }
+
+    /// Body-space ray against the triangles; `direction` must be unit
+    /// length. The normal faces back along the ray.
+    bool rayCast(math::Vec3 origin, math::Vec3 direction, float maxDistance, CastHit& hit) const;
+
+    /// Calls fn(id, vertices) for every triangle in a leaf whose bounds
+    /// overlap the body-space `box`, with the three body-space vertices.
+    /// Ids are stable for a cooked mesh.
+    template <typename Fn>
+    void queryTriangles(const Aabb& box, Fn&& fn) const
+    {
+        uint16_t low[3], high[3];
+        if (!quantize(box, low, high))
+            return;
+        uint32_t stack[kMaxDepth];
+        uint32_t size = 0;
+        stack[size++] = 0;
+        while (size > 0) {
+            const uint32_t index = stack[--size];
+            const Node& node = nodes_[index];
+            if (node.min[0] > high[0] || node.max[0] < low[0] || node.min[1] > high[1] || node.max[1] < low[1] ||
+                node.min[2] > high[2] || node.max[2] < low[2])
+                continue;
+            if (node.data & kLeafFlag) {
+                forEachTriangle(index, fn);
+                continue;
+            }
+            stack[size++] = node.data;
+            stack[size++] = index + 1;
+        }
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x4D544252; // "RBTM"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kLeafFlag = 0x80000000u;
+    static constexpr uint16_t kStripRestart = 0xFFFF;
+    static constexpr uint32_t kMaxDepth = 64;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        uint32_t nodeCount;
+        uint32_t leafWords;
+        uint32_t reserved[2];
+        float boundsMin[3];
+        float boundsMax[3];
+        float unused[2];
+    };
+    static_assert(sizeof(Header) == 64);
+
+    /// Internal nodes keep their first child next in the array and the
+    /// second at `data`; leaves set kLeafFlag and the word offset of their
+    /// record in the leaf stream. A record is the base vertex, then the
+    /// triangle count and index count as two 16-bit halves, then the
+    /// indices, strips separated by kStripRestart, padded to a word.
+    struct Node {
+        uint16_t min[3];
+        uint16_t max[3];
+        uint32_t data;
+    };
+    static_assert(sizeof(Node) == 16);
+
+    math::Vec3 vertex(uint32_t i) const { return {vertices_[3 * i], vertices_[3 * i + 1], vertices_[3 * i + 2]}; }
+
+    /// Conservative node-space range of a body-space box; false when it
+    /// misses the mesh.
+    bool quantize(const Aabb& box, uint16_t (&low)[3], uint16_t (&high)[3]) const
+    {
+        if (!overlaps(box, bounds_))
+            return false;
+        for (int i = 0; i < 3; ++i) {
+            const float a = std::floor((box.min[i] - bounds_.min[i]) * inverseStep_[i]);
+            const float b = std::ceil((box.max[i] - bounds_.min[i]) * inverseStep_[i]);
+            low[i] = uint16_t(std::clamp(a, 0.0f, 65535.0f));
+            high[i] = uint16_t(std::clamp(b, 0.0f, 65535.0f));
+        }
+        return true;
+    }
+
+    /// Decodes a leaf's strips. Ids are the node index times
+    /// kMaxLeafTriangles plus the triangle's place in the leaf.
+    template <typename Fn>
+    void forEachTriangle(uint32_t index, Fn&& fn) const
+    {
+        const uint32_t* record = leaves_ + (nodes_[index].data & ~kLeafFlag);
+        const uint32_t base = record[0];
+        const uint32_t indexCount = record[1] >> 16;
+        const uint16_t* strip = reinterpret_cast<const uint16_t*>(record + 2);
+        uint32_t id = index * kMaxLeafTriangles;
+        math::Vec3 v[3];
+        uint32_t run = 0;
+        for (uint32_t i = 0; i < indexCount; ++i) {
+            if (strip[i] == kStripRestart) {
+                run = 0;
+                continue;
+            }
+            v[0] = v[1];
+            v[1] = v[2];
+            v[2] = vertex(base + strip[i]);
+            if (++run >= 3)
+                fn(id++, static_cast<const math::Vec3*>(v));
+        }
+    }
+
+    const Header* header_ = nullptr;
+    const float* vertices_ = nullptr;
+    const Node* nodes_ = nullptr;
+    const uint32_t* leaves_ = nullptr;
+    std::size_t size_ = 0;
+    Aabb bounds_;
+    math::Vec3 step_;        // body-space size of one quantization step
+    math::Vec3 inverseStep_;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "physics/body.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::physics {
+
+/// How a wheel finds the ground.
+enum class WheelCast : uint8_t {
+    /// A ray down the suspension, hitting under the wheel's centre only.
+    /// Cheapest; fine on roads and smooth terrain.
+    Ray,
+    /// A sphere of the wheel's radius swept down the suspension, so kerbs
+    /// and bumps ahead of or beside the centre lift the wheel too.
+    Sphere,
+};
+
+struct WheelDesc {
+    /// Wheel centre with the suspension fully compressed, in chassis space.
+    /// The suspension extends from here along the chassis' -Y.
+    math::Vec3 mount;
+    float radius = 0.35f;
+    /// Suspension travel.
+    float restLength = 0.3f;
+    float stiffness = 35000.0f; // N/m
+    float damping = 4000.0f;    // N s/m
+    float inertia = 1.2f;       // kg m^2, wheel and brake disc
+    /// Front wheel angle at full steering lock, in radians; zero for fixed
+    /// wheels and negative to steer against the input, as rear-steer does.
+    float maxSteer = 0.0f;
+    float brakeTorque = 2500.0f;     // N m at full brake
+    float handbrakeTorque = 0.0f;    // N m
+    /// Gets a share of the differential's output.
+    bool driven = false;
+};
+
+/// Brush-style tire: longitudinal and lateral forces grow linearly with
+/// slip ratio and slip angle, scaled by the wheel's load, and are clipped
+/// together to the friction circle.
+struct TireDesc {
+    float friction = 1.0f;
+    float longitudinalStiffness = 12.0f; // force per unit load and slip ratio
+    float lateralStiffness = 10.0f;      // force per unit load and radian
+};
+
+struct EngineDesc {
+    float maxTorque = 350.0f; // N m
+    float maxTorqueRpm = 4000.0f;
+    float idleRpm = 900.0f;
+    float maxRpm = 6500.0f; // rev limiter
+    float inertia = 0.2f;   // kg m^2, engine and flywheel
+    /// Engine braking with the throttle closed, N m per rad/s.
+    float friction = 0.08f;
+};
+
+/// Automatic gearbox behind a friction clutch.
+struct GearboxDesc {
+    /// Forward ratios, first gear first.
+    std::vector<float> gears{3.6f, 2.2f, 1.5f, 1.1f, 0.85f};
+    float reverse = 3.4f;
+    float finalDrive = 3.9f;
+    float shiftUpRpm = 5500.0f;
+    float shiftDownRpm = 2000.0f;
+    /// Seconds with the clutch open during a shift.
+    float shiftTime = 0.25f;
+    /// Torque the clutch transmits before it slips.
+    float clutchTorque = 450.0f;
+    /// The clutch closes as the engine revs from idle to idle plus this,
+    /// so a car pulls away smoothly and idles at a standstill.
+    float clutchEngageRpm = 1000.0f;
+};
+
+/// Splits the gearbox output between the driven wheels. Open by default:
+/// equal torque to each, so one wheel in the air spins while the others
+/// stall. `limitedSlip` adds a torque pulling each driven wheel towards
+/// their mean speed.
+struct DifferentialDesc {
+    float limitedSlip = 0.0f; // N m per rad/s
+};
+
+/// A vehicle drives an existing dynamic chassis body, which sets its mass,
+/// inertia and collision shape; the wheels have no bodies of their own.
+struct VehicleDesc {
+    BodyId chassis;
+    std::vector<WheelDesc> wheels;
+    TireDesc tire;
+    EngineDesc engine;
+    GearboxDesc gearbox;
+    DifferentialDesc differential;
+    WheelCast cast = WheelCast::Ray;
+    /// Where tire forces act, from 0 at the contact point to 1 level with
+    /// the chassis centre. A chassis body's mass is centred on its shape,
+    /// higher than in most real cars, and forces at the ground would roll
+    /// it over in hard turns; lifting them trades body roll for stability.
+    float tireForceLift = 0.5f;
+};
+
+/// A four-wheeled car: front wheels steer, rear wheels driven. Mounts sit
+/// `mountHeight` above the chassis centre (negative for below), at
+/// +-halfTrack across X and +-halfWheelbase along Z, the front at +Z.
+VehicleDesc makeCar(BodyId chassis, float halfTrack, float halfWheelbase, float mountHeight);
+
+} // namespace rebel::physics
@@ -0,0 +1,410 @@
+#include "physics/vehicle/vehicle_world.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kVehiclesPerJob = 32;
+// Below this speed slip is measured against it instead, so a car at rest
+// does not see infinite slip ratios and angles.
+constexpr float kMinSlipSpeed = 1.0f;
+// Reverse and first gear are swapped below this forward speed, m/s.
+constexpr float kReverseSpeed = 1.0f;
+constexpr float kRpmPerRadian = 60.0f / (2.0f * math::kPi);
+
+// Rises from 60% at idle to the peak and falls to 70% at the limiter.
+float engineTorque(const EngineDesc& engine, float rpm)
+{
+    if (rpm >= engine.maxRpm)
+        return 0.0f;
+    const float falloff = rpm < engine.maxTorqueRpm
+                              ? 0.4f * (engine.maxTorqueRpm - rpm) / std::max(engine.maxTorqueRpm - engine.idleRpm, 1.0f)
+                              : 0.3f * (rpm - engine.maxTorqueRpm) / std::max(engine.maxRpm - engine.maxTorqueRpm, 1.0f);
+    return engine.maxTorque * (1.0f - std::min(falloff, 1.0f));
+}
+
+float gearRatio(const GearboxDesc& gearbox, int32_t gear)
+{
+    if (gear > 0)
+        return gearbox.gears[uint32_t(gear - 1)] * gearbox.finalDrive;
+    return gear < 0 ? -gearbox.reverse * gearbox.finalDrive : 0.0f;
+}
+
+// Friction torque that slows `speed` towards zero without reversing it.
+float brake(float speed, float torque, float inertia, float h)
+{
+    const float change = torque * h / inertia;
+    return std::fabs(speed) <= change ? 0.0f : speed - std::copysign(change, speed);
+}
+
+Vec3 pointVelocity(const Body& body, Vec3 point)
+{
+    return body.linearVelocity + math::cross(body.angularVelocity, point - body.transform.position);
+}
+
+// Inverse of the chassis mass felt by an impulse along `direction` at
+// `point`, rotation included.
+float inverseMassAt(const Body& body, Vec3 point, Vec3 direction)
+{
+    const Vec3 arm = body.transform.rotateInverse(math::cross(point - body.transform.position, direction));
+    return body.inverseMass + math::dot(arm * body.inverseInertia, arm);
+}
+
+// One wheel's ground contact, fixed for the step.
+struct Tire {
+    Vec3 forward; // rolling direction, in the contact plane
+    Vec3 side;
+    float vx = 0.0f; // contact velocity relative to the ground, sub-stepped
+    float vy = 0.0f;
+    float load = 0.0f;
+    // Chassis mass the tire moves along each direction, its share of the
+    // effective mass at the contact point.
+    float massX = 0.0f;
+    float massY = 0.0f;
+};
+
+} // namespace
+
+VehicleDesc makeCar(BodyId chassis, float halfTrack, float halfWheelbase, float mountHeight)
+{
+    VehicleDesc desc;
+    desc.chassis = chassis;
+    for (const float z : {halfWheelbase, -halfWheelbase}) {
+        for (const float x : {-halfTrack, halfTrack}) {
+            WheelDesc wheel;
+            wheel.mount = {x, mountHeight, z};
+            const bool front = z > 0.0f;
+            wheel.maxSteer = front ? 0.6f : 0.0f;
+            wheel.brakeTorque = front ? 3000.0f : 2000.0f;
+            wheel.handbrakeTorque = front ? 0.0f : 3000.0f;
+            wheel.driven = !front;
+            desc.wheels.push_back(wheel);
+        }
+    }
+    return desc;
+}
+
+VehicleWorld::VehicleWorld(const VehicleWorldDesc& desc)
+    : substeps_(std::max(desc.drivetrainSubsteps, 1u))
+    , query_(desc.query)
+{
+}
+
+VehicleId VehicleWorld::createVehicle(const VehicleDesc& desc)
+{
+    REBEL_ASSERT(!desc.wheels.empty() && desc.wheels.size() <= kMaxWheels, "vehicles take 1 to 8 wheels");
+    REBEL_ASSERT(!desc.gearbox.gears.empty(), "gearbox needs a forward gear");
+    const VehicleId id = ids_.create();
+    if (id.index == slots_.size())
+        slots_.emplace_back();
+    Slot& slot = slots_[id.index];
+    slot = Slot{};
+    slot.desc = desc;
+    slot.wheels.resize(desc.wheels.size());
+    slot.queries.resize(desc.wheels.size());
+    slot.impulses.resize(desc.wheels.size());
+    slot.forcePoints.resize(desc.wheels.size());
+    for (uint32_t i = 0; i < desc.wheels.size(); ++i) {
+        slot.wheels[i].suspensionLength = desc.wheels[i].restLength;
+        slot.drivenWheels += desc.wheels[i].driven;
+    }
+    slot.engineSpeed = desc.engine.idleRpm / kRpmPerRadian;
+    slot.state.engineRpm = desc.engine.idleRpm;
+    return id;
+}
+
+void VehicleWorld::destroyVehicle(VehicleId id)
+{
+    ids_.destroy(id);
+    slots_[id.index] = Slot{};
+}
+
+void VehicleWorld::setControls(VehicleId id, const VehicleControls& controls)
+{
+    REBEL_ASSERT(valid(id), "stale vehicle");
+    slots_[id.index].controls = controls;
+}
+
+const VehicleState& VehicleWorld::state(VehicleId id) const
+{
+    REBEL_ASSERT(valid(id), "stale vehicle");
+    return slots_[id.index].state;
+}
+
+std::span<const WheelState> VehicleWorld::wheels(VehicleId id) const
+{
+    REBEL_ASSERT(valid(id), "stale vehicle");
+    return slots_[id.index].wheels;
+}
+
+void VehicleWorld::update(PhysicsWorld& world, float dt, jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(world.broadphase().type() == BroadphaseType::DynamicTree, "vehicles need a DynamicTree broadphase");
+    stats_ = {};
+    rays_.clear();
+    sweeps_.clear();
+    const Vec3 down{0.0f, -1.0f, 0.0f};
+    for (uint32_t index = 0; index < slots_.size(); ++index) {
+        Slot& slot = slots_[index];
+        slot.active = ids_.alive(index) && world.valid(slot.desc.chassis);
+        if (!slot.active)
+            continue;
+        const Body& chassis = *world.body(slot.desc.chassis);
+        REBEL_ASSERT(chassis.type == BodyType::Dynamic, "vehicle chassis must be dynamic");
+        const Vec3 direction = chassis.transform.rotate(down);
+        for (uint32_t i = 0; i < slot.wheels.size(); ++i) {
+            const WheelDesc& wheel = slot.desc.wheels[i];
+            const Vec3 mount = chassis.transform.apply(wheel.mount);
+            if (slot.desc.cast == WheelCast::Ray) {
+                slot.queries[i] = uint32_t(rays_.size());
+                rays_.push_back({mount, direction, wheel.restLength + wheel.radius, slot.desc.chassis});
+            } else {
+                slot.queries[i] = uint32_t(sweeps_.size());
+                sweeps_.push_back({Shape::sphere(wheel.radius), {mount, chassis.transform.rotation}, direction,
+                                   wheel.restLength, slot.desc.chassis});
+            }
+        }
+        ++stats_.vehicles;
+    }
+
+    // Rays first, then sweeps, in one set of result arrays.
+    const std::size_t casts = rays_.size() + sweeps_.size();
+    hitBodies_.resize(casts);
+    hitDistances_.resize(casts);
+    hitPoints_.resize(casts);
+    hitNormals_.resize(casts);
+    const auto results = [&](std::size_t first, std::size_t count) {
+        return CastResults{std::span(hitBodies_).subspan(first, count), std::span(hitDistances_).subspan(first, count),
+                           std::span(hitPoints_).subspan(first, count), std::span(hitNormals_).subspan(first, count)};
+    };
+    if (!rays_.empty())
+        query_.raycast(world, rays_, QueryMode::Closest, results(0, rays_.size()), jobs);
+    if (!sweeps_.empty())
+        query_.sweep(world, sweeps_, QueryMode::Closest, results(rays_.size(), sweeps_.size()), jobs);
+
+    jobs.parallelFor(uint32_t(slots_.size()), kVehiclesPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            if (slots_[i].active)
+                simulate(slots_[i], world, dt);
+        }
+    });
+
+    // applyImpulse wakes bodies and writes their velocities, so the
+    // impulses go in serially, in slot order.
+    for (const Slot& slot : slots_) {
+        if (!slot.active)
+            continue;
+        for (uint32_t i = 0; i < slot.wheels.size(); ++i) {
+            const WheelState& wheel = slot.wheels[i];
+            if (!wheel.contact)
+                continue;
+            world.applyImpulse(slot.desc.chassis, slot.impulses[i], slot.forcePoints[i]);
+            world.applyImpulse(wheel.ground, -slot.impulses[i], slot.forcePoints[i]); // ignored unless dynamic
+            ++stats_.contacts;
+        }
+        stats_.wheels += uint32_t(slot.wheels.size());
+        stats_.substeps += substeps_;
+    }
+    stats_.rayWheels = uint32_t(rays_.size());
+    stats_.sphereWheels = uint32_t(sweeps_.size());
+}
+
+void VehicleWorld::simulate(Slot& slot, const PhysicsWorld& world, float dt) const
+{
+    const VehicleDesc& desc = slot.desc;
+    const VehicleControls& controls = slot.controls;
+    const Body& chassis = *world.body(desc.chassis);
+    const Transform& transform = chassis.transform;
+    const Vec3 up = transform.rotate({0.0f, 1.0f, 0.0f});
+    const uint32_t wheelCount = uint32_t(slot.wheels.size());
+    slot.state.forwardSpeed = math::dot(chassis.linearVelocity, transform.rotate({0.0f, 0.0f, 1.0f}));
+
+    // Suspension at the world rate, and each tire's contact frame.
+    Tire tires[kMaxWheels];
+    uint32_t contacts = 0;
+    for (uint32_t i = 0; i < wheelCount; ++i) {
+        const WheelDesc& wheelDesc = desc.wheels[i];
+        WheelState& wheel = slot.wheels[i];
+        Tire& tire = tires[i];
+        const bool swept = desc.cast == WheelCast::Sphere;
+        const uint32_t query = slot.queries[i] + (swept ? uint32_t(rays_.size()) : 0u);
+        const Vec3 mount = transform.apply(wheelDesc.mount);
+        wheel.steer = controls.steering * wheelDesc.maxSteer;
+        slot.impulses[i] = {};
+        wheel.ground = hitBodies_[query];
+        wheel.contact = !wheel.ground.isNull();
+        if (!wheel.contact) {
+            wheel.suspensionLength = wheelDesc.restLength;
+            wheel.contactPoint = mount - up * (wheelDesc.restLength + wheelDesc.radius);
+            wheel.contactNormal = up;
+            wheel.load = wheel.slipRatio = wheel.slipAngle = 0.0f;
+            continue;
+        }
+        ++contacts;
+        const float travel = !swept ? hitDistances_[query] - wheelDesc.radius : hitDistances_[query];
+        wheel.suspensionLength = std::clamp(travel, 0.0f, wheelDesc.restLength);
+        wheel.contactPoint = hitPoints_[query];
+        wheel.contactNormal = hitNormals_[query];
+
+        const Body* ground = world.body(wheel.ground);
+        Vec3 relative = pointVelocity(chassis, wheel.contactPoint);
+        if (ground && ground->type != BodyType::Static)
+            relative -= pointVelocity(*ground, wheel.contactPoint);
+        const float compression = wheelDesc.restLength - wheel.suspensionLength;
+        const float force = std::max(wheelDesc.stiffness * compression - wheelDesc.damping * math::dot(relative, up), 0.0f);
+        wheel.load = force * std::max(math::dot(up, wheel.contactNormal), 0.0f);
+        slot.impulses[i] = up * (force * dt);
+
+        // The wheel's heading, turned by the steering about the chassis' up
+        // and laid into the contact plane.
+        const Vec3 heading = transform.rotate({std::sin(wheel.steer), 0.0f, std::cos(wheel.steer)});
+        tire.forward = math::normalize(heading - wheel.contactNormal * math::dot(heading, wheel.contactNormal),
+                                       transform.rotate({0.0f, 0.0f, 1.0f}));
+        tire.side = math::cross(wheel.contactNormal, tire.forward);
+        tire.vx = math::dot(relative, tire.forward);
+        tire.vy = math::dot(relative, tire.side);
+        tire.load = wheel.load;
+        // Along `up`, the lift leaves the suspension force's torque as it is.
+        const Vec3 point = wheel.contactPoint +
+                           up * (math::dot(transform.position - wheel.contactPoint, up) * desc.tireForceLift);
+        slot.forcePoints[i] = point;
+        tire.massX = inverseMassAt(chassis, point, tire.forward);
+        tire.massY = inverseMassAt(chassis, point, tire.side);
+    }
+    for (uint32_t i = 0; i < wheelCount; ++i) {
+        if (slot.wheels[i].contact) {
+            tires[i].massX = 1.0f / (tires[i].massX * float(contacts));
+            tires[i].massY = 1.0f / (tires[i].massY * float(contacts));
+        }
+    }
+
+    // Reverse and first gear are only swapped near a standstill.
+    if (controls.reverse && slot.state.gear > 0 && slot.state.forwardSpeed < kReverseSpeed)
+        slot.state.gear = slot.nextGear = -1;
+    else if (!controls.reverse && slot.state.gear < 0 && slot.state.forwardSpeed > -kReverseSpeed)
+        slot.state.gear = slot.nextGear = 1;
+
+    const EngineDesc& engine = desc.engine;
+    const GearboxDesc& gearbox = desc.gearbox;
+    const TireDesc& tireDesc = desc.tire;
+    const float h = dt / float(substeps_);
+    const float idleSpeed = engine.idleRpm / kRpmPerRadian;
+    float inverseWheelInertia = 0.0f, drivenRadius = 0.0f; // means over the driven wheels
+    for (uint32_t i = 0; i < wheelCount; ++i) {
+        inverseWheelInertia += desc.wheels[i].driven ? 1.0f / desc.wheels[i].inertia : 0.0f;
+        drivenRadius += desc.wheels[i].driven ? desc.wheels[i].radius : 0.0f;
+    }
+    inverseWheelInertia /= float(std::max(slot.drivenWheels, 1u));
+    drivenRadius /= float(std::max(slot.drivenWheels, 1u));
+    const float brakeInput = std::clamp(controls.brake, 0.0f, 1.0f);
+    const float throttle = std::clamp(controls.throttle, 0.0f, 1.0f);
+    Vec3 tireImpulses[kMaxWheels] = {};
+
+    for (uint32_t step = 0; step < substeps_; ++step) {
+        if (slot.shiftTimer > 0.0f) {
+            slot.shiftTimer -= h;
+            if (slot.shiftTimer <= 0.0f)
+                slot.state.gear = slot.nextGear;
+        }
+        const float ratio = gearRatio(gearbox, slot.state.gear);
+        float meanWheelSpeed = 0.0f;
+        for (uint32_t i = 0; i < wheelCount; ++i)
+            meanWheelSpeed += desc.wheels[i].driven ? slot.wheels[i].angularVelocity : 0.0f;
+        meanWheelSpeed /= float(std::max(slot.drivenWheels, 1u));
+
+        // Friction clutch: the torque that would lock engine and driveshaft
+        // together this sub-step, up to what the clutch holds as it closes.
+        float clutch = 0.0f;
+        if (ratio != 0.0f && slot.drivenWheels > 0) {
+            const float slip = slot.engineSpeed - meanWheelSpeed * ratio;
+            const float inverseInertia =
+                1.0f / engine.inertia + ratio * ratio * inverseWheelInertia / float(slot.drivenWheels);
+            const float engaged =
+                std::clamp((slot.engineSpeed - idleSpeed) * kRpmPerRadian / gearbox.clutchEngageRpm, 0.0f, 1.0f);
+            const float capacity = gearbox.clutchTorque * engaged;
+            clutch = std::clamp(slip / (h * inverseInertia), -capacity, capacity);
+        }
+        // Torque is cut while shifting, as automatic gearboxes do, so the
+        // engine does not flare with the clutch open.
+        const float rpm = slot.engineSpeed * kRpmPerRadian;
+        const float pedal = slot.shiftTimer > 0.0f ? 0.0f : throttle;
+        const float torque = pedal * engineTorque(engine, rpm) - engine.friction * (slot.engineSpeed - idleSpeed);
+        slot.engineSpeed = std::max(slot.engineSpeed + (torque - clutch) * h / engine.inertia, idleSpeed);
+
+        for (uint32_t i = 0; i < wheelCount; ++i) {
+            const WheelDesc& wheelDesc = desc.wheels[i];
+            WheelState& wheel = slot.wheels[i];
+            float drive = 0.0f;
+            if (wheelDesc.driven) {
+                drive = clutch * ratio / float(slot.drivenWheels) +
+                        desc.differential.limitedSlip * (meanWheelSpeed - wheel.angularVelocity);
+            }
+            float fx = 0.0f, fy = 0.0f;
+            if (wheel.contact) {
+                Tire& tire = tires[i];
+                const float r = wheelDesc.radius;
+                const float reference = std::max(std::fabs(tire.vx), kMinSlipSpeed);
+                const float slipSpeed = wheel.angularVelocity * r - tire.vx;
+                wheel.slipRatio = slipSpeed / reference;
+                wheel.slipAngle = std::atan2(tire.vy, reference);
+                fx = tire.load * tireDesc.longitudinalStiffness * wheel.slipRatio;
+                fy = -tire.load * tireDesc.lateralStiffness * wheel.slipAngle;
+                // No more than cancels the slip within the sub-step, which
+                // keeps stiff tires stable at any speed.
+                const float lockX = std::fabs(slipSpeed) / (h * (r * r / wheelDesc.inertia + 1.0f / tire.massX));
+                const float lockY = std::fabs(tire.vy) * tire.massY / h;
+                fx = std::clamp(fx, -lockX, lockX);
+                fy = std::clamp(fy, -lockY, lockY);
+                const float limit = tireDesc.friction * tire.load;
+                const float magnitude = std::sqrt(fx * fx + fy * fy);
+                if (magnitude > limit) {
+                    fx *= limit / magnitude;
+                    fy *= limit / magnitude;
+                }
+                tire.vx += fx * h / tire.massX;
+                tire.vy += fy * h / tire.massY;
+                tireImpulses[i] += (tire.forward * fx + tire.side * fy) * h;
+            }
+            const float spin = wheel.angularVelocity + (drive - fx * wheelDesc.radius) * h / wheelDesc.inertia;
+            const float braking =
+                brakeInput * wheelDesc.brakeTorque + (controls.handbrake ? wheelDesc.handbrakeTorque : 0.0f);
+            wheel.angularVelocity = brake(spin, braking, wheelDesc.inertia, h);
+            wheel.rotation += wheel.angularVelocity * h;
+        }
+
+        // Automatic shifts on road speed, not wheel speed, so wheelspin
+        // does not run up through the gears.
+        if (slot.shiftTimer <= 0.0f && slot.state.gear > 0 && slot.drivenWheels > 0) {
+            const float shaftRpm = slot.state.forwardSpeed / drivenRadius * ratio * kRpmPerRadian;
+            const int32_t top = int32_t(gearbox.gears.size());
+            int32_t next = slot.state.gear;
+            if (shaftRpm > gearbox.shiftUpRpm && next < top)
+                ++next;
+            else if (shaftRpm < gearbox.shiftDownRpm && next > 1)
+                --next;
+            if (next != slot.state.gear) {
+                slot.nextGear = next;
+                slot.state.gear = 0;
+                slot.shiftTimer = gearbox.shiftTime;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < wheelCount; ++i) {
+        slot.impulses[i] += tireImpulses[i];
+        WheelState& wheel = slot.wheels[i];
+        wheel.rotation -= 2.0f * math::kPi * std::floor(wheel.rotation / (2.0f * math::kPi));
+    }
+    slot.state.engineRpm = slot.engineSpeed * kRpmPerRadian;
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "core/memory/slot_table.h"
+#include "physics/body.h"
+#include "physics/query/scene_query.h"
+#include "physics/vehicle/vehicle.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+class PhysicsWorld;
+
+struct VehicleWorldDesc {
+    /// Drivetrain and tire sub-steps per update. The clutch, the wheels'
+    /// spin and the tires' grip are stiff against the masses they move, so
+    /// they run at this many times the world rate while the chassis and
+    /// suspension run at the world rate.
+    uint32_t drivetrainSubsteps = 8;
+    SceneQueryDesc query{};
+};
+
+/// Driver input, held until changed.
+struct VehicleControls {
+    float throttle = 0.0f; // [0, 1]
+    float brake = 0.0f;    // [0, 1]
+    float steering = 0.0f; // [-1, 1], positive towards the chassis' +X
+    bool handbrake = false;
+    /// Selects reverse once nearly stopped; clearing it selects first gear
+    /// the same way.
+    bool reverse = false;
+};
+
+struct WheelState {
+    /// Where the tire touches the ground, or the bottom of the fully
+    /// extended wheel when airborne.
+    math::Vec3 contactPoint;
+    math::Vec3 contactNormal;
+    BodyId ground;
+    /// Current suspension extension from the mount, in [0, restLength].
+    float suspensionLength = 0.0f;
+    float load = 0.0f; // N, along the contact normal
+    float steer = 0.0f; // radians
+    float angularVelocity = 0.0f; // rad/s, positive rolling forwards
+    float rotation = 0.0f;        // radians, wrapped to [0, 2 pi)
+    float slipRatio = 0.0f;
+    float slipAngle = 0.0f; // radians
+    bool contact = false;
+};
+
+struct VehicleState {
+    float engineRpm = 0.0f;
+    /// -1 reverse, 0 neutral while shifting, then 1 for first gear and up.
+    int32_t gear = 1;
+    /// Along the chassis' +Z, m/s.
+    float forwardSpeed = 0.0f;
+};
+
+struct VehicleStats {
+    uint32_t vehicles = 0;
+    uint32_t wheels = 0;
+    uint32_t rayWheels = 0;    // wheels found by the batched raycast
+    uint32_t sphereWheels = 0; // and by the batched sphere sweep
+    uint32_t contacts = 0;     // wheels on the ground
+    uint32_t substeps = 0;     // drivetrain sub-steps, summed over vehicles
+};
+
+struct Vehicle;
+using VehicleId = memory::Handle<Vehicle>;
+
+/// Raycast vehicles over a PhysicsWorld. Each chassis is an ordinary
+/// dynamic body; update() runs before every world step and adds the
+/// wheels' forces to it as impulses.
+///
+/// An update first finds the ground under every wheel of every vehicle at
+/// once: one batched SceneQuery raycast for the ray wheels and one sphere
+/// sweep for the others, each split into jobs over the broadphase tree and
+/// skipping the wheel's own chassis. Then one job per batch of vehicles
+/// turns those hits into suspension forces (a spring and damper at the
+/// world rate) and runs the drivetrain `drivetrainSubsteps` times: engine
+/// torque curve, automatic gearbox behind a friction clutch, differential,
+/// brakes, and a brush tire at each wheel on the ground. During the
+/// sub-steps each tire moves its own share of the chassis mass, so slip
+/// settles within the step rather than oscillating across steps; the
+/// forces are summed into one impulse per wheel. Impulses, including the
+/// reaction on dynamic ground bodies, are applied serially at the end.
+///
+/// Needs the DynamicTree broadphase. Must not overlap with step().
+class VehicleWorld {
+public:
+    static constexpr uint32_t kMaxWheels = 8;
+
+    explicit VehicleWorld(const VehicleWorldDesc& desc = {});
+
+    VehicleId createVehicle(const VehicleDesc& desc);
+    /// Leaves the chassis body alone.
+    void destroyVehicle(VehicleId id);
+    bool valid(VehicleId id) const { return ids_.valid(id); }
+
+    void setControls(VehicleId id, const VehicleControls& controls);
+    const VehicleState& state(VehicleId id) const;
+    /// In the order of the desc.
+    std::span<const WheelState> wheels(VehicleId id) const;
+
+    /// Advances every vehicle's drivetrain by `dt` and applies the wheels'
+    /// impulses to the chassis, ready for world.step(dt). Vehicles whose
+    /// chassis has been destroyed are skipped.
+    void update(PhysicsWorld& world, float dt, jobs::JobSystem& jobs);
+
+    /// Of the last update.
+    const VehicleStats& stats() const { return stats_; }
+
+private:
+    struct Slot {
+        VehicleDesc desc;
+        VehicleControls controls;
+        VehicleState state;
+        std::vector<WheelState> wheels;
+        std::vector<uint32_t> queries;    // per wheel, into its cast's batch
+        std::vector<math::Vec3> impulses; // per wheel, at its force point
+        std::vector<math::Vec3> forcePoints; // contact points lifted by tireForceLift
+        uint32_t drivenWheels = 0;
+        int32_t nextGear = 1;     // taken once the shift timer runs out
+        float engineSpeed = 0.0f; // rad/s
+        float shiftTimer = 0.0f;
+        bool active = false; // chassis alive this update
+    };
+
+    void simulate(Slot& slot, const PhysicsWorld& world, float dt) const;
+
+    uint32_t substeps_;
+    SceneQuery query_;
+    memory::SlotTable<Vehicle> ids_;
+    std::vector<Slot> slots_;
+    // Per-update query batches and their results.
+    std::vector<Ray> rays_;
+    std::vector<ShapeSweep> sweeps_;
+    std::vector<BodyId> hitBodies_;
+    std::vector<float> hitDistances_;
+    std::vector<math::Vec3> hitPoints_;
+    std::vector<math::Vec3> hitNormals_;
+    VehicleStats stats_;
+};
+
+} // namespace rebel::physics
@@ -0,0 +1,678 @@
+#include "physics/world.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/math/mat.h"
+#include "core/radix_sort.h"
+#include "physics/collision/collide.h"
+#include "physics/collision/time_of_impact.h"
+#include "physics/state_buffer.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace rebel::physics {
+
+using math::Vec3;
+
+namespace {
+
+constexpr uint32_t kBodiesPerJob = 1024;
+constexpr uint32_t kPairsPerJob = 256;
+constexpr uint32_t kContinuousPerJob = 32;
+
+uint32_t contactSlot(uint64_t key, uint32_t mask)
+{
+    return uint32_t(((key ^ (key >> 29)) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+// FNV-1a over 32-bit words.
+class StateHasher {
+public:
+    void add(uint32_t word) { hash_ = (hash_ ^ word) * 0x100000001B3ull; }
+    void add(float value) { add(std::bit_cast<uint32_t>(value)); }
+    void add(Vec3 v)
+    {
+        add(v.x);
+        add(v.y);
+        add(v.z);
+    }
+    uint64_t value() const { return hash_; }
+
+private:
+    uint64_t hash_ = 0xCBF29CE484222325ull;
+};
+
+} // namespace
+
+PhysicsWorld::PhysicsWorld(const PhysicsWorldDesc& desc)
+    : gravity_(desc.gravity)
+    , solverSettings_(desc.solver)
+    , contactMargin_(desc.contactMargin)
+    , contactMatchDistance_(desc.contactMatchDistance)
+    , maxImpactSubsteps_(desc.maxImpactSubsteps)
+    , deterministic_(desc.deterministic)
+    , allowSleeping_(desc.allowSleeping)
+    , sleepLinearVelocity_(desc.sleepLinearVelocity)
+    , sleepAngularVelocity_(desc.sleepAngularVelocity)
+    , timeToSleep_(desc.timeToSleep)
+    , broadphase_(desc.broadphase)
+{
+}
+
+BodyId PhysicsWorld::createBody(const BodyDesc& desc)
+{
+    REBEL_ASSERT(desc.type == BodyType::Static || !isTriangleShape(desc.shape.type),
+                 "heightfields and triangle meshes are static only");
+    const BodyId id = ids_.create();
+    const uint32_t index = id.index;
+    if (index == bodies_.size()) {
+        bodies_.emplace_back();
+        solverIndex_.push_back(0);
+        bounds_.emplace_back();
+    }
+
+    Body& body = bodies_[index];
+    body = Body{};
+    body.transform = {desc.position, desc.rotation};
+    body.shape = desc.shape;
+    body.type = desc.type;
+    body.friction = desc.friction;
+    body.restitution = desc.restitution;
+    body.linearDamping = desc.linearDamping;
+    body.angularDamping = desc.angularDamping;
+    body.allowSleep = desc.allowSleep;
+    body.ccd = desc.ccd && desc.type == BodyType::Dynamic;
+    body.userData = desc.userData;
+    if (desc.type != BodyType::Static) {
+        body.linearVelocity = desc.linearVelocity;
+        body.angularVelocity = desc.angularVelocity;
+    }
+    if (desc.type == BodyType::Dynamic) {
+        REBEL_ASSERT(desc.mass > 0.0f, "dynamic bodies need a positive mass");
+        body.inverseMass = 1.0f / desc.mass;
+        const Vec3 inertia = computeInertia(desc.shape, desc.mass);
+        body.inverseInertia = {1.0f / inertia.x, 1.0f / inertia.y, 1.0f / inertia.z};
+    }
+    bounds_[index] = computeAabb(body.shape, body.transform);
+    body.proxy = broadphase_.createProxy(bounds_[index], index);
+    solverIndex_[index] = 0;
+    return id;
+}
+
+void PhysicsWorld::destroyBody(BodyId id)
+{
+    REBEL_ASSERT(valid(id), "destroying a stale body");
+    if (!valid(id))
+        return;
+    Body& body = bodies_[id.index];
+    if (body.sleeping)
+        wakeIsland(body.island);
+    // Sleeping bodies resting on this one, whichever island it is in, would
+    // otherwise stay asleep in mid-air. Its cached pairs cover every body
+    // it can touch.
+    const uint32_t proxy = body.proxy;
+    broadphase_.pairs().forEach([&](uint64_t key) {
+        if (pairFirst(key) != proxy && pairSecond(key) != proxy)
+            return;
+        const Body& other = bodies_[broadphase_.userData(pairFirst(key) == proxy ? pairSecond(key) : pairFirst(key))];
+        if (other.sleeping)
+            wakeIsland(other.island);
+    });
+    broadphase_.destroyProxy(body.proxy);
+    ids_.destroy(id);
+}
+
+void PhysicsWorld::setLinearVelocity(BodyId id, Vec3 velocity)
+{
+    if (!valid(id) || bodies_[id.index].type == BodyType::Static)
+        return;
+    bodies_[id.index].linearVelocity = velocity;
+    wake(id);
+}
+
+void PhysicsWorld::setAngularVelocity(BodyId id, Vec3 velocity)
+{
+    if (!valid(id) || bodies_[id.index].type == BodyType::Static)
+        return;
+    bodies_[id.index].angularVelocity = velocity;
+    wake(id);
+}
+
+void PhysicsWorld::applyImpulse(BodyId id, Vec3 impulse, Vec3 point)
+{
+    if (!valid(id) || bodies_[id.index].type != BodyType::Dynamic)
+        return;
+    Body& body = bodies_[id.index];
+    body.linearVelocity += impulse * body.inverseMass;
+    // World inverse inertia applied through body space.
+    const Vec3 torque = body.transform.rotateInverse(math::cross(point - body.transform.position, impulse));
+    body.angularVelocity += body.transform.rotate(torque * body.inverseInertia);
+    wake(id);
+}
+
+void PhysicsWorld::wake(BodyId id)
+{
+    if (!valid(id))
+        return;
+    Body& body = bodies_[id.index];
+    if (body.sleeping)
+        wakeIsland(body.island);
+    body.sleepTime = 0.0f;
+}
+
+void PhysicsWorld::wakeIsland(uint32_t island)
+{
+    std::vector<uint32_t>& members = sleepingIslands_[island];
+    for (const uint32_t index : members) {
+        Body& body = bodies_[index];
+        body.sleeping = false;
+        body.sleepTime = 0.0f;
+        body.island = UINT32_MAX;
+        awake_.push_back(index);
+    }
+    members.clear();
+    freeIslands_.push_back(island);
+    --sleepingIslandCount_;
+}
+
+void PhysicsWorld::step(float dt, jobs::JobSystem& jobs)
+{
+    stats_ = {};
+    updateBroadphase(dt, jobs);
+    collide(dt, jobs);
+    integrateVelocities(dt, jobs);
+    solveContacts(dt, jobs);
+    integratePositions(dt, jobs);
+    sweepContinuous(dt, jobs);
+    updateSleep();
+
+    stats_.bodies = ids_.size();
+    stats_.awakeBodies = uint32_t(awake_.size());
+    stats_.sleepingIslands = sleepingIslandCount_;
+    if (deterministic_)
+        stats_.stateHash = stateHash();
+}
+
+uint64_t PhysicsWorld::stateHash() const
+{
+    StateHasher hasher;
+    for (uint32_t i = 0; i < uint32_t(bodies_.size()); ++i) {
+        if (!ids_.alive(i))
+            continue;
+        const Body& body = bodies_[i];
+        hasher.add(i);
+        hasher.add(ids_.handle(i).generation);
+        hasher.add(body.transform.position);
+        hasher.add(body.transform.rotation.x);
+        hasher.add(body.transform.rotation.y);
+        hasher.add(body.transform.rotation.z);
+        hasher.add(body.transform.rotation.w);
+        hasher.add(body.linearVelocity);
+        hasher.add(body.angularVelocity);
+        hasher.add(body.sleepTime);
+        hasher.add(body.sleeping ? body.island : UINT32_MAX);
+    }
+    return hasher.value();
+}
+
+void PhysicsWorld::saveState(std::vector<uint8_t>& out) const
+{
+    StateWriter writer(out);
+    writer.array(bodies_);
+    ids_.saveState(writer);
+    broadphase_.saveState(writer);
+    writer.value(uint32_t(sleepingIslands_.size()));
+    for (const std::vector<uint32_t>& members : sleepingIslands_)
+        writer.array(members);
+    writer.array(freeIslands_);
+    writer.value(sleepingIslandCount_);
+    writer.array(contacts_);
+}
+
+void PhysicsWorld::loadState(std::span<const uint8_t> state)
+{
+    StateReader reader(state);
+    reader.array(bodies_);
+    ids_.loadState(reader);
+    broadphase_.loadState(reader);
+    uint32_t islandCount = 0;
+    reader.value(islandCount);
+    sleepingIslands_.resize(islandCount);
+    for (std::vector<uint32_t>& members : sleepingIslands_)
+        reader.array(members);
+    reader.array(freeIslands_);
+    reader.value(sleepingIslandCount_);
+    reader.array(contacts_);
+    REBEL_ASSERT(reader.finished(), "physics state has trailing bytes");
+
+    // Bounds are a function of shape and transform, so they are rebuilt
+    // rather than stored.
+    const uint32_t slots = uint32_t(bodies_.size());
+    bounds_.resize(slots);
+    solverIndex_.assign(slots, 0);
+    for (uint32_t i = 0; i < slots; ++i) {
+        if (ids_.alive(i))
+            bounds_[i] = computeAabb(bodies_[i].shape, bodies_[i].transform);
+    }
+    awake_.clear();
+}
+
+void PhysicsWorld::updateBroadphase(float dt, jobs::JobSystem& jobs)
+{
+    awake_.clear();
+    continuous_.clear();
+    for (uint32_t i = 0; i < uint32_t(bodies_.size()); ++i) {
+        if (ids_.alive(i) && active(bodies_[i])) {
+            awake_.push_back(i);
+            if (bodies_[i].ccd)
+                continuous_.push_back({i, bodies_[i].transform});
+        }
+    }
+
+    const uint32_t awakeCount = uint32_t(awake_.size());
+    jobs.parallelFor(awakeCount, kBodiesPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const Body& body = bodies_[awake_[i]];
+            bounds_[awake_[i]] = computeAabb(body.shape, body.transform);
+        }
+    });
+    // Cheap while bodies stay inside their fat boxes; tree edits are serial.
+    for (uint32_t i = 0; i < awakeCount; ++i) {
+        const Body& body = bodies_[awake_[i]];
+        const Vec3 displacement = body.linearVelocity * dt;
+        Aabb box = bounds_[awake_[i]];
+        // The whole predicted path, so the pair cache holds every static
+        // body a CCD body could hit this step.
+        if (body.ccd)
+            box = merge(box, {box.min + displacement, box.max + displacement});
+        broadphase_.moveProxy(body.proxy, box, displacement);
+    }
+    broadphase_.updatePairs(jobs);
+}
+
+void PhysicsWorld::collide(float dt, jobs::JobSystem& jobs)
+{
+    const PairCache& cache = broadphase_.pairs();
+    pairKeys_.clear();
+    for (uint32_t i = 0; i < cache.capacity(); ++i) {
+        const uint64_t key = cache.slot(i);
+        if (PairCache::live(key))
+            pairKeys_.push_back(key);
+    }
+    // Slot order depends on how the broadphase's parallel inserts
+    // interleaved; key order depends only on the proxies.
+    if (deterministic_) {
+        sortScratch_.resize(pairKeys_.size());
+        radixSort(pairKeys_, sortScratch_);
+    }
+    pairs_.clear();
+    for (const uint64_t key : pairKeys_)
+        pairs_.push_back(
+            {key, broadphase_.userData(pairFirst(key)), broadphase_.userData(pairSecond(key)), PairState::Skipped});
+
+    // Last step's touching pairs become the lookup for warm starting.
+    std::swap(contacts_, previousContacts_);
+    indexContacts();
+    contacts_.clear();
+    candidates_.clear();
+    pending_.resize(pairs_.size());
+    std::iota(pending_.begin(), pending_.end(), 0u);
+    while (!pending_.empty()) {
+        const std::size_t first = contacts_.size();
+        collidePairs(pending_, dt, jobs);
+        pending_.clear();
+
+        // An awake body touching a sleeping one wakes the sleeper's whole
+        // island; pairs inside that island then need testing too.
+        bool woke = false;
+        for (std::size_t c = first; c < contacts_.size(); ++c) {
+            for (const uint32_t index : {contacts_[c].bodyA, contacts_[c].bodyB}) {
+                if (bodies_[index].sleeping) {
+                    wakeIsland(bodies_[index].island);
+                    woke = true;
+                }
+            }
+        }
+        if (!woke)
+            break;
+        for (uint32_t i = 0; i < uint32_t(pairs_.size()); ++i) {
+            const PairRef& pair = pairs_[i];
+            if (pair.state == PairState::Skipped && (active(bodies_[pair.bodyA]) || active(bodies_[pair.bodyB])))
+                pending_.push_back(i);
+        }
+    }
+
+    for (const Contact& contact : contacts_) {
+        stats_.contactPoints += contact.manifold.pointCount;
+        for (uint32_t p = 0; p < contact.manifold.pointCount; ++p)
+            stats_.warmStartedPoints += contact.manifold.points[p].normalImpulse > 0.0f;
+    }
+    stats_.pairs = uint32_t(pairs_.size());
+    stats_.contacts = uint32_t(contacts_.size());
+}
+
+void PhysicsWorld::collidePairs(std::span<const uint32_t> pairs, float dt, jobs::JobSystem& jobs)
+{
+    // Each job appends its touching pairs to its own list; concatenating
+    // the lists in job order keeps contacts in pair order.
+    const uint32_t count = uint32_t(pairs.size());
+    const uint32_t jobCount = (count + kPairsPerJob - 1) / kPairsPerJob;
+    if (jobContacts_.size() < jobCount) {
+        jobContacts_.resize(jobCount);
+        jobCandidates_.resize(jobCount);
+    }
+
+    jobs.parallelFor(count, kPairsPerJob, [&](uint32_t begin, uint32_t end) {
+        std::vector<Contact>& out = jobContacts_[begin / kPairsPerJob];
+        std::vector<uint64_t>& candidates = jobCandidates_[begin / kPairsPerJob];
+        out.clear();
+        candidates.clear();
+        Contact contact;
+        for (uint32_t i = begin; i < end; ++i) {
+            PairRef& pair = pairs_[pairs[i]];
+            const Body& a = bodies_[pair.bodyA];
+            const Body& b = bodies_[pair.bodyB];
+            if (!(active(a) || active(b)) || (a.type != BodyType::Dynamic && b.type != BodyType::Dynamic)) {
+                pair.state = PairState::Skipped;
+                continue;
+            }
+            float margin = contactMargin_;
+            if (a.ccd || b.ccd) {
+                margin += reach(a, b, dt);
+                if (a.ccd && b.type == BodyType::Static)
+                    candidates.push_back(uint64_t(pair.bodyA) << 32 | pair.bodyB);
+                else if (b.ccd && a.type == BodyType::Static)
+                    candidates.push_back(uint64_t(pair.bodyB) << 32 | pair.bodyA);
+            }
+            // Fat boxes overlap far more often than the shapes come within
+            // the margin; the tight boxes reject most of those pairs.
+            pair.state = PairState::Separate;
+            if (!overlaps(bounds_[pair.bodyA].expanded(margin), bounds_[pair.bodyB]))
+                continue;
+            if (physics::collide(a.shape, a.transform, b.shape, b.transform, margin, contact.manifold)) {
+                pair.state = PairState::Touching;
+                matchManifold(previousManifold(pair), contact.manifold, a.transform, contactMatchDistance_);
+                contact.key = pair.key;
+                contact.bodyA = pair.bodyA;
+                contact.bodyB = pair.bodyB;
+                out.push_back(contact);
+            }
+        }
+    });
+
+    for (uint32_t j = 0; j < jobCount; ++j) {
+        contacts_.insert(contacts_.end(), jobContacts_[j].begin(), jobContacts_[j].end());
+        candidates_.insert(candidates_.end(), jobCandidates_[j].begin(), jobCandidates_[j].end());
+    }
+}
+
+float PhysicsWorld::reach(const Body& a, const Body& b, float dt) const
+{
+    // Static and sleeping bodies have zero velocity; gravity cancels out
+    // between two dynamic bodies.
+    Vec3 relative = a.linearVelocity - b.linearVelocity;
+    if (a.type == BodyType::Dynamic && !a.sleeping)
+        relative += gravity_ * dt;
+    if (b.type == BodyType::Dynamic && !b.sleeping)
+        relative -= gravity_ * dt;
+    float speed = math::length(relative);
+    for (const Body* body : {&a, &b}) {
+        const float spin = math::length(body->angularVelocity);
+        if (spin > 0.0f)
+            speed += spin * boundingRadius(body->shape);
+    }
+    return speed * dt;
+}
+
+void PhysicsWorld::indexContacts()
+{
+    uint32_t capacity = 16;
+    while (capacity < 2 * previousContacts_.size())
+        capacity *= 2;
+    contactIndex_.assign(capacity, UINT32_MAX);
+    for (uint32_t i = 0; i < uint32_t(previousContacts_.size()); ++i) {
+        uint32_t slot = contactSlot(previousContacts_[i].key, capacity - 1);
+        while (contactIndex_[slot] != UINT32_MAX)
+            slot = (slot + 1) & (capacity - 1);
+        contactIndex_[slot] = i;
+    }
+}
+
+const ContactManifold* PhysicsWorld::previousManifold(const PairRef& pair) const
+{
+    const uint32_t mask = uint32_t(contactIndex_.size()) - 1;
+    for (uint32_t slot = contactSlot(pair.key, mask);; slot = (slot + 1) & mask) {
+        const uint32_t index = contactIndex_[slot];
+        if (index == UINT32_MAX)
+            return nullptr;
+        const Contact& contact = previousContacts_[index];
+        if (contact.key == pair.key)
+            return contact.bodyA == pair.bodyA && contact.bodyB == pair.bodyB ? &contact.manifold : nullptr;
+    }
+}
+
+void PhysicsWorld::integrateVelocities(float dt, jobs::JobSystem& jobs)
+{
+    const uint32_t awakeCount = uint32_t(awake_.size());
+    solverBodies_.resize(awakeCount + 1);
+    solverCenters_.resize(awakeCount + 1);
+    solverBodies_[0] = SolverBody{};
+    solverCenters_[0] = {};
+
+    jobs.parallelFor(awakeCount, kBodiesPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t index = awake_[i];
+            const Body& body = bodies_[index];
+            solverIndex_[index] = i + 1;
+            SolverBody& sb = solverBodies_[i + 1];
+            solverCenters_[i + 1] = body.transform.position;
+
+            Vec3 v = body.linearVelocity;
+            Vec3 w = body.angularVelocity;
+            if (body.type == BodyType::Dynamic) {
+                v += gravity_ * dt;
+                v *= 1.0f / (1.0f + dt * body.linearDamping);
+                w *= 1.0f / (1.0f + dt * body.angularDamping);
+            }
+            sb.linear[0] = v.x;
+            sb.linear[1] = v.y;
+            sb.linear[2] = v.z;
+            sb.linear[3] = body.inverseMass;
+            sb.angular[0] = w.x;
+            sb.angular[1] = w.y;
+            sb.angular[2] = w.z;
+            sb.angular[3] = 0.0f;
+
+            // R * diag(invI) * R^T, stored as its six unique entries.
+            const math::Mat3 r = math::Mat3::fromQuat(body.transform.rotation);
+            const Vec3 d = body.inverseInertia;
+            const Vec3 c0 = r.cols[0] * d.x, c1 = r.cols[1] * d.y, c2 = r.cols[2] * d.z;
+            auto entry = [&](int row, int col) {
+                return c0[row] * r.cols[0][col] + c1[row] * r.cols[1][col] + c2[row] * r.cols[2][col];
+            };
+            sb.inverseInertia[0] = entry(0, 0);
+            sb.inverseInertia[1] = entry(1, 1);
+            sb.inverseInertia[2] = entry(2, 2);
+            sb.inverseInertia[3] = entry(0, 1);
+            sb.inverseInertia[4] = entry(0, 2);
+            sb.inverseInertia[5] = entry(1, 2);
+            sb.inverseInertia[6] = 0.0f;
+            sb.inverseInertia[7] = 0.0f;
+        }
+    });
+}
+
+void PhysicsWorld::solveContacts(float dt, jobs::JobSystem& jobs)
+{
+    const uint32_t solverBodyCount = uint32_t(solverBodies_.size());
+    islands_.reset(solverBodyCount);
+    solverContacts_.resize(contacts_.size());
+    for (uint32_t c = 0; c < uint32_t(contacts_.size()); ++c) {
+        Contact& contact = contacts_[c];
+        const Body& a = bodies_[contact.bodyA];
+        const Body& b = bodies_[contact.bodyB];
+        SolverContact& sc = solverContacts_[c];
+        sc.bodyA = a.type == BodyType::Static ? 0 : solverIndex_[contact.bodyA];
+        sc.bodyB = b.type == BodyType::Static ? 0 : solverIndex_[contact.bodyB];
+        sc.friction = std::sqrt(a.friction * b.friction);
+        sc.restitution = std::max(a.restitution, b.restitution);
+        sc.manifold = &contact.manifold;
+        if (a.type == BodyType::Dynamic && b.type == BodyType::Dynamic)
+            islands_.link(sc.bodyA, sc.bodyB);
+    }
+    islands_.build();
+    // Island 0 is the static slot on its own.
+    stats_.islands = islands_.islandCount() - 1;
+
+    solver_.prepare(solverContacts_, solverBodies_, solverCenters_, dt, solverSettings_, jobs);
+    solver_.solve(solverBodies_, jobs);
+    stats_.colors = solver_.stats().colors;
+    stats_.overflowContacts = solver_.stats().overflow;
+}
+
+void PhysicsWorld::integratePositions(float dt, jobs::JobSystem& jobs)
+{
+    const float linearSq = sleepLinearVelocity_ * sleepLinearVelocity_;
+    const float angularSq = sleepAngularVelocity_ * sleepAngularVelocity_;
+    jobs.parallelFor(uint32_t(awake_.size()), kBodiesPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            Body& body = bodies_[awake_[i]];
+            const SolverBody& sb = solverBodies_[i + 1];
+            body.linearVelocity = {sb.linear[0], sb.linear[1], sb.linear[2]};
+            body.angularVelocity = {sb.angular[0], sb.angular[1], sb.angular[2]};
+            body.transform.position += body.linearVelocity * dt;
+            body.transform.rotation = math::integrate(body.transform.rotation, body.angularVelocity, dt);
+
+            const bool resting = math::lengthSquared(body.linearVelocity) < linearSq &&
+                                 math::lengthSquared(body.angularVelocity) < angularSq;
+            body.sleepTime = resting ? body.sleepTime + dt : 0.0f;
+        }
+    });
+}
+
+void PhysicsWorld::sweepContinuous(float dt, jobs::JobSystem& jobs)
+{
+    // Both lists are in body slot order: continuous_ by construction, the
+    // candidates once sorted. Bodies woken during the narrowphase have no
+    // entry and are skipped this step.
+    std::sort(candidates_.begin(), candidates_.end());
+    uint32_t next = 0;
+    for (ContinuousBody& cb : continuous_) {
+        while (next < candidates_.size() && uint32_t(candidates_[next] >> 32) < cb.body)
+            ++next;
+        cb.firstCandidate = next;
+        while (next < candidates_.size() && uint32_t(candidates_[next] >> 32) == cb.body)
+            ++next;
+        cb.candidateCount = next - cb.firstCandidate;
+    }
+
+    const float target = solverSettings_.linearSlop;
+    jobs.parallelFor(uint32_t(continuous_.size()), kContinuousPerJob, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            ContinuousBody& cb = continuous_[i];
+            Body& body = bodies_[cb.body];
+            Sweep sweep{cb.start, body.linearVelocity, body.angularVelocity};
+            float remaining = dt;
+            bool stopped = false;
+            while (cb.candidateCount > 0) {
+                // Earliest impact over the rest of the step; each hit
+                // shortens the window the remaining candidates search.
+                TimeOfImpact first;
+                first.time = remaining;
+                const Body* hit = nullptr;
+                for (uint32_t c = 0; c < cb.candidateCount; ++c) {
+                    const Body& other = bodies_[uint32_t(candidates_[cb.firstCandidate + c])];
+                    TimeOfImpact impact;
+                    if (timeOfImpact(body.shape, sweep, other.shape, Sweep{other.transform}, first.time, target,
+                                     impact)) {
+                        first = impact;
+                        hit = &other;
+                    }
+                }
+                if (!hit)
+                    break;
+
+                sweep.start = sweep.at(first.time);
+                remaining -= first.time;
+                if (cb.impacts++ == maxImpactSubsteps_) {
+                    stopped = true;
+                    break;
+                }
+
+                // Frictionless impulse at the contact point, normal from
+                // the body to the static surface.
+                const Transform& pose = sweep.start;
+                const Vec3 n = first.normal;
+                const Vec3 r = first.point - pose.position;
+                auto applyInertia = [&](Vec3 v) {
+                    return pose.rotate(pose.rotateInverse(v) * body.inverseInertia);
+                };
+                const Vec3 rxn = math::cross(r, n);
+                const float approach = math::dot(sweep.linearVelocity + math::cross(sweep.angularVelocity, r), n);
+                if (approach > 0.0f) {
+                    const float e = approach > solverSettings_.restitutionThreshold
+                                        ? std::max(body.restitution, hit->restitution)
+                                        : 0.0f;
+                    const float k = body.inverseMass + math::dot(rxn, applyInertia(rxn));
+                    const float impulse = (1.0f + e) * approach / k;
+                    sweep.linearVelocity -= n * (impulse * body.inverseMass);
+                    sweep.angularVelocity -= applyInertia(rxn) * impulse;
+                }
+            }
+            if (cb.impacts == 0)
+                continue;
+            body.transform = stopped ? sweep.start : sweep.at(remaining);
+            body.linearVelocity = sweep.linearVelocity;
+            body.angularVelocity = sweep.angularVelocity;
+        }
+    });
+
+    stats_.ccdBodies = uint32_t(continuous_.size());
+    for (const ContinuousBody& cb : continuous_)
+        stats_.impacts += cb.impacts;
+}
+
+void PhysicsWorld::updateSleep()
+{
+    if (!allowSleeping_)
+        return;
+
+    for (uint32_t k = 1; k < islands_.islandCount(); ++k) {
+        const std::span<const uint32_t> members = islands_.island(k);
+        bool canSleep = true;
+        for (const uint32_t s : members) {
+            const Body& body = bodies_[awake_[s - 1]];
+            if (body.type != BodyType::Dynamic || !body.allowSleep || body.sleepTime < timeToSleep_) {
+                canSleep = false;
+                break;
+            }
+        }
+        if (!canSleep)
+            continue;
+
+        uint32_t island;
+        if (!freeIslands_.empty()) {
+            island = freeIslands_.back();
+            freeIslands_.pop_back();
+        } else {
+            island = uint32_t(sleepingIslands_.size());
+            sleepingIslands_.emplace_back();
+        }
+        std::vector<uint32_t>& list = sleepingIslands_[island];
+        for (const uint32_t s : members) {
+            const uint32_t index = awake_[s - 1];
+            Body& body = bodies_[index];
+            body.sleeping = true;
+            body.island = island;
+            body.linearVelocity = {};
+            body.angularVelocity = {};
+            list.push_back(index);
+        }
+        ++sleepingIslandCount_;
+    }
+}
+
+} // namespace rebel::physics
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "core/memory/slot_table.h"
+#include "physics/body.h"
+#include "physics/broadphase/broadphase.h"
+#include "physics/collision/contact.h"
+#include "physics/transform.h"
+#include "physics/dynamics/contact_solver.h"
+#include "physics/dynamics/island_builder.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::physics {
+
+struct PhysicsWorldDesc {
+    math::Vec3 gravity{0.0f, -9.81f, 0.0f};
+    BroadphaseDesc broadphase{};
+    ContactSolverSettings solver{};
+    /// The narrowphase keeps points up to this far apart, so resting
+    /// contacts do not flicker on and off.
+    float contactMargin = 0.02f;
+    /// Points within this distance of last step's point (in body A's frame)
+    /// inherit its impulses when their feature ids differ.
+    float contactMatchDistance = 0.05f;
+    /// Impacts a CCD body may resolve within one step. Once they run out the
+    /// body stays at its last impact for the rest of the step.
+    uint32_t maxImpactSubsteps = 4;
+    /// Bit-identical results across runs and thread counts for lockstep and
+    /// rollback: pairs are processed in pair key order rather than pair
+    /// cache slot order (which depends on how parallel inserts interleave),
+    /// and each step ends by hashing the body state into
+    /// PhysicsStats::stateHash. Costs a radix sort of the pair keys per step.
+    bool deterministic = false;
+    bool allowSleeping = true;
+    float sleepLinearVelocity = 0.05f;
+    float sleepAngularVelocity = 0.05f;
+    /// An island sleeps once every body in it has been slow this long.
+    float timeToSleep = 0.5f;
+};
+
+struct PhysicsStats {
+    uint32_t bodies = 0;
+    uint32_t awakeBodies = 0;
+    uint32_t pairs = 0;
+    uint32_t contacts = 0;
+    uint32_t contactPoints = 0;
+    uint32_t warmStartedPoints = 0; // points that inherited impulses
+    uint32_t islands = 0; // awake islands solved this step
+    uint32_t sleepingIslands = 0;
+    uint32_t colors = 0;
+    uint32_t overflowContacts = 0;
+    uint32_t ccdBodies = 0; // awake CCD bodies swept this step
+    uint32_t impacts = 0;   // time-of-impact sub-steps taken
+    uint64_t stateHash = 0; // deterministic worlds only; see stateHash()
+};
+
+/// Rigid-body world. Bodies live in dense slots addressed by generational
+/// BodyIds. step() runs:
+///   1. broadphase update for awake bodies;
+///   2. narrowphase over the pair cache in parallel batches, waking
+///      sleeping islands that an awake body touches. Manifolds persist by
+///      pair key: each new manifold is matched against the pair's manifold
+///      from the previous step to carry its impulses over. Pairs with a CCD
+///      body widen the margin by how far the bodies can move this step, so
+///      the solver gets speculative contacts ahead of fast bodies;
+///   3. velocity integration;
+///   4. union-find islands over the touching contacts;
+///   5. the graph-coloured SIMD contact solver (see ContactSolver);
+///   6. position integration;
+///   7. CCD bodies are swept against the static bodies they share a pair
+///      with. At each time of impact the body stops, takes a frictionless
+///      impulse against the surface, and continues for the rest of the step,
+///      up to maxImpactSubsteps times. Work here follows the number of CCD
+///      bodies and their pairs only;
+///   8. islands whose bodies have all been at rest for timeToSleep are put
+///      to sleep and drop out of every stage until something touches them.
+///
+/// Apart from the pair cache's slot order, every stage is already
+/// independent of the thread count: parallelFor splits work by a fixed
+/// grain, per-job outputs are concatenated in job order, bodies and islands
+/// are numbered in slot order, jobs within a solver colour touch disjoint
+/// bodies, and there are no floating-point reductions across jobs. The
+/// SSE and AVX2 solver kernels agree bit for bit, and the library is built
+/// without FMA contraction. PhysicsWorldDesc::deterministic removes the
+/// remaining dependency.
+class PhysicsWorld {
+public:
+    explicit PhysicsWorld(const PhysicsWorldDesc& desc = {});
+
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    BodyId createBody(const BodyDesc& desc);
+    void destroyBody(BodyId id);
+    bool valid(BodyId id) const { return ids_.valid(id); }
+    /// Null for stale ids.
+    const Body* body(BodyId id) const { return valid(id) ? &bodies_[id.index] : nullptr; }
+    /// Id of the body in `slot`, the index the broadphase proxies carry.
+    BodyId bodyId(uint32_t slot) const { return ids_.handle(slot); }
+
+    void setLinearVelocity(BodyId id, math::Vec3 velocity);
+    void setAngularVelocity(BodyId id, math::Vec3 velocity);
+    /// Impulse applied at a world-space point. Wakes the body.
+    void applyImpulse(BodyId id, math::Vec3 impulse, math::Vec3 point);
+    /// Wakes the body and every body in its sleeping island.
+    void wake(BodyId id);
+
+    void step(float dt, jobs::JobSystem& jobs);
+
+    /// Touching contacts from the last step.
+    std::span<const Contact> contacts() const { return contacts_; }
+    const Broadphase& broadphase() const { return broadphase_; }
+    const PhysicsStats& stats() const { return stats_; }
+
+    /// 64-bit hash of every live body's slot, generation, transform,
+    /// velocities and sleep state, bit for bit. Two deterministic worlds fed
+    /// the same inputs hash equal after every step; comparing per-step hashes
+    /// finds the first step where two runs diverge.
+    uint64_t stateHash() const;
+
+    /// Appends the complete simulation state to `out`: bodies and free
+    /// slots, the broadphase, sleeping islands and the persistent contacts.
+    /// Fixed-size sections come first and the contacts last, so consecutive
+    /// snapshots line up byte for byte and delta-encode well (see
+    /// StateHistory). Per-step scratch and stats are not included.
+    void saveState(std::vector<uint8_t>& out) const;
+    /// Replaces the simulation state with one saved by this world, or by one
+    /// created from the same desc and fed the same calls. Stepping on from
+    /// it reproduces the original run; in deterministic mode bit for bit.
+    void loadState(std::span<const uint8_t> state);
+
+private:
+    enum class PairState : uint8_t {
+        Skipped,  // no active body involved
+        Separate, // tested, not touching
+        Touching,
+    };
+
+    struct PairRef {
+        uint64_t key;
+        uint32_t bodyA;
+        uint32_t bodyB;
+        PairState state;
+    };
+
+    /// An awake CCD body and its static candidates this step.
+    struct ContinuousBody {
+        uint32_t body;
+        Transform start;
+        uint32_t firstCandidate = 0;
+        uint32_t candidateCount = 0;
+        uint32_t impacts = 0;
+    };
+
+    bool active(const Body& body) const { return body.type != BodyType::Static && !body.sleeping; }
+    void wakeIsland(uint32_t island);
+    void updateBroadphase(float dt, jobs::JobSystem& jobs);
+    void collide(float dt, jobs::JobSystem& jobs);
+    void collidePairs(std::span<const uint32_t> pairs, float dt, jobs::JobSystem& jobs);
+    /// Upper bound on how far any point of one body moves towards the other
+    /// in `dt`.
+    float reach(const Body& a, const Body& b, float dt) const;
+    /// Last step's manifold for the pair, or null. Checks the bodies too, as
+    /// a destroyed body's proxy id may be reused by a new one.
+    const ContactManifold* previousManifold(const PairRef& pair) const;
+    void indexContacts();
+    void integrateVelocities(float dt, jobs::JobSystem& jobs);
+    void solveContacts(float dt, jobs::JobSystem& jobs);
+    void integratePositions(float dt, jobs::JobSystem& jobs);
+    void sweepContinuous(float dt, jobs::JobSystem& jobs);
+    void updateSleep();
+
+    math::Vec3 gravity_;
+    ContactSolverSettings solverSettings_;
+    float contactMargin_;
+    float contactMatchDistance_;
+    uint32_t maxImpactSubsteps_;
+    bool deterministic_;
+    bool allowSleeping_;
+    float sleepLinearVelocity_;
+    float sleepAngularVelocity_;
+    float timeToSleep_;
+
+    memory::SlotTable<Body> ids_;
+    std::vector<Body> bodies_;
+    std::vector<Aabb> bounds_; // tight, refreshed for awake bodies each step
+
+    Broadphase broadphase_;
+
+    // Per-step working state.
+    std::vector<uint32_t> awake_;       // active body slots; solver body i + 1
+    std::vector<uint32_t> solverIndex_; // per slot; 0 for static and sleeping bodies
+    std::vector<uint64_t> pairKeys_;
+    std::vector<uint64_t> sortScratch_;
+    std::vector<PairRef> pairs_;
+    std::vector<uint32_t> pending_;
+    std::vector<std::vector<Contact>> jobContacts_;
+    std::vector<Contact> contacts_;
+    std::vector<Contact> previousContacts_;
+    std::vector<uint32_t> contactIndex_; // open addressing over previousContacts_ by key
+    std::vector<SolverBody> solverBodies_;
+    std::vector<math::Vec3> solverCenters_;
+    std::vector<SolverContact> solverContacts_;
+    std::vector<ContinuousBody> continuous_; // in body slot order
+    std::vector<std::vector<uint64_t>> jobCandidates_;
+    std::vector<uint64_t> candidates_; // CCD body slot << 32 | static body slot
+    IslandBuilder islands_;
+    ContactSolver solver_;
+
+    std::vector<std::vector<uint32_t>> sleepingIslands_;
+    std::vector<uint32_t> freeIslands_;
+    uint32_t sleepingIslandCount_ = 0;
+
+    PhysicsStats stats_;
+};
+
+} // namespace rebel::physics
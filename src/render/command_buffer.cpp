@@ -0,0 +1,81 @@
+#include "render/command_buffer.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/radix_sort.h"
+
+namespace rebel::render {
+
+RenderQueue::RenderQueue(uint32_t threadCount)
+{
+    REBEL_ASSERT(threadCount > 0 && threadCount <= 256, "render queue supports 1..256 threads");
+    buffers_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+        buffers_.push_back(std::make_unique<CommandBuffer>());
+}
+
+CommandBuffer& RenderQueue::threadBuffer()
+{
+    const int worker = jobs::JobSystem::workerIndex();
+    REBEL_ASSERT(worker >= 0 && uint32_t(worker) < buffers_.size(), "recording thread has no command buffer");
+    return *buffers_[std::size_t(worker)];
+}
+
+void RenderQueue::reset()
+{
+    for (auto& buffer : buffers_)
+        buffer->clear();
+    sorted_.clear();
+}
+
+void RenderQueue::sort()
+{
+    std::size_t total = 0;
+    for (const auto& buffer : buffers_)
+        total += buffer->size();
+
+    sorted_.resize(total);
+    scratch_.resize(total);
+    std::size_t cursor = 0;
+    for (uint32_t b = 0; b < buffers_.size(); ++b) {
+        const std::span<const uint64_t> keys = buffers_[b]->keys();
+        REBEL_ASSERT(keys.size() < (std::size_t(1) << kCommandBits), "too many commands in one buffer");
+        for (uint32_t i = 0; i < keys.size(); ++i)
+            sorted_[cursor++] = {keys[i], (b << kCommandBits) | i};
+    }
+
+    radixSort(std::span(sorted_), std::span(scratch_), [](const SortEntry& entry) { return entry.key; });
+}
+
+void RenderQueue::submit(RenderBackend& backend, const RenderFrameParams& params, jobs::JobSystem& jobs)
+{
+    sort();
+
+    stats_ = {};
+    stats_.commands = uint32_t(sorted_.size());
+
+    backend.beginFrame(params);
+    uint32_t currentPass = ~0u;
+    uint32_t currentMaterial = ~0u;
+    for (const SortEntry& entry : sorted_) {
+        const DrawCommand& command =
+            buffers_[entry.value >> kCommandBits]->commands()[entry.value & ((1u << kCommandBits) - 1)];
+
+        const uint32_t pass = uint32_t(entry.key >> 56);
+        if (pass != currentPass) {
+            backend.setPass(sortkey::layer(entry.key), sortkey::pass(entry.key));
+            currentPass = pass;
+            currentMaterial = ~0u; // passes start with no material bound
+            ++stats_.passChanges;
+        }
+        if (command.material != currentMaterial) {
+            backend.setMaterial(command.material);
+            currentMaterial = command.material;
+            ++stats_.materialChanges;
+        }
+        backend.draw(command);
+    }
+    backend.endFrame(jobs);
+}
+
+} // namespace rebel::render
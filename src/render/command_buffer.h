@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/platform.h"
+#include "render/render_backend.h"
+#include "render/sort_key.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rebel::render {
+
+struct SortEntry {
+    uint64_t key;
+    uint32_t value;
+};
+
+/// Append-only list of draws recorded by a single thread. Keys and commands
+/// are kept in separate arrays so sorting only touches the keys.
+class alignas(kCacheLineSize) CommandBuffer {
+public:
+    void draw(uint64_t sortKey, const DrawCommand& command)
+    {
+        keys_.push_back(sortKey);
+        commands_.push_back(command);
+    }
+
+    void clear()
+    {
+        keys_.clear();
+        commands_.clear();
+    }
+
+    uint32_t size() const { return uint32_t(keys_.size()); }
+    std::span<const uint64_t> keys() const { return keys_; }
+    std::span<const DrawCommand> commands() const { return commands_; }
+
+private:
+    std::vector<uint64_t> keys_;
+    std::vector<DrawCommand> commands_;
+};
+
+struct RenderQueueStats {
+    uint32_t commands = 0;
+    uint32_t passChanges = 0;
+    uint32_t materialChanges = 0;
+};
+
+/// Per-frame collection of command buffers, one per job system worker.
+/// Workers record into threadBuffer() without synchronization; submit()
+/// merges every buffer with a single radix sort on the 64-bit keys (see
+/// sort_key.h) and replays the result into a backend, so state changes are
+/// issued only where consecutive keys differ.
+class RenderQueue {
+public:
+    /// `threadCount` is normally JobSystem::workerCount().
+    explicit RenderQueue(uint32_t threadCount);
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    uint32_t bufferCount() const { return uint32_t(buffers_.size()); }
+    CommandBuffer& buffer(uint32_t index) { return *buffers_[index]; }
+    /// Buffer owned by the calling job system worker.
+    CommandBuffer& threadBuffer();
+
+    /// Clears every buffer, keeping their capacity.
+    void reset();
+
+    /// Merges and sorts every recorded command. submit() does this itself;
+    /// it is exposed separately for profiling.
+    void sort();
+    /// Sorted (key, buffer << 24 | command) entries from the last sort().
+    std::span<const SortEntry> sorted() const { return sorted_; }
+
+    /// Sorts, then replays all commands in key order into `backend`.
+    void submit(RenderBackend& backend, const RenderFrameParams& params, jobs::JobSystem& jobs);
+
+    const RenderQueueStats& stats() const { return stats_; }
+
+private:
+    static constexpr uint32_t kCommandBits = 24;
+
+    std::vector<std::unique_ptr<CommandBuffer>> buffers_;
+    std::vector<SortEntry> sorted_;
+    std::vector<SortEntry> scratch_;
+    RenderQueueStats stats_;
+};
+
+} // namespace rebel::render
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/math/vec.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::render {
+
+/// World-space bounding volumes stored structure-of-arrays, so culling
+/// kernels load 8 or 16 objects per instruction. Every object has both an
+/// AABB (center/extents) and a bounding sphere sharing the same center; tests
+/// use whichever is tighter per plane.
+///
+/// Arrays are padded to a multiple of kPadding so kernels never need a
+/// remainder loop; padding lanes are masked out by count.
+class BoundsSoA {
+public:
+    static constexpr uint32_t kPadding = 16;
+
+    uint32_t size() const { return count_; }
+
+    void clear() { resize(0); }
+    void resize(uint32_t count)
+    {
+        count_ = count;
+        const std::size_t padded = (std::size_t(count) + kPadding - 1) / kPadding * kPadding;
+        for (std::vector<float>* array : {&centerX_, &centerY_, &centerZ_, &extentX_, &extentY_, &extentZ_, &radius_})
+            array->resize(padded, 0.0f);
+    }
+
+    /// Sets object `i` from an AABB; the sphere is the AABB's circumsphere.
+    void setAabb(uint32_t i, math::Vec3 center, math::Vec3 extents)
+    {
+        setAabbSphere(i, center, extents, math::length(extents));
+    }
+
+    /// Sets object `i` from a sphere; the AABB is the sphere's bounding cube.
+    void setSphere(uint32_t i, math::Vec3 center, float radius)
+    {
+        setAabbSphere(i, center, {radius, radius, radius}, radius);
+    }
+
+    void setAabbSphere(uint32_t i, math::Vec3 center, math::Vec3 extents, float radius)
+    {
+        centerX_[i] = center.x;
+        centerY_[i] = center.y;
+        centerZ_[i] = center.z;
+        extentX_[i] = extents.x;
+        extentY_[i] = extents.y;
+        extentZ_[i] = extents.z;
+        radius_[i] = radius;
+    }
+
+    const float* centerX() const { return centerX_.data(); }
+    const float* centerY() const { return centerY_.data(); }
+    const float* centerZ() const { return centerZ_.data(); }
+    const float* extentX() const { return extentX_.data(); }
+    const float* extentY() const { return extentY_.data(); }
+    const float* extentZ() const { return extentZ_.data(); }
+    const float* radius() const { return radius_.data(); }
+
+private:
+    uint32_t count_ = 0;
+    std::vector<float> centerX_, centerY_, centerZ_;
+    std::vector<float> extentX_, extentY_, extentZ_;
+    std::vector<float> radius_;
+};
+
+} // namespace rebel::render
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// Internal interface between Culler and its per-ISA kernels.
+
+namespace rebel::render::detail {
+
+struct CullKernelInput {
+    const float* centerX;
+    const float* centerY;
+    const float* centerZ;
+    const float* extentX;
+    const float* extentY;
+    const float* extentZ;
+    const float* radius;
+
+    /// Normalized planes (nx, ny, nz, d); inside when n.p + d >= 0.
+    float planes[6][4];
+    /// Column-major view-projection, only read when occlusion is enabled.
+    float viewProjection[16];
+
+    /// Depth pyramid (see DepthPyramid); null disables occlusion.
+    const float* pyramid;
+    const int32_t* pyramidOffsets;
+    const int32_t* pyramidWidths;
+    int32_t pyramidLevels;
+    float screenWidth;
+    float screenHeight;
+};
+
+struct CullKernelResult {
+    uint32_t visible;
+    uint32_t frustumCulled;
+};
+
+/// Tests objects [begin, end) (begin a multiple of 16) and writes visible
+/// indices to `out` in ascending order.
+using CullKernel = CullKernelResult (*)(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out);
+
+CullKernelResult cullScalar(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out);
+CullKernelResult cullAvx2(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out);
+CullKernelResult cullAvx512(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out);
+
+} // namespace rebel::render::detail
@@ -0,0 +1,342 @@
+#include "render/culling/cull_kernels.h"
+
+#include "core/platform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <bit>
+#include <cmath>
+
+// GCC 12's AVX-512 headers seed results with _mm512_undefined_*(), which
+// trips -Wmaybe-uninitialized once inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+
+// AVX2 and AVX-512 variants of cullScalar() (see culler.cpp for the
+// reference). Built for the baseline ISA with per-function target
+// attributes; Culler only calls them after checking detectSimdLevel().
+
+namespace rebel::render::detail {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// AVX2, 8 objects per iteration
+
+struct Avx2Constants {
+    __m256 plane[6][4];
+    __m256 absPlane[6][3];
+    __m256 m[16];
+};
+
+// Clamps to [0, hi]; NaN maps to 0.
+REBEL_TARGET_AVX2_FMA REBEL_FORCEINLINE __m256 clampScreen(__m256 v, __m256 hi)
+{
+    return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), hi);
+}
+
+REBEL_TARGET_AVX2_FMA inline uint32_t occludedAvx2(const CullKernelInput& in, const Avx2Constants& k, __m256 cx,
+                                               __m256 cy, __m256 cz, __m256 ex, __m256 ey, __m256 ez)
+{
+    __m256 center[4], axisX[4], axisY[4], axisZ[4];
+    for (int r = 0; r < 4; ++r) {
+        center[r] = _mm256_fmadd_ps(k.m[r], cx, _mm256_fmadd_ps(k.m[4 + r], cy, _mm256_fmadd_ps(k.m[8 + r], cz, k.m[12 + r])));
+        axisX[r] = _mm256_mul_ps(k.m[r], ex);
+        axisY[r] = _mm256_mul_ps(k.m[4 + r], ey);
+        axisZ[r] = _mm256_mul_ps(k.m[8 + r], ez);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 minX = _mm256_set1_ps(INFINITY), maxX = _mm256_set1_ps(-INFINITY);
+    __m256 minY = minX, maxY = maxX, minZ = minX;
+    __m256 nearCross = zero;
+    for (int c = 0; c < 8; ++c) {
+        __m256 p[4];
+        for (int r = 0; r < 4; ++r) {
+            p[r] = (c & 1) ? _mm256_add_ps(center[r], axisX[r]) : _mm256_sub_ps(center[r], axisX[r]);
+            p[r] = (c & 2) ? _mm256_add_ps(p[r], axisY[r]) : _mm256_sub_ps(p[r], axisY[r]);
+            p[r] = (c & 4) ? _mm256_add_ps(p[r], axisZ[r]) : _mm256_sub_ps(p[r], axisZ[r]);
+        }
+        nearCross = _mm256_or_ps(nearCross, _mm256_cmp_ps(p[2], zero, _CMP_LT_OQ));
+        // Reciprocal estimate plus one Newton-Raphson step (~23 bits); a
+        // full divide per corner would dominate the kernel.
+        __m256 invW = _mm256_rcp_ps(p[3]);
+        invW = _mm256_mul_ps(invW, _mm256_fnmadd_ps(p[3], invW, _mm256_set1_ps(2.0f)));
+        const __m256 x = _mm256_mul_ps(p[0], invW), y = _mm256_mul_ps(p[1], invW), z = _mm256_mul_ps(p[2], invW);
+        minX = _mm256_min_ps(minX, x);
+        maxX = _mm256_max_ps(maxX, x);
+        minY = _mm256_min_ps(minY, y);
+        maxY = _mm256_max_ps(maxY, y);
+        minZ = _mm256_min_ps(minZ, z);
+    }
+
+    // Lanes crossing the near plane may hold inf/NaN; clamping keeps every
+    // texel index below in range.
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 w = _mm256_set1_ps(in.screenWidth), h = _mm256_set1_ps(in.screenHeight);
+    const __m256 wMax = _mm256_set1_ps(in.screenWidth - 1.0f), hMax = _mm256_set1_ps(in.screenHeight - 1.0f);
+    const __m256 x0 = clampScreen(_mm256_mul_ps(_mm256_fmadd_ps(minX, half, half), w), wMax);
+    const __m256 x1 = clampScreen(_mm256_mul_ps(_mm256_fmadd_ps(maxX, half, half), w), wMax);
+    const __m256 y0 = clampScreen(_mm256_mul_ps(_mm256_fnmadd_ps(maxY, half, half), h), hMax);
+    const __m256 y1 = clampScreen(_mm256_mul_ps(_mm256_fnmadd_ps(minY, half, half), h), hMax);
+
+    const __m256 size = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(x1, x0), _mm256_sub_ps(y1, y0)), _mm256_set1_ps(1.0f));
+    __m256i level = _mm256_sub_epi32(
+        _mm256_srli_epi32(_mm256_add_epi32(_mm256_castps_si256(size), _mm256_set1_epi32(0x7FFFFF)), 23),
+        _mm256_set1_epi32(127));
+    level = _mm256_min_epi32(level, _mm256_set1_epi32(in.pyramidLevels - 1));
+
+    const __m256i ix0 = _mm256_srlv_epi32(_mm256_cvttps_epi32(x0), level);
+    const __m256i ix1 = _mm256_srlv_epi32(_mm256_cvttps_epi32(x1), level);
+    const __m256i iy0 = _mm256_srlv_epi32(_mm256_cvttps_epi32(y0), level);
+    const __m256i iy1 = _mm256_srlv_epi32(_mm256_cvttps_epi32(y1), level);
+    const __m256i offset = _mm256_i32gather_epi32(in.pyramidOffsets, level, 4);
+    const __m256i stride = _mm256_i32gather_epi32(in.pyramidWidths, level, 4);
+    const __m256i row0 = _mm256_add_epi32(offset, _mm256_mullo_epi32(iy0, stride));
+    const __m256i row1 = _mm256_add_epi32(offset, _mm256_mullo_epi32(iy1, stride));
+
+    const __m256 d00 = _mm256_i32gather_ps(in.pyramid, _mm256_add_epi32(row0, ix0), 4);
+    const __m256 d01 = _mm256_i32gather_ps(in.pyramid, _mm256_add_epi32(row0, ix1), 4);
+    const __m256 d10 = _mm256_i32gather_ps(in.pyramid, _mm256_add_epi32(row1, ix0), 4);
+    const __m256 d11 = _mm256_i32gather_ps(in.pyramid, _mm256_add_epi32(row1, ix1), 4);
+    const __m256 depth = _mm256_max_ps(_mm256_max_ps(d00, d01), _mm256_max_ps(d10, d11));
+
+    const __m256 occluded = _mm256_andnot_ps(nearCross, _mm256_cmp_ps(minZ, depth, _CMP_GT_OQ));
+    return uint32_t(_mm256_movemask_ps(occluded));
+}
+
+} // namespace
+
+REBEL_TARGET_AVX2_FMA CullKernelResult cullAvx2(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out)
+{
+    Avx2Constants k;
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    for (int p = 0; p < 6; ++p) {
+        for (int c = 0; c < 4; ++c)
+            k.plane[p][c] = _mm256_set1_ps(in.planes[p][c]);
+        for (int c = 0; c < 3; ++c)
+            k.absPlane[p][c] = _mm256_andnot_ps(signMask, k.plane[p][c]);
+    }
+    for (int i = 0; i < 16; ++i)
+        k.m[i] = _mm256_set1_ps(in.viewProjection[i]);
+
+    CullKernelResult result{0, 0};
+    for (uint32_t i = begin; i < end; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(in.centerX + i);
+        const __m256 cy = _mm256_loadu_ps(in.centerY + i);
+        const __m256 cz = _mm256_loadu_ps(in.centerZ + i);
+        const __m256 ex = _mm256_loadu_ps(in.extentX + i);
+        const __m256 ey = _mm256_loadu_ps(in.extentY + i);
+        const __m256 ez = _mm256_loadu_ps(in.extentZ + i);
+        const __m256 radius = _mm256_loadu_ps(in.radius + i);
+
+        __m256 outside = _mm256_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const __m256 d =
+                _mm256_fmadd_ps(k.plane[p][0], cx, _mm256_fmadd_ps(k.plane[p][1], cy, _mm256_fmadd_ps(k.plane[p][2], cz, k.plane[p][3])));
+            const __m256 boxRadius = _mm256_fmadd_ps(
+                k.absPlane[p][0], ex, _mm256_fmadd_ps(k.absPlane[p][1], ey, _mm256_mul_ps(k.absPlane[p][2], ez)));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(d, _mm256_min_ps(radius, boxRadius)),
+                                                          _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+
+        const uint32_t valid = end - i >= 8 ? 0xFFu : (1u << (end - i)) - 1;
+        uint32_t visible = ~uint32_t(_mm256_movemask_ps(outside)) & valid;
+        while (visible) {
+            out[result.visible++] = i + uint32_t(std::countr_zero(visible));
+            visible &= visible - 1;
+        }
+    }
+    result.frustumCulled = (end - begin) - result.visible;
+    if (!in.pyramid)
+        return result;
+
+    // Occlusion runs over the packed frustum survivors so no lanes are
+    // wasted on culled objects; survivors are compacted again in place.
+    const uint32_t survivors = result.visible;
+    result.visible = 0;
+    for (uint32_t s = 0; s < survivors; s += 8) {
+        const uint32_t valid = survivors - s >= 8 ? 0xFFu : (1u << (survivors - s)) - 1;
+        const __m256i laneMask = _mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(survivors - s)),
+                                                    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        const __m256i index = _mm256_maskload_epi32(reinterpret_cast<const int*>(out + s), laneMask);
+        uint32_t visible = valid & ~occludedAvx2(in, k, _mm256_i32gather_ps(in.centerX, index, 4),
+                                                 _mm256_i32gather_ps(in.centerY, index, 4),
+                                                 _mm256_i32gather_ps(in.centerZ, index, 4),
+                                                 _mm256_i32gather_ps(in.extentX, index, 4),
+                                                 _mm256_i32gather_ps(in.extentY, index, 4),
+                                                 _mm256_i32gather_ps(in.extentZ, index, 4));
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), index);
+        while (visible) {
+            out[result.visible++] = lanes[std::countr_zero(visible)];
+            visible &= visible - 1;
+        }
+    }
+    return result;
+}
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// AVX-512, 16 objects per iteration
+
+struct Avx512Constants {
+    __m512 plane[6][4];
+    __m512 absPlane[6][3];
+    __m512 m[16];
+};
+
+REBEL_TARGET_AVX512 REBEL_FORCEINLINE __m512 clampScreen(__m512 v, __m512 hi)
+{
+    return _mm512_min_ps(_mm512_max_ps(v, _mm512_setzero_ps()), hi);
+}
+
+REBEL_TARGET_AVX512 inline __mmask16 occludedAvx512(const CullKernelInput& in, const Avx512Constants& k,
+                                                    __m512 cx, __m512 cy, __m512 cz, __m512 ex, __m512 ey,
+                                                    __m512 ez)
+{
+    __m512 center[4], axisX[4], axisY[4], axisZ[4];
+    for (int r = 0; r < 4; ++r) {
+        center[r] = _mm512_fmadd_ps(k.m[r], cx, _mm512_fmadd_ps(k.m[4 + r], cy, _mm512_fmadd_ps(k.m[8 + r], cz, k.m[12 + r])));
+        axisX[r] = _mm512_mul_ps(k.m[r], ex);
+        axisY[r] = _mm512_mul_ps(k.m[4 + r], ey);
+        axisZ[r] = _mm512_mul_ps(k.m[8 + r], ez);
+    }
+
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 minX = _mm512_set1_ps(INFINITY), maxX = _mm512_set1_ps(-INFINITY);
+    __m512 minY = minX, maxY = maxX, minZ = minX;
+    __mmask16 nearCross = 0;
+    for (int c = 0; c < 8; ++c) {
+        __m512 p[4];
+        for (int r = 0; r < 4; ++r) {
+            p[r] = (c & 1) ? _mm512_add_ps(center[r], axisX[r]) : _mm512_sub_ps(center[r], axisX[r]);
+            p[r] = (c & 2) ? _mm512_add_ps(p[r], axisY[r]) : _mm512_sub_ps(p[r], axisY[r]);
+            p[r] = (c & 4) ? _mm512_add_ps(p[r], axisZ[r]) : _mm512_sub_ps(p[r], axisZ[r]);
+        }
+        nearCross |= _mm512_cmp_ps_mask(p[2], zero, _CMP_LT_OQ);
+        __m512 invW = _mm512_rcp14_ps(p[3]);
+        invW = _mm512_mul_ps(invW, _mm512_fnmadd_ps(p[3], invW, _mm512_set1_ps(2.0f)));
+        const __m512 x = _mm512_mul_ps(p[0], invW), y = _mm512_mul_ps(p[1], invW), z = _mm512_mul_ps(p[2], invW);
+        minX = _mm512_min_ps(minX, x);
+        maxX = _mm512_max_ps(maxX, x);
+        minY = _mm512_min_ps(minY, y);
+        maxY = _mm512_max_ps(maxY, y);
+        minZ = _mm512_min_ps(minZ, z);
+    }
+
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 w = _mm512_set1_ps(in.screenWidth), h = _mm512_set1_ps(in.screenHeight);
+    const __m512 wMax = _mm512_set1_ps(in.screenWidth - 1.0f), hMax = _mm512_set1_ps(in.screenHeight - 1.0f);
+    const __m512 x0 = clampScreen(_mm512_mul_ps(_mm512_fmadd_ps(minX, half, half), w), wMax);
+    const __m512 x1 = clampScreen(_mm512_mul_ps(_mm512_fmadd_ps(maxX, half, half), w), wMax);
+    const __m512 y0 = clampScreen(_mm512_mul_ps(_mm512_fnmadd_ps(maxY, half, half), h), hMax);
+    const __m512 y1 = clampScreen(_mm512_mul_ps(_mm512_fnmadd_ps(minY, half, half), h), hMax);
+
+    const __m512 size = _mm512_max_ps(_mm512_max_ps(_mm512_sub_ps(x1, x0), _mm512_sub_ps(y1, y0)), _mm512_set1_ps(1.0f));
+    __m512i level = _mm512_sub_epi32(
+        _mm512_srli_epi32(_mm512_add_epi32(_mm512_castps_si512(size), _mm512_set1_epi32(0x7FFFFF)), 23),
+        _mm512_set1_epi32(127));
+    level = _mm512_min_epi32(level, _mm512_set1_epi32(in.pyramidLevels - 1));
+
+    const __m512i ix0 = _mm512_srlv_epi32(_mm512_cvttps_epi32(x0), level);
+    const __m512i ix1 = _mm512_srlv_epi32(_mm512_cvttps_epi32(x1), level);
+    const __m512i iy0 = _mm512_srlv_epi32(_mm512_cvttps_epi32(y0), level);
+    const __m512i iy1 = _mm512_srlv_epi32(_mm512_cvttps_epi32(y1), level);
+    const __m512i offset = _mm512_i32gather_epi32(level, in.pyramidOffsets, 4);
+    const __m512i stride = _mm512_i32gather_epi32(level, in.pyramidWidths, 4);
+    const __m512i row0 = _mm512_add_epi32(offset, _mm512_mullo_epi32(iy0, stride));
+    const __m512i row1 = _mm512_add_epi32(offset, _mm512_mullo_epi32(iy1, stride));
+
+    const __m512 d00 = _mm512_i32gather_ps(_mm512_add_epi32(row0, ix0), in.pyramid, 4);
+    const __m512 d01 = _mm512_i32gather_ps(_mm512_add_epi32(row0, ix1), in.pyramid, 4);
+    const __m512 d10 = _mm512_i32gather_ps(_mm512_add_epi32(row1, ix0), in.pyramid, 4);
+    const __m512 d11 = _mm512_i32gather_ps(_mm512_add_epi32(row1, ix1), in.pyramid, 4);
+    const __m512 depth = _mm512_max_ps(_mm512_max_ps(d00, d01), _mm512_max_ps(d10, d11));
+
+    return __mmask16(_mm512_cmp_ps_mask(minZ, depth, _CMP_GT_OQ) & ~nearCross);
+}
+
+} // namespace
+
+REBEL_TARGET_AVX512 CullKernelResult cullAvx512(const CullKernelInput& in, uint32_t begin, uint32_t end,
+                                                uint32_t* out)
+{
+    Avx512Constants k;
+    for (int p = 0; p < 6; ++p) {
+        for (int c = 0; c < 4; ++c)
+            k.plane[p][c] = _mm512_set1_ps(in.planes[p][c]);
+        for (int c = 0; c < 3; ++c)
+            k.absPlane[p][c] = _mm512_abs_ps(k.plane[p][c]);
+    }
+    for (int i = 0; i < 16; ++i)
+        k.m[i] = _mm512_set1_ps(in.viewProjection[i]);
+
+    const __m512i laneIndex = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    CullKernelResult result{0, 0};
+    for (uint32_t i = begin; i < end; i += 16) {
+        const __m512 cx = _mm512_loadu_ps(in.centerX + i);
+        const __m512 cy = _mm512_loadu_ps(in.centerY + i);
+        const __m512 cz = _mm512_loadu_ps(in.centerZ + i);
+        const __m512 ex = _mm512_loadu_ps(in.extentX + i);
+        const __m512 ey = _mm512_loadu_ps(in.extentY + i);
+        const __m512 ez = _mm512_loadu_ps(in.extentZ + i);
+        const __m512 radius = _mm512_loadu_ps(in.radius + i);
+
+        const __mmask16 valid = end - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (end - i)) - 1);
+        __mmask16 visible = valid;
+        for (int p = 0; p < 6; ++p) {
+            const __m512 d =
+                _mm512_fmadd_ps(k.plane[p][0], cx, _mm512_fmadd_ps(k.plane[p][1], cy, _mm512_fmadd_ps(k.plane[p][2], cz, k.plane[p][3])));
+            const __m512 boxRadius = _mm512_fmadd_ps(
+                k.absPlane[p][0], ex, _mm512_fmadd_ps(k.absPlane[p][1], ey, _mm512_mul_ps(k.absPlane[p][2], ez)));
+            visible = _mm512_mask_cmp_ps_mask(visible, _mm512_add_ps(d, _mm512_min_ps(radius, boxRadius)),
+                                              _mm512_setzero_ps(), _CMP_GE_OQ);
+        }
+
+        _mm512_mask_compressstoreu_epi32(out + result.visible, visible,
+                                         _mm512_add_epi32(laneIndex, _mm512_set1_epi32(int32_t(i))));
+        result.visible += uint32_t(std::popcount(uint32_t(visible)));
+    }
+    result.frustumCulled = (end - begin) - result.visible;
+    if (!in.pyramid)
+        return result;
+
+    const uint32_t survivors = result.visible;
+    result.visible = 0;
+    for (uint32_t s = 0; s < survivors; s += 16) {
+        const __mmask16 valid = survivors - s >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (survivors - s)) - 1);
+        const __m512i index = _mm512_maskz_loadu_epi32(valid, out + s);
+        const __mmask16 visible =
+            valid & ~occludedAvx512(in, k, _mm512_i32gather_ps(index, in.centerX, 4),
+                                    _mm512_i32gather_ps(index, in.centerY, 4), _mm512_i32gather_ps(index, in.centerZ, 4),
+                                    _mm512_i32gather_ps(index, in.extentX, 4), _mm512_i32gather_ps(index, in.extentY, 4),
+                                    _mm512_i32gather_ps(index, in.extentZ, 4));
+        _mm512_mask_compressstoreu_epi32(out + result.visible, visible, index);
+        result.visible += uint32_t(std::popcount(uint32_t(visible)));
+    }
+    return result;
+}
+
+} // namespace rebel::render::detail
+
+#else
+
+namespace rebel::render::detail {
+
+CullKernelResult cullAvx2(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out)
+{
+    return cullScalar(in, begin, end, out);
+}
+
+CullKernelResult cullAvx512(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out)
+{
+    return cullScalar(in, begin, end, out);
+}
+
+} // namespace rebel::render::detail
+
+#endif
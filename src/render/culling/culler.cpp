@@ -0,0 +1,166 @@
+#include "render/culling/culler.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "render/culling/cull_kernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace rebel::render {
+
+namespace detail {
+
+namespace {
+
+bool occludedScalar(const CullKernelInput& in, uint32_t i)
+{
+    const float* m = in.viewProjection;
+    const float cx = in.centerX[i], cy = in.centerY[i], cz = in.centerZ[i];
+    const float ex = in.extentX[i], ey = in.extentY[i], ez = in.extentZ[i];
+
+    float center[4], axisX[4], axisY[4], axisZ[4];
+    for (int r = 0; r < 4; ++r) {
+        center[r] = m[r] * cx + m[4 + r] * cy + m[8 + r] * cz + m[12 + r];
+        axisX[r] = m[r] * ex;
+        axisY[r] = m[4 + r] * ey;
+        axisZ[r] = m[8 + r] * ez;
+    }
+
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY, minZ = INFINITY;
+    for (int k = 0; k < 8; ++k) {
+        const float sx = (k & 1) ? 1.0f : -1.0f, sy = (k & 2) ? 1.0f : -1.0f, sz = (k & 4) ? 1.0f : -1.0f;
+        float c[4];
+        for (int r = 0; r < 4; ++r)
+            c[r] = center[r] + sx * axisX[r] + sy * axisY[r] + sz * axisZ[r];
+        if (c[2] < 0.0f)
+            return false; // crosses the near plane
+        const float invW = 1.0f / c[3];
+        minX = std::min(minX, c[0] * invW);
+        maxX = std::max(maxX, c[0] * invW);
+        minY = std::min(minY, c[1] * invW);
+        maxY = std::max(maxY, c[1] * invW);
+        minZ = std::min(minZ, c[2] * invW);
+    }
+
+    const float x0 = std::clamp((minX * 0.5f + 0.5f) * in.screenWidth, 0.0f, in.screenWidth - 1.0f);
+    const float x1 = std::clamp((maxX * 0.5f + 0.5f) * in.screenWidth, 0.0f, in.screenWidth - 1.0f);
+    const float y0 = std::clamp((0.5f - maxY * 0.5f) * in.screenHeight, 0.0f, in.screenHeight - 1.0f);
+    const float y1 = std::clamp((0.5f - minY * 0.5f) * in.screenHeight, 0.0f, in.screenHeight - 1.0f);
+
+    // Smallest level at which the rectangle spans at most 2x2 texels:
+    // ceil(log2(size)), read from the float exponent.
+    const float size = std::max(std::max(x1 - x0, y1 - y0), 1.0f);
+    const int32_t level = std::min(int32_t((std::bit_cast<uint32_t>(size) + 0x7FFFFF) >> 23) - 127, in.pyramidLevels - 1);
+
+    const int32_t ix0 = int32_t(x0) >> level, ix1 = int32_t(x1) >> level;
+    const int32_t iy0 = int32_t(y0) >> level, iy1 = int32_t(y1) >> level;
+    const float* texels = in.pyramid + in.pyramidOffsets[level];
+    const int32_t stride = in.pyramidWidths[level];
+    const float depth = std::max(std::max(texels[iy0 * stride + ix0], texels[iy0 * stride + ix1]),
+                                 std::max(texels[iy1 * stride + ix0], texels[iy1 * stride + ix1]));
+    return minZ > depth;
+}
+
+} // namespace
+
+CullKernelResult cullScalar(const CullKernelInput& in, uint32_t begin, uint32_t end, uint32_t* out)
+{
+    CullKernelResult result{0, 0};
+    for (uint32_t i = begin; i < end; ++i) {
+        bool outside = false;
+        for (const float* p : in.planes) {
+            const float d = p[0] * in.centerX[i] + p[1] * in.centerY[i] + p[2] * in.centerZ[i] + p[3];
+            const float boxRadius =
+                std::abs(p[0]) * in.extentX[i] + std::abs(p[1]) * in.extentY[i] + std::abs(p[2]) * in.extentZ[i];
+            outside |= d + std::min(in.radius[i], boxRadius) < 0.0f;
+        }
+        if (outside) {
+            ++result.frustumCulled;
+            continue;
+        }
+        if (in.pyramid && occludedScalar(in, i))
+            continue;
+        out[result.visible++] = i;
+    }
+    return result;
+}
+
+} // namespace detail
+
+Culler::Culler(SimdLevel level)
+    : level_(std::min(level, detectSimdLevel()))
+{
+}
+
+std::span<const uint32_t> Culler::cull(const BoundsSoA& bounds, const CullParams& params, jobs::JobSystem& jobs)
+{
+    static_assert(kObjectsPerJob % BoundsSoA::kPadding == 0);
+
+    detail::CullKernelInput in{};
+    in.centerX = bounds.centerX();
+    in.centerY = bounds.centerY();
+    in.centerZ = bounds.centerZ();
+    in.extentX = bounds.extentX();
+    in.extentY = bounds.extentY();
+    in.extentZ = bounds.extentZ();
+    in.radius = bounds.radius();
+
+    // Gribb-Hartmann plane extraction for clip z in [0, w].
+    const math::Mat4& vp = params.viewProjection;
+    auto row = [&](int r) { return math::Vec4{vp.cols[0][r], vp.cols[1][r], vp.cols[2][r], vp.cols[3][r]}; };
+    const math::Vec4 planes[6] = {row(3) + row(0), row(3) - row(0), row(3) + row(1),
+                                  row(3) - row(1), row(2),          row(3) - row(2)};
+    for (int p = 0; p < 6; ++p) {
+        const float invLength = 1.0f / math::length(planes[p].xyz());
+        in.planes[p][0] = planes[p].x * invLength;
+        in.planes[p][1] = planes[p].y * invLength;
+        in.planes[p][2] = planes[p].z * invLength;
+        in.planes[p][3] = planes[p].w * invLength;
+    }
+    std::memcpy(in.viewProjection, vp.cols, sizeof(in.viewProjection));
+
+    if (params.occlusion && !params.occlusion->empty()) {
+        const DepthPyramid& pyramid = *params.occlusion;
+        in.pyramid = pyramid.data();
+        in.pyramidOffsets = pyramid.offsets();
+        in.pyramidWidths = pyramid.widths();
+        in.pyramidLevels = int32_t(pyramid.levelCount());
+        in.screenWidth = float(pyramid.width(0));
+        in.screenHeight = float(pyramid.height(0));
+    }
+
+    detail::CullKernel kernel = detail::cullScalar;
+    if (level_ == SimdLevel::Avx512)
+        kernel = detail::cullAvx512;
+    else if (level_ == SimdLevel::Avx2)
+        kernel = detail::cullAvx2;
+
+    const uint32_t count = bounds.size();
+    const uint32_t jobCount = (count + kObjectsPerJob - 1) / kObjectsPerJob;
+    visible_.resize(count);
+    results_.resize(jobCount);
+    jobs.parallelFor(count, kObjectsPerJob, [&](uint32_t begin, uint32_t end) {
+        const detail::CullKernelResult r = kernel(in, begin, end, visible_.data() + begin);
+        results_[begin / kObjectsPerJob] = {r.visible, r.frustumCulled};
+    });
+
+    // Each job wrote its survivors at its own offset; pack them together.
+    stats_ = {};
+    stats_.tested = count;
+    uint32_t cursor = 0;
+    for (uint32_t j = 0; j < jobCount; ++j) {
+        const JobResult& r = results_[j];
+        if (cursor != j * kObjectsPerJob)
+            std::memmove(visible_.data() + cursor, visible_.data() + j * kObjectsPerJob, r.visible * sizeof(uint32_t));
+        cursor += r.visible;
+        stats_.frustumCulled += r.frustumCulled;
+    }
+    stats_.visible = cursor;
+    stats_.occlusionCulled = count - stats_.visible - stats_.frustumCulled;
+    return {visible_.data(), cursor};
+}
+
+} // namespace rebel::render
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/cpu_features.h"
+#include "core/math/mat.h"
+#include "render/culling/bounds.h"
+#include "render/culling/depth_pyramid.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::render {
+
+struct CullParams {
+    math::Mat4 viewProjection;
+    /// Optional occlusion test against a depth pyramid rendered with the same
+    /// viewProjection. Objects crossing the near plane are never occluded.
+    const DepthPyramid* occlusion = nullptr;
+};
+
+struct CullStats {
+    uint32_t tested = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t occlusionCulled = 0;
+    uint32_t visible = 0;
+};
+
+/// Frustum and occlusion culling over BoundsSoA, split into jobs of
+/// kObjectsPerJob objects.
+///
+/// The frustum test rejects an object when, against any plane, either its
+/// sphere or its AABB lies fully outside. Frustum survivors are then
+/// projected (all eight AABB corners) to a screen rectangle and nearest
+/// depth; the pyramid level where the rectangle spans at most 2x2 texels is
+/// sampled, and the object is occluded if its nearest depth lies behind the
+/// farthest occluder depth there.
+///
+/// Kernels exist for AVX-512 (16 lanes), AVX2 (8 lanes) and scalar code; the
+/// widest one the CPU supports is used unless a lower level is requested.
+class Culler {
+public:
+    static constexpr uint32_t kObjectsPerJob = 8192;
+
+    explicit Culler(SimdLevel level = detectSimdLevel());
+
+    SimdLevel simdLevel() const { return level_; }
+
+    /// Returns the indices of visible objects in ascending order. The span
+    /// stays valid until the next cull().
+    std::span<const uint32_t> cull(const BoundsSoA& bounds, const CullParams& params, jobs::JobSystem& jobs);
+
+    const CullStats& stats() const { return stats_; }
+
+private:
+    struct JobResult {
+        uint32_t visible;
+        uint32_t frustumCulled;
+    };
+
+    SimdLevel level_;
+    std::vector<uint32_t> visible_;
+    std::vector<JobResult> results_;
+    CullStats stats_;
+};
+
+} // namespace rebel::render
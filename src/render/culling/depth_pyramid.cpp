@@ -0,0 +1,55 @@
+#include "render/culling/depth_pyramid.h"
+
+#include "core/assert.h"
+#include "render/software/software_rasterizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rebel::render {
+
+void DepthPyramid::build(const SoftwareRasterizer& occluders)
+{
+    occluders.resolveDepth(scratch_);
+    build(scratch_.data(), occluders.width(), occluders.height());
+}
+
+void DepthPyramid::build(const float* depth, uint32_t width, uint32_t height)
+{
+    REBEL_ASSERT(width > 0 && height > 0, "empty depth buffer");
+
+    std::size_t total = 0;
+    levels_ = 0;
+    uint32_t w = width, h = height;
+    while (true) {
+        REBEL_ASSERT(levels_ < kMaxLevels, "depth buffer too large for the pyramid");
+        offsets_[levels_] = int32_t(total);
+        widths_[levels_] = int32_t(w);
+        heights_[levels_] = int32_t(h);
+        total += std::size_t(w) * h;
+        ++levels_;
+        if (w == 1 && h == 1)
+            break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+
+    data_.resize(total);
+    std::memcpy(data_.data(), depth, std::size_t(width) * height * sizeof(float));
+
+    for (uint32_t l = 1; l < levels_; ++l) {
+        const float* src = data_.data() + offsets_[l - 1];
+        float* dst = data_.data() + offsets_[l];
+        const int32_t srcW = widths_[l - 1], srcH = heights_[l - 1];
+        for (int32_t y = 0; y < heights_[l]; ++y) {
+            const float* row0 = src + std::size_t(2 * y) * srcW;
+            const float* row1 = src + std::size_t(std::min(2 * y + 1, srcH - 1)) * srcW;
+            for (int32_t x = 0; x < widths_[l]; ++x) {
+                const int32_t x0 = 2 * x, x1 = std::min(2 * x + 1, srcW - 1);
+                dst[std::size_t(y) * widths_[l] + x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+            }
+        }
+    }
+}
+
+} // namespace rebel::render
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::render {
+
+class SoftwareRasterizer;
+
+/// Hierarchical max-depth buffer for occlusion queries. Level 0 is the
+/// occluder depth buffer; each further level halves the resolution (rounding
+/// up) and keeps the farthest depth of its 2x2 children, so texel t of level
+/// L covers level-0 pixels [t * 2^L, (t + 1) * 2^L).
+///
+/// Built from a low-resolution depth-only SoftwareRasterizer pass over the
+/// largest occluders. Depth is clip z/w in [0, 1] with less-than testing, as
+/// in the rasterizer.
+class DepthPyramid {
+public:
+    static constexpr uint32_t kMaxLevels = 16;
+
+    void build(const SoftwareRasterizer& occluders);
+    /// Builds from a row-major depth buffer.
+    void build(const float* depth, uint32_t width, uint32_t height);
+
+    bool empty() const { return levels_ == 0; }
+    uint32_t levelCount() const { return levels_; }
+    uint32_t width(uint32_t level) const { return uint32_t(widths_[level]); }
+    uint32_t height(uint32_t level) const { return uint32_t(heights_[level]); }
+    const float* level(uint32_t level) const { return data_.data() + offsets_[level]; }
+
+    /// Kernel view: every level packed in one array, with per-level offsets
+    /// and sizes stored as int32 so SIMD code can gather them directly.
+    const float* data() const { return data_.data(); }
+    const int32_t* offsets() const { return offsets_; }
+    const int32_t* widths() const { return widths_; }
+    const int32_t* heights() const { return heights_; }
+
+private:
+    std::vector<float> data_;
+    std::vector<float> scratch_;
+    uint32_t levels_ = 0;
+    int32_t offsets_[kMaxLevels] = {};
+    int32_t widths_[kMaxLevels] = {};
+    int32_t heights_[kMaxLevels] = {};
+};
+
+} // namespace rebel::render
@@ -0,0 +1,37 @@
+#include "render/image.h"
+
+#include <cstdio>
+
+namespace rebel::render {
+
+bool writeTga(const Image& image, const char* path)
+{
+    FILE* file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+
+    unsigned char header[18] = {};
+    header[2] = 2; // uncompressed true-colour
+    header[12] = uint8_t(image.width & 0xFF);
+    header[13] = uint8_t(image.width >> 8);
+    header[14] = uint8_t(image.height & 0xFF);
+    header[15] = uint8_t(image.height >> 8);
+    header[16] = 32;
+    header[17] = 0x28; // top-left origin, 8 alpha bits
+    bool ok = std::fwrite(header, sizeof(header), 1, file) == 1;
+
+    std::vector<unsigned char> row(std::size_t(image.width) * 4);
+    for (uint32_t y = 0; ok && y < image.height; ++y) {
+        for (uint32_t x = 0; x < image.width; ++x) {
+            const uint32_t p = image.at(x, y);
+            row[x * 4 + 0] = uint8_t(p >> 16); // B
+            row[x * 4 + 1] = uint8_t(p >> 8);  // G
+            row[x * 4 + 2] = uint8_t(p);       // R
+            row[x * 4 + 3] = uint8_t(p >> 24); // A
+        }
+        ok = std::fwrite(row.data(), row.size(), 1, file) == 1;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace rebel::render
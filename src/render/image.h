@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::render {
+
+/// CPU-side RGBA8 image, row-major, top row first. Pixels are packed as
+/// 0xAABBGGRR (R in the lowest byte).
+struct Image {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> pixels;
+
+    void resize(uint32_t w, uint32_t h)
+    {
+        width = w;
+        height = h;
+        pixels.assign(std::size_t(w) * h, 0u);
+    }
+
+    uint32_t at(uint32_t x, uint32_t y) const { return pixels[std::size_t(y) * width + x]; }
+};
+
+/// Writes an uncompressed 32-bit TGA. Returns false on I/O failure.
+bool writeTga(const Image& image, const char* path);
+
+} // namespace rebel::render
@@ -0,0 +1,142 @@
+#include "render/lighting/clustered_lights.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rebel::render {
+
+ClusteredLights::ClusteredLights(const ClusterGridDesc& desc)
+    : tilesX_(desc.tilesX)
+    , tilesY_(desc.tilesY)
+    , slices_(desc.slices)
+{
+    REBEL_ASSERT(tilesX_ > 0 && tilesY_ > 0 && slices_ > 0, "empty cluster grid");
+    ranges_.resize(clusterCount());
+}
+
+uint32_t ClusteredLights::slice(float viewDepth) const
+{
+    const float s = std::log(std::max(viewDepth, view_.nearPlane)) * sliceScale_ + sliceBias_;
+    return std::min(uint32_t(std::max(s, 0.0f)), slices_ - 1);
+}
+
+uint32_t ClusteredLights::clusterIndex(float u, float v, float viewDepth) const
+{
+    const uint32_t x = std::min(uint32_t(std::max(u, 0.0f) * float(tilesX_)), tilesX_ - 1);
+    const uint32_t y = std::min(uint32_t(std::max(v, 0.0f) * float(tilesY_)), tilesY_ - 1);
+    return (slice(viewDepth) * tilesY_ + y) * tilesX_ + x;
+}
+
+void ClusteredLights::build(std::span<const PointLight> lights, const ClusterView& view, jobs::JobSystem& jobs)
+{
+    REBEL_ASSERT(view.nearPlane > 0.0f && view.farPlane > view.nearPlane, "invalid cluster depth range");
+
+    view_ = view;
+    tanHalfY_ = std::tan(view.verticalFov * 0.5f);
+    tanHalfX_ = tanHalfY_ * view.aspect;
+    // slice(d) = log(d / near) / log(far / near) * slices
+    sliceScale_ = float(slices_) / std::log(view.farPlane / view.nearPlane);
+    sliceBias_ = -std::log(view.nearPlane) * sliceScale_;
+    sliceDepths_.resize(slices_ + 1);
+    for (uint32_t s = 0; s <= slices_; ++s)
+        sliceDepths_[s] = view.nearPlane * std::pow(view.farPlane / view.nearPlane, float(s) / float(slices_));
+    sliceDepths_[slices_] = view.farPlane;
+
+    const uint32_t lightCount = uint32_t(lights.size());
+    const uint32_t clusters = clusterCount();
+    const uint32_t grain = std::max(32u, (lightCount + jobs.workerCount() * 4 - 1) / (jobs.workerCount() * 4));
+    const uint32_t jobCount = std::max(1u, (lightCount + grain - 1) / grain);
+
+    // 1. Bin lights into (cluster, light) entries, one list per job.
+    if (jobEntries_.size() < jobCount)
+        jobEntries_.resize(jobCount);
+    for (uint32_t j = 0; j < jobCount; ++j)
+        jobEntries_[j].clear();
+    jobs.parallelFor(lightCount, grain, [&](uint32_t begin, uint32_t end) {
+        binLights(lights, begin, end, jobEntries_[begin / grain]);
+    });
+
+    // 2. Count entries per (job, cluster), then prefix-sum cluster-major so
+    //    every cluster's lights are contiguous and in job (= light) order.
+    jobOffsets_.assign(std::size_t(jobCount) * clusters, 0);
+    jobs.parallelFor(jobCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t j = begin; j < end; ++j) {
+            uint32_t* counts = jobOffsets_.data() + std::size_t(j) * clusters;
+            for (const Entry& e : jobEntries_[j])
+                ++counts[e.cluster];
+        }
+    });
+
+    uint32_t total = 0;
+    for (uint32_t c = 0; c < clusters; ++c) {
+        ranges_[c].offset = total;
+        for (uint32_t j = 0; j < jobCount; ++j) {
+            uint32_t& slot = jobOffsets_[std::size_t(j) * clusters + c];
+            const uint32_t count = slot;
+            slot = total;
+            total += count;
+        }
+        ranges_[c].count = total - ranges_[c].offset;
+    }
+
+    // 3. Scatter each job's entries into place.
+    indices_.resize(total);
+    jobs.parallelFor(jobCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t j = begin; j < end; ++j) {
+            uint32_t* offsets = jobOffsets_.data() + std::size_t(j) * clusters;
+            for (const Entry& e : jobEntries_[j])
+                indices_[offsets[e.cluster]++] = e.light;
+        }
+    });
+}
+
+void ClusteredLights::binLights(std::span<const PointLight> lights, uint32_t begin, uint32_t end,
+                                std::vector<Entry>& out) const
+{
+    const float nearPlane = view_.nearPlane, farPlane = view_.farPlane;
+    const int32_t maxTileX = int32_t(tilesX_) - 1, maxTileY = int32_t(tilesY_) - 1;
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const PointLight& light = lights[i];
+        const math::Vec3 p = view_.view.transformPoint(light.position);
+        const float depth = -p.z;
+        const float r = light.radius;
+        if (depth + r < nearPlane || depth - r > farPlane)
+            continue;
+
+        const uint32_t firstSlice = slice(std::max(depth - r, nearPlane));
+        const uint32_t lastSlice = slice(std::min(depth + r, farPlane));
+        for (uint32_t s = firstSlice; s <= lastSlice; ++s) {
+            const float z0 = std::max(sliceDepths_[s], depth - r);
+            const float z1 = std::max(std::min(sliceDepths_[s + 1], depth + r), z0);
+
+            // Largest cross-section of the sphere within [z0, z1], bounded by
+            // a view-space square and projected at both slab depths.
+            const float gap = depth < z0 ? z0 - depth : (depth > z1 ? depth - z1 : 0.0f);
+            const float rs = std::sqrt(std::max(r * r - gap * gap, 0.0f));
+            const float x0 = p.x - rs, x1 = p.x + rs;
+            const float y0 = p.y - rs, y1 = p.y + rs;
+            const float ndcX0 = std::min(x0 / z0, x0 / z1) / tanHalfX_;
+            const float ndcX1 = std::max(x1 / z0, x1 / z1) / tanHalfX_;
+            const float ndcY0 = std::min(y0 / z0, y0 / z1) / tanHalfY_;
+            const float ndcY1 = std::max(y1 / z0, y1 / z1) / tanHalfY_;
+            if (ndcX1 < -1.0f || ndcX0 > 1.0f || ndcY1 < -1.0f || ndcY0 > 1.0f)
+                continue;
+
+            const int32_t tx0 = std::max(int32_t(std::floor((ndcX0 * 0.5f + 0.5f) * float(tilesX_))), 0);
+            const int32_t tx1 = std::min(int32_t(std::floor((ndcX1 * 0.5f + 0.5f) * float(tilesX_))), maxTileX);
+            const int32_t ty0 = std::max(int32_t(std::floor((0.5f - ndcY1 * 0.5f) * float(tilesY_))), 0);
+            const int32_t ty1 = std::min(int32_t(std::floor((0.5f - ndcY0 * 0.5f) * float(tilesY_))), maxTileY);
+            for (int32_t ty = ty0; ty <= ty1; ++ty) {
+                const uint32_t row = (s * tilesY_ + uint32_t(ty)) * tilesX_;
+                for (int32_t tx = tx0; tx <= tx1; ++tx)
+                    out.push_back({row + uint32_t(tx), i});
+            }
+        }
+    }
+}
+
+} // namespace rebel::render
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/math/mat.h"
+#include "core/math/vec.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::render {
+
+struct PointLight {
+    math::Vec3 position; // world space
+    float radius = 1.0f; // range; the light contributes nothing beyond it
+    math::Vec3 color{1.0f, 1.0f, 1.0f};
+    float intensity = 1.0f;
+};
+
+struct ClusterGridDesc {
+    uint32_t tilesX = 16;
+    uint32_t tilesY = 9;
+    uint32_t slices = 24;
+};
+
+/// Camera the clusters are built for; matches Mat4::perspective().
+struct ClusterView {
+    math::Mat4 view;
+    float verticalFov = 1.0f;
+    float aspect = 16.0f / 9.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 500.0f;
+};
+
+/// Range of ClusteredLights::lightIndices() belonging to one cluster.
+struct ClusterLightRange {
+    uint32_t offset;
+    uint32_t count;
+};
+
+/// Clustered forward light assignment on the CPU.
+///
+/// The view frustum is split into tilesX x tilesY screen tiles and `slices`
+/// exponentially spaced depth slices. build() bins every light into the
+/// clusters its sphere may touch: per depth slice it overlaps, the sphere's
+/// cross-section is bounded in view space and projected to a tile rectangle.
+/// Cost is proportional to lights x touched clusters, independent of screen
+/// resolution.
+///
+/// Binning is parallel over lights and the per-cluster lists are then
+/// assembled with a parallel counting sort, so each cluster lists its lights
+/// in ascending index order regardless of scheduling.
+class ClusteredLights {
+public:
+    explicit ClusteredLights(const ClusterGridDesc& desc = {});
+
+    void build(std::span<const PointLight> lights, const ClusterView& view, jobs::JobSystem& jobs);
+
+    uint32_t tilesX() const { return tilesX_; }
+    uint32_t tilesY() const { return tilesY_; }
+    uint32_t slices() const { return slices_; }
+    uint32_t clusterCount() const { return tilesX_ * tilesY_ * slices_; }
+
+    /// Cluster containing a pixel at the given positive view distance.
+    /// `u`, `v` are normalized screen coordinates in [0, 1), v pointing down.
+    uint32_t clusterIndex(float u, float v, float viewDepth) const;
+    uint32_t slice(float viewDepth) const;
+
+    std::span<const ClusterLightRange> clusters() const { return ranges_; }
+    std::span<const uint32_t> lightIndices() const { return indices_; }
+    std::span<const uint32_t> lights(uint32_t cluster) const
+    {
+        const ClusterLightRange r = ranges_[cluster];
+        return {indices_.data() + r.offset, r.count};
+    }
+
+private:
+    struct Entry {
+        uint32_t cluster;
+        uint32_t light;
+    };
+
+    void binLights(std::span<const PointLight> lights, uint32_t begin, uint32_t end, std::vector<Entry>& out) const;
+
+    uint32_t tilesX_, tilesY_, slices_;
+    ClusterView view_;
+    float tanHalfX_ = 1.0f, tanHalfY_ = 1.0f;
+    float sliceScale_ = 1.0f, sliceBias_ = 0.0f;
+    std::vector<float> sliceDepths_; // slices + 1 boundaries
+
+    std::vector<std::vector<Entry>> jobEntries_;
+    std::vector<uint32_t> jobOffsets_; // [job * clusters + cluster]
+    std::vector<ClusterLightRange> ranges_;
+    std::vector<uint32_t> indices_;
+};
+
+} // namespace rebel::render
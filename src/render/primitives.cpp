@@ -0,0 +1,79 @@
+#include "render/primitives.h"
+
+#include <cmath>
+
+namespace rebel::render {
+
+using math::Vec2;
+using math::Vec3;
+
+MeshData makeSphere(uint32_t rings, uint32_t segments, float radius)
+{
+    MeshData mesh;
+    mesh.vertices.reserve(std::size_t(rings + 1) * (segments + 1));
+    for (uint32_t r = 0; r <= rings; ++r) {
+        const float v = float(r) / float(rings);
+        const float theta = v * math::kPi;
+        for (uint32_t s = 0; s <= segments; ++s) {
+            const float u = float(s) / float(segments);
+            const float phi = u * 2.0f * math::kPi;
+            const Vec3 n{std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi)};
+            mesh.vertices.push_back({n * radius, n, Vec2{u, v}});
+        }
+    }
+
+    const uint32_t stride = segments + 1;
+    for (uint32_t r = 0; r < rings; ++r) {
+        for (uint32_t s = 0; s < segments; ++s) {
+            const uint32_t i0 = r * stride + s, i1 = i0 + 1, i2 = i0 + stride, i3 = i2 + 1;
+            if (r != 0)
+                mesh.indices.insert(mesh.indices.end(), {i0, i2, i1});
+            if (r != rings - 1)
+                mesh.indices.insert(mesh.indices.end(), {i1, i2, i3});
+        }
+    }
+    return mesh;
+}
+
+MeshData makeBox(Vec3 h)
+{
+    MeshData mesh;
+    const Vec3 normals[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    for (const Vec3& n : normals) {
+        // Two tangents spanning the face, ordered so (t1 x t2) == n.
+        const Vec3 t1 = std::fabs(n.y) > 0.5f ? Vec3{0, 0, n.y} : Vec3{-n.z, 0, n.x};
+        const Vec3 t2 = math::cross(n, t1);
+        const uint32_t base = uint32_t(mesh.vertices.size());
+        const Vec2 uvs[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+        const float signs[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+        for (int k = 0; k < 4; ++k) {
+            const Vec3 p = (n + t1 * signs[k][0] + t2 * signs[k][1]) * h;
+            mesh.vertices.push_back({p, n, uvs[k]});
+        }
+        mesh.indices.insert(mesh.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+    return mesh;
+}
+
+MeshData makeGrid(uint32_t cells, float size)
+{
+    MeshData mesh;
+    const float step = size / float(cells);
+    const float half = size * 0.5f;
+    for (uint32_t z = 0; z <= cells; ++z) {
+        for (uint32_t x = 0; x <= cells; ++x) {
+            mesh.vertices.push_back({Vec3{-half + float(x) * step, 0.0f, -half + float(z) * step}, Vec3{0, 1, 0},
+                                     Vec2{float(x), float(z)}});
+        }
+    }
+    const uint32_t stride = cells + 1;
+    for (uint32_t z = 0; z < cells; ++z) {
+        for (uint32_t x = 0; x < cells; ++x) {
+            const uint32_t i0 = z * stride + x, i1 = i0 + 1, i2 = i0 + stride, i3 = i2 + 1;
+            mesh.indices.insert(mesh.indices.end(), {i0, i2, i1, i1, i2, i3});
+        }
+    }
+    return mesh;
+}
+
+} // namespace rebel::render
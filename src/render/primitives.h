@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/math/vec.h"
+#include "render/vertex.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rebel::render {
+
+/// Owning indexed triangle list.
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    MeshView view() const { return {vertices, indices}; }
+};
+
+/// UV sphere with 2 * rings * segments - 2 * segments triangles, CCW front faces.
+MeshData makeSphere(uint32_t rings, uint32_t segments, float radius);
+
+/// Axis-aligned box centred at the origin.
+MeshData makeBox(math::Vec3 halfExtents);
+
+/// Flat grid in the XZ plane facing +Y, `cells` x `cells` quads.
+MeshData makeGrid(uint32_t cells, float size);
+
+} // namespace rebel::render
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/math/mat.h"
+#include "core/math/vec.h"
+#include "render/vertex.h"
+
+#include <cstdint>
+#include <span>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::render {
+
+enum class CullMode : uint8_t {
+    None,
+    Back,
+};
+
+/// One recorded draw. Plain data, so it can be recorded on any worker and
+/// replayed by any backend; mesh memory must outlive the frame.
+struct DrawCommand {
+    MeshView mesh;
+    math::Mat4 model;
+    math::Vec4 color{1.0f, 1.0f, 1.0f, 1.0f};
+    uint32_t material = 0;
+    CullMode cull = CullMode::Back;
+    /// Skinned draws: the first of the mesh's bones in
+    /// RenderFrameParams::bonePalette, so instances can share or pick
+    /// palettes without rebinding.
+    uint32_t paletteOffset = 0;
+};
+
+struct RenderFrameParams {
+    math::Mat4 viewProjection;
+    math::Vec3 lightDirection{0.3f, 0.8f, 0.5f}; // towards the light, world space
+    uint32_t clearColor = 0xFF302820;
+    float clearDepth = 1.0f;
+    /// Skinning matrices for the frame's skinned draws, 3x4 row-major,
+    /// 12 floats per bone. Backends that skin on the GPU upload it as one
+    /// buffer; the software backend skins on the CPU before rasterizing.
+    std::span<const float> bonePalette = {};
+};
+
+/// Consumer of sorted draw streams. RenderQueue::submit() calls beginFrame(),
+/// then setPass()/setMaterial() only when the value changes between
+/// consecutive commands, draw() once per command, and finally endFrame().
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual void beginFrame(const RenderFrameParams& params) = 0;
+    virtual void setPass(uint32_t layer, uint32_t pass) = 0;
+    virtual void setMaterial(uint32_t material) = 0;
+    virtual void draw(const DrawCommand& command) = 0;
+    virtual void endFrame(jobs::JobSystem& jobs) = 0;
+};
+
+struct NullBackendStats {
+    uint64_t draws = 0;
+    uint64_t triangles = 0;
+    uint64_t passChanges = 0;
+    uint64_t materialChanges = 0;
+};
+
+/// Backend that only counts what it is asked to do. Used to measure the
+/// recording/sorting/submission path without any rendering cost.
+class NullBackend final : public RenderBackend {
+public:
+    void beginFrame(const RenderFrameParams&) override { stats_ = {}; }
+    void setPass(uint32_t, uint32_t) override { ++stats_.passChanges; }
+    void setMaterial(uint32_t) override { ++stats_.materialChanges; }
+    void draw(const DrawCommand& command) override
+    {
+        ++stats_.draws;
+        stats_.triangles += command.mesh.triangleCount();
+    }
+    void endFrame(jobs::JobSystem&) override {}
+
+    const NullBackendStats& stats() const { return stats_; }
+
+private:
+    NullBackendStats stats_;
+};
+
+} // namespace rebel::render
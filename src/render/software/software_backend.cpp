@@ -0,0 +1,83 @@
+#include "render/software/software_backend.h"
+
+#include "core/assert.h"
+
+namespace rebel::render {
+
+namespace {
+
+constexpr uint32_t kMatrixFloats = 12;
+
+math::Vec3 transformPoint(const float* m, math::Vec3 p)
+{
+    return {m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3], m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+            m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]};
+}
+
+math::Vec3 transformVector(const float* m, math::Vec3 v)
+{
+    return {m[0] * v.x + m[1] * v.y + m[2] * v.z, m[4] * v.x + m[5] * v.y + m[6] * v.z,
+            m[8] * v.x + m[9] * v.y + m[10] * v.z};
+}
+
+} // namespace
+
+void SoftwareBackend::beginFrame(const RenderFrameParams& params)
+{
+    bonePalette_ = params.bonePalette;
+    skinnedDraws_ = 0;
+    rasterizer_.beginFrame({.viewProjection = params.viewProjection,
+                            .lightDirection = params.lightDirection,
+                            .clearColor = params.clearColor,
+                            .clearDepth = params.clearDepth});
+}
+
+void SoftwareBackend::draw(const DrawCommand& command)
+{
+    REBEL_ASSERT(command.mesh.skinned() || command.paletteOffset == 0, "palette offset on an unskinned mesh");
+    const MeshView mesh = command.mesh.skinned() ? skin(command) : command.mesh;
+    rasterizer_.draw({.mesh = mesh, .model = command.model, .color = command.color, .cull = command.cull});
+}
+
+void SoftwareBackend::endFrame(jobs::JobSystem& jobs)
+{
+    rasterizer_.endFrame(jobs);
+}
+
+MeshView SoftwareBackend::skin(const DrawCommand& command)
+{
+    const MeshView& mesh = command.mesh;
+    const uint32_t influences = mesh.influences;
+    REBEL_ASSERT(mesh.boneIndices.size() >= mesh.vertices.size() * influences &&
+                     mesh.boneWeights.size() >= mesh.vertices.size() * influences,
+                 "skinned meshes need bone indices and weights for every influence");
+
+    if (skinnedDraws_ == skinned_.size())
+        skinned_.emplace_back();
+    std::vector<Vertex>& out = skinned_[skinnedDraws_++];
+    out.resize(mesh.vertices.size());
+
+    const float* palette = bonePalette_.data() + std::size_t(command.paletteOffset) * kMatrixFloats;
+    for (std::size_t v = 0; v < mesh.vertices.size(); ++v) {
+        const Vertex& in = mesh.vertices[v];
+        math::Vec3 position{0.0f, 0.0f, 0.0f};
+        math::Vec3 normal{0.0f, 0.0f, 0.0f};
+        for (uint32_t i = 0; i < influences; ++i) {
+            const uint32_t bone = mesh.boneIndices[v * influences + i];
+            const float weight = mesh.boneWeights[v * influences + i];
+            REBEL_ASSERT((std::size_t(command.paletteOffset) + bone + 1) * kMatrixFloats <= bonePalette_.size(),
+                         "skinned draw reads past the bone palette");
+            const float* m = palette + std::size_t(bone) * kMatrixFloats;
+            position += transformPoint(m, in.position) * weight;
+            normal += transformVector(m, in.normal) * weight;
+        }
+        out[v] = {position, math::normalize(normal, in.normal), in.uv};
+    }
+
+    MeshView result;
+    result.vertices = out;
+    result.indices = mesh.indices;
+    return result;
+}
+
+} // namespace rebel::render
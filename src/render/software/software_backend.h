@@ -0,0 +1,43 @@
+#pragma once
+
+#include "render/render_backend.h"
+#include "render/software/software_rasterizer.h"
+
+#include <span>
+#include <vector>
+
+namespace rebel::render {
+
+/// Adapts SoftwareRasterizer to the RenderBackend interface. The rasterizer
+/// is borrowed so callers can still resolve or inspect it after a frame.
+///
+/// Skinned meshes are skinned on the CPU at draw(): each vertex is blended
+/// through the frame's bone palette starting at the command's
+/// paletteOffset, and the result is kept until the next frame so the
+/// rasterizer can read it in endFrame().
+class SoftwareBackend final : public RenderBackend {
+public:
+    explicit SoftwareBackend(SoftwareRasterizer& rasterizer)
+        : rasterizer_(rasterizer)
+    {
+    }
+
+    void beginFrame(const RenderFrameParams& params) override;
+    void setPass(uint32_t, uint32_t) override {}
+    void setMaterial(uint32_t) override {}
+    void draw(const DrawCommand& command) override;
+    void endFrame(jobs::JobSystem& jobs) override;
+
+    SoftwareRasterizer& rasterizer() { return rasterizer_; }
+
+private:
+    MeshView skin(const DrawCommand& command);
+
+    SoftwareRasterizer& rasterizer_;
+    std::span<const float> bonePalette_;
+    /// Skinned vertices per skinned draw, reused across frames.
+    std::vector<std::vector<Vertex>> skinned_;
+    uint32_t skinnedDraws_ = 0;
+};
+
+} // namespace rebel::render
@@ -0,0 +1,617 @@
+#include "render/software/software_rasterizer.h"
+
+#include "core/assert.h"
+#include "core/jobs/job_system.h"
+#include "core/math/simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace rebel::render {
+
+using math::Float4;
+using math::Vec2;
+using math::Vec3;
+using math::Vec4;
+
+struct SoftwareRasterizer::ClipVertex {
+    Vec4 clip;
+    Vec3 normal;
+    Vec2 uv;
+};
+
+struct SoftwareRasterizer::SetupTriangle {
+    int32_t x[3], y[3]; // 28.4 fixed-point screen position
+    float z[3];         // clip z / w
+    float invW[3];
+    int32_t minX, minY, maxX, maxY; // inclusive pixel bounds, clamped to the viewport
+    uint32_t ref[3];                // vertex references, see kClippedRef
+    uint32_t draw;
+    float zMin;
+};
+
+struct SoftwareRasterizer::Batch {
+    std::vector<SetupTriangle> triangles;
+    std::vector<ClipVertex> clipped;
+    std::vector<std::vector<uint32_t>> bins;
+    uint64_t submitted = 0;
+    uint64_t clippedTriangles = 0;
+};
+
+namespace {
+
+using ClipVertex = SoftwareRasterizer::ClipVertex;
+
+constexpr uint32_t kTilePixels = SoftwareRasterizer::kTileSize * SoftwareRasterizer::kTileSize;
+constexpr uint32_t kTilesPerBin = SoftwareRasterizer::kBinSize / SoftwareRasterizer::kTileSize;
+constexpr int32_t kSubpixel = 16; // 28.4 fixed point
+
+// Vertex references with this bit set index Batch::clipped instead of the
+// frame's transformed vertex array.
+constexpr uint32_t kClippedRef = 0x80000000u;
+
+// Triangles are clipped against a guard band this many pixels beyond the
+// viewport edges, which keeps fixed-point edge values within 32 bits inside a
+// tile and 64 bits anywhere.
+constexpr float kGuardBandPixels = 4096.0f;
+
+// Attribute plane in pixel units: value(px, py) = origin + dx * px + dy * py,
+// with (px, py) relative to the plane's reference pixel.
+struct Plane {
+    float origin, dx, dy;
+};
+
+ClipVertex lerpVertex(const ClipVertex& a, const ClipVertex& b, float t)
+{
+    ClipVertex r;
+    r.clip = a.clip + (b.clip - a.clip) * t;
+    r.normal = a.normal + (b.normal - a.normal) * t;
+    r.uv = a.uv + (b.uv - a.uv) * t;
+    return r;
+}
+
+// Sutherland-Hodgman against the half-space dot(plane, clip) >= 0.
+int clipPolygon(const ClipVertex* in, int count, ClipVertex* out, Vec4 plane)
+{
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        const ClipVertex& a = in[i];
+        const ClipVertex& b = in[(i + 1) % count];
+        const float da = math::dot(plane, a.clip);
+        const float db = math::dot(plane, b.clip);
+        if (da >= 0.0f)
+            out[n++] = a;
+        if ((da >= 0.0f) != (db >= 0.0f))
+            out[n++] = lerpVertex(a, b, da / (da - db));
+    }
+    return n;
+}
+
+uint32_t outcode(const Vec4& c)
+{
+    return (c.x < -c.w ? 1u : 0u) | (c.x > c.w ? 2u : 0u) | (c.y < -c.w ? 4u : 0u) | (c.y > c.w ? 8u : 0u) |
+           (c.z < 0.0f ? 16u : 0u) | (c.z > c.w ? 32u : 0u);
+}
+
+REBEL_FORCEINLINE __m128i packColor(Float4 r, Float4 g, Float4 b, Float4 a)
+{
+    const Float4 scale(255.0f);
+    const Float4 zero = Float4::zero();
+    const Float4 one(1.0f);
+    const __m128i ir = _mm_cvtps_epi32(math::clamp(r, zero, one) * scale);
+    const __m128i ig = _mm_cvtps_epi32(math::clamp(g, zero, one) * scale);
+    const __m128i ib = _mm_cvtps_epi32(math::clamp(b, zero, one) * scale);
+    const __m128i ia = _mm_cvtps_epi32(math::clamp(a, zero, one) * scale);
+    return _mm_or_si128(_mm_or_si128(ir, _mm_slli_epi32(ig, 8)),
+                        _mm_or_si128(_mm_slli_epi32(ib, 16), _mm_slli_epi32(ia, 24)));
+}
+
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer(const SoftwareRasterizerDesc& desc)
+    : width_(desc.width)
+    , height_(desc.height)
+    , depthOnly_(desc.depthOnly)
+    , hierarchicalZ_(desc.hierarchicalZ)
+    , trianglesPerBatch_(std::max(desc.trianglesPerSetupJob, 1u))
+{
+    REBEL_ASSERT(width_ > 0 && height_ > 0 && width_ <= 8192 && height_ <= 8192, "unsupported framebuffer size");
+    tilesX_ = (width_ + kTileSize - 1) / kTileSize;
+    tilesY_ = (height_ + kTileSize - 1) / kTileSize;
+    binsX_ = (width_ + kBinSize - 1) / kBinSize;
+    binsY_ = (height_ + kBinSize - 1) / kBinSize;
+
+    const std::size_t pixels = std::size_t(tilesX_) * tilesY_ * kTilePixels;
+    depth_ = std::make_unique<float[]>(pixels);
+    if (!depthOnly_)
+        color_ = std::make_unique<uint32_t[]>(pixels);
+    tileMaxZ_ = std::make_unique<float[]>(std::size_t(tilesX_) * tilesY_);
+    std::fill_n(depth_.get(), pixels, 1.0f);
+    std::fill_n(tileMaxZ_.get(), std::size_t(tilesX_) * tilesY_, 1.0f);
+}
+
+SoftwareRasterizer::~SoftwareRasterizer() = default;
+
+void SoftwareRasterizer::beginFrame(const SoftwareFrameParams& params)
+{
+    params_ = params;
+    light_ = math::normalize(params.lightDirection, {0.0f, 1.0f, 0.0f});
+    draws_.clear();
+}
+
+void SoftwareRasterizer::draw(const SoftwareDraw& draw)
+{
+    DrawRecord record;
+    record.draw = draw;
+    record.mvp = params_.viewProjection * draw.model;
+    record.normalMatrix = math::transpose(math::inverse(draw.model.upper3x3()));
+    draws_.push_back(record);
+}
+
+void SoftwareRasterizer::endFrame(jobs::JobSystem& jobs)
+{
+    // Lay out every draw's vertices and triangles in one global range so the
+    // phases below can split work evenly regardless of draw sizes.
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+    drawVertexEnd_.clear();
+    drawTriangleEnd_.clear();
+    for (DrawRecord& record : draws_) {
+        record.vertexBase = vertexCount;
+        record.firstTriangle = triangleCount;
+        vertexCount += uint32_t(record.draw.mesh.vertices.size());
+        triangleCount += record.draw.mesh.triangleCount();
+        drawVertexEnd_.push_back(vertexCount);
+        drawTriangleEnd_.push_back(triangleCount);
+    }
+
+    vertices_.resize(vertexCount);
+    jobs.parallelFor(vertexCount, 8192, [this](uint32_t begin, uint32_t end) { transformVertices(begin, end); });
+
+    activeBatches_ = (triangleCount + trianglesPerBatch_ - 1) / trianglesPerBatch_;
+    while (batches_.size() < activeBatches_) {
+        batches_.push_back(std::make_unique<Batch>());
+        batches_.back()->bins.resize(std::size_t(binsX_) * binsY_);
+    }
+    jobs.parallelFor(activeBatches_, 1, [this, triangleCount](uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; ++b) {
+            const uint32_t first = b * trianglesPerBatch_;
+            setupBatch(*batches_[b], first, std::min(first + trianglesPerBatch_, triangleCount));
+        }
+    });
+
+    tilesRasterized_.store(0, std::memory_order_relaxed);
+    tilesHiZRejected_.store(0, std::memory_order_relaxed);
+    jobs.parallelFor(binsX_ * binsY_, 1, [this](uint32_t begin, uint32_t end) {
+        for (uint32_t bin = begin; bin < end; ++bin)
+            rasterizeBin(bin);
+    });
+
+    stats_ = {};
+    stats_.trianglesSubmitted = triangleCount;
+    for (uint32_t b = 0; b < activeBatches_; ++b) {
+        stats_.trianglesBinned += batches_[b]->triangles.size();
+        stats_.trianglesClipped += batches_[b]->clippedTriangles;
+    }
+    stats_.tilesRasterized = tilesRasterized_.load(std::memory_order_relaxed);
+    stats_.tilesHiZRejected = tilesHiZRejected_.load(std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::transformVertices(uint32_t begin, uint32_t end)
+{
+    std::size_t d = std::upper_bound(drawVertexEnd_.begin(), drawVertexEnd_.end(), begin) - drawVertexEnd_.begin();
+    for (uint32_t i = begin; i < end;) {
+        const DrawRecord& record = draws_[d];
+        const uint32_t drawEnd = std::min(end, drawVertexEnd_[d]);
+        const Vertex* src = record.draw.mesh.vertices.data() - record.vertexBase;
+        for (; i < drawEnd; ++i) {
+            ClipVertex& out = vertices_[i];
+            out.clip = record.mvp * Vec4(src[i].position, 1.0f);
+            out.normal = record.normalMatrix * src[i].normal;
+            out.uv = src[i].uv;
+        }
+        ++d;
+    }
+}
+
+void SoftwareRasterizer::setupBatch(Batch& batch, uint32_t firstTriangle, uint32_t lastTriangle)
+{
+    batch.triangles.clear();
+    batch.clipped.clear();
+    for (std::vector<uint32_t>& bin : batch.bins)
+        bin.clear();
+    batch.submitted = lastTriangle - firstTriangle;
+    batch.clippedTriangles = 0;
+
+    const float guardX = kGuardBandPixels * 2.0f / float(width_) + 1.0f;
+    const float guardY = kGuardBandPixels * 2.0f / float(height_) + 1.0f;
+    const Vec4 clipPlanes[5] = {
+        {0.0f, 0.0f, 1.0f, 0.0f},    // near: z >= 0
+        {1.0f, 0.0f, 0.0f, guardX},  // x >= -guard * w
+        {-1.0f, 0.0f, 0.0f, guardX}, // x <= guard * w
+        {0.0f, 1.0f, 0.0f, guardY},
+        {0.0f, -1.0f, 0.0f, guardY},
+    };
+
+    std::size_t d =
+        std::upper_bound(drawTriangleEnd_.begin(), drawTriangleEnd_.end(), firstTriangle) - drawTriangleEnd_.begin();
+    for (uint32_t t = firstTriangle; t < lastTriangle;) {
+        const DrawRecord& record = draws_[d];
+        const uint32_t drawEnd = std::min(lastTriangle, drawTriangleEnd_[d]);
+        const uint32_t* indices = record.draw.mesh.indices.data();
+        for (; t < drawEnd; ++t) {
+            const uint32_t local = t - record.firstTriangle;
+            uint32_t refs[3];
+            const ClipVertex* v[3];
+            for (int k = 0; k < 3; ++k) {
+                refs[k] = record.vertexBase + indices[local * 3 + k];
+                v[k] = &vertices_[refs[k]];
+            }
+
+            const uint32_t c0 = outcode(v[0]->clip), c1 = outcode(v[1]->clip), c2 = outcode(v[2]->clip);
+            if (c0 & c1 & c2)
+                continue; // entirely outside one frustum plane
+
+            bool needsClip = ((c0 | c1 | c2) & 16u) != 0;
+            for (int k = 0; k < 3 && !needsClip; ++k) {
+                const Vec4& c = v[k]->clip;
+                needsClip = std::fabs(c.x) > guardX * c.w || std::fabs(c.y) > guardY * c.w;
+            }
+
+            if (!needsClip) {
+                emitTriangle(batch, v, refs, uint32_t(d), record.draw.cull);
+                continue;
+            }
+
+            ClipVertex polyA[16], polyB[16];
+            ClipVertex* in = polyA;
+            ClipVertex* out = polyB;
+            int count = 3;
+            for (int k = 0; k < 3; ++k)
+                in[k] = *v[k];
+            for (const Vec4& plane : clipPlanes) {
+                count = clipPolygon(in, count, out, plane);
+                std::swap(in, out);
+                if (count < 3)
+                    break;
+            }
+            if (count < 3)
+                continue;
+
+            ++batch.clippedTriangles;
+            const uint32_t base = uint32_t(batch.clipped.size());
+            batch.clipped.insert(batch.clipped.end(), in, in + count);
+            for (int k = 1; k + 1 < count; ++k) {
+                const uint32_t fanRefs[3] = {kClippedRef | base, kClippedRef | (base + uint32_t(k)),
+                                             kClippedRef | (base + uint32_t(k) + 1)};
+                const ClipVertex* fan[3] = {&in[0], &in[k], &in[k + 1]};
+                emitTriangle(batch, fan, fanRefs, uint32_t(d), record.draw.cull);
+            }
+        }
+        ++d;
+    }
+}
+
+void SoftwareRasterizer::emitTriangle(Batch& batch, const ClipVertex* const v[3], const uint32_t refs[3],
+                                      uint32_t drawIndex, CullMode cull)
+{
+    SetupTriangle tri;
+    for (int k = 0; k < 3; ++k) {
+        const Vec4& c = v[k]->clip;
+        const float invW = 1.0f / c.w;
+        const float sx = (c.x * invW * 0.5f + 0.5f) * float(width_);
+        const float sy = (0.5f - c.y * invW * 0.5f) * float(height_);
+        tri.x[k] = _mm_cvtss_si32(_mm_set_ss(sx * float(kSubpixel))); // round to nearest
+        tri.y[k] = _mm_cvtss_si32(_mm_set_ss(sy * float(kSubpixel)));
+        tri.z[k] = c.z * invW;
+        tri.invW[k] = invW;
+        tri.ref[k] = refs[k];
+    }
+
+    const int64_t area = int64_t(tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+                         int64_t(tri.y[1] - tri.y[0]) * (tri.x[2] - tri.x[0]);
+    if (area == 0)
+        return;
+    // Counter-clockwise in NDC (front-facing) has negative area in y-down
+    // screen space; flip those so every stored triangle has positive area.
+    if (area > 0) {
+        if (cull == CullMode::Back)
+            return;
+    }
+    if (area < 0) {
+        std::swap(tri.x[1], tri.x[2]);
+        std::swap(tri.y[1], tri.y[2]);
+        std::swap(tri.z[1], tri.z[2]);
+        std::swap(tri.invW[1], tri.invW[2]);
+        std::swap(tri.ref[1], tri.ref[2]);
+    }
+
+    const int32_t minXf = std::min({tri.x[0], tri.x[1], tri.x[2]});
+    const int32_t maxXf = std::max({tri.x[0], tri.x[1], tri.x[2]});
+    const int32_t minYf = std::min({tri.y[0], tri.y[1], tri.y[2]});
+    const int32_t maxYf = std::max({tri.y[0], tri.y[1], tri.y[2]});
+    // Pixel centres sit at +8 in 28.4; keep only pixels whose centre is inside the bounds.
+    tri.minX = std::max((minXf - kSubpixel / 2 + kSubpixel - 1) >> 4, 0);
+    tri.minY = std::max((minYf - kSubpixel / 2 + kSubpixel - 1) >> 4, 0);
+    tri.maxX = std::min((maxXf - kSubpixel / 2) >> 4, int32_t(width_) - 1);
+    tri.maxY = std::min((maxYf - kSubpixel / 2) >> 4, int32_t(height_) - 1);
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+        return;
+
+    tri.draw = drawIndex;
+    tri.zMin = std::max(0.0f, std::min({tri.z[0], tri.z[1], tri.z[2]}));
+
+    const uint32_t index = uint32_t(batch.triangles.size());
+    batch.triangles.push_back(tri);
+
+    const uint32_t bx0 = uint32_t(tri.minX) / kBinSize, bx1 = uint32_t(tri.maxX) / kBinSize;
+    const uint32_t by0 = uint32_t(tri.minY) / kBinSize, by1 = uint32_t(tri.maxY) / kBinSize;
+    for (uint32_t by = by0; by <= by1; ++by) {
+        for (uint32_t bx = bx0; bx <= bx1; ++bx)
+            batch.bins[by * binsX_ + bx].push_back(index);
+    }
+}
+
+void SoftwareRasterizer::rasterizeBin(uint32_t bin)
+{
+    const uint32_t binX = bin % binsX_;
+    const uint32_t binY = bin / binsX_;
+    const uint32_t tx0 = binX * kTilesPerBin, tx1 = std::min(tx0 + kTilesPerBin, tilesX_);
+    const uint32_t ty0 = binY * kTilesPerBin, ty1 = std::min(ty0 + kTilesPerBin, tilesY_);
+
+    // Each bin clears its own tiles, so clearing is parallel and cache-warm.
+    for (uint32_t ty = ty0; ty < ty1; ++ty) {
+        for (uint32_t tx = tx0; tx < tx1; ++tx) {
+            const std::size_t tile = std::size_t(ty) * tilesX_ + tx;
+            std::fill_n(depth_.get() + tile * kTilePixels, kTilePixels, params_.clearDepth);
+            if (color_)
+                std::fill_n(color_.get() + tile * kTilePixels, kTilePixels, params_.clearColor);
+            tileMaxZ_[tile] = params_.clearDepth;
+        }
+    }
+
+    uint64_t tiles = 0;
+    uint64_t hizRejects = 0;
+    for (uint32_t b = 0; b < activeBatches_; ++b) {
+        const Batch& batch = *batches_[b];
+        for (const uint32_t index : batch.bins[bin])
+            rasterizeTriangle(bin, batch, batch.triangles[index], tiles, hizRejects);
+    }
+    tilesRasterized_.fetch_add(tiles, std::memory_order_relaxed);
+    tilesHiZRejected_.fetch_add(hizRejects, std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::rasterizeTriangle(uint32_t bin, const Batch& batch, const SetupTriangle& tri,
+                                           uint64_t& tiles, uint64_t& hizRejects)
+{
+    const int32_t binX0 = int32_t((bin % binsX_) * kBinSize);
+    const int32_t binY0 = int32_t((bin / binsX_) * kBinSize);
+    const int32_t x0 = std::max(tri.minX, binX0);
+    const int32_t y0 = std::max(tri.minY, binY0);
+    const int32_t x1 = std::min(tri.maxX, binX0 + int32_t(kBinSize) - 1);
+    const int32_t y1 = std::min(tri.maxY, binY0 + int32_t(kBinSize) - 1);
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    // Edge i runs from vertex i to vertex i+1: E(p) = A*px + B*py + C in 28.4
+    // units, positive inside. The top-left rule biases non top-left edges by
+    // -1 so pixels exactly on a shared edge are drawn once.
+    int64_t A[3], B[3], C[3];
+    int32_t bias[3];
+    for (int i = 0; i < 3; ++i) {
+        const int j = (i + 1) % 3;
+        const int32_t dx = tri.x[j] - tri.x[i];
+        const int32_t dy = tri.y[j] - tri.y[i];
+        A[i] = -int64_t(dy);
+        B[i] = dx;
+        C[i] = -A[i] * tri.x[i] - B[i] * tri.y[i];
+        bias[i] = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1;
+    }
+    const int64_t area = A[0] * tri.x[2] + B[0] * tri.y[2] + C[0];
+
+    auto edgeAt = [&](int i, int32_t px, int32_t py) {
+        return A[i] * (int64_t(px) * kSubpixel + kSubpixel / 2) + B[i] * (int64_t(py) * kSubpixel + kSubpixel / 2) +
+               C[i] + bias[i];
+    };
+
+    // Barycentric weights of vertices 1 and 2 come from edges 2 and 0; build
+    // every interpolated attribute as a plane relative to pixel (x0, y0).
+    const double invArea = 1.0 / double(area);
+    const double b1 = double(edgeAt(2, x0, y0) - bias[2]) * invArea;
+    const double b2 = double(edgeAt(0, x0, y0) - bias[0]) * invArea;
+    const double b1dx = double(A[2] * kSubpixel) * invArea, b1dy = double(B[2] * kSubpixel) * invArea;
+    const double b2dx = double(A[0] * kSubpixel) * invArea, b2dy = double(B[0] * kSubpixel) * invArea;
+    auto makePlane = [&](float f0, float f1, float f2) {
+        const double d1 = double(f1) - f0, d2 = double(f2) - f0;
+        return Plane{float(f0 + d1 * b1 + d2 * b2), float(d1 * b1dx + d2 * b2dx), float(d1 * b1dy + d2 * b2dy)};
+    };
+
+    const Plane zPlane = makePlane(tri.z[0], tri.z[1], tri.z[2]);
+
+    Plane wPlane{}, nxPlane{}, nyPlane{}, nzPlane{}, uPlane{}, vPlane{};
+    Float4 baseColor[4] = {Float4::zero(), Float4::zero(), Float4::zero(), Float4::zero()};
+    if (!depthOnly_) {
+        const ClipVertex* v[3];
+        for (int k = 0; k < 3; ++k)
+            v[k] = (tri.ref[k] & kClippedRef) ? &batch.clipped[tri.ref[k] & ~kClippedRef] : &vertices_[tri.ref[k]];
+        const float* w = tri.invW;
+        wPlane = makePlane(w[0], w[1], w[2]);
+        nxPlane = makePlane(v[0]->normal.x * w[0], v[1]->normal.x * w[1], v[2]->normal.x * w[2]);
+        nyPlane = makePlane(v[0]->normal.y * w[0], v[1]->normal.y * w[1], v[2]->normal.y * w[2]);
+        nzPlane = makePlane(v[0]->normal.z * w[0], v[1]->normal.z * w[1], v[2]->normal.z * w[2]);
+        uPlane = makePlane(v[0]->uv.x * w[0], v[1]->uv.x * w[1], v[2]->uv.x * w[2]);
+        vPlane = makePlane(v[0]->uv.y * w[0], v[1]->uv.y * w[1], v[2]->uv.y * w[2]);
+        const Vec4& c = draws_[tri.draw].draw.color;
+        baseColor[0] = Float4(c.x);
+        baseColor[1] = Float4(c.y);
+        baseColor[2] = Float4(c.z);
+        baseColor[3] = Float4(c.w);
+    }
+
+    const Float4 laneOffset(0.0f, 1.0f, 2.0f, 3.0f);
+    const int64_t stepX[3] = {A[0] * kSubpixel, A[1] * kSubpixel, A[2] * kSubpixel};
+    const int64_t stepY[3] = {B[0] * kSubpixel, B[1] * kSubpixel, B[2] * kSubpixel};
+    const int32_t tileSpan = int32_t(kTileSize) - 1;
+
+    for (int32_t ty = y0 / int32_t(kTileSize); ty <= y1 / int32_t(kTileSize); ++ty) {
+        for (int32_t tx = x0 / int32_t(kTileSize); tx <= x1 / int32_t(kTileSize); ++tx) {
+            const std::size_t tile = std::size_t(ty) * tilesX_ + std::size_t(tx);
+            if (hierarchicalZ_ && tri.zMin >= tileMaxZ_[tile]) {
+                ++hizRejects;
+                continue;
+            }
+
+            const int32_t px = tx * int32_t(kTileSize);
+            const int32_t py = ty * int32_t(kTileSize);
+            int64_t e[3];
+            bool inside[3];
+            bool reject = false;
+            for (int i = 0; i < 3; ++i) {
+                e[i] = edgeAt(i, px, py);
+                const int64_t hi =
+                    e[i] + (std::max<int64_t>(stepX[i], 0) + std::max<int64_t>(stepY[i], 0)) * tileSpan;
+                const int64_t lo =
+                    e[i] + (std::min<int64_t>(stepX[i], 0) + std::min<int64_t>(stepY[i], 0)) * tileSpan;
+                reject |= hi < 0;
+                inside[i] = lo >= 0;
+            }
+            if (reject)
+                continue;
+            ++tiles;
+            const bool full = inside[0] && inside[1] && inside[2];
+
+            // Restrict the walk to the rows and 4-pixel halves that overlap
+            // the triangle's bounds; small triangles rarely span a whole tile.
+            const int32_t rowBegin = std::max(y0 - py, 0);
+            const int32_t rowEnd = std::min(y1 - py, tileSpan);
+            const int32_t halfBegin = std::max(x0 - px, 0) / 4;
+            const int32_t halfEnd = std::min(x1 - px, tileSpan) / 4;
+
+            // Only edges that straddle the tile are evaluated per pixel; their
+            // values over the tile are bounded by the tile's edge span and
+            // fit comfortably in 32 bits. Edges fully inside contribute zero.
+            __m128i eRow[3] = {}, eStepX4[3] = {}, eStepY[3] = {};
+            if (!full) {
+                for (int i = 0; i < 3; ++i) {
+                    if (inside[i])
+                        continue;
+                    const int32_t sx = int32_t(stepX[i]);
+                    const int64_t start = e[i] + stepY[i] * rowBegin;
+                    eRow[i] = _mm_add_epi32(_mm_set1_epi32(int32_t(start)), _mm_setr_epi32(0, sx, sx * 2, sx * 3));
+                    eStepX4[i] = _mm_set1_epi32(sx * 4);
+                    eStepY[i] = _mm_set1_epi32(int32_t(stepY[i]));
+                }
+            }
+
+            const float ox = float(px - x0), oy = float(py - y0);
+            float* depth = depth_.get() + tile * kTilePixels;
+            uint32_t* color = color_ ? color_.get() + tile * kTilePixels : nullptr;
+            bool wrote = false;
+
+            for (int32_t row = rowBegin; row <= rowEnd; ++row) {
+                const float fy = oy + float(row);
+                for (int32_t half = halfBegin; half <= halfEnd; ++half) {
+                    const float fx = ox + float(half * 4);
+
+                    Float4 coverage;
+                    if (full) {
+                        coverage = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                    } else {
+                        __m128i e0 = eRow[0], e1 = eRow[1], e2 = eRow[2];
+                        if (half) {
+                            e0 = _mm_add_epi32(e0, eStepX4[0]);
+                            e1 = _mm_add_epi32(e1, eStepX4[1]);
+                            e2 = _mm_add_epi32(e2, eStepX4[2]);
+                        }
+                        const __m128i outside = _mm_srai_epi32(_mm_or_si128(_mm_or_si128(e0, e1), e2), 31);
+                        coverage = _mm_castsi128_ps(_mm_xor_si128(outside, _mm_set1_epi32(-1)));
+                    }
+                    if (math::moveMask(coverage) == 0)
+                        continue;
+
+                    const Float4 lx = Float4(fx) + laneOffset;
+                    const Float4 ly(fy);
+                    const Float4 z = Float4(zPlane.origin) + lx * Float4(zPlane.dx) + ly * Float4(zPlane.dy);
+                    float* depthPtr = depth + row * int32_t(kTileSize) + half * 4;
+                    const Float4 oldDepth = Float4::loadAligned(depthPtr);
+                    const Float4 pass = coverage & math::cmpLt(z, oldDepth);
+                    if (math::moveMask(pass) == 0)
+                        continue;
+
+                    math::select(pass, z, oldDepth).storeAligned(depthPtr);
+                    wrote = true;
+                    if (!color)
+                        continue;
+
+                    auto eval = [&](const Plane& p) {
+                        return Float4(p.origin) + lx * Float4(p.dx) + ly * Float4(p.dy);
+                    };
+                    const Float4 w = math::reciprocal(eval(wPlane));
+                    Float4 nx = eval(nxPlane) * w, ny = eval(nyPlane) * w, nz = eval(nzPlane) * w;
+                    const Float4 invLen = math::rsqrt(math::max(nx * nx + ny * ny + nz * nz, Float4(1e-12f)));
+                    nx *= invLen;
+                    ny *= invLen;
+                    nz *= invLen;
+                    const Float4 ndl =
+                        math::max(nx * Float4(light_.x) + ny * Float4(light_.y) + nz * Float4(light_.z), Float4::zero());
+                    Float4 shade = Float4(0.25f) + Float4(0.75f) * ndl;
+
+                    // Checker from perspective-correct UVs; 1024 keeps the
+                    // truncating conversion a floor for small negative UVs.
+                    const __m128i iu = _mm_cvttps_epi32(eval(uPlane) * w * Float4(8.0f) + Float4(1024.0f));
+                    const __m128i iv = _mm_cvttps_epi32(eval(vPlane) * w * Float4(8.0f) + Float4(1024.0f));
+                    const __m128i parity = _mm_and_si128(_mm_add_epi32(iu, iv), _mm_set1_epi32(1));
+                    const Float4 odd = _mm_castsi128_ps(_mm_cmpeq_epi32(parity, _mm_set1_epi32(1)));
+                    shade = shade * math::select(odd, Float4(0.8f), Float4(1.0f));
+
+                    const __m128i rgba =
+                        packColor(baseColor[0] * shade, baseColor[1] * shade, baseColor[2] * shade, baseColor[3]);
+                    uint32_t* colorPtr = color + row * int32_t(kTileSize) + half * 4;
+                    const __m128i old = _mm_load_si128(reinterpret_cast<const __m128i*>(colorPtr));
+                    const __m128i mask = _mm_castps_si128(pass);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(colorPtr),
+                                    _mm_or_si128(_mm_and_si128(mask, rgba), _mm_andnot_si128(mask, old)));
+                }
+                if (!full) {
+                    for (int i = 0; i < 3; ++i)
+                        eRow[i] = _mm_add_epi32(eRow[i], eStepY[i]);
+                }
+            }
+
+            if (wrote) {
+                Float4 m = Float4::loadAligned(depth);
+                for (uint32_t i = 4; i < kTilePixels; i += 4)
+                    m = math::max(m, Float4::loadAligned(depth + i));
+                tileMaxZ_[tile] = math::horizontalMax(m);
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::resolve(Image& out) const
+{
+    out.resize(width_, height_);
+    if (!color_)
+        return;
+    for (uint32_t y = 0; y < height_; ++y) {
+        for (uint32_t x = 0; x < width_; ++x) {
+            const std::size_t tile = std::size_t(y / kTileSize) * tilesX_ + x / kTileSize;
+            out.pixels[std::size_t(y) * width_ + x] = color_[tile * kTilePixels + (y % kTileSize) * kTileSize + x % kTileSize];
+        }
+    }
+}
+
+void SoftwareRasterizer::resolveDepth(std::vector<float>& out) const
+{
+    out.resize(std::size_t(width_) * height_);
+    for (uint32_t y = 0; y < height_; ++y) {
+        for (uint32_t x = 0; x < width_; ++x) {
+            const std::size_t tile = std::size_t(y / kTileSize) * tilesX_ + x / kTileSize;
+            out[std::size_t(y) * width_ + x] = depth_[tile * kTilePixels + (y % kTileSize) * kTileSize + x % kTileSize];
+        }
+    }
+}
+
+} // namespace rebel::render
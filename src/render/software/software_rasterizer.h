@@ -0,0 +1,149 @@
+#pragma once
+
+#include "core/math/mat.h"
+#include "core/math/vec.h"
+#include "render/image.h"
+#include "render/render_backend.h"
+#include "render/vertex.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rebel::jobs {
+class JobSystem;
+}
+
+namespace rebel::render {
+
+struct SoftwareRasterizerDesc {
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    /// Skip shading and colour writes entirely (occluder and shadow passes).
+    bool depthOnly = false;
+    /// Reject tiles whose farthest depth is nearer than a triangle before
+    /// any per-pixel work. Turning it off gives the reference output HiZ
+    /// must reproduce; tileMaxDepth() is kept either way.
+    bool hierarchicalZ = true;
+    /// Triangles per setup job. Each job bins into its own lists, and bins
+    /// replay jobs in order, so draw order is preserved.
+    uint32_t trianglesPerSetupJob = 16 * 1024;
+};
+
+struct SoftwareFrameParams {
+    math::Mat4 viewProjection;
+    math::Vec3 lightDirection{0.3f, 0.8f, 0.5f}; // towards the light, world space
+    uint32_t clearColor = 0xFF302820;
+    float clearDepth = 1.0f;
+};
+
+struct SoftwareDraw {
+    MeshView mesh;
+    math::Mat4 model;
+    math::Vec4 color{1.0f, 1.0f, 1.0f, 1.0f};
+    CullMode cull = CullMode::Back;
+};
+
+struct SoftwareRasterizerStats {
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesBinned = 0;
+    uint64_t trianglesClipped = 0;
+    uint64_t tilesRasterized = 0;
+    uint64_t tilesHiZRejected = 0;
+};
+
+/// Tile-based, multithreaded CPU rasterizer.
+///
+/// A frame runs in three parallel phases on the job system:
+///   1. vertex transform into clip space;
+///   2. triangle setup (frustum reject, near/guard-band clipping, backface
+///      cull, snapping to 28.4 fixed point), binned into 64x64 pixel bins;
+///   3. one job per bin walks its triangles over 8x8 pixel tiles. Each tile
+///      keeps its farthest depth (hierarchical Z) to reject occluded
+///      triangles before any per-pixel work. Partially covered tiles run
+///      4-wide SSE integer edge functions with the top-left fill rule, and
+///      attributes are interpolated perspective-correctly.
+///
+/// Colour and depth are stored tile-major (each 8x8 tile contiguous); use
+/// resolve()/resolveDepth() to get row-major images. Depth follows the D3D
+/// convention: clip z/w in [0, 1], less-than test.
+class SoftwareRasterizer {
+public:
+    static constexpr uint32_t kTileSize = 8;
+    static constexpr uint32_t kBinSize = 64;
+
+    explicit SoftwareRasterizer(const SoftwareRasterizerDesc& desc = {});
+    ~SoftwareRasterizer();
+
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+
+    void beginFrame(const SoftwareFrameParams& params);
+    /// Records a draw; mesh memory must stay alive until endFrame() returns.
+    void draw(const SoftwareDraw& draw);
+    /// Renders every recorded draw.
+    void endFrame(jobs::JobSystem& jobs);
+
+    void resolve(Image& out) const;
+    /// Row-major copy of the depth buffer.
+    void resolveDepth(std::vector<float>& out) const;
+
+    /// Farthest depth in each 8x8 tile, tilesX() * tilesY() entries, row-major.
+    const float* tileMaxDepth() const { return tileMaxZ_.get(); }
+    uint32_t tilesX() const { return tilesX_; }
+    uint32_t tilesY() const { return tilesY_; }
+
+    const SoftwareRasterizerStats& stats() const { return stats_; }
+
+    struct ClipVertex;
+    struct SetupTriangle;
+    struct Batch;
+
+private:
+    struct DrawRecord {
+        SoftwareDraw draw;
+        math::Mat4 mvp;
+        math::Mat3 normalMatrix;
+        uint32_t vertexBase = 0;
+        uint32_t firstTriangle = 0;
+    };
+
+    void transformVertices(uint32_t begin, uint32_t end);
+    void setupBatch(Batch& batch, uint32_t firstTriangle, uint32_t lastTriangle);
+    void emitTriangle(Batch& batch, const ClipVertex* const v[3], const uint32_t refs[3], uint32_t drawIndex,
+                      CullMode cull);
+    void rasterizeBin(uint32_t bin);
+    void rasterizeTriangle(uint32_t bin, const Batch& batch, const SetupTriangle& tri, uint64_t& tiles,
+                           uint64_t& hizRejects);
+
+    uint32_t width_;
+    uint32_t height_;
+    bool depthOnly_;
+    bool hierarchicalZ_;
+    uint32_t trianglesPerBatch_;
+    uint32_t tilesX_, tilesY_;
+    uint32_t binsX_, binsY_;
+
+    std::unique_ptr<float[]> depth_;
+    std::unique_ptr<uint32_t[]> color_;
+    std::unique_ptr<float[]> tileMaxZ_;
+
+    SoftwareFrameParams params_;
+    math::Vec3 light_;
+    std::vector<DrawRecord> draws_;
+    std::vector<ClipVertex> vertices_;
+    std::vector<uint32_t> drawVertexEnd_;
+    std::vector<uint32_t> drawTriangleEnd_;
+    std::vector<std::unique_ptr<Batch>> batches_;
+    uint32_t activeBatches_ = 0;
+
+    std::atomic<uint64_t> tilesRasterized_{0};
+    std::atomic<uint64_t> tilesHiZRejected_{0};
+    SoftwareRasterizerStats stats_;
+};
+
+} // namespace rebel::render
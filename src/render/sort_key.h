@@ -0,0 +1,45 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace rebel::render {
+
+/// 64-bit draw sort key. Sorting ascending groups draws by layer, then pass,
+/// then whichever of material/depth matters most for that kind of geometry:
+///
+///   opaque:      | layer:4 | pass:4 | material:24 | depth:32 |   material first, front to back
+///   translucent: | layer:4 | pass:4 | ~depth:32   | material:24 | back to front
+///
+/// Depth is the float bit pattern of a non-negative view distance, which
+/// orders the same way as the float value.
+namespace sortkey {
+
+inline constexpr uint32_t kLayerBits = 4;
+inline constexpr uint32_t kPassBits = 4;
+inline constexpr uint32_t kMaterialBits = 24;
+inline constexpr uint32_t kMaxMaterial = (1u << kMaterialBits) - 1;
+
+inline uint32_t depthBits(float viewDepth)
+{
+    return std::bit_cast<uint32_t>(viewDepth > 0.0f ? viewDepth : 0.0f);
+}
+
+inline uint64_t opaque(uint32_t layer, uint32_t pass, uint32_t material, float viewDepth)
+{
+    return (uint64_t(layer & 0xF) << 60) | (uint64_t(pass & 0xF) << 56) | (uint64_t(material & kMaxMaterial) << 32) |
+           depthBits(viewDepth);
+}
+
+inline uint64_t translucent(uint32_t layer, uint32_t pass, uint32_t material, float viewDepth)
+{
+    return (uint64_t(layer & 0xF) << 60) | (uint64_t(pass & 0xF) << 56) | (uint64_t(~depthBits(viewDepth)) << 24) |
+           (material & kMaxMaterial);
+}
+
+constexpr uint32_t layer(uint64_t key) { return uint32_t(key >> 60); }
+constexpr uint32_t pass(uint64_t key) { return uint32_t(key >> 56) & 0xF; }
+
+} // namespace sortkey
+
+} // namespace rebel::render
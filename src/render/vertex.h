@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/math/vec.h"
+
+#include <cstdint>
+#include <span>
+
+namespace rebel::render {
+
+/// Interleaved vertex format shared by every renderer backend.
+struct Vertex {
+    math::Vec3 position;
+    math::Vec3 normal;
+    math::Vec2 uv;
+};
+static_assert(sizeof(Vertex) == 32);
+
+/// Non-owning view of an indexed triangle list.
+struct MeshView {
+    std::span<const Vertex> vertices;
+    std::span<const uint32_t> indices;
+    /// Skinned meshes only: `influences` bone indices and weights per
+    /// vertex, vertex-major. Bone indices are relative to the draw's
+    /// DrawCommand::paletteOffset.
+    std::span<const uint16_t> boneIndices = {};
+    std::span<const float> boneWeights = {};
+    uint32_t influences = 0;
+
+    bool skinned() const { return influences != 0; }
+    uint32_t triangleCount() const { return uint32_t(indices.size() / 3); }
+};
+
+} // namespace rebel::render
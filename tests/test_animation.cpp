@@ -0,0 +1,141 @@
+#include "test_common.h"
+
+#include "animation/clip/animation_clip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// A cooked clip played back at its source frames stays within the cook
+// tolerances plus quantization of every source transform, for static,
+// constant and animated tracks, and beyond the end it holds the last frame.
+// Jitter below the tolerance does not stop keyframe reduction.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr uint32_t kBones = 24;
+constexpr uint32_t kFrames = 75; // not a whole number of segments
+constexpr float kFrameRate = 30.0f;
+
+// Bone 0 translates, rotates and scales; bones 1-3 are static, 4-7 hold a
+// constant offset and turn, and the rest rotate at assorted rates, with
+// sharp turns every so often that keyframe reduction must keep.
+std::vector<animation::Transform> makeSamples()
+{
+    std::vector<animation::Transform> samples(std::size_t(kFrames) * kBones);
+    for (uint32_t f = 0; f < kFrames; ++f) {
+        const float t = float(f) / kFrameRate;
+        for (uint32_t b = 0; b < kBones; ++b) {
+            animation::Transform& out = samples[std::size_t(f) * kBones + b];
+            const Vec3 axis = math::normalize(Vec3{float(b % 3), 1.0f, float(b % 5) - 2.0f}, {0.0f, 1.0f, 0.0f});
+            if (b == 0) {
+                out.translation = {0.3f * std::sin(2.0f * t), 0.9f + 0.05f * std::sin(9.0f * t), 1.5f * t};
+                out.rotation = Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.4f * std::sin(3.0f * t));
+                out.scale = Vec3{1.0f, 1.0f, 1.0f} * (1.0f + 0.1f * std::sin(t));
+            } else if (b >= 4 && b < 8) {
+                out.translation = {0.0f, 0.1f * float(b), 0.0f};
+                out.rotation = Quat::fromAxisAngle(axis, 0.25f);
+            } else if (b >= 8) {
+                const float angle = 0.6f * std::sin(float(b) * 0.37f * t + float(b)) + (f % 19 == 0 ? 0.2f : 0.0f);
+                out.translation = {0.0f, 0.1f, 0.0f};
+                out.rotation = Quat::fromAxisAngle(axis, angle);
+            }
+        }
+    }
+    return samples;
+}
+
+float rotationError(Quat a, Quat b)
+{
+    if (math::dot(a, b) < 0.0f)
+        b = -b;
+    // From the chord, 2 sin(angle / 4), as acos is too coarse near zero.
+    const Quat chord = a + (-b);
+    return 4.0f * std::asin(std::min(std::sqrt(math::dot(chord, chord)) * 0.5f, 1.0f));
+}
+
+void testRoundTrip()
+{
+    const std::vector<animation::Transform> samples = makeSamples();
+    const animation::AnimationClipDesc desc{
+        .bones = kBones, .frames = kFrames, .frameRate = kFrameRate, .samples = samples};
+    const animation::AnimationClip clip(desc);
+    const animation::AnimationClipStats& stats = clip.stats();
+    REBEL_CHECK(stats.staticTracks >= 3 * 3);
+    REBEL_CHECK(stats.keys < stats.sourceKeys);
+    REBEL_CHECK(clip.memoryUsage() < clip.rawSize());
+    REBEL_CHECK(std::abs(clip.duration() - float(kFrames - 1) / kFrameRate) < 1e-6f);
+
+    // Tolerances plus what 15-bit rotation and 16-bit translation and scale
+    // quantization adds over these tracks' ranges.
+    const float maxRotation = desc.rotationTolerance + 1e-4f;
+    const float maxTranslation = desc.translationTolerance + 5e-5f;
+    const float maxScale = desc.scaleTolerance + 1e-5f;
+    std::vector<animation::Transform> pose(kBones);
+    float rotation = 0.0f, translation = 0.0f, scale = 0.0f;
+    for (uint32_t f = 0; f < kFrames; ++f) {
+        clip.sample(float(f) / kFrameRate, pose);
+        for (uint32_t b = 0; b < kBones; ++b) {
+            const animation::Transform& expected = samples[std::size_t(f) * kBones + b];
+            rotation = std::max(rotation, rotationError(pose[b].rotation, expected.rotation));
+            translation = std::max(translation, math::length(pose[b].translation - expected.translation));
+            scale = std::max(scale, math::length(pose[b].scale - expected.scale));
+        }
+    }
+    REBEL_CHECK(rotation <= maxRotation);
+    REBEL_CHECK(translation <= maxTranslation);
+    REBEL_CHECK(scale <= maxScale);
+
+    // Static tracks come back exactly.
+    clip.sample(0.5f, pose);
+    REBEL_CHECK(pose[1].rotation.w == 1.0f && pose[1].translation.x == 0.0f && pose[1].scale.y == 1.0f);
+
+    // Times past either end clamp to the first and last frames.
+    std::vector<animation::Transform> end(kBones);
+    clip.sample(clip.duration(), end);
+    clip.sample(clip.duration() + 1.0f, pose);
+    for (uint32_t b = 0; b < kBones; ++b)
+        REBEL_CHECK(rotationError(pose[b].rotation, end[b].rotation) == 0.0f);
+    clip.sample(0.0f, end);
+    clip.sample(-1.0f, pose);
+    for (uint32_t b = 0; b < kBones; ++b)
+        REBEL_CHECK(math::length(pose[b].translation - end[b].translation) == 0.0f);
+}
+
+// A steady turn with alternating jitter of 0.6 x the tolerance: a key at
+// a source frame carries the jitter, so interpolating from one misses the
+// next frame's by more than the tolerance, but keys fitted to the frames
+// between them follow the turn.
+void testJitterIsReduced()
+{
+    constexpr uint32_t kJitterFrames = 61;
+    const animation::AnimationClipDesc defaults;
+    const float jitter = 0.6f * defaults.rotationTolerance;
+    std::vector<animation::Transform> samples(kJitterFrames);
+    for (uint32_t f = 0; f < kJitterFrames; ++f) {
+        const float angle = 0.5f * float(f) / kFrameRate + (f % 2 ? jitter : -jitter);
+        samples[f].rotation = Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, angle);
+    }
+    const animation::AnimationClip clip(
+        {.bones = 1, .frames = kJitterFrames, .frameRate = kFrameRate, .samples = samples});
+    REBEL_CHECK(clip.stats().animatedTracks == 1);
+    REBEL_CHECK(clip.stats().keys * 4 <= clip.stats().sourceKeys);
+
+    std::vector<animation::Transform> pose(1);
+    for (uint32_t f = 0; f < kJitterFrames; ++f) {
+        clip.sample(float(f) / kFrameRate, pose);
+        REBEL_CHECK(rotationError(pose[0].rotation, samples[f].rotation) <= defaults.rotationTolerance + 1e-4f);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testRoundTrip();
+    testJitterIsReduced();
+    return test::exitCode();
+}
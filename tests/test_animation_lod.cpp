@@ -0,0 +1,294 @@
+#include "test_clips.h"
+#include "test_common.h"
+
+#include "animation/blend/animation_budget.h"
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Characters animated every frame get their tree's pose; those at longer
+// intervals are evaluated once per interval, staggered evenly over the
+// frames, and in between are blended from their last two evaluations one
+// interval behind. Skeleton levels leave the bones they drop alone. The
+// budget hands out levels in importance order, in bands that double in
+// width, as wide as fit its time, and calibrates its cost estimate.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr uint32_t kBones = 10;
+using Pose = std::vector<animation::Transform>;
+
+// Two clips blended by parameter 1, both at phase parameter 0, over a
+// chain of bones: level L keeps the first kBones - L.
+struct Rig {
+    animation::AnimationClip a = test::makeClip(1, kBones), b = test::makeClip(2, kBones);
+    std::vector<int16_t> parents;
+    animation::Skeleton skeleton;
+    animation::BlendNodeDesc nodes[3];
+    animation::BlendTree tree;
+
+    static std::vector<int16_t> chain()
+    {
+        std::vector<int16_t> parents(kBones);
+        for (uint32_t i = 0; i < kBones; ++i)
+            parents[i] = int16_t(i) - 1;
+        return parents;
+    }
+
+    Rig()
+        : parents(chain())
+        , skeleton(parents)
+        , nodes{{.type = animation::BlendNodeType::Lerp, .inputs = {1, 2}, .weight = 1},
+                {.type = animation::BlendNodeType::Clip, .clip = &a, .phase = 0},
+                {.type = animation::BlendNodeType::Clip, .clip = &b, .phase = 0}}
+        , tree({.bones = kBones, .nodes = nodes, .parameterCount = 2, .skeleton = &skeleton})
+    {
+    }
+};
+
+// Character i's parameters at a frame: each walks its own phase.
+std::vector<float> parameters(uint32_t i, uint32_t frame)
+{
+    return {0.013f * float(frame) + 0.1f * float(i), 0.3f + 0.05f * float(i % 8)};
+}
+
+Pose evaluate(const animation::BlendTree& tree, const std::vector<float>& params)
+{
+    animation::PoseBuffer buffer(kBones);
+    tree.evaluate(params, buffer);
+    Pose pose(kBones);
+    buffer.get(pose);
+    return pose;
+}
+
+float difference(const Pose& a, const Pose& b, uint32_t bones = kBones)
+{
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < bones; ++i) {
+        const Quat q = math::dot(a[i].rotation, b[i].rotation) < 0.0f ? -b[i].rotation : b[i].rotation;
+        const Quat d = a[i].rotation + (-q);
+        worst = std::max({worst, std::sqrt(math::dot(d, d)), math::length(a[i].translation - b[i].translation)});
+    }
+    return worst;
+}
+
+void testIntervals(jobs::JobSystem& jobs)
+{
+    // 64 characters at each interval in turn.
+    constexpr uint32_t kCharacters = 64;
+    constexpr uint32_t kFrames = 40;
+    const Rig rig;
+    for (const uint8_t interval : {uint8_t(1), uint8_t(2), uint8_t(4), uint8_t(8)}) {
+        std::vector<std::vector<float>> params(kCharacters);
+        std::vector<animation::PoseBuffer> poses(kCharacters, animation::PoseBuffer(kBones));
+        std::vector<animation::AnimatorHistory> histories(kCharacters);
+        std::vector<animation::AnimatorInstance> instances(kCharacters);
+        // Every character's exact pose at every frame so far.
+        std::vector<std::vector<Pose>> exact(kCharacters);
+        animation::Animator animator;
+        uint32_t wrong = 0, uneven = 0;
+        for (uint32_t frame = 0; frame < kFrames; ++frame) {
+            for (uint32_t i = 0; i < kCharacters; ++i) {
+                params[i] = parameters(i, frame);
+                instances[i] = {&rig.tree, params[i], &poses[i], {interval, 0}, &histories[i]};
+                exact[i].push_back(evaluate(rig.tree, params[i]));
+            }
+            animator.update(instances, jobs);
+            const animation::AnimatorStats& stats = animator.stats();
+            REBEL_CHECK(stats.characters == kCharacters && stats.bones == kCharacters * kBones);
+            // All at once on the first frame, then an even share each frame.
+            const uint32_t expected = frame == 0 || interval == 1 ? kCharacters : kCharacters / interval;
+            uneven += stats.evaluated != expected;
+            REBEL_CHECK(stats.interpolated == (interval > 1 ? kCharacters : 0));
+
+            // Once a character has two evaluations behind it, it shows the
+            // blend between them: evaluated at f0 and one interval earlier.
+            if (frame < 2u * interval)
+                continue;
+            for (uint32_t i = 0; i < kCharacters; ++i) {
+                const uint32_t phase = (interval - i % interval) % interval;
+                const uint32_t f0 = frame - (frame + interval - phase) % interval;
+                Pose expectedPose = exact[i][f0 - interval + (interval == 1 ? 1 : 0)];
+                if (interval > 1) {
+                    const float t = float(frame - f0) / float(interval);
+                    for (uint32_t b = 0; b < kBones; ++b) {
+                        animation::Transform& e = expectedPose[b];
+                        const animation::Transform& next = exact[i][f0][b];
+                        e.rotation = math::nlerp(e.rotation, next.rotation, t);
+                        e.translation = e.translation + (next.translation - e.translation) * t;
+                    }
+                }
+                Pose pose(kBones);
+                poses[i].get(pose);
+                wrong += difference(pose, expectedPose) > 1e-4f;
+            }
+        }
+        REBEL_CHECK(uneven == 0);
+        REBEL_CHECK(wrong == 0);
+        REBEL_CHECK(animator.frame() == kFrames);
+    }
+}
+
+void testSkeletonLevels(jobs::JobSystem& jobs)
+{
+    // A character dropping to level 6 keeps its first four bones' group
+    // animated, and the rest hold the pose they had.
+    const Rig rig;
+    REBEL_CHECK(rig.tree.levelCount() == kBones && rig.tree.boneCount(6) == 4);
+    animation::PoseBuffer pose(kBones);
+    animation::AnimatorHistory history;
+    animation::Animator animator;
+    std::vector<float> params = parameters(0, 0);
+    animation::AnimatorInstance instance{&rig.tree, params, &pose, {1, 0}, &history};
+    animator.update({&instance, 1}, jobs);
+    Pose held(kBones);
+    pose.get(held);
+
+    const std::vector<float> later = parameters(0, 20);
+    std::copy(later.begin(), later.end(), params.begin());
+    instance.lod = {1, 6};
+    animator.update({&instance, 1}, jobs);
+    REBEL_CHECK(animator.stats().bones == 4);
+    Pose now(kBones);
+    pose.get(now);
+    REBEL_CHECK(difference(now, evaluate(rig.tree, params), 4) < 1e-6f);
+    REBEL_CHECK(difference(now, held, 4) > 0.01f);
+    for (uint32_t b = 4; b < kBones; ++b)
+        REBEL_CHECK(difference({now[b]}, {held[b]}, 1) == 0.0f);
+
+    // Changing level at a longer interval starts its history over: it is
+    // evaluated at once rather than when the interval would be up.
+    instance.lod = {4, 0};
+    animator.update({&instance, 1}, jobs);
+    REBEL_CHECK(animator.stats().evaluated == 1);
+    animator.update({&instance, 1}, jobs);
+    REBEL_CHECK(animator.stats().evaluated == 0);
+    instance.lod = {4, 2};
+    animator.update({&instance, 1}, jobs);
+    REBEL_CHECK(animator.stats().evaluated == 1);
+}
+
+void testWork(jobs::JobSystem& jobs)
+{
+    // Over a whole interval the work counted per frame adds up to what
+    // Animator::work() predicts for each character.
+    const Rig rig;
+    constexpr uint32_t kCharacters = 48;
+    const animation::AnimationLod lods[] = {{1, 0}, {2, 1}, {4, 3}, {8, 5}};
+    std::vector<std::vector<float>> params(kCharacters);
+    std::vector<animation::PoseBuffer> poses(kCharacters, animation::PoseBuffer(kBones));
+    std::vector<animation::AnimatorHistory> histories(kCharacters);
+    std::vector<animation::AnimatorInstance> instances(kCharacters);
+    double predicted = 0.0;
+    for (uint32_t i = 0; i < kCharacters; ++i) {
+        params[i] = parameters(i, 0);
+        instances[i] = {&rig.tree, params[i], &poses[i], lods[i % 4], &histories[i]};
+        predicted += animation::Animator::work(rig.tree, lods[i % 4]);
+    }
+    REBEL_CHECK(animation::Animator::work(rig.tree, {1, 0}) == double(kBones * rig.tree.instructionCount()));
+    REBEL_CHECK(animation::Animator::work(rig.tree, {4, 3}) ==
+                double(7 * rig.tree.instructionCount()) / 4.0 + 7.0);
+    animation::Animator animator;
+    animator.update(instances, jobs); // everyone evaluated on the first frame
+    uint64_t work = 0;
+    for (uint32_t frame = 0; frame < 8; ++frame) {
+        animator.update(instances, jobs);
+        work += animator.stats().work;
+    }
+    REBEL_CHECK(std::abs(double(work) / 8.0 - predicted) < 1e-6);
+}
+
+void testBudget()
+{
+    const Rig rig;
+    constexpr uint32_t kCharacters = 5000;
+    std::vector<animation::PoseBuffer> poses(1, animation::PoseBuffer(kBones));
+    std::vector<animation::AnimatorInstance> instances(kCharacters, {&rig.tree, {}, &poses[0], {}, nullptr});
+    std::vector<float> importance(kCharacters);
+    std::mt19937 rng(24);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (float& value : importance)
+        value = unit(rng);
+
+    // Predicted work for bands of width d, the last level taking the rest.
+    const std::span<const animation::AnimationLod> levels = animation::AnimationBudget::kDefaultLevels;
+    const auto bandWork = [&](uint64_t d) {
+        double work = 0.0;
+        uint64_t begin = 0;
+        for (uint32_t level = 0; level < levels.size(); ++level) {
+            const uint64_t end =
+                level + 1 == levels.size() ? kCharacters : std::min<uint64_t>(d * ((2u << level) - 1), kCharacters);
+            work += double(end - begin) * animation::Animator::work(rig.tree, levels[level]);
+            begin = end;
+        }
+        return work;
+    };
+
+    uint32_t previousBest = 0;
+    for (const float milliseconds : {0.7f, 0.8f, 0.9f, 1.1f}) {
+        animation::AnimationBudget budget({.milliseconds = milliseconds, .microsecondsPerWork = 0.01f});
+        budget.assign(instances, importance);
+        const animation::AnimationBudgetStats& stats = budget.stats();
+
+        // Bands of d, 2d and 4d, the rest the cheapest level.
+        const uint32_t d = stats.characters[0];
+        REBEL_CHECK(d > previousBest);
+        previousBest = d;
+        REBEL_CHECK(stats.characters[1] == 2 * d && stats.characters[2] == 4 * d);
+        REBEL_CHECK(stats.characters[0] + stats.characters[1] + stats.characters[2] + stats.characters[3] ==
+                    kCharacters);
+
+        // The widest bands within the budget.
+        const double limit = double(milliseconds) * 1000.0 / 0.01;
+        REBEL_CHECK(std::abs(stats.predictedWork - bandWork(d)) < 1e-6 * bandWork(d));
+        REBEL_CHECK(stats.predictedWork <= limit && bandWork(d + 1) > limit);
+        REBEL_CHECK(stats.predictedMilliseconds <= milliseconds);
+
+        // More important characters never get a worse level than less
+        // important ones.
+        std::vector<uint32_t> order(kCharacters);
+        for (uint32_t i = 0; i < kCharacters; ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return importance[a] > importance[b]; });
+        uint32_t inverted = 0;
+        for (uint32_t r = 1; r < kCharacters; ++r) {
+            const animation::AnimationLod before = instances[order[r - 1]].lod, after = instances[order[r]].lod;
+            inverted += before.interval > after.interval || before.skeletonLevel > after.skeletonLevel;
+        }
+        REBEL_CHECK(inverted == 0);
+        REBEL_CHECK(instances[order[0]].lod.interval == 1);
+        REBEL_CHECK(instances[order[kCharacters - 1]].lod.interval == 8);
+    }
+
+    // A budget too small for anyone's best still animates everyone, at the
+    // cheapest level.
+    animation::AnimationBudget tight({.milliseconds = 0.1f, .microsecondsPerWork = 0.01f});
+    tight.assign(instances, importance);
+    REBEL_CHECK(tight.stats().characters[3] == kCharacters);
+    REBEL_CHECK(std::abs(tight.stats().predictedWork - bandWork(0)) < 1e-6 * bandWork(0));
+
+    // Each measurement moves the estimate a quarter of the way to it.
+    animation::AnimationBudget budget({.microsecondsPerWork = 0.01f});
+    budget.calibrate({.work = 100000, .milliseconds = 3.0f});
+    REBEL_CHECK(std::abs(budget.stats().microsecondsPerWork - (0.01f + (0.03f - 0.01f) * 0.25f)) < 1e-7f);
+    budget.calibrate({});
+    REBEL_CHECK(std::abs(budget.stats().microsecondsPerWork - 0.015f) < 1e-7f);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testIntervals(jobs);
+    testSkeletonLevels(jobs);
+    testWork(jobs);
+    testBudget();
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,280 @@
+#include "test_clips.h"
+#include "test_common.h"
+
+#include "animation/blend/blend_tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
+
+// A compiled blend tree of lerps, a masked layer, an additive delta and
+// one- and two-dimensional blendspaces gives the pose that blending the
+// sampled clips bone by bone, as each node is documented to, gives, for
+// weights and blend positions in range, at the ends and beyond them. A
+// skeleton LOD level evaluates only its own bones.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr uint32_t kBones = 10; // not a whole number of groups
+using Pose = std::vector<animation::Transform>;
+
+float wrap(float phase)
+{
+    return phase - std::floor(phase);
+}
+
+float clamp01(float w)
+{
+    return std::clamp(w, 0.0f, 1.0f);
+}
+
+Pose sample(const animation::AnimationClip& clip, float phase)
+{
+    Pose pose(kBones);
+    clip.sample(wrap(phase) * clip.duration(), pose);
+    return pose;
+}
+
+// a towards b by a weight per bone.
+void blend(Pose& a, const Pose& b, const std::vector<float>& weights)
+{
+    for (uint32_t i = 0; i < kBones; ++i) {
+        const float w = weights[i];
+        a[i].rotation = math::nlerp(a[i].rotation, b[i].rotation, w);
+        a[i].translation = a[i].translation + (b[i].translation - a[i].translation) * w;
+        a[i].scale = a[i].scale + (b[i].scale - a[i].scale) * w;
+    }
+}
+
+// b's deltas on top of a by a weight per bone.
+void add(Pose& a, const Pose& b, const std::vector<float>& weights)
+{
+    for (uint32_t i = 0; i < kBones; ++i) {
+        const float w = weights[i];
+        const Quat delta = b[i].rotation.w < 0.0f ? -b[i].rotation : b[i].rotation;
+        a[i].rotation = a[i].rotation * math::normalize(Quat{} * (1.0f - w) + delta * w);
+        a[i].translation = a[i].translation + b[i].translation * w;
+        const Vec3 one{1.0f, 1.0f, 1.0f};
+        const Vec3 s = one + (b[i].scale - one) * w;
+        a[i].scale = {a[i].scale.x * s.x, a[i].scale.y * s.y, a[i].scale.z * s.z};
+    }
+}
+
+// The point of `axis` at or below v and the weight of the next, as the
+// tree locates them.
+void locate(std::span<const float> axis, float v, uint32_t& index, float& weight)
+{
+    index = 0;
+    weight = 0.0f;
+    if (v >= axis.back()) {
+        index = uint32_t(axis.size() - 1);
+        return;
+    }
+    while (index + 1 < axis.size() && axis[index + 1] <= v)
+        ++index;
+    if (v > axis[0])
+        weight = (v - axis[index]) / (axis[index + 1] - axis[index]);
+}
+
+// Node `node` of `nodes` evaluated bone by bone, from the node semantics.
+Pose evaluate(std::span<const animation::BlendNodeDesc> nodes, uint32_t node, const std::vector<float>& parameters)
+{
+    const animation::BlendNodeDesc& n = nodes[node];
+    switch (n.type) {
+    case animation::BlendNodeType::Clip:
+        return sample(*n.clip, parameters[n.phase]);
+    case animation::BlendNodeType::Lerp:
+    case animation::BlendNodeType::Layer:
+    case animation::BlendNodeType::Additive: {
+        Pose pose = evaluate(nodes, n.inputs[0], parameters);
+        const float w = clamp01(parameters[n.weight]);
+        if (w == 0.0f)
+            return pose;
+        std::vector<float> weights(kBones, w);
+        for (std::size_t i = 0; i < n.mask.size(); ++i)
+            weights[i] *= clamp01(n.mask[i]);
+        const Pose other = evaluate(nodes, n.inputs[1], parameters);
+        if (n.type == animation::BlendNodeType::Additive)
+            add(pose, other, weights);
+        else
+            blend(pose, other, weights);
+        return pose;
+    }
+    case animation::BlendNodeType::Blendspace1D:
+    case animation::BlendNodeType::Blendspace2D: {
+        uint32_t column = 0, row = 0;
+        float tx = 0.0f, ty = 0.0f;
+        locate(n.xs, parameters[n.x], column, tx);
+        if (n.type == animation::BlendNodeType::Blendspace2D)
+            locate(n.ys, parameters[n.y], row, ty);
+        const float phase = parameters[n.phase];
+        const auto rowPose = [&](uint32_t r) {
+            const std::size_t first = r * n.xs.size() + column;
+            Pose pose = sample(*n.clips[first], phase);
+            if (tx > 0.0f)
+                blend(pose, sample(*n.clips[first + 1], phase), std::vector<float>(kBones, tx));
+            return pose;
+        };
+        Pose pose = rowPose(row);
+        if (ty > 0.0f)
+            blend(pose, rowPose(row + 1), std::vector<float>(kBones, ty));
+        return pose;
+    }
+    }
+    return {};
+}
+
+// Worst difference over the first `bones` bones, rotations compared
+// up to sign.
+float difference(const Pose& a, const Pose& b, uint32_t bones = kBones)
+{
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < bones; ++i) {
+        const Quat q = math::dot(a[i].rotation, b[i].rotation) < 0.0f ? -b[i].rotation : b[i].rotation;
+        const Quat d = a[i].rotation + (-q);
+        worst = std::max({worst, std::sqrt(math::dot(d, d)), math::length(a[i].translation - b[i].translation),
+                          math::length(a[i].scale - b[i].scale)});
+    }
+    return worst;
+}
+
+// Chains of four, three and two bones off a root, put in LOD order.
+std::vector<int16_t> makeParents()
+{
+    const int16_t source[kBones] = {-1, 0, 1, 2, 3, 0, 5, 6, 0, 8};
+    const std::vector<uint32_t> order = animation::Skeleton::lodOrder(source);
+    std::vector<int16_t> renamed(kBones), parents(kBones);
+    for (uint32_t i = 0; i < kBones; ++i)
+        renamed[order[i]] = int16_t(i);
+    for (uint32_t i = 0; i < kBones; ++i)
+        parents[i] = source[order[i]] < 0 ? int16_t(-1) : renamed[std::size_t(source[order[i]])];
+    return parents;
+}
+
+void testMatchesReference()
+{
+    std::vector<animation::AnimationClip> clips;
+    for (uint32_t i = 0; i < 11; ++i)
+        clips.push_back(test::makeClip(23 + i, kBones));
+    const animation::AnimationClip* walk[3] = {&clips[0], &clips[1], &clips[2]};
+    const animation::AnimationClip* aim[6] = {&clips[4], &clips[5], &clips[6], &clips[7], &clips[8], &clips[9]};
+    const float walkSpeeds[3] = {-1.0f, 0.0f, 2.0f};
+    const float aimX[3] = {0.0f, 1.0f, 2.0f}, aimY[2] = {0.0f, 1.0f};
+    const float mask[kBones] = {0.0f, 0.0f, 1.0f, 1.0f, 0.5f, 0.25f, 1.5f, -1.0f, 1.0f, 0.75f};
+
+    // Parameters: 0-2 weights, 3 phase, 4 and 6 blend positions, 5 the
+    // delta and overlay clips' phase.
+    const animation::BlendNodeDesc nodes[] = {
+        {.type = animation::BlendNodeType::Lerp, .inputs = {1, 2}, .weight = 0},
+        {.type = animation::BlendNodeType::Additive, .inputs = {3, 4}, .weight = 1},
+        {.type = animation::BlendNodeType::Layer, .inputs = {5, 6}, .weight = 2, .mask = mask},
+        {.type = animation::BlendNodeType::Blendspace1D, .phase = 3, .clips = walk, .xs = walkSpeeds, .x = 4},
+        {.type = animation::BlendNodeType::Clip, .clip = &clips[3], .phase = 5},
+        {.type = animation::BlendNodeType::Blendspace2D,
+         .phase = 3,
+         .clips = aim,
+         .xs = aimX,
+         .ys = aimY,
+         .x = 4,
+         .y = 6},
+        {.type = animation::BlendNodeType::Clip, .clip = &clips[10], .phase = 5},
+    };
+    const std::vector<int16_t> parents = makeParents();
+    const animation::Skeleton skeleton(parents);
+    const animation::BlendTree tree(
+        {.bones = kBones, .nodes = nodes, .root = 0, .parameterCount = 7, .skeleton = &skeleton});
+    REBEL_CHECK(tree.boneCount() == kBones && tree.parameterCount() == 7);
+    // The layer's second input sits two registers up, and its 2D
+    // blendspace takes two more above that.
+    REBEL_CHECK(tree.registerCount() == 4);
+    // The root is four generations above the longest chain's leaf.
+    REBEL_CHECK(tree.levelCount() == skeleton.levelCount() && tree.levelCount() == 5);
+
+    // Weights in range, at either end and beyond; positions on points,
+    // between them and off either end; phases wrapping both ways.
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float weights[] = {-0.5f, 0.0f, 1.0f, 1.5f};
+    const float positions[] = {-3.0f, -1.0f, 0.0f, 1.0f, 2.0f, 5.0f};
+    animation::PoseBuffer buffer(kBones);
+    Pose pose(kBones);
+    uint32_t wrong = 0;
+    for (int i = 0; i < 400; ++i) {
+        std::vector<float> parameters(7);
+        for (uint32_t w = 0; w < 3; ++w)
+            parameters[w] = i % 3 == 0 ? weights[rng() % 4] : unit(rng);
+        parameters[3] = 3.0f * unit(rng) - 1.0f;
+        parameters[5] = 3.0f * unit(rng) - 1.0f;
+        parameters[4] = i % 4 == 0 ? positions[rng() % 6] : 4.0f * unit(rng) - 1.5f;
+        parameters[6] = i % 4 == 1 ? positions[rng() % 6] : 1.4f * unit(rng) - 0.2f;
+        tree.evaluate(parameters, buffer);
+        buffer.get(pose);
+        wrong += difference(pose, evaluate(nodes, 0, parameters)) > 1e-4f;
+    }
+    REBEL_CHECK(wrong == 0);
+
+    // Each LOD level writes the groups holding its bones, the same as a
+    // full evaluation, and leaves the rest alone.
+    const std::vector<float> parameters{0.4f, 0.7f, 0.6f, 0.3f, 0.5f, 0.8f, 0.5f};
+    tree.evaluate(parameters, buffer);
+    Pose full(kBones);
+    buffer.get(full);
+    animation::Transform marker;
+    marker.translation = {9.0f, 9.0f, 9.0f};
+    for (uint32_t level = 1; level < tree.levelCount(); ++level) {
+        const uint32_t bones = tree.boneCount(level);
+        REBEL_CHECK(bones == skeleton.boneCount(level) && bones < tree.boneCount(level - 1));
+        buffer.set(Pose(kBones, marker));
+        tree.evaluate(parameters, buffer, level);
+        buffer.get(pose);
+        REBEL_CHECK(difference(pose, full, bones) == 0.0f);
+        const uint32_t written = animation::PoseBuffer::groupCount(bones) * animation::PoseBuffer::kLanes;
+        for (uint32_t b = written; b < kBones; ++b)
+            REBEL_CHECK(pose[b].translation.x == 9.0f);
+    }
+}
+
+void testSingleNodes()
+{
+    // A lone clip is the clip, wrapped in phase; a lerp at 0 and at 1 is
+    // exactly its first and second input.
+    const animation::AnimationClip a = test::makeClip(1, kBones), b = test::makeClip(2, kBones);
+    const animation::BlendNodeDesc clipNode[] = {{.type = animation::BlendNodeType::Clip, .clip = &a, .phase = 0}};
+    const animation::BlendTree clipTree({.bones = kBones, .nodes = clipNode, .parameterCount = 1});
+    REBEL_CHECK(clipTree.instructionCount() == 1 && clipTree.levelCount() == 1);
+    animation::PoseBuffer buffer(kBones);
+    Pose pose(kBones);
+    const float phase[] = {2.25f};
+    clipTree.evaluate(phase, buffer);
+    buffer.get(pose);
+    REBEL_CHECK(difference(pose, sample(a, 0.25f)) < 1e-6f);
+
+    const animation::BlendNodeDesc lerp[] = {
+        {.type = animation::BlendNodeType::Lerp, .inputs = {1, 2}, .weight = 1},
+        {.type = animation::BlendNodeType::Clip, .clip = &a, .phase = 0},
+        {.type = animation::BlendNodeType::Clip, .clip = &b, .phase = 0},
+    };
+    const animation::BlendTree lerpTree({.bones = kBones, .nodes = lerp, .parameterCount = 2});
+    REBEL_CHECK(lerpTree.instructionCount() == 4 && lerpTree.registerCount() == 2);
+    const float zero[] = {0.6f, 0.0f}, one[] = {0.6f, 1.0f};
+    lerpTree.evaluate(zero, buffer);
+    buffer.get(pose);
+    REBEL_CHECK(difference(pose, sample(a, 0.6f)) == 0.0f);
+    lerpTree.evaluate(one, buffer);
+    buffer.get(pose);
+    REBEL_CHECK(difference(pose, sample(b, 0.6f)) < 1e-6f);
+}
+
+} // namespace
+
+int main()
+{
+    testMatchesReference();
+    testSingleNodes();
+    return test::exitCode();
+}
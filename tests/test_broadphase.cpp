@@ -0,0 +1,102 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/broadphase/broadphase.h"
+
+#include <random>
+#include <vector>
+
+// After every step, for both broadphase types, the pair cache holds exactly
+// the overlapping fat boxes found by testing every pair, while boxes move,
+// are created and are destroyed.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+struct Body {
+    Vec3 position;
+    Vec3 velocity;
+    Vec3 half;
+    uint32_t proxy = 0;
+    bool live = false;
+};
+
+// Pairs the cache is missing plus pairs it holds that no longer overlap.
+uint32_t countMismatches(const physics::Broadphase& broadphase, const std::vector<Body>& bodies)
+{
+    uint32_t expected = 0, missing = 0;
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+        if (!bodies[i].live)
+            continue;
+        for (std::size_t j = i + 1; j < bodies.size(); ++j) {
+            if (!bodies[j].live ||
+                !physics::overlaps(broadphase.fatAabb(bodies[i].proxy), broadphase.fatAabb(bodies[j].proxy)))
+                continue;
+            ++expected;
+            missing += !broadphase.pairs().contains(physics::pairKey(bodies[i].proxy, bodies[j].proxy));
+        }
+    }
+    return missing + (broadphase.pairs().size() - (expected - missing));
+}
+
+void testPairsMatchBruteForce(physics::BroadphaseType type, jobs::JobSystem& jobs)
+{
+    constexpr uint32_t kBodies = 2000;
+    constexpr float kDt = 1.0f / 60.0f;
+    const Vec3 worldMin{-40.0f, 0.0f, -40.0f}, worldMax{40.0f, 10.0f, 40.0f};
+
+    physics::Broadphase broadphase({.type = type});
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Body> bodies(kBodies);
+    auto spawn = [&](Body& body) {
+        body.position = {worldMin.x + unit(rng) * 80.0f, unit(rng) * 10.0f, worldMin.z + unit(rng) * 80.0f};
+        body.half = Vec3{0.2f, 0.2f, 0.2f} + Vec3{unit(rng), unit(rng), unit(rng)} * 0.8f;
+        body.velocity = rng() % 4 ? Vec3{unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f} * 20.0f : Vec3{};
+        body.proxy = broadphase.createProxy(physics::Aabb::fromCenterExtents(body.position, body.half),
+                                             uint32_t(&body - bodies.data()));
+        body.live = true;
+    };
+    for (Body& body : bodies)
+        spawn(body);
+    broadphase.updatePairs(jobs);
+    REBEL_CHECK(broadphase.pairs().size() > 0);
+    REBEL_CHECK(countMismatches(broadphase, bodies) == 0);
+
+    for (int step = 0; step < 60; ++step) {
+        for (Body& body : bodies) {
+            if (!body.live)
+                continue;
+            const Vec3 d = body.velocity * kDt;
+            body.position += d;
+            for (int axis = 0; axis < 3; ++axis) {
+                if (body.position[axis] < worldMin[axis] || body.position[axis] > worldMax[axis])
+                    body.velocity[axis] = -body.velocity[axis];
+            }
+            broadphase.moveProxy(body.proxy, physics::Aabb::fromCenterExtents(body.position, body.half), d);
+        }
+        // Churn a few proxies; destroyed ids may be handed out again.
+        for (int i = 0; i < 5; ++i) {
+            Body& body = bodies[rng() % kBodies];
+            if (body.live) {
+                broadphase.destroyProxy(body.proxy);
+                body.live = false;
+            } else {
+                spawn(body);
+            }
+        }
+        broadphase.updatePairs(jobs);
+        REBEL_CHECK(countMismatches(broadphase, bodies) == 0);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    jobs::JobSystem jobs({.workerCount = 4});
+    testPairsMatchBruteForce(physics::BroadphaseType::DynamicTree, jobs);
+    testPairsMatchBruteForce(physics::BroadphaseType::SweepAndPrune, jobs);
+    return test::exitCode();
+}
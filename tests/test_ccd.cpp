@@ -0,0 +1,180 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/collision/time_of_impact.h"
+#include "physics/triangle_mesh.h"
+#include "physics/world.h"
+
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Time of impact lands within the target distance of the surface and never
+// past it, for spinning shapes and against meshes; fast CCD bodies stop at
+// thin walls and floors that the same bodies without CCD pass through.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr float kDt = 1.0f / 60.0f;
+
+// Surface distance between two shapes at the given poses.
+float surfaceDistance(const physics::Shape& a, const physics::Transform& ta, const physics::Shape& b,
+                      const physics::Transform& tb)
+{
+    const physics::ConvexCore ca(a, ta), cb(b, tb);
+    physics::ClosestPoints points;
+    physics::closestPoints(ca, cb, FLT_MAX, points);
+    return points.distance - ca.radius - cb.radius;
+}
+
+void testImpactTimeMatchesClosedForm()
+{
+    // A sphere flying square at a thin slab touches it once its centre is
+    // radius plus half thickness away.
+    const physics::Shape sphere = physics::Shape::sphere(0.1f);
+    const physics::Shape slab = physics::Shape::box({0.05f, 2.0f, 2.0f});
+    const physics::Sweep sa{{{-5.0f, 0.3f, 0.2f}, {}}, {100.0f, 0.0f, 0.0f}};
+    const physics::Sweep sb{{{}, {}}};
+    constexpr float kTarget = 0.01f;
+    physics::TimeOfImpact impact;
+    REBEL_CHECK(physics::timeOfImpact(sphere, sa, slab, sb, 0.1f, kTarget, impact));
+    const float touch = (5.0f - 0.15f) / 100.0f;
+    REBEL_CHECK(impact.time <= touch && impact.time >= touch - 1.25f * kTarget / 100.0f);
+    REBEL_CHECK(math::dot(impact.normal, Vec3{1.0f, 0.0f, 0.0f}) > 0.999f);
+    REBEL_CHECK(std::abs(impact.point.x + 0.05f) < 2.0f * kTarget);
+
+    // Passing beside the slab, and flying away from it.
+    const physics::Sweep beside{{{-5.0f, 2.5f, 0.0f}, {}}, {100.0f, 0.0f, 0.0f}};
+    REBEL_CHECK(!physics::timeOfImpact(sphere, beside, slab, sb, 0.1f, kTarget, impact));
+    const physics::Sweep away{{{-0.2f, 0.0f, 0.0f}, {}}, {-100.0f, 0.0f, 0.0f}};
+    REBEL_CHECK(!physics::timeOfImpact(sphere, away, slab, sb, 0.1f, kTarget, impact));
+}
+
+void testImpactIsConservative()
+{
+    // Spinning capsules and boxes thrown at a thin slab from all sides: an
+    // impact is reported within the target of the surface with no contact
+    // earlier in the sweep, and a miss never passes through.
+    const physics::Shape movers[] = {physics::Shape::capsule(0.03f, 0.2f), physics::Shape::box({0.3f, 0.05f, 0.1f})};
+    const physics::Shape slab = physics::Shape::box({0.05f, 1.0f, 1.0f});
+    const physics::Sweep sb{{{}, Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.3f)}};
+    constexpr float kTarget = 0.01f;
+    constexpr float kDuration = 0.05f;
+
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t hits = 0, misses = 0, tooFar = 0, penetrated = 0;
+    for (int i = 0; i < 400; ++i) {
+        const physics::Shape& a = movers[i % 2];
+        const Vec3 start{unit(rng) < 0.0f ? -4.0f : 4.0f, unit(rng) * 1.5f, unit(rng) * 1.5f};
+        const Vec3 aim{0.0f, unit(rng), unit(rng)};
+        const physics::Sweep sa{{start, Quat::fromAxisAngle(math::normalize(Vec3{unit(rng), 1.0f, unit(rng)}, {}),
+                                                          unit(rng) * 3.0f)},
+                                (aim - start) * (1.0f / kDuration) * (0.8f + 0.4f * unit(rng)),
+                                Vec3{unit(rng), unit(rng), unit(rng)} * 200.0f};
+        physics::TimeOfImpact impact;
+        const bool hit = physics::timeOfImpact(a, sa, slab, sb, kDuration, kTarget, impact);
+        const float end = hit ? impact.time : kDuration;
+        for (int k = 0; k <= 200; ++k)
+            penetrated += surfaceDistance(a, sa.at(end * float(k) / 200.0f), slab, sb.start) < 0.0f;
+        if (hit) {
+            ++hits;
+            tooFar += surfaceDistance(a, sa.at(impact.time), slab, sb.start) > 1.25f * kTarget + 1e-4f;
+        } else {
+            ++misses;
+        }
+    }
+    REBEL_CHECK(hits > 100 && misses > 20);
+    REBEL_CHECK(tooFar == 0);
+    REBEL_CHECK(penetrated == 0);
+}
+
+void testImpactAgainstMesh()
+{
+    // A two-triangle floor: the earliest triangle under the sweep wins.
+    const std::vector<Vec3> vertices{{-5.0f, 0.0f, -5.0f}, {5.0f, 0.0f, -5.0f}, {5.0f, 0.0f, 5.0f},
+                                     {-5.0f, 0.0f, 5.0f}};
+    const std::vector<uint32_t> indices{0, 2, 1, 0, 3, 2};
+    const std::vector<uint8_t> cooked = physics::TriangleMesh::cook(vertices, indices);
+    const physics::TriangleMesh mesh(cooked);
+    const physics::Shape floor = physics::Shape::triangleMesh(&mesh);
+    const physics::Shape sphere = physics::Shape::sphere(0.1f);
+
+    const physics::Sweep falling{{{0.5f, 3.0f, -0.2f}, {}}, {10.0f, -200.0f, 0.0f}};
+    physics::TimeOfImpact impact;
+    REBEL_CHECK(physics::timeOfImpact(sphere, falling, floor, {}, kDt, 0.01f, impact));
+    const float touch = (3.0f - 0.1f) / 200.0f;
+    REBEL_CHECK(impact.time <= touch && impact.time >= touch - 1.25f * 0.01f / 200.0f);
+    REBEL_CHECK(std::abs(impact.normal.y) > 0.999f);
+
+    const physics::Sweep outside{{{7.0f, 3.0f, 0.0f}, {}}, {0.0f, -200.0f, 0.0f}};
+    REBEL_CHECK(!physics::timeOfImpact(sphere, outside, floor, {}, kDt, 0.01f, impact));
+}
+
+// Rounds fired at a thin wall, and dropped fast onto a mesh floor; returns
+// how many end up beyond either.
+uint32_t tunnelled(bool ccd, jobs::JobSystem& jobs, uint32_t& ccdBodies)
+{
+    const std::vector<Vec3> vertices{{-20.0f, 0.0f, -20.0f}, {20.0f, 0.0f, -20.0f}, {20.0f, 0.0f, 20.0f},
+                                     {-20.0f, 0.0f, 20.0f}};
+    const std::vector<uint32_t> indices{0, 2, 1, 0, 3, 2};
+    const std::vector<uint8_t> cooked = physics::TriangleMesh::cook(vertices, indices);
+    const physics::TriangleMesh mesh(cooked);
+
+    physics::PhysicsWorld world;
+    world.createBody({.type = physics::BodyType::Static, .shape = physics::Shape::triangleMesh(&mesh)});
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({0.05f, 4.0f, 10.0f}),
+                      .position = {0.0f, 4.0f, 0.0f}});
+    std::vector<physics::BodyId> rounds, drops;
+    for (int i = 0; i < 40; ++i) {
+        rounds.push_back(world.createBody({.shape = physics::Shape::capsule(0.03f, 0.1f),
+                                           .position = {-6.0f, 1.0f + float(i % 5), float(i / 5) - 4.0f},
+                                           .rotation = Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 1.5708f),
+                                           .linearVelocity = {400.0f, 0.0f, 0.0f},
+                                           .angularVelocity = {300.0f, 0.0f, 0.0f},
+                                           .mass = 0.01f,
+                                           .ccd = ccd}));
+        drops.push_back(world.createBody({.shape = physics::Shape::sphere(0.05f),
+                                          .position = {5.0f + float(i % 5), 3.0f, float(i / 5) - 4.0f},
+                                          .linearVelocity = {0.0f, -250.0f, 0.0f},
+                                          .mass = 0.01f,
+                                          .ccd = ccd}));
+    }
+    world.step(kDt, jobs);
+    ccdBodies = world.stats().ccdBodies;
+    for (int i = 0; i < 30; ++i)
+        world.step(kDt, jobs);
+
+    uint32_t through = 0;
+    for (const physics::BodyId id : rounds)
+        through += world.body(id)->transform.position.x > 0.0f;
+    for (const physics::BodyId id : drops)
+        through += world.body(id)->transform.position.y < 0.0f;
+    return through;
+}
+
+void testFastBodiesStop(jobs::JobSystem& jobs)
+{
+    uint32_t ccdBodies = 0;
+    REBEL_CHECK(tunnelled(false, jobs, ccdBodies) > 40);
+    REBEL_CHECK(ccdBodies == 0);
+    REBEL_CHECK(tunnelled(true, jobs, ccdBodies) == 0);
+    REBEL_CHECK(ccdBodies == 80);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testImpactTimeMatchesClosedForm();
+    testImpactIsConservative();
+    testImpactAgainstMesh();
+    testFastBodiesStop(jobs);
+    return rebel::test::exitCode();
+}
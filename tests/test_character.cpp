@@ -0,0 +1,214 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/character/character_world.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Characters land on the ground and walk at the speed they ask for, stop at
+// walls and slide along them, step onto kerbs but not onto taller ledges,
+// walk up walkable slopes and not steeper ones, stay on the ground walking
+// down them and off kerbs, jump and land again, and are not moved through thin walls
+// however fast they go.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr float kDt = 1.0f / 60.0f;
+// Capsule centre over flat ground: half its segment, its radius and the
+// skin width.
+constexpr float kStanding = 0.5f + 0.4f + 0.02f;
+
+// A ramp whose top face rises at `angle` in +X from the ground at x0,
+// across z +-3.
+void addRamp(physics::PhysicsWorld& world, float x0, float z, float angle)
+{
+    // Its lower end sunk half a metre into the ground.
+    const Vec3 normal{-std::sin(angle), std::cos(angle), 0.0f};
+    const Vec3 top{x0 + 4.5f * std::cos(angle), 4.5f * std::sin(angle), z};
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({5.0f, 0.5f, 3.0f}),
+                      .position = top - normal * 0.5f,
+                      .rotation = Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, angle)});
+}
+
+struct Level {
+    physics::PhysicsWorld world;
+    physics::BodyId ground;
+};
+
+// Flat ground at y = 0 with a lane per test along +X: a wall at z = 0, a
+// kerb at z = 10, a ledge too tall to step at z = 20, ramps of 30 and 60
+// degrees at z = 30 and 40, and a thin wall at z = 50.
+void buildLevel(Level& level)
+{
+    physics::PhysicsWorld& world = level.world;
+    level.ground = world.createBody({.type = physics::BodyType::Static,
+                                     .shape = physics::Shape::box({60.0f, 1.0f, 60.0f}),
+                                     .position = {0.0f, -1.0f, 0.0f}});
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({0.1f, 2.0f, 3.0f}),
+                      .position = {3.1f, 2.0f, 0.0f}});
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({2.0f, 0.125f, 3.0f}),
+                      .position = {4.0f, 0.125f, 10.0f}});
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({2.0f, 0.3f, 3.0f}),
+                      .position = {4.0f, 0.3f, 20.0f}});
+    addRamp(world, 2.0f, 30.0f, 0.5236f);
+    addRamp(world, 2.0f, 40.0f, 1.0472f);
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({0.02f, 2.0f, 3.0f}),
+                      .position = {3.0f, 2.0f, 50.0f}});
+}
+
+struct Walk {
+    uint32_t airborne = 0; // frames ending off the ground
+    uint32_t steps = 0;
+    uint32_t snaps = 0;
+    float highest = -1e9f;
+};
+
+Walk walk(physics::CharacterWorld& characters, const Level& level, physics::CharacterId id, Vec3 velocity,
+          int frames, jobs::JobSystem& jobs)
+{
+    Walk walk;
+    for (int i = 0; i < frames; ++i) {
+        const physics::CharacterMove move{id, velocity};
+        characters.move(level.world, {&move, 1}, kDt, jobs);
+        walk.airborne += !characters.state(id).grounded;
+        walk.steps += characters.stats().steps;
+        walk.snaps += characters.stats().snaps;
+        walk.highest = std::max(walk.highest, characters.state(id).position.y);
+    }
+    return walk;
+}
+
+// Dropped from 2 m at x = 0 in lane `z`, then left to land.
+physics::CharacterId drop(physics::CharacterWorld& characters, const Level& level, float z, jobs::JobSystem& jobs)
+{
+    const physics::CharacterId id = characters.createCharacter({.position = {0.0f, 2.0f, z}});
+    REBEL_CHECK(!characters.state(id).grounded);
+    walk(characters, level, id, {}, 60, jobs);
+    return id;
+}
+
+void testLandsAndWalks(const Level& level, jobs::JobSystem& jobs)
+{
+    physics::CharacterWorld characters;
+    const physics::CharacterId id = drop(characters, level, -10.0f, jobs);
+    const physics::CharacterState& state = characters.state(id);
+    REBEL_CHECK(state.grounded && state.ground == level.ground);
+    REBEL_CHECK(std::abs(state.position.y - kStanding) < 0.01f);
+    REBEL_CHECK(math::dot(state.groundNormal, Vec3{0.0f, 1.0f, 0.0f}) > 0.999f);
+
+    const Walk w = walk(characters, level, id, {4.0f, 0.0f, -3.0f}, 60, jobs);
+    REBEL_CHECK(w.airborne == 0);
+    REBEL_CHECK(math::length(state.position - Vec3{4.0f, kStanding, -13.0f}) < 0.05f);
+    REBEL_CHECK(math::length(state.velocity - Vec3{4.0f, 0.0f, -3.0f}) < 0.05f);
+}
+
+void testWallBlocksAndSlides(const Level& level, jobs::JobSystem& jobs)
+{
+    // Into the wall at 45 degrees: stopped a radius and skin off it, and
+    // sliding along it at the speed along it.
+    physics::CharacterWorld characters;
+    const physics::CharacterId id = drop(characters, level, -1.0f, jobs);
+    walk(characters, level, id, {4.0f, 0.0f, 2.0f}, 60, jobs);
+    const physics::CharacterState& state = characters.state(id);
+    REBEL_CHECK(state.position.x < 3.0f - 0.4f && state.position.x > 3.0f - 0.45f);
+    REBEL_CHECK(std::abs(state.position.z - 1.0f) < 0.1f);
+    REBEL_CHECK(std::abs(state.velocity.x) < 0.05f && std::abs(state.velocity.z - 2.0f) < 0.05f);
+    REBEL_CHECK(state.grounded && std::abs(state.position.y - kStanding) < 0.01f);
+}
+
+void testStepsOntoKerbs(const Level& level, jobs::JobSystem& jobs)
+{
+    physics::CharacterWorld characters;
+    const physics::CharacterId kerb = drop(characters, level, 10.0f, jobs);
+    const Walk up = walk(characters, level, kerb, {4.0f, 0.0f, 0.0f}, 45, jobs);
+    REBEL_CHECK(up.steps > 0 && up.airborne == 0);
+    REBEL_CHECK(characters.state(kerb).position.x > 2.9f);
+    REBEL_CHECK(std::abs(characters.state(kerb).position.y - (0.25f + kStanding)) < 0.01f);
+    // Off its far side snapped straight down rather than launched.
+    const Walk off = walk(characters, level, kerb, {4.0f, 0.0f, 0.0f}, 60, jobs);
+    REBEL_CHECK(off.snaps > 0 && off.airborne == 0);
+    REBEL_CHECK(characters.state(kerb).position.x > 6.0f + 0.4f);
+    REBEL_CHECK(std::abs(characters.state(kerb).position.y - kStanding) < 0.01f);
+
+    const physics::CharacterId ledge = drop(characters, level, 20.0f, jobs);
+    const Walk blocked = walk(characters, level, ledge, {4.0f, 0.0f, 0.0f}, 45, jobs);
+    REBEL_CHECK(blocked.steps == 0);
+    REBEL_CHECK(characters.state(ledge).position.x < 2.0f - 0.4f);
+    REBEL_CHECK(std::abs(characters.state(ledge).position.y - kStanding) < 0.01f);
+}
+
+void testSlopes(const Level& level, jobs::JobSystem& jobs)
+{
+    // Up 30 degrees at full horizontal speed, resting on the slope.
+    physics::CharacterWorld characters;
+    const physics::CharacterId gentle = drop(characters, level, 30.0f, jobs);
+    const Walk up = walk(characters, level, gentle, {4.0f, 0.0f, 0.0f}, 60, jobs);
+    const physics::CharacterState& state = characters.state(gentle);
+    const float angle = 0.5236f;
+    REBEL_CHECK(up.airborne == 0);
+    REBEL_CHECK(std::abs(state.position.x - 4.0f) < 0.1f);
+    const float onSlope = std::tan(angle) * (state.position.x - 2.0f) + 0.42f / std::cos(angle) + 0.5f;
+    REBEL_CHECK(std::abs(state.position.y - onSlope) < 0.02f);
+    REBEL_CHECK(math::dot(state.groundNormal, Vec3{-std::sin(angle), std::cos(angle), 0.0f}) > 0.999f);
+
+    // And back down without leaving the ground.
+    const Walk down = walk(characters, level, gentle, {-4.0f, 0.0f, 0.0f}, 60, jobs);
+    REBEL_CHECK(down.airborne == 0);
+    REBEL_CHECK(std::abs(state.position.y - kStanding) < 0.01f);
+
+    // 60 degrees is too steep to climb.
+    const physics::CharacterId steep = drop(characters, level, 40.0f, jobs);
+    walk(characters, level, steep, {4.0f, 0.0f, 0.0f}, 60, jobs);
+    REBEL_CHECK(characters.state(steep).position.x < 2.0f);
+    REBEL_CHECK(characters.state(steep).position.y < kStanding + 0.3f);
+}
+
+void testJumps(const Level& level, jobs::JobSystem& jobs)
+{
+    // Up at 5 m/s rises 5^2 / 2g and is back down in 2 * 5 / g seconds.
+    physics::CharacterWorld characters;
+    const physics::CharacterId id = drop(characters, level, -20.0f, jobs);
+    const Walk jump = walk(characters, level, id, {0.0f, 5.0f, 0.0f}, 1, jobs);
+    REBEL_CHECK(jump.airborne == 1);
+    const Walk flight = walk(characters, level, id, {}, 80, jobs);
+    REBEL_CHECK(std::abs(flight.highest - (kStanding + 25.0f / (2.0f * 9.81f))) < 0.1f);
+    REBEL_CHECK(flight.airborne > 55 && flight.airborne < 65);
+    REBEL_CHECK(characters.state(id).grounded);
+    REBEL_CHECK(std::abs(characters.state(id).position.y - kStanding) < 0.01f);
+}
+
+void testNoTunnelling(const Level& level, jobs::JobSystem& jobs)
+{
+    // 10 m in a frame at a 4 cm wall.
+    physics::CharacterWorld characters;
+    const physics::CharacterId id = drop(characters, level, 50.0f, jobs);
+    walk(characters, level, id, {600.0f, 0.0f, 0.0f}, 5, jobs);
+    REBEL_CHECK(characters.state(id).position.x < 3.0f - 0.02f - 0.4f);
+    REBEL_CHECK(characters.state(id).position.x > 3.0f - 0.02f - 0.45f);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    Level level;
+    buildLevel(level);
+    testLandsAndWalks(level, jobs);
+    testWallBlocksAndSlides(level, jobs);
+    testStepsOntoKerbs(level, jobs);
+    testSlopes(level, jobs);
+    testJumps(level, jobs);
+    testNoTunnelling(level, jobs);
+    return rebel::test::exitCode();
+}
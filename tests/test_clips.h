@@ -0,0 +1,39 @@
+#pragma once
+
+#include "animation/clip/animation_clip.h"
+#include "animation/transform.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace rebel::test {
+
+/// A looping clip of `bones` bones, 31 frames long, drawn from `seed`: every
+/// bone turns back and forth about an axis of its own by up to `turn`
+/// radians, sways, and breathes in scale, bone b held 0.1 b up. Turns past
+/// pi leave some rotations with w negative once cooked.
+inline animation::AnimationClip makeClip(uint32_t seed, uint32_t bones, float turn = 3.5f)
+{
+    using math::Vec3;
+    constexpr uint32_t kFrames = 31;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<animation::Transform> samples(std::size_t(kFrames) * bones);
+    for (uint32_t b = 0; b < bones; ++b) {
+        const Vec3 axis = math::normalize(Vec3{unit(rng), unit(rng), unit(rng)}, {0.0f, 1.0f, 0.0f});
+        const float amplitude = turn * unit(rng), offset = unit(rng);
+        const Vec3 sway{unit(rng), unit(rng), unit(rng)};
+        for (uint32_t f = 0; f < kFrames; ++f) {
+            const float t = 6.2831853f * float(f) / float(kFrames - 1);
+            animation::Transform& out = samples[std::size_t(f) * bones + b];
+            out.rotation = math::Quat::fromAxisAngle(axis, amplitude * std::sin(t + offset));
+            out.translation = sway * std::cos(t + offset) + Vec3{0.0f, 0.1f * float(b), 0.0f};
+            out.scale = Vec3{1.0f, 1.0f, 1.0f} * (1.0f + 0.1f * std::sin(t));
+        }
+    }
+    return animation::AnimationClip({.bones = bones, .frames = kFrames, .samples = samples});
+}
+
+} // namespace rebel::test
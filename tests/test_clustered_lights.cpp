@@ -0,0 +1,165 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "render/lighting/clustered_lights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Every cluster lists, in ascending order, every light that reaches a point
+// inside it and no light that is nowhere near it, checked cluster by
+// cluster against brute force; the result does not depend on the number of
+// workers.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr render::ClusterGridDesc kGrid{.tilesX = 8, .tilesY = 4, .slices = 6};
+
+const render::ClusterView kView{
+    .view = math::Mat4::lookAt({0.0f, 2.0f, 0.0f}, {1.0f, 2.0f, -4.0f}, {0.0f, 1.0f, 0.0f}),
+    .verticalFov = 1.0f,
+    .aspect = 2.0f,
+    .nearPlane = 0.5f,
+    .farPlane = 60.0f,
+};
+
+std::vector<render::PointLight> makeLights()
+{
+    // Around and behind the camera as well as inside the frustum, so some
+    // lights straddle the near and far planes and the frustum sides.
+    std::vector<render::PointLight> lights(300);
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (render::PointLight& light : lights) {
+        light.position = {unit(rng) * 80.0f - 40.0f, unit(rng) * 12.0f - 4.0f, 6.0f - unit(rng) * 72.0f};
+        light.radius = 0.5f + unit(rng) * 6.0f;
+    }
+    return lights;
+}
+
+// Depth where `slice` begins: slices are exponentially spaced.
+double sliceDepth(uint32_t slice)
+{
+    return kView.nearPlane * std::pow(double(kView.farPlane) / kView.nearPlane, double(slice) / kGrid.slices);
+}
+
+// View-space point at normalized screen (u, v), v down, and view distance d.
+Vec3 cellPoint(double u, double v, double d)
+{
+    const double tanY = std::tan(kView.verticalFov * 0.5), tanX = tanY * kView.aspect;
+    return {float((u * 2.0 - 1.0) * tanX * d), float((1.0 - v * 2.0) * tanY * d), float(-d)};
+}
+
+void testMatchesBruteForce(jobs::JobSystem& jobs)
+{
+    const std::vector<render::PointLight> lights = makeLights();
+    render::ClusteredLights clusters(kGrid);
+    clusters.build(lights, kView, jobs);
+
+    std::vector<Vec3> viewPositions;
+    for (const render::PointLight& light : lights)
+        viewPositions.push_back(kView.view.transformPoint(light.position));
+
+    constexpr int kSamples = 5; // per axis, corners included
+    uint32_t missing = 0, stray = 0, unsorted = 0, reaching = 0;
+    for (uint32_t s = 0; s < kGrid.slices; ++s) {
+        for (uint32_t ty = 0; ty < kGrid.tilesY; ++ty) {
+            for (uint32_t tx = 0; tx < kGrid.tilesX; ++tx) {
+                const uint32_t cluster = (s * kGrid.tilesY + ty) * kGrid.tilesX + tx;
+                const std::span<const uint32_t> list = clusters.lights(cluster);
+                unsorted += !std::is_sorted(list.begin(), list.end());
+
+                // Points spread through the cell, and the cell's bounds.
+                std::vector<Vec3> points;
+                Vec3 lo{INFINITY, INFINITY, INFINITY}, hi{-INFINITY, -INFINITY, -INFINITY};
+                for (int k = 0; k < kSamples * kSamples * kSamples; ++k) {
+                    const double fu = double(k % kSamples) / (kSamples - 1);
+                    const double fv = double(k / kSamples % kSamples) / (kSamples - 1);
+                    const double fd = double(k / (kSamples * kSamples)) / (kSamples - 1);
+                    const Vec3 p = cellPoint((tx + fu) / kGrid.tilesX, (ty + fv) / kGrid.tilesY,
+                                             sliceDepth(s) + (sliceDepth(s + 1) - sliceDepth(s)) * fd);
+                    points.push_back(p);
+                    lo = math::min(lo, p);
+                    hi = math::max(hi, p);
+                }
+
+                for (uint32_t l = 0; l < lights.size(); ++l) {
+                    const Vec3 c = viewPositions[l];
+                    const float r = lights[l].radius;
+                    const bool listed = std::binary_search(list.begin(), list.end(), l);
+                    const bool reaches = std::any_of(points.begin(), points.end(), [&](const Vec3& p) {
+                        return math::length(p - c) < r * 0.999f;
+                    });
+                    // The light's bounding cube misses the cell's bounds.
+                    const bool apart = c.x + r < lo.x - 1e-3f || c.x - r > hi.x + 1e-3f || c.y + r < lo.y - 1e-3f ||
+                                       c.y - r > hi.y + 1e-3f || c.z + r < lo.z - 1e-3f || c.z - r > hi.z + 1e-3f;
+                    reaching += reaches;
+                    missing += reaches && !listed;
+                    stray += apart && listed;
+                }
+            }
+        }
+    }
+    REBEL_CHECK(reaching > 500);
+    REBEL_CHECK(missing == 0);
+    REBEL_CHECK(stray == 0);
+    REBEL_CHECK(unsorted == 0);
+}
+
+void testSameForAnyWorkerCount()
+{
+    const std::vector<render::PointLight> lights = makeLights();
+    // Each build on a thread of its own, as a thread owns at most one
+    // JobSystem and main()'s is still alive.
+    auto build = [&](uint32_t workers) {
+        std::vector<uint32_t> out;
+        std::thread([&] {
+            jobs::JobSystem jobs({.workerCount = workers});
+            render::ClusteredLights clusters(kGrid);
+            clusters.build(lights, kView, jobs);
+            out.assign(clusters.lightIndices().begin(), clusters.lightIndices().end());
+            for (const render::ClusterLightRange& range : clusters.clusters()) {
+                out.push_back(range.offset);
+                out.push_back(range.count);
+            }
+        }).join();
+        return out;
+    };
+    REBEL_CHECK(build(1) == build(4));
+}
+
+void testClusterIndexFollowsGrid(jobs::JobSystem& jobs)
+{
+    render::ClusteredLights clusters(kGrid);
+    clusters.build({}, kView, jobs);
+    uint32_t wrong = 0;
+    for (uint32_t s = 0; s < kGrid.slices; ++s) {
+        const float mid = float(std::sqrt(sliceDepth(s) * sliceDepth(s + 1)));
+        wrong += clusters.slice(mid) != s;
+        for (uint32_t ty = 0; ty < kGrid.tilesY; ++ty) {
+            for (uint32_t tx = 0; tx < kGrid.tilesX; ++tx) {
+                const float u = (float(tx) + 0.5f) / kGrid.tilesX, v = (float(ty) + 0.5f) / kGrid.tilesY;
+                wrong += clusters.clusterIndex(u, v, mid) != (s * kGrid.tilesY + ty) * kGrid.tilesX + tx;
+            }
+        }
+    }
+    REBEL_CHECK(wrong == 0);
+    REBEL_CHECK(clusters.lightIndices().empty());
+    REBEL_CHECK(clusters.slice(0.0f) == 0 && clusters.slice(1e6f) == kGrid.slices - 1);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testMatchesBruteForce(jobs);
+    testSameForAnyWorkerCount();
+    testClusterIndexFollowsGrid(jobs);
+    return rebel::test::exitCode();
+}
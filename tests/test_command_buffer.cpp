@@ -0,0 +1,155 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "core/radix_sort.h"
+#include "render/command_buffer.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// The radix sort agrees with std::stable_sort, sort keys order draws the
+// way sort_key.h promises, and a queue recorded from every worker replays
+// each draw once, in key order, binding materials only when they change.
+namespace {
+
+using namespace rebel;
+using render::SortEntry;
+
+void testRadixSortMatchesStableSort()
+{
+    std::mt19937_64 rng(3);
+    for (const std::size_t n : {0u, 1u, 2u, 255u, 1000u, 100'000u}) {
+        // Few distinct values, so equal keys are common and some bytes are
+        // the same in every key; the sort has to skip those passes.
+        std::vector<SortEntry> entries(n), scratch(n);
+        for (uint32_t i = 0; i < n; ++i)
+            entries[i] = {(rng() % 64) << 40 | (rng() % 4) << 8, i};
+        std::vector<SortEntry> expected = entries;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+
+        radixSort(std::span(entries), std::span(scratch), [](const SortEntry& entry) { return entry.key; });
+        REBEL_CHECK(std::equal(entries.begin(), entries.end(), expected.begin(), expected.end(),
+                               [](const SortEntry& a, const SortEntry& b) {
+                                   return a.key == b.key && a.value == b.value;
+                               }));
+    }
+
+    std::vector<uint64_t> keys(4096), scratch(keys.size());
+    for (uint64_t& key : keys)
+        key = rng();
+    std::vector<uint64_t> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    radixSort(std::span(keys), std::span(scratch));
+    REBEL_CHECK(keys == expected);
+}
+
+void testSortKeyOrder()
+{
+    using namespace render::sortkey;
+    // Opaque: layer, then pass, then material, then nearest first.
+    REBEL_CHECK(opaque(0, 1, 0, 0.0f) > opaque(0, 0, kMaxMaterial, 1000.0f));
+    REBEL_CHECK(opaque(1, 0, 0, 0.0f) > opaque(0, 15, kMaxMaterial, 1000.0f));
+    REBEL_CHECK(opaque(0, 0, 2, 1.0f) > opaque(0, 0, 1, 500.0f));
+    REBEL_CHECK(opaque(0, 0, 1, 2.0f) > opaque(0, 0, 1, 1.0f));
+    REBEL_CHECK(opaque(0, 0, 1, -5.0f) == opaque(0, 0, 1, 0.0f));
+    // Translucent: farthest first, whatever the material.
+    REBEL_CHECK(translucent(0, 0, 9, 10.0f) < translucent(0, 0, 1, 2.0f));
+    REBEL_CHECK(translucent(0, 1, 0, 100.0f) > translucent(0, 0, 0, 1.0f));
+    REBEL_CHECK(layer(opaque(7, 3, 5, 1.0f)) == 7 && pass(opaque(7, 3, 5, 1.0f)) == 3);
+}
+
+// Remembers what it was asked to do, in order.
+class RecordingBackend final : public render::RenderBackend {
+public:
+    void beginFrame(const render::RenderFrameParams&) override
+    {
+        draws.clear();
+        bound = ~0u;
+        materialBinds = redundantBinds = wrongMaterial = 0;
+    }
+    void setPass(uint32_t, uint32_t) override { bound = ~0u; }
+    void setMaterial(uint32_t material) override
+    {
+        redundantBinds += material == bound;
+        bound = material;
+        ++materialBinds;
+    }
+    void draw(const render::DrawCommand& command) override
+    {
+        wrongMaterial += command.material != bound;
+        draws.push_back(uint32_t(command.color.x)); // the draw's id
+    }
+    void endFrame(jobs::JobSystem&) override {}
+
+    std::vector<uint32_t> draws;
+    uint32_t bound = ~0u;
+    uint32_t materialBinds = 0;
+    uint32_t redundantBinds = 0;
+    uint32_t wrongMaterial = 0;
+};
+
+void testQueueReplaysInKeyOrder()
+{
+    constexpr uint32_t kDraws = 50'000;
+    constexpr uint32_t kMaterials = 40;
+    jobs::JobSystem jobs({.workerCount = 4});
+    render::RenderQueue queue(jobs.workerCount());
+
+    std::vector<uint64_t> keyOf(kDraws);
+    std::vector<uint32_t> materialOf(kDraws);
+    std::mt19937 rng(17);
+    for (uint32_t i = 0; i < kDraws; ++i) {
+        const float depth = float(rng() % 1000) * 0.1f;
+        materialOf[i] = rng() % kMaterials;
+        keyOf[i] = rng() % 8 ? render::sortkey::opaque(0, 0, materialOf[i], depth)
+                             : render::sortkey::translucent(0, 1, materialOf[i], depth);
+    }
+
+    RecordingBackend backend;
+    for (int frame = 0; frame < 2; ++frame) {
+        queue.reset();
+        jobs.parallelFor(kDraws, 256, [&](uint32_t begin, uint32_t end) {
+            render::CommandBuffer& buffer = queue.threadBuffer();
+            for (uint32_t i = begin; i < end; ++i)
+                buffer.draw(keyOf[i], {.mesh = {},
+                                       .model = math::Mat4::identity(),
+                                       .color = {float(i), 0.0f, 0.0f, 1.0f},
+                                       .material = materialOf[i]});
+        });
+        queue.submit(backend, {}, jobs);
+
+        REBEL_CHECK(backend.draws.size() == kDraws);
+        std::vector<uint32_t> seen(kDraws, 0);
+        uint32_t outOfOrder = 0, expectedBinds = 0;
+        for (std::size_t d = 0; d < backend.draws.size(); ++d) {
+            const uint32_t id = backend.draws[d];
+            ++seen[id];
+            if (d > 0) {
+                const uint32_t prev = backend.draws[d - 1];
+                outOfOrder += keyOf[prev] > keyOf[id];
+                expectedBinds += render::sortkey::pass(keyOf[prev]) != render::sortkey::pass(keyOf[id]) ||
+                                 materialOf[prev] != materialOf[id];
+            } else {
+                expectedBinds = 1;
+            }
+        }
+        REBEL_CHECK(std::all_of(seen.begin(), seen.end(), [](uint32_t n) { return n == 1; }));
+        REBEL_CHECK(outOfOrder == 0);
+        REBEL_CHECK(backend.wrongMaterial == 0);
+        REBEL_CHECK(backend.redundantBinds == 0);
+        REBEL_CHECK(backend.materialBinds == expectedBinds);
+        REBEL_CHECK(queue.stats().materialChanges == expectedBinds);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testRadixSortMatchesStableSort();
+    testSortKeyOrder();
+    testQueueReplaysInKeyOrder();
+    return rebel::test::exitCode();
+}
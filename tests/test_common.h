@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+
+namespace rebel::test {
+
+/// Checks failed so far in this test executable.
+inline int failures = 0;
+
+inline void checkFailed(const char* expr, const char* file, int line)
+{
+    std::fprintf(stderr, "%s:%d: check '%s' failed\n", file, line, expr);
+    ++failures;
+}
+
+/// For main to return: 1 if any check failed.
+inline int exitCode()
+{
+    if (failures > 0)
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures > 0 ? 1 : 0;
+}
+
+} // namespace rebel::test
+
+/// Like REBEL_ASSERT, but active in every build and carries on after a
+/// failure, so one run reports every broken check.
+#define REBEL_CHECK(cond)                                                        \
+    do {                                                                         \
+        if (!(cond))                                                             \
+            ::rebel::test::checkFailed(#cond, __FILE__, __LINE__);               \
+    } while (0)
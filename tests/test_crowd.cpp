@@ -0,0 +1,185 @@
+#include "test_clips.h"
+#include "test_common.h"
+
+#include "animation/crowd/crowd_animator.h"
+#include "animation/transform.h"
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+// Agents snap to the nearest of a clip's phase steps, wrapping round the
+// cycle. Each update counts the distinct buckets its agents are in, poses
+// only those no agent reached before, lists exactly them, and points every
+// agent at its bucket's fixed place in the palette, which holds the bone
+// matrices that posing the clip at that step down the hierarchy gives.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr uint32_t kBones = 7;
+constexpr uint32_t kClips = 3;
+constexpr uint32_t kSteps = 16;
+
+struct Crowd {
+    animation::AnimationClip clipStore[kClips] = {test::makeClip(1, kBones), test::makeClip(2, kBones),
+                                                  test::makeClip(3, kBones)};
+    const animation::AnimationClip* clips[kClips] = {&clipStore[0], &clipStore[1], &clipStore[2]};
+    // A spine with two arms off its second bone, in LOD order.
+    std::vector<int16_t> parents{-1, 0, 1, 1, 1, 2, 3};
+    animation::Skeleton skeleton{parents};
+    std::vector<math::Mat4> inverseBind;
+    animation::CrowdAnimator animator;
+
+    static std::vector<math::Mat4> binds()
+    {
+        std::vector<math::Mat4> binds(kBones);
+        for (uint32_t b = 0; b < kBones; ++b)
+            binds[b] = math::Mat4::translation({0.0f, -0.3f * float(b), 0.1f});
+        return binds;
+    }
+
+    Crowd()
+        : inverseBind(binds())
+        , animator({.clips = clips, .skeleton = &skeleton, .inverseBind = inverseBind, .phaseSteps = kSteps})
+    {
+    }
+};
+
+void testBucket()
+{
+    const Crowd crowd;
+    const animation::CrowdAnimator& animator = crowd.animator;
+    REBEL_CHECK(animator.bucketCount() == kClips * kSteps);
+    REBEL_CHECK(animator.palette().size() == std::size_t(kClips) * kSteps * kBones * 12);
+    // Nearest step, a half step either way, wrapping round the cycle.
+    REBEL_CHECK(animator.bucket({1, 0.0f}) == kSteps);
+    REBEL_CHECK(animator.bucket({1, 0.25f}) == kSteps + 4);
+    REBEL_CHECK(animator.bucket({1, 0.25f + 0.4f / kSteps}) == kSteps + 4);
+    REBEL_CHECK(animator.bucket({1, 0.25f + 0.6f / kSteps}) == kSteps + 5);
+    REBEL_CHECK(animator.bucket({2, 0.99f}) == 2 * kSteps);
+    REBEL_CHECK(animator.bucket({2, 1.25f}) == 2 * kSteps + 4);
+    REBEL_CHECK(animator.bucket({0, -0.25f}) == 12);
+}
+
+// The skinning matrix of `bone` applied to p: the bind offset undone, then
+// each bone's local transform up to the root.
+Vec3 skin(const Crowd& crowd, std::span<const animation::Transform> local, uint32_t bone, Vec3 p)
+{
+    p = crowd.inverseBind[bone].transformPoint(p);
+    for (int b = int(bone); b >= 0; b = crowd.skeleton.parent(uint32_t(b))) {
+        const Vec3 scaled{p.x * local[b].scale.x, p.y * local[b].scale.y, p.z * local[b].scale.z};
+        p = math::rotate(local[b].rotation, scaled) + local[b].translation;
+    }
+    return p;
+}
+
+void testCounts(jobs::JobSystem& jobs)
+{
+    Crowd crowd;
+    animation::CrowdAnimator& animator = crowd.animator;
+    constexpr uint32_t kAgents = 2000;
+    std::mt19937 rng(25);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<animation::CrowdAgent> agents(kAgents);
+    for (animation::CrowdAgent& agent : agents)
+        agent = {uint32_t(rng() % kClips), unit(rng)};
+    // Most of the crowd is bunched on the first clip's first few steps,
+    // the rest spread out, so some buckets stay out of reach at first.
+    for (uint32_t i = 0; i < kAgents / 2; ++i)
+        agents[i] = {0, 0.2f * unit(rng)};
+    for (uint32_t i = kAgents / 2; i < kAgents; ++i)
+        agents[i].phase *= 0.5f;
+    std::vector<uint32_t> offsets(kAgents, ~0u);
+
+    std::set<uint32_t> cached;
+    std::vector<float> before;
+    for (uint32_t frame = 0; frame < 40; ++frame) {
+        animator.update(agents, offsets, jobs);
+        const animation::CrowdStats& stats = animator.stats();
+
+        std::set<uint32_t> occupied;
+        uint32_t misplaced = 0;
+        for (uint32_t i = 0; i < kAgents; ++i) {
+            occupied.insert(animator.bucket(agents[i]));
+            misplaced += offsets[i] != animator.bucket(agents[i]) * kBones;
+        }
+        std::set<uint32_t> fresh;
+        for (const uint32_t bucket : occupied) {
+            if (!cached.count(bucket))
+                fresh.insert(bucket);
+        }
+        const std::span<const uint32_t> written = animator.buckets();
+        REBEL_CHECK(misplaced == 0);
+        REBEL_CHECK(stats.agents == kAgents);
+        REBEL_CHECK(stats.buckets == occupied.size());
+        REBEL_CHECK(stats.evaluated == fresh.size());
+        REBEL_CHECK(written.size() == fresh.size() && std::set<uint32_t>(written.begin(), written.end()) == fresh);
+        cached.insert(fresh.begin(), fresh.end());
+        REBEL_CHECK(stats.cached == cached.size());
+        if (frame % 10 == 0 && frame > 0)
+            REBEL_CHECK(stats.evaluated == 0 && stats.buckets > 0);
+
+        // Buckets already posed keep their matrices; those never reached
+        // stay empty.
+        const std::span<const float> palette = animator.palette();
+        uint32_t changed = 0, touched = 0;
+        for (uint32_t bucket = 0; bucket < animator.bucketCount(); ++bucket) {
+            const std::size_t begin = std::size_t(bucket) * kBones * 12;
+            for (std::size_t k = begin; k < begin + kBones * 12; ++k) {
+                if (!before.empty() && !fresh.count(bucket))
+                    changed += palette[k] != before[k];
+                if (!cached.count(bucket))
+                    touched += palette[k] != 0.0f;
+            }
+        }
+        REBEL_CHECK(changed == 0 && touched == 0);
+        before.assign(palette.begin(), palette.end());
+
+        // The crowd drifts on at its own pace per agent, standing still
+        // every tenth frame so that the next poses nothing.
+        if (frame % 10 == 9)
+            continue;
+        for (uint32_t i = 0; i < kAgents; ++i)
+            agents[i].phase += 0.004f * float(1 + i % 5);
+    }
+    REBEL_CHECK(cached.size() == animator.bucketCount());
+    animator.update(agents, offsets, jobs);
+    REBEL_CHECK(animator.stats().evaluated == 0 && animator.buckets().empty());
+    REBEL_CHECK(animator.stats().cached == animator.bucketCount());
+
+    // Every bucket's matrices move points as its clip's pose at its step
+    // does.
+    const std::span<const float> palette = animator.palette();
+    const Vec3 points[] = {{0.0f, 0.0f, 0.0f}, {0.3f, -0.2f, 0.5f}, {-1.0f, 2.0f, 0.25f}};
+    float worst = 0.0f;
+    std::vector<animation::Transform> local(kBones);
+    for (uint32_t bucket = 0; bucket < animator.bucketCount(); ++bucket) {
+        const animation::AnimationClip& clip = *crowd.clips[bucket / kSteps];
+        clip.sample(float(bucket % kSteps) / float(kSteps) * clip.duration(), local);
+        for (uint32_t b = 0; b < kBones; ++b) {
+            const float* m = palette.data() + (std::size_t(bucket) * kBones + b) * 12;
+            for (const Vec3 p : points) {
+                const Vec3 got{m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3],
+                               m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+                               m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]};
+                worst = std::max(worst, math::length(got - skin(crowd, local, b, p)));
+            }
+        }
+    }
+    REBEL_CHECK(worst < 1e-4f);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testBucket();
+    testCounts(jobs);
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,292 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "render/culling/culler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Every kernel level the CPU supports keeps everything inside the frustum,
+// drops everything fully beyond one of its planes or behind an occluder,
+// and otherwise decides each object as culler.h's rules do in double
+// precision, apart from objects within rounding distance of a decision.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+using math::Vec4;
+
+// An object count that spans several jobs and ends in a partial SIMD block.
+constexpr uint32_t kObjects = 3 * render::Culler::kObjectsPerJob + 7;
+
+struct Scene {
+    render::BoundsSoA bounds;
+    std::vector<Vec3> centers, extents;
+    std::vector<float> radii;
+    math::Mat4 viewProjection;
+};
+
+Scene makeScene()
+{
+    Scene scene;
+    scene.bounds.resize(kObjects);
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> coord(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> extent(0.1f, 4.0f);
+    for (uint32_t i = 0; i < kObjects; ++i) {
+        const Vec3 c{coord(rng), coord(rng) * 0.2f, coord(rng)};
+        const Vec3 e{extent(rng), extent(rng), extent(rng)};
+        if (i % 3)
+            scene.bounds.setAabb(i, c, e);
+        else
+            scene.bounds.setSphere(i, c, e.x);
+        scene.centers.push_back(c);
+        scene.extents.push_back(i % 3 ? e : Vec3{e.x, e.x, e.x});
+        scene.radii.push_back(i % 3 ? math::length(e) : e.x);
+    }
+    scene.viewProjection = math::Mat4::perspective(1.1f, 16.0f / 9.0f, 0.5f, 100.0f) *
+                           math::Mat4::lookAt({0.0f, 2.0f, 10.0f}, {0.0f, 0.0f, -20.0f}, {0.0f, 1.0f, 0.0f});
+    return scene;
+}
+
+// Clip-space corners of object i's box.
+void corners(const Scene& scene, uint32_t i, Vec4 out[8])
+{
+    for (int k = 0; k < 8; ++k) {
+        const Vec3 s{(k & 1) ? 1.0f : -1.0f, (k & 2) ? 1.0f : -1.0f, (k & 4) ? 1.0f : -1.0f};
+        out[k] = scene.viewProjection * Vec4(scene.centers[i] + scene.extents[i] * s, 1.0f);
+    }
+}
+
+std::vector<SimdLevel> supportedLevels()
+{
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (level <= detectSimdLevel())
+            levels.push_back(level);
+    }
+    return levels;
+}
+
+struct Expected {
+    bool visible;
+    bool borderline; // close enough to a decision for float rounding to flip it
+};
+
+// Object i judged by the rules in culler.h, in double precision.
+Expected reference(const Scene& scene, const render::DepthPyramid* pyramid, uint32_t i)
+{
+    const math::Mat4& vp = scene.viewProjection;
+    const Vec3 c = scene.centers[i], e = scene.extents[i];
+    auto row = [&](int r, double out[4]) {
+        for (int k = 0; k < 4; ++k)
+            out[k] = vp.cols[k][r];
+    };
+    double rows[4][4];
+    for (int r = 0; r < 4; ++r)
+        row(r, rows[r]);
+
+    bool borderline = false;
+    for (int p = 0; p < 6; ++p) {
+        double plane[4];
+        for (int k = 0; k < 4; ++k) {
+            const double axis = p < 4 ? rows[p / 2][k] : rows[2][k];
+            plane[k] = p < 4 ? rows[3][k] + (p % 2 ? -axis : axis) : (p == 4 ? axis : rows[3][k] - axis);
+        }
+        const double length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        const double d = (plane[0] * c.x + plane[1] * c.y + plane[2] * c.z + plane[3]) / length;
+        const double box = (std::abs(plane[0]) * e.x + std::abs(plane[1]) * e.y + std::abs(plane[2]) * e.z) / length;
+        const double margin = d + std::min(double(scene.radii[i]), box);
+        if (margin < -1e-3)
+            return {false, false};
+        borderline |= margin < 1e-3;
+    }
+    if (!pyramid)
+        return {true, borderline};
+
+    double minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY, minZ = INFINITY;
+    for (int k = 0; k < 8; ++k) {
+        const double p[3] = {c.x + ((k & 1) ? e.x : -e.x), c.y + ((k & 2) ? e.y : -e.y), c.z + ((k & 4) ? e.z : -e.z)};
+        double clip[4];
+        for (int r = 0; r < 4; ++r)
+            clip[r] = rows[r][0] * p[0] + rows[r][1] * p[1] + rows[r][2] * p[2] + rows[r][3];
+        if (clip[2] < 1e-4)
+            return {true, borderline || clip[2] > -1e-4};
+        minX = std::min(minX, clip[0] / clip[3]);
+        maxX = std::max(maxX, clip[0] / clip[3]);
+        minY = std::min(minY, clip[1] / clip[3]);
+        maxY = std::max(maxY, clip[1] / clip[3]);
+        minZ = std::min(minZ, clip[2] / clip[3]);
+    }
+
+    const double w = pyramid->width(0), h = pyramid->height(0);
+    const double screen[4] = {(minX * 0.5 + 0.5) * w, (maxX * 0.5 + 0.5) * w, (0.5 - maxY * 0.5) * h,
+                              (0.5 - minY * 0.5) * h};
+    const double x0 = std::clamp(screen[0], 0.0, w - 1.0), x1 = std::clamp(screen[1], 0.0, w - 1.0);
+    const double y0 = std::clamp(screen[2], 0.0, h - 1.0), y1 = std::clamp(screen[3], 0.0, h - 1.0);
+    const double size = std::max({x1 - x0, y1 - y0, 1.0});
+    const uint32_t level = std::min(uint32_t(std::ceil(std::log2(size) - 1e-9)), pyramid->levelCount() - 1);
+    // Texel edges sit on whole pixels and levels change at powers of two.
+    for (int k = 0; k < 4; ++k) {
+        const double limit = k < 2 ? w - 1.0 : h - 1.0;
+        borderline |= screen[k] > 0.0 && screen[k] < limit && std::abs(screen[k] - std::round(screen[k])) < 1e-4;
+    }
+    borderline |= size > 1.0 && std::abs(std::log2(size) - std::round(std::log2(size))) < 1e-4;
+
+    const uint32_t ix0 = uint32_t(x0) >> level, ix1 = uint32_t(x1) >> level;
+    const uint32_t iy0 = uint32_t(y0) >> level, iy1 = uint32_t(y1) >> level;
+    const float* texels = pyramid->level(level);
+    const uint32_t stride = pyramid->width(level);
+    const double depth = std::max({texels[iy0 * stride + ix0], texels[iy0 * stride + ix1],
+                                   texels[iy1 * stride + ix0], texels[iy1 * stride + ix1]});
+    return {minZ <= depth, borderline || std::abs(minZ - depth) < 1e-5};
+}
+
+std::vector<uint32_t> cull(const Scene& scene, SimdLevel level, const render::DepthPyramid* occlusion,
+                           jobs::JobSystem& jobs)
+{
+    render::Culler culler(level);
+    const std::span<const uint32_t> visible = culler.cull(scene.bounds, {scene.viewProjection, occlusion}, jobs);
+    REBEL_CHECK(culler.stats().visible + culler.stats().frustumCulled + culler.stats().occlusionCulled == kObjects);
+    return {visible.begin(), visible.end()};
+}
+
+void testFrustumIsConservative(const Scene& scene, SimdLevel level, jobs::JobSystem& jobs)
+{
+    const std::vector<uint32_t> visible = cull(scene, level, nullptr, jobs);
+    REBEL_CHECK(std::is_sorted(visible.begin(), visible.end()));
+
+    uint32_t inside = 0, outside = 0, wrong = 0;
+    for (uint32_t i = 0; i < kObjects; ++i) {
+        Vec4 c[8];
+        corners(scene, i, c);
+        // Bit p is set when every corner is beyond clip plane p.
+        uint32_t allOut = 0x3F, anyOut = 0;
+        for (const Vec4& v : c) {
+            const uint32_t out = (v.x < -v.w ? 1u : 0u) | (v.x > v.w ? 2u : 0u) | (v.y < -v.w ? 4u : 0u) |
+                                 (v.y > v.w ? 8u : 0u) | (v.z < 0.0f ? 16u : 0u) | (v.z > v.w ? 32u : 0u);
+            allOut &= out;
+            anyOut |= out;
+        }
+        const bool kept = std::binary_search(visible.begin(), visible.end(), i);
+        if (anyOut == 0) {
+            ++inside;
+            wrong += !kept;
+        } else if (allOut != 0) {
+            ++outside;
+            wrong += kept;
+        }
+    }
+    REBEL_CHECK(inside > 100 && outside > 1000);
+    REBEL_CHECK(wrong == 0);
+}
+
+void testOcclusionAgainstAWall(const Scene& scene, SimdLevel level, jobs::JobSystem& jobs)
+{
+    // A screen-filling occluder at clip depth 0.98: objects entirely behind
+    // it are occluded, anything reaching in front of it is not.
+    constexpr uint32_t kWidth = 160, kHeight = 90;
+    constexpr float kWall = 0.98f;
+    const std::vector<float> depth(kWidth * kHeight, kWall);
+    render::DepthPyramid pyramid;
+    pyramid.build(depth.data(), kWidth, kHeight);
+
+    const std::vector<uint32_t> frustum = cull(scene, level, nullptr, jobs);
+    const std::vector<uint32_t> visible = cull(scene, level, &pyramid, jobs);
+    REBEL_CHECK(std::includes(frustum.begin(), frustum.end(), visible.begin(), visible.end()));
+
+    uint32_t behind = 0, front = 0, wrong = 0;
+    for (const uint32_t i : frustum) {
+        Vec4 c[8];
+        corners(scene, i, c);
+        float nearest = 1.0f;
+        bool crossesNear = false;
+        for (const Vec4& v : c) {
+            crossesNear |= v.z < 0.0f;
+            nearest = std::min(nearest, v.z / v.w);
+        }
+        const bool kept = std::binary_search(visible.begin(), visible.end(), i);
+        if (crossesNear || nearest < kWall - 1e-4f) {
+            ++front;
+            wrong += !kept;
+        } else if (nearest > kWall + 1e-4f) {
+            ++behind;
+            wrong += kept;
+        }
+    }
+    REBEL_CHECK(behind > 100 && front > 100);
+    REBEL_CHECK(wrong == 0);
+}
+
+void testMatchesReference(const Scene& scene, SimdLevel level, jobs::JobSystem& jobs)
+{
+    // An uneven occluder buffer, so objects sample different pyramid levels
+    // and texels; its depths sit where far objects do, so occlusion
+    // decisions are close calls.
+    constexpr uint32_t kWidth = 157, kHeight = 91;
+    std::vector<float> depth(kWidth * kHeight);
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> unit(0.9f, 1.0f);
+    for (float& d : depth)
+        d = unit(rng);
+    render::DepthPyramid pyramid;
+    pyramid.build(depth.data(), kWidth, kHeight);
+
+    const render::DepthPyramid* const occlusions[] = {nullptr, &pyramid};
+    for (const render::DepthPyramid* occlusion : occlusions) {
+        const std::vector<uint32_t> visible = cull(scene, level, occlusion, jobs);
+        uint32_t borderline = 0, wrong = 0;
+        for (uint32_t i = 0; i < kObjects; ++i) {
+            const Expected expected = reference(scene, occlusion, i);
+            borderline += expected.borderline;
+            wrong += !expected.borderline && std::binary_search(visible.begin(), visible.end(), i) != expected.visible;
+        }
+        REBEL_CHECK(borderline < kObjects / 100);
+        REBEL_CHECK(wrong == 0);
+    }
+}
+
+void testPyramidKeepsFarthestDepth()
+{
+    constexpr uint32_t kWidth = 37, kHeight = 23;
+    std::vector<float> depth(kWidth * kHeight);
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (float& d : depth)
+        d = unit(rng);
+    render::DepthPyramid pyramid;
+    pyramid.build(depth.data(), kWidth, kHeight);
+
+    REBEL_CHECK(pyramid.width(pyramid.levelCount() - 1) == 1 && pyramid.height(pyramid.levelCount() - 1) == 1);
+    uint32_t wrong = 0;
+    for (uint32_t l = 0; l < pyramid.levelCount(); ++l) {
+        for (uint32_t ty = 0; ty < pyramid.height(l); ++ty) {
+            for (uint32_t tx = 0; tx < pyramid.width(l); ++tx) {
+                float expected = 0.0f;
+                for (uint32_t y = ty << l; y < std::min((ty + 1) << l, kHeight); ++y) {
+                    for (uint32_t x = tx << l; x < std::min((tx + 1) << l, kWidth); ++x)
+                        expected = std::max(expected, depth[y * kWidth + x]);
+                }
+                wrong += pyramid.level(l)[ty * pyramid.width(l) + tx] != expected;
+            }
+        }
+    }
+    REBEL_CHECK(wrong == 0);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    const Scene scene = makeScene();
+    for (const rebel::SimdLevel level : supportedLevels()) {
+        testFrustumIsConservative(scene, level, jobs);
+        testOcclusionAgainstAWall(scene, level, jobs);
+        testMatchesReference(scene, level, jobs);
+    }
+    testPyramidKeepsFarthestDepth();
+    return rebel::test::exitCode();
+}
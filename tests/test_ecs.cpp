@@ -0,0 +1,188 @@
+#include "test_common.h"
+
+#include "core/ecs/world.h"
+
+#include <vector>
+
+// Structural changes keep component values and entity handles straight, tags
+// take no storage, and iteration visits every matching entity exactly once.
+namespace {
+
+using namespace rebel;
+
+struct Position {
+    float x, y, z;
+};
+
+struct Velocity {
+    float x, y, z;
+};
+
+struct Frozen {};
+
+void testAddRemove()
+{
+    ecs::World world;
+    const ecs::Entity a = world.create(Position{1.0f, 2.0f, 3.0f});
+    const ecs::Entity b = world.create(Position{4.0f, 5.0f, 6.0f}, Velocity{7.0f, 8.0f, 9.0f});
+    REBEL_CHECK(world.entityCount() == 2);
+    REBEL_CHECK(world.has<Position>(a) && !world.has<Velocity>(a));
+    REBEL_CHECK(world.get<Velocity>(a) == nullptr);
+
+    // Moving to another archetype keeps the existing components.
+    world.add(a, Velocity{-1.0f, -2.0f, -3.0f});
+    REBEL_CHECK(world.has<Velocity>(a));
+    REBEL_CHECK(world.get<Position>(a)->y == 2.0f && world.get<Velocity>(a)->z == -3.0f);
+    world.add(a, Velocity{0.5f, 0.5f, 0.5f});
+    REBEL_CHECK(world.get<Velocity>(a)->x == 0.5f);
+
+    // Removing a row swaps another into its place; both must stay intact.
+    world.remove<Velocity>(b);
+    REBEL_CHECK(!world.has<Velocity>(b) && world.get<Position>(b)->x == 4.0f);
+    REBEL_CHECK(world.get<Velocity>(a)->y == 0.5f && world.get<Position>(a)->z == 3.0f);
+    world.remove<Velocity>(b);
+    REBEL_CHECK(world.has<Position>(b));
+
+    world.destroy(a);
+    REBEL_CHECK(!world.alive(a) && world.get<Position>(a) == nullptr);
+    REBEL_CHECK(world.alive(b) && world.get<Position>(b)->z == 6.0f);
+    REBEL_CHECK(world.entityCount() == 1);
+
+    // A recycled index gets a new generation, so the old handle stays dead.
+    const ecs::Entity c = world.create(Position{});
+    REBEL_CHECK(world.alive(c) && !world.alive(a));
+    REBEL_CHECK(c.index != a.index || c.generation != a.generation);
+}
+
+void testTags()
+{
+    ecs::World world;
+    const ecs::Entity a = world.create(Position{1.0f, 0.0f, 0.0f});
+    const ecs::Entity b = world.create(Position{2.0f, 0.0f, 0.0f});
+    world.add<Frozen>(a);
+    REBEL_CHECK(world.has<Frozen>(a) && !world.has<Frozen>(b));
+    REBEL_CHECK(world.get<Frozen>(a) == nullptr);
+    REBEL_CHECK(world.get<Position>(a)->x == 1.0f);
+
+    ecs::Query moving = ecs::Query().with<Position>().without<Frozen>();
+    ecs::Query frozen = ecs::Query().with<Position, Frozen>();
+    float movingSum = 0.0f, frozenSum = 0.0f;
+    world.forEachChunk(moving, [&](const ecs::ChunkView& view) {
+        REBEL_CHECK(!view.has<Frozen>() && view.get<Frozen>() == nullptr);
+        for (uint32_t i = 0; i < view.size(); ++i)
+            movingSum += view.get<Position>()[i].x;
+    });
+    world.forEachChunk(frozen, [&](const ecs::ChunkView& view) {
+        REBEL_CHECK(view.has<Frozen>());
+        for (uint32_t i = 0; i < view.size(); ++i)
+            frozenSum += view.get<Position>()[i].x;
+    });
+    REBEL_CHECK(movingSum == 2.0f && frozenSum == 1.0f);
+
+    world.remove<Frozen>(a);
+    REBEL_CHECK(!world.has<Frozen>(a) && world.get<Position>(a)->x == 1.0f);
+}
+
+void testIteration()
+{
+    // Enough entities for several chunks per archetype, spread over two
+    // archetypes, with every third one destroyed and every fifth moved.
+    ecs::World world;
+    constexpr uint32_t kCount = 20'000;
+    std::vector<ecs::Entity> entities;
+    for (uint32_t i = 0; i < kCount; ++i)
+        entities.push_back(i % 2 ? world.create(Position{float(i), 0.0f, 0.0f}, Velocity{1.0f, 0.0f, 0.0f})
+                                 : world.create(Position{float(i), 0.0f, 0.0f}));
+    std::vector<bool> live(kCount, true);
+    for (uint32_t i = 0; i < kCount; i += 3) {
+        world.destroy(entities[i]);
+        live[i] = false;
+    }
+    for (uint32_t i = 1; i < kCount; i += 5) {
+        if (live[i])
+            world.add<Frozen>(entities[i]);
+    }
+
+    std::vector<int> seen(kCount, 0);
+    ecs::Query all = ecs::Query().with<Position>();
+    world.forEachChunk(all, [&](const ecs::ChunkView& view) {
+        const Position* positions = view.get<Position>();
+        for (uint32_t i = 0; i < view.size(); ++i) {
+            const uint32_t index = uint32_t(positions[i].x);
+            ++seen[index];
+            REBEL_CHECK(view.entities()[i] == entities[index]);
+        }
+    });
+    for (uint32_t i = 0; i < kCount; ++i)
+        REBEL_CHECK(seen[i] == (live[i] ? 1 : 0));
+
+    std::size_t withVelocity = 0, expected = 0;
+    world.each<Position, Velocity>([&](Position& p, const Velocity& v) {
+        p.y += v.x;
+        ++withVelocity;
+    });
+    for (uint32_t i = 1; i < kCount; i += 2)
+        expected += live[i];
+    REBEL_CHECK(withVelocity == expected);
+    REBEL_CHECK(world.get<Position>(entities[1])->y == 1.0f);
+
+    std::vector<ecs::ChunkView> chunks;
+    world.gatherChunks(all, chunks);
+    std::size_t gathered = 0;
+    for (const ecs::ChunkView& view : chunks)
+        gathered += view.size();
+    REBEL_CHECK(gathered == world.entityCount());
+}
+
+void testConstComponents()
+{
+    // A const-qualified component names the same component: reading through
+    // one visits the same entities as the plain type.
+    REBEL_CHECK(ecs::componentId<const Position>() == ecs::componentId<Position>());
+    REBEL_CHECK(ecs::componentId<const volatile Frozen>() == ecs::componentId<Frozen>());
+    REBEL_CHECK((ecs::componentMask<const Position, Velocity>() == ecs::componentMask<Position, Velocity>()));
+
+    ecs::World world;
+    for (int i = 0; i < 10; ++i) {
+        const ecs::Entity e = world.create(Position{float(i), 0.0f, 0.0f});
+        if (i % 2)
+            world.add(e, Velocity{2.0f, 0.0f, 0.0f});
+        if (i % 5 == 0)
+            world.add<Frozen>(e);
+    }
+    const ecs::Entity last = world.create(Position{});
+    REBEL_CHECK(world.has<const Position>(last) && world.get<const Position>(last) != nullptr);
+
+    float sum = 0.0f;
+    int moving = 0, frozen = 0;
+    world.each<const Position>([&](const Position& p) { sum += p.x; });
+    world.each<Position, const Velocity>([&](Position& p, const Velocity& v) {
+        p.y = v.x;
+        ++moving;
+    });
+    world.each<const Frozen>([&](const Frozen&) { ++frozen; });
+    REBEL_CHECK(sum == 45.0f && moving == 5 && frozen == 2);
+
+    uint32_t rows = 0;
+    float lifted = 0.0f;
+    ecs::Query query = ecs::Query().with<const Position>().without<const Velocity>();
+    world.forEachChunk(query, [&](const ecs::ChunkView& view) {
+        const Position* positions = view.get<const Position>();
+        REBEL_CHECK(positions != nullptr && view.has<const Position>() && !view.has<const Velocity>());
+        for (uint32_t i = 0; i < view.size(); ++i)
+            lifted += positions[i].y;
+        rows += view.size();
+    });
+    REBEL_CHECK(rows == 6 && lifted == 0.0f);
+}
+
+} // namespace
+
+int main()
+{
+    testAddRemove();
+    testTags();
+    testIteration();
+    testConstComponents();
+    return test::exitCode();
+}
@@ -0,0 +1,176 @@
+#include "test_common.h"
+
+#include "core/jobs/chase_lev_deque.h"
+#include "core/jobs/job_system.h"
+#include "core/jobs/task_graph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Every item pushed to a ChaseLevDeque is taken exactly once while thieves
+// race the owner for it, including for the last item and across wrap-around
+// of the ring; parallelFor covers every index exactly once. A task graph
+// orders systems that write what another touches, and those joined by an
+// explicit edge, waits only on direct predecessors, and runs every system
+// once per frame after all of them.
+namespace {
+
+using namespace rebel;
+
+void testDequeSteal()
+{
+    constexpr uint32_t kItems = 200'000;
+    constexpr int kThieves = 3;
+    jobs::ChaseLevDeque<uint32_t> deque(64);
+    const auto taken = std::make_unique<std::atomic<uint32_t>[]>(kItems);
+    std::atomic<bool> done = false;
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < kThieves; ++t) {
+        thieves.emplace_back([&] {
+            uint32_t item;
+            while (!done.load(std::memory_order_acquire)) {
+                if (deque.steal(item))
+                    taken[item].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // Push in bursts and pop some back, so the owner often contends for the
+    // last item; a full ring makes the owner pop instead.
+    uint32_t item;
+    for (uint32_t next = 0; next < kItems;) {
+        const uint32_t burst = 1 + next % 7;
+        for (uint32_t i = 0; i < burst && next < kItems; ++i) {
+            if (deque.push(next))
+                ++next;
+            else if (deque.pop(item))
+                taken[item].fetch_add(1, std::memory_order_relaxed);
+        }
+        if (next % 3 == 0 && deque.pop(item))
+            taken[item].fetch_add(1, std::memory_order_relaxed);
+    }
+    // Failing pops leave the deque empty; joining waits for the last steals
+    // to be counted.
+    while (deque.pop(item))
+        taken[item].fetch_add(1, std::memory_order_relaxed);
+    done.store(true, std::memory_order_release);
+    for (std::thread& thief : thieves)
+        thief.join();
+
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < kItems; ++i)
+        wrong += taken[i].load(std::memory_order_relaxed) != 1;
+    REBEL_CHECK(wrong == 0);
+    REBEL_CHECK(!deque.pop(item) && !deque.steal(item));
+}
+
+void testParallelFor()
+{
+    jobs::JobSystem jobs({.workerCount = 4});
+    constexpr uint32_t kCount = 100'000;
+    const auto hits = std::make_unique<std::atomic<uint32_t>[]>(kCount);
+    for (uint32_t grain : {1u, 7u, 1024u, kCount * 2}) {
+        for (uint32_t i = 0; i < kCount; ++i)
+            hits[i].store(0, std::memory_order_relaxed);
+        jobs.parallelFor(kCount, grain, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        uint32_t wrong = 0;
+        for (uint32_t i = 0; i < kCount; ++i)
+            wrong += hits[i].load(std::memory_order_relaxed) != 1;
+        REBEL_CHECK(wrong == 0);
+    }
+}
+
+struct A {
+    int value;
+};
+struct B {
+    int value;
+};
+struct C {
+    int value;
+};
+struct D {
+    int value;
+};
+
+void testTaskGraph()
+{
+    jobs::TaskGraph graph;
+    struct Span {
+        uint32_t start = 0, end = 0, runs = 0;
+    };
+    std::vector<Span> spans(10);
+    std::atomic<uint32_t> clock = 0;
+    const auto add = [&](const char* name, const jobs::SystemAccess& access) {
+        const uint32_t index = uint32_t(graph.systemCount());
+        return graph.add(name, access, [&, index] {
+            spans[index].start = clock.fetch_add(1);
+            std::this_thread::yield();
+            spans[index].end = clock.fetch_add(1);
+            ++spans[index].runs;
+        });
+    };
+    const uint32_t readA = add("readA", jobs::SystemAccess().read<A>());
+    const uint32_t readA2 = add("readA2", jobs::SystemAccess().read<const A>());
+    const uint32_t writeA = add("writeA", jobs::SystemAccess().write<A>());
+    const uint32_t writeA2 = add("writeA2", jobs::SystemAccess().write<A>());
+    const uint32_t writeB = add("writeB", jobs::SystemAccess().write<B>());
+    const uint32_t readC = add("readC", jobs::SystemAccess().read<C>());
+    // A chain: writeC, then transform reading C and writing D, then a
+    // system reading both, whose edge from writeC the chain implies.
+    const uint32_t writeC = add("writeC", jobs::SystemAccess().write<C>());
+    const uint32_t transform = add("transform", jobs::SystemAccess().read<C>().write<D>());
+    const uint32_t readCD = add("readCD", jobs::SystemAccess().read<C, D>());
+    const uint32_t alone = add("alone", jobs::SystemAccess());
+    graph.addDependency(writeB, readC);
+    graph.compile();
+
+    using Systems = std::vector<uint32_t>;
+    REBEL_CHECK(graph.predecessors(readA).empty());
+    REBEL_CHECK(graph.predecessors(readA2).empty()); // read/read
+    REBEL_CHECK((graph.predecessors(writeA) == Systems{readA, readA2})); // read/write
+    REBEL_CHECK((graph.predecessors(writeA2) == Systems{writeA})); // write/write, the reads implied
+    REBEL_CHECK(graph.predecessors(writeB).empty());
+    REBEL_CHECK((graph.predecessors(readC) == Systems{writeB})); // explicit
+    REBEL_CHECK((graph.predecessors(writeC) == Systems{readC}));
+    REBEL_CHECK((graph.predecessors(transform) == Systems{writeC}));
+    REBEL_CHECK((graph.predecessors(readCD) == Systems{transform})); // no writeC -> readCD
+    REBEL_CHECK(graph.predecessors(alone).empty());
+    REBEL_CHECK((graph.levels() == Systems{0, 0, 1, 2, 0, 1, 2, 3, 4, 0}));
+    REBEL_CHECK(graph.name(transform) == "transform");
+
+    // Every pair ordered directly or through a chain finishes in order,
+    // frame after frame, and every system runs once per frame.
+    const std::pair<uint32_t, uint32_t> ordered[] = {
+        {readA, writeA}, {readA2, writeA}, {readA, writeA2}, {readA2, writeA2}, {writeA, writeA2},
+        {writeB, readC}, {writeB, writeC}, {readC, writeC}, {readC, transform}, {readC, readCD},
+        {writeC, transform}, {writeC, readCD}, {transform, readCD},
+    };
+    jobs::JobSystem jobs({.workerCount = 4});
+    constexpr uint32_t kFrames = 200;
+    uint32_t misordered = 0;
+    for (uint32_t frame = 0; frame < kFrames; ++frame) {
+        graph.run(jobs);
+        for (const auto& [before, after] : ordered)
+            misordered += spans[before].end >= spans[after].start;
+    }
+    REBEL_CHECK(misordered == 0);
+    REBEL_CHECK(std::all_of(spans.begin(), spans.end(), [](const Span& s) { return s.runs == kFrames; }));
+}
+
+} // namespace
+
+int main()
+{
+    testDequeSteal();
+    testParallelFor();
+    testTaskGraph();
+    return test::exitCode();
+}
@@ -0,0 +1,362 @@
+#include "test_common.h"
+
+#include "core/memory/arena_allocator.h"
+#include "core/memory/pool.h"
+#include "core/memory/slot_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Handles to destroyed objects stay invalid after their slot is reused, in
+// Pool and SlotTable alike, and Pool's lock-free free list neither loses nor
+// duplicates slots under concurrent create/destroy. Arenas hand out aligned
+// memory, rewind to their markers, nested scratch scopes included, and
+// report running out; frame memory lives through the next frame and is
+// poisoned after that, with usage reported per subsystem in memory debug
+// builds; arena-backed containers allocate from their arena.
+namespace {
+
+using namespace rebel;
+
+struct Item {
+    uint32_t value = 0;
+    std::atomic<uint32_t>* destroyed = nullptr;
+
+    Item(uint32_t v, std::atomic<uint32_t>* counter)
+        : value(v)
+        , destroyed(counter)
+    {
+    }
+    ~Item()
+    {
+        if (destroyed)
+            destroyed->fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+void testPoolStaleHandles()
+{
+    std::atomic<uint32_t> destroyed = 0;
+    {
+        memory::Pool<Item> pool(4096);
+        const memory::Handle<Item> a = pool.create(1u, &destroyed);
+        const memory::Handle<Item> b = pool.create(2u, &destroyed);
+        REBEL_CHECK(pool.get(a)->value == 1 && pool.get(b)->value == 2);
+        REBEL_CHECK(pool.size() == 2);
+
+        REBEL_CHECK(pool.destroy(a));
+        REBEL_CHECK(destroyed == 1);
+        REBEL_CHECK(pool.get(a) == nullptr && !pool.valid(a));
+        REBEL_CHECK(!pool.destroy(a));
+        REBEL_CHECK(destroyed == 1);
+
+        // The freed slot comes back with a new generation.
+        const memory::Handle<Item> c = pool.create(3u, &destroyed);
+        REBEL_CHECK(c.index == a.index && c.generation != a.generation);
+        REBEL_CHECK(pool.get(a) == nullptr && pool.get(c)->value == 3);
+        REBEL_CHECK(!pool.destroy(a) && pool.valid(c));
+
+        REBEL_CHECK(pool.get(memory::Handle<Item>{}) == nullptr);
+        REBEL_CHECK(!pool.destroy(memory::Handle<Item>{}));
+        REBEL_CHECK(pool.get(memory::Handle<Item>{b.index, b.generation + 1}) == nullptr);
+        REBEL_CHECK(pool.get(memory::Handle<Item>{4095, 1}) == nullptr);
+
+        uint32_t visited = 0;
+        pool.forEach([&](memory::Handle<Item> handle, Item& item) {
+            REBEL_CHECK(handle == b || handle == c);
+            visited += item.value;
+        });
+        REBEL_CHECK(visited == 5);
+    }
+    // The pool destroys what is still live.
+    REBEL_CHECK(destroyed == 3);
+}
+
+void testPoolConcurrent()
+{
+    constexpr uint32_t kThreads = 4;
+    constexpr uint32_t kRounds = 20'000;
+    constexpr uint32_t kHeld = 16;
+    memory::Pool<Item> pool(kThreads * kHeld);
+
+    // Each thread keeps up to kHeld objects, destroying and recreating them;
+    // an object seen with another thread's value means a slot was handed
+    // out twice.
+    std::atomic<uint32_t> failures = 0;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<memory::Handle<Item>> held;
+            for (uint32_t round = 0; round < kRounds; ++round) {
+                if (held.size() == kHeld || (round % 3 == 2 && !held.empty())) {
+                    const memory::Handle<Item> handle = held[round % held.size()];
+                    held[round % held.size()] = held.back();
+                    held.pop_back();
+                    failures += !pool.destroy(handle);
+                    failures += pool.get(handle) != nullptr;
+                } else {
+                    const memory::Handle<Item> handle = pool.create(t, nullptr);
+                    failures += handle.isNull();
+                    if (!handle.isNull())
+                        held.push_back(handle);
+                }
+                for (const memory::Handle<Item> handle : held)
+                    failures += pool.get(handle) == nullptr || pool.get(handle)->value != t;
+            }
+            for (const memory::Handle<Item> handle : held)
+                failures += !pool.destroy(handle);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    REBEL_CHECK(failures == 0);
+    REBEL_CHECK(pool.size() == 0);
+
+    // Every slot is free exactly once: the pool fills to capacity again.
+    std::unordered_set<uint32_t> indices;
+    for (uint32_t i = 0; i < pool.capacity(); ++i)
+        indices.insert(pool.create(0u, nullptr).index);
+    REBEL_CHECK(indices.size() == pool.capacity() && !indices.contains(memory::Handle<Item>::kInvalidIndex));
+}
+
+void testSlotTable()
+{
+    memory::SlotTable<Item> table;
+    const memory::Handle<Item> a = table.create();
+    const memory::Handle<Item> b = table.create();
+    const memory::Handle<Item> c = table.create();
+    REBEL_CHECK(table.slotCount() == 3 && table.size() == 3);
+
+    table.destroy(a);
+    table.destroy(c);
+    REBEL_CHECK(!table.valid(a) && table.valid(b) && !table.valid(c));
+    REBEL_CHECK(!table.alive(a.index) && table.alive(b.index));
+
+    // Last freed first, with new generations; the table does not grow.
+    const memory::Handle<Item> d = table.create();
+    const memory::Handle<Item> e = table.create();
+    REBEL_CHECK(d.index == c.index && e.index == a.index);
+    REBEL_CHECK(!table.valid(c) && !table.valid(a) && table.valid(d) && table.valid(e));
+    REBEL_CHECK(table.handle(d.index) == d);
+    REBEL_CHECK(table.slotCount() == 3 && table.size() == 3);
+    REBEL_CHECK(!table.valid(memory::Handle<Item>{}) && !table.valid(memory::Handle<Item>{7, 1}));
+}
+
+bool filled(const void* memory, std::size_t size, unsigned char value)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(memory);
+    return std::all_of(bytes, bytes + size, [&](unsigned char b) { return b == value; });
+}
+
+void testLinearArena()
+{
+    alignas(64) unsigned char buffer[1024];
+    memory::LinearArena arena(buffer, sizeof(buffer), "test");
+    REBEL_CHECK(arena.capacity() == 1024 && arena.used() == 0);
+
+    char* a = static_cast<char*>(arena.allocate(3, 1));
+    double* b = arena.allocateArray<double>(4);
+    void* c = arena.allocate(10, 64);
+    REBEL_CHECK(reinterpret_cast<unsigned char*>(a) == buffer);
+    REBEL_CHECK(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0 && reinterpret_cast<char*>(b) >= a + 3);
+    REBEL_CHECK(reinterpret_cast<uintptr_t>(c) % 64 == 0 && static_cast<void*>(b + 4) <= c);
+    REBEL_CHECK(arena.used() == std::size_t(static_cast<unsigned char*>(c) - buffer) + 10);
+
+    // Rewinding hands the same memory out again; the high-water mark stays.
+    const std::size_t marker = arena.marker();
+    void* d = arena.allocate(100);
+    const std::size_t peak = arena.used();
+    arena.rewind(marker);
+    REBEL_CHECK(arena.used() == marker && arena.highWater() == peak);
+#if defined(REBEL_MEMORY_DEBUG)
+    REBEL_CHECK(filled(d, 100, memory::kPoisonByte));
+#endif
+    REBEL_CHECK(arena.allocate(100) == d);
+    arena.reset();
+    REBEL_CHECK(arena.used() == 0 && arena.highWater() == peak);
+    REBEL_CHECK(arena.allocate(1, 1) == buffer);
+}
+
+void testScratchScopes()
+{
+    alignas(64) unsigned char buffer[4096];
+    memory::LinearArena arena(buffer, sizeof(buffer), "scratch");
+    memory::bindThreadScratch(&arena);
+    REBEL_CHECK(&memory::threadScratch() == &arena);
+    arena.allocate(16);
+    {
+        memory::ScratchScope outer;
+        int* kept = outer.allocateArray<int>(8);
+        std::fill(kept, kept + 8, 7);
+        const std::size_t afterOuter = arena.used();
+        void* inner = nullptr;
+        {
+            memory::ScratchScope scope;
+            REBEL_CHECK(&scope.arena() == &arena);
+            inner = scope.allocate(256);
+            {
+                memory::ScratchScope innermost;
+                innermost.allocate(512);
+                REBEL_CHECK(arena.used() >= afterOuter + 768);
+            }
+            REBEL_CHECK(arena.used() == std::size_t(static_cast<unsigned char*>(inner) - buffer) + 256);
+        }
+        // Back to the outer scope's mark, its own allocations intact.
+        REBEL_CHECK(arena.used() == afterOuter);
+        REBEL_CHECK(std::all_of(kept, kept + 8, [](int v) { return v == 7; }));
+        REBEL_CHECK(outer.allocate(256) == inner);
+    }
+    REBEL_CHECK(arena.used() == 16);
+    memory::bindThreadScratch(nullptr);
+    REBEL_CHECK(&memory::threadScratch() != &arena);
+}
+
+void testFrameAllocator()
+{
+    using memory::MemoryTag;
+    memory::FrameAllocator frames(4096);
+
+    // Frame 0: a render and a physics allocation.
+    unsigned char* render = frames.allocateArray<unsigned char>(1000, MemoryTag::Render);
+    unsigned char* physics = frames.allocateArray<unsigned char>(200, MemoryTag::Physics);
+    std::memset(render, 0x11, 1000);
+    std::memset(physics, 0x22, 200);
+    const std::size_t frame0 = frames.used();
+    REBEL_CHECK(frame0 >= 1200);
+    frames.endFrame();
+
+    // Frame 1 allocates from the other buffer; frame 0's memory stays put.
+    unsigned char* animation = frames.allocateArray<unsigned char>(300, MemoryTag::Animation);
+    REBEL_CHECK(frames.used() >= 300 && frames.used() < frame0);
+    REBEL_CHECK(animation + 300 <= render || animation >= physics + 200);
+    std::memset(animation, 0x33, 300);
+    REBEL_CHECK(filled(render, 1000, 0x11) && filled(physics, 200, 0x22));
+    memory::FrameAllocatorStats stats = frames.stats();
+    REBEL_CHECK(stats.frame == 1 && stats.capacityPerFrame == 4096);
+    REBEL_CHECK(stats.lastFrameBytes == frame0 && stats.highWaterBytes == frame0);
+    frames.endFrame();
+
+    // Frame 0's buffer is current again, and what was in it is dead.
+    stats = frames.stats();
+    REBEL_CHECK(stats.frame == 2 && stats.highWaterBytes == frame0 && stats.lastFrameBytes < frame0);
+    REBEL_CHECK(frames.used() == 0 && frames.allocate(1000, alignof(std::max_align_t), MemoryTag::Render) == render);
+    REBEL_CHECK(filled(animation, 300, 0x33));
+#if defined(REBEL_MEMORY_DEBUG)
+    REBEL_CHECK(filled(render, 1000, memory::kPoisonByte) && filled(physics, 200, memory::kPoisonByte));
+
+    // Bytes per subsystem: the last frame's and the most any frame used.
+    const auto tag = [](MemoryTag t) { return std::size_t(t); };
+    REBEL_CHECK(stats.lastFrameByTag[tag(MemoryTag::Animation)] == 300);
+    REBEL_CHECK(stats.lastFrameByTag[tag(MemoryTag::Render)] == 0);
+    REBEL_CHECK(stats.highWaterByTag[tag(MemoryTag::Render)] == 1000);
+    REBEL_CHECK(stats.highWaterByTag[tag(MemoryTag::Physics)] == 200);
+    REBEL_CHECK(stats.highWaterByTag[tag(MemoryTag::Animation)] == 300);
+    REBEL_CHECK(stats.highWaterByTag[tag(MemoryTag::General)] == 0 && stats.highWaterByTag[tag(MemoryTag::AI)] == 0);
+    frames.allocate(50, 16, MemoryTag::Render);
+    frames.endFrame();
+    stats = frames.stats();
+    REBEL_CHECK(stats.lastFrameByTag[tag(MemoryTag::Render)] == 1050);
+    REBEL_CHECK(stats.highWaterByTag[tag(MemoryTag::Render)] == 1050);
+    REBEL_CHECK(stats.lastFrameByTag[tag(MemoryTag::Animation)] == 0);
+    REBEL_CHECK(stats.highWaterByTag[tag(MemoryTag::Animation)] == 300);
+    const std::string report = memory::formatStats(stats);
+    REBEL_CHECK(report.find("render") != std::string::npos && report.find("animation") != std::string::npos);
+    REBEL_CHECK(report.find("ai") == std::string::npos);
+#endif
+}
+
+void testArenaAllocator()
+{
+    alignas(64) unsigned char buffer[16384];
+    memory::LinearArena arena(buffer, sizeof(buffer), "vectors");
+    {
+        memory::ScratchVector<int> values{memory::ArenaAllocator<int>(arena)};
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i);
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(values.data());
+        REBEL_CHECK(data >= buffer && data + values.size() * sizeof(int) <= buffer + sizeof(buffer));
+        REBEL_CHECK(arena.used() >= 1000 * sizeof(int));
+        int sum = 0;
+        for (const int v : values)
+            sum += v;
+        REBEL_CHECK(sum == 999 * 1000 / 2);
+
+        // Allocators over one arena compare equal across value types.
+        const memory::ArenaAllocator<double> other(values.get_allocator());
+        REBEL_CHECK(other.arena() == &arena && other == values.get_allocator());
+    }
+
+    memory::FrameAllocator frames(4096);
+    memory::FrameVector<uint16_t> shorts{memory::ArenaAllocator<uint16_t, memory::FrameAllocator>(frames)};
+    shorts.assign(100, 9);
+    REBEL_CHECK(frames.used() >= 100 * sizeof(uint16_t));
+}
+
+// Asking for more than is left returns nullptr where asserts are compiled
+// out, and stops on the allocator's assertion where they are not.
+int exhaust(std::string_view allocator)
+{
+    if (allocator == "arena") {
+        alignas(64) unsigned char buffer[256];
+        memory::LinearArena arena(buffer, sizeof(buffer));
+        const bool full = arena.allocate(200) != nullptr && arena.allocate(100) == nullptr;
+        return full && arena.used() == 200 && arena.allocate(56, 1) != nullptr ? 0 : 1;
+    }
+    memory::FrameAllocator frames(256);
+    const bool full = frames.allocate(200) != nullptr && frames.allocate(100) == nullptr;
+    return full && frames.used() == 200 && frames.allocate(56, 1) != nullptr ? 0 : 1;
+}
+
+void testExhaustion(const char* self)
+{
+    for (const char* allocator : {"arena", "frames"}) {
+#if defined(NDEBUG) && !defined(REBEL_ENABLE_ASSERTS)
+        (void)self;
+        REBEL_CHECK(exhaust(allocator) == 0);
+#else
+        // In a child process, which the assertion aborts.
+#if defined(_WIN32)
+        const char* discard = " 2>NUL";
+#else
+        const char* discard = " 2>/dev/null";
+#endif
+        const std::string command = std::string("\"") + self + "\" --exhaust " + allocator + discard;
+        REBEL_CHECK(std::system(command.c_str()) != 0);
+#endif
+    }
+#if defined(NDEBUG) && !defined(REBEL_ENABLE_ASSERTS)
+    // Containers see an exhausted arena as std::bad_alloc.
+    memory::LinearArena arena(64);
+    bool threw = false;
+    try {
+        memory::ScratchVector<int> values(100, 0, memory::ArenaAllocator<int>(arena));
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    REBEL_CHECK(threw);
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 && std::string_view(argv[1]) == "--exhaust")
+        return exhaust(argv[2]);
+    testPoolStaleHandles();
+    testPoolConcurrent();
+    testSlotTable();
+    testLinearArena();
+    testScratchScopes();
+    testFrameAllocator();
+    testArenaAllocator();
+    testExhaustion(argv[0]);
+    return test::exitCode();
+}
@@ -0,0 +1,205 @@
+#include "test_common.h"
+
+#include "physics/collision/collide.h"
+#include "physics/collision/gjk.h"
+#include "physics/convex_hull.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Hull support queries match brute force, GJK distances and EPA depths
+// match closed forms, the general convex path agrees with the box-box
+// closed form, and manifolds keep their impulses from step to step.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+Quat randomRotation(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const Vec3 axis = math::normalize(Vec3{unit(rng), unit(rng), unit(rng)}, Vec3{0.0f, 1.0f, 0.0f});
+    return Quat::fromAxisAngle(axis, unit(rng) * 3.14159f);
+}
+
+std::vector<Vec3> boxCorners(Vec3 half)
+{
+    std::vector<Vec3> corners;
+    for (int k = 0; k < 8; ++k)
+        corners.push_back({(k & 1) ? half.x : -half.x, (k & 2) ? half.y : -half.y, (k & 4) ? half.z : -half.z});
+    return corners;
+}
+
+void testHullSupportMatchesBruteForce()
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<Vec3> points(37); // not a multiple of the four-wide blocks
+    for (Vec3& p : points)
+        p = {unit(rng) * 2.0f, unit(rng), unit(rng) * 0.5f};
+    const physics::ConvexHull hull(points);
+
+    uint32_t wrong = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const Vec3 d{unit(rng), unit(rng), unit(rng)};
+        float best = -INFINITY;
+        for (const Vec3& p : points)
+            best = std::max(best, math::dot(p, d));
+        wrong += math::dot(hull.point(hull.support(d)), d) != best;
+    }
+    REBEL_CHECK(hull.size() == points.size());
+    REBEL_CHECK(wrong == 0);
+}
+
+// Distance from a point to an oriented box, negative inside (the depth
+// to the nearest face).
+float boxDistance(Vec3 half, const physics::Transform& box, Vec3 point)
+{
+    const Vec3 local = box.applyInverse(point);
+    const Vec3 outside = math::max(Vec3{std::abs(local.x), std::abs(local.y), std::abs(local.z)} - half, Vec3{});
+    if (math::length(outside) > 0.0f)
+        return math::length(outside);
+    return -std::min({half.x - std::abs(local.x), half.y - std::abs(local.y), half.z - std::abs(local.z)});
+}
+
+void testDistanceAndDepthMatchClosedForm()
+{
+    const Vec3 half{0.8f, 0.5f, 1.2f};
+    const std::vector<Vec3> corners = boxCorners(half);
+    const physics::ConvexHull hull(corners);
+    const physics::Shape shapes[] = {physics::Shape::box(half), physics::Shape::convexHull(&hull)};
+    const physics::Shape sphere = physics::Shape::sphere(0.25f);
+
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t wrongDistance = 0, wrongNormal = 0, separated = 0, overlapping = 0;
+    for (int i = 0; i < 2000; ++i) {
+        const physics::Transform box{{unit(rng), unit(rng), unit(rng)}, randomRotation(rng)};
+        const Vec3 center = box.position + Vec3{unit(rng), unit(rng), unit(rng)} * 1.5f;
+        const float expected = boxDistance(half, box, center);
+        if (std::abs(expected) < 1e-3f)
+            continue; // on the surface, where the normal is undefined
+        for (const physics::Shape& shape : shapes) {
+            const physics::ConvexCore a(shape, box), b(sphere, {center, {}});
+            physics::ClosestPoints result;
+            if (!physics::closestPoints(a, b, 100.0f, result)) {
+                ++wrongDistance;
+                continue;
+            }
+            // The sphere's core is its centre, so the core distance is the
+            // centre's distance to the box.
+            wrongDistance += std::abs(result.distance - expected) > 2e-3f;
+            if (expected > 0.0f) {
+                ++separated;
+                const Vec3 towards = math::normalize(center - result.pointA, {});
+                wrongNormal += math::dot(towards, result.normal) < 0.999f;
+            } else {
+                ++overlapping;
+                // Pushing the box back along the normal by the depth moves
+                // the centre onto its surface.
+                physics::Transform moved = box;
+                moved.position = box.position + result.normal * result.distance;
+                wrongNormal += std::abs(boxDistance(half, moved, center)) > 2e-3f;
+            }
+        }
+    }
+    REBEL_CHECK(separated > 1000 && overlapping > 200);
+    REBEL_CHECK(wrongDistance == 0);
+    REBEL_CHECK(wrongNormal == 0);
+
+    // Beyond maxDistance, GJK gives up early.
+    physics::ClosestPoints result;
+    const physics::ConvexCore a(shapes[1], {{}, {}}), b(sphere, {{10.0f, 0.0f, 0.0f}, {}});
+    REBEL_CHECK(!physics::closestPoints(a, b, 1.0f, result));
+}
+
+float minSeparation(const physics::ContactManifold& m)
+{
+    float s = INFINITY;
+    for (uint32_t i = 0; i < m.pointCount; ++i)
+        s = std::min(s, m.points[i].separation);
+    return s;
+}
+
+void testConvexPathMatchesBoxes()
+{
+    const Vec3 halfA{2.0f, 0.5f, 2.0f}, halfB{0.5f, 0.4f, 0.6f};
+    const std::vector<Vec3> cornersA = boxCorners(halfA), cornersB = boxCorners(halfB);
+    const physics::ConvexHull hullA(cornersA), hullB(cornersB);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t compared = 0, wrong = 0;
+    for (int i = 0; i < 500; ++i) {
+        // B resting on A's top face, turned about the vertical, a little
+        // into it or a little above it.
+        const physics::Transform ta{{}, {}};
+        const physics::Transform tb{{unit(rng), halfA.y + halfB.y + unit(rng) * 0.05f, unit(rng)},
+                                    Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, unit(rng) * 3.0f)};
+        physics::ContactManifold boxes, convex;
+        const bool hitBoxes = physics::collideBoxes(halfA, ta, halfB, tb, 0.1f, boxes);
+        const bool hitConvex = physics::collideConvex(physics::Shape::convexHull(&hullA), ta,
+                                                      physics::Shape::convexHull(&hullB), tb, 0.1f, convex);
+        REBEL_CHECK(hitBoxes && hitConvex);
+        if (!hitBoxes || !hitConvex)
+            continue;
+        ++compared;
+        wrong += boxes.pointCount != 4 || convex.pointCount != 4;
+        wrong += math::dot(boxes.normal, convex.normal) < 0.99999f;
+        wrong += std::abs(minSeparation(boxes) - minSeparation(convex)) > 1e-3f;
+    }
+    REBEL_CHECK(compared == 500);
+    REBEL_CHECK(wrong == 0);
+}
+
+void testManifoldKeepsImpulses()
+{
+    const Vec3 halfA{2.0f, 0.5f, 2.0f}, halfB{0.5f, 0.5f, 0.5f};
+    const physics::Transform ta{{}, {}};
+    physics::Transform tb{{0.3f, 0.99f, -0.2f}, Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.4f)};
+
+    physics::ContactManifold previous;
+    REBEL_CHECK(physics::collideBoxes(halfA, ta, halfB, tb, 0.05f, previous));
+    physics::matchManifold(nullptr, previous, ta, 0.05f);
+    REBEL_CHECK(previous.pointCount == 4);
+    for (uint32_t i = 0; i < previous.pointCount; ++i) {
+        REBEL_CHECK(previous.points[i].normalImpulse == 0.0f);
+        previous.points[i].normalImpulse = float(i + 1);
+        previous.points[i].tangentImpulse[0] = -float(i + 1);
+    }
+
+    // A step later the box has slid and settled a little: every point is
+    // the same feature pair and picks up its impulses.
+    tb.position += Vec3{0.01f, -0.002f, 0.005f};
+    physics::ContactManifold current;
+    REBEL_CHECK(physics::collideBoxes(halfA, ta, halfB, tb, 0.05f, current));
+    physics::matchManifold(&previous, current, ta, 0.05f);
+    REBEL_CHECK(current.pointCount == previous.pointCount);
+    float total = 0.0f;
+    for (uint32_t i = 0; i < current.pointCount; ++i) {
+        total += current.points[i].normalImpulse;
+        REBEL_CHECK(current.points[i].tangentImpulse[0] == -current.points[i].normalImpulse);
+    }
+    REBEL_CHECK(total == 1.0f + 2.0f + 3.0f + 4.0f);
+
+    // Knocked onto its side, the normal swings and nothing carries over.
+    physics::ContactManifold flipped = current;
+    flipped.normal = {1.0f, 0.0f, 0.0f};
+    physics::matchManifold(&current, flipped, ta, 0.05f);
+    for (uint32_t i = 0; i < flipped.pointCount; ++i)
+        REBEL_CHECK(flipped.points[i].normalImpulse == 0.0f);
+}
+
+} // namespace
+
+int main()
+{
+    testHullSupportMatchesBruteForce();
+    testDistanceAndDepthMatchClosedForm();
+    testConvexPathMatchesBoxes();
+    testManifoldKeepsImpulses();
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,169 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/state_history.h"
+#include "physics/world.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+// Deterministic worlds hash the same whatever the worker count, and a world
+// rolled back through StateHistory, or reloaded from a snapshot, replays to
+// the same hashes as the original run. Destroying a body wakes what rests on
+// it.
+namespace {
+
+using namespace rebel;
+
+constexpr float kDt = 1.0f / 60.0f;
+
+// Stacks of boxes on a 12 x 12 grid, dropped from a little above the
+// ground so they collide, settle and go to sleep over the run.
+void buildStacks(physics::PhysicsWorld& world)
+{
+    world.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({50.0f, 1.0f, 50.0f}),
+                      .position = {0.0f, -1.0f, 0.0f}});
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+    for (int z = 0; z < 12; ++z) {
+        for (int x = 0; x < 12; ++x) {
+            for (int y = 0; y < 3; ++y)
+                world.createBody({.shape = physics::Shape::box({0.5f, 0.5f, 0.5f}),
+                                  .position = {(float(x) - 6.0f) * 1.6f + jitter(rng), 1.0f + float(y) * 1.1f,
+                                               (float(z) - 6.0f) * 1.6f + jitter(rng)},
+                                  .rotation = math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, jitter(rng) * 4.0f)});
+        }
+    }
+}
+
+// A thread owns at most one JobSystem, so each run gets a thread of its own.
+std::vector<uint64_t> stepHashes(uint32_t workers, int steps)
+{
+    std::vector<uint64_t> hashes;
+    std::thread([&] {
+        jobs::JobSystem jobs({.workerCount = workers});
+        physics::PhysicsWorld world({.deterministic = true});
+        buildStacks(world);
+        for (int i = 0; i < steps; ++i) {
+            world.step(kDt, jobs);
+            hashes.push_back(world.stateHash());
+        }
+    }).join();
+    return hashes;
+}
+
+void testDeterminism()
+{
+    const std::vector<uint64_t> one = stepHashes(1, 120);
+    REBEL_CHECK(one == stepHashes(4, 120));
+    REBEL_CHECK(one == stepHashes(1, 120));
+    REBEL_CHECK(one.front() != one.back());
+}
+
+void testSnapshot(jobs::JobSystem& jobs)
+{
+    physics::PhysicsWorld world({.deterministic = true});
+    buildStacks(world);
+    for (int i = 0; i < 30; ++i)
+        world.step(kDt, jobs);
+    std::vector<uint8_t> state;
+    world.saveState(state);
+
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < 30; ++i) {
+        world.step(kDt, jobs);
+        hashes.push_back(world.stateHash());
+    }
+
+    // Into the same world and into a fresh one.
+    world.loadState(state);
+    physics::PhysicsWorld copy({.deterministic = true});
+    copy.loadState(state);
+    REBEL_CHECK(world.stateHash() == copy.stateHash());
+    for (int i = 0; i < 30; ++i) {
+        world.step(kDt, jobs);
+        copy.step(kDt, jobs);
+        REBEL_CHECK(world.stateHash() == hashes[std::size_t(i)]);
+        REBEL_CHECK(copy.stateHash() == hashes[std::size_t(i)]);
+    }
+}
+
+void testRollback(jobs::JobSystem& jobs, std::size_t maxBytes)
+{
+    physics::PhysicsWorld world({.deterministic = true});
+    buildStacks(world);
+    physics::StateHistory history(60, maxBytes);
+    std::vector<uint64_t> hashes;
+    uint32_t overBudget = 0;
+    for (uint32_t frame = 0; frame < 90; ++frame) {
+        world.step(kDt, jobs);
+        overBudget += !history.push(frame, world);
+        hashes.push_back(world.stateHash());
+        REBEL_CHECK(history.memoryUsage() <= maxBytes || history.frameCount() == 1);
+    }
+    REBEL_CHECK(history.newestFrame() == 89);
+    REBEL_CHECK(history.frameCount() <= 60);
+    REBEL_CHECK(history.frameCount() > 1);
+    // A short window is always reported.
+    REBEL_CHECK((history.frameCount() < 60) == (history.budgetEvictions() > 0));
+    REBEL_CHECK((overBudget > 0) == (history.budgetEvictions() > 0));
+    REBEL_CHECK(!history.rollback(history.oldestFrame() - 1, world));
+    REBEL_CHECK(world.stateHash() == hashes.back());
+
+    // Back to the oldest frame held, then replay, recording again.
+    const uint32_t oldest = history.oldestFrame();
+    REBEL_CHECK(history.rollback(oldest, world));
+    REBEL_CHECK(world.stateHash() == hashes[oldest]);
+    REBEL_CHECK(history.newestFrame() == oldest);
+    for (uint32_t frame = oldest + 1; frame < 90; ++frame) {
+        world.step(kDt, jobs);
+        history.push(frame, world);
+        REBEL_CHECK(world.stateHash() == hashes[frame]);
+    }
+
+    // And part way into the re-recorded frames.
+    const uint32_t middle = history.oldestFrame() + history.frameCount() / 2;
+    REBEL_CHECK(history.rollback(middle, world));
+    REBEL_CHECK(world.stateHash() == hashes[middle]);
+}
+
+void testDestroyWakesNeighbours(jobs::JobSystem& jobs)
+{
+    physics::PhysicsWorld world;
+    const physics::BodyId floor = world.createBody({.type = physics::BodyType::Static,
+                                                    .shape = physics::Shape::box({5.0f, 0.5f, 5.0f}),
+                                                    .position = {0.0f, -0.5f, 0.0f}});
+    std::vector<physics::BodyId> stack;
+    for (int y = 0; y < 3; ++y)
+        stack.push_back(world.createBody(
+            {.shape = physics::Shape::box({0.5f, 0.5f, 0.5f}), .position = {0.0f, 0.5f + float(y) * 1.0f, 0.0f}}));
+    for (int i = 0; i < 300 && world.stats().sleepingIslands == 0; ++i)
+        world.step(kDt, jobs);
+    for (const physics::BodyId id : stack)
+        REBEL_CHECK(world.body(id)->sleeping);
+
+    // The floor is in no island, so only its pairs reach the stack.
+    world.destroyBody(floor);
+    for (const physics::BodyId id : stack)
+        REBEL_CHECK(!world.body(id)->sleeping);
+    for (int i = 0; i < 30; ++i)
+        world.step(kDt, jobs);
+    for (int y = 0; y < 3; ++y)
+        REBEL_CHECK(world.body(stack[std::size_t(y)])->transform.position.y < float(y) - 0.5f);
+}
+
+} // namespace
+
+int main()
+{
+    testDeterminism();
+    jobs::JobSystem jobs({.workerCount = 4});
+    testSnapshot(jobs);
+    testRollback(jobs, SIZE_MAX);
+    // Small enough that the budget, not the ring, limits the frames held.
+    testRollback(jobs, std::size_t(1) << 20);
+    testDestroyWakesNeighbours(jobs);
+    return test::exitCode();
+}
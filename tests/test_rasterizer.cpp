@@ -0,0 +1,216 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "render/image.h"
+#include "render/primitives.h"
+#include "render/software/software_rasterizer.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Triangle coverage matches a per-pixel reference of the fill rule, meshes
+// that tile the screen draw every pixel exactly once, and hierarchical Z
+// changes nothing but the work done.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr uint32_t kSize = 64;
+constexpr int32_t kSubpixel = 16;
+
+// Screen position in 28.4 fixed point, y down, as the rasterizer snaps it.
+struct Point {
+    int64_t x, y;
+};
+
+// NDC for a fixed-point screen position; exact for a 64x64 target.
+Vec3 toNdc(Point p)
+{
+    const float scale = 2.0f / float(kSize * kSubpixel);
+    return {float(p.x) * scale - 1.0f, 1.0f - float(p.y) * scale, 0.5f};
+}
+
+// Side of edge a->b that pixel sample p is on, with p nudged right by e
+// and down by e*e. The nudge settles samples that lie exactly on an edge
+// the way the top-left rule does, so each belongs to exactly one of the
+// triangles sharing that edge.
+int side(Point a, Point b, Point p)
+{
+    const int64_t e = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+    const int64_t tie = e != 0 ? e : a.y - b.y != 0 ? a.y - b.y : b.x - a.x;
+    return tie > 0 ? 1 : -1;
+}
+
+bool referenceCovers(const std::array<Point, 3>& t, uint32_t x, uint32_t y)
+{
+    const Point p{int64_t(x) * kSubpixel + kSubpixel / 2, int64_t(y) * kSubpixel + kSubpixel / 2};
+    const int s = side(t[0], t[1], p);
+    return s == side(t[1], t[2], p) && s == side(t[2], t[0], p);
+}
+
+// Pixels one triangle covers, read back from the depth buffer.
+std::vector<bool> rasterize(render::SoftwareRasterizer& rasterizer, const std::array<Point, 3>& t,
+                            jobs::JobSystem& jobs)
+{
+    std::array<render::Vertex, 3> vertices;
+    for (int k = 0; k < 3; ++k)
+        vertices[k] = {toNdc(t[k]), {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}};
+    const std::array<uint32_t, 3> indices{0, 1, 2};
+
+    rasterizer.beginFrame({.viewProjection = math::Mat4::identity()});
+    rasterizer.draw({.mesh = {vertices, indices}, .model = math::Mat4::identity(), .cull = render::CullMode::None});
+    rasterizer.endFrame(jobs);
+
+    std::vector<float> depth;
+    rasterizer.resolveDepth(depth);
+    std::vector<bool> covered(depth.size());
+    for (std::size_t i = 0; i < depth.size(); ++i)
+        covered[i] = depth[i] < 1.0f;
+    return covered;
+}
+
+void testCoverageMatchesReference(jobs::JobSystem& jobs)
+{
+    render::SoftwareRasterizer rasterizer({.width = kSize, .height = kSize, .depthOnly = true});
+    std::mt19937 rng(5);
+    // Reaches past the viewport edges; some coordinates land on pixel
+    // centres and edges so ties are common.
+    std::uniform_int_distribution<int64_t> coord(-8 * kSubpixel, (kSize + 8) * kSubpixel);
+
+    uint32_t mismatches = 0, covered = 0;
+    for (int i = 0; i < 300; ++i) {
+        std::array<Point, 3> t;
+        for (Point& p : t) {
+            p = {coord(rng), coord(rng)};
+            if (i % 2)
+                p = {p.x & ~int64_t(7), p.y & ~int64_t(7)};
+        }
+        if ((t[1].x - t[0].x) * (t[2].y - t[0].y) == (t[1].y - t[0].y) * (t[2].x - t[0].x))
+            continue;
+
+        const std::vector<bool> drawn = rasterize(rasterizer, t, jobs);
+        for (uint32_t y = 0; y < kSize; ++y) {
+            for (uint32_t x = 0; x < kSize; ++x) {
+                const bool expected = referenceCovers(t, x, y);
+                mismatches += drawn[y * kSize + x] != expected;
+                covered += expected;
+            }
+        }
+    }
+    REBEL_CHECK(covered > 0);
+    REBEL_CHECK(mismatches == 0);
+}
+
+void testSharedEdgesDrawOnce(jobs::JobSystem& jobs)
+{
+    render::SoftwareRasterizer rasterizer({.width = kSize, .height = kSize, .depthOnly = true});
+    std::vector<uint32_t> drawCount(kSize * kSize, 0);
+    auto drawAll = [&](const std::vector<std::array<Point, 3>>& triangles) {
+        for (const auto& t : triangles) {
+            const std::vector<bool> drawn = rasterize(rasterizer, t, jobs);
+            for (std::size_t i = 0; i < drawn.size(); ++i)
+                drawCount[i] += drawn[i];
+        }
+    };
+    auto drawnOnce = [&] {
+        uint32_t wrong = 0;
+        for (uint32_t& count : drawCount) {
+            wrong += count != 1;
+            count = 0;
+        }
+        return wrong == 0;
+    };
+
+    // A jittered grid over the whole viewport, quads split along
+    // alternating diagonals. Vertices sit on half pixels so many edges pass
+    // through pixel centres; the outer ring stays outside the viewport.
+    constexpr int kCells = 6;
+    constexpr int64_t kMin = -8 * kSubpixel, kMax = (kSize + 8) * kSubpixel;
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int64_t> jitter(-8, 8);
+    Point grid[kCells + 1][kCells + 1];
+    for (int j = 0; j <= kCells; ++j) {
+        for (int i = 0; i <= kCells; ++i) {
+            const bool border = i == 0 || j == 0 || i == kCells || j == kCells;
+            const int64_t x = (kMin + (kMax - kMin) * i / kCells) & ~int64_t(7);
+            const int64_t y = (kMin + (kMax - kMin) * j / kCells) & ~int64_t(7);
+            grid[j][i] = {x + (border ? 0 : jitter(rng) * kSubpixel / 2),
+                          y + (border ? 0 : jitter(rng) * kSubpixel / 2)};
+        }
+    }
+    std::vector<std::array<Point, 3>> triangles;
+    for (int j = 0; j < kCells; ++j) {
+        for (int i = 0; i < kCells; ++i) {
+            const Point a = grid[j][i], b = grid[j][i + 1], c = grid[j + 1][i + 1], d = grid[j + 1][i];
+            if ((i + j) % 2) {
+                triangles.push_back({a, b, c});
+                triangles.push_back({a, c, d});
+            } else {
+                triangles.push_back({a, b, d});
+                triangles.push_back({b, c, d});
+            }
+        }
+    }
+    drawAll(triangles);
+    REBEL_CHECK(drawnOnce());
+
+    // A fan whose hub sits on a pixel centre, where every triangle meets.
+    const Point hub{32 * kSubpixel + kSubpixel / 2, 32 * kSubpixel + kSubpixel / 2};
+    const Point rim[] = {{kMin, kMin}, {hub.x, kMin}, {kMax, kMin}, {kMax, hub.y},
+                         {kMax, kMax}, {hub.x, kMax}, {kMin, kMax}, {kMin, hub.y}};
+    triangles.clear();
+    for (std::size_t k = 0; k < std::size(rim); ++k)
+        triangles.push_back({hub, rim[k], rim[(k + 1) % std::size(rim)]});
+    drawAll(triangles);
+    REBEL_CHECK(drawnOnce());
+}
+
+void testHierarchicalZMatchesReference(jobs::JobSystem& jobs)
+{
+    const render::MeshData sphere = render::makeSphere(16, 12, 0.9f);
+    const render::MeshData wall = render::makeBox({2.0f, 1.0f, 0.2f});
+    const render::MeshData ground = render::makeGrid(8, 20.0f);
+    const math::Mat4 viewProjection =
+        math::Mat4::perspective(1.0f, 1.0f, 0.1f, 100.0f) *
+        math::Mat4::lookAt({0.0f, 3.0f, 8.0f}, {0.0f, 0.5f, 0.0f}, {0.0f, 1.0f, 0.0f});
+
+    auto render = [&](bool hierarchicalZ, render::Image& image, std::vector<float>& depth) {
+        render::SoftwareRasterizer rasterizer({.width = 128, .height = 128, .hierarchicalZ = hierarchicalZ});
+        rasterizer.beginFrame({.viewProjection = viewProjection});
+        // The wall goes first, so HiZ has something to reject behind it.
+        rasterizer.draw({.mesh = wall.view(), .model = math::Mat4::translation({0.0f, 1.0f, 3.0f})});
+        rasterizer.draw({.mesh = ground.view(), .model = math::Mat4::identity()});
+        for (int z = 0; z < 5; ++z) {
+            for (int x = 0; x < 5; ++x) {
+                rasterizer.draw({.mesh = sphere.view(),
+                                 .model = math::Mat4::translation({float(x) * 2.0f - 4.0f, 0.9f, float(z) * -2.0f}),
+                                 .color = {0.2f * float(x), 0.5f, 0.2f * float(z), 1.0f}});
+            }
+        }
+        rasterizer.endFrame(jobs);
+        rasterizer.resolve(image);
+        rasterizer.resolveDepth(depth);
+        return rasterizer.stats().tilesHiZRejected;
+    };
+
+    render::Image withHiZ, withoutHiZ;
+    std::vector<float> depthWithHiZ, depthWithoutHiZ;
+    REBEL_CHECK(render(true, withHiZ, depthWithHiZ) > 0);
+    REBEL_CHECK(render(false, withoutHiZ, depthWithoutHiZ) == 0);
+    REBEL_CHECK(depthWithHiZ == depthWithoutHiZ);
+    REBEL_CHECK(withHiZ.pixels == withoutHiZ.pixels);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testCoverageMatchesReference(jobs);
+    testSharedEdgesDrawOnce(jobs);
+    testHierarchicalZMatchesReference(jobs);
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,218 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/collision/shape_cast.h"
+#include "physics/query/scene_query.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Batched rays, sweeps and overlaps find what testing every body in turn
+// finds, with and without packets and at every SIMD level the CPU has;
+// any-hit rays agree on whether something is hit, and ignored bodies are
+// skipped.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+struct Scene {
+    physics::PhysicsWorld world;
+    std::vector<physics::BodyId> bodies;
+};
+
+// Boxes, spheres and capsules scattered through a 40 m cube, some
+// overlapping, plus a ground box under them all.
+void buildScene(Scene& scene)
+{
+    scene.bodies.push_back(scene.world.createBody({.type = physics::BodyType::Static,
+                                                   .shape = physics::Shape::box({40.0f, 1.0f, 40.0f}),
+                                                   .position = {0.0f, -21.0f, 0.0f}}));
+    std::mt19937 rng(15);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int i = 0; i < 800; ++i) {
+        const float size = 0.3f + 1.2f * (unit(rng) * 0.5f + 0.5f);
+        const physics::Shape shape = i % 3 == 0   ? physics::Shape::sphere(size)
+                                     : i % 3 == 1 ? physics::Shape::box({size, size * 0.5f, size * 1.5f})
+                                                  : physics::Shape::capsule(size * 0.5f, size);
+        const Vec3 axis = math::normalize(Vec3{unit(rng), unit(rng), unit(rng)}, {0.0f, 1.0f, 0.0f});
+        scene.bodies.push_back(scene.world.createBody({.type = physics::BodyType::Static,
+                                                       .shape = shape,
+                                                       .position = Vec3{unit(rng), unit(rng), unit(rng)} * 20.0f,
+                                                       .rotation = Quat::fromAxisAngle(axis, unit(rng) * 3.0f)}));
+    }
+}
+
+// Fans of eight sight lines from shared eyes, so packets form, then rays
+// from anywhere to anywhere.
+std::vector<physics::Ray> makeRays()
+{
+    std::mt19937 rng(16);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<physics::Ray> rays;
+    for (int fan = 0; fan < 256; ++fan) {
+        const Vec3 eye = Vec3{unit(rng), unit(rng), unit(rng)} * 25.0f;
+        const Vec3 look = math::normalize(Vec3{unit(rng), unit(rng), unit(rng)}, {1.0f, 0.0f, 0.0f});
+        for (int k = 0; k < 8; ++k) {
+            const Vec3 spread = Vec3{unit(rng), unit(rng), unit(rng)} * 0.15f;
+            rays.push_back({eye, math::normalize(look + spread, look), 80.0f, {}});
+        }
+    }
+    for (int i = 0; i < 2000; ++i) {
+        const Vec3 direction = math::normalize(Vec3{unit(rng), unit(rng), unit(rng)}, {0.0f, -1.0f, 0.0f});
+        rays.push_back({Vec3{unit(rng), unit(rng), unit(rng)} * 25.0f, direction, 20.0f + 60.0f * unit(rng), {}});
+    }
+    return rays;
+}
+
+// Nearest body along the ray, testing every body; null when none.
+physics::BodyId nearestHit(const Scene& scene, const physics::Ray& ray, float& distance)
+{
+    physics::BodyId nearest;
+    distance = ray.maxDistance;
+    for (const physics::BodyId id : scene.bodies) {
+        if (id == ray.ignore)
+            continue;
+        const physics::Body& body = *scene.world.body(id);
+        physics::CastHit hit;
+        if (physics::rayCast(body.shape, body.transform, ray.origin, ray.direction, distance, hit) &&
+            hit.distance < distance) {
+            distance = hit.distance;
+            nearest = id;
+        }
+    }
+    return nearest;
+}
+
+std::vector<SimdLevel> simdLevels()
+{
+    std::vector<SimdLevel> levels{SimdLevel::Scalar};
+    if (detectSimdLevel() != SimdLevel::Scalar)
+        levels.push_back(SimdLevel::Avx2);
+    return levels;
+}
+
+void testRaysMatchBruteForce(const Scene& scene, jobs::JobSystem& jobs)
+{
+    std::vector<physics::Ray> rays = makeRays();
+    // Every tenth ray ignores the body it would hit first.
+    std::vector<float> expectedDistance(rays.size());
+    std::vector<physics::BodyId> expectedBody(rays.size());
+    uint32_t hits = 0, ignoring = 0;
+    for (std::size_t i = 0; i < rays.size(); ++i) {
+        expectedBody[i] = nearestHit(scene, rays[i], expectedDistance[i]);
+        if (i % 10 == 0 && !expectedBody[i].isNull()) {
+            rays[i].ignore = expectedBody[i];
+            expectedBody[i] = nearestHit(scene, rays[i], expectedDistance[i]);
+            ++ignoring;
+        }
+        hits += !expectedBody[i].isNull();
+    }
+    REBEL_CHECK(hits > rays.size() / 4 && hits < rays.size());
+    REBEL_CHECK(ignoring > 50);
+
+    const std::size_t n = rays.size();
+    std::vector<physics::BodyId> bodies(n);
+    std::vector<float> distances(n);
+    std::vector<Vec3> points(n), normals(n);
+    const physics::CastResults results{bodies, distances, points, normals};
+    for (const SimdLevel level : simdLevels()) {
+        for (const bool packets : {false, true}) {
+            physics::SceneQuery query({.simdLevel = level, .packets = packets});
+            query.raycast(scene.world, rays, physics::QueryMode::Closest, results, jobs);
+            REBEL_CHECK(query.stats().queries == n);
+            REBEL_CHECK(packets ? query.stats().packets >= 128 : query.stats().packets == 0);
+            uint32_t wrongDistance = 0, wrongBody = 0, wrongPoint = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                wrongDistance += std::abs(distances[i] - expectedDistance[i]) > 1e-4f;
+                // Rays starting inside two bodies at once may report either.
+                wrongBody += bodies[i] != expectedBody[i] && expectedDistance[i] > 0.0f;
+                if (!bodies[i].isNull())
+                    wrongPoint += math::length(points[i] - (rays[i].origin + rays[i].direction * distances[i])) >
+                                  1e-3f;
+            }
+            REBEL_CHECK(wrongDistance == 0);
+            REBEL_CHECK(wrongBody == 0);
+            REBEL_CHECK(wrongPoint == 0);
+
+            query.raycast(scene.world, rays, physics::QueryMode::Any, results, jobs);
+            uint32_t wrongAny = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                wrongAny += bodies[i].isNull() != expectedBody[i].isNull();
+            REBEL_CHECK(wrongAny == 0);
+        }
+    }
+}
+
+void testSweepsAndOverlapsMatchBruteForce(const Scene& scene, jobs::JobSystem& jobs)
+{
+    const std::vector<physics::Ray> rays = makeRays();
+    std::vector<physics::ShapeSweep> sweeps;
+    std::vector<physics::ShapeOverlap> overlaps;
+    for (std::size_t i = 0; i < rays.size(); i += 7) {
+        const physics::Shape shape = i % 2 ? physics::Shape::capsule(0.4f, 0.5f) : physics::Shape::sphere(0.6f);
+        const physics::Transform start{rays[i].origin, Quat::fromAxisAngle({1.0f, 0.0f, 0.0f}, float(i))};
+        sweeps.push_back({shape, start, rays[i].direction, 15.0f, {}});
+        overlaps.push_back({shape, start});
+    }
+
+    const std::size_t n = sweeps.size();
+    std::vector<physics::BodyId> bodies(n * 16);
+    std::vector<float> distances(n);
+    std::vector<uint32_t> counts(n);
+    physics::SceneQuery query;
+    query.sweep(scene.world, sweeps, physics::QueryMode::Closest, {{bodies.data(), n}, distances, {}, {}}, jobs);
+    uint32_t hits = 0, wrong = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const physics::ShapeSweep& s = sweeps[i];
+        float nearest = s.maxDistance;
+        for (const physics::BodyId id : scene.bodies) {
+            const physics::Body& body = *scene.world.body(id);
+            physics::CastHit hit;
+            if (physics::shapeCast(s.shape, s.start, s.direction, nearest, body.shape, body.transform, hit))
+                nearest = std::min(nearest, hit.distance);
+        }
+        hits += nearest < s.maxDistance;
+        wrong += std::abs(distances[i] - nearest) > 1e-3f;
+    }
+    REBEL_CHECK(hits > n / 4);
+    REBEL_CHECK(wrong == 0);
+
+    query.overlap(scene.world, overlaps, {16, counts, bodies}, jobs);
+    uint32_t touching = 0;
+    wrong = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::vector<physics::BodyId> expected;
+        for (const physics::BodyId id : scene.bodies) {
+            const physics::Body& body = *scene.world.body(id);
+            if (physics::shapesOverlap(overlaps[i].shape, overlaps[i].transform, body.shape, body.transform))
+                expected.push_back(id);
+        }
+        if (expected.size() > 16)
+            continue;
+        touching += !expected.empty();
+        std::vector<physics::BodyId> found(bodies.begin() + i * 16, bodies.begin() + i * 16 + counts[i]);
+        const auto byBits = [](physics::BodyId a, physics::BodyId b) { return a.bits() < b.bits(); };
+        std::sort(expected.begin(), expected.end(), byBits);
+        std::sort(found.begin(), found.end(), byBits);
+        wrong += found != expected;
+    }
+    REBEL_CHECK(touching > 10);
+    REBEL_CHECK(wrong == 0);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    Scene scene;
+    buildScene(scene);
+    testRaysMatchBruteForce(scene, jobs);
+    testSweepsAndOverlapsMatchBruteForce(scene, jobs);
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,202 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/softbody/soft_body_world.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+// A pinned rope swings down and hangs at its rest length, a cloth's pinned
+// row follows its pins, the SSE and AVX2 kernels agree, a soft block lands
+// on the ground keeping its volume, and cloth draped over a sphere stays
+// outside it.
+namespace {
+
+using namespace rebel;
+using math::Quat;
+using math::Vec3;
+
+constexpr float kDt = 1.0f / 60.0f;
+constexpr uint32_t kSegments = 20;
+constexpr float kLength = 2.0f;
+
+// A rope pinned at one end, started out sideways along +X so it swings
+// down about the pin; returns its particles after ten seconds.
+std::vector<physics::SoftParticle> hangRope(uint32_t substeps, jobs::JobSystem& jobs)
+{
+    physics::SoftBodyDesc desc =
+        physics::makeRope(kSegments, kLength, {{0.0f, 5.0f, 0.0f}, Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 1.5708f)});
+    desc.inverseMasses.assign(desc.positions.size(), 1.0f);
+    desc.inverseMasses[0] = 0.0f;
+    desc.damping = 1.0f;
+    REBEL_CHECK(desc.positions.back().x > kLength * 0.99f);
+
+    physics::SoftBodyWorld world({.substeps = substeps});
+    const physics::SoftBodyId rope = world.createBody(desc);
+    for (int i = 0; i < 600; ++i)
+        world.step(kDt, nullptr, jobs);
+    const std::span<const physics::SoftParticle> particles = world.particles(rope);
+    return {particles.begin(), particles.end()};
+}
+
+// Worst stretch of a link, as a fraction of its rest length.
+float worstStretch(const std::vector<physics::SoftParticle>& particles)
+{
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < kSegments; ++i) {
+        const float link = math::length(particles[i + 1].position - particles[i].position);
+        worst = std::max(worst, std::abs(link / (kLength / kSegments) - 1.0f));
+    }
+    return worst;
+}
+
+void testRopeHangs(jobs::JobSystem& jobs)
+{
+    const std::vector<physics::SoftParticle> particles = hangRope(4, jobs);
+    REBEL_CHECK(particles.size() == kSegments + 1);
+    REBEL_CHECK(math::length(particles[0].position - Vec3{0.0f, 5.0f, 0.0f}) == 0.0f);
+    // Hanging straight down below the pin, about its rest length.
+    const Vec3 end = particles[kSegments].position;
+    REBEL_CHECK(std::abs(end.x) < 0.05f && std::abs(end.z) < 1e-4f);
+    REBEL_CHECK(end.y < 5.0f - kLength && end.y > 5.0f - kLength * 1.03f);
+    // One projection per substep leaves the top links, which carry the
+    // whole rope, stretched a little; more substeps take it out.
+    const float stretch = worstStretch(particles);
+    REBEL_CHECK(stretch < 0.1f);
+    REBEL_CHECK(worstStretch(hangRope(16, jobs)) < stretch * 0.5f);
+}
+
+// A 16 x 16 cloth pinned along its top row, held out flat and let go while
+// its pins are dragged sideways.
+std::vector<physics::SoftParticle> swingCloth(SimdLevel level, jobs::JobSystem& jobs)
+{
+    physics::SoftBodyDesc desc =
+        physics::makeCloth(16, 16, 0.1f, {{0.0f, 3.0f, 0.0f}, Quat::fromAxisAngle({1.0f, 0.0f, 0.0f}, 1.5708f)});
+    desc.inverseMasses.assign(desc.positions.size(), 1.0f);
+    std::fill_n(desc.inverseMasses.begin(), 16, 0.0f);
+    desc.damping = 2.0f;
+
+    physics::SoftBodyWorld world({.simdLevel = level});
+    const physics::SoftBodyId cloth = world.createBody(desc);
+    for (int i = 0; i < 90; ++i) {
+        const float shift = 0.01f * float(i);
+        for (uint32_t column = 0; column < 16; ++column)
+            world.setPinned(cloth, column, desc.positions[column] + Vec3{shift, 0.0f, 0.0f});
+        world.step(kDt, nullptr, jobs);
+    }
+    REBEL_CHECK(world.stats().distanceConstraints == desc.distances.size());
+    REBEL_CHECK(world.stats().colors > 0 && world.stats().colors <= physics::SoftBodyWorld::kMaxColors);
+
+    const std::span<const physics::SoftParticle> particles = world.particles(cloth);
+    // The pinned row is exactly where it was put.
+    uint32_t misplaced = 0;
+    for (uint32_t column = 0; column < 16; ++column)
+        misplaced += math::length(particles[column].position - (desc.positions[column] + Vec3{0.89f, 0.0f, 0.0f})) >
+                     1e-5f;
+    REBEL_CHECK(misplaced == 0);
+    return {particles.begin(), particles.end()};
+}
+
+void testKernelsAgree(jobs::JobSystem& jobs)
+{
+    // Below AVX2 the world runs its SSE kernels.
+    const std::vector<physics::SoftParticle> sse = swingCloth(SimdLevel::Scalar, jobs);
+    // The cloth has fallen from flat to hanging.
+    REBEL_CHECK(sse.back().position.y < 3.0f - 1.0f);
+    if (detectSimdLevel() == SimdLevel::Scalar)
+        return;
+    const std::vector<physics::SoftParticle> avx2 = swingCloth(SimdLevel::Avx2, jobs);
+    float worst = 0.0f;
+    for (std::size_t i = 0; i < sse.size(); ++i)
+        worst = std::max(worst, math::length(sse[i].position - avx2[i].position));
+    REBEL_CHECK(worst < 1e-3f);
+}
+
+// Six times the body's volume, summed over its tetrahedra, which alternate
+// in orientation.
+float volume(const physics::SoftBodyDesc& desc, std::span<const physics::SoftParticle> particles)
+{
+    float sum = 0.0f;
+    for (const physics::VolumeConstraint& tet : desc.volumes) {
+        const Vec3 p0 = particles[tet.particles[0]].position;
+        const Vec3 e1 = particles[tet.particles[1]].position - p0;
+        const Vec3 e2 = particles[tet.particles[2]].position - p0;
+        const Vec3 e3 = particles[tet.particles[3]].position - p0;
+        sum += std::abs(math::dot(math::cross(e1, e2), e3));
+    }
+    return sum;
+}
+
+void testBlockLandsAndKeepsVolume(jobs::JobSystem& jobs)
+{
+    physics::PhysicsWorld rigid;
+    rigid.createBody({.type = physics::BodyType::Static,
+                      .shape = physics::Shape::box({10.0f, 1.0f, 10.0f}),
+                      .position = {0.0f, -1.0f, 0.0f}});
+    rigid.step(kDt, jobs);
+
+    const physics::SoftBodyDesc desc = physics::makeBlock(4, 4, 4, 0.1f, {{-0.2f, 1.0f, -0.2f}, {}});
+    physics::SoftBodyWorld world;
+    const physics::SoftBodyId block = world.createBody(desc);
+    const float restVolume = volume(desc, world.particles(block));
+    REBEL_CHECK(std::abs(restVolume - 6.0f * 0.4f * 0.4f * 0.4f) < 1e-4f);
+
+    for (int i = 0; i < 180; ++i)
+        world.step(kDt, &rigid, jobs);
+    REBEL_CHECK(world.stats().volumeConstraints == desc.volumes.size());
+    float lowest = FLT_MAX, highest = -FLT_MAX;
+    for (const physics::SoftParticle& particle : world.particles(block)) {
+        lowest = std::min(lowest, particle.position.y);
+        highest = std::max(highest, particle.position.y);
+    }
+    // Resting on the ground at its particle radius, not squashed flat.
+    REBEL_CHECK(std::abs(lowest - desc.particleRadius) < 0.005f);
+    REBEL_CHECK(highest > lowest + 0.35f);
+    REBEL_CHECK(std::abs(volume(desc, world.particles(block)) / restVolume - 1.0f) < 0.05f);
+    REBEL_CHECK(world.stats().collisions > 0);
+}
+
+void testClothDrapesOverSphere(jobs::JobSystem& jobs)
+{
+    constexpr float kRadius = 0.5f;
+    const Vec3 center{0.0f, 1.0f, 0.0f};
+    physics::PhysicsWorld rigid;
+    rigid.createBody({.type = physics::BodyType::Static, .shape = physics::Shape::sphere(kRadius), .position = center});
+    rigid.step(kDt, jobs);
+
+    // A free sheet dropped flat onto the sphere.
+    physics::SoftBodyDesc desc = physics::makeCloth(
+        24, 24, 0.06f, {{-0.69f, 1.8f, -0.69f}, Quat::fromAxisAngle({1.0f, 0.0f, 0.0f}, -1.5708f)});
+    physics::SoftBodyWorld world;
+    const physics::SoftBodyId cloth = world.createBody(desc);
+    float nearest = FLT_MAX;
+    for (int i = 0; i < 120; ++i) {
+        world.step(kDt, &rigid, jobs);
+        for (const physics::SoftParticle& particle : world.particles(cloth))
+            nearest = std::min(nearest, math::length(particle.position - center));
+    }
+    // Collisions hold particles a radius off the surface, give or take the
+    // last substep's constraint projection.
+    REBEL_CHECK(nearest > kRadius + desc.particleRadius * 0.5f);
+    REBEL_CHECK(nearest < kRadius + desc.particleRadius * 2.0f);
+    // Hanging down around it rather than sliding off.
+    float lowest = FLT_MAX;
+    for (const physics::SoftParticle& particle : world.particles(cloth))
+        lowest = std::min(lowest, particle.position.y);
+    REBEL_CHECK(lowest < center.y - 0.15f);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testRopeHangs(jobs);
+    testKernelsAgree(jobs);
+    testBlockLandsAndKeepsVolume(jobs);
+    testClothDrapesOverSphere(jobs);
+    return rebel::test::exitCode();
+}
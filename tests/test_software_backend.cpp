@@ -0,0 +1,133 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "render/image.h"
+#include "render/software/software_backend.h"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Instanced skinned draws through SoftwareBackend land where their palette
+// entries put them, not in the bind pose.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr uint32_t kSize = 64;
+constexpr uint32_t kClear = 0xFF302820;
+
+// 3x4 row-major translation, as laid out in RenderFrameParams::bonePalette.
+void writeTranslation(float* out, Vec3 t)
+{
+    const float m[12] = {1.0f, 0.0f, 0.0f, t.x, 0.0f, 1.0f, 0.0f, t.y, 0.0f, 0.0f, 1.0f, t.z};
+    std::copy(m, m + 12, out);
+}
+
+uint32_t red(uint32_t pixel) { return pixel & 0xFF; }
+uint32_t blue(uint32_t pixel) { return (pixel >> 16) & 0xFF; }
+
+// A 0.4 wide quad at the origin facing +Z, two bone influences per vertex.
+struct SkinnedQuad {
+    std::array<render::Vertex, 4> vertices{{
+        {{-0.2f, -0.2f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+        {{0.2f, -0.2f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+        {{0.2f, 0.2f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+        {{-0.2f, 0.2f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+    }};
+    std::array<uint32_t, 6> indices{0, 1, 2, 0, 2, 3};
+    std::array<uint16_t, 8> bones{0, 1, 0, 1, 0, 1, 0, 1};
+    std::array<float, 8> weights{};
+
+    explicit SkinnedQuad(float firstWeight)
+    {
+        for (std::size_t i = 0; i < weights.size(); i += 2) {
+            weights[i] = firstWeight;
+            weights[i + 1] = 1.0f - firstWeight;
+        }
+    }
+
+    render::MeshView view() const
+    {
+        render::MeshView mesh;
+        mesh.vertices = vertices;
+        mesh.indices = indices;
+        mesh.boneIndices = bones;
+        mesh.boneWeights = weights;
+        mesh.influences = 2;
+        return mesh;
+    }
+};
+
+render::Image renderQuads(const SkinnedQuad& quad, std::span<const float> palette,
+                          std::span<const std::pair<uint32_t, math::Vec4>> instances, jobs::JobSystem& jobs)
+{
+    render::SoftwareRasterizer rasterizer({.width = kSize, .height = kSize});
+    render::SoftwareBackend backend(rasterizer);
+    // Clip space is the quad's space, pushed to depth 0.5.
+    backend.beginFrame({.viewProjection = math::Mat4::translation({0.0f, 0.0f, 0.5f}),
+                        .clearColor = kClear,
+                        .bonePalette = palette});
+    for (const auto& [offset, color] : instances)
+        backend.draw({.mesh = quad.view(),
+                      .model = math::Mat4::identity(),
+                      .color = color,
+                      .cull = render::CullMode::None,
+                      .paletteOffset = offset});
+    backend.endFrame(jobs);
+
+    render::Image image;
+    rasterizer.resolve(image);
+    return image;
+}
+
+void testInstancesUseTheirPalette(jobs::JobSystem& jobs)
+{
+    // Two instances of two bones each: the first moved left, the second
+    // right. Every vertex is fully weighted to its instance's first bone.
+    std::vector<float> palette(4 * 12);
+    writeTranslation(&palette[0], {-0.5f, 0.0f, 0.0f});
+    writeTranslation(&palette[12], {0.0f, 0.0f, 0.0f});
+    writeTranslation(&palette[24], {0.5f, 0.0f, 0.0f});
+    writeTranslation(&palette[36], {0.0f, 0.0f, 0.0f});
+
+    const SkinnedQuad quad(1.0f);
+    const std::pair<uint32_t, math::Vec4> instances[] = {{0, {1.0f, 0.0f, 0.0f, 1.0f}}, {2, {0.0f, 0.0f, 1.0f, 1.0f}}};
+    const render::Image image = renderQuads(quad, palette, instances, jobs);
+
+    // NDC x = -0.5 and 0.5 are pixel columns 16 and 48.
+    const uint32_t left = image.at(16, kSize / 2), right = image.at(48, kSize / 2);
+    REBEL_CHECK(image.at(kSize / 2, kSize / 2) == kClear); // nothing left in the bind pose
+    REBEL_CHECK(left != kClear && red(left) > blue(left));
+    REBEL_CHECK(right != kClear && blue(right) > red(right));
+}
+
+void testInfluencesBlend(jobs::JobSystem& jobs)
+{
+    // Half way between a bone moved left and a bone moved right is the
+    // bind pose.
+    std::vector<float> palette(2 * 12);
+    writeTranslation(&palette[0], {-0.5f, 0.0f, 0.0f});
+    writeTranslation(&palette[12], {0.5f, 0.0f, 0.0f});
+
+    const SkinnedQuad quad(0.5f);
+    const std::pair<uint32_t, math::Vec4> instances[] = {{0, {1.0f, 1.0f, 1.0f, 1.0f}}};
+    const render::Image image = renderQuads(quad, palette, instances, jobs);
+
+    REBEL_CHECK(image.at(kSize / 2, kSize / 2) != kClear);
+    REBEL_CHECK(image.at(16, kSize / 2) == kClear);
+    REBEL_CHECK(image.at(48, kSize / 2) == kClear);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testInstancesUseTheirPalette(jobs);
+    testInfluencesBlend(jobs);
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,269 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "core/mapped_file.h"
+#include "physics/collision/shape_cast.h"
+#include "physics/heightfield.h"
+#include "physics/query/scene_query.h"
+#include "physics/triangle_mesh.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+// Heightfields keep their heights to the quantization step, and both they
+// and cooked meshes (loaded back from a mapped file) answer rays from above
+// and below as testing every triangle does, and box queries with every
+// triangle that reaches the box. Bodies dropped on either come to rest on
+// the surface.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr uint32_t kSamples = 65;
+
+float terrainHeight(float x, float z)
+{
+    return 3.0f * std::sin(x * 0.21f) * std::cos(z * 0.17f) + 0.8f * std::sin(x * 0.9f + z * 1.3f);
+}
+
+std::vector<float> makeHeights()
+{
+    std::vector<float> heights;
+    for (uint32_t r = 0; r < kSamples; ++r) {
+        for (uint32_t c = 0; c < kSamples; ++c)
+            heights.push_back(terrainHeight(float(c) - 32.0f, float(r) - 32.0f));
+    }
+    return heights;
+}
+
+// The same grid as a triangle list, split along the same diagonals, with
+// a few degenerate triangles mixed in.
+void makeMesh(std::vector<Vec3>& vertices, std::vector<uint32_t>& indices)
+{
+    for (uint32_t r = 0; r < kSamples; ++r) {
+        for (uint32_t c = 0; c < kSamples; ++c) {
+            const float x = float(c) - 32.0f, z = float(r) - 32.0f;
+            vertices.push_back({x, terrainHeight(x, z), z});
+        }
+    }
+    for (uint32_t r = 0; r + 1 < kSamples; ++r) {
+        for (uint32_t c = 0; c + 1 < kSamples; ++c) {
+            const uint32_t v = r * kSamples + c;
+            indices.insert(indices.end(), {v, v + kSamples, v + kSamples + 1, v, v + kSamples + 1, v + 1});
+            if (c == r)
+                indices.insert(indices.end(), {v, v, v + 1});
+        }
+    }
+}
+
+// Rays down onto the surface, grazing along it, and up from underneath.
+std::vector<physics::Ray> makeRays()
+{
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<physics::Ray> rays;
+    for (int i = 0; i < 3000; ++i) {
+        const float slope = std::abs(unit(rng));
+        const float dy = i % 3 == 0 ? -0.2f - 0.8f * slope : i % 3 == 1 ? 0.05f * unit(rng) : 0.3f + 0.7f * slope;
+        const float y = i % 3 == 0 ? 10.0f : i % 3 == 1 ? unit(rng) * 3.0f : -10.0f;
+        const Vec3 direction = math::normalize(Vec3{unit(rng), dy, unit(rng)}, {0.0f, -1.0f, 0.0f});
+        rays.push_back({{unit(rng) * 30.0f, y, unit(rng) * 30.0f}, direction, 60.0f, {}});
+    }
+    return rays;
+}
+
+// Casts every ray through `cast` and by testing every triangle `all`
+// yields; returns how many distances disagree by more than a millimetre.
+template <typename Cast, typename All>
+uint32_t rayMismatches(Cast&& cast, All&& all, uint32_t& hits)
+{
+    uint32_t wrong = 0;
+    hits = 0;
+    for (const physics::Ray& ray : makeRays()) {
+        physics::CastHit hit;
+        const float distance = cast(ray, hit) ? hit.distance : ray.maxDistance;
+        float best = ray.maxDistance;
+        all([&](uint32_t, const Vec3* v) {
+            physics::CastHit candidate;
+            if (physics::rayTriangle(ray.origin, ray.direction, v, best, candidate))
+                best = candidate.distance;
+        });
+        hits += best < ray.maxDistance;
+        wrong += std::abs(best - distance) > 1e-3f;
+    }
+    return wrong;
+}
+
+// Runs box queries around the terrain and returns how many triangles whose
+// bounds overlap a box were left out of its query.
+template <typename All, typename Query>
+uint32_t missedByBoxes(All&& all, Query&& query, uint32_t& reported)
+{
+    struct Triangle {
+        uint32_t id;
+        physics::Aabb bounds;
+    };
+    std::vector<Triangle> triangles;
+    all([&](uint32_t id, const Vec3* v) {
+        triangles.push_back({id, {math::min(math::min(v[0], v[1]), v[2]), math::max(math::max(v[0], v[1]), v[2])}});
+    });
+
+    std::mt19937 rng(18);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t missed = 0;
+    reported = 0;
+    for (int i = 0; i < 300; ++i) {
+        const Vec3 center{unit(rng) * 34.0f, unit(rng) * 4.0f, unit(rng) * 34.0f};
+        const physics::Aabb box =
+            physics::Aabb::fromCenterExtents(center, Vec3{0.2f + std::abs(unit(rng)) * 3.0f, std::abs(unit(rng)),
+                                                          0.2f + std::abs(unit(rng)) * 3.0f});
+        std::set<uint32_t> ids;
+        query(box, [&](uint32_t id, const Vec3*) { ids.insert(id); });
+        reported += uint32_t(ids.size());
+        for (const Triangle& t : triangles)
+            missed += physics::overlaps(t.bounds, box) && !ids.contains(t.id);
+    }
+    return missed;
+}
+
+void testHeightfield()
+{
+    const std::vector<float> heights = makeHeights();
+    const physics::Heightfield field({kSamples, kSamples, 1.0f, heights});
+    const auto [low, high] = std::minmax_element(heights.begin(), heights.end());
+    const float step = (*high - *low) / 65535.0f;
+    float worst = 0.0f;
+    for (uint32_t r = 0; r < kSamples; ++r) {
+        for (uint32_t c = 0; c < kSamples; ++c)
+            worst = std::max(worst, std::abs(field.height(c, r) - heights[r * kSamples + c]));
+    }
+    REBEL_CHECK(worst <= step * 0.5f + 1e-5f);
+    REBEL_CHECK(field.bounds().min.x == -32.0f && field.bounds().max.z == 32.0f);
+
+    const auto all = [&](auto&& fn) { field.queryTriangles(field.bounds(), fn); };
+    const auto cast = [&](const physics::Ray& ray, physics::CastHit& hit) {
+        return field.rayCast(ray.origin, ray.direction, ray.maxDistance, hit);
+    };
+    uint32_t hits = 0;
+    REBEL_CHECK(rayMismatches(cast, all, hits) == 0);
+    REBEL_CHECK(hits > 1500);
+
+    uint32_t reported = 0;
+    REBEL_CHECK(missedByBoxes(all, [&](const physics::Aabb& box, auto&& fn) { field.queryTriangles(box, fn); },
+                              reported) == 0);
+    REBEL_CHECK(reported > 1000);
+}
+
+void testMesh()
+{
+    std::vector<Vec3> vertices;
+    std::vector<uint32_t> indices;
+    makeMesh(vertices, indices);
+    const std::vector<uint8_t> cooked = physics::TriangleMesh::cook(vertices, indices);
+
+    // Through a file, as levels load them.
+    const char* path = "test_terrain.rbtm";
+    REBEL_CHECK(writeFile(path, cooked));
+    MappedFile file;
+    REBEL_CHECK(file.open(path));
+    REBEL_CHECK(std::equal(cooked.begin(), cooked.end(), file.bytes().begin(), file.bytes().end()));
+    const physics::TriangleMesh mesh(file.bytes());
+    constexpr uint32_t kTriangles = 2 * (kSamples - 1) * (kSamples - 1);
+    REBEL_CHECK(mesh.triangleCount() == kTriangles);
+    REBEL_CHECK(mesh.vertexCount() <= vertices.size() + kTriangles);
+    REBEL_CHECK(double(mesh.memoryUsage()) / kTriangles < 16.0);
+
+    const auto all = [&](auto&& fn) { mesh.queryTriangles(mesh.bounds(), fn); };
+    const auto cast = [&](const physics::Ray& ray, physics::CastHit& hit) {
+        return mesh.rayCast(ray.origin, ray.direction, ray.maxDistance, hit);
+    };
+    uint32_t hits = 0;
+    REBEL_CHECK(rayMismatches(cast, all, hits) == 0);
+    REBEL_CHECK(hits > 1500);
+
+    uint32_t count = 0;
+    std::set<uint32_t> ids;
+    all([&](uint32_t id, const Vec3*) {
+        ++count;
+        ids.insert(id);
+    });
+    REBEL_CHECK(count == kTriangles && ids.size() == kTriangles);
+
+    uint32_t reported = 0;
+    REBEL_CHECK(missedByBoxes(all, [&](const physics::Aabb& box, auto&& fn) { mesh.queryTriangles(box, fn); },
+                              reported) == 0);
+    REBEL_CHECK(reported > 1000);
+
+    file.close();
+    std::remove(path);
+}
+
+// Boxes, spheres and capsules dropped onto `ground` settle on its surface.
+void testBodiesRest(const physics::Shape& ground, jobs::JobSystem& jobs)
+{
+    physics::PhysicsWorld world;
+    world.createBody({.type = physics::BodyType::Static, .shape = ground});
+    const physics::Shape shapes[3] = {physics::Shape::box({0.5f, 0.5f, 0.5f}), physics::Shape::sphere(0.5f),
+                                      physics::Shape::capsule(0.3f, 0.4f)};
+    std::vector<physics::BodyId> bodies;
+    for (int i = 0; i < 64; ++i) {
+        const Vec3 position{float(i % 8) * 6.0f - 21.0f, 12.0f, float(i / 8) * 6.0f - 21.0f};
+        bodies.push_back(world.createBody({.shape = shapes[i % 3], .position = position}));
+    }
+    for (int i = 0; i < 900; ++i)
+        world.step(1.0f / 60.0f, jobs);
+
+    uint32_t below = 0, floating = 0, sunk = 0, resting = 0;
+    for (const physics::BodyId id : bodies) {
+        const physics::Body& body = *world.body(id);
+        const Vec3 p = body.transform.position;
+        physics::CastHit hit;
+        if (!physics::rayCast(ground, {}, {p.x, 100.0f, p.z}, {0.0f, -1.0f, 0.0f}, 200.0f, hit)) {
+            ++below;
+            continue;
+        }
+        // Not sunk into the ground: raised a little it is clear. Once at
+        // rest, touching it: lowered a little it meets the surface. Round
+        // bodies may still be rolling down a slope.
+        physics::Transform lowered = body.transform, raised = body.transform;
+        lowered.position.y -= 0.05f;
+        raised.position.y += 0.05f;
+        below += p.y < hit.point.y;
+        if (math::length(body.linearVelocity) < 0.1f) {
+            ++resting;
+            floating += !physics::shapesOverlap(body.shape, lowered, ground, {});
+        }
+        sunk += physics::shapesOverlap(body.shape, raised, ground, {});
+    }
+    REBEL_CHECK(below == 0);
+    REBEL_CHECK(resting > 56);
+    REBEL_CHECK(floating == 0);
+    REBEL_CHECK(sunk == 0);
+    REBEL_CHECK(world.stats().awakeBodies < bodies.size());
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    testHeightfield();
+    testMesh();
+
+    const std::vector<float> heights = makeHeights();
+    const physics::Heightfield field({kSamples, kSamples, 1.0f, heights});
+    testBodiesRest(physics::Shape::heightfield(&field), jobs);
+    std::vector<Vec3> vertices;
+    std::vector<uint32_t> indices;
+    makeMesh(vertices, indices);
+    const std::vector<uint8_t> cooked = physics::TriangleMesh::cook(vertices, indices);
+    const physics::TriangleMesh mesh(cooked);
+    testBodiesRest(physics::Shape::triangleMesh(&mesh), jobs);
+    return rebel::test::exitCode();
+}
@@ -0,0 +1,142 @@
+#include "test_common.h"
+
+#include "core/jobs/job_system.h"
+#include "physics/vehicle/vehicle_world.h"
+#include "physics/world.h"
+
+#include <algorithm>
+#include <cmath>
+
+// A car settles on its springs carrying its weight, pulls away and shifts
+// up under full throttle with its wheels rolling at road speed, brakes to
+// a stop, turns the way it is steered and backs up in reverse, finding the
+// ground by rays and by sphere sweeps alike.
+namespace {
+
+using namespace rebel;
+using math::Vec3;
+
+constexpr float kDt = 1.0f / 60.0f;
+constexpr float kMass = 1300.0f;
+
+struct Track {
+    physics::PhysicsWorld world;
+    physics::VehicleWorld vehicles;
+    physics::BodyId chassis;
+    physics::VehicleId car;
+};
+
+// A car on flat ground at y = 0, facing +Z.
+void build(Track& track, physics::WheelCast cast)
+{
+    track.world.createBody({.type = physics::BodyType::Static,
+                            .shape = physics::Shape::box({500.0f, 1.0f, 500.0f}),
+                            .position = {0.0f, -1.0f, 0.0f}});
+    track.chassis = track.world.createBody(
+        {.shape = physics::Shape::box({0.9f, 0.4f, 2.2f}), .position = {0.0f, 1.0f, 0.0f}, .mass = kMass});
+    physics::VehicleDesc car = physics::makeCar(track.chassis, 0.8f, 1.4f, -0.2f);
+    car.cast = cast;
+    track.car = track.vehicles.createVehicle(car);
+}
+
+void drive(Track& track, const physics::VehicleControls& controls, int frames, jobs::JobSystem& jobs)
+{
+    track.vehicles.setControls(track.car, controls);
+    for (int i = 0; i < frames; ++i) {
+        track.vehicles.update(track.world, kDt, jobs);
+        track.world.step(kDt, jobs);
+    }
+}
+
+const physics::Body& chassis(const Track& track)
+{
+    return *track.world.body(track.chassis);
+}
+
+void testSettles(physics::WheelCast cast, jobs::JobSystem& jobs)
+{
+    Track track;
+    build(track, cast);
+    drive(track, {}, 120, jobs);
+    const physics::VehicleStats& stats = track.vehicles.stats();
+    REBEL_CHECK(stats.vehicles == 1 && stats.wheels == 4 && stats.contacts == 4);
+    REBEL_CHECK(cast == physics::WheelCast::Ray ? stats.rayWheels == 4 : stats.sphereWheels == 4);
+
+    // The springs carry the weight, each compressed by its share of it.
+    float load = 0.0f;
+    for (const physics::WheelState& wheel : track.vehicles.wheels(track.car)) {
+        REBEL_CHECK(wheel.contact && !wheel.ground.isNull());
+        REBEL_CHECK(std::abs(wheel.contactPoint.y) < 0.01f && wheel.contactNormal.y > 0.999f);
+        REBEL_CHECK(std::abs(wheel.suspensionLength - (0.3f - wheel.load / 35000.0f)) < 0.01f);
+        load += wheel.load;
+    }
+    REBEL_CHECK(std::abs(load / (kMass * 9.81f) - 1.0f) < 0.02f);
+    REBEL_CHECK(math::length(chassis(track).linearVelocity) < 0.01f);
+    REBEL_CHECK(chassis(track).transform.rotate({0.0f, 1.0f, 0.0f}).y > 0.999f);
+    const physics::VehicleState& state = track.vehicles.state(track.car);
+    REBEL_CHECK(state.gear == 1 && std::abs(state.forwardSpeed) < 0.01f);
+    REBEL_CHECK(std::abs(state.engineRpm - 900.0f) < 50.0f);
+}
+
+void testAcceleratesAndBrakes(physics::WheelCast cast, jobs::JobSystem& jobs)
+{
+    Track track;
+    build(track, cast);
+    drive(track, {}, 60, jobs);
+    drive(track, {.throttle = 1.0f}, 360, jobs);
+    const physics::VehicleState& state = track.vehicles.state(track.car);
+    // Six seconds flat out on the flat: well up to speed, in a higher gear,
+    // straight ahead, wheels rolling with the road.
+    REBEL_CHECK(state.forwardSpeed > 20.0f);
+    REBEL_CHECK(state.gear >= 3);
+    REBEL_CHECK(state.engineRpm <= 6500.0f + 1.0f);
+    const Vec3 p = chassis(track).transform.position;
+    REBEL_CHECK(p.z > 50.0f && std::abs(p.x) < 0.5f);
+    for (const physics::WheelState& wheel : track.vehicles.wheels(track.car)) {
+        REBEL_CHECK(wheel.contact);
+        REBEL_CHECK(std::abs(wheel.angularVelocity * 0.35f / state.forwardSpeed - 1.0f) < 0.1f);
+    }
+
+    drive(track, {.brake = 1.0f}, 300, jobs);
+    REBEL_CHECK(std::abs(state.forwardSpeed) < 0.1f);
+    REBEL_CHECK(math::length(chassis(track).linearVelocity) < 0.1f);
+    REBEL_CHECK(chassis(track).transform.rotate({0.0f, 1.0f, 0.0f}).y > 0.99f);
+}
+
+void testSteersAndReverses(physics::WheelCast cast, jobs::JobSystem& jobs)
+{
+    // Steering towards +X turns the nose that way.
+    Track track;
+    build(track, cast);
+    drive(track, {}, 60, jobs);
+    drive(track, {.throttle = 0.3f}, 120, jobs);
+    drive(track, {.throttle = 0.3f, .steering = 0.5f}, 120, jobs);
+    const Vec3 forward = chassis(track).transform.rotate({0.0f, 0.0f, 1.0f});
+    REBEL_CHECK(forward.x > 0.5f);
+    REBEL_CHECK(chassis(track).transform.position.x > 1.0f);
+    float steer = 0.0f;
+    for (const physics::WheelState& wheel : track.vehicles.wheels(track.car))
+        steer += std::abs(wheel.steer);
+    REBEL_CHECK(steer > 0.1f);
+    REBEL_CHECK(chassis(track).transform.rotate({0.0f, 1.0f, 0.0f}).y > 0.99f);
+
+    // Stopped, then backing up.
+    drive(track, {.brake = 1.0f}, 240, jobs);
+    drive(track, {.throttle = 0.5f, .reverse = true}, 180, jobs);
+    const physics::VehicleState& state = track.vehicles.state(track.car);
+    REBEL_CHECK(state.gear == -1);
+    REBEL_CHECK(state.forwardSpeed < -2.0f);
+}
+
+} // namespace
+
+int main()
+{
+    rebel::jobs::JobSystem jobs({.workerCount = 4});
+    for (const rebel::physics::WheelCast cast : {rebel::physics::WheelCast::Ray, rebel::physics::WheelCast::Sphere}) {
+        testSettles(cast, jobs);
+        testAcceleratesAndBrakes(cast, jobs);
+        testSteersAndReverses(cast, jobs);
+    }
+    return rebel::test::exitCode();
+}